@@ -13,6 +13,8 @@ struct PerDrawData
     uvec2 normal_tx_hndl;
 
 	uvec2 padding;
+
+	vec4 min_lod; // finest mip level of the base color, roughness and normal texture storage that is still resident
 };
 
 layout(std430, binding = 0) readonly buffer PerDrawDataBuffer { PerDrawData per_draw_data[]; };
@@ -42,6 +44,16 @@ vec4 toLinear(vec4 sRGB)
     return mix(higher, lower, cutoff);
 }
 
+// Excludes evicted mip levels until the texture is reallocated, texture parameters can't change once a bindless handle exists
+vec4 textureMinLod(sampler2D tx, vec2 uv, float min_lod)
+{
+    if(min_lod > 0.0){
+        return textureLod(tx, uv, max(textureQueryLod(tx, uv).y, min_lod));
+    }
+
+    return texture(tx, uv);
+}
+
 
 void main()
 {
@@ -49,9 +61,11 @@ void main()
 	sampler2D roughness_tx_hndl = sampler2D(per_draw_data[draw_id].roughness_tx_hndl);
     sampler2D normal_tx_hndl = sampler2D(per_draw_data[draw_id].normal_tx_hndl);
 
-	vec4 albedo_tx_value = texture(base_tx_hndl, uvCoord);
-	vec4 roughness_tx_value = texture(roughness_tx_hndl, uvCoord);
-	vec4 normal_tx_value = texture(normal_tx_hndl, uvCoord);
+	vec4 min_lod = per_draw_data[draw_id].min_lod;
+
+	vec4 albedo_tx_value = textureMinLod(base_tx_hndl, uvCoord, min_lod.x);
+	vec4 roughness_tx_value = textureMinLod(roughness_tx_hndl, uvCoord, min_lod.y);
+	vec4 normal_tx_value = textureMinLod(normal_tx_hndl, uvCoord, min_lod.z);
 
 	bool is_sRGB = true;
 	if(is_sRGB){
@@ -67,7 +81,10 @@ void main()
 
 	depth = length( (view_matrix * vec4(position,1.0)).rgb );
 	
-	vec3 tNormal = ( normal_tx_value.rgb * 2.0) - 1.0;
+	// reconstruct z, normal maps might be stored as two channel (BC5) textures
+	vec3 tNormal;
+	tNormal.xy = ( normal_tx_value.rg * 2.0) - 1.0;
+	tNormal.z = sqrt( max(0.0, 1.0 - dot(tNormal.xy, tNormal.xy)) );
 	normal.xyz = (normalize(transpose(tangent_space_matrix) * tNormal)) * 0.5 + 0.5;
 	
 	albedoRGB = albedo_tx_value.rgb;
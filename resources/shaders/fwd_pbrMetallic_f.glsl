@@ -13,6 +13,8 @@ struct PerDrawData
     uvec2 normal_tx_hndl;
 
 	uvec2 padding;
+
+	vec4 min_lod; // finest mip level of the base color, roughness and normal texture storage that is still resident
 };
 
 layout(std430, binding = 0) readonly buffer PerDrawDataBuffer { PerDrawData per_draw_data[]; };
@@ -80,16 +82,31 @@ vec3 cookTorranceShading(
 	return (light_colour*diffuse_brdf + light_colour*specular_brdf) * max(0.0,n_dot_l);
 }
 
+// Excludes evicted mip levels until the texture is reallocated, texture parameters can't change once a bindless handle exists
+vec4 textureMinLod(sampler2D tx, vec2 uv, float min_lod)
+{
+    if(min_lod > 0.0){
+        return textureLod(tx, uv, max(textureQueryLod(tx, uv).y, min_lod));
+    }
+
+    return texture(tx, uv);
+}
+
 void main()
 {
 	sampler2D base_tx_hndl = sampler2D(per_draw_data[draw_id].base_color_tx_hndl);
 	sampler2D roughness_tx_hndl = sampler2D(per_draw_data[draw_id].roughness_tx_hndl);
     sampler2D normal_tx_hndl = sampler2D(per_draw_data[draw_id].normal_tx_hndl);
 
-	vec3 base_color = texture(base_tx_hndl, uvCoord).rgb;
-    vec3 normal = texture(normal_tx_hndl, uvCoord).rgb;
-	normal = normalize( transpose(tangent_space_matrix) * ((normal*2.0)-1.0) );
-	vec2 metallicRoughness = texture(roughness_tx_hndl, uvCoord).bg;
+	vec4 min_lod = per_draw_data[draw_id].min_lod;
+
+	vec3 base_color = textureMinLod(base_tx_hndl, uvCoord, min_lod.x).rgb;
+    // reconstruct z, normal maps might be stored as two channel (BC5) textures
+    vec3 normal;
+    normal.xy = (textureMinLod(normal_tx_hndl, uvCoord, min_lod.z).rg * 2.0) - 1.0;
+    normal.z = sqrt( max(0.0, 1.0 - dot(normal.xy, normal.xy)) );
+	normal = normalize( transpose(tangent_space_matrix) * normal );
+	vec2 metallicRoughness = textureMinLod(roughness_tx_hndl, uvCoord, min_lod.y).bg;
 
 	vec3 specular_color = base_color * metallicRoughness.r;
 	vec3 albedo_color = base_color * (1.0 - metallicRoughness.r);
@@ -10,6 +10,8 @@ struct PerDrawData
 	uvec2 normal_tx_hndl;
 
 	uvec2 padding;
+
+	vec4 min_lod;
 };
 
 layout(std430, binding = 0) readonly buffer PerDrawDataBuffer { PerDrawData per_draw_data[]; };
@@ -5,11 +5,11 @@ struct PerDrawData
 {
 	mat4 model_matrix;
 
-	int joint_index_offset;
+	int joint_index_offset;          // current evaluation of the skin in the slotted joint palette
+	int previous_joint_index_offset; // previous evaluation of the skin in the slotted joint palette
+	float joint_blend;               // interpolation factor from the previous to the current evaluation
 
 	int padding0;
-	int padding1;
-	int padding2;
 };
 
 layout(std430, binding = 0) readonly buffer PerDrawDataBuffer { PerDrawData per_draw_data[]; };
@@ -29,6 +29,22 @@ layout (location = 1) out vec3 w_normal;
 
 flat out int draw_id;
 
+// Joint matrix interpolated between the last two evaluations of the skin, skins updated every frame only read the current one
+mat4 jointTransform(int joint)
+{
+	PerDrawData draw_data = per_draw_data[gl_DrawIDARB];
+
+	mat4 current = joint_transforms[draw_data.joint_index_offset + joint];
+
+	if(draw_data.joint_blend >= 1.0){
+		return current;
+	}
+
+	mat4 previous = joint_transforms[draw_data.previous_joint_index_offset + joint];
+
+	return previous + (current - previous) * draw_data.joint_blend;
+}
+
 void main()
 {   
 	draw_id = gl_DrawIDARB;
@@ -44,10 +60,10 @@ void main()
 
 	// Compute skin matrix
 	mat4 skinMatrix = 
-		v_joint_weights.x * joint_transforms[per_draw_data[gl_DrawIDARB].joint_index_offset + int(v_joints.x)] +
-		v_joint_weights.y * joint_transforms[per_draw_data[gl_DrawIDARB].joint_index_offset + int(v_joints.y)] +
-		v_joint_weights.z * joint_transforms[per_draw_data[gl_DrawIDARB].joint_index_offset + int(v_joints.z)] +
-		v_joint_weights.w * joint_transforms[per_draw_data[gl_DrawIDARB].joint_index_offset + int(v_joints.w)];
+		v_joint_weights.x * jointTransform(int(v_joints.x)) +
+		v_joint_weights.y * jointTransform(int(v_joints.y)) +
+		v_joint_weights.z * jointTransform(int(v_joints.z)) +
+		v_joint_weights.w * jointTransform(int(v_joints.w));
 
 	// Transform vertex position to world space
 	w_position = (per_draw_data[gl_DrawIDARB].model_matrix * skinMatrix * vec4(v_position,1.0)).xyz;
@@ -1,9 +1,228 @@
 #include "AirplanePhysicsComponent.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "EntityManager.hpp"
+#include "SimdFloat.hpp"
+#include "TaskScheduler.hpp"
 #include "TransformComponentManager.hpp"
 #include "WorldState.hpp"
 
+namespace
+{
+    constexpr size_t airplanes_per_task = 1024;
+
+    using namespace EngineCore::Utility::Simd;
+
+    /** Staged per airplane values of a batch, one float array per channel */
+    enum Channel
+    {
+        ORIENTATION_X, ORIENTATION_Y, ORIENTATION_Z, ORIENTATION_W,
+        POSITION_X, POSITION_Y, POSITION_Z,
+        VELOCITY_X, VELOCITY_Y, VELOCITY_Z,
+        ACCELERATION_X, ACCELERATION_Y, ACCELERATION_Z,
+        ENGINE_THRUST, ELEVATOR_ANGLE, RUDDER_ANGLE, AILERON_ANGLE,
+        PITCH_TORQUE, ROLL_TORQUE, YAW_TORQUE,
+        ANGLE_OF_ATTACK, ANGLE_OF_SIDESLIP, LIFT_COEFFICIENT, DRAG_COEFFICIENT, AERODYNAMIC_LIFT, AERODYNAMIC_DRAG,
+        WING_SURFACE, MASS,
+        CHANNEL_CNT
+    };
+
+    /** Channels padded to a multiple of the SIMD width, padding lanes hold a resting unit mass airplane */
+    struct AirplaneBatch
+    {
+        AirplaneBatch(size_t cnt) : padded_cnt((cnt + width - 1) / width * width), data(CHANNEL_CNT * padded_cnt, 0.0f)
+        {
+            std::fill((*this)[ORIENTATION_W], (*this)[ORIENTATION_W] + padded_cnt, 1.0f);
+            std::fill((*this)[MASS], (*this)[MASS] + padded_cnt, 1.0f);
+        }
+
+        float* operator[](Channel channel) { return data.data() + channel * padded_cnt; }
+
+        size_t             padded_cnt;
+        std::vector<float> data;
+    };
+
+    struct QuatN
+    {
+        FloatN x;
+        FloatN y;
+        FloatN z;
+        FloatN w;
+    };
+
+    inline QuatN operator*(QuatN const& a, QuatN const& b)
+    {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y + a.y * b.w + a.z * b.x - a.x * b.z,
+            a.w * b.z + a.z * b.w + a.x * b.y - a.y * b.x,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+    }
+
+    /** Rotation about a unit axis, same as glm::rotate(Quat(), angle, axis) */
+    inline QuatN angleAxis(FloatN angle, Vec3N const& axis)
+    {
+        FloatN s, c;
+        vsincos(angle * splat(0.5f), s, c);
+        return { axis.x * s, axis.y * s, axis.z * s, c };
+    }
+
+    /** Unit length vector or the fallback if the vector is (almost) zero */
+    inline Vec3N normalizeOr(Vec3N const& v, Vec3N const& fallback)
+    {
+        FloatN len = length(v);
+        return select(len > splat(1.0e-6f), v / len, fallback);
+    }
+
+    /**
+    * The flight model of all airplanes of the batch, width airplanes at a time. Same model as the former per
+    * airplane update: the aerodynamic forces follow from angle of attack and sideslip, the orientation is turned
+    * by the simplified gravity and lift torques and the control surface torques, all in aircraft space.
+    */
+    void integrateBatch(AirplaneBatch& batch, float timestep)
+    {
+        FloatN const dt = splat(timestep);
+        FloatN const one = splat(1.0f);
+        FloatN const two = splat(2.0f);
+        FloatN const zero = splat(0.0f);
+
+        for (size_t i = 0; i < batch.padded_cnt; i += width)
+        {
+            QuatN q = { load(batch[ORIENTATION_X] + i), load(batch[ORIENTATION_Y] + i), load(batch[ORIENTATION_Z] + i), load(batch[ORIENTATION_W] + i) };
+            Vec3N position = { load(batch[POSITION_X] + i), load(batch[POSITION_Y] + i), load(batch[POSITION_Z] + i) };
+            Vec3N velocity = { load(batch[VELOCITY_X] + i), load(batch[VELOCITY_Y] + i), load(batch[VELOCITY_Z] + i) };
+            FloatN engine_thrust = load(batch[ENGINE_THRUST] + i);
+            FloatN wing_surface = load(batch[WING_SURFACE] + i);
+            FloatN mass = load(batch[MASS] + i);
+
+            // columns of the rotation matrix, i.e. the aircraft axes in world space
+            Vec3N col0 = {
+                one - two * (q.y * q.y + q.z * q.z),
+                two * (q.x * q.y + q.w * q.z),
+                two * (q.x * q.z - q.w * q.y) };
+            Vec3N col1 = {
+                two * (q.x * q.y - q.w * q.z),
+                one - two * (q.x * q.x + q.z * q.z),
+                two * (q.y * q.z + q.w * q.x) };
+            Vec3N col2 = {
+                two * (q.x * q.z + q.w * q.y),
+                two * (q.y * q.z - q.w * q.x),
+                one - two * (q.x * q.x + q.y * q.y) };
+
+            Vec3N front = col2;
+            Vec3N up = col1;
+            Vec3N righthand = -col0;
+
+            // use the lift equation to compute updated aerodynamic lift:
+            // lift = cl * (rho * v^2)/2 * A
+            // and the drag equation to compute updated aerodynamic drag:
+            // drag = 0.5 * rho * v^2 * A * cd
+            FloatN rho = splat(1.2f); // TODO: depends on altitude
+            FloatN v = length(velocity);
+            FloatN g = splat(9.81f);
+
+            // a resting airplane has no angle of attack
+            Vec3N velocity_dir = normalizeOr(velocity, front);
+
+            // project velocity into aircraft yz and xz plane
+            Vec3N v_yz = normalizeOr(velocity_dir - dot(righthand, velocity_dir) * righthand, front);
+            Vec3N v_xz = normalizeOr(velocity_dir - dot(up, velocity_dir) * up, front);
+
+            // transform angles to degree
+            FloatN aoa = (vacos(dot(front, v_yz)) / splat(3.14f)) * splat(180.0f);
+            FloatN aos = (vacos(dot(front, v_xz)) / splat(3.14f)) * splat(180.0f);
+
+            // negative angle of attack!
+            aoa = select(dot(up, v_yz) > zero, -aoa, aoa);
+            aos = select(dot(righthand, v_xz) > zero, -aos, aos);
+
+            FloatN cl = select(aoa < splat(16.0f), splat(0.1f) * aoa, splat(-0.1f) * aoa + splat(3.2f));
+            cl = cl / (one + aos / splat(45.0f));
+
+            // modify induced drag to not decrease after passing the stall angle
+            FloatN cdp = splat(0.034f);
+            FloatN eff = splat(0.77f);
+            FloatN induced = splat(0.0889f) * aoa + splat(0.178f);
+            FloatN cd = cdp + (induced * induced) / (splat(3.14f) * (splat(49.0f) / splat(22.0f)) * eff)
+                + ((aos * aos) / splat(2000.0f));
+
+            FloatN aerodynamic_lift = cl * ((rho * v * v) / two) * wing_surface;
+            FloatN aerodynamic_drag = cd * ((rho * v * v) / two) * wing_surface;
+
+            Vec3N acceleration = Vec3N{ zero, -g, zero }
+                + ((aerodynamic_lift / mass) * up)
+                + ((engine_thrust / mass) * front)
+                + ((aerodynamic_drag / mass) * -velocity_dir);
+
+            velocity = velocity + acceleration * dt;
+
+            // add rotation about center of mass induced by gravity and induced by lift...very, very simplified
+            FloatN gravity_torque = splat(-0.000025f) * mass;
+            FloatN lift_torque = splat(0.000025f) * mass;
+
+            Vec3N world_up_aircraft_space = { col0.y, col1.y, col2.y };
+            Vec3N velocity_aircraft_space = { dot(col0, velocity), dot(col1, velocity), dot(col2, velocity) };
+
+            // no gravity torque when flying straight up or down
+            Vec3N aircraft_space_world_x = cross(velocity_aircraft_space, world_up_aircraft_space);
+            FloatN world_x_length = length(aircraft_space_world_x);
+            FloatN has_world_x = world_x_length > splat(1.0e-6f);
+            aircraft_space_world_x = select(has_world_x, aircraft_space_world_x / world_x_length, Vec3N{ one, zero, zero });
+
+            // rotations are applied in aircraft space!
+            q = q * angleAxis(select(has_world_x, dt * gravity_torque, zero), aircraft_space_world_x);
+            q = q * angleAxis(dt * lift_torque, Vec3N{ -one, zero, zero });
+
+            FloatN elevator_angle = load(batch[ELEVATOR_ANGLE] + i);
+            FloatN rudder_angle = load(batch[RUDDER_ANGLE] + i);
+            FloatN aileron_angle = load(batch[AILERON_ANGLE] + i);
+            FloatN roll_torque = load(batch[ROLL_TORQUE] + i);
+            FloatN pitch_torque = load(batch[PITCH_TORQUE] + i);
+            FloatN yaw_torque = load(batch[YAW_TORQUE] + i);
+
+            roll_torque = roll_torque + ((aileron_angle / (one + splat(0.5f) * vabs(aoa))) - splat(5.0f) * roll_torque) * dt;
+            pitch_torque = pitch_torque + ((elevator_angle / (one + splat(0.5f) * vabs(aoa))) - splat(5.0f) * pitch_torque) * dt;
+            yaw_torque = yaw_torque + ((rudder_angle / (one + splat(0.5f) * vabs(aos))) - splat(10.0f) * yaw_torque) * dt;
+
+            q = q * angleAxis(dt * splat(12.0f) * roll_torque, Vec3N{ zero, zero, one }); // roll
+            q = q * angleAxis(dt * splat(7.0f) * pitch_torque, Vec3N{ -one, zero, zero }); // pitch
+            q = q * angleAxis(dt * splat(3.0f) * yaw_torque, Vec3N{ zero, one, zero }); // yaw
+
+            // keep the orientation from drifting off unit length over many steps
+            FloatN inv_q_length = one / vsqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+            q = { q.x * inv_q_length, q.y * inv_q_length, q.z * inv_q_length, q.w * inv_q_length };
+
+            position = position + velocity * dt;
+
+            store(batch[ORIENTATION_X] + i, q.x);
+            store(batch[ORIENTATION_Y] + i, q.y);
+            store(batch[ORIENTATION_Z] + i, q.z);
+            store(batch[ORIENTATION_W] + i, q.w);
+            store(batch[POSITION_X] + i, position.x);
+            store(batch[POSITION_Y] + i, position.y);
+            store(batch[POSITION_Z] + i, position.z);
+            store(batch[VELOCITY_X] + i, velocity.x);
+            store(batch[VELOCITY_Y] + i, velocity.y);
+            store(batch[VELOCITY_Z] + i, velocity.z);
+            store(batch[ACCELERATION_X] + i, acceleration.x);
+            store(batch[ACCELERATION_Y] + i, acceleration.y);
+            store(batch[ACCELERATION_Z] + i, acceleration.z);
+            store(batch[PITCH_TORQUE] + i, pitch_torque);
+            store(batch[ROLL_TORQUE] + i, roll_torque);
+            store(batch[YAW_TORQUE] + i, yaw_torque);
+            store(batch[ANGLE_OF_ATTACK] + i, aoa);
+            store(batch[ANGLE_OF_SIDESLIP] + i, aos);
+            store(batch[LIFT_COEFFICIENT] + i, cl);
+            store(batch[DRAG_COEFFICIENT] + i, cd);
+            store(batch[AERODYNAMIC_LIFT] + i, aerodynamic_lift);
+            store(batch[AERODYNAMIC_DRAG] + i, aerodynamic_drag);
+        }
+    }
+}
+
 namespace EngineCore
 {
     namespace Physics
@@ -74,7 +293,7 @@ namespace EngineCore
             new_data.angle_of_sideslip = (float*)(new_data.angle_of_attack + size);
             new_data.lift_coefficient = (float*)(new_data.angle_of_sideslip + size);
             new_data.drag_coefficient = (float*)(new_data.lift_coefficient + size);
-            new_data.aerodynamic_drag = (float*)(new_data.aileron_angle + size);
+            new_data.aerodynamic_drag = (float*)(new_data.drag_coefficient + size);
             new_data.aerodynamic_lift = (float*)(new_data.aerodynamic_drag + size);
             new_data.wing_surface = (float*)(new_data.aerodynamic_lift + size);
             new_data.mass = (float*)(new_data.wing_surface + size);
@@ -100,11 +319,26 @@ namespace EngineCore
             std::memcpy(new_data.wing_surface, m_data.wing_surface, m_data.used * sizeof(float));
             std::memcpy(new_data.mass, m_data.mass, m_data.used * sizeof(float));
 
-            delete m_data.buffer;
+            delete[] m_data.buffer;
 
             m_data = new_data;
         }
 
+        void AirplanePhysicsComponentManager::reserve(uint size)
+        {
+            std::unique_lock<std::mutex> lock(m_data_mutex);
+
+            if (size > m_data.allocated) {
+                reallocate(size);
+            }
+        }
+
+        uint AirplanePhysicsComponentManager::getComponentCount() const
+        {
+            std::unique_lock<std::mutex> lock(m_data_mutex);
+            return m_data.used;
+        }
+
         void AirplanePhysicsComponentManager::addComponent(
             Entity entity,
             Vec3 velocity,
@@ -146,117 +380,184 @@ namespace EngineCore
         {
             std::unique_lock<std::mutex> lock(m_data_mutex);
 
-            auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
-
-            for (uint i = 0; i < m_data.used; i++)
-            {
-                size_t aircraft_transform_idx = transform_mngr.getIndex(m_data.entity[i]); // TODO this is not safe...
-                Quat orientation = transform_mngr.getOrientation(aircraft_transform_idx);
-
-                Quat qFront = glm::cross(glm::cross(orientation, glm::quat(0.0, 0.0, 0.0, 1.0)), glm::conjugate(orientation));
-                Quat qUp = glm::cross(glm::cross(orientation, glm::quat(0.0, 0.0, 1.0, 0.0)), glm::conjugate(orientation));
-                Quat qRighthand = glm::cross(glm::cross(orientation, glm::quat(0.0, -1.0, 0.0, 0.0)), glm::conjugate(orientation));
-
-                Vec3 vFront(qFront.x, qFront.y, qFront.z);
-                Vec3 vUp(qUp.x, qUp.y, qUp.z);
-                Vec3 vRighthand(qRighthand.x, qRighthand.y, qRighthand.z);
-
-                // use the lift equation to compute updated aerodynamic lift:
-                // lift = cl * (rho * v^2)/2 * A
-                // and the drag equation to compute updated aerodynamic drag:
-                // drag = 0.5 * rho * v^2 * A * cd
-
-                float min_airbrake = 0.2f;
-                float max_airbrake = 0.6f;
-
-                float rho = 1.2f; // TODO: depends on altitude
-                float A = m_data.wing_surface[i];
-                float v = glm::length(m_data.velocity[i]);
-                float m = m_data.mass[i];
-                float g = 9.81f;
-
-                // project velocity into aircraft yz plane
-                Vec3 v_yz = glm::normalize(glm::normalize(m_data.velocity[i]) - (glm::dot(vRighthand, glm::normalize(m_data.velocity[i])) * vRighthand));
-                Vec3 v_xz = glm::normalize(glm::normalize(m_data.velocity[i]) - (glm::dot(vUp, glm::normalize(m_data.velocity[i])) * vUp));
-                float aoa = glm::dot(vFront, v_yz);
-                float aos = glm::dot(vFront, v_xz);
-
-                //transform angle of attack to degree
-                aoa = (aoa < -1.0f) ? -1.0f : (aoa > 1.0f) ? 1.0f : aoa;
-                aos = (aos < -1.0f) ? -1.0f : (aos > 1.0f) ? 1.0f : aos;
-
-                aoa = (std::acos(aoa) / 3.14f) * 180.0f;
-                aos = (std::acos(aos) / 3.14f) * 180.0f;
-
-                // negative angle of attack!
-                aoa = glm::dot(vUp, v_yz) > 0.0f ? -aoa : aoa;
-                aos = glm::dot(vRighthand, v_xz) > 0.0f ? -aos : aos;
-
-                m_data.angle_of_attack[i] = aoa;
-                m_data.angle_of_sideslip[i] = aos;
-
-                //float cl = (aoa < 16.0f) ? 0.0889*aoa + 0.178 : -0.1*aoa+3.2;
-                float cl = (aoa < 16.0f) ? 0.1f*aoa : -0.1f*aoa + 3.2f;
-                cl = cl / (1.0f + aos / 45.0f);
-                //cl = (abs(aoa) > 25.0f) ? 0.0f : cl;
-                m_data.lift_coefficient[i] = cl;
-
-                float cdp = 0.034f;
-                float eff = 0.77f;
-                //float cd = cdp + cl*cl / (3.14f * (64.0f/22.0f) * eff);
-                // modify induced drag to not decrease after passing the stall angle
-                float cd = cdp + ((0.0889f*aoa + 0.178f)*(0.0889f*aoa + 0.178f)) / (3.14f * (49.0f / 22.0f) * eff)
-                    + ((aos*aos) / 2000.0f);
-                m_data.drag_coefficient[i] = cd;
-
-                m_data.aerodynamic_lift[i] = cl * ((rho * v*v) / 2.0f) * A;
-                m_data.aerodynamic_drag[i] = cd * ((rho * v*v) / 2.0f) * A;
-
-                m_data.acceleration[i] = (g * Vec3(0.0f, -1.0f, 0.0f))
-                    + ((m_data.aerodynamic_lift[i] / m) * vUp)
-                    + ((m_data.engine_thrust[i] / m) * vFront)
-                    + ((m_data.aerodynamic_drag[i] / m) * -glm::normalize(m_data.velocity[i]));
+            integrate(timestep, nullptr);
+        }
 
-                m_data.velocity[i] += m_data.acceleration[i] * timestep;
+        void AirplanePhysicsComponentManager::update(float timestep, Utility::TaskScheduler& task_scheduler)
+        {
+            std::unique_lock<std::mutex> lock(m_data_mutex);
 
-                // based on rudder/elevator/aileron configuration, aoa and windspeed update aircraft orientations
-                float elevator_angle = m_data.elevator_angle[i] * 1.0f;
-                float rudder_angle = m_data.rudder_angle[i] * 1.0f;
-                float aileron_angle = m_data.aileron_angle[i] * 1.0f;
+            integrate(timestep, &task_scheduler);
+        }
 
-                // orientation is updated in local coordinate frame
-                //    orientation *= glm::rotate(glm::quat(), -0.02f * aileron_angle / (1.0f + abs(aoa)), Vec3(0.0, 0.0, -1.0)); // roll
-                //    orientation *= glm::rotate(glm::quat(), -0.005f * elevator_angle / (1.0f + abs(aoa)), Vec3(1.0, 0.0, 0.0)); // pitch
-                //    orientation *= glm::rotate(glm::quat(), 0.001f * rudder_angle / (1.0f + abs(aos)), Vec3(0.0, 1.0, 0.0)); // yaw
+        void AirplanePhysicsComponentManager::integrate(float timestep, Utility::TaskScheduler* task_scheduler)
+        {
+            size_t airplane_cnt = m_data.used;
 
-                // add rotation about center of mass induced by gravity and induced by lift...very, very simplified
-                float gravity_torque = -0.000025f * m;
-                float lift_torque = 0.000025f * m;
+            // resolve the manager once, the lookup locks the world state
+            auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
 
+            std::vector<size_t> indices(airplane_cnt);
+            std::vector<Vec3> positions(airplane_cnt);
+            std::vector<Quat> orientations(airplane_cnt);
+            std::vector<Vec3> scales(airplane_cnt);
+
+            auto integrateChunk = [this, &transform_mngr, &indices, &positions, &orientations, &scales, timestep](size_t first, size_t last) {
+                size_t cnt = last - first;
+                AirplaneBatch batch(cnt);
+
+                for (size_t i = 0; i < cnt; ++i)
+                {
+                    size_t idx = first + i;
+
+                    // airplanes without a transform fly from the origin and are not written back
+                    size_t transform_idx = transform_mngr.getIndex(m_data.entity[idx]);
+                    Vec3 position(0.0f);
+                    Quat orientation(1.0f, 0.0f, 0.0f, 0.0f);
+                    Vec3 scale(1.0f);
+                    if (transform_idx != std::numeric_limits<size_t>::max())
+                    {
+                        position = transform_mngr.getPosition(transform_idx);
+                        orientation = transform_mngr.getOrientation(transform_idx);
+                        scale = transform_mngr.getScale(transform_idx);
+                    }
+                    indices[idx] = transform_idx;
+                    scales[idx] = scale;
+
+                    batch[ORIENTATION_X][i] = orientation.x;
+                    batch[ORIENTATION_Y][i] = orientation.y;
+                    batch[ORIENTATION_Z][i] = orientation.z;
+                    batch[ORIENTATION_W][i] = orientation.w;
+                    batch[POSITION_X][i] = position.x;
+                    batch[POSITION_Y][i] = position.y;
+                    batch[POSITION_Z][i] = position.z;
+                    batch[VELOCITY_X][i] = m_data.velocity[idx].x;
+                    batch[VELOCITY_Y][i] = m_data.velocity[idx].y;
+                    batch[VELOCITY_Z][i] = m_data.velocity[idx].z;
+                    batch[ENGINE_THRUST][i] = m_data.engine_thrust[idx];
+                    batch[ELEVATOR_ANGLE][i] = m_data.elevator_angle[idx];
+                    batch[RUDDER_ANGLE][i] = m_data.rudder_angle[idx];
+                    batch[AILERON_ANGLE][i] = m_data.aileron_angle[idx];
+                    batch[PITCH_TORQUE][i] = m_data.pitch_torque[idx];
+                    batch[ROLL_TORQUE][i] = m_data.roll_torque[idx];
+                    batch[YAW_TORQUE][i] = m_data.yaw_torque[idx];
+                    batch[WING_SURFACE][i] = m_data.wing_surface[idx];
+                    batch[MASS][i] = m_data.mass[idx];
+                }
+
+                integrateBatch(batch, timestep);
+
+                for (size_t i = 0; i < cnt; ++i)
+                {
+                    size_t idx = first + i;
+
+                    positions[idx] = Vec3(batch[POSITION_X][i], batch[POSITION_Y][i], batch[POSITION_Z][i]);
+                    orientations[idx] = Quat(batch[ORIENTATION_W][i], batch[ORIENTATION_X][i], batch[ORIENTATION_Y][i], batch[ORIENTATION_Z][i]);
+
+                    m_data.velocity[idx] = Vec3(batch[VELOCITY_X][i], batch[VELOCITY_Y][i], batch[VELOCITY_Z][i]);
+                    m_data.acceleration[idx] = Vec3(batch[ACCELERATION_X][i], batch[ACCELERATION_Y][i], batch[ACCELERATION_Z][i]);
+                    m_data.pitch_torque[idx] = batch[PITCH_TORQUE][i];
+                    m_data.roll_torque[idx] = batch[ROLL_TORQUE][i];
+                    m_data.yaw_torque[idx] = batch[YAW_TORQUE][i];
+                    m_data.angle_of_attack[idx] = batch[ANGLE_OF_ATTACK][i];
+                    m_data.angle_of_sideslip[idx] = batch[ANGLE_OF_SIDESLIP][i];
+                    m_data.lift_coefficient[idx] = batch[LIFT_COEFFICIENT][i];
+                    m_data.drag_coefficient[idx] = batch[DRAG_COEFFICIENT][i];
+                    m_data.aerodynamic_lift[idx] = batch[AERODYNAMIC_LIFT][i];
+                    m_data.aerodynamic_drag[idx] = batch[AERODYNAMIC_DRAG][i];
+                }
+            };
+
+            for (size_t first = 0; first < airplane_cnt; first += airplanes_per_task)
+            {
+                size_t last = std::min(first + airplanes_per_task, airplane_cnt);
+
+                if (task_scheduler != nullptr) {
+                    task_scheduler->submitTask([&integrateChunk, first, last]() { integrateChunk(first, last); });
+                }
+                else {
+                    integrateChunk(first, last);
+                }
+            }
 
-                Quat worldUp_aircraftSpace_q = glm::conjugate(orientation) * glm::quat(0.0, 0.0, 1.0, 0.0) * orientation;
-                Vec3 worldUp_aircraftSpace = Vec3(worldUp_aircraftSpace_q.x, worldUp_aircraftSpace_q.y, worldUp_aircraftSpace_q.z);
-                Quat velocity_aircraftSpace_q = glm::conjugate(orientation) * glm::quat(0.0, m_data.velocity[i]) * orientation;
-                Vec3 velocity_aircraftSpace = Vec3(velocity_aircraftSpace_q.x, velocity_aircraftSpace_q.y, velocity_aircraftSpace_q.z);
+            if (task_scheduler != nullptr) {
+                task_scheduler->waitWhileBusy();
+            }
 
-                Vec3 aircraftSpace_worldX = glm::cross(velocity_aircraftSpace, worldUp_aircraftSpace);
+            // one batched write back, world transformations are recomputed once per updated subtree
+            size_t transform_cnt = 0;
+            for (size_t i = 0; i < airplane_cnt; ++i)
+            {
+                if (indices[i] == std::numeric_limits<size_t>::max())
+                    continue;
+
+                indices[transform_cnt] = indices[i];
+                positions[transform_cnt] = positions[i];
+                orientations[transform_cnt] = orientations[i];
+                scales[transform_cnt] = scales[i];
+                ++transform_cnt;
+            }
+            indices.resize(transform_cnt);
+            positions.resize(transform_cnt);
+            orientations.resize(transform_cnt);
+            scales.resize(transform_cnt);
 
-                // rotations are applied in aircraft space!
-                orientation *= glm::rotate(glm::quat(), timestep *gravity_torque, aircraftSpace_worldX);
-                orientation *= glm::rotate(glm::quat(), timestep *lift_torque, Vec3(-1.0f, 0.0f, 0.0f));
+            if (transform_cnt > 0) {
+                transform_mngr.setLocalTransforms(indices, positions, orientations, scales);
+            }
+        }
 
+        std::vector<AirplanePhysicsComponentManager::AirplaneState> AirplanePhysicsComponentManager::getStates() const
+        {
+            std::unique_lock<std::mutex> lock(m_data_mutex);
 
-                m_data.roll_torque[i] = (m_data.roll_torque[i] + ((aileron_angle / (1.0f + 0.5f*abs(aoa))) - 5.0f*m_data.roll_torque[i]) * timestep);
-                m_data.pitch_torque[i] = (m_data.pitch_torque[i] + ((elevator_angle / (1.0f + 0.5f*abs(aoa))) - 5.0f*m_data.pitch_torque[i]) * timestep);
-                m_data.yaw_torque[i] = (m_data.yaw_torque[i] + ((rudder_angle / (1.0f + 0.5f*abs(aos))) - 10.0f*m_data.yaw_torque[i]) * timestep);
+            std::vector<AirplaneState> states(m_data.used);
+            for (uint i = 0; i < m_data.used; ++i)
+            {
+                AirplaneState& state = states[i];
+                state.velocity = m_data.velocity[i];
+                state.acceleration = m_data.acceleration[i];
+                state.engine_thrust = m_data.engine_thrust[i];
+                state.elevator_angle = m_data.elevator_angle[i];
+                state.rudder_angle = m_data.rudder_angle[i];
+                state.aileron_angle = m_data.aileron_angle[i];
+                state.pitch_torque = m_data.pitch_torque[i];
+                state.roll_torque = m_data.roll_torque[i];
+                state.yaw_torque = m_data.yaw_torque[i];
+                state.angle_of_attack = m_data.angle_of_attack[i];
+                state.angle_of_sideslip = m_data.angle_of_sideslip[i];
+                state.lift_coefficient = m_data.lift_coefficient[i];
+                state.drag_coefficient = m_data.drag_coefficient[i];
+                state.aerodynamic_drag = m_data.aerodynamic_drag[i];
+                state.aerodynamic_lift = m_data.aerodynamic_lift[i];
+            }
 
+            return states;
+        }
 
-                orientation *= glm::rotate(glm::quat(), timestep * 12.0f * (m_data.roll_torque[i]), Vec3(0.0, 0.0, 1.0)); // roll
-                orientation *= glm::rotate(glm::quat(), timestep * 7.0f * (m_data.pitch_torque[i]), Vec3(-1.0, 0.0, 0.0)); // pitch
-                orientation *= glm::rotate(glm::quat(), timestep * 3.0f * (m_data.yaw_torque[i]), Vec3(0.0, 1.0, 0.0)); // yaw
+        void AirplanePhysicsComponentManager::setStates(std::vector<AirplaneState> const& states)
+        {
+            std::unique_lock<std::mutex> lock(m_data_mutex);
 
-                transform_mngr.setOrientation(aircraft_transform_idx, orientation);
-                transform_mngr.translate(aircraft_transform_idx, m_data.velocity[i] * timestep);
+            uint cnt = std::min(m_data.used, static_cast<uint>(states.size()));
+            for (uint i = 0; i < cnt; ++i)
+            {
+                AirplaneState const& state = states[i];
+                m_data.velocity[i] = state.velocity;
+                m_data.acceleration[i] = state.acceleration;
+                m_data.engine_thrust[i] = state.engine_thrust;
+                m_data.elevator_angle[i] = state.elevator_angle;
+                m_data.rudder_angle[i] = state.rudder_angle;
+                m_data.aileron_angle[i] = state.aileron_angle;
+                m_data.pitch_torque[i] = state.pitch_torque;
+                m_data.roll_torque[i] = state.roll_torque;
+                m_data.yaw_torque[i] = state.yaw_torque;
+                m_data.angle_of_attack[i] = state.angle_of_attack;
+                m_data.angle_of_sideslip[i] = state.angle_of_sideslip;
+                m_data.lift_coefficient[i] = state.lift_coefficient;
+                m_data.drag_coefficient[i] = state.drag_coefficient;
+                m_data.aerodynamic_drag[i] = state.aerodynamic_drag;
+                m_data.aerodynamic_lift[i] = state.aerodynamic_lift;
             }
         }
 
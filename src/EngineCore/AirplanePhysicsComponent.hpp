@@ -10,11 +10,40 @@ namespace EngineCore
 {
     class WorldState;
 
+    namespace Utility
+    {
+        class TaskScheduler;
+    }
+
     namespace Physics
     {
 
         class AirplanePhysicsComponentManager : public BaseMultiInstanceComponentManager
         {
+        public:
+            /**
+             * Simulated state of an airplane, i.e. everything but the constant mass and wing surface.
+             * Used for recording and replaying simulations.
+             */
+            struct AirplaneState
+            {
+                Vec3  velocity;
+                Vec3  acceleration;
+                float engine_thrust;
+                float elevator_angle;
+                float rudder_angle;
+                float aileron_angle;
+                float pitch_torque;
+                float roll_torque;
+                float yaw_torque;
+                float angle_of_attack;
+                float angle_of_sideslip;
+                float lift_coefficient;
+                float drag_coefficient;
+                float aerodynamic_drag;
+                float aerodynamic_lift;
+            };
+
         private:
 
             struct AerodynamicForces
@@ -62,12 +91,23 @@ namespace EngineCore
 
             WorldState& m_world;
 
+            /**
+             * Runs the flight model for all airplanes in chunks, on the task scheduler if one is given and on the
+             * calling thread otherwise. Expects m_data_mutex to be locked.
+             */
+            void integrate(float timestep, Utility::TaskScheduler* task_scheduler);
+
         public:
             AirplanePhysicsComponentManager(uint size, WorldState& world);
             ~AirplanePhysicsComponentManager();
 
             void reallocate(uint size);
 
+            /**
+             * Grow the component storage to hold at least the given number of components
+             */
+            void reserve(uint size);
+
             void addComponent(Entity entity,
                 Vec3 velocity,
                 Vec3 acceleration,
@@ -77,8 +117,30 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            uint getComponentCount() const;
+
+            /**
+             * Advance all airplanes by the given timestep. Meant to be called with a fixed timestep,
+             * e.g. as a simulation of the PhysicsSystem, as the integration is only stable for small steps.
+             */
             void update(float timestep);
 
+            /**
+             * Same as update(float) with chunks of airplanes processed in parallel on the task scheduler.
+             * The flight model runs in SIMD lanes, all transforms are written back in one batch afterwards.
+             */
+            void update(float timestep, Utility::TaskScheduler& task_scheduler);
+
+            /**
+             * Simulated state of all airplanes in component order
+             */
+            std::vector<AirplaneState> getStates() const;
+
+            /**
+             * Overwrite the simulated state of the first states.size() airplanes, additional states are ignored
+             */
+            void setStates(std::vector<AirplaneState> const& states);
+
             std::pair<bool, uint> getIndex(uint entity_id) const;
 
             float getEngineThrust(uint index) const;
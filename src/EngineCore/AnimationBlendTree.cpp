@@ -0,0 +1,424 @@
+#include "AnimationBlendTree.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    using EngineCore::Animation::AnimationClip;
+    using EngineCore::Animation::BlendTree;
+    using EngineCore::Animation::BlendTreeState;
+    using EngineCore::Animation::PoseBuffer;
+    using EngineCore::Animation::PosePool;
+
+    /** Blend a towards b per joint by weight, or by weight * mask[joint] if a mask is given */
+    void blendPoses(PoseBuffer& a, PoseBuffer const& b, float weight, float const* mask)
+    {
+        size_t joint_cnt = a.joint_cnt;
+
+        int const vector_components[] = {
+            PoseBuffer::TRANSLATION_X, PoseBuffer::TRANSLATION_Y, PoseBuffer::TRANSLATION_Z,
+            PoseBuffer::SCALE_X, PoseBuffer::SCALE_Y, PoseBuffer::SCALE_Z };
+
+        for (int c : vector_components)
+        {
+            float* a_values = a.component(c);
+            float const* b_values = b.component(c);
+
+            if (mask == nullptr)
+            {
+                for (size_t j = 0; j < joint_cnt; ++j) {
+                    a_values[j] += (b_values[j] - a_values[j]) * weight;
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < joint_cnt; ++j) {
+                    a_values[j] += (b_values[j] - a_values[j]) * (weight * mask[j]);
+                }
+            }
+        }
+
+        float* ax = a.component(PoseBuffer::ROTATION_X);
+        float* ay = a.component(PoseBuffer::ROTATION_Y);
+        float* az = a.component(PoseBuffer::ROTATION_Z);
+        float* aw = a.component(PoseBuffer::ROTATION_W);
+        float const* bx = b.component(PoseBuffer::ROTATION_X);
+        float const* by = b.component(PoseBuffer::ROTATION_Y);
+        float const* bz = b.component(PoseBuffer::ROTATION_Z);
+        float const* bw = b.component(PoseBuffer::ROTATION_W);
+
+        // normalized linear interpolation along the shorter path
+        for (size_t j = 0; j < joint_cnt; ++j)
+        {
+            float w = mask != nullptr ? weight * mask[j] : weight;
+            float cos_theta = ax[j] * bx[j] + ay[j] * by[j] + az[j] * bz[j] + aw[j] * bw[j];
+            float wb = cos_theta < 0.0f ? -w : w;
+            float wa = 1.0f - w;
+
+            float x = ax[j] * wa + bx[j] * wb;
+            float y = ay[j] * wa + by[j] * wb;
+            float z = az[j] * wa + bz[j] * wb;
+            float qw = aw[j] * wa + bw[j] * wb;
+            float inv_length = 1.0f / std::sqrt(x * x + y * y + z * z + qw * qw);
+
+            ax[j] = x * inv_length;
+            ay[j] = y * inv_length;
+            az[j] = z * inv_length;
+            aw[j] = qw * inv_length;
+        }
+    }
+
+    /** Apply the delta pose additive, scaled by weight, on top of base */
+    void addPose(PoseBuffer& base, PoseBuffer const& additive, float weight)
+    {
+        size_t joint_cnt = base.joint_cnt;
+
+        for (int c = PoseBuffer::TRANSLATION_X; c <= PoseBuffer::TRANSLATION_Z; ++c)
+        {
+            float* base_values = base.component(c);
+            float const* additive_values = additive.component(c);
+
+            for (size_t j = 0; j < joint_cnt; ++j) {
+                base_values[j] += additive_values[j] * weight;
+            }
+        }
+
+        for (int c = PoseBuffer::SCALE_X; c <= PoseBuffer::SCALE_Z; ++c)
+        {
+            float* base_values = base.component(c);
+            float const* additive_values = additive.component(c);
+
+            for (size_t j = 0; j < joint_cnt; ++j) {
+                base_values[j] *= 1.0f + (additive_values[j] - 1.0f) * weight;
+            }
+        }
+
+        float* x1 = base.component(PoseBuffer::ROTATION_X);
+        float* y1 = base.component(PoseBuffer::ROTATION_Y);
+        float* z1 = base.component(PoseBuffer::ROTATION_Z);
+        float* w1 = base.component(PoseBuffer::ROTATION_W);
+        float const* ax = additive.component(PoseBuffer::ROTATION_X);
+        float const* ay = additive.component(PoseBuffer::ROTATION_Y);
+        float const* az = additive.component(PoseBuffer::ROTATION_Z);
+        float const* aw = additive.component(PoseBuffer::ROTATION_W);
+
+        for (size_t j = 0; j < joint_cnt; ++j)
+        {
+            // scale the delta rotation by interpolating from identity, then apply it as base * delta
+            float w = aw[j] < 0.0f ? -weight : weight;
+            float x2 = ax[j] * w;
+            float y2 = ay[j] * w;
+            float z2 = az[j] * w;
+            float w2 = 1.0f - weight + aw[j] * w;
+            float inv_length = 1.0f / std::sqrt(x2 * x2 + y2 * y2 + z2 * z2 + w2 * w2);
+            x2 *= inv_length;
+            y2 *= inv_length;
+            z2 *= inv_length;
+            w2 *= inv_length;
+
+            float x = w1[j] * x2 + x1[j] * w2 + y1[j] * z2 - z1[j] * y2;
+            float y = w1[j] * y2 - x1[j] * z2 + y1[j] * w2 + z1[j] * x2;
+            float z = w1[j] * z2 + x1[j] * y2 - y1[j] * x2 + z1[j] * w2;
+            float qw = w1[j] * w2 - x1[j] * x2 - y1[j] * y2 - z1[j] * z2;
+
+            x1[j] = x;
+            y1[j] = y;
+            z1[j] = z;
+            w1[j] = qw;
+        }
+    }
+
+    /** Translation 0, rotation identity and scale 1 for all joints, the rest pose of additive inputs */
+    void setIdentityPose(PoseBuffer& pose)
+    {
+        std::fill(pose.data.begin(), pose.data.end(), 0.0f);
+        std::fill_n(pose.component(PoseBuffer::ROTATION_W), pose.joint_cnt, 1.0f);
+        std::fill_n(pose.component(PoseBuffer::SCALE_X), pose.joint_cnt * 3, 1.0f);
+    }
+
+    void sampleClip(BlendTree const& tree, uint32_t clip_idx, BlendTreeState& state, PoseBuffer const& rest_pose, PoseBuffer& result)
+    {
+        auto const& clip = tree.clips[clip_idx];
+        float time = state.clip_times[clip_idx];
+
+        result.data = rest_pose.data;
+
+        if (clip.clip != nullptr)
+        {
+            auto& key_hints = state.key_hints[clip_idx];
+
+            for (size_t channel_idx = 0; channel_idx < clip.clip->channels.size(); ++channel_idx)
+            {
+                auto const& channel = clip.clip->channels[channel_idx];
+
+                float value[4];
+                EngineCore::Animation::sampleChannel(*clip.clip, channel, time, key_hints[channel_idx], value);
+
+                int first_component = channel.path == AnimationClip::Path::TRANSLATION ? PoseBuffer::TRANSLATION_X
+                    : (channel.path == AnimationClip::Path::ROTATION ? PoseBuffer::ROTATION_X : PoseBuffer::SCALE_X);
+                int component_cnt = channel.path == AnimationClip::Path::ROTATION ? 4 : 3;
+
+                for (int c = 0; c < component_cnt; ++c) {
+                    result.component(first_component + c)[channel.target] = value[c];
+                }
+            }
+        }
+        else if (clip.compressed_clip != nullptr)
+        {
+            for (size_t j = 0; j < rest_pose.joint_cnt; ++j) {
+                rest_pose.get(j, state.positions[j], state.orientations[j], state.scales[j]);
+            }
+
+            EngineCore::Animation::samplePose(*clip.compressed_clip, time, state.positions.data(), state.orientations.data(), state.scales.data());
+
+            for (size_t j = 0; j < rest_pose.joint_cnt; ++j) {
+                result.set(j, state.positions[j], state.orientations[j], state.scales[j]);
+            }
+        }
+    }
+
+    void evaluateNode(
+        BlendTree const& tree,
+        uint32_t node_idx,
+        BlendTreeState& state,
+        PoseBuffer const& rest_pose,
+        PosePool& pool,
+        PoseBuffer& result)
+    {
+        auto const& node = tree.nodes[node_idx];
+
+        if (node.type == BlendTree::NodeType::CLIP)
+        {
+            sampleClip(tree, node.index, state, rest_pose, result);
+            return;
+        }
+
+        float weight = std::clamp(state.parameters[node.weight_parameter], 0.0f, 1.0f);
+
+        // skip inputs that don't contribute
+        if (weight <= 0.0f)
+        {
+            evaluateNode(tree, node.inputs[0], state, rest_pose, pool, result);
+            return;
+        }
+        if (weight >= 1.0f && node.type == BlendTree::NodeType::LERP)
+        {
+            evaluateNode(tree, node.inputs[1], state, rest_pose, pool, result);
+            return;
+        }
+
+        evaluateNode(tree, node.inputs[0], state, rest_pose, pool, result);
+
+        auto pose = pool.acquire(rest_pose.joint_cnt);
+
+        if (node.type == BlendTree::NodeType::ADDITIVE)
+        {
+            // joints that the additive clips don't animate have to stay unchanged, i.e. default to identity
+            auto identity_pose = pool.acquire(rest_pose.joint_cnt);
+            setIdentityPose(*identity_pose);
+            evaluateNode(tree, node.inputs[1], state, *identity_pose, pool, *pose);
+            pool.release(std::move(identity_pose));
+        }
+        else
+        {
+            evaluateNode(tree, node.inputs[1], state, rest_pose, pool, *pose);
+        }
+
+        switch (node.type)
+        {
+        case BlendTree::NodeType::LERP:
+            blendPoses(result, *pose, weight, nullptr);
+            break;
+        case BlendTree::NodeType::ADDITIVE:
+            addPose(result, *pose, weight);
+            break;
+        case BlendTree::NodeType::MASKED_LAYER:
+            blendPoses(result, *pose, weight, tree.masks[node.index].data());
+            break;
+        default:
+            break;
+        }
+
+        pool.release(std::move(pose));
+    }
+}
+
+void EngineCore::Animation::PoseBuffer::resize(size_t joint_cnt)
+{
+    this->joint_cnt = joint_cnt;
+    data.resize(joint_cnt * COMPONENT_CNT);
+}
+
+void EngineCore::Animation::PoseBuffer::set(size_t joint, Vec3 const& position, Quat const& orientation, Vec3 const& scale)
+{
+    component(TRANSLATION_X)[joint] = position.x;
+    component(TRANSLATION_Y)[joint] = position.y;
+    component(TRANSLATION_Z)[joint] = position.z;
+    component(ROTATION_X)[joint] = orientation.x;
+    component(ROTATION_Y)[joint] = orientation.y;
+    component(ROTATION_Z)[joint] = orientation.z;
+    component(ROTATION_W)[joint] = orientation.w;
+    component(SCALE_X)[joint] = scale.x;
+    component(SCALE_Y)[joint] = scale.y;
+    component(SCALE_Z)[joint] = scale.z;
+}
+
+void EngineCore::Animation::PoseBuffer::get(size_t joint, Vec3& position, Quat& orientation, Vec3& scale) const
+{
+    position = Vec3(component(TRANSLATION_X)[joint], component(TRANSLATION_Y)[joint], component(TRANSLATION_Z)[joint]);
+    orientation = Quat(component(ROTATION_W)[joint], component(ROTATION_X)[joint], component(ROTATION_Y)[joint], component(ROTATION_Z)[joint]);
+    scale = Vec3(component(SCALE_X)[joint], component(SCALE_Y)[joint], component(SCALE_Z)[joint]);
+}
+
+std::unique_ptr<EngineCore::Animation::PoseBuffer> EngineCore::Animation::PosePool::acquire(size_t joint_cnt)
+{
+    std::unique_ptr<PoseBuffer> retval;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_free_poses.empty())
+        {
+            retval = std::move(m_free_poses.back());
+            m_free_poses.pop_back();
+        }
+    }
+
+    if (retval == nullptr) {
+        retval = std::make_unique<PoseBuffer>();
+    }
+
+    retval->resize(joint_cnt);
+
+    return retval;
+}
+
+void EngineCore::Animation::PosePool::release(std::unique_ptr<PoseBuffer> pose)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_free_poses.push_back(std::move(pose));
+}
+
+uint32_t EngineCore::Animation::BlendTree::addClipNode(AnimationClipPtr const& clip, float speed, bool loop)
+{
+    assert(clip != nullptr && clip->target_ids.size() == joint_cnt);
+
+    clips.push_back({ clip, nullptr, speed, loop });
+    return addNode({ NodeType::CLIP, { 0, 0 }, 0, static_cast<uint32_t>(clips.size() - 1) });
+}
+
+uint32_t EngineCore::Animation::BlendTree::addClipNode(CompressedAnimationClipPtr const& clip, float speed, bool loop)
+{
+    assert(clip != nullptr && clip->target_ids.size() == joint_cnt);
+
+    clips.push_back({ nullptr, clip, speed, loop });
+    return addNode({ NodeType::CLIP, { 0, 0 }, 0, static_cast<uint32_t>(clips.size() - 1) });
+}
+
+uint32_t EngineCore::Animation::BlendTree::addLerpNode(uint32_t input_a, uint32_t input_b, uint32_t weight_parameter)
+{
+    return addNode({ NodeType::LERP, { input_a, input_b }, weight_parameter, 0 });
+}
+
+uint32_t EngineCore::Animation::BlendTree::addAdditiveNode(uint32_t base, uint32_t additive, uint32_t weight_parameter)
+{
+    return addNode({ NodeType::ADDITIVE, { base, additive }, weight_parameter, 0 });
+}
+
+uint32_t EngineCore::Animation::BlendTree::addMaskedLayerNode(uint32_t base, uint32_t layer, uint32_t mask, uint32_t weight_parameter)
+{
+    assert(mask < masks.size());
+
+    return addNode({ NodeType::MASKED_LAYER, { base, layer }, weight_parameter, mask });
+}
+
+uint32_t EngineCore::Animation::BlendTree::addMask(std::vector<float> const& joint_weights)
+{
+    assert(joint_weights.size() == joint_cnt);
+
+    masks.push_back(joint_weights);
+    return static_cast<uint32_t>(masks.size() - 1);
+}
+
+uint32_t EngineCore::Animation::BlendTree::addNode(Node const& node)
+{
+    if (node.type != NodeType::CLIP)
+    {
+        // inputs have to be added first, which also rules out cycles
+        assert(node.inputs[0] < nodes.size() && node.inputs[1] < nodes.size());
+        parameter_cnt = std::max(parameter_cnt, node.weight_parameter + 1);
+    }
+
+    nodes.push_back(node);
+
+    // the last added node is the root unless set otherwise
+    root = static_cast<uint32_t>(nodes.size() - 1);
+
+    return root;
+}
+
+EngineCore::Animation::BlendTreeState::BlendTreeState(BlendTree const& tree)
+    : parameters(tree.parameter_cnt, 0.0f), clip_times(tree.clips.size(), 0.0f), key_hints(tree.clips.size())
+{
+    bool has_compressed_clips = false;
+
+    for (size_t i = 0; i < tree.clips.size(); ++i)
+    {
+        if (tree.clips[i].clip != nullptr) {
+            key_hints[i].resize(tree.clips[i].clip->channels.size(), 0);
+        }
+        else {
+            has_compressed_clips = true;
+        }
+    }
+
+    if (has_compressed_clips)
+    {
+        positions.resize(tree.joint_cnt);
+        orientations.resize(tree.joint_cnt);
+        scales.resize(tree.joint_cnt);
+    }
+}
+
+void EngineCore::Animation::advanceBlendTree(BlendTree const& tree, BlendTreeState& state, float dt)
+{
+    for (size_t i = 0; i < tree.clips.size(); ++i)
+    {
+        auto const& clip = tree.clips[i];
+        float duration = clip.clip != nullptr ? clip.clip->duration : clip.compressed_clip->duration;
+
+        float& time = state.clip_times[i];
+        time += dt * clip.speed;
+
+        if (clip.loop && duration > 0.0f)
+        {
+            time = std::fmod(time, duration);
+            if (time < 0.0f) {
+                time += duration;
+            }
+        }
+        else
+        {
+            time = std::clamp(time, 0.0f, duration);
+        }
+    }
+}
+
+void EngineCore::Animation::evaluateBlendTree(
+    BlendTree const& tree,
+    BlendTreeState& state,
+    PoseBuffer const& rest_pose,
+    PosePool& pool,
+    PoseBuffer& result)
+{
+    result.resize(rest_pose.joint_cnt);
+
+    if (tree.nodes.empty())
+    {
+        result.data = rest_pose.data;
+        return;
+    }
+
+    evaluateNode(tree, tree.root, state, rest_pose, pool, result);
+}
@@ -0,0 +1,159 @@
+#ifndef AnimationBlendTree_hpp
+#define AnimationBlendTree_hpp
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AnimationClip.hpp"
+#include "AnimationCompression.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Animation
+    {
+        /**
+        * \brief Local transformations of a set of joints as structure of arrays, i.e. one array per component.
+        * Blending then processes each component array in a single straight loop.
+        */
+        struct PoseBuffer
+        {
+            enum Component
+            {
+                TRANSLATION_X, TRANSLATION_Y, TRANSLATION_Z,
+                ROTATION_X, ROTATION_Y, ROTATION_Z, ROTATION_W,
+                SCALE_X, SCALE_Y, SCALE_Z,
+                COMPONENT_CNT
+            };
+
+            size_t             joint_cnt = 0;
+            std::vector<float> data; ///< COMPONENT_CNT arrays of joint_cnt floats each
+
+            void resize(size_t joint_cnt);
+
+            inline float* component(int c) { return data.data() + c * joint_cnt; }
+
+            inline float const* component(int c) const { return data.data() + c * joint_cnt; }
+
+            void set(size_t joint, Vec3 const& position, Quat const& orientation, Vec3 const& scale);
+
+            void get(size_t joint, Vec3& position, Quat& orientation, Vec3& scale) const;
+        };
+
+        /**
+        * \brief Recycles pose buffers, so that evaluating blend trees does not allocate once warmed up.
+        * Can be used concurrently.
+        */
+        class PosePool
+        {
+        public:
+            std::unique_ptr<PoseBuffer> acquire(size_t joint_cnt);
+
+            void release(std::unique_ptr<PoseBuffer> pose);
+
+        private:
+            std::vector<std::unique_ptr<PoseBuffer>> m_free_poses;
+            std::mutex                               m_mutex;
+        };
+
+        /**
+        * \brief Immutable description of a blend graph that is shared by all characters using it.
+        *
+        * Nodes refer to their inputs by node index and to their blend weight by parameter index, the parameter
+        * values are set per character. All clips of a tree animate the same set of targets, i.e. clip target i is
+        * joint i of the pose.
+        */
+        struct BlendTree
+        {
+            enum class NodeType : uint8_t
+            {
+                CLIP,         ///< Samples a clip
+                LERP,         ///< Blends from input 0 to input 1 by weight
+                ADDITIVE,     ///< Adds input 1 scaled by weight to input 0. Input 1 is a delta pose relative to identity, joints it doesn't animate are identity.
+                MASKED_LAYER  ///< Blends from input 0 to input 1 by weight times the per-joint weight of the mask
+            };
+
+            struct Node
+            {
+                NodeType type;
+                uint32_t inputs[2];
+                uint32_t weight_parameter; ///< Index into the per character parameters, unused by clip nodes
+                uint32_t index;            ///< Index into clips for clip nodes, into masks for masked layers
+            };
+
+            struct Clip
+            {
+                AnimationClipPtr           clip;
+                CompressedAnimationClipPtr compressed_clip; ///< Used if clip is not set
+                float                      speed;
+                bool                       loop;
+            };
+
+            size_t                          joint_cnt = 0;
+            uint32_t                        parameter_cnt = 0;
+            uint32_t                        root = 0;
+            std::vector<Node>               nodes;
+            std::vector<Clip>               clips;
+            std::vector<std::vector<float>> masks; ///< Weight in [0,1] per joint
+
+            uint32_t addClipNode(AnimationClipPtr const& clip, float speed = 1.0f, bool loop = true);
+
+            uint32_t addClipNode(CompressedAnimationClipPtr const& clip, float speed = 1.0f, bool loop = true);
+
+            uint32_t addLerpNode(uint32_t input_a, uint32_t input_b, uint32_t weight_parameter);
+
+            uint32_t addAdditiveNode(uint32_t base, uint32_t additive, uint32_t weight_parameter);
+
+            uint32_t addMaskedLayerNode(uint32_t base, uint32_t layer, uint32_t mask, uint32_t weight_parameter);
+
+            /**
+            * \brief Add a joint mask, e.g. 1 for all upper body joints and 0 otherwise
+            * \return Returns the mask index for addMaskedLayerNode
+            */
+            uint32_t addMask(std::vector<float> const& joint_weights);
+
+        private:
+            uint32_t addNode(Node const& node);
+        };
+
+        typedef std::shared_ptr<BlendTree const> BlendTreePtr;
+
+        /**
+        * \brief Per character state of a blend tree
+        */
+        struct BlendTreeState
+        {
+            std::vector<float>                 parameters;
+            std::vector<float>                 clip_times;
+            std::vector<std::vector<uint32_t>> key_hints;  ///< Per clip and channel, see sampleChannel
+
+            /** Scratch buffers for sampling compressed clips */
+            std::vector<Vec3> positions;
+            std::vector<Quat> orientations;
+            std::vector<Vec3> scales;
+
+            explicit BlendTreeState(BlendTree const& tree);
+        };
+
+        /**
+        * \brief Advance the playback time of all clips of the tree
+        */
+        void advanceBlendTree(BlendTree const& tree, BlendTreeState& state, float dt);
+
+        /**
+        * \brief Evaluate the tree into result. Inputs that don't contribute because of a zero weight are not evaluated.
+        * \param rest_pose Values of joints that are not animated by a clip (outside of additive inputs)
+        * \param pool Provides temporary poses for blend nodes
+        */
+        void evaluateBlendTree(
+            BlendTree const& tree,
+            BlendTreeState& state,
+            PoseBuffer const& rest_pose,
+            PosePool& pool,
+            PoseBuffer& result);
+    }
+}
+
+#endif // !AnimationBlendTree_hpp
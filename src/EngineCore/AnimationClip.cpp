@@ -0,0 +1,241 @@
+#include "AnimationClip.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIMATION_CLIP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    /** Quaternions closer than this are interpolated linearly, slerp is numerically unstable for small angles */
+    constexpr float slerp_threshold = 0.9995f;
+
+#ifdef ANIMATION_CLIP_SSE2
+    inline float dot4(__m128 a, __m128 b)
+    {
+        __m128 m = _mm_mul_ps(a, b);
+        __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        s = _mm_add_ss(s, _mm_movehl_ps(s, s));
+        return _mm_cvtss_f32(s);
+    }
+
+    inline __m128 normalize4(__m128 v)
+    {
+        float length_sq = dot4(v, v);
+        return length_sq > 0.0f ? _mm_mul_ps(v, _mm_set1_ps(1.0f / std::sqrt(length_sq))) : v;
+    }
+
+    /** Weighted sum a * wa + b * wb */
+    inline void blend(float const* a, float wa, float const* b, float wb, float* result)
+    {
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(wa)), _mm_mul_ps(_mm_loadu_ps(b), _mm_set1_ps(wb)));
+        _mm_storeu_ps(result, r);
+    }
+
+    inline float dot(float const* a, float const* b)
+    {
+        return dot4(_mm_loadu_ps(a), _mm_loadu_ps(b));
+    }
+
+    inline void normalize(float* v)
+    {
+        _mm_storeu_ps(v, normalize4(_mm_loadu_ps(v)));
+    }
+
+    /** Cubic Hermite spline, tangents already scaled by the key interval */
+    inline void hermite(float const* v0, float const* b0, float const* a1, float const* v1, float t, float* result)
+    {
+        float t2 = t * t;
+        float t3 = t2 * t;
+
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(v0), _mm_set1_ps(2.0f * t3 - 3.0f * t2 + 1.0f));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(b0), _mm_set1_ps(t3 - 2.0f * t2 + t)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(v1), _mm_set1_ps(-2.0f * t3 + 3.0f * t2)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a1), _mm_set1_ps(t3 - t2)));
+        _mm_storeu_ps(result, r);
+    }
+#else
+    inline void blend(float const* a, float wa, float const* b, float wb, float* result)
+    {
+        for (int i = 0; i < 4; ++i) {
+            result[i] = a[i] * wa + b[i] * wb;
+        }
+    }
+
+    inline float dot(float const* a, float const* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    }
+
+    inline void normalize(float* v)
+    {
+        float length_sq = dot(v, v);
+        if (length_sq > 0.0f)
+        {
+            float inv_length = 1.0f / std::sqrt(length_sq);
+            for (int i = 0; i < 4; ++i) {
+                v[i] *= inv_length;
+            }
+        }
+    }
+
+    inline void hermite(float const* v0, float const* b0, float const* a1, float const* v1, float t, float* result)
+    {
+        float t2 = t * t;
+        float t3 = t2 * t;
+
+        for (int i = 0; i < 4; ++i) {
+            result[i] = v0[i] * (2.0f * t3 - 3.0f * t2 + 1.0f) + b0[i] * (t3 - 2.0f * t2 + t)
+                + v1[i] * (-2.0f * t3 + 3.0f * t2) + a1[i] * (t3 - t2);
+        }
+    }
+#endif
+
+    inline void slerp(float const* a, float const* b, float t, float* result)
+    {
+        float cos_theta = dot(a, b);
+
+        // take the shorter path
+        float sign = 1.0f;
+        if (cos_theta < 0.0f)
+        {
+            cos_theta = -cos_theta;
+            sign = -1.0f;
+        }
+
+        if (cos_theta > slerp_threshold)
+        {
+            // nlerp
+            blend(a, 1.0f - t, b, sign * t, result);
+            normalize(result);
+            return;
+        }
+
+        float theta = std::acos(cos_theta);
+        float inv_sin_theta = 1.0f / std::sin(theta);
+        blend(a, std::sin((1.0f - t) * theta) * inv_sin_theta, b, sign * std::sin(t * theta) * inv_sin_theta, result);
+    }
+}
+
+void EngineCore::Animation::AnimationClip::addChannel(
+    uint32_t target,
+    Path path,
+    Interpolation interpolation,
+    float const* key_times,
+    uint32_t key_cnt,
+    float const* key_values)
+{
+    uint32_t component_cnt = path == Path::ROTATION ? 4 : 3;
+    uint32_t values_per_key = interpolation == Interpolation::CUBICSPLINE ? 3 : 1;
+
+    Channel channel;
+    channel.target = target;
+    channel.path = path;
+    channel.interpolation = interpolation;
+    channel.key_offset = static_cast<uint32_t>(times.size());
+    channel.key_cnt = key_cnt;
+    channel.value_offset = static_cast<uint32_t>(values.size() / 4);
+
+    times.insert(times.end(), key_times, key_times + key_cnt);
+
+    for (uint32_t i = 0; i < key_cnt * values_per_key; ++i)
+    {
+        float value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        std::copy_n(key_values + i * component_cnt, component_cnt, value);
+        values.insert(values.end(), value, value + 4);
+    }
+
+    if (key_cnt > 0) {
+        duration = std::max(duration, key_times[key_cnt - 1]);
+    }
+
+    channels.push_back(channel);
+}
+
+void EngineCore::Animation::sampleChannel(
+    AnimationClip const& clip,
+    AnimationClip::Channel const& channel,
+    float time,
+    uint32_t& key_hint,
+    float* result)
+{
+    bool     is_cubic = channel.interpolation == AnimationClip::Interpolation::CUBICSPLINE;
+    uint32_t values_per_key = is_cubic ? 3 : 1;
+
+    float const* times = clip.times.data() + channel.key_offset;
+    float const* values = clip.values.data() + static_cast<size_t>(channel.value_offset) * 4;
+    uint32_t     key_cnt = channel.key_cnt;
+
+    // value of key i, for cubic splines the value sits between the in- and out-tangent
+    auto key_value = [values, values_per_key, is_cubic](uint32_t i) {
+        return values + (static_cast<size_t>(i) * values_per_key + (is_cubic ? 1 : 0)) * 4;
+    };
+
+    if (key_cnt == 0)
+    {
+        std::fill_n(result, 4, 0.0f);
+        return;
+    }
+
+    if (key_cnt == 1 || time <= times[0])
+    {
+        key_hint = 0;
+        std::copy_n(key_value(0), 4, result);
+        return;
+    }
+
+    if (time >= times[key_cnt - 1])
+    {
+        key_hint = key_cnt - 2;
+        std::copy_n(key_value(key_cnt - 1), 4, result);
+        return;
+    }
+
+    // find key k with times[k] <= time < times[k+1], usually the hinted key or its successor
+    uint32_t k = std::min(key_hint, key_cnt - 2);
+    if (!(times[k] <= time && time < times[k + 1]))
+    {
+        if (k + 2 < key_cnt && times[k + 1] <= time && time < times[k + 2]) {
+            k = k + 1;
+        }
+        else {
+            k = static_cast<uint32_t>(std::upper_bound(times, times + key_cnt, time) - times) - 1;
+        }
+    }
+    key_hint = k;
+
+    float key_interval = times[k + 1] - times[k];
+    float t = key_interval > 0.0f ? (time - times[k]) / key_interval : 0.0f;
+
+    switch (channel.interpolation)
+    {
+    case AnimationClip::Interpolation::STEP:
+        std::copy_n(key_value(k), 4, result);
+        break;
+    case AnimationClip::Interpolation::LINEAR:
+        if (channel.path == AnimationClip::Path::ROTATION) {
+            slerp(key_value(k), key_value(k + 1), t, result);
+        }
+        else {
+            blend(key_value(k), 1.0f - t, key_value(k + 1), t, result);
+        }
+        break;
+    case AnimationClip::Interpolation::CUBICSPLINE:
+    {
+        float b0[4];
+        float a1[4];
+        float const zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        blend(key_value(k) + 4, key_interval, zero, 0.0f, b0);     // out-tangent of key k
+        blend(key_value(k + 1) - 4, key_interval, zero, 0.0f, a1); // in-tangent of key k+1
+        hermite(key_value(k), b0, a1, key_value(k + 1), t, result);
+
+        if (channel.path == AnimationClip::Path::ROTATION) {
+            normalize(result);
+        }
+        break;
+    }
+    }
+}
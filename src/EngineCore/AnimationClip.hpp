@@ -0,0 +1,80 @@
+#ifndef AnimationClip_hpp
+#define AnimationClip_hpp
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Animation
+    {
+        /**
+        * \brief Keyframe animation of a set of targets (e.g. the joints of a skeleton). Clips are immutable once
+        * created and shared by all players.
+        *
+        * Keyframes are stored as structure of arrays: the key times of all channels in one array and the key values
+        * in another one. Each value is padded to 4 floats, so that interpolation works on whole SIMD registers.
+        */
+        struct AnimationClip
+        {
+            enum class Path : uint8_t { TRANSLATION, ROTATION, SCALE };
+
+            enum class Interpolation : uint8_t { LINEAR, STEP, CUBICSPLINE };
+
+            struct Channel
+            {
+                uint32_t      target;       ///< Index into target_ids
+                Path          path;
+                Interpolation interpolation;
+                uint32_t      key_offset;   ///< Index of the first key time in times
+                uint32_t      key_cnt;
+                uint32_t      value_offset; ///< Index of the first value in values, in units of 4 floats
+            };
+
+            std::string           name;
+            float                 duration = 0.0f;
+            std::vector<uint32_t> target_ids; ///< Source specific id of each target, e.g. the glTF node index
+            std::vector<Channel>  channels;
+            std::vector<float>    times;
+            std::vector<float>    values;     ///< Vectors as x,y,z,0 and quaternions as x,y,z,w
+
+            /**
+            * \brief Add a channel to the clip.
+            * \param target Index into target_ids
+            * \param key_times Key times in seconds, in ascending order
+            * \param key_cnt Number of keys
+            * \param key_values Tightly packed vec3 (translation, scale) or quaternion x,y,z,w (rotation) values.
+            * Cubic splines have three values per key: in-tangent, value and out-tangent.
+            */
+            void addChannel(
+                uint32_t target,
+                Path path,
+                Interpolation interpolation,
+                float const* key_times,
+                uint32_t key_cnt,
+                float const* key_values);
+        };
+
+        typedef std::shared_ptr<AnimationClip const> AnimationClipPtr;
+
+        /**
+        * \brief Sample a channel of a clip.
+        * \param clip The clip that contains the channel
+        * \param channel The channel to sample
+        * \param time Time in seconds, clamped to the channel's key range
+        * \param key_hint Starting point of the key search, updated to the key found. Sampling at increasing times
+        * only needs constant time per sample.
+        * \param result Receives 4 floats, i.e. x,y,z,0 for translation and scale or x,y,z,w for rotation
+        */
+        void sampleChannel(
+            AnimationClip const& clip,
+            AnimationClip::Channel const& channel,
+            float time,
+            uint32_t& key_hint,
+            float* result);
+    }
+}
+
+#endif // !AnimationClip_hpp
@@ -0,0 +1,1148 @@
+#include "AnimationCompression.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace EngineCore
+{
+    namespace Animation
+    {
+        namespace
+        {
+            constexpr char     compressed_clip_file_magic[4] = { 'S','L','A','C' };
+            constexpr uint32_t compressed_clip_file_version = 2;
+
+            constexpr float    inv_sqrt2 = 0.70710678f;
+            constexpr uint32_t rotation_code_max = (1u << 15) - 1;
+            constexpr uint32_t wide_rotation_code_max = (1u << 31) - 1;
+            constexpr uint32_t vector_code_max = (1u << 16) - 1;
+
+            template<typename T>
+            void writeValue(std::ofstream& file, T value)
+            {
+                file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+            }
+
+            template<typename T>
+            bool readValue(std::ifstream& file, T& value)
+            {
+                return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+            }
+
+            /** Dense keys of a single channel, values padded to 4 floats */
+            struct ChannelKeys
+            {
+                std::vector<float> times;
+                std::vector<float> values;
+                bool               step;
+            };
+
+            ChannelKeys gatherKeys(AnimationClip const& clip, AnimationClip::Channel const& channel, float sample_rate)
+            {
+                ChannelKeys retval;
+                retval.step = channel.interpolation == AnimationClip::Interpolation::STEP;
+
+                float const* times = clip.times.data() + channel.key_offset;
+
+                if (channel.interpolation == AnimationClip::Interpolation::CUBICSPLINE)
+                {
+                    // resample, the compressed format only supports linear interpolation
+                    float begin = times[0];
+                    float end = times[channel.key_cnt - 1];
+                    uint32_t sample_cnt = std::max(2u, static_cast<uint32_t>(std::ceil((end - begin) * sample_rate)) + 1);
+                    if (channel.key_cnt == 1) {
+                        sample_cnt = 1;
+                    }
+
+                    uint32_t key_hint = 0;
+                    for (uint32_t i = 0; i < sample_cnt; ++i)
+                    {
+                        float t = sample_cnt > 1 ? begin + (end - begin) * static_cast<float>(i) / static_cast<float>(sample_cnt - 1) : begin;
+                        float value[4];
+                        sampleChannel(clip, channel, t, key_hint, value);
+                        retval.times.push_back(t);
+                        retval.values.insert(retval.values.end(), value, value + 4);
+                    }
+                }
+                else
+                {
+                    retval.times.assign(times, times + channel.key_cnt);
+                    float const* values = clip.values.data() + static_cast<size_t>(channel.value_offset) * 4;
+                    retval.values.assign(values, values + static_cast<size_t>(channel.key_cnt) * 4);
+                }
+
+                return retval;
+            }
+
+            void normalizeQuaternion(float* q)
+            {
+                float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+                if (length > 0.0f)
+                {
+                    for (int i = 0; i < 4; ++i) {
+                        q[i] /= length;
+                    }
+                }
+                else
+                {
+                    q[0] = q[1] = q[2] = 0.0f;
+                    q[3] = 1.0f;
+                }
+            }
+
+            /** Smallest-three encoding: index of the largest component in 2 bits and the other components in 15 bits each */
+            void encodeRotation(float const* q, uint16_t* codes)
+            {
+                int largest = 0;
+                for (int i = 1; i < 4; ++i) {
+                    if (std::abs(q[i]) > std::abs(q[largest]))
+                        largest = i;
+                }
+
+                // q and -q are the same rotation, so the largest component is always stored as positive
+                float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+                uint64_t packed = static_cast<uint64_t>(largest);
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (i == largest)
+                        continue;
+
+                    float normalized = std::clamp((q[i] * sign / inv_sqrt2 + 1.0f) * 0.5f, 0.0f, 1.0f);
+                    packed = (packed << 15) | static_cast<uint64_t>(std::lround(normalized * rotation_code_max));
+                }
+
+                codes[0] = static_cast<uint16_t>(packed & 0xFFFF);
+                codes[1] = static_cast<uint16_t>((packed >> 16) & 0xFFFF);
+                codes[2] = static_cast<uint16_t>((packed >> 32) & 0xFFFF);
+            }
+
+            inline void decodeRotation(uint16_t const* codes, float* q)
+            {
+                uint64_t packed = static_cast<uint64_t>(codes[0]) | (static_cast<uint64_t>(codes[1]) << 16) | (static_cast<uint64_t>(codes[2]) << 32);
+
+                int largest = static_cast<int>((packed >> 45) & 0x3);
+
+                float sum_sq = 0.0f;
+                int   shift = 30;
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (i == largest)
+                        continue;
+
+                    uint32_t code = static_cast<uint32_t>((packed >> shift) & rotation_code_max);
+                    q[i] = (static_cast<float>(code) / rotation_code_max * 2.0f - 1.0f) * inv_sqrt2;
+                    sum_sq += q[i] * q[i];
+                    shift -= 15;
+                }
+
+                q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum_sq));
+            }
+
+            void encodeVector(float const* v, float const* range_min, float const* range_extent, uint16_t* codes)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    float normalized = range_extent[i] > 0.0f ? std::clamp((v[i] - range_min[i]) / range_extent[i], 0.0f, 1.0f) : 0.0f;
+                    codes[i] = static_cast<uint16_t>(std::lround(normalized * vector_code_max));
+                }
+            }
+
+            inline void decodeVector(uint16_t const* codes, float const* range_min, float const* range_extent, float* v)
+            {
+                for (int i = 0; i < 3; ++i) {
+                    v[i] = range_min[i] + static_cast<float>(codes[i]) / vector_code_max * range_extent[i];
+                }
+                v[3] = 0.0f;
+            }
+
+            /**
+            * Wide smallest-three encoding in 6 codes: the other components in 31 bits each, the index of the largest
+            * component in the top bits of the first two 32 bit words
+            */
+            void encodeRotationWide(float const* q, uint16_t* codes)
+            {
+                int largest = 0;
+                for (int i = 1; i < 4; ++i)
+                {
+                    if (std::abs(q[i]) > std::abs(q[largest]))
+                        largest = i;
+                }
+
+                float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+                int word = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (i == largest)
+                        continue;
+
+                    double normalized = std::clamp((double(q[i]) * sign / inv_sqrt2 + 1.0) * 0.5, 0.0, 1.0);
+                    uint32_t code = static_cast<uint32_t>(std::llround(normalized * wide_rotation_code_max));
+                    if (word < 2) {
+                        code |= static_cast<uint32_t>((largest >> word) & 0x1) << 31;
+                    }
+
+                    codes[word * 2] = static_cast<uint16_t>(code & 0xFFFF);
+                    codes[word * 2 + 1] = static_cast<uint16_t>(code >> 16);
+                    ++word;
+                }
+            }
+
+            inline void decodeRotationWide(uint16_t const* codes, float* q)
+            {
+                uint32_t words[3];
+                for (int w = 0; w < 3; ++w) {
+                    words[w] = static_cast<uint32_t>(codes[w * 2]) | (static_cast<uint32_t>(codes[w * 2 + 1]) << 16);
+                }
+
+                int largest = static_cast<int>((words[0] >> 31) | ((words[1] >> 31) << 1));
+
+                float sum_sq = 0.0f;
+                int   word = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (i == largest)
+                        continue;
+
+                    uint32_t code = words[word++] & wide_rotation_code_max;
+                    q[i] = static_cast<float>((double(code) / wide_rotation_code_max * 2.0 - 1.0) * inv_sqrt2);
+                    sum_sq += q[i] * q[i];
+                }
+
+                q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum_sq));
+            }
+
+            /** Wide vectors are stored as plain floats, i.e. without quantization error */
+            void encodeVectorWide(float const* v, uint16_t* codes)
+            {
+                std::memcpy(codes, v, 3 * sizeof(float));
+            }
+
+            inline void decodeVectorWide(uint16_t const* codes, float* v)
+            {
+                std::memcpy(v, codes, 3 * sizeof(float));
+                v[3] = 0.0f;
+            }
+
+            /** Linear interpolation of vectors, normalized linear interpolation along the shorter path for quaternions */
+            inline void interpolate(float const* a, float const* b, float t, bool is_rotation, float* result)
+            {
+                if (is_rotation)
+                {
+                    float cos_theta = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+                    float sign = cos_theta < 0.0f ? -1.0f : 1.0f;
+
+                    float length_sq = 0.0f;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        result[i] = a[i] * (1.0f - t) + b[i] * sign * t;
+                        length_sq += result[i] * result[i];
+                    }
+
+                    float inv_length = 1.0f / std::sqrt(length_sq);
+                    for (int i = 0; i < 4; ++i) {
+                        result[i] *= inv_length;
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < 4; ++i) {
+                        result[i] = a[i] * (1.0f - t) + b[i] * t;
+                    }
+                }
+            }
+
+            /** Rotation angle between two unit quaternions, computed from the chord length to stay accurate for small angles */
+            double rotationError(float const* a, float const* b)
+            {
+                double cos_theta = double(a[0]) * b[0] + double(a[1]) * b[1] + double(a[2]) * b[2] + double(a[3]) * b[3];
+                double sign = cos_theta < 0.0 ? -1.0 : 1.0;
+
+                double chord_sq = 0.0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    double d = double(a[i]) - sign * double(b[i]);
+                    chord_sq += d * d;
+                }
+
+                return 4.0 * std::asin(std::min(1.0, std::sqrt(chord_sq) * 0.5));
+            }
+
+            double vectorError(float const* a, float const* b)
+            {
+                double sum_sq = 0.0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    double d = double(a[i]) - double(b[i]);
+                    sum_sq += d * d;
+                }
+                return std::sqrt(sum_sq);
+            }
+
+            /**
+            * Append the samples of a resampled spline interval [t0, t1] without the sample at t0. The interval is split until
+            * linear interpolation between its samples stays within max_error of the spline at regular check points.
+            */
+            void refineResampledInterval(
+                AnimationClip const& clip,
+                AnimationClip::Channel const& channel,
+                bool is_rotation,
+                double max_error,
+                float t0,
+                float const* v0,
+                float t1,
+                float const* v1,
+                uint32_t depth,
+                ChannelKeys& keys)
+            {
+                // a few levels suffice for smooth splines, protects against discontinuous ones
+                uint32_t const max_depth = 8;
+                uint32_t const check_cnt = 8;
+
+                uint32_t key_hint = 0;
+
+                bool is_valid = true;
+                for (uint32_t i = 1; i < check_cnt && is_valid && depth < max_depth; ++i)
+                {
+                    float t = static_cast<float>(i) / static_cast<float>(check_cnt);
+                    float spline_value[4];
+                    float interpolated_value[4];
+                    sampleChannel(clip, channel, t0 + (t1 - t0) * t, key_hint, spline_value);
+                    interpolate(v0, v1, t, is_rotation, interpolated_value);
+
+                    if (is_rotation) {
+                        normalizeQuaternion(spline_value);
+                    }
+
+                    is_valid = (is_rotation ? rotationError(spline_value, interpolated_value) : vectorError(spline_value, interpolated_value)) <= max_error;
+                }
+
+                if (!is_valid)
+                {
+                    float t_mid = 0.5f * (t0 + t1);
+                    float v_mid[4];
+                    sampleChannel(clip, channel, t_mid, key_hint, v_mid);
+                    if (is_rotation) {
+                        normalizeQuaternion(v_mid);
+                    }
+
+                    refineResampledInterval(clip, channel, is_rotation, max_error, t0, v0, t_mid, v_mid, depth + 1, keys);
+                    refineResampledInterval(clip, channel, is_rotation, max_error, t_mid, v_mid, t1, v1, depth + 1, keys);
+                    return;
+                }
+
+                keys.times.push_back(t1);
+                keys.values.insert(keys.values.end(), v1, v1 + 4);
+            }
+
+            /**
+            * Insert samples into a resampled spline channel where linear interpolation deviates more than max_error from the spline
+            */
+            void refineResampling(AnimationClip const& clip, AnimationClip::Channel const& channel, bool is_rotation, double max_error, ChannelKeys& keys)
+            {
+                if (keys.times.size() < 2)
+                    return;
+
+                ChannelKeys refined_keys;
+                refined_keys.step = keys.step;
+                refined_keys.times.push_back(keys.times[0]);
+                refined_keys.values.insert(refined_keys.values.end(), keys.values.begin(), keys.values.begin() + 4);
+
+                std::vector<float> values = keys.values;
+                if (is_rotation)
+                {
+                    for (size_t k = 0; k < keys.times.size(); ++k) {
+                        normalizeQuaternion(values.data() + k * 4);
+                    }
+                }
+
+                for (size_t k = 0; k + 1 < keys.times.size(); ++k)
+                {
+                    refineResampledInterval(clip, channel, is_rotation, max_error,
+                        keys.times[k], values.data() + k * 4, keys.times[k + 1], values.data() + (k + 1) * 4, 0, refined_keys);
+                }
+
+                keys = std::move(refined_keys);
+            }
+
+            /**
+            * Length of the longest joint chain below each target plus the shell distance, i.e. the distance at which
+            * rotation and scale errors of the target show up as position errors
+            */
+            std::vector<float> computeChainLengths(
+                AnimationClip const& clip,
+                std::vector<ChannelKeys> const& channel_keys,
+                AnimationCompressionSettings const& settings)
+            {
+                size_t target_cnt = clip.target_ids.size();
+
+                std::vector<float> bone_lengths(target_cnt, 0.0f);
+                std::vector<bool>  has_translation(target_cnt, false);
+
+                for (size_t c = 0; c < clip.channels.size(); ++c)
+                {
+                    auto const& channel = clip.channels[c];
+                    if (channel.path == AnimationClip::Path::TRANSLATION && !channel_keys[c].values.empty())
+                    {
+                        // longest translation of the channel, which covers e.g. stretching bones
+                        for (size_t k = 0; k < channel_keys[c].times.size(); ++k)
+                        {
+                            float const* v = channel_keys[c].values.data() + k * 4;
+                            bone_lengths[channel.target] = std::max(bone_lengths[channel.target], std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+                        }
+                        has_translation[channel.target] = true;
+                    }
+                }
+
+                for (size_t t = 0; t < target_cnt && t < settings.rest_translations.size(); ++t)
+                {
+                    if (!has_translation[t]) {
+                        bone_lengths[t] = glm::length(settings.rest_translations[t]);
+                    }
+                }
+
+                std::vector<float> reach(target_cnt, 0.0f);
+
+                if (settings.target_parents.size() == target_cnt)
+                {
+                    for (size_t t = 0; t < target_cnt; ++t)
+                    {
+                        float  distance = 0.0f;
+                        size_t current = t;
+
+                        // bounded walk, protects against cycles in malformed input
+                        for (size_t depth = 0; depth < target_cnt && settings.target_parents[current] >= 0; ++depth)
+                        {
+                            distance += bone_lengths[current];
+                            current = static_cast<size_t>(settings.target_parents[current]);
+                            reach[current] = std::max(reach[current], distance);
+                        }
+                    }
+                }
+
+                for (auto& r : reach) {
+                    r += settings.shell_distance;
+                }
+
+                return reach;
+            }
+
+            /**
+            * Greedy error-bounded key reduction. Each kept segment is extended as long as interpolating the decoded
+            * end keys reproduces all original keys in between within the tolerance.
+            */
+            std::vector<uint32_t> reduceKeys(
+                ChannelKeys const& keys,
+                std::vector<float> const& decoded_values,
+                bool is_rotation,
+                double tolerance)
+            {
+                uint32_t key_cnt = static_cast<uint32_t>(keys.times.size());
+
+                auto error = [is_rotation](float const* a, float const* b) {
+                    return is_rotation ? rotationError(a, b) : vectorError(a, b);
+                };
+
+                // constant channels only need a single key
+                bool is_constant = true;
+                for (uint32_t k = 0; k < key_cnt && is_constant; ++k) {
+                    is_constant = error(decoded_values.data(), keys.values.data() + static_cast<size_t>(k) * 4) <= tolerance;
+                }
+                if (is_constant) {
+                    return { 0 };
+                }
+
+                std::vector<uint32_t> retval = { 0 };
+
+                if (keys.step)
+                {
+                    for (uint32_t k = 1; k < key_cnt; ++k)
+                    {
+                        if (error(decoded_values.data() + static_cast<size_t>(retval.back()) * 4, keys.values.data() + static_cast<size_t>(k) * 4) > tolerance) {
+                            retval.push_back(k);
+                        }
+                    }
+                    return retval;
+                }
+
+                uint32_t segment_begin = 0;
+                while (segment_begin + 1 < key_cnt)
+                {
+                    uint32_t segment_end = segment_begin + 1;
+
+                    while (segment_end + 1 < key_cnt)
+                    {
+                        uint32_t candidate_end = segment_end + 1;
+                        float const* a = decoded_values.data() + static_cast<size_t>(segment_begin) * 4;
+                        float const* b = decoded_values.data() + static_cast<size_t>(candidate_end) * 4;
+                        float interval = keys.times[candidate_end] - keys.times[segment_begin];
+
+                        bool is_valid = true;
+                        for (uint32_t k = segment_begin + 1; k < candidate_end && is_valid; ++k)
+                        {
+                            float t = interval > 0.0f ? (keys.times[k] - keys.times[segment_begin]) / interval : 0.0f;
+                            float value[4];
+                            interpolate(a, b, t, is_rotation, value);
+                            is_valid = error(value, keys.values.data() + static_cast<size_t>(k) * 4) <= tolerance;
+                        }
+
+                        if (!is_valid)
+                            break;
+
+                        segment_end = candidate_end;
+                    }
+
+                    retval.push_back(segment_end);
+                    segment_begin = segment_end;
+                }
+
+                return retval;
+            }
+
+            template<typename T>
+            void appendBytes(std::vector<uint8_t>& data, T const& value)
+            {
+                uint8_t const* bytes = reinterpret_cast<uint8_t const*>(&value);
+                data.insert(data.end(), bytes, bytes + sizeof(T));
+            }
+
+            /** Number of 16 bit codes per key */
+            inline uint32_t codeCount(CompressedAnimationClip::Channel const& channel)
+            {
+                return channel.wide ? 6 : 3;
+            }
+
+            void encodeKey(CompressedAnimationClip::Channel const& channel, float const* value, uint16_t* codes)
+            {
+                if (channel.path == AnimationClip::Path::ROTATION) {
+                    channel.wide ? encodeRotationWide(value, codes) : encodeRotation(value, codes);
+                }
+                else {
+                    channel.wide ? encodeVectorWide(value, codes) : encodeVector(value, channel.range_min, channel.range_extent, codes);
+                }
+            }
+
+            inline void decodeKey(CompressedAnimationClip::Channel const& channel, uint16_t const* codes, float* value)
+            {
+                if (channel.path == AnimationClip::Path::ROTATION) {
+                    channel.wide ? decodeRotationWide(codes, value) : decodeRotation(codes, value);
+                }
+                else {
+                    channel.wide ? decodeVectorWide(codes, value) : decodeVector(codes, channel.range_min, channel.range_extent, value);
+                }
+            }
+
+            /** Indices of the first and last key needed for sampling [begin_time, end_time], including the enclosing keys */
+            inline std::pair<size_t, size_t> findBlockKeys(std::vector<float> const& times, float begin_time, float end_time)
+            {
+                size_t first = static_cast<size_t>(std::max<ptrdiff_t>(0, (std::upper_bound(times.begin(), times.end(), begin_time) - times.begin()) - 1));
+                size_t last = std::min(times.size() - 1, static_cast<size_t>(std::lower_bound(times.begin(), times.end(), end_time) - times.begin()));
+                return { first, std::max(first, last) };
+            }
+
+            /** Append the keys [first, last] of a channel to a block: time range, key count, 16 bit key times and key codes */
+            void appendChannelBlock(
+                std::vector<uint8_t>& data,
+                std::vector<float> const& times,
+                std::vector<uint16_t> const& codes,
+                uint32_t code_cnt,
+                size_t first,
+                size_t last)
+            {
+                float    t0 = times[first];
+                float    t1 = times[last];
+                uint16_t key_cnt = static_cast<uint16_t>(last - first + 1);
+
+                appendBytes(data, t0);
+                appendBytes(data, t1);
+                appendBytes(data, key_cnt);
+
+                for (size_t k = first; k <= last; ++k)
+                {
+                    float normalized = t1 > t0 ? (times[k] - t0) / (t1 - t0) : 0.0f;
+                    appendBytes(data, static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * vector_code_max)));
+                }
+
+                for (size_t k = first; k <= last; ++k)
+                {
+                    for (uint32_t i = 0; i < code_cnt; ++i) {
+                        appendBytes(data, codes[k * code_cnt + i]);
+                    }
+                }
+            }
+
+            /** Sample the keys of a channel within a block, see appendChannelBlock */
+            void sampleChannelBlock(CompressedAnimationClip::Channel const& channel, uint8_t const* channel_data, float time, float* value)
+            {
+                float    t0, t1;
+                uint16_t key_cnt;
+                std::memcpy(&t0, channel_data, sizeof(float));
+                std::memcpy(&t1, channel_data + 4, sizeof(float));
+                std::memcpy(&key_cnt, channel_data + 8, sizeof(uint16_t));
+
+                // all block and channel offsets are even, so 16 bit reads are aligned
+                uint16_t const* key_times = reinterpret_cast<uint16_t const*>(channel_data + 10);
+                uint16_t const* key_codes = key_times + key_cnt;
+                uint32_t        code_cnt = codeCount(channel);
+
+                if (key_cnt == 1 || t1 <= t0)
+                {
+                    decodeKey(channel, key_codes, value);
+                    return;
+                }
+
+                float local_time = std::clamp((time - t0) / (t1 - t0), 0.0f, 1.0f) * vector_code_max;
+
+                uint32_t k = static_cast<uint32_t>(std::upper_bound(key_times, key_times + key_cnt, local_time,
+                    [](float t, uint16_t key_time) { return t < static_cast<float>(key_time); }) - key_times);
+                k = std::clamp(k, 1u, static_cast<uint32_t>(key_cnt) - 1u) - 1;
+
+                float interval = static_cast<float>(key_times[k + 1]) - static_cast<float>(key_times[k]);
+                float t = interval > 0.0f ? std::clamp((local_time - key_times[k]) / interval, 0.0f, 1.0f) : 0.0f;
+
+                if (channel.step)
+                {
+                    decodeKey(channel, key_codes + (t >= 1.0f ? k + 1 : k) * code_cnt, value);
+                }
+                else
+                {
+                    float a[4], b[4];
+                    decodeKey(channel, key_codes + k * code_cnt, a);
+                    decodeKey(channel, key_codes + (k + 1) * code_cnt, b);
+                    interpolate(a, b, t, channel.path == AnimationClip::Path::ROTATION, value);
+                }
+            }
+
+            inline void writeOutput(AnimationClip::Path path, float const* value, size_t target, Vec3* positions, Quat* orientations, Vec3* scales)
+            {
+                switch (path)
+                {
+                case AnimationClip::Path::TRANSLATION:
+                    positions[target] = Vec3(value[0], value[1], value[2]);
+                    break;
+                case AnimationClip::Path::ROTATION:
+                    orientations[target] = Quat(value[3], value[0], value[1], value[2]);
+                    break;
+                case AnimationClip::Path::SCALE:
+                    scales[target] = Vec3(value[0], value[1], value[2]);
+                    break;
+                }
+            }
+        }
+
+        size_t CompressedAnimationClip::computeByteSize() const
+        {
+            return data.size() + channels.size() * sizeof(Channel) + blocks.size() * sizeof(Block) + target_ids.size() * sizeof(uint32_t);
+        }
+
+        CompressedAnimationClip compressAnimationClip(AnimationClip const& clip, AnimationCompressionSettings const& settings)
+        {
+            CompressedAnimationClip retval;
+            retval.name = clip.name;
+            retval.duration = clip.duration;
+            retval.target_ids = clip.target_ids;
+
+            std::vector<ChannelKeys> channel_keys;
+            channel_keys.reserve(clip.channels.size());
+            for (auto const& channel : clip.channels) {
+                channel_keys.push_back(channel.key_cnt > 0 ? gatherKeys(clip, channel, settings.sample_rate) : ChannelKeys());
+            }
+
+            std::vector<float> chain_lengths = computeChainLengths(clip, channel_keys, settings);
+
+            // quantize and reduce keys per channel
+            std::vector<ChannelKeys const*>    source_keys;
+            std::vector<double>                tolerances;
+            std::vector<std::vector<uint16_t>> channel_codes;
+            std::vector<std::vector<uint32_t>> kept_keys;
+
+            for (size_t c = 0; c < clip.channels.size(); ++c)
+            {
+                auto const& channel = clip.channels[c];
+                auto&       keys = channel_keys[c];
+
+                if (keys.times.empty())
+                    continue;
+
+                bool is_rotation = channel.path == AnimationClip::Path::ROTATION;
+
+                double tolerance = settings.position_tolerance;
+                if (channel.path != AnimationClip::Path::TRANSLATION) {
+                    tolerance /= chain_lengths[channel.target];
+                }
+
+                // Key reduction only checks the resampled keys, so a quarter of the tolerance is left for the resampling error
+                if (channel.interpolation == AnimationClip::Interpolation::CUBICSPLINE)
+                {
+                    refineResampling(clip, channel, is_rotation, tolerance * 0.25, keys);
+                    tolerance *= 0.75;
+                }
+
+                uint32_t key_cnt = static_cast<uint32_t>(keys.times.size());
+
+                CompressedAnimationClip::Channel compressed_channel;
+                compressed_channel.target = channel.target;
+                compressed_channel.path = channel.path;
+                compressed_channel.step = keys.step;
+                compressed_channel.wide = false;
+
+                for (int i = 0; i < 3; ++i)
+                {
+                    float range_max = keys.values[i];
+                    compressed_channel.range_min[i] = keys.values[i];
+                    for (uint32_t k = 1; k < key_cnt; ++k)
+                    {
+                        compressed_channel.range_min[i] = std::min(compressed_channel.range_min[i], keys.values[k * 4 + i]);
+                        range_max = std::max(range_max, keys.values[k * 4 + i]);
+                    }
+                    compressed_channel.range_extent[i] = range_max - compressed_channel.range_min[i];
+                }
+
+                if (is_rotation)
+                {
+                    for (uint32_t k = 0; k < key_cnt; ++k) {
+                        normalizeQuaternion(keys.values.data() + static_cast<size_t>(k) * 4);
+                    }
+                }
+
+                std::vector<uint16_t> codes;
+                std::vector<float>    decoded_values(static_cast<size_t>(key_cnt) * 4);
+
+                auto quantize = [&]() {
+                    uint32_t code_cnt = codeCount(compressed_channel);
+                    codes.resize(static_cast<size_t>(key_cnt) * code_cnt);
+
+                    double max_error = 0.0;
+                    for (uint32_t k = 0; k < key_cnt; ++k)
+                    {
+                        float const* value = keys.values.data() + static_cast<size_t>(k) * 4;
+                        float*       decoded_value = decoded_values.data() + static_cast<size_t>(k) * 4;
+
+                        encodeKey(compressed_channel, value, codes.data() + k * code_cnt);
+                        decodeKey(compressed_channel, codes.data() + k * code_cnt, decoded_value);
+
+                        max_error = std::max(max_error, is_rotation ? rotationError(decoded_value, value) : vectorError(decoded_value, value));
+                    }
+                    return max_error;
+                };
+
+                // Key reduction only checks the keys it removes, the error of the kept keys is the quantization error.
+                // Use wide codes if 16 bits already take more than half of the tolerance, e.g. for large translation ranges.
+                if (quantize() > tolerance * 0.5)
+                {
+                    compressed_channel.wide = true;
+                    quantize();
+                }
+
+                retval.channels.push_back(compressed_channel);
+                source_keys.push_back(&keys);
+                tolerances.push_back(tolerance);
+                kept_keys.push_back(reduceKeys(keys, decoded_values, is_rotation, tolerance));
+                channel_codes.push_back(std::move(codes));
+            }
+
+            // split into time blocks of roughly the requested size, the key count per channel and block has to fit 16 bit
+            size_t channel_cnt = retval.channels.size();
+            size_t total_size = 0;
+            size_t max_key_cnt = 0;
+            for (size_t c = 0; c < channel_cnt; ++c)
+            {
+                total_size += 10 + kept_keys[c].size() * (1 + codeCount(retval.channels[c])) * sizeof(uint16_t);
+
+                // the error check below might restore any key
+                max_key_cnt = std::max(max_key_cnt, source_keys[c]->times.size());
+            }
+
+            size_t block_cnt = std::max<size_t>(1, (total_size + settings.block_size - 1) / std::max<uint32_t>(settings.block_size, 1));
+            block_cnt = std::max(block_cnt, (max_key_cnt + 32767) / 32768);
+            if (retval.duration <= 0.0f) {
+                block_cnt = 1;
+            }
+
+            // gather kept keys and codes per channel
+            std::vector<std::vector<float>>    kept_times(channel_cnt);
+            std::vector<std::vector<uint16_t>> kept_codes(channel_cnt);
+
+            auto gather_kept_keys = [&](size_t c) {
+                uint32_t code_cnt = codeCount(retval.channels[c]);
+                kept_times[c].clear();
+                kept_codes[c].clear();
+                for (uint32_t k : kept_keys[c])
+                {
+                    kept_times[c].push_back(source_keys[c]->times[k]);
+                    kept_codes[c].insert(kept_codes[c].end(), channel_codes[c].begin() + k * code_cnt, channel_codes[c].begin() + (k + 1) * code_cnt);
+                }
+            };
+
+            for (size_t c = 0; c < channel_cnt; ++c) {
+                gather_kept_keys(c);
+            }
+
+            // Key times are quantized to 16 bits within the keys of each block, which shifts the kept keys in time.
+            // Sample the encoded blocks at all original key times and restore keys where the error exceeds the tolerance.
+            // If kept keys themselves are off, the blocks are too long for the time resolution and are split further.
+            // Step channels are skipped, sampling them exactly at their discontinuities is ill-defined.
+            std::vector<float>   block_begin_times;
+            std::vector<uint8_t> channel_block;
+
+            for (;;)
+            {
+                float block_duration = retval.duration / static_cast<float>(block_cnt);
+
+                block_begin_times.resize(block_cnt + 1);
+                for (size_t b = 0; b < block_cnt; ++b) {
+                    block_begin_times[b] = block_duration * static_cast<float>(b);
+                }
+                block_begin_times[block_cnt] = retval.duration;
+
+                bool needs_shorter_blocks = false;
+
+                for (size_t c = 0; c < channel_cnt; ++c)
+                {
+                    auto const& channel = retval.channels[c];
+                    auto const& keys = *source_keys[c];
+                    bool        is_rotation = channel.path == AnimationClip::Path::ROTATION;
+
+                    if (channel.step)
+                        continue;
+
+                    std::vector<uint32_t> restored_keys;
+                    do
+                    {
+                        restored_keys.clear();
+
+                        for (size_t b = 0; b < block_cnt; ++b)
+                        {
+                            auto [first, last] = findBlockKeys(kept_times[c], block_begin_times[b], block_begin_times[b + 1]);
+
+                            channel_block.clear();
+                            appendChannelBlock(channel_block, kept_times[c], kept_codes[c], codeCount(channel), first, last);
+
+                            // keys sampled from this block, times outside of the clip are clamped when sampling
+                            auto key_begin = std::lower_bound(keys.times.begin(), keys.times.end(), b == 0 ? 0.0f : block_begin_times[b]);
+                            auto key_end = b + 1 < block_cnt
+                                ? std::lower_bound(keys.times.begin(), keys.times.end(), block_begin_times[b + 1])
+                                : std::upper_bound(keys.times.begin(), keys.times.end(), retval.duration);
+
+                            for (auto key = key_begin; key < key_end; ++key)
+                            {
+                                uint32_t k = static_cast<uint32_t>(key - keys.times.begin());
+                                float const* value = keys.values.data() + static_cast<size_t>(k) * 4;
+
+                                float sampled_value[4];
+                                sampleChannelBlock(channel, channel_block.data(), *key, sampled_value);
+
+                                double error = is_rotation ? rotationError(sampled_value, value) : vectorError(sampled_value, value);
+                                if (error <= tolerances[c])
+                                    continue;
+
+                                if (std::binary_search(kept_keys[c].begin(), kept_keys[c].end(), k)) {
+                                    needs_shorter_blocks = true;
+                                }
+                                else {
+                                    restored_keys.push_back(k);
+                                }
+                            }
+                        }
+
+                        if (!restored_keys.empty())
+                        {
+                            std::vector<uint32_t> merged_keys;
+                            std::merge(kept_keys[c].begin(), kept_keys[c].end(), restored_keys.begin(), restored_keys.end(), std::back_inserter(merged_keys));
+                            kept_keys[c] = std::move(merged_keys);
+
+                            gather_kept_keys(c);
+                        }
+                    } while (!restored_keys.empty());
+                }
+
+                // with a block per key, the remaining error is the quantization error of the values
+                if (!needs_shorter_blocks || block_cnt >= max_key_cnt || retval.duration <= 0.0f)
+                    break;
+
+                block_cnt = std::min(block_cnt * 2, max_key_cnt);
+            }
+
+            for (size_t b = 0; b < block_cnt; ++b)
+            {
+                float begin_time = block_begin_times[b];
+                float end_time = block_begin_times[b + 1];
+
+                size_t block_offset = retval.data.size();
+                retval.blocks.push_back({ begin_time, static_cast<uint32_t>(block_offset) });
+
+                // channel offset table
+                retval.data.resize(block_offset + channel_cnt * sizeof(uint32_t));
+
+                for (size_t c = 0; c < channel_cnt; ++c)
+                {
+                    // include the keys enclosing the block, so that sampling never needs keys of other blocks
+                    auto [first, last] = findBlockKeys(kept_times[c], begin_time, end_time);
+
+                    uint32_t channel_offset = static_cast<uint32_t>(retval.data.size() - block_offset);
+                    std::memcpy(retval.data.data() + block_offset + c * sizeof(uint32_t), &channel_offset, sizeof(uint32_t));
+
+                    appendChannelBlock(retval.data, kept_times[c], kept_codes[c], codeCount(retval.channels[c]), first, last);
+                }
+            }
+
+            return retval;
+        }
+
+        void samplePose(
+            CompressedAnimationClip const& clip,
+            float time,
+            Vec3* positions,
+            Quat* orientations,
+            Vec3* scales)
+        {
+            if (clip.blocks.empty())
+                return;
+
+            time = std::clamp(time, 0.0f, clip.duration);
+
+            auto block_query = std::upper_bound(clip.blocks.begin(), clip.blocks.end(), time,
+                [](float t, CompressedAnimationClip::Block const& block) { return t < block.begin_time; });
+            size_t block_idx = block_query == clip.blocks.begin() ? 0 : static_cast<size_t>(block_query - clip.blocks.begin()) - 1;
+
+            uint8_t const* block = clip.data.data() + clip.blocks[block_idx].byte_offset;
+
+            for (size_t c = 0; c < clip.channels.size(); ++c)
+            {
+                auto const& channel = clip.channels[c];
+
+                uint32_t channel_offset;
+                std::memcpy(&channel_offset, block + c * sizeof(uint32_t), sizeof(uint32_t));
+
+                float value[4];
+                sampleChannelBlock(channel, block + channel_offset, time, value);
+
+                writeOutput(channel.path, value, channel.target, positions, orientations, scales);
+            }
+        }
+
+        void samplePose(
+            AnimationClip const& clip,
+            float time,
+            uint32_t* key_hints,
+            Vec3* positions,
+            Quat* orientations,
+            Vec3* scales)
+        {
+            for (size_t c = 0; c < clip.channels.size(); ++c)
+            {
+                float value[4];
+                sampleChannel(clip, clip.channels[c], time, key_hints[c], value);
+                writeOutput(clip.channels[c].path, value, clip.channels[c].target, positions, orientations, scales);
+            }
+        }
+
+        AnimationCompressionReport evaluateAnimationCompression(
+            AnimationClip const& clip,
+            CompressedAnimationClip const& compressed_clip,
+            uint32_t sample_cnt)
+        {
+            AnimationCompressionReport retval;
+            retval.uncompressed_size = (clip.times.size() + clip.values.size()) * sizeof(float)
+                + clip.channels.size() * sizeof(AnimationClip::Channel) + clip.target_ids.size() * sizeof(uint32_t);
+            retval.compressed_size = compressed_clip.computeByteSize();
+            retval.max_position_error = 0.0f;
+            retval.max_rotation_error = 0.0f;
+            retval.max_scale_error = 0.0f;
+
+            sample_cnt = std::max(sample_cnt, 2u);
+            size_t target_cnt = clip.target_ids.size();
+
+            std::vector<uint32_t> key_hints(clip.channels.size(), 0);
+            std::vector<Vec3> positions(target_cnt), compressed_positions(target_cnt);
+            std::vector<Quat> orientations(target_cnt), compressed_orientations(target_cnt);
+            std::vector<Vec3> scales(target_cnt), compressed_scales(target_cnt);
+
+            auto sample_time = [&clip, sample_cnt](uint32_t s) {
+                return clip.duration * static_cast<float>(s) / static_cast<float>(sample_cnt - 1);
+            };
+
+            // accuracy
+            for (uint32_t s = 0; s < sample_cnt; ++s)
+            {
+                float time = sample_time(s);
+                samplePose(clip, time, key_hints.data(), positions.data(), orientations.data(), scales.data());
+                samplePose(compressed_clip, time, compressed_positions.data(), compressed_orientations.data(), compressed_scales.data());
+
+                for (auto const& channel : clip.channels)
+                {
+                    uint32_t t = channel.target;
+                    switch (channel.path)
+                    {
+                    case AnimationClip::Path::TRANSLATION:
+                        retval.max_position_error = std::max(retval.max_position_error, glm::length(positions[t] - compressed_positions[t]));
+                        break;
+                    case AnimationClip::Path::ROTATION:
+                    {
+                        float a[4] = { orientations[t].x, orientations[t].y, orientations[t].z, orientations[t].w };
+                        float b[4] = { compressed_orientations[t].x, compressed_orientations[t].y, compressed_orientations[t].z, compressed_orientations[t].w };
+                        retval.max_rotation_error = std::max(retval.max_rotation_error, static_cast<float>(rotationError(a, b)));
+                        break;
+                    }
+                    case AnimationClip::Path::SCALE:
+                        retval.max_scale_error = std::max(retval.max_scale_error, glm::length(scales[t] - compressed_scales[t]));
+                        break;
+                    }
+                }
+            }
+
+            // throughput
+            std::fill(key_hints.begin(), key_hints.end(), 0);
+            auto t_0 = std::chrono::high_resolution_clock::now();
+            for (uint32_t s = 0; s < sample_cnt; ++s) {
+                samplePose(clip, sample_time(s), key_hints.data(), positions.data(), orientations.data(), scales.data());
+            }
+            auto t_1 = std::chrono::high_resolution_clock::now();
+            for (uint32_t s = 0; s < sample_cnt; ++s) {
+                samplePose(compressed_clip, sample_time(s), compressed_positions.data(), compressed_orientations.data(), compressed_scales.data());
+            }
+            auto t_2 = std::chrono::high_resolution_clock::now();
+
+            double uncompressed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(t_1 - t_0).count();
+            double compressed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(t_2 - t_1).count();
+            retval.uncompressed_poses_per_second = uncompressed_seconds > 0.0 ? sample_cnt / uncompressed_seconds : 0.0;
+            retval.compressed_poses_per_second = compressed_seconds > 0.0 ? sample_cnt / compressed_seconds : 0.0;
+
+            return retval;
+        }
+
+        bool saveCompressedAnimationClip(std::string const& path, CompressedAnimationClip const& clip)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+            if (!file.is_open())
+                return false;
+
+            file.write(compressed_clip_file_magic, 4);
+            writeValue(file, compressed_clip_file_version);
+
+            writeValue(file, static_cast<uint32_t>(clip.name.size()));
+            file.write(clip.name.data(), clip.name.size());
+            writeValue(file, clip.duration);
+
+            writeValue(file, static_cast<uint32_t>(clip.target_ids.size()));
+            file.write(reinterpret_cast<char const*>(clip.target_ids.data()), clip.target_ids.size() * sizeof(uint32_t));
+
+            writeValue(file, static_cast<uint32_t>(clip.channels.size()));
+            for (auto const& channel : clip.channels)
+            {
+                writeValue(file, channel.target);
+                writeValue(file, static_cast<uint8_t>(channel.path));
+                writeValue(file, static_cast<uint8_t>(channel.step ? 1 : 0));
+                writeValue(file, static_cast<uint8_t>(channel.wide ? 1 : 0));
+                for (int i = 0; i < 3; ++i) {
+                    writeValue(file, channel.range_min[i]);
+                }
+                for (int i = 0; i < 3; ++i) {
+                    writeValue(file, channel.range_extent[i]);
+                }
+            }
+
+            writeValue(file, static_cast<uint32_t>(clip.blocks.size()));
+            for (auto const& block : clip.blocks)
+            {
+                writeValue(file, block.begin_time);
+                writeValue(file, block.byte_offset);
+            }
+
+            writeValue(file, static_cast<uint64_t>(clip.data.size()));
+            file.write(reinterpret_cast<char const*>(clip.data.data()), clip.data.size());
+
+            return static_cast<bool>(file);
+        }
+
+        bool loadCompressedAnimationClip(std::string const& path, CompressedAnimationClip& clip)
+        {
+            std::ifstream file(path, std::ios::binary);
+
+            if (!file.is_open())
+                return false;
+
+            char magic[4];
+            uint32_t version;
+
+            if (!file.read(magic, 4) || std::memcmp(magic, compressed_clip_file_magic, 4) != 0)
+                return false;
+
+            if (!readValue(file, version) || version != compressed_clip_file_version)
+                return false;
+
+            CompressedAnimationClip retval;
+
+            uint32_t name_length;
+            if (!readValue(file, name_length))
+                return false;
+            retval.name.resize(name_length);
+            if (!file.read(retval.name.data(), name_length) || !readValue(file, retval.duration))
+                return false;
+
+            uint32_t target_cnt;
+            if (!readValue(file, target_cnt))
+                return false;
+            retval.target_ids.resize(target_cnt);
+            if (!file.read(reinterpret_cast<char*>(retval.target_ids.data()), target_cnt * sizeof(uint32_t)))
+                return false;
+
+            uint32_t channel_cnt;
+            if (!readValue(file, channel_cnt))
+                return false;
+            retval.channels.resize(channel_cnt);
+            for (auto& channel : retval.channels)
+            {
+                uint8_t channel_path, step, wide;
+                if (!readValue(file, channel.target) || !readValue(file, channel_path) || !readValue(file, step) || !readValue(file, wide))
+                    return false;
+                channel.path = static_cast<AnimationClip::Path>(channel_path);
+                channel.step = step != 0;
+                channel.wide = wide != 0;
+                for (int i = 0; i < 3; ++i) {
+                    if (!readValue(file, channel.range_min[i]))
+                        return false;
+                }
+                for (int i = 0; i < 3; ++i) {
+                    if (!readValue(file, channel.range_extent[i]))
+                        return false;
+                }
+                if (channel.target >= target_cnt)
+                    return false;
+            }
+
+            uint32_t block_cnt;
+            if (!readValue(file, block_cnt))
+                return false;
+            retval.blocks.resize(block_cnt);
+            for (auto& block : retval.blocks)
+            {
+                if (!readValue(file, block.begin_time) || !readValue(file, block.byte_offset))
+                    return false;
+            }
+
+            uint64_t data_size;
+            if (!readValue(file, data_size))
+                return false;
+            retval.data.resize(static_cast<size_t>(data_size));
+            if (!file.read(reinterpret_cast<char*>(retval.data.data()), data_size))
+                return false;
+
+            for (auto const& block : retval.blocks)
+            {
+                if (block.byte_offset + channel_cnt * sizeof(uint32_t) > retval.data.size())
+                    return false;
+            }
+
+            clip = std::move(retval);
+
+            return true;
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef AnimationCompression_hpp
+#define AnimationCompression_hpp
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AnimationClip.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Animation
+    {
+        /**
+        * \brief Animation clip with quantized and reduced keyframes.
+        *
+        * Rotations are stored as smallest-three quaternions in 48 bits, translations and scales as 16 bit values
+        * within the per-channel value range. Channels that these can't resolve within the tolerance use wide keys of
+        * 96 bits, i.e. 31 bit smallest-three quaternions and float vectors. The clip is split into time blocks of roughly equal byte size. Each block
+        * holds all keys needed to sample any channel within the block, so that sampling a pose only touches a
+        * single contiguous (and cache sized) range of memory.
+        */
+        struct CompressedAnimationClip
+        {
+            struct Channel
+            {
+                uint32_t            target;     ///< Index into target_ids
+                AnimationClip::Path path;
+                bool                step;       ///< Use step instead of linear interpolation
+                bool                wide;       ///< Keys use 6 instead of 3 16 bit codes
+                float               range_min[3];
+                float               range_extent[3];
+            };
+
+            struct Block
+            {
+                float    begin_time;
+                uint32_t byte_offset; ///< Offset of the block in data
+            };
+
+            std::string           name;
+            float                 duration = 0.0f;
+            std::vector<uint32_t> target_ids;
+            std::vector<Channel>  channels;
+            std::vector<Block>    blocks;
+            std::vector<uint8_t>  data;
+
+            /**
+            * \brief Returns the memory footprint of the keyframe data and channel descriptions in bytes
+            */
+            size_t computeByteSize() const;
+        };
+
+        typedef std::shared_ptr<CompressedAnimationClip const> CompressedAnimationClipPtr;
+
+        struct AnimationCompressionSettings
+        {
+            /**
+            * Maximum error in scene units, measured at the (virtual) vertices skinned to a joint chain. Rotation and
+            * scale errors of a joint are scaled by the length of the chain below the joint.
+            */
+            float position_tolerance = 0.0001f;
+
+            /** Minimum distance of skinned vertices from their joint, used for joints without known child bones */
+            float shell_distance = 0.03f;
+
+            /**
+            * Rate in Hz at which cubic spline channels are resampled. Samples are added between these where linear
+            * interpolation deviates from the spline by more than a quarter of the tolerance.
+            */
+            float sample_rate = 30.0f;
+
+            /** Target size of time blocks in bytes */
+            uint32_t block_size = 16384;
+
+            /** Parent of each target as index into the clip's target_ids, -1 for roots. Empty if unknown. */
+            std::vector<int32_t> target_parents;
+
+            /** Local rest translation of each target, used for bone lengths of targets without translation channel. Optional. */
+            std::vector<Vec3> rest_translations;
+        };
+
+        /**
+        * \brief Compress a clip. Channels are resampled where needed, quantized and then keyframes are removed as long
+        * as the error stays below the tolerance. The error is checked again after key times are quantized.
+        */
+        CompressedAnimationClip compressAnimationClip(AnimationClip const& clip, AnimationCompressionSettings const& settings);
+
+        /**
+        * \brief Sample all channels of a compressed clip.
+        * Each output array needs one entry per target. Only entries of animated targets and paths are written.
+        */
+        void samplePose(
+            CompressedAnimationClip const& clip,
+            float time,
+            Vec3* positions,
+            Quat* orientations,
+            Vec3* scales);
+
+        /**
+        * \brief Sample all channels of an uncompressed clip, same output as the compressed version
+        * \param key_hints One entry per channel, see sampleChannel
+        */
+        void samplePose(
+            AnimationClip const& clip,
+            float time,
+            uint32_t* key_hints,
+            Vec3* positions,
+            Quat* orientations,
+            Vec3* scales);
+
+        struct AnimationCompressionReport
+        {
+            size_t uncompressed_size;             ///< Bytes
+            size_t compressed_size;               ///< Bytes
+            float  max_position_error;            ///< Largest translation difference
+            float  max_rotation_error;            ///< Largest rotation difference in radians
+            float  max_scale_error;               ///< Largest scale difference
+            double uncompressed_poses_per_second;
+            double compressed_poses_per_second;
+        };
+
+        /**
+        * \brief Compare a compressed clip with its source in memory footprint, accuracy and sampling throughput.
+        * \param sample_cnt Number of poses sampled at increasing times, as during playback
+        */
+        AnimationCompressionReport evaluateAnimationCompression(
+            AnimationClip const& clip,
+            CompressedAnimationClip const& compressed_clip,
+            uint32_t sample_cnt = 1000);
+
+        /**
+        * \brief Write a compressed clip to a binary file
+        * \return Returns false if the file could not be written
+        */
+        bool saveCompressedAnimationClip(std::string const& path, CompressedAnimationClip const& clip);
+
+        /**
+        * \brief Read a clip previously written with saveCompressedAnimationClip
+        * \return Returns false if the file doesn't exist or is not a valid clip file
+        */
+        bool loadCompressedAnimationClip(std::string const& path, CompressedAnimationClip& clip);
+    }
+}
+
+#endif // !AnimationCompression_hpp
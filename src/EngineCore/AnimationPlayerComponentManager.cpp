@@ -0,0 +1,200 @@
+#include "AnimationPlayerComponentManager.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "TransformComponentManager.hpp"
+
+void EngineCore::Animation::AnimationPlayerComponentManager::addComponent(
+    Entity entity,
+    AnimationClipPtr const& clip,
+    std::vector<Entity> const& targets,
+    bool loop,
+    float speed)
+{
+    assert(clip == nullptr || clip->target_ids.size() == targets.size());
+
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    size_t idx = m_data.size();
+
+    addIndex(entity.id(), idx);
+
+    m_data.push_back(Data(entity, clip, targets, loop, speed));
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::setClip(Entity entity, AnimationClipPtr const& clip, std::vector<Entity> const& targets)
+{
+    assert(clip == nullptr || clip->target_ids.size() == targets.size());
+
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto& cmp = m_data[getIndex(entity)];
+    cmp = Data(entity, clip, targets, cmp.loop, cmp.speed);
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::addComponent(
+    Entity entity,
+    CompressedAnimationClipPtr const& clip,
+    std::vector<Entity> const& targets,
+    bool loop,
+    float speed)
+{
+    assert(clip == nullptr || clip->target_ids.size() == targets.size());
+
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    size_t idx = m_data.size();
+
+    addIndex(entity.id(), idx);
+
+    m_data.push_back(Data(entity, clip, targets, loop, speed));
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::setClip(Entity entity, CompressedAnimationClipPtr const& clip, std::vector<Entity> const& targets)
+{
+    assert(clip == nullptr || clip->target_ids.size() == targets.size());
+
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto& cmp = m_data[getIndex(entity)];
+    cmp = Data(entity, clip, targets, cmp.loop, cmp.speed);
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::play(Entity entity)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_data[getIndex(entity)].playing = true;
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::pause(Entity entity)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_data[getIndex(entity)].playing = false;
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::setTime(Entity entity, float time)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_data[getIndex(entity)].time = time;
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::setSpeed(Entity entity, float speed)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_data[getIndex(entity)].speed = speed;
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::setLoop(Entity entity, bool loop)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_data[getIndex(entity)].loop = loop;
+}
+
+bool EngineCore::Animation::AnimationPlayerComponentManager::isPlaying(Entity entity) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_data[getIndex(entity)].playing;
+}
+
+size_t EngineCore::Animation::AnimationPlayerComponentManager::getComponentCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_data.size();
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::update(
+    size_t first,
+    size_t last,
+    double dt,
+    Common::TransformComponentManager& transform_mngr)
+{
+    // the shared lock only protects the component array, each component is modified by a single caller
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    last = std::min(last, m_data.size());
+
+    std::vector<size_t> transform_indices;
+    std::vector<Vec3>   positions;
+    std::vector<Quat>   orientations;
+    std::vector<Vec3>   scales;
+
+    for (size_t i = first; i < last; ++i)
+    {
+        auto& cmp = m_data[i];
+
+        if (!cmp.playing || (cmp.clip == nullptr && cmp.compressed_clip == nullptr))
+            continue;
+
+        float duration = cmp.clip != nullptr ? cmp.clip->duration : cmp.compressed_clip->duration;
+
+        // advance playback time
+        cmp.time += static_cast<float>(dt) * cmp.speed;
+        if (cmp.loop && duration > 0.0f)
+        {
+            cmp.time = std::fmod(cmp.time, duration);
+            if (cmp.time < 0.0f) {
+                cmp.time += duration;
+            }
+        }
+        else if (cmp.time > duration || cmp.time < 0.0f)
+        {
+            // sample the last frame once more before stopping
+            cmp.time = std::clamp(cmp.time, 0.0f, duration);
+            cmp.playing = false;
+        }
+
+        size_t target_cnt = cmp.targets.size();
+
+        // capture the rest pose on first use
+        if (cmp.rest_positions.size() != target_cnt)
+        {
+            cmp.rest_positions.resize(target_cnt);
+            cmp.rest_orientations.resize(target_cnt);
+            cmp.rest_scales.resize(target_cnt);
+
+            for (size_t target = 0; target < target_cnt; ++target)
+            {
+                size_t transform_idx = transform_mngr.getIndex(cmp.targets[target]);
+                cmp.rest_positions[target] = transform_mngr.getPosition(transform_idx);
+                cmp.rest_orientations[target] = transform_mngr.getOrientation(transform_idx);
+                cmp.rest_scales[target] = transform_mngr.getScale(transform_idx);
+            }
+        }
+
+        size_t base = transform_indices.size();
+
+        for (size_t target = 0; target < target_cnt; ++target) {
+            transform_indices.push_back(transform_mngr.getIndex(cmp.targets[target]));
+        }
+        positions.insert(positions.end(), cmp.rest_positions.begin(), cmp.rest_positions.end());
+        orientations.insert(orientations.end(), cmp.rest_orientations.begin(), cmp.rest_orientations.end());
+        scales.insert(scales.end(), cmp.rest_scales.begin(), cmp.rest_scales.end());
+
+        if (cmp.clip != nullptr) {
+            samplePose(*cmp.clip, cmp.time, cmp.key_hints.data(), positions.data() + base, orientations.data() + base, scales.data() + base);
+        }
+        else {
+            samplePose(*cmp.compressed_clip, cmp.time, positions.data() + base, orientations.data() + base, scales.data() + base);
+        }
+    }
+
+    if (!transform_indices.empty()) {
+        transform_mngr.setLocalTransforms(transform_indices, positions, orientations, scales);
+    }
+}
+
+void EngineCore::Animation::AnimationPlayerComponentManager::addClip(std::string const& name, AnimationClipPtr const& clip)
+{
+    std::unique_lock<std::shared_mutex> lock(m_clips_mutex);
+    m_clips[name] = clip;
+}
+
+EngineCore::Animation::AnimationClipPtr EngineCore::Animation::AnimationPlayerComponentManager::getClip(std::string const& name) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_clips_mutex);
+
+    auto query = m_clips.find(name);
+
+    return query != m_clips.end() ? query->second : nullptr;
+}
@@ -0,0 +1,120 @@
+#ifndef AnimationPlayerComponentManager_hpp
+#define AnimationPlayerComponentManager_hpp
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AnimationClip.hpp"
+#include "AnimationCompression.hpp"
+#include "BaseSingleInstanceComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Common
+    {
+        class TransformComponentManager;
+    }
+
+    namespace Animation
+    {
+        /**
+        * \class AnimationPlayerComponentManager
+        *
+        * \brief Plays an animation clip per entity by writing the local transformations of the clip's targets.
+        *
+        * Targets that are not animated by a channel keep the local transformation they had when the player was
+        * first updated (rest pose). The manager also holds a library of named clips, e.g. all animations of an
+        * imported glTF file.
+        */
+        class AnimationPlayerComponentManager : public BaseSingleInstanceComponentManager
+        {
+        public:
+            struct Data
+            {
+                Data(Entity entity, AnimationClipPtr const& clip, std::vector<Entity> const& targets, bool loop, float speed)
+                    : entity(entity), clip(clip), targets(targets), time(0.0f), speed(speed), loop(loop), playing(true),
+                    key_hints(clip != nullptr ? clip->channels.size() : 0, 0) {}
+
+                Data(Entity entity, CompressedAnimationClipPtr const& compressed_clip, std::vector<Entity> const& targets, bool loop, float speed)
+                    : entity(entity), compressed_clip(compressed_clip), targets(targets), time(0.0f), speed(speed), loop(loop), playing(true) {}
+
+                Entity                     entity;
+                AnimationClipPtr           clip;
+                CompressedAnimationClipPtr compressed_clip; ///< Used instead of clip if set
+                std::vector<Entity> targets;   ///< Entity of each clip target, i.e. clip->target_ids
+                float               time;      ///< Current playback time in seconds
+                float               speed;     ///< Playback speed factor, negative values play backwards
+                bool                loop;
+                bool                playing;
+
+                std::vector<uint32_t> key_hints; ///< Last sampled key per channel
+
+                std::vector<Vec3> rest_positions;
+                std::vector<Quat> rest_orientations;
+                std::vector<Vec3> rest_scales;
+            };
+
+        private:
+            std::vector<Data>         m_data;
+            mutable std::shared_mutex m_data_access_mutex;
+
+            std::unordered_map<std::string, AnimationClipPtr> m_clips;
+            mutable std::shared_mutex                         m_clips_mutex;
+
+        public:
+            AnimationPlayerComponentManager() = default;
+            ~AnimationPlayerComponentManager() = default;
+
+            /**
+            * \brief Add a player that starts playing the given clip.
+            * \param targets Entity of each clip target, needs to have the same size as clip->target_ids
+            */
+            void addComponent(Entity entity, AnimationClipPtr const& clip, std::vector<Entity> const& targets, bool loop = true, float speed = 1.0f);
+
+            /**
+            * \brief Switch to another clip and restart playback
+            */
+            void setClip(Entity entity, AnimationClipPtr const& clip, std::vector<Entity> const& targets);
+
+            /**
+            * \brief Add a player that starts playing the given compressed clip
+            */
+            void addComponent(Entity entity, CompressedAnimationClipPtr const& clip, std::vector<Entity> const& targets, bool loop = true, float speed = 1.0f);
+
+            void setClip(Entity entity, CompressedAnimationClipPtr const& clip, std::vector<Entity> const& targets);
+
+            void play(Entity entity);
+
+            void pause(Entity entity);
+
+            void setTime(Entity entity, float time);
+
+            void setSpeed(Entity entity, float speed);
+
+            void setLoop(Entity entity, bool loop);
+
+            bool isPlaying(Entity entity) const;
+
+            size_t getComponentCount() const;
+
+            /**
+            * \brief Advance all players in the range [first, last) and write the sampled local transformations.
+            * Can be called concurrently for disjoint ranges.
+            */
+            void update(size_t first, size_t last, double dt, Common::TransformComponentManager& transform_mngr);
+
+            void addClip(std::string const& name, AnimationClipPtr const& clip);
+
+            /**
+            * \brief Returns the clip with the given name or nullptr
+            */
+            AnimationClipPtr getClip(std::string const& name) const;
+        };
+    }
+}
+
+#endif // !AnimationPlayerComponentManager_hpp
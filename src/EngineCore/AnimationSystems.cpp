@@ -1,5 +1,248 @@
 #include "AnimationSystems.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIMATION_SYSTEMS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    std::mutex                                    s_timings_mutex;
+    EngineCore::Animation::AnimationSystemTimings s_timings;
+
+    void recordTiming(double EngineCore::Animation::AnimationSystemTimings::* timing, std::chrono::high_resolution_clock::time_point t_0)
+    {
+        auto t_1 = std::chrono::high_resolution_clock::now();
+
+        std::unique_lock<std::mutex> lock(s_timings_mutex);
+        s_timings.*timing = std::chrono::duration_cast<std::chrono::duration<double>>(t_1 - t_0).count();
+    }
+
+    /** Process [0, cnt) in chunks on the task scheduler, chunks are large enough to amortize the task overhead */
+    template<typename ChunkFunction>
+    void processChunks(size_t cnt, EngineCore::Utility::TaskScheduler& task_scheduler, ChunkFunction const& chunk_function)
+    {
+        size_t const chunk_size = 1024;
+
+        for (size_t first = 0; first < cnt; first += chunk_size)
+        {
+            size_t last = std::min(first + chunk_size, cnt);
+
+            task_scheduler.submitTask(
+                [&chunk_function, first, last]() {
+                    chunk_function(first, last);
+                }
+            );
+        }
+
+        task_scheduler.waitWhileBusy();
+    }
+
+    /** Structure of arrays, one float array per component */
+    struct SoABuffer
+    {
+        SoABuffer(size_t component_cnt, size_t element_cnt) : element_cnt(element_cnt), data(component_cnt * element_cnt) {}
+
+        float* operator[](size_t component) { return data.data() + component * element_cnt; }
+
+        size_t             element_cnt;
+        std::vector<float> data;
+    };
+
+    /** a = normalize(a * b) for quaternions given as x,y,z,w component arrays */
+    void multiplyQuaternions(float* ax, float* ay, float* az, float* aw, float const* bx, float const* by, float const* bz, float const* bw, size_t cnt)
+    {
+        size_t i = 0;
+
+#ifdef ANIMATION_SYSTEMS_SSE2
+        for (; i + 4 <= cnt; i += 4)
+        {
+            __m128 x1 = _mm_loadu_ps(ax + i), y1 = _mm_loadu_ps(ay + i), z1 = _mm_loadu_ps(az + i), w1 = _mm_loadu_ps(aw + i);
+            __m128 x2 = _mm_loadu_ps(bx + i), y2 = _mm_loadu_ps(by + i), z2 = _mm_loadu_ps(bz + i), w2 = _mm_loadu_ps(bw + i);
+
+            __m128 x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(w1, x2), _mm_mul_ps(x1, w2)), _mm_mul_ps(y1, z2)), _mm_mul_ps(z1, y2));
+            __m128 y = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(w1, y2), _mm_mul_ps(x1, z2)), _mm_mul_ps(y1, w2)), _mm_mul_ps(z1, x2));
+            __m128 z = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(w1, z2), _mm_mul_ps(x1, y2)), _mm_mul_ps(y1, x2)), _mm_mul_ps(z1, w2));
+            __m128 w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(w1, w2), _mm_mul_ps(x1, x2)), _mm_mul_ps(y1, y2)), _mm_mul_ps(z1, z2));
+
+            __m128 length_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+            __m128 inv_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_sq));
+
+            _mm_storeu_ps(ax + i, _mm_mul_ps(x, inv_length));
+            _mm_storeu_ps(ay + i, _mm_mul_ps(y, inv_length));
+            _mm_storeu_ps(az + i, _mm_mul_ps(z, inv_length));
+            _mm_storeu_ps(aw + i, _mm_mul_ps(w, inv_length));
+        }
+#endif
+
+        for (; i < cnt; ++i)
+        {
+            float x = aw[i] * bx[i] + ax[i] * bw[i] + ay[i] * bz[i] - az[i] * by[i];
+            float y = aw[i] * by[i] - ax[i] * bz[i] + ay[i] * bw[i] + az[i] * bx[i];
+            float z = aw[i] * bz[i] + ax[i] * by[i] - ay[i] * bx[i] + az[i] * bw[i];
+            float w = aw[i] * bw[i] - ax[i] * bx[i] - ay[i] * by[i] - az[i] * bz[i];
+            float inv_length = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+
+            ax[i] = x * inv_length;
+            ay[i] = y * inv_length;
+            az[i] = z * inv_length;
+            aw[i] = w * inv_length;
+        }
+    }
+
+    /** p = p + (t - p) * max(0, |t - p| - deadzone) / |t - p| * min(1, dt / time_to_target) */
+    void moveTowards(
+        float* px, float* py, float* pz,
+        float const* tx, float const* ty, float const* tz,
+        float const* deadzone, float const* time_to_target, float dt, size_t cnt)
+    {
+        size_t i = 0;
+
+#ifdef ANIMATION_SYSTEMS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 dt_v = _mm_set1_ps(dt);
+
+        for (; i + 4 <= cnt; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(px + i), y = _mm_loadu_ps(py + i), z = _mm_loadu_ps(pz + i);
+            __m128 mx = _mm_sub_ps(_mm_loadu_ps(tx + i), x);
+            __m128 my = _mm_sub_ps(_mm_loadu_ps(ty + i), y);
+            __m128 mz = _mm_sub_ps(_mm_loadu_ps(tz + i), z);
+
+            __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)), _mm_mul_ps(mz, mz)));
+            __m128 is_moving = _mm_cmpgt_ps(distance, zero);
+
+            __m128 deadzone_factor = _mm_div_ps(_mm_max_ps(zero, _mm_sub_ps(distance, _mm_loadu_ps(deadzone + i))), _mm_or_ps(_mm_and_ps(is_moving, distance), _mm_andnot_ps(is_moving, one)));
+            __m128 step = _mm_min_ps(one, _mm_div_ps(dt_v, _mm_loadu_ps(time_to_target + i)));
+            __m128 factor = _mm_and_ps(is_moving, _mm_mul_ps(deadzone_factor, step));
+
+            _mm_storeu_ps(px + i, _mm_add_ps(x, _mm_mul_ps(mx, factor)));
+            _mm_storeu_ps(py + i, _mm_add_ps(y, _mm_mul_ps(my, factor)));
+            _mm_storeu_ps(pz + i, _mm_add_ps(z, _mm_mul_ps(mz, factor)));
+        }
+#endif
+
+        for (; i < cnt; ++i)
+        {
+            float mx = tx[i] - px[i];
+            float my = ty[i] - py[i];
+            float mz = tz[i] - pz[i];
+            float distance = std::sqrt(mx * mx + my * my + mz * mz);
+            float deadzone_factor = distance > 0.0f ? std::max(0.0f, distance - deadzone[i]) / distance : 0.0f;
+            float factor = deadzone_factor * std::min(1.0f, dt / time_to_target[i]);
+
+            px[i] += mx * factor;
+            py[i] += my * factor;
+            pz[i] += mz * factor;
+        }
+    }
+
+    /**
+    * Basis with +z pointing from p to t and x perpendicular to the world up axis, i.e. z = normalize(t - p),
+    * x = normalize(cross(up, z)) and y = cross(z, x). Returns the squared length of cross(up, z) in x_length_sq,
+    * the basis is degenerate where it is zero.
+    */
+    void computeFacingBases(
+        float const* px, float const* py, float const* pz,
+        float const* tx, float const* ty, float const* tz,
+        SoABuffer& basis, float* x_length_sq, size_t cnt)
+    {
+        // basis components: 0-2 x axis, 3-5 y axis, 6-8 z axis
+        float* xx = basis[0]; float* xy = basis[1]; float* xz = basis[2];
+        float* yx = basis[3]; float* yy = basis[4]; float* yz = basis[5];
+        float* zx = basis[6]; float* zy = basis[7]; float* zz = basis[8];
+
+        size_t i = 0;
+
+#ifdef ANIMATION_SYSTEMS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+
+        auto safe_inverse_length = [zero, one](__m128 length_sq) {
+            __m128 is_valid = _mm_cmpgt_ps(length_sq, zero);
+            return _mm_and_ps(is_valid, _mm_div_ps(one, _mm_sqrt_ps(_mm_or_ps(_mm_and_ps(is_valid, length_sq), _mm_andnot_ps(is_valid, one)))));
+        };
+
+        for (; i + 4 <= cnt; i += 4)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(tx + i), _mm_loadu_ps(px + i));
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(ty + i), _mm_loadu_ps(py + i));
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(tz + i), _mm_loadu_ps(pz + i));
+
+            __m128 inv_length = safe_inverse_length(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+            dx = _mm_mul_ps(dx, inv_length);
+            dy = _mm_mul_ps(dy, inv_length);
+            dz = _mm_mul_ps(dz, inv_length);
+
+            // cross((0,1,0), z) = (z.z, 0, -z.x)
+            __m128 cx = dz;
+            __m128 cz = _mm_sub_ps(zero, dx);
+            __m128 c_length_sq = _mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cz, cz));
+            _mm_storeu_ps(x_length_sq + i, c_length_sq);
+
+            __m128 c_inv_length = safe_inverse_length(c_length_sq);
+            cx = _mm_mul_ps(cx, c_inv_length);
+            cz = _mm_mul_ps(cz, c_inv_length);
+
+            // y = cross(z, x) with x.y = 0
+            _mm_storeu_ps(yx + i, _mm_mul_ps(dy, cz));
+            _mm_storeu_ps(yy + i, _mm_sub_ps(_mm_mul_ps(dz, cx), _mm_mul_ps(dx, cz)));
+            _mm_storeu_ps(yz + i, _mm_sub_ps(zero, _mm_mul_ps(dy, cx)));
+
+            _mm_storeu_ps(xx + i, cx);
+            _mm_storeu_ps(xy + i, zero);
+            _mm_storeu_ps(xz + i, cz);
+            _mm_storeu_ps(zx + i, dx);
+            _mm_storeu_ps(zy + i, dy);
+            _mm_storeu_ps(zz + i, dz);
+        }
+#endif
+
+        for (; i < cnt; ++i)
+        {
+            float dx = tx[i] - px[i];
+            float dy = ty[i] - py[i];
+            float dz = tz[i] - pz[i];
+            float length_sq = dx * dx + dy * dy + dz * dz;
+            float inv_length = length_sq > 0.0f ? 1.0f / std::sqrt(length_sq) : 0.0f;
+            dx *= inv_length;
+            dy *= inv_length;
+            dz *= inv_length;
+
+            float cx = dz;
+            float cz = -dx;
+            x_length_sq[i] = cx * cx + cz * cz;
+            float c_inv_length = x_length_sq[i] > 0.0f ? 1.0f / std::sqrt(x_length_sq[i]) : 0.0f;
+            cx *= c_inv_length;
+            cz *= c_inv_length;
+
+            yx[i] = dy * cz;
+            yy[i] = dz * cx - dx * cz;
+            yz[i] = -dy * cx;
+
+            xx[i] = cx;
+            xy[i] = 0.0f;
+            xz[i] = cz;
+            zx[i] = dx;
+            zy[i] = dy;
+            zz[i] = dz;
+        }
+    }
+}
+
+EngineCore::Animation::AnimationSystemTimings EngineCore::Animation::getAnimationSystemTimings()
+{
+    std::unique_lock<std::mutex> lock(s_timings_mutex);
+    return s_timings;
+}
+
 void EngineCore::Animation::animateTurntables(
     EngineCore::Common::TransformComponentManager & transform_mngr,
     EngineCore::Animation::TurntableComponentManager & turntable_mngr,
@@ -10,84 +253,257 @@ void EngineCore::Animation::animateTurntables(
 
     std::vector<EngineCore::Animation::TurntableComponentManager::Data> tt_cmps = turntable_mngr.getComponentDataCopy();
 
-    std::vector<std::pair<size_t, size_t>> from_to_pairs;
-    size_t bucket_cnt = 6;
-    for (size_t i = 0; i < bucket_cnt; ++i) {
-        from_to_pairs.push_back({ tt_cmps.size() * (float(i) / float(bucket_cnt)), tt_cmps.size() * (float(i + 1) / float(bucket_cnt)) });
-    }
-    
-    for (auto from_to : from_to_pairs) {
-        task_scheduler.submitTask(
-            [&transform_mngr, &tt_cmps, from_to, dt]() {
-                for (size_t i = from_to.first; i < from_to.second; ++i)
-                {
-                    auto transform_idx = transform_mngr.getIndex((tt_cmps)[i].entity);
-                    transform_mngr.rotateLocal(transform_idx, glm::angleAxis(static_cast<float>((tt_cmps)[i].angle * dt), (tt_cmps)[i].axis));
-                }
+    size_t cmp_cnt = tt_cmps.size();
+
+    std::vector<size_t> indices(cmp_cnt);
+    std::vector<Vec3>   positions(cmp_cnt);
+    std::vector<Quat>   orientations(cmp_cnt);
+    std::vector<Vec3>   scales(cmp_cnt);
+
+    // gather, rotate and scatter per chunk, then write all transformations at once
+    processChunks(cmp_cnt, task_scheduler,
+        [&transform_mngr, &tt_cmps, &indices, &positions, &orientations, &scales, dt](size_t first, size_t last) {
+            size_t cnt = last - first;
+
+            // orientation x,y,z,w and rotation x,y,z,w
+            SoABuffer quaternions(8, cnt);
+
+            for (size_t i = 0; i < cnt; ++i)
+            {
+                auto const& cmp = tt_cmps[first + i];
+
+                size_t transform_idx = transform_mngr.getIndex(cmp.entity);
+                indices[first + i] = transform_idx;
+                positions[first + i] = transform_mngr.getPosition(transform_idx);
+                scales[first + i] = transform_mngr.getScale(transform_idx);
+
+                Quat const& orientation = transform_mngr.getOrientation(transform_idx);
+                quaternions[0][i] = orientation.x;
+                quaternions[1][i] = orientation.y;
+                quaternions[2][i] = orientation.z;
+                quaternions[3][i] = orientation.w;
+
+                float half_angle = static_cast<float>(cmp.angle * dt) * 0.5f;
+                float s = std::sin(half_angle);
+                quaternions[4][i] = cmp.axis.x * s;
+                quaternions[5][i] = cmp.axis.y * s;
+                quaternions[6][i] = cmp.axis.z * s;
+                quaternions[7][i] = std::cos(half_angle);
             }
-        );
-    }
-    
-    task_scheduler.waitWhileBusy();
 
-    auto t_1 = std::chrono::high_resolution_clock::now();
+            multiplyQuaternions(quaternions[0], quaternions[1], quaternions[2], quaternions[3],
+                quaternions[4], quaternions[5], quaternions[6], quaternions[7], cnt);
+
+            for (size_t i = 0; i < cnt; ++i) {
+                orientations[first + i] = Quat(quaternions[3][i], quaternions[0][i], quaternions[1][i], quaternions[2][i]);
+            }
+        }
+    );
+
+    if (!indices.empty()) {
+        transform_mngr.setLocalTransforms(indices, positions, orientations, scales);
+    }
 
-    auto dt2 = std::chrono::duration_cast<std::chrono::duration<double>>(t_1 - t_0).count();
-    std::cout << "Animation system computation time: " << dt2 << std::endl;
+    recordTiming(&AnimationSystemTimings::turntables, t_0);
 }
 
 
 void EngineCore::Animation::animateTagAlong(
     EngineCore::Common::TransformComponentManager& transform_mngr,
     EngineCore::Animation::TagAlongComponentManager& tagalong_mngr,
-    double dt) 
+    double dt,
+    Utility::TaskScheduler& task_scheduler)
 {
+    auto t_0 = std::chrono::high_resolution_clock::now();
+
     auto tag_cmps = tagalong_mngr.getTagComponentDataCopy();
 
-    for (auto& cmp : tag_cmps)
-    {
-        size_t target_idx = transform_mngr.getIndex(cmp.target);
-        Mat4x4 target_xform = transform_mngr.getWorldTransformation(target_idx);
-        Vec3 target_front_pos = Vec3(target_xform * Vec4(cmp.offset, 1.0f));
+    size_t cmp_cnt = tag_cmps.size();
+
+    std::vector<size_t> indices(cmp_cnt);
+    std::vector<Vec3>   positions(cmp_cnt);
+    std::vector<Quat>   orientations(cmp_cnt);
+    std::vector<Vec3>   scales(cmp_cnt);
+
+    processChunks(cmp_cnt, task_scheduler,
+        [&transform_mngr, &tag_cmps, &indices, &positions, &orientations, &scales, dt](size_t first, size_t last) {
+            size_t cnt = last - first;
+
+            // position x,y,z, target x,y,z, deadzone, time to target
+            SoABuffer values(8, cnt);
+
+            for (size_t i = 0; i < cnt; ++i)
+            {
+                auto const& cmp = tag_cmps[first + i];
+
+                Mat4x4 const& target_xform = transform_mngr.getWorldTransformation(transform_mngr.getIndex(cmp.target));
+                Vec3 target_front_pos = Vec3(target_xform * Vec4(cmp.offset, 1.0f));
 
-        size_t entity_idx = transform_mngr.getIndex(cmp.entity);
-        Vec3 entity_position = transform_mngr.getWorldPosition(entity_idx);
+                size_t entity_idx = transform_mngr.getIndex(cmp.entity);
+                Vec3 entity_position = transform_mngr.getWorldPosition(entity_idx);
 
-        Vec3 movement_vector = target_front_pos - entity_position;
-        float distance = glm::length(movement_vector);
-        float deadzone_factor = distance > 0.0f ? std::max(0.0f,(distance - cmp.deadzone)) / distance : 0.0f;
+                indices[first + i] = entity_idx;
+                orientations[first + i] = transform_mngr.getOrientation(entity_idx);
+                scales[first + i] = transform_mngr.getScale(entity_idx);
 
-        target_front_pos = entity_position + movement_vector * deadzone_factor * std::min(1.0f, (static_cast<float>(dt) / cmp.time_to_target));
+                values[0][i] = entity_position.x;
+                values[1][i] = entity_position.y;
+                values[2][i] = entity_position.z;
+                values[3][i] = target_front_pos.x;
+                values[4][i] = target_front_pos.y;
+                values[5][i] = target_front_pos.z;
+                values[6][i] = cmp.deadzone;
+                values[7][i] = cmp.time_to_target;
+            }
+
+            moveTowards(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7], static_cast<float>(dt), cnt);
+
+            for (size_t i = 0; i < cnt; ++i) {
+                positions[first + i] = Vec3(values[0][i], values[1][i], values[2][i]);
+            }
+        }
+    );
 
-        transform_mngr.setPosition(entity_idx, target_front_pos);
+    if (!indices.empty()) {
+        transform_mngr.setLocalTransforms(indices, positions, orientations, scales);
     }
+
+    recordTiming(&AnimationSystemTimings::tagalong, t_0);
 }
 
 
 void EngineCore::Animation::animateBillboards(
     EngineCore::Common::TransformComponentManager& transform_mngr,
     EngineCore::Animation::BillboardComponentManager& billboard_mngr,
-    double dt)
+    double dt,
+    Utility::TaskScheduler& task_scheduler)
 {
+    auto t_0 = std::chrono::high_resolution_clock::now();
+
     auto billboard_cmps = billboard_mngr.getBillboardComponentDataCopy();
 
-    for (auto& cmp : billboard_cmps) {
-        size_t target_idx = transform_mngr.getIndex(cmp.target);
-        size_t entity_idx = transform_mngr.getIndex(cmp.entity);
+    size_t cmp_cnt = billboard_cmps.size();
 
-        Vec3 target_pos = transform_mngr.getPosition(target_idx);
-        Vec3 entity_pos = transform_mngr.getPosition(entity_idx);
+    std::vector<size_t> indices(cmp_cnt);
+    std::vector<Vec3>   positions(cmp_cnt);
+    std::vector<Quat>   orientations(cmp_cnt);
+    std::vector<Vec3>   scales(cmp_cnt);
 
-        Entity parent = transform_mngr.getParent(entity_idx);
-        if (parent != EntityManager::invalidEntity())
-        {
-            Mat4x4 to_parent_space = glm::inverse(transform_mngr.getWorldTransformation(transform_mngr.getIndex(parent)));
-            target_pos = Vec3(to_parent_space * Vec4(target_pos, 1.0f));
+    processChunks(cmp_cnt, task_scheduler,
+        [&transform_mngr, &billboard_cmps, &indices, &positions, &orientations, &scales](size_t first, size_t last) {
+            size_t cnt = last - first;
+
+            // position x,y,z and target x,y,z in parent space
+            SoABuffer values(6, cnt);
+            SoABuffer basis(9, cnt);
+            std::vector<float> x_length_sq(cnt);
+
+            // billboards commonly share their parent, so each parent is only inverted once per chunk
+            std::unordered_map<size_t, Mat4x4> to_parent_spaces;
+
+            for (size_t i = 0; i < cnt; ++i)
+            {
+                auto const& cmp = billboard_cmps[first + i];
+
+                size_t target_idx = transform_mngr.getIndex(cmp.target);
+                size_t entity_idx = transform_mngr.getIndex(cmp.entity);
+
+                Vec3 target_pos = transform_mngr.getPosition(target_idx);
+                Vec3 entity_pos = transform_mngr.getPosition(entity_idx);
+
+                Entity parent = transform_mngr.getParent(entity_idx);
+                if (parent != EntityManager::invalidEntity())
+                {
+                    size_t parent_idx = transform_mngr.getIndex(parent);
+                    auto query = to_parent_spaces.find(parent_idx);
+                    if (query == to_parent_spaces.end()) {
+                        query = to_parent_spaces.insert({ parent_idx, glm::inverse(transform_mngr.getWorldTransformation(parent_idx)) }).first;
+                    }
+                    target_pos = Vec3(query->second * Vec4(target_pos, 1.0f));
+                }
+
+                indices[first + i] = entity_idx;
+                positions[first + i] = entity_pos;
+                orientations[first + i] = transform_mngr.getOrientation(entity_idx);
+                scales[first + i] = transform_mngr.getScale(entity_idx);
+
+                values[0][i] = entity_pos.x;
+                values[1][i] = entity_pos.y;
+                values[2][i] = entity_pos.z;
+                values[3][i] = target_pos.x;
+                values[4][i] = target_pos.y;
+                values[5][i] = target_pos.z;
+            }
+
+            computeFacingBases(values[0], values[1], values[2], values[3], values[4], values[5], basis, x_length_sq.data(), cnt);
+
+            for (size_t i = 0; i < cnt; ++i)
+            {
+                // keep the current orientation if the target is straight above or below
+                if (x_length_sq[i] <= 0.0f)
+                    continue;
+
+                glm::mat3 rotation(
+                    Vec3(basis[0][i], basis[1][i], basis[2][i]),
+                    Vec3(basis[3][i], basis[4][i], basis[5][i]),
+                    Vec3(basis[6][i], basis[7][i], basis[8][i]));
+                orientations[first + i] = glm::quat_cast(rotation);
+            }
         }
+    );
+
+    if (!indices.empty()) {
+        transform_mngr.setLocalTransforms(indices, positions, orientations, scales);
+    }
+
+    recordTiming(&AnimationSystemTimings::billboards, t_0);
+}
+
+void EngineCore::Animation::animateClips(
+    EngineCore::Common::TransformComponentManager& transform_mngr,
+    EngineCore::Animation::AnimationPlayerComponentManager& player_mngr,
+    double dt,
+    Utility::TaskScheduler& task_scheduler)
+{
+    // large enough to amortize the batched transform update, small enough to balance skeletons of different size
+    size_t const players_per_task = 32;
+
+    size_t player_cnt = player_mngr.getComponentCount();
+
+    for (size_t first = 0; first < player_cnt; first += players_per_task)
+    {
+        size_t last = std::min(first + players_per_task, player_cnt);
+
+        task_scheduler.submitTask(
+            [&transform_mngr, &player_mngr, first, last, dt]() {
+                player_mngr.update(first, last, dt, transform_mngr);
+            }
+        );
+    }
+
+    task_scheduler.waitWhileBusy();
+}
+
+void EngineCore::Animation::blendAnimations(
+    EngineCore::Common::TransformComponentManager& transform_mngr,
+    EngineCore::Animation::BlendTreeComponentManager& blend_tree_mngr,
+    double dt,
+    Utility::TaskScheduler& task_scheduler)
+{
+    size_t const characters_per_task = 32;
+
+    size_t character_cnt = blend_tree_mngr.getComponentCount();
 
-        // Mirror target position to make +z face the original target
-        auto mirrored_target_pos = target_pos - 2.0f * (target_pos-entity_pos);
-        auto r = glm::toQuat(glm::inverse(glm::lookAt(entity_pos, mirrored_target_pos, Vec3(0.0f, 1.0f, 0.0f))));
-        transform_mngr.setOrientation(entity_idx, r);
+    for (size_t first = 0; first < character_cnt; first += characters_per_task)
+    {
+        size_t last = std::min(first + characters_per_task, character_cnt);
+
+        task_scheduler.submitTask(
+            [&transform_mngr, &blend_tree_mngr, first, last, dt]() {
+                blend_tree_mngr.update(first, last, dt, transform_mngr);
+            }
+        );
     }
-}
\ No newline at end of file
+
+    task_scheduler.waitWhileBusy();
+}
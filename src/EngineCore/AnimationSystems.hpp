@@ -2,6 +2,8 @@
 #define AnimationSystems_hpp
 
 
+#include "AnimationPlayerComponentManager.hpp"
+#include "BlendTreeComponentManager.hpp"
 #include "TransformComponentManager.hpp"
 #include "TurntableComponentManager.hpp"
 #include "TagAlongComponentManager.hpp"
@@ -11,6 +13,22 @@
 namespace EngineCore {
 namespace Animation {
 
+    /**
+     * Wall clock time in seconds of the last call of each system, e.g. for profiling overlays
+     */
+    struct AnimationSystemTimings
+    {
+        double turntables = 0.0;
+        double tagalong = 0.0;
+        double billboards = 0.0;
+    };
+
+    AnimationSystemTimings getAnimationSystemTimings();
+
+    /**
+     * The turntable, tag along and billboard systems gather their inputs in parallel chunks, compute the new
+     * local transformations on component arrays and write them with a single batched transform update.
+     */
     void animateTurntables(
         EngineCore::Common::TransformComponentManager& transform_mngr,
         EngineCore::Animation::TurntableComponentManager& turntable_mngr,
@@ -20,12 +38,32 @@ namespace Animation {
     void animateTagAlong(
         EngineCore::Common::TransformComponentManager& transform_mngr,
         EngineCore::Animation::TagAlongComponentManager& tagalong_mngr,
-        double dt);
+        double dt,
+        Utility::TaskScheduler& task_scheduler);
 
     void animateBillboards(
         EngineCore::Common::TransformComponentManager& transform_mngr,
         EngineCore::Animation::BillboardComponentManager& billboard_mngr,
-        double dt);
+        double dt,
+        Utility::TaskScheduler& task_scheduler);
+
+    /**
+     * Advance all animation players and write the sampled local transformations, players are processed in parallel batches.
+     */
+    void animateClips(
+        EngineCore::Common::TransformComponentManager& transform_mngr,
+        EngineCore::Animation::AnimationPlayerComponentManager& player_mngr,
+        double dt,
+        Utility::TaskScheduler& task_scheduler);
+
+    /**
+     * Evaluate the blend trees of all characters and write the resulting local transformations, one tree per character in parallel batches.
+     */
+    void blendAnimations(
+        EngineCore::Common::TransformComponentManager& transform_mngr,
+        EngineCore::Animation::BlendTreeComponentManager& blend_tree_mngr,
+        double dt,
+        Utility::TaskScheduler& task_scheduler);
 }
 }
 
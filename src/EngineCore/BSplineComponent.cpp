@@ -1,27 +1,252 @@
 #include "BSplineComponent.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 
 #include "utility.hpp"
 
 #include "TransformComponentManager.hpp"
 
-Vec3 EngineCore::Common::BSplineComponentManager::recursiveDeBoor(size_t idx, uint k, uint i, float x) const
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BSPLINE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
 {
-    if (k == 0)
+    /** Number of arc length table entries per curve span */
+    constexpr size_t arc_length_samples_per_span = 32;
+
+    /** Index of the span containing the knot value x, values outside of the knot range map to the first or last span */
+    size_t findSpan(std::vector<float> const& span_knots, float x)
     {
-        auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
-        size_t transform_idx = transform_mngr.getIndex(m_data[idx].m_control_vertices[i]);
-        return transform_mngr.getPosition(transform_idx);
+        auto it = std::upper_bound(span_knots.begin(), span_knots.end() - 1, x);
+        return it == span_knots.begin() ? 0 : static_cast<size_t>(it - span_knots.begin()) - 1;
     }
-    else
+
+    /** Evaluate the cubic power basis polynomials of a span (4 coefficients each for x, y and z) and their derivative at s */
+    Vec3 evaluateSpan(float const* coefficients, float s, Vec3* derivative)
+    {
+        Vec3 point;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            float const* a = coefficients + c * 4;
+            point[c] = ((a[3] * s + a[2]) * s + a[1]) * s + a[0];
+
+            if (derivative != nullptr) {
+                (*derivative)[c] = (3.0f * a[3] * s + 2.0f * a[2]) * s + a[1];
+            }
+        }
+
+        return point;
+    }
+}
+
+float EngineCore::Common::BSplineComponentManager::toKnotValue(size_t component_idx, float u) const
+{
+    u = std::min(1.0f, std::max(0.0f, u)); // clamp u to valid range
+
+    size_t cv_cnt = m_data[component_idx].m_control_vertices.size();
+    uint degree = m_data[component_idx].m_degree;
+
+    return u * (cv_cnt - degree); // map to knotvector value range
+}
+
+Vec3 EngineCore::Common::BSplineComponentManager::evaluateDeBoor(size_t component_idx, float x, Vec3* tangent) const
+{
+    auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
+
+    auto const& cmp = m_data[component_idx];
+    auto const& t = cmp.m_knotvector;
+    uint p = cmp.m_degree;
+    size_t cv_cnt = cmp.m_control_vertices.size();
+
+    assert(p < 4 && cv_cnt > p);
+
+    // find span i with t_i <= x <= t_i+1
+    size_t i = p;
+    while (i + 1 < cv_cnt && t[i + 1] < x) {
+        ++i;
+    }
+
+    std::array<Vec3, 4> d;
+    for (uint j = 0; j <= p; ++j) {
+        d[j] = transform_mngr.getPosition(transform_mngr.getIndex(cmp.m_control_vertices[j + i - p]));
+    }
+
+    if (tangent != nullptr) {
+        *tangent = Vec3(0.0f);
+    }
+
+    for (uint r = 1; r <= p; ++r)
+    {
+        // the derivative is proportional to the difference of the two points remaining for the last step
+        if (r == p && tangent != nullptr) {
+            *tangent = d[p] - d[p - 1];
+        }
+
+        for (uint j = p; j >= r; --j)
+        {
+            float denom = t[j + 1 + i - r] - t[j + i - p];
+            float alpha = denom > 0.0f ? (x - t[j + i - p]) / denom : 0.0f;
+
+            d[j] = (1.0f - alpha) * d[j - 1] + alpha * d[j];
+        }
+    }
+
+    return d[p];
+}
+
+std::shared_lock<std::shared_mutex> EngineCore::Common::BSplineComponentManager::lockEvaluationCache(size_t component_idx) const
+{
+    auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
+
+    auto const& cmp = m_data[component_idx];
+
+    std::vector<Vec3> control_points;
+    control_points.reserve(cmp.m_control_vertices.size());
+    for (auto const& cv : cmp.m_control_vertices) {
+        control_points.push_back(transform_mngr.getPosition(transform_mngr.getIndex(cv)));
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_cache_mutex);
+
+        if (cmp.m_cache.control_points == control_points && cmp.m_cache.knots == cmp.m_knotvector) {
+            return lock;
+        }
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_cache_mutex);
+        buildEvaluationCache(component_idx, std::move(control_points));
+    }
+
+    return std::shared_lock<std::shared_mutex>(m_cache_mutex);
+}
+
+void EngineCore::Common::BSplineComponentManager::buildEvaluationCache(size_t component_idx, std::vector<Vec3>&& control_points) const
+{
+    auto const& cmp = m_data[component_idx];
+    auto const& t = cmp.m_knotvector;
+    uint p = cmp.m_degree;
+
+    auto& cache = cmp.m_cache;
+    size_t cv_cnt = control_points.size();
+
+    assert(p < 4);
+
+    // the basis functions only depend on the knot vector, moving control vertices only requires new curve coefficients
+    if (cache.knots != t || cache.control_points.size() != cv_cnt)
+    {
+        cache.knots = t;
+        cache.span_knots.clear();
+        cache.span_cv_offsets.clear();
+        cache.basis.clear();
+
+        for (size_t i = p; i < cv_cnt; ++i)
+        {
+            // skip empty spans of repeated knots
+            if (!(t[i] < t[i + 1]))
+                continue;
+
+            cache.span_knots.push_back(t[i]);
+            cache.span_cv_offsets.push_back(i - p);
+
+            // Cox-de Boor recursion on the polynomial pieces of the basis functions in s = x - t_i,
+            // N[a] holds the power basis coefficients of basis function i - p + a
+            float N[4][4] = {};
+            N[p][0] = 1.0f;
+
+            for (uint r = 1; r <= p; ++r)
+            {
+                for (uint a = p - r; a <= p; ++a)
+                {
+                    size_t j = i - p + a;
+                    float result[4] = {};
+
+                    // (x - t_j) / (t_j+r - t_j) * N_j,r-1
+                    float denom = t[j + r] - t[j];
+                    if (denom > 0.0f)
+                    {
+                        float c = (t[i] - t[j]) / denom;
+                        float b = 1.0f / denom;
+                        for (int k = 0; k < 4; ++k) {
+                            result[k] += c * N[a][k] + (k > 0 ? b * N[a][k - 1] : 0.0f);
+                        }
+                    }
+
+                    // (t_j+r+1 - x) / (t_j+r+1 - t_j+1) * N_j+1,r-1
+                    if (a < p)
+                    {
+                        denom = t[j + r + 1] - t[j + 1];
+                        if (denom > 0.0f)
+                        {
+                            float c = (t[j + r + 1] - t[i]) / denom;
+                            float b = -1.0f / denom;
+                            for (int k = 0; k < 4; ++k) {
+                                result[k] += c * N[a + 1][k] + (k > 0 ? b * N[a + 1][k - 1] : 0.0f);
+                            }
+                        }
+                    }
+
+                    std::copy(result, result + 4, N[a]);
+                }
+            }
+
+            for (uint a = 0; a <= p; ++a) {
+                cache.basis.insert(cache.basis.end(), N[a], N[a] + 4);
+            }
+        }
+
+        if (!cache.span_knots.empty()) {
+            cache.span_knots.push_back(t[cv_cnt]);
+        }
+    }
+
+    cache.control_points = std::move(control_points);
+    cache.coefficients.clear();
+    cache.arc_lengths.clear();
+
+    if (cache.span_knots.empty())
+        return;
+
+    size_t span_cnt = cache.span_knots.size() - 1;
+    cache.coefficients.resize(span_cnt * 12);
+
+    for (size_t span = 0; span < span_cnt; ++span)
     {
-        float u_i = m_data[idx].m_knotvector[i];
-        float u_in1k = m_data[idx].m_knotvector[i + m_data[idx].m_degree + 1 - k];
+        float const* N = cache.basis.data() + span * (p + 1) * 4;
+        Vec3 const* P = cache.control_points.data() + cache.span_cv_offsets[span];
+
+        for (int c = 0; c < 3; ++c)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                float coefficient = 0.0f;
+                for (uint a = 0; a <= p; ++a) {
+                    coefficient += N[a * 4 + k] * P[a][c];
+                }
+                cache.coefficients[span * 12 + c * 4 + k] = coefficient;
+            }
+        }
+    }
 
-        float alpha_k_i = (x - u_i) / (u_in1k - u_i);
+    // cumulative chord lengths at uniformly spaced parameters
+    size_t sample_cnt = span_cnt * arc_length_samples_per_span + 1;
+    cache.arc_lengths.resize(sample_cnt);
+
+    Vec3 previous_point;
+    for (size_t sample = 0; sample < sample_cnt; ++sample)
+    {
+        float x = toKnotValue(component_idx, static_cast<float>(sample) / static_cast<float>(sample_cnt - 1));
+        size_t span = findSpan(cache.span_knots, x);
+        Vec3 point = evaluateSpan(cache.coefficients.data() + span * 12, x - cache.span_knots[span], nullptr);
 
-        return ((1.0f - alpha_k_i)*recursiveDeBoor(idx, k - 1, i - 1, x) + alpha_k_i*recursiveDeBoor(idx, k - 1, i, x));
+        cache.arc_lengths[sample] = sample == 0 ? 0.0f : cache.arc_lengths[sample - 1] + glm::length(point - previous_point);
+        previous_point = point;
     }
 }
 
@@ -143,23 +368,7 @@ void EngineCore::Common::BSplineComponentManager::insertControlVertex(Entity ent
 
 Vec3 EngineCore::Common::BSplineComponentManager::computeCurvePoint(size_t component_idx, float u) const
 {
-    u = std::min(1.0f, std::max(0.0f, u)); // clamp u to valid range
-
-    // calculate i for recursive De Boor
-    size_t cv_cnt = m_data[component_idx].m_control_vertices.size();
-    size_t knotvector_length = m_data[component_idx].m_knotvector.size();
-    uint degree = m_data[component_idx].m_degree;
-
-    float knot_value = u * (cv_cnt - degree); // map to knotvector value range
-
-    uint i = degree;
-    for (; i < knotvector_length; ++i)
-    {
-        if (m_data[component_idx].m_knotvector[i + 1] >= knot_value)
-            break;
-    }
-
-    return recursiveDeBoor(component_idx, degree, i, knot_value);
+    return evaluateDeBoor(component_idx, toKnotValue(component_idx, u), nullptr);
 }
 
 Vec3 EngineCore::Common::BSplineComponentManager::computeCurvePoint(Entity spline, float u) const
@@ -183,6 +392,15 @@ Vec3 EngineCore::Common::BSplineComponentManager::computeCurvePoint(Entity splin
 
 Vec3 EngineCore::Common::BSplineComponentManager::computeCurveTangent(size_t component_idx, float u) const
 {
+    Vec3 tangent;
+    evaluateDeBoor(component_idx, toKnotValue(component_idx, u), &tangent);
+
+    float length = glm::length(tangent);
+    if (length > 0.0f) {
+        return tangent / length;
+    }
+
+    // no derivative direction, e.g. at coinciding control vertices, use the secant around u instead
     Vec3 p1 = computeCurvePoint(component_idx, u + 0.02f);
     Vec3 p2 = computeCurvePoint(component_idx, u - 0.02f);
 
@@ -208,6 +426,135 @@ Vec3 EngineCore::Common::BSplineComponentManager::computeCurveTangent(Entity spl
     return retval;
 }
 
+void EngineCore::Common::BSplineComponentManager::computeCurvePoints(size_t component_idx, float const* parameters, size_t cnt, Vec3* points, Vec3* tangents) const
+{
+    auto lock = lockEvaluationCache(component_idx);
+
+    auto const& cache = m_data[component_idx].m_cache;
+
+    // degenerate knot vector without any non-empty span
+    if (cache.span_knots.empty())
+    {
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            points[i] = computeCurvePoint(component_idx, parameters[i]);
+            if (tangents != nullptr) {
+                tangents[i] = computeCurveTangent(component_idx, parameters[i]);
+            }
+        }
+        return;
+    }
+
+    size_t i = 0;
+
+#ifdef BSPLINE_SSE2
+    // evaluate 4 parameters at a time, the coefficient rows of the 4 spans are transposed so that each
+    // register holds the same coefficient for all parameters
+    for (; i + 4 <= cnt; i += 4)
+    {
+        alignas(16) float s[4];
+        size_t spans[4];
+
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            float x = toKnotValue(component_idx, parameters[i + lane]);
+            spans[lane] = findSpan(cache.span_knots, x);
+            s[lane] = x - cache.span_knots[spans[lane]];
+        }
+
+        __m128 s_v = _mm_load_ps(s);
+
+        alignas(16) float result[3][4];
+        alignas(16) float derivative[3][4];
+
+        for (int c = 0; c < 3; ++c)
+        {
+            __m128 a0 = _mm_loadu_ps(cache.coefficients.data() + spans[0] * 12 + c * 4);
+            __m128 a1 = _mm_loadu_ps(cache.coefficients.data() + spans[1] * 12 + c * 4);
+            __m128 a2 = _mm_loadu_ps(cache.coefficients.data() + spans[2] * 12 + c * 4);
+            __m128 a3 = _mm_loadu_ps(cache.coefficients.data() + spans[3] * 12 + c * 4);
+            _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+
+            __m128 value = _mm_add_ps(_mm_mul_ps(a3, s_v), a2);
+            value = _mm_add_ps(_mm_mul_ps(value, s_v), a1);
+            value = _mm_add_ps(_mm_mul_ps(value, s_v), a0);
+            _mm_store_ps(result[c], value);
+
+            if (tangents != nullptr)
+            {
+                __m128 slope = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(3.0f), a3), s_v), _mm_mul_ps(_mm_set1_ps(2.0f), a2));
+                slope = _mm_add_ps(_mm_mul_ps(slope, s_v), a1);
+                _mm_store_ps(derivative[c], slope);
+            }
+        }
+
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            points[i + lane] = Vec3(result[0][lane], result[1][lane], result[2][lane]);
+
+            if (tangents != nullptr) {
+                tangents[i + lane] = Vec3(derivative[0][lane], derivative[1][lane], derivative[2][lane]);
+            }
+        }
+    }
+#endif
+
+    for (; i < cnt; ++i)
+    {
+        float x = toKnotValue(component_idx, parameters[i]);
+        size_t span = findSpan(cache.span_knots, x);
+        points[i] = evaluateSpan(cache.coefficients.data() + span * 12, x - cache.span_knots[span], tangents != nullptr ? tangents + i : nullptr);
+    }
+
+    if (tangents != nullptr)
+    {
+        for (size_t j = 0; j < cnt; ++j)
+        {
+            float length = glm::length(tangents[j]);
+            tangents[j] = length > 0.0f ? tangents[j] / length : computeCurveTangent(component_idx, parameters[j]);
+        }
+    }
+}
+
+float EngineCore::Common::BSplineComponentManager::computeCurveLength(size_t component_idx) const
+{
+    auto lock = lockEvaluationCache(component_idx);
+
+    auto const& arc_lengths = m_data[component_idx].m_cache.arc_lengths;
+
+    return arc_lengths.empty() ? 0.0f : arc_lengths.back();
+}
+
+void EngineCore::Common::BSplineComponentManager::computeArcLengthParameters(size_t component_idx, float const* distances, size_t cnt, float* parameters) const
+{
+    auto lock = lockEvaluationCache(component_idx);
+
+    auto const& arc_lengths = m_data[component_idx].m_cache.arc_lengths;
+
+    float length = arc_lengths.empty() ? 0.0f : arc_lengths.back();
+
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        float distance = std::min(1.0f, std::max(0.0f, distances[i]));
+
+        // zero length curve, every parameter results in the same point
+        if (!(length > 0.0f))
+        {
+            parameters[i] = distance;
+            continue;
+        }
+
+        float target = distance * length;
+        size_t sample = static_cast<size_t>(std::lower_bound(arc_lengths.begin(), arc_lengths.end(), target) - arc_lengths.begin());
+        sample = std::min(std::max(sample, size_t(1)), arc_lengths.size() - 1);
+
+        float segment_length = arc_lengths[sample] - arc_lengths[sample - 1];
+        float lambda = segment_length > 0.0f ? (target - arc_lengths[sample - 1]) / segment_length : 0.0f;
+
+        parameters[i] = (static_cast<float>(sample - 1) + std::min(1.0f, std::max(0.0f, lambda))) / static_cast<float>(arc_lengths.size() - 1);
+    }
+}
+
 Entity EngineCore::Common::BSplineComponentManager::getLastControlVertex(Entity spline) const
 {
     auto query = getIndex(spline);
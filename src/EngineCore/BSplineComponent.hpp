@@ -1,6 +1,7 @@
 #ifndef BSplineComponent_hpp
 #define BSPlineComponent_hpp
 
+#include <shared_mutex>
 #include <unordered_map>
 
 #include "BaseMultiInstanceComponentManager.hpp"
@@ -14,6 +15,21 @@ namespace Common {
     private:
         typedef Entity ControlVertex;
     
+        /**
+         * Evaluation data derived from the knot vector and the control vertex positions, rebuilt lazily
+         * by lockEvaluationCache whenever either of them changed.
+         */
+        struct EvaluationCache
+        {
+            std::vector<float>  knots;           ///< Knot vector the cache was built from
+            std::vector<Vec3>   control_points;  ///< Control vertex positions the cache was built from
+            std::vector<float>  span_knots;      ///< First knot value of each non-empty span, followed by the last knot value
+            std::vector<size_t> span_cv_offsets; ///< Index of the first control vertex of each span
+            std::vector<float>  basis;           ///< Per span (degree+1)x4 power basis coefficients of the non-zero basis functions
+            std::vector<float>  coefficients;    ///< Per span 4 power basis coefficients of x, then y, then z of the curve
+            std::vector<float>  arc_lengths;     ///< Cumulative arc length at uniformly spaced parameter values
+        };
+
         struct ComponentData
         {
             ComponentData(Entity e) : m_entity(e), m_degree(0) {}
@@ -24,16 +40,33 @@ namespace Common {
     
             std::vector<float> m_knotvector;
             std::vector<ControlVertex> m_control_vertices;
+
+            mutable EvaluationCache m_cache;
         };
     
         std::vector<ComponentData> m_data;
         std::shared_mutex          m_data_mutex;
 
+        mutable std::shared_mutex  m_cache_mutex;
+
         WorldState& m_world;
     
-    
-        /** Recursive De Boor algorithm as seen on Wikipedia */
-        Vec3 recursiveDeBoor(size_t index, uint k, uint i, float x) const;
+        /** Map the curve parameter u in [0,1] to the knot value range */
+        float toKnotValue(size_t component_idx, float u) const;
+
+        /**
+         * Iterative De Boor algorithm, only fetches the degree+1 control vertices of the span containing x.
+         * Optionally returns the (unnormalized) direction of the derivative.
+         */
+        Vec3 evaluateDeBoor(size_t component_idx, float x, Vec3* tangent) const;
+
+        /**
+         * Make sure the evaluation cache of the component matches the current knots and control vertex positions
+         * and return a shared lock on it.
+         */
+        std::shared_lock<std::shared_mutex> lockEvaluationCache(size_t component_idx) const;
+
+        void buildEvaluationCache(size_t component_idx, std::vector<Vec3>&& control_points) const;
     
     public:
 
@@ -66,6 +99,28 @@ namespace Common {
         Vec3 computeCurveTangent(size_t component_idx, float u) const;
     
         Vec3 computeCurveTangent(Entity entity, float u) const;
+
+        /**
+         * Evaluate the curve at many parameters at once, using the cached per span polynomial coefficients.
+         * Can be called concurrently.
+         * @param parameters cnt curve parameters in [0,1], values outside are clamped
+         * @param points Receives cnt curve points
+         * @param tangents Receives cnt normalized tangents, ignored if nullptr
+         */
+        void computeCurvePoints(size_t component_idx, float const* parameters, size_t cnt, Vec3* points, Vec3* tangents = nullptr) const;
+
+        /**
+         * Approximate length of the curve, from the cached arc length table
+         */
+        float computeCurveLength(size_t component_idx) const;
+
+        /**
+         * Map normalized arc lengths in [0,1] to curve parameters, i.e. uniformly spaced distances
+         * result in points that are evenly spaced along the curve. Use for constant speed motion.
+         * @param distances cnt normalized arc lengths
+         * @param parameters Receives cnt curve parameters that can be passed to computeCurvePoints
+         */
+        void computeArcLengthParameters(size_t component_idx, float const* distances, size_t cnt, float* parameters) const;
     
         Entity getLastControlVertex(Entity entity) const;
     };
@@ -106,6 +106,14 @@ namespace EngineCore
 
             WeakResource<ShaderProgram> getShaderProgramResource(std::string rsrc_name);
 
+            /**
+            * \brief Set a program that is returned by getShaderProgramResource in place of the given program,
+            * as long as the given program is not ready (e.g. while it is still being compiled).
+            * \param program Program that is substituted
+            * \param fallback Substitute program, pass an invalid id to remove the fallback
+            */
+            void setShaderProgramFallback(ResourceID program, ResourceID fallback);
+
             WeakResource<Texture2D> getTexture2DResource(ResourceID rsrc_id);
 
             WeakResource<Texture2D> getTexture2DResource(std::string name);
@@ -144,6 +152,34 @@ namespace EngineCore
                 m_name_to_textures_2d_idx.insert(std::pair<std::string, size_t>(name, index));
             }
 
+            /**
+            * Returns the shader program at the given index, or its fallback if the program is not ready.
+            * Requires a lock on m_shader_programs_mutex.
+            */
+            WeakResource<ShaderProgram> resolveShaderProgram(size_t idx) const
+            {
+                if (m_shader_programs[idx].state != READY)
+                {
+                    auto fallback = m_shader_program_fallbacks.find(m_shader_programs[idx].id.value());
+                    if (fallback != m_shader_program_fallbacks.end())
+                    {
+                        auto fallback_idx = m_id_to_shader_program_idx.find(fallback->second);
+                        if (fallback_idx != m_id_to_shader_program_idx.end() && m_shader_programs[fallback_idx->second].state == READY)
+                        {
+                            return WeakResource<ShaderProgram>(
+                                m_shader_programs[fallback_idx->second].id,
+                                m_shader_programs[fallback_idx->second].resource.get(),
+                                m_shader_programs[fallback_idx->second].state);
+                        }
+                    }
+                }
+
+                return WeakResource<ShaderProgram>(
+                    m_shader_programs[idx].id,
+                    m_shader_programs[idx].resource.get(),
+                    m_shader_programs[idx].state);
+            }
+
             ResourceID generateResourceID() {
                 std::unique_lock<std::mutex> rsrcID_lock(m_rsrcID_mutex);
                 return ResourceID(m_resource_cnt++);
@@ -186,6 +222,9 @@ namespace EngineCore
             std::unordered_map<std::string, size_t> m_name_to_textures_2d_idx;
             std::unordered_map<std::string, size_t> m_name_to_textures_3d_idx;
 
+            /** Fallback program ids by program id, protected by m_shader_programs_mutex */
+            std::unordered_map<unsigned int, unsigned int> m_shader_program_fallbacks;
+
             mutable std::shared_mutex m_buffers_mutex;
             mutable std::shared_mutex m_meshes_mutex;
             mutable std::shared_mutex m_shader_programs_mutex;
@@ -262,10 +301,7 @@ namespace EngineCore
 
             if (query != m_id_to_shader_program_idx.end())
             {
-                retval = WeakResource<ShaderProgram>(
-                    m_shader_programs[query->second].id,
-                    m_shader_programs[query->second].resource.get(),
-                    m_shader_programs[query->second].state);
+                retval = resolveShaderProgram(query->second);
             }
 
             return retval;
@@ -282,15 +318,25 @@ namespace EngineCore
 
             if (query != m_name_to_shader_program_idx.end())
             {
-                retval = WeakResource<ShaderProgram>(
-                    m_shader_programs[query->second].id,
-                    m_shader_programs[query->second].resource.get(),
-                    m_shader_programs[query->second].state);
+                retval = resolveShaderProgram(query->second);
             }
 
             return retval;
         }
 
+        template<typename Buffer, typename Mesh, typename ShaderProgram, typename Texture2D, typename Texture3D>
+        inline void BaseResourceManager<Buffer, Mesh, ShaderProgram, Texture2D, Texture3D>::setShaderProgramFallback(ResourceID program, ResourceID fallback)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_shader_programs_mutex);
+
+            if (fallback == invalidResourceID() || fallback == program) {
+                m_shader_program_fallbacks.erase(program.value());
+            }
+            else {
+                m_shader_program_fallbacks[program.value()] = fallback.value();
+            }
+        }
+
         template<typename Buffer, typename Mesh, typename ShaderProgram, typename Texture2D, typename Texture3D>
         inline WeakResource<Texture2D> BaseResourceManager<Buffer, Mesh, ShaderProgram, Texture2D, Texture3D>::getTexture2DResource(ResourceID rsrc_id)
         {
@@ -0,0 +1,106 @@
+#include "BlendTreeComponentManager.hpp"
+
+#include <algorithm>
+
+#include "TransformComponentManager.hpp"
+
+void EngineCore::Animation::BlendTreeComponentManager::addComponent(Entity entity, BlendTreePtr const& tree, std::vector<Entity> const& targets)
+{
+    assert(tree != nullptr && tree->joint_cnt == targets.size());
+
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    size_t idx = m_data.size();
+
+    addIndex(entity.id(), idx);
+
+    m_data.push_back(Data(entity, tree, targets));
+}
+
+void EngineCore::Animation::BlendTreeComponentManager::setParameter(Entity entity, uint32_t parameter_idx, float value)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto& parameters = m_data[getIndex(entity)].state.parameters;
+
+    if (parameter_idx < parameters.size()) {
+        parameters[parameter_idx] = value;
+    }
+}
+
+float EngineCore::Animation::BlendTreeComponentManager::getParameter(Entity entity, uint32_t parameter_idx) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto const& parameters = m_data[getIndex(entity)].state.parameters;
+
+    return parameter_idx < parameters.size() ? parameters[parameter_idx] : 0.0f;
+}
+
+size_t EngineCore::Animation::BlendTreeComponentManager::getComponentCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_data.size();
+}
+
+void EngineCore::Animation::BlendTreeComponentManager::update(
+    size_t first,
+    size_t last,
+    double dt,
+    Common::TransformComponentManager& transform_mngr)
+{
+    // the shared lock only protects the component array, each component is modified by a single caller
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    last = std::min(last, m_data.size());
+
+    std::vector<size_t> transform_indices;
+    std::vector<Vec3>   positions;
+    std::vector<Quat>   orientations;
+    std::vector<Vec3>   scales;
+
+    auto pose = m_pose_pool.acquire(0);
+
+    for (size_t i = first; i < last; ++i)
+    {
+        auto& cmp = m_data[i];
+        size_t joint_cnt = cmp.targets.size();
+
+        // capture the rest pose on first use
+        if (cmp.rest_pose.joint_cnt != joint_cnt)
+        {
+            cmp.rest_pose.resize(joint_cnt);
+
+            for (size_t joint = 0; joint < joint_cnt; ++joint)
+            {
+                size_t transform_idx = transform_mngr.getIndex(cmp.targets[joint]);
+                cmp.rest_pose.set(joint,
+                    transform_mngr.getPosition(transform_idx),
+                    transform_mngr.getOrientation(transform_idx),
+                    transform_mngr.getScale(transform_idx));
+            }
+        }
+
+        advanceBlendTree(*cmp.tree, cmp.state, static_cast<float>(dt));
+        evaluateBlendTree(*cmp.tree, cmp.state, cmp.rest_pose, m_pose_pool, *pose);
+
+        size_t base = transform_indices.size();
+
+        transform_indices.resize(base + joint_cnt);
+        positions.resize(base + joint_cnt);
+        orientations.resize(base + joint_cnt);
+        scales.resize(base + joint_cnt);
+
+        for (size_t joint = 0; joint < joint_cnt; ++joint)
+        {
+            transform_indices[base + joint] = transform_mngr.getIndex(cmp.targets[joint]);
+            pose->get(joint, positions[base + joint], orientations[base + joint], scales[base + joint]);
+        }
+    }
+
+    m_pose_pool.release(std::move(pose));
+
+    if (!transform_indices.empty()) {
+        transform_mngr.setLocalTransforms(transform_indices, positions, orientations, scales);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef BlendTreeComponentManager_hpp
+#define BlendTreeComponentManager_hpp
+
+#include <shared_mutex>
+#include <vector>
+
+#include "AnimationBlendTree.hpp"
+#include "BaseSingleInstanceComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Common
+    {
+        class TransformComponentManager;
+    }
+
+    namespace Animation
+    {
+        /**
+        * \class BlendTreeComponentManager
+        *
+        * \brief Evaluates a blend tree per entity and writes the resulting local transformations of its targets.
+        *
+        * Like the animation player, joints that no clip of the tree animates keep the local transformation they
+        * had when the component was first updated.
+        */
+        class BlendTreeComponentManager : public BaseSingleInstanceComponentManager
+        {
+        public:
+            struct Data
+            {
+                Data(Entity entity, BlendTreePtr const& tree, std::vector<Entity> const& targets)
+                    : entity(entity), tree(tree), targets(targets), state(*tree) {}
+
+                Entity              entity;
+                BlendTreePtr        tree;
+                std::vector<Entity> targets;   ///< Entity of each joint of the tree
+                BlendTreeState      state;
+                PoseBuffer          rest_pose;
+            };
+
+        private:
+            std::vector<Data>         m_data;
+            mutable std::shared_mutex m_data_access_mutex;
+
+            PosePool m_pose_pool;
+
+        public:
+            BlendTreeComponentManager() = default;
+            ~BlendTreeComponentManager() = default;
+
+            /**
+            * \param targets Entity of each joint, needs to have tree->joint_cnt entries
+            */
+            void addComponent(Entity entity, BlendTreePtr const& tree, std::vector<Entity> const& targets);
+
+            /**
+            * \brief Set a blend weight parameter of the entity's tree, values are clamped to [0,1] on evaluation
+            */
+            void setParameter(Entity entity, uint32_t parameter_idx, float value);
+
+            float getParameter(Entity entity, uint32_t parameter_idx) const;
+
+            size_t getComponentCount() const;
+
+            /**
+            * \brief Advance and evaluate the trees in the range [first, last) and write the local transformations.
+            * Can be called concurrently for disjoint ranges.
+            */
+            void update(size_t first, size_t last, double dt, Common::TransformComponentManager& transform_mngr);
+        };
+    }
+}
+
+#endif // !BlendTreeComponentManager_hpp
@@ -0,0 +1,743 @@
+#include "Broadphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    constexpr size_t leaves_per_task = 1024;
+    constexpr size_t proxies_per_task = 4096;
+
+    using EngineCore::Physics::AABB;
+    using EngineCore::Physics::BroadphasePair;
+    using EngineCore::Physics::BroadphaseRayHit;
+
+    AABB combine(AABB const& a, AABB const& b)
+    {
+        return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+    }
+
+    float surfaceArea(AABB const& b)
+    {
+        Vec3 d = b.max - b.min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool overlaps(AABB const& a, AABB const& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+            a.min.y <= b.max.y && b.min.y <= a.max.y &&
+            a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    bool contains(AABB const& outer, AABB const& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+            inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    struct Ray
+    {
+        Vec3  origin;
+        Vec3  direction;
+        Vec3  inverse_direction;
+        float max_distance;
+    };
+
+    Ray makeRay(Vec3 const& origin, Vec3 const& direction, float max_distance)
+    {
+        return { origin, direction, Vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z), max_distance };
+    }
+
+    /** Slab test, distance is where the ray enters the box */
+    bool intersectSlabs(AABB const& b, Ray const& ray, float& distance)
+    {
+        float t_min = 0.0f;
+        float t_max = ray.max_distance;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            if (ray.direction[k] == 0.0f)
+            {
+                if (ray.origin[k] < b.min[k] || ray.origin[k] > b.max[k])
+                    return false;
+                continue;
+            }
+
+            float t_0 = (b.min[k] - ray.origin[k]) * ray.inverse_direction[k];
+            float t_1 = (b.max[k] - ray.origin[k]) * ray.inverse_direction[k];
+            t_min = std::max(t_min, std::min(t_0, t_1));
+            t_max = std::min(t_max, std::max(t_0, t_1));
+
+            if (t_min > t_max)
+                return false;
+        }
+
+        distance = t_min;
+        return true;
+    }
+
+    bool pairLess(BroadphasePair const& lhs, BroadphasePair const& rhs)
+    {
+        return lhs.proxy_a < rhs.proxy_a || (lhs.proxy_a == rhs.proxy_a && lhs.proxy_b < rhs.proxy_b);
+    }
+
+    bool hitLess(BroadphaseRayHit const& lhs, BroadphaseRayHit const& rhs)
+    {
+        return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.proxy < rhs.proxy);
+    }
+
+    /** Concatenate per task results in task order */
+    void gatherPairs(std::vector<std::vector<BroadphasePair>> const& task_pairs, std::vector<BroadphasePair>& pairs)
+    {
+        size_t pair_cnt = 0;
+        for (auto const& p : task_pairs) {
+            pair_cnt += p.size();
+        }
+
+        pairs.clear();
+        pairs.reserve(pair_cnt);
+        for (auto const& p : task_pairs) {
+            pairs.insert(pairs.end(), p.begin(), p.end());
+        }
+    }
+}
+
+bool EngineCore::Physics::intersects(AABB const& a, AABB const& b)
+{
+    return overlaps(a, b);
+}
+
+bool EngineCore::Physics::intersectRay(AABB const& box, Vec3 origin, Vec3 direction, float max_distance, float& distance)
+{
+    return intersectSlabs(box, makeRay(origin, direction, max_distance), distance);
+}
+
+EngineCore::Physics::DynamicAABBTree::DynamicAABBTree(float fat_margin)
+    : m_root(invalid_proxy), m_free_list(invalid_proxy), m_proxy_cnt(0), m_fat_margin(fat_margin)
+{
+}
+
+uint32_t EngineCore::Physics::DynamicAABBTree::createProxy(AABB const& bounds, uint64_t user_data)
+{
+    uint32_t proxy = allocateNode();
+
+    m_nodes[proxy].bounds = { bounds.min - Vec3(m_fat_margin), bounds.max + Vec3(m_fat_margin) };
+    m_nodes[proxy].user_data = user_data;
+    m_nodes[proxy].height = 0;
+
+    insertLeaf(proxy);
+    ++m_proxy_cnt;
+
+    return proxy;
+}
+
+void EngineCore::Physics::DynamicAABBTree::destroyProxy(uint32_t proxy)
+{
+    assert(proxy < m_nodes.size() && m_nodes[proxy].isLeaf());
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --m_proxy_cnt;
+}
+
+bool EngineCore::Physics::DynamicAABBTree::moveProxy(uint32_t proxy, AABB const& bounds)
+{
+    assert(proxy < m_nodes.size() && m_nodes[proxy].isLeaf());
+
+    AABB const& fat_bounds = m_nodes[proxy].bounds;
+
+    // also reinsert proxies that shrank a lot, their fat AABB would cause many false pairs
+    Vec3 loose_margin(4.0f * m_fat_margin);
+    AABB loose_bounds = { bounds.min - loose_margin, bounds.max + loose_margin };
+
+    if (contains(fat_bounds, bounds) && contains(loose_bounds, fat_bounds))
+        return false;
+
+    removeLeaf(proxy);
+    m_nodes[proxy].bounds = { bounds.min - Vec3(m_fat_margin), bounds.max + Vec3(m_fat_margin) };
+    insertLeaf(proxy);
+
+    return true;
+}
+
+EngineCore::Physics::AABB const& EngineCore::Physics::DynamicAABBTree::getFatAABB(uint32_t proxy) const
+{
+    return m_nodes[proxy].bounds;
+}
+
+uint64_t EngineCore::Physics::DynamicAABBTree::getUserData(uint32_t proxy) const
+{
+    return m_nodes[proxy].user_data;
+}
+
+size_t EngineCore::Physics::DynamicAABBTree::getProxyCount() const
+{
+    return m_proxy_cnt;
+}
+
+int EngineCore::Physics::DynamicAABBTree::getHeight() const
+{
+    return m_root == invalid_proxy ? 0 : m_nodes[m_root].height;
+}
+
+void EngineCore::Physics::DynamicAABBTree::computePairs(Utility::TaskScheduler& task_scheduler, std::vector<BroadphasePair>& pairs) const
+{
+    std::vector<uint32_t> leaves;
+    leaves.reserve(m_proxy_cnt);
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i].height == 0) {
+            leaves.push_back(i);
+        }
+    }
+
+    size_t task_cnt = (leaves.size() + leaves_per_task - 1) / leaves_per_task;
+    std::vector<std::vector<BroadphasePair>> task_pairs(task_cnt);
+
+    for (size_t task = 0; task < task_cnt; ++task)
+    {
+        task_scheduler.submitTask([this, &leaves, &task_pairs, task]() {
+            size_t first = task * leaves_per_task;
+            size_t last = std::min(first + leaves_per_task, leaves.size());
+
+            std::vector<uint32_t> stack;
+            std::vector<uint32_t> overlapping;
+            auto& result = task_pairs[task];
+
+            for (size_t i = first; i < last; ++i)
+            {
+                uint32_t leaf = leaves[i];
+                AABB const& bounds = m_nodes[leaf].bounds;
+
+                overlapping.clear();
+                stack.push_back(m_root);
+
+                while (!stack.empty())
+                {
+                    uint32_t node = stack.back();
+                    stack.pop_back();
+
+                    Node const& n = m_nodes[node];
+                    if (!overlaps(n.bounds, bounds))
+                        continue;
+
+                    if (n.isLeaf())
+                    {
+                        // each pair is reported by its lower proxy
+                        if (node > leaf) {
+                            overlapping.push_back(node);
+                        }
+                    }
+                    else
+                    {
+                        stack.push_back(n.children[0]);
+                        stack.push_back(n.children[1]);
+                    }
+                }
+
+                std::sort(overlapping.begin(), overlapping.end());
+                for (uint32_t other : overlapping) {
+                    result.push_back({ leaf, other });
+                }
+            }
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    gatherPairs(task_pairs, pairs);
+}
+
+void EngineCore::Physics::DynamicAABBTree::queryBox(AABB const& box, std::vector<uint32_t>& proxies) const
+{
+    proxies.clear();
+
+    if (m_root == invalid_proxy)
+        return;
+
+    std::vector<uint32_t> stack = { m_root };
+
+    while (!stack.empty())
+    {
+        uint32_t node = stack.back();
+        stack.pop_back();
+
+        Node const& n = m_nodes[node];
+        if (!overlaps(n.bounds, box))
+            continue;
+
+        if (n.isLeaf())
+        {
+            proxies.push_back(node);
+        }
+        else
+        {
+            stack.push_back(n.children[0]);
+            stack.push_back(n.children[1]);
+        }
+    }
+
+    std::sort(proxies.begin(), proxies.end());
+}
+
+void EngineCore::Physics::DynamicAABBTree::queryRay(Vec3 origin, Vec3 direction, float max_distance, std::vector<BroadphaseRayHit>& hits) const
+{
+    hits.clear();
+
+    if (m_root == invalid_proxy)
+        return;
+
+    Ray ray = makeRay(origin, direction, max_distance);
+    std::vector<uint32_t> stack = { m_root };
+
+    while (!stack.empty())
+    {
+        uint32_t node = stack.back();
+        stack.pop_back();
+
+        Node const& n = m_nodes[node];
+        float distance;
+        if (!intersectSlabs(n.bounds, ray, distance))
+            continue;
+
+        if (n.isLeaf())
+        {
+            hits.push_back({ node, distance });
+        }
+        else
+        {
+            stack.push_back(n.children[0]);
+            stack.push_back(n.children[1]);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), hitLess);
+}
+
+uint32_t EngineCore::Physics::DynamicAABBTree::allocateNode()
+{
+    uint32_t node;
+
+    if (m_free_list != invalid_proxy)
+    {
+        node = m_free_list;
+        m_free_list = m_nodes[node].parent;
+    }
+    else
+    {
+        node = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(Node());
+    }
+
+    m_nodes[node].parent = invalid_proxy;
+    m_nodes[node].children[0] = invalid_proxy;
+    m_nodes[node].children[1] = invalid_proxy;
+    m_nodes[node].height = 0;
+    m_nodes[node].user_data = 0;
+
+    return node;
+}
+
+void EngineCore::Physics::DynamicAABBTree::freeNode(uint32_t node)
+{
+    m_nodes[node].parent = m_free_list;
+    m_nodes[node].height = -1;
+    m_free_list = node;
+}
+
+void EngineCore::Physics::DynamicAABBTree::insertLeaf(uint32_t leaf)
+{
+    if (m_root == invalid_proxy)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = invalid_proxy;
+        return;
+    }
+
+    AABB leaf_bounds = m_nodes[leaf].bounds;
+
+    // branch and bound search for the sibling with the lowest surface area cost, the cost of a sibling is the area
+    // of the new parent plus the area growth of all its ancestors
+    float leaf_area = surfaceArea(leaf_bounds);
+
+    uint32_t sibling = m_root;
+    float best_cost = surfaceArea(combine(m_nodes[m_root].bounds, leaf_bounds));
+
+    std::vector<std::pair<uint32_t, float>> stack; ///< Node and the area growth of its ancestors
+    stack.push_back({ m_root, 0.0f });
+
+    while (!stack.empty())
+    {
+        auto [node, inherited_cost] = stack.back();
+        stack.pop_back();
+
+        Node const& n = m_nodes[node];
+        float combined_area = surfaceArea(combine(n.bounds, leaf_bounds));
+        float cost = combined_area + inherited_cost;
+
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            sibling = node;
+        }
+
+        if (n.isLeaf())
+            continue;
+
+        // lower bound of the cost of any descendant
+        float child_inherited_cost = inherited_cost + combined_area - surfaceArea(n.bounds);
+        if (leaf_area + child_inherited_cost < best_cost)
+        {
+            stack.push_back({ n.children[0], child_inherited_cost });
+            stack.push_back({ n.children[1], child_inherited_cost });
+        }
+    }
+
+    uint32_t old_parent = m_nodes[sibling].parent;
+    uint32_t new_parent = allocateNode();
+
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].bounds = combine(leaf_bounds, m_nodes[sibling].bounds);
+    m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+    m_nodes[new_parent].children[0] = sibling;
+    m_nodes[new_parent].children[1] = leaf;
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf].parent = new_parent;
+
+    if (old_parent != invalid_proxy)
+    {
+        Node& p = m_nodes[old_parent];
+        p.children[p.children[0] == sibling ? 0 : 1] = new_parent;
+    }
+    else
+    {
+        m_root = new_parent;
+    }
+
+    // refit and rebalance up to the root
+    for (uint32_t node = m_nodes[leaf].parent; node != invalid_proxy; node = m_nodes[node].parent)
+    {
+        node = balance(node);
+
+        Node& n = m_nodes[node];
+        Node const& child_0 = m_nodes[n.children[0]];
+        Node const& child_1 = m_nodes[n.children[1]];
+        n.height = 1 + std::max(child_0.height, child_1.height);
+        n.bounds = combine(child_0.bounds, child_1.bounds);
+    }
+}
+
+void EngineCore::Physics::DynamicAABBTree::removeLeaf(uint32_t leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = invalid_proxy;
+        return;
+    }
+
+    uint32_t parent = m_nodes[leaf].parent;
+    uint32_t grand_parent = m_nodes[parent].parent;
+    uint32_t sibling = m_nodes[parent].children[0] == leaf ? m_nodes[parent].children[1] : m_nodes[parent].children[0];
+
+    freeNode(parent);
+
+    if (grand_parent == invalid_proxy)
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = invalid_proxy;
+        return;
+    }
+
+    Node& g = m_nodes[grand_parent];
+    g.children[g.children[0] == parent ? 0 : 1] = sibling;
+    m_nodes[sibling].parent = grand_parent;
+
+    for (uint32_t node = grand_parent; node != invalid_proxy; node = m_nodes[node].parent)
+    {
+        node = balance(node);
+
+        Node& n = m_nodes[node];
+        Node const& child_0 = m_nodes[n.children[0]];
+        Node const& child_1 = m_nodes[n.children[1]];
+        n.height = 1 + std::max(child_0.height, child_1.height);
+        n.bounds = combine(child_0.bounds, child_1.bounds);
+    }
+}
+
+uint32_t EngineCore::Physics::DynamicAABBTree::balance(uint32_t a)
+{
+    if (m_nodes[a].isLeaf() || m_nodes[a].height < 2)
+        return a;
+
+    // the taller child b is rotated up, its taller child stays below it and its shorter child moves to a
+    int taller = m_nodes[m_nodes[a].children[1]].height > m_nodes[m_nodes[a].children[0]].height ? 1 : 0;
+    uint32_t b = m_nodes[a].children[taller];
+    uint32_t c = m_nodes[a].children[1 - taller];
+
+    if (m_nodes[b].height - m_nodes[c].height <= 1)
+        return a;
+
+    uint32_t f = m_nodes[b].children[0];
+    uint32_t g = m_nodes[b].children[1];
+    if (m_nodes[f].height < m_nodes[g].height) {
+        std::swap(f, g);
+    }
+
+    // b replaces a below a's parent
+    uint32_t parent = m_nodes[a].parent;
+    m_nodes[b].parent = parent;
+    if (parent != invalid_proxy)
+    {
+        Node& p = m_nodes[parent];
+        p.children[p.children[0] == a ? 0 : 1] = b;
+    }
+    else
+    {
+        m_root = b;
+    }
+
+    // a keeps c and takes the shorter child g, b takes a and f
+    m_nodes[a].children[taller] = g;
+    m_nodes[g].parent = a;
+    m_nodes[a].parent = b;
+    m_nodes[b].children[0] = a;
+    m_nodes[b].children[1] = f;
+
+    m_nodes[a].bounds = combine(m_nodes[c].bounds, m_nodes[g].bounds);
+    m_nodes[a].height = 1 + std::max(m_nodes[c].height, m_nodes[g].height);
+    m_nodes[b].bounds = combine(m_nodes[a].bounds, m_nodes[f].bounds);
+    m_nodes[b].height = 1 + std::max(m_nodes[a].height, m_nodes[f].height);
+
+    return b;
+}
+
+EngineCore::Physics::IncrementalSweepAndPrune::IncrementalSweepAndPrune()
+    : m_proxy_cnt(0), m_unsorted_cnt(0), m_max_width(0.0f)
+{
+}
+
+uint32_t EngineCore::Physics::IncrementalSweepAndPrune::createProxy(AABB const& bounds, uint64_t user_data)
+{
+    uint32_t proxy;
+
+    if (!m_free_proxies.empty())
+    {
+        proxy = m_free_proxies.back();
+        m_free_proxies.pop_back();
+        m_bounds[proxy] = bounds;
+        m_user_data[proxy] = user_data;
+        m_alive[proxy] = 1;
+    }
+    else
+    {
+        proxy = static_cast<uint32_t>(m_bounds.size());
+        m_bounds.push_back(bounds);
+        m_user_data.push_back(user_data);
+        m_alive.push_back(1);
+    }
+
+    m_order.push_back(proxy);
+    ++m_proxy_cnt;
+    ++m_unsorted_cnt;
+
+    return proxy;
+}
+
+void EngineCore::Physics::IncrementalSweepAndPrune::destroyProxy(uint32_t proxy)
+{
+    assert(proxy < m_alive.size() && m_alive[proxy]);
+
+    // the id is reused only after the next sort removed it from the order
+    m_alive[proxy] = 0;
+    --m_proxy_cnt;
+    ++m_unsorted_cnt;
+}
+
+void EngineCore::Physics::IncrementalSweepAndPrune::moveProxy(uint32_t proxy, AABB const& bounds)
+{
+    m_bounds[proxy] = bounds;
+}
+
+EngineCore::Physics::AABB const& EngineCore::Physics::IncrementalSweepAndPrune::getAABB(uint32_t proxy) const
+{
+    return m_bounds[proxy];
+}
+
+uint64_t EngineCore::Physics::IncrementalSweepAndPrune::getUserData(uint32_t proxy) const
+{
+    return m_user_data[proxy];
+}
+
+size_t EngineCore::Physics::IncrementalSweepAndPrune::getProxyCount() const
+{
+    return m_proxy_cnt;
+}
+
+void EngineCore::Physics::IncrementalSweepAndPrune::computePairs(Utility::TaskScheduler& task_scheduler, std::vector<BroadphasePair>& pairs)
+{
+    sort();
+
+    size_t proxy_cnt = m_order.size();
+    size_t task_cnt = (proxy_cnt + proxies_per_task - 1) / proxies_per_task;
+    std::vector<std::vector<BroadphasePair>> task_pairs(task_cnt);
+
+    for (size_t task = 0; task < task_cnt; ++task)
+    {
+        task_scheduler.submitTask([this, &task_pairs, task, proxy_cnt]() {
+            size_t first = task * proxies_per_task;
+            size_t last = std::min(first + proxies_per_task, proxy_cnt);
+            auto& result = task_pairs[task];
+
+            for (size_t i = first; i < last; ++i)
+            {
+                AABB const& a = m_sorted_bounds[i];
+
+                for (size_t j = i + 1; j < proxy_cnt && m_sorted_bounds[j].min.x <= a.max.x; ++j)
+                {
+                    AABB const& b = m_sorted_bounds[j];
+
+                    if (a.min.y > b.max.y || b.min.y > a.max.y || a.min.z > b.max.z || b.min.z > a.max.z)
+                        continue;
+
+                    result.push_back({ std::min(m_order[i], m_order[j]), std::max(m_order[i], m_order[j]) });
+                }
+            }
+
+            std::sort(result.begin(), result.end(), pairLess);
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    gatherPairs(task_pairs, pairs);
+
+    // the task results are sorted, merge them pairwise
+    std::vector<size_t> ranges = { 0 };
+    for (auto const& p : task_pairs) {
+        ranges.push_back(ranges.back() + p.size());
+    }
+
+    for (size_t width = 1; width < task_cnt; width *= 2)
+    {
+        for (size_t i = 0; i + width < task_cnt; i += 2 * width)
+        {
+            std::inplace_merge(
+                pairs.begin() + ranges[i],
+                pairs.begin() + ranges[i + width],
+                pairs.begin() + ranges[std::min(i + 2 * width, task_cnt)],
+                pairLess);
+        }
+    }
+}
+
+void EngineCore::Physics::IncrementalSweepAndPrune::queryBox(AABB const& box, std::vector<uint32_t>& proxies) const
+{
+    proxies.clear();
+
+    for (size_t i = findFirstCandidate(box.min.x); i < m_sorted_bounds.size() && m_sorted_bounds[i].min.x <= box.max.x; ++i)
+    {
+        if (overlaps(m_sorted_bounds[i], box)) {
+            proxies.push_back(m_order[i]);
+        }
+    }
+
+    std::sort(proxies.begin(), proxies.end());
+}
+
+void EngineCore::Physics::IncrementalSweepAndPrune::queryRay(Vec3 origin, Vec3 direction, float max_distance, std::vector<BroadphaseRayHit>& hits) const
+{
+    hits.clear();
+
+    Ray ray = makeRay(origin, direction, max_distance);
+    float min_x = ray.direction.x < 0.0f ? origin.x + ray.direction.x * max_distance : origin.x;
+    float max_x = ray.direction.x > 0.0f ? origin.x + ray.direction.x * max_distance : origin.x;
+
+    for (size_t i = findFirstCandidate(min_x); i < m_sorted_bounds.size() && m_sorted_bounds[i].min.x <= max_x; ++i)
+    {
+        float distance;
+        if (intersectSlabs(m_sorted_bounds[i], ray, distance)) {
+            hits.push_back({ m_order[i], distance });
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), hitLess);
+}
+
+size_t EngineCore::Physics::IncrementalSweepAndPrune::findFirstCandidate(float min_x) const
+{
+    // no proxy that starts further left than the widest proxy can reach min_x
+    float start_x = min_x - m_max_width;
+
+    auto first = std::partition_point(m_sorted_bounds.begin(), m_sorted_bounds.end(), [start_x](AABB const& b) { return b.min.x < start_x; });
+
+    return static_cast<size_t>(first - m_sorted_bounds.begin());
+}
+
+void EngineCore::Physics::IncrementalSweepAndPrune::sort()
+{
+    auto less = [this](uint32_t lhs, uint32_t rhs) {
+        float lhs_x = m_bounds[lhs].min.x;
+        float rhs_x = m_bounds[rhs].min.x;
+        return lhs_x < rhs_x || (lhs_x == rhs_x && lhs < rhs);
+    };
+
+    if (m_unsorted_cnt > 0)
+    {
+        m_order.erase(std::remove_if(m_order.begin(), m_order.end(), [this](uint32_t proxy) { return m_alive[proxy] == 0; }), m_order.end());
+
+        m_free_proxies.clear();
+        for (uint32_t proxy = 0; proxy < m_alive.size(); ++proxy)
+        {
+            if (m_alive[proxy] == 0) {
+                m_free_proxies.push_back(proxy);
+            }
+        }
+    }
+
+    size_t proxy_cnt = m_order.size();
+
+    bool sorted = false;
+
+    // insertion sort is close to linear for coherent movement, give up if it is not
+    if (m_unsorted_cnt <= proxy_cnt / 8)
+    {
+        size_t move_budget = 4 * proxy_cnt + 1024;
+        sorted = true;
+
+        for (size_t i = 1; i < proxy_cnt && sorted; ++i)
+        {
+            uint32_t proxy = m_order[i];
+            size_t j = i;
+
+            while (j > 0 && less(proxy, m_order[j - 1]))
+            {
+                m_order[j] = m_order[j - 1];
+                --j;
+
+                if (--move_budget == 0)
+                {
+                    sorted = false;
+                    break;
+                }
+            }
+
+            m_order[j] = proxy;
+        }
+    }
+
+    if (!sorted) {
+        std::sort(m_order.begin(), m_order.end(), less);
+    }
+
+    m_unsorted_cnt = 0;
+
+    m_sorted_bounds.resize(proxy_cnt);
+    m_max_width = 0.0f;
+    for (size_t i = 0; i < proxy_cnt; ++i)
+    {
+        m_sorted_bounds[i] = m_bounds[m_order[i]];
+        m_max_width = std::max(m_max_width, m_sorted_bounds[i].max.x - m_sorted_bounds[i].min.x);
+    }
+}
@@ -0,0 +1,183 @@
+#ifndef Broadphase_hpp
+#define Broadphase_hpp
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Physics
+    {
+        struct AABB
+        {
+            Vec3 min;
+            Vec3 max;
+        };
+
+        /** Overlapping proxies, proxy_a < proxy_b */
+        struct BroadphasePair
+        {
+            uint32_t proxy_a;
+            uint32_t proxy_b;
+        };
+
+        struct BroadphaseRayHit
+        {
+            uint32_t proxy;
+            float    distance; ///< Distance along the ray at which it enters the bounds, 0 if the origin is inside
+        };
+
+        constexpr uint32_t invalid_proxy = std::numeric_limits<uint32_t>::max();
+
+        bool intersects(AABB const& a, AABB const& b);
+
+        /**
+        * \brief Slab test of a ray against a box, distance is where the ray enters the box. The direction does not need
+        * to be normalized, distances are measured in units of its length.
+        */
+        bool intersectRay(AABB const& box, Vec3 origin, Vec3 direction, float max_distance, float& distance);
+
+        /**
+        * \class DynamicAABBTree
+        *
+        * \brief Bounding volume hierarchy over fat AABBs, i.e. bounds enlarged by a margin, so that small movements do
+        * not change the tree. Leaves are inserted by surface area heuristic and the tree is kept balanced with AVL
+        * rotations.
+        *
+        * Proxy ids are node indices and stay valid until the proxy is destroyed. Not thread safe for modification,
+        * queries and computePairs are const and can run concurrently.
+        */
+        class DynamicAABBTree
+        {
+        public:
+            DynamicAABBTree(float fat_margin = 0.1f);
+            ~DynamicAABBTree() = default;
+
+            uint32_t createProxy(AABB const& bounds, uint64_t user_data);
+
+            void destroyProxy(uint32_t proxy);
+
+            /**
+            * \brief Update the bounds of a proxy. Returns true if the proxy left its fat AABB and was reinserted.
+            */
+            bool moveProxy(uint32_t proxy, AABB const& bounds);
+
+            AABB const& getFatAABB(uint32_t proxy) const;
+
+            uint64_t getUserData(uint32_t proxy) const;
+
+            size_t getProxyCount() const;
+
+            int getHeight() const;
+
+            /**
+            * \brief All pairs of proxies with overlapping fat AABBs, sorted. Each task queries the tree for a range
+            * of leaves.
+            */
+            void computePairs(Utility::TaskScheduler& task_scheduler, std::vector<BroadphasePair>& pairs) const;
+
+            void queryBox(AABB const& box, std::vector<uint32_t>& proxies) const;
+
+            /**
+            * \brief All proxies whose fat AABB is hit by the ray within max_distance, sorted by distance. Distances are
+            * measured in units of the direction length.
+            */
+            void queryRay(Vec3 origin, Vec3 direction, float max_distance, std::vector<BroadphaseRayHit>& hits) const;
+
+        private:
+            struct Node
+            {
+                AABB     bounds;
+                uint64_t user_data;
+                uint32_t parent;      ///< Next free node for nodes in the free list
+                uint32_t children[2];
+                int32_t  height;      ///< 0 for leaves, -1 for free nodes
+
+                bool isLeaf() const { return children[0] == invalid_proxy; }
+            };
+
+            uint32_t allocateNode();
+
+            void freeNode(uint32_t node);
+
+            void insertLeaf(uint32_t leaf);
+
+            void removeLeaf(uint32_t leaf);
+
+            /** Rotates the subtree if it is imbalanced, returns the new subtree root */
+            uint32_t balance(uint32_t node);
+
+            std::vector<Node> m_nodes;
+
+            uint32_t m_root;
+            uint32_t m_free_list;
+            size_t   m_proxy_cnt;
+            float    m_fat_margin;
+        };
+
+        /**
+        * \class IncrementalSweepAndPrune
+        *
+        * \brief Keeps proxies sorted by the lower bound along the x axis and sweeps the sorted list for overlaps.
+        *
+        * The order is kept from the last update and restored with insertion sort, which is close to linear for
+        * coherent movement. Large changes, e.g. many new proxies, fall back to a full sort. Not thread safe for
+        * modification, queries are const and can run concurrently after computePairs.
+        */
+        class IncrementalSweepAndPrune
+        {
+        public:
+            IncrementalSweepAndPrune();
+            ~IncrementalSweepAndPrune() = default;
+
+            uint32_t createProxy(AABB const& bounds, uint64_t user_data);
+
+            void destroyProxy(uint32_t proxy);
+
+            void moveProxy(uint32_t proxy, AABB const& bounds);
+
+            AABB const& getAABB(uint32_t proxy) const;
+
+            uint64_t getUserData(uint32_t proxy) const;
+
+            size_t getProxyCount() const;
+
+            /**
+            * \brief Restore the sort order and return all pairs of proxies with overlapping AABBs, sorted. The sweep
+            * is split into ranges of the sorted list, one task per range.
+            */
+            void computePairs(Utility::TaskScheduler& task_scheduler, std::vector<BroadphasePair>& pairs);
+
+            /**
+            * \brief Queries use the sort order of the last computePairs, call it after moving proxies.
+            */
+            void queryBox(AABB const& box, std::vector<uint32_t>& proxies) const;
+
+            void queryRay(Vec3 origin, Vec3 direction, float max_distance, std::vector<BroadphaseRayHit>& hits) const;
+
+        private:
+            void sort();
+
+            /** Index of the first proxy in sort order that can overlap the interval starting at min_x */
+            size_t findFirstCandidate(float min_x) const;
+
+            std::vector<AABB>     m_bounds;
+            std::vector<uint64_t> m_user_data;
+            std::vector<uint8_t>  m_alive;
+            std::vector<uint32_t> m_free_proxies;
+
+            std::vector<uint32_t> m_order;           ///< Live proxies sorted by bounds.min.x
+            std::vector<AABB>     m_sorted_bounds;   ///< Bounds in sort order for cache friendly sweeps
+
+            size_t m_proxy_cnt;
+            size_t m_unsorted_cnt;                   ///< Proxies created or destroyed since the last sort
+            float  m_max_width;                      ///< Largest extent along the x axis, bounds the backwards search of queries
+        };
+    }
+}
+
+#endif // !Broadphase_hpp
@@ -0,0 +1,280 @@
+#include "BroadphaseService.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "BoundingBoxComponent.hpp"
+#include "BoundingCylinderComponent.hpp"
+#include "BoundingSphereComponent.hpp"
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace
+{
+    constexpr size_t volumes_per_task = 4096;
+
+    using EngineCore::Physics::AABB;
+
+    /** World space AABB of a box with the given local half extents */
+    AABB transformBox(Mat4x4 const& transform, Vec3 const& half_extents)
+    {
+        Vec3 center(transform[3]);
+        Vec3 extent =
+            glm::abs(Vec3(transform[0])) * half_extents.x +
+            glm::abs(Vec3(transform[1])) * half_extents.y +
+            glm::abs(Vec3(transform[2])) * half_extents.z;
+
+        return { center - extent, center + extent };
+    }
+
+    Vec3 getScale(Mat4x4 const& transform)
+    {
+        return Vec3(glm::length(Vec3(transform[0])), glm::length(Vec3(transform[1])), glm::length(Vec3(transform[2])));
+    }
+}
+
+EngineCore::Physics::BroadphaseService::BroadphaseService(WorldState& world, Method method, float fat_margin)
+    : m_world(world), m_method(method), m_tree(fat_margin)
+{
+}
+
+void EngineCore::Physics::BroadphaseService::update(Utility::TaskScheduler& task_scheduler)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    for (int type = 0; type < VOLUME_TYPE_CNT; ++type) {
+        gatherBounds(static_cast<VolumeType>(type), task_scheduler);
+    }
+
+    std::vector<BroadphasePair> pairs;
+    if (m_method == Method::DYNAMIC_AABB_TREE) {
+        m_tree.computePairs(task_scheduler, pairs);
+    }
+    else {
+        m_sweep_and_prune.computePairs(task_scheduler, pairs);
+    }
+
+    m_overlaps.clear();
+
+    for (auto const& pair : pairs)
+    {
+        uint64_t user_data_a = m_method == Method::DYNAMIC_AABB_TREE ? m_tree.getUserData(pair.proxy_a) : m_sweep_and_prune.getUserData(pair.proxy_a);
+        uint64_t user_data_b = m_method == Method::DYNAMIC_AABB_TREE ? m_tree.getUserData(pair.proxy_b) : m_sweep_and_prune.getUserData(pair.proxy_b);
+
+        Volume const& a = getVolume(user_data_a);
+        Volume const& b = getVolume(user_data_b);
+
+        // tree pairs are found with fat bounds
+        if (a.entity.id() == b.entity.id() || !intersects(a.bounds, b.bounds))
+            continue;
+
+        m_overlaps.push_back({ a.entity, b.entity });
+    }
+}
+
+std::vector<EngineCore::Physics::BroadphaseService::Overlap> EngineCore::Physics::BroadphaseService::getOverlaps() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_overlaps;
+}
+
+std::vector<EngineCore::Physics::BroadphaseService::RayHit> EngineCore::Physics::BroadphaseService::queryRay(Vec3 origin, Vec3 direction, float max_distance) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    direction = glm::normalize(direction);
+
+    std::vector<BroadphaseRayHit> candidates;
+    if (m_method == Method::DYNAMIC_AABB_TREE) {
+        m_tree.queryRay(origin, direction, max_distance, candidates);
+    }
+    else {
+        m_sweep_and_prune.queryRay(origin, direction, max_distance, candidates);
+    }
+
+    std::vector<RayHit> hits;
+    for (auto const& candidate : candidates)
+    {
+        uint64_t user_data = m_method == Method::DYNAMIC_AABB_TREE ? m_tree.getUserData(candidate.proxy) : m_sweep_and_prune.getUserData(candidate.proxy);
+        Volume const& volume = getVolume(user_data);
+
+        float distance;
+        if (intersectRay(volume.bounds, origin, direction, max_distance, distance)) {
+            hits.push_back({ volume.entity, distance });
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [](RayHit const& lhs, RayHit const& rhs) {
+        return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.entity.id() < rhs.entity.id());
+    });
+
+    return hits;
+}
+
+std::vector<Entity> EngineCore::Physics::BroadphaseService::queryBox(AABB const& box) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    std::vector<uint32_t> candidates;
+    if (m_method == Method::DYNAMIC_AABB_TREE) {
+        m_tree.queryBox(box, candidates);
+    }
+    else {
+        m_sweep_and_prune.queryBox(box, candidates);
+    }
+
+    std::vector<Entity> entities;
+    for (uint32_t proxy : candidates)
+    {
+        uint64_t user_data = m_method == Method::DYNAMIC_AABB_TREE ? m_tree.getUserData(proxy) : m_sweep_and_prune.getUserData(proxy);
+        Volume const& volume = getVolume(user_data);
+
+        if (intersects(volume.bounds, box)) {
+            entities.push_back(volume.entity);
+        }
+    }
+
+    std::sort(entities.begin(), entities.end(), [](Entity const& lhs, Entity const& rhs) { return lhs.id() < rhs.id(); });
+    entities.erase(std::unique(entities.begin(), entities.end(), [](Entity const& lhs, Entity const& rhs) { return lhs.id() == rhs.id(); }), entities.end());
+
+    return entities;
+}
+
+void EngineCore::Physics::BroadphaseService::gatherBounds(VolumeType type, Utility::TaskScheduler& task_scheduler)
+{
+    auto& volumes = m_volumes[type];
+
+    // resolve the managers once, the lookup locks the world state
+    auto const* box_mngr = m_world.has<Graphics::BoundingBoxComponentManager>() ? &m_world.get<Graphics::BoundingBoxComponentManager>() : nullptr;
+    auto const* sphere_mngr = m_world.has<Graphics::BoundingSphereComponentManager>() ? &m_world.get<Graphics::BoundingSphereComponentManager>() : nullptr;
+    auto const* cylinder_mngr = m_world.has<Graphics::BoundingCylinderComponentManager>() ? &m_world.get<Graphics::BoundingCylinderComponentManager>() : nullptr;
+    auto const* transform_mngr = m_world.has<Common::TransformComponentManager>() ? &m_world.get<Common::TransformComponentManager>() : nullptr;
+
+    size_t component_cnt = 0;
+    switch (type)
+    {
+    case BOX:
+        component_cnt = box_mngr != nullptr ? box_mngr->getComponentCount() : 0;
+        break;
+    case SPHERE:
+        component_cnt = sphere_mngr != nullptr ? sphere_mngr->getComponentCount() : 0;
+        break;
+    case CYLINDER:
+        component_cnt = cylinder_mngr != nullptr ? cylinder_mngr->getComponentCount() : 0;
+        break;
+    default:
+        break;
+    }
+
+    // bounding volume components are never removed, new components are appended
+    size_t known_cnt = volumes.size();
+    volumes.resize(component_cnt);
+
+    for (size_t first = 0; first < component_cnt; first += volumes_per_task)
+    {
+        size_t last = std::min(first + volumes_per_task, component_cnt);
+
+        task_scheduler.submitTask([&volumes, type, first, last, box_mngr, sphere_mngr, cylinder_mngr, transform_mngr]() {
+            for (size_t i = first; i < last; ++i)
+            {
+                uint idx = static_cast<uint>(i);
+                Volume& volume = volumes[i];
+
+                switch (type)
+                {
+                case BOX:
+                    volume.entity = box_mngr->getEntity(idx);
+                    break;
+                case SPHERE:
+                    volume.entity = sphere_mngr->getEntity(idx);
+                    break;
+                case CYLINDER:
+                    volume.entity = cylinder_mngr->getEntity(idx);
+                    break;
+                default:
+                    break;
+                }
+
+                Mat4x4 transform(1.0f);
+                if (transform_mngr != nullptr)
+                {
+                    size_t transform_idx = transform_mngr->getIndex(volume.entity);
+                    if (transform_idx != std::numeric_limits<size_t>::max()) {
+                        transform = transform_mngr->getWorldTransformation(transform_idx);
+                    }
+                }
+
+                switch (type)
+                {
+                case BOX:
+                {
+                    Vec3 half_extents = 0.5f * Vec3(box_mngr->getWidth(idx), box_mngr->getHeight(idx), box_mngr->getDepth(idx));
+
+                    if (box_mngr->getAlignment(idx) == Graphics::BoundingBoxComponentManager::BBAlignment::AXIS_ALIGNED)
+                    {
+                        // ignores the rotation of the entity
+                        Vec3 center(transform[3]);
+                        Vec3 extent = half_extents * getScale(transform);
+                        volume.bounds = { center - extent, center + extent };
+                    }
+                    else
+                    {
+                        volume.bounds = transformBox(transform, half_extents);
+                    }
+                    break;
+                }
+                case SPHERE:
+                {
+                    Vec3 scale = getScale(transform);
+                    float radius = sphere_mngr->getRadius(idx) * std::max(scale.x, std::max(scale.y, scale.z));
+                    Vec3 center(transform[3]);
+                    volume.bounds = { center - Vec3(radius), center + Vec3(radius) };
+                    break;
+                }
+                case CYLINDER:
+                {
+                    float radius = cylinder_mngr->getRadius(idx);
+                    volume.bounds = transformBox(transform, Vec3(radius, 0.5f * cylinder_mngr->getHeight(idx), radius));
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    // the acceleration structures are not thread safe for modification
+    for (size_t i = 0; i < component_cnt; ++i)
+    {
+        Volume& volume = volumes[i];
+
+        if (i < known_cnt)
+        {
+            if (m_method == Method::DYNAMIC_AABB_TREE) {
+                m_tree.moveProxy(volume.proxy, volume.bounds);
+            }
+            else {
+                m_sweep_and_prune.moveProxy(volume.proxy, volume.bounds);
+            }
+        }
+        else
+        {
+            uint64_t user_data = (static_cast<uint64_t>(type) << 32) | static_cast<uint64_t>(i);
+
+            if (m_method == Method::DYNAMIC_AABB_TREE) {
+                volume.proxy = m_tree.createProxy(volume.bounds, user_data);
+            }
+            else {
+                volume.proxy = m_sweep_and_prune.createProxy(volume.bounds, user_data);
+            }
+        }
+    }
+}
+
+EngineCore::Physics::BroadphaseService::Volume const& EngineCore::Physics::BroadphaseService::getVolume(uint64_t user_data) const
+{
+    return m_volumes[user_data >> 32][user_data & 0xffffffffull];
+}
@@ -0,0 +1,117 @@
+#ifndef BroadphaseService_hpp
+#define BroadphaseService_hpp
+
+#include <limits>
+#include <shared_mutex>
+#include <vector>
+
+#include "Broadphase.hpp"
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    class WorldState;
+
+    namespace Physics
+    {
+        /**
+        * \class BroadphaseService
+        *
+        * \brief Finds overlapping bounding volumes and answers ray and box queries, e.g. for picking and editor
+        * selection.
+        *
+        * Each update gathers the world space AABBs of all components of the BoundingBoxComponentManager,
+        * BoundingSphereComponentManager and BoundingCylinderComponentManager of the world (the ones that were added)
+        * and feeds them to either a dynamic AABB tree or an incremental sweep and prune. Volumes of entities without
+        * a transform component are placed at the origin. Bounding cylinders are aligned with the local y axis.
+        *
+        * Overlaps and query results are exact for the world space AABBs, independent of the method.
+        */
+        class BroadphaseService
+        {
+        public:
+            enum class Method
+            {
+                DYNAMIC_AABB_TREE,
+                SWEEP_AND_PRUNE
+            };
+
+            struct Overlap
+            {
+                Entity entity_a;
+                Entity entity_b;
+            };
+
+            struct RayHit
+            {
+                Entity entity;
+                float  distance;
+            };
+
+            BroadphaseService(WorldState& world, Method method = Method::DYNAMIC_AABB_TREE, float fat_margin = 0.1f);
+            ~BroadphaseService() = default;
+
+            BroadphaseService(BroadphaseService const& cpy) = delete;
+            BroadphaseService& operator=(BroadphaseService const& rhs) = delete;
+
+            /**
+            * \brief Gather the bounds of all bounding volumes and find overlaps. Bounds are gathered and pairs are
+            * found on the task scheduler. Meant to be called once per frame after transformations were updated.
+            */
+            void update(Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Overlapping volumes of different entities found by the last update
+            */
+            std::vector<Overlap> getOverlaps() const;
+
+            /**
+            * \brief Entities whose volumes are hit by the ray, sorted by distance. An entity with multiple volumes is
+            * reported once per hit volume.
+            */
+            std::vector<RayHit> queryRay(Vec3 origin, Vec3 direction, float max_distance = std::numeric_limits<float>::max()) const;
+
+            /**
+            * \brief Entities whose volumes overlap the box, each entity is reported once
+            */
+            std::vector<Entity> queryBox(AABB const& box) const;
+
+        private:
+            enum VolumeType
+            {
+                BOX,
+                SPHERE,
+                CYLINDER,
+                VOLUME_TYPE_CNT
+            };
+
+            struct Volume
+            {
+                Entity   entity;
+                AABB     bounds;  ///< World space bounds of the last update
+                uint32_t proxy;
+            };
+
+            void gatherBounds(VolumeType type, Utility::TaskScheduler& task_scheduler);
+
+            Volume const& getVolume(uint64_t user_data) const;
+
+            WorldState& m_world;
+            Method      m_method;
+
+            DynamicAABBTree          m_tree;
+            IncrementalSweepAndPrune m_sweep_and_prune;
+
+            /** Volumes per type, in component order of the respective component manager */
+            std::vector<Volume> m_volumes[VOLUME_TYPE_CNT];
+
+            std::vector<Overlap> m_overlaps;
+
+            mutable std::shared_mutex m_data_access_mutex;
+        };
+    }
+}
+
+#endif // !BroadphaseService_hpp
@@ -36,6 +36,10 @@ namespace EngineCore
         {
             std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
 
+            // checked again under the unique lock, a concurrent reserve might have grown the storage already
+            if (size <= m_data.allocated)
+                return;
+
             Data new_data;
             const uint bytes = size * (sizeof(Entity)
                 + 5 * sizeof(float)
@@ -58,14 +62,31 @@ namespace EngineCore
             std::memcpy(new_data.far_cp, m_data.far_cp, m_data.used * sizeof(float));
             std::memcpy(new_data.fovy, m_data.fovy, m_data.used * sizeof(float));
             std::memcpy(new_data.aspect_ratio, m_data.aspect_ratio, m_data.used * sizeof(float));
-            std::memcpy(new_data.exposure, m_data.exposure, m_data.used * sizeof(Mat4x4));
+            std::memcpy(new_data.exposure, m_data.exposure, m_data.used * sizeof(float));
             std::memcpy(new_data.projection_matrix, m_data.projection_matrix, m_data.used * sizeof(Mat4x4));
 
-            delete m_data.buffer;
+            delete[] m_data.buffer;
 
             m_data = new_data;
         }
 
+        void CameraComponentManager::reserve(uint size)
+        {
+            {
+                std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+                if (size <= m_data.allocated)
+                    return;
+            }
+
+            reallocate(size);
+        }
+
+        uint CameraComponentManager::getComponentCount() const
+        {
+            std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+            return m_data.used;
+        }
+
         void CameraComponentManager::addComponent(Entity entity, float near_cp, float far_cp, float fovy, float aspect_ratio, float exposure)
         {
             uint index = 0;
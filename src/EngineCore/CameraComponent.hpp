@@ -39,8 +39,16 @@ namespace EngineCore
             CameraComponentManager(uint size);
             ~CameraComponentManager();
 
+            /**
+             * Grow the component storage to the given size, smaller sizes are ignored
+             */
             void reallocate(uint size);
 
+            /**
+             * Grow the component storage to hold at least the given number of components
+             */
+            void reserve(uint size);
+
             void addComponent(Entity entity,
                 float near_cp = 0.001f,
                 float far_cp = 1000.0f,
@@ -50,6 +58,8 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            uint getComponentCount() const;
+
             bool checkComponent(uint entity_id) const;
 
             void setActiveCamera(Entity entity);
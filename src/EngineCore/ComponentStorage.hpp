@@ -22,6 +22,12 @@ namespace EngineCore {
 
             size_t addComponent(T component);
 
+            /**
+             * Add multiple components, taking the add lock only once.
+             * Returns the component indices in the order of the input.
+             */
+            std::vector<size_t> addComponents(std::vector<T>&& components);
+
             void deleteComponent(size_t component_index);
 
             size_t getComponentCount() const;
@@ -120,6 +126,64 @@ namespace EngineCore {
             return component_index;
         }
 
+        template<typename T, size_t PageCount, size_t PageSize>
+        inline std::vector<size_t> ComponentStorage<T, PageCount, PageSize>::addComponents(std::vector<T>&& components)
+        {
+            std::unique_lock<std::mutex> lock(add_component_mutex_);
+
+            std::vector<size_t> component_indices(components.size());
+
+            size_t locked_page_index = PageCount;
+            std::unique_lock<std::shared_mutex> page_lock;
+
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                size_t component_cnt = component_cnt_.load();
+                size_t component_index;
+
+                // check for free component slots to overwrite
+                if (!free_list_.empty())
+                {
+                    component_index = free_list_.front();
+                    free_list_.pop();
+                }
+                else
+                {
+                    component_index = component_cnt;
+                }
+
+                auto [page_index, index_in_page] = getIndices(component_index);
+                assert(page_index < PageCount);
+
+                // consecutive components mostly end up in the same page, keep its lock until the page changes
+                if (page_index != locked_page_index)
+                {
+                    page_lock = std::unique_lock<std::shared_mutex>(components_[page_index].mutex);
+                    locked_page_index = page_index;
+                }
+
+                if (components_[page_index].storage == nullptr)
+                {
+                    components_[page_index].storage = std::make_unique<std::vector<std::pair<bool, T>>>(PageSize);
+
+                    for (auto& c : (*components_[page_index].storage))
+                    {
+                        c.first = false;
+                    }
+                }
+
+                components_[page_index].storage->operator[](index_in_page) = { true, std::move(components[i]) };
+
+                if (component_index == component_cnt) {
+                    ++component_cnt_;
+                }
+
+                component_indices[i] = component_index;
+            }
+
+            return component_indices;
+        }
+
         template<typename T, size_t PageCount, size_t PageSize>
         inline void ComponentStorage<T, PageCount, PageSize>::deleteComponent(size_t component_index)
         {
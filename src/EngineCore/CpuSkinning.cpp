@@ -0,0 +1,435 @@
+#include "CpuSkinning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPU_SKINNING_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace
+{
+    inline void cross(float const* a, float const* b, float* result)
+    {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    inline void normalize3(float* v)
+    {
+        float length_sq = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+        if (length_sq > 0.0f)
+        {
+            float inv_length = 1.0f / std::sqrt(length_sq);
+            v[0] *= inv_length;
+            v[1] *= inv_length;
+            v[2] *= inv_length;
+        }
+    }
+
+    /** Rigid part of a column-major matrix as unit dual quaternion, scale is removed from the rotation */
+    void toDualQuaternion(Mat4x4 const& matrix, float* dq)
+    {
+        float const* m = &matrix[0][0];
+
+        // normalized rotation columns
+        float r[3][3];
+        for (int c = 0; c < 3; ++c)
+        {
+            r[c][0] = m[c * 4 + 0];
+            r[c][1] = m[c * 4 + 1];
+            r[c][2] = m[c * 4 + 2];
+            normalize3(r[c]);
+        }
+
+        // r[col][row]
+        float q[4];
+        float trace = r[0][0] + r[1][1] + r[2][2];
+        if (trace > 0.0f)
+        {
+            float s = std::sqrt(trace + 1.0f) * 2.0f;
+            q[3] = 0.25f * s;
+            q[0] = (r[1][2] - r[2][1]) / s;
+            q[1] = (r[2][0] - r[0][2]) / s;
+            q[2] = (r[0][1] - r[1][0]) / s;
+        }
+        else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+        {
+            float s = std::sqrt(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+            q[3] = (r[1][2] - r[2][1]) / s;
+            q[0] = 0.25f * s;
+            q[1] = (r[1][0] + r[0][1]) / s;
+            q[2] = (r[2][0] + r[0][2]) / s;
+        }
+        else if (r[1][1] > r[2][2])
+        {
+            float s = std::sqrt(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+            q[3] = (r[2][0] - r[0][2]) / s;
+            q[0] = (r[1][0] + r[0][1]) / s;
+            q[1] = 0.25f * s;
+            q[2] = (r[2][1] + r[1][2]) / s;
+        }
+        else
+        {
+            float s = std::sqrt(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+            q[3] = (r[0][1] - r[1][0]) / s;
+            q[0] = (r[2][0] + r[0][2]) / s;
+            q[1] = (r[2][1] + r[1][2]) / s;
+            q[2] = 0.25f * s;
+        }
+
+        float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        for (int i = 0; i < 4; ++i) {
+            q[i] /= length;
+        }
+
+        // dual part 0.5 * t * q with t as pure quaternion
+        float t[3] = { m[12], m[13], m[14] };
+        float t_cross_q[3];
+        cross(t, q, t_cross_q);
+
+        dq[0] = q[0];
+        dq[1] = q[1];
+        dq[2] = q[2];
+        dq[3] = q[3];
+        dq[4] = 0.5f * (q[3] * t[0] + t_cross_q[0]);
+        dq[5] = 0.5f * (q[3] * t[1] + t_cross_q[1]);
+        dq[6] = 0.5f * (q[3] * t[2] + t_cross_q[2]);
+        dq[7] = -0.5f * (t[0] * q[0] + t[1] * q[1] + t[2] * q[2]);
+    }
+
+    inline float realPartDot(float const* a, float const* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    }
+}
+
+void EngineCore::Animation::detail::transformDualQuaternion(float const* dq, float const* position, float const* normal, float* position_out, float* normal_out)
+{
+    float length_sq = dq[0] * dq[0] + dq[1] * dq[1] + dq[2] * dq[2] + dq[3] * dq[3];
+    float inv_length = length_sq > 0.0f ? 1.0f / std::sqrt(length_sq) : 0.0f;
+
+    float real[3] = { dq[0] * inv_length, dq[1] * inv_length, dq[2] * inv_length };
+    float real_w = dq[3] * inv_length;
+    float dual[3] = { dq[4] * inv_length, dq[5] * inv_length, dq[6] * inv_length };
+    float dual_w = dq[7] * inv_length;
+
+    // rotate: v + 2 * cross(r, cross(r, v) + w * v)
+    auto rotate = [&real, real_w](float const* v, float* result) {
+        float c[3];
+        cross(real, v, c);
+        c[0] += real_w * v[0];
+        c[1] += real_w * v[1];
+        c[2] += real_w * v[2];
+        float cc[3];
+        cross(real, c, cc);
+        result[0] = v[0] + 2.0f * cc[0];
+        result[1] = v[1] + 2.0f * cc[1];
+        result[2] = v[2] + 2.0f * cc[2];
+    };
+
+    // translation: 2 * (w_r * d - w_d * r + cross(r, d))
+    float r_cross_d[3];
+    cross(real, dual, r_cross_d);
+
+    rotate(position, position_out);
+    for (int i = 0; i < 3; ++i) {
+        position_out[i] += 2.0f * (real_w * dual[i] - dual_w * real[i] + r_cross_d[i]);
+    }
+
+    if (normal != nullptr)
+    {
+        rotate(normal, normal_out);
+        normalize3(normal_out);
+    }
+}
+
+EngineCore::Animation::SkinningPalette EngineCore::Animation::createSkinningPalette(
+    std::vector<Mat4x4> const& joint_palette,
+    size_t palette_offset,
+    size_t joint_cnt,
+    SkinningMethod method)
+{
+    SkinningPalette retval;
+    retval.matrices.assign(joint_palette.begin() + palette_offset, joint_palette.begin() + palette_offset + joint_cnt);
+
+    if (method == SkinningMethod::DUAL_QUATERNION)
+    {
+        retval.dual_quaternions.resize(joint_cnt * 8);
+        for (size_t joint = 0; joint < joint_cnt; ++joint) {
+            toDualQuaternion(retval.matrices[joint], retval.dual_quaternions.data() + joint * 8);
+        }
+    }
+
+    return retval;
+}
+
+void EngineCore::Animation::skinVerticesReference(
+    SkinnedMeshData const& mesh,
+    SkinningPalette const& palette,
+    SkinningMethod method,
+    size_t first,
+    size_t last,
+    float* positions,
+    float* normals)
+{
+    bool has_normals = normals != nullptr && !mesh.normals.empty();
+
+    for (size_t v = first; v < last; ++v)
+    {
+        float const* position = mesh.positions.data() + v * 3;
+        float const* normal = has_normals ? mesh.normals.data() + v * 3 : nullptr;
+
+        if (method == SkinningMethod::LINEAR_BLEND)
+        {
+            float blended[16] = {};
+            for (int k = 0; k < 4; ++k)
+            {
+                float weight = mesh.weights[v * 4 + k];
+                float const* m = &palette.matrices[mesh.joints[v * 4 + k]][0][0];
+                for (int i = 0; i < 16; ++i) {
+                    blended[i] += m[i] * weight;
+                }
+            }
+
+            for (int r = 0; r < 3; ++r) {
+                positions[v * 3 + r] = blended[r] * position[0] + blended[4 + r] * position[1] + blended[8 + r] * position[2] + blended[12 + r];
+            }
+
+            if (has_normals)
+            {
+                for (int r = 0; r < 3; ++r) {
+                    normals[v * 3 + r] = blended[r] * normal[0] + blended[4 + r] * normal[1] + blended[8 + r] * normal[2];
+                }
+                normalize3(normals + v * 3);
+            }
+        }
+        else
+        {
+            float const* pivot = palette.dual_quaternions.data() + static_cast<size_t>(mesh.joints[v * 4]) * 8;
+
+            float blended[8] = {};
+            for (int k = 0; k < 4; ++k)
+            {
+                float const* dq = palette.dual_quaternions.data() + static_cast<size_t>(mesh.joints[v * 4 + k]) * 8;
+
+                // blend along the shorter path
+                float weight = mesh.weights[v * 4 + k] * (realPartDot(dq, pivot) < 0.0f ? -1.0f : 1.0f);
+                for (int i = 0; i < 8; ++i) {
+                    blended[i] += dq[i] * weight;
+                }
+            }
+
+            detail::transformDualQuaternion(blended, position, normal, positions + v * 3, has_normals ? normals + v * 3 : nullptr);
+        }
+    }
+}
+
+bool EngineCore::Animation::detail::cpuSupportsAvx2()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // AVX and OSXSAVE, i.e. the OS saves the AVX registers
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 28)) == 0 || (info[2] & (1 << 27)) == 0)
+        return false;
+
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // also checks for OS support
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool EngineCore::Animation::detail::skinVerticesSse2(
+    SkinningStreams const& streams,
+    SkinningMethod method,
+    size_t first,
+    size_t last,
+    float* positions,
+    float* normals)
+{
+#ifdef CPU_SKINNING_SSE2
+    bool has_normals = normals != nullptr && streams.normals != nullptr;
+
+    for (size_t v = first; v < last; ++v)
+    {
+        float const* position = streams.positions + v * 3;
+        float const* normal = has_normals ? streams.normals + v * 3 : nullptr;
+        uint16_t const* joints = streams.joints + v * 4;
+        float const* weights = streams.weights + v * 4;
+
+        if (method == SkinningMethod::LINEAR_BLEND)
+        {
+            float position_out[4];
+            float normal_out[4];
+
+            __m128 c0 = _mm_setzero_ps();
+            __m128 c1 = _mm_setzero_ps();
+            __m128 c2 = _mm_setzero_ps();
+            __m128 c3 = _mm_setzero_ps();
+
+            for (int k = 0; k < 4; ++k)
+            {
+                if (weights[k] == 0.0f)
+                    continue;
+
+                float const* m = streams.matrices + static_cast<size_t>(joints[k]) * 16;
+                __m128 w = _mm_set1_ps(weights[k]);
+                c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m), w));
+                c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4), w));
+                c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8), w));
+                c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+            }
+
+            __m128 p = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(position[0])), _mm_mul_ps(c1, _mm_set1_ps(position[1]))),
+                _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(position[2])), c3));
+            _mm_storeu_ps(position_out, p);
+
+            positions[v * 3 + 0] = position_out[0];
+            positions[v * 3 + 1] = position_out[1];
+            positions[v * 3 + 2] = position_out[2];
+
+            if (has_normals)
+            {
+                __m128 n = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(normal[0])), _mm_mul_ps(c1, _mm_set1_ps(normal[1]))),
+                    _mm_mul_ps(c2, _mm_set1_ps(normal[2])));
+                _mm_storeu_ps(normal_out, n);
+
+                normalize3(normal_out);
+                normals[v * 3 + 0] = normal_out[0];
+                normals[v * 3 + 1] = normal_out[1];
+                normals[v * 3 + 2] = normal_out[2];
+            }
+        }
+        else
+        {
+            float const* pivot = streams.dual_quaternions + static_cast<size_t>(joints[0]) * 8;
+            float blended[8];
+
+            __m128 real = _mm_setzero_ps();
+            __m128 dual = _mm_setzero_ps();
+
+            for (int k = 0; k < 4; ++k)
+            {
+                if (weights[k] == 0.0f)
+                    continue;
+
+                float const* dq = streams.dual_quaternions + static_cast<size_t>(joints[k]) * 8;
+                __m128 w = _mm_set1_ps(realPartDot(dq, pivot) < 0.0f ? -weights[k] : weights[k]);
+                real = _mm_add_ps(real, _mm_mul_ps(_mm_loadu_ps(dq), w));
+                dual = _mm_add_ps(dual, _mm_mul_ps(_mm_loadu_ps(dq + 4), w));
+            }
+
+            _mm_storeu_ps(blended, real);
+            _mm_storeu_ps(blended + 4, dual);
+
+            transformDualQuaternion(blended, position, normal, positions + v * 3, has_normals ? normals + v * 3 : nullptr);
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void EngineCore::Animation::skinVertices(
+    SkinnedMeshData const& mesh,
+    SkinningPalette const& palette,
+    SkinningMethod method,
+    size_t first,
+    size_t last,
+    float* positions,
+    float* normals)
+{
+    static bool const use_avx2 = detail::cpuSupportsAvx2();
+
+    detail::SkinningStreams streams;
+    streams.positions = mesh.positions.data();
+    streams.normals = mesh.normals.empty() ? nullptr : mesh.normals.data();
+    streams.joints = mesh.joints.data();
+    streams.weights = mesh.weights.data();
+    streams.matrices = palette.matrices.empty() ? nullptr : &palette.matrices[0][0][0];
+    streams.dual_quaternions = palette.dual_quaternions.data();
+
+    if (use_avx2 && detail::skinVerticesAvx2(streams, method, first, last, positions, normals))
+        return;
+
+    if (detail::skinVerticesSse2(streams, method, first, last, positions, normals))
+        return;
+
+    skinVerticesReference(mesh, palette, method, first, last, positions, normals);
+}
+
+void EngineCore::Animation::skinMesh(
+    SkinnedMeshData const& mesh,
+    SkinningPalette const& palette,
+    SkinningMethod method,
+    std::vector<float>& positions,
+    std::vector<float>& normals,
+    Utility::TaskScheduler* task_scheduler)
+{
+    positions.resize(mesh.vertex_cnt * 3);
+    normals.resize(mesh.normals.empty() ? 0 : mesh.vertex_cnt * 3);
+
+    float* normals_ptr = normals.empty() ? nullptr : normals.data();
+
+    if (task_scheduler == nullptr)
+    {
+        skinVertices(mesh, palette, method, 0, mesh.vertex_cnt, positions.data(), normals_ptr);
+        return;
+    }
+
+    size_t const vertices_per_task = 4096;
+
+    for (size_t first = 0; first < mesh.vertex_cnt; first += vertices_per_task)
+    {
+        size_t last = std::min(first + vertices_per_task, mesh.vertex_cnt);
+
+        task_scheduler->submitTask(
+            [&mesh, &palette, method, first, last, &positions, normals_ptr]() {
+                skinVertices(mesh, palette, method, first, last, positions.data(), normals_ptr);
+            }
+        );
+    }
+
+    task_scheduler->waitWhileBusy();
+}
+
+void EngineCore::Animation::computeSkinnedBounds(std::vector<float> const& positions, Vec3& bbox_min, Vec3& bbox_max)
+{
+    float lo[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    float hi[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+
+    for (size_t i = 0; i + 2 < positions.size(); i += 3)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            lo[c] = std::min(lo[c], positions[i + c]);
+            hi[c] = std::max(hi[c], positions[i + c]);
+        }
+    }
+
+    bbox_min = Vec3(lo[0], lo[1], lo[2]);
+    bbox_max = Vec3(hi[0], hi[1], hi[2]);
+}
@@ -0,0 +1,147 @@
+#ifndef CpuSkinning_hpp
+#define CpuSkinning_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Animation
+    {
+        /**
+        * \brief CPU copy of the vertex streams of a skinned mesh primitive that are needed for skinning,
+        * i.e. POSITION, NORMAL, JOINTS_0 and WEIGHTS_0 of a glTF primitive.
+        */
+        struct SkinnedMeshData
+        {
+            size_t                vertex_cnt = 0;
+            std::vector<float>    positions; ///< 3 floats per vertex
+            std::vector<float>    normals;   ///< 3 floats per vertex, empty if the mesh has no normals
+            std::vector<uint16_t> joints;    ///< 4 joint indices per vertex, relative to the skin's palette offset
+            std::vector<float>    weights;   ///< 4 weights per vertex
+        };
+
+        enum class SkinningMethod
+        {
+            LINEAR_BLEND,   ///< Blend joint matrices, same as the skinned mesh shader
+            DUAL_QUATERNION ///< Blend rigid joint transformations, avoids volume loss at twisted joints. Joint scale is ignored.
+        };
+
+        /**
+        * \brief Joint palette converted for skinning. Dual quaternions are only computed for DUAL_QUATERNION.
+        */
+        struct SkinningPalette
+        {
+            std::vector<Mat4x4> matrices;
+            std::vector<float>  dual_quaternions; ///< 8 floats per joint: real x,y,z,w, dual x,y,z,w
+        };
+
+        /**
+        * \brief Gather the joint matrices of a skin from the joint palette (see SkinComponentManager::updateJointPalettes)
+        * \param palette_offset Offset of the skin in the joint palette
+        */
+        SkinningPalette createSkinningPalette(
+            std::vector<Mat4x4> const& joint_palette,
+            size_t palette_offset,
+            size_t joint_cnt,
+            SkinningMethod method);
+
+        /**
+        * \brief Skin the vertices in the range [first, last) with the fastest SIMD kernel the CPU supports
+        * (AVX2 or SSE2, scalar otherwise). AVX2 support is detected once at runtime.
+        * \param positions Receives 3 floats per vertex of the mesh, only the range is written
+        * \param normals Receives 3 floats per vertex, ignored if nullptr or the mesh has no normals
+        */
+        void skinVertices(
+            SkinnedMeshData const& mesh,
+            SkinningPalette const& palette,
+            SkinningMethod method,
+            size_t first,
+            size_t last,
+            float* positions,
+            float* normals);
+
+        /**
+        * \brief Straightforward scalar implementation, used as reference for validating the SIMD kernels
+        */
+        void skinVerticesReference(
+            SkinnedMeshData const& mesh,
+            SkinningPalette const& palette,
+            SkinningMethod method,
+            size_t first,
+            size_t last,
+            float* positions,
+            float* normals);
+
+        /**
+        * \brief Skin a whole mesh, split into chunks that are processed in parallel if a task scheduler is given.
+        * \param positions Resized to 3 floats per vertex
+        * \param normals Resized to 3 floats per vertex if the mesh has normals
+        */
+        void skinMesh(
+            SkinnedMeshData const& mesh,
+            SkinningPalette const& palette,
+            SkinningMethod method,
+            std::vector<float>& positions,
+            std::vector<float>& normals,
+            Utility::TaskScheduler* task_scheduler = nullptr);
+
+        /**
+        * \brief Axis aligned bounds of skinned positions, e.g. for baking the bounds of animated meshes
+        */
+        void computeSkinnedBounds(std::vector<float> const& positions, Vec3& bbox_min, Vec3& bbox_max);
+
+        namespace detail
+        {
+            /**
+            * \brief Raw vertex and palette streams for the SIMD kernels. The AVX2 kernel lives in its own
+            * translation unit that is built with AVX2 enabled, so only plain pointers cross that boundary.
+            */
+            struct SkinningStreams
+            {
+                float const*    positions = nullptr;
+                float const*    normals = nullptr;          ///< nullptr if the mesh has no normals
+                uint16_t const* joints = nullptr;
+                float const*    weights = nullptr;
+                float const*    matrices = nullptr;         ///< 16 floats per joint, column-major
+                float const*    dual_quaternions = nullptr; ///< 8 floats per joint
+            };
+
+            /** \brief Whether the CPU and OS support AVX2 */
+            bool cpuSupportsAvx2();
+
+            /**
+            * \brief AVX2 kernel, sums two matrix columns or a whole dual quaternion per register.
+            * Only call if cpuSupportsAvx2 returns true.
+            * \return Returns false without writing anything if the kernel was not built with AVX2 enabled
+            */
+            bool skinVerticesAvx2(
+                SkinningStreams const& streams,
+                SkinningMethod method,
+                size_t first,
+                size_t last,
+                float* positions,
+                float* normals);
+
+            /**
+            * \brief SSE2 kernel
+            * \return Returns false without writing anything if the target doesn't support SSE2
+            */
+            bool skinVerticesSse2(
+                SkinningStreams const& streams,
+                SkinningMethod method,
+                size_t first,
+                size_t last,
+                float* positions,
+                float* normals);
+
+            /** \brief Transform position and normal (may be nullptr) by a blended, not yet normalized dual quaternion */
+            void transformDualQuaternion(float const* dq, float const* position, float const* normal, float* position_out, float* normal_out);
+        }
+    }
+}
+
+#endif // !CpuSkinning_hpp
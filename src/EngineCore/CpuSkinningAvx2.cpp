@@ -0,0 +1,120 @@
+#include "CpuSkinning.hpp"
+
+#include <cmath>
+
+// Built with AVX2 enabled (see CMakeLists.txt), only called after checking cpuSupportsAvx2.
+// Keep this file free of inline functions shared with other translation units, the linker might
+// otherwise pick the AVX2 version of them for the whole engine.
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace
+{
+    inline void normalize3(float* v)
+    {
+        float length_sq = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+        if (length_sq > 0.0f)
+        {
+            float inv_length = 1.0f / std::sqrt(length_sq);
+            v[0] *= inv_length;
+            v[1] *= inv_length;
+            v[2] *= inv_length;
+        }
+    }
+
+    inline float realPartDot(float const* a, float const* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    }
+}
+#endif
+
+bool EngineCore::Animation::detail::skinVerticesAvx2(
+    SkinningStreams const& streams,
+    SkinningMethod method,
+    size_t first,
+    size_t last,
+    float* positions,
+    float* normals)
+{
+#if defined(__AVX2__)
+    bool has_normals = normals != nullptr && streams.normals != nullptr;
+
+    for (size_t v = first; v < last; ++v)
+    {
+        float const* position = streams.positions + v * 3;
+        float const* normal = has_normals ? streams.normals + v * 3 : nullptr;
+        uint16_t const* joints = streams.joints + v * 4;
+        float const* weights = streams.weights + v * 4;
+
+        if (method == SkinningMethod::LINEAR_BLEND)
+        {
+            float position_out[4];
+            float normal_out[4];
+
+            // two matrix columns per register
+            __m256 c01 = _mm256_setzero_ps();
+            __m256 c23 = _mm256_setzero_ps();
+
+            for (int k = 0; k < 4; ++k)
+            {
+                if (weights[k] == 0.0f)
+                    continue;
+
+                float const* m = streams.matrices + static_cast<size_t>(joints[k]) * 16;
+                __m256 w = _mm256_set1_ps(weights[k]);
+                c01 = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_loadu_ps(m), w));
+                c23 = _mm256_add_ps(c23, _mm256_mul_ps(_mm256_loadu_ps(m + 8), w));
+            }
+
+            __m256 p = _mm256_add_ps(
+                _mm256_mul_ps(c01, _mm256_setr_ps(position[0], position[0], position[0], position[0], position[1], position[1], position[1], position[1])),
+                _mm256_mul_ps(c23, _mm256_setr_ps(position[2], position[2], position[2], position[2], 1.0f, 1.0f, 1.0f, 1.0f)));
+            _mm_storeu_ps(position_out, _mm_add_ps(_mm256_castps256_ps128(p), _mm256_extractf128_ps(p, 1)));
+
+            positions[v * 3 + 0] = position_out[0];
+            positions[v * 3 + 1] = position_out[1];
+            positions[v * 3 + 2] = position_out[2];
+
+            if (has_normals)
+            {
+                __m256 n = _mm256_add_ps(
+                    _mm256_mul_ps(c01, _mm256_setr_ps(normal[0], normal[0], normal[0], normal[0], normal[1], normal[1], normal[1], normal[1])),
+                    _mm256_mul_ps(c23, _mm256_setr_ps(normal[2], normal[2], normal[2], normal[2], 0.0f, 0.0f, 0.0f, 0.0f)));
+                _mm_storeu_ps(normal_out, _mm_add_ps(_mm256_castps256_ps128(n), _mm256_extractf128_ps(n, 1)));
+
+                normalize3(normal_out);
+                normals[v * 3 + 0] = normal_out[0];
+                normals[v * 3 + 1] = normal_out[1];
+                normals[v * 3 + 2] = normal_out[2];
+            }
+        }
+        else
+        {
+            float const* pivot = streams.dual_quaternions + static_cast<size_t>(joints[0]) * 8;
+            float blended[8];
+
+            // one dual quaternion per register
+            __m256 b = _mm256_setzero_ps();
+
+            for (int k = 0; k < 4; ++k)
+            {
+                if (weights[k] == 0.0f)
+                    continue;
+
+                float const* dq = streams.dual_quaternions + static_cast<size_t>(joints[k]) * 8;
+                float weight = realPartDot(dq, pivot) < 0.0f ? -weights[k] : weights[k];
+                b = _mm256_add_ps(b, _mm256_mul_ps(_mm256_loadu_ps(dq), _mm256_set1_ps(weight)));
+            }
+
+            _mm256_storeu_ps(blended, b);
+
+            transformDualQuaternion(blended, position, normal, positions + v * 3, has_normals ? normals + v * 3 : nullptr);
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
@@ -43,7 +43,16 @@ void DecalComponentManager::addComponent(Entity entity, const std::string& mater
 		image_layout.int_parameters.push_back({ GL_TEXTURE_WRAP_R,GL_CLAMP_TO_BORDER });
 		image_layout.int_parameters.push_back({ GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR });
 		image_layout.int_parameters.push_back({ GL_TEXTURE_MAG_FILTER,GL_LINEAR });
-		ResourceLoading::loadPngImage(decal_texture_filepaths[i], image_data, image_layout);
+		try
+		{
+			ResourceLoading::loadPngImage(decal_texture_filepaths[i], image_data, image_layout);
+		}
+		catch (std::runtime_error const& e)
+		{
+			// the decal is kept with an invalid texture
+			std::cerr << "Exception DecalComponentManager::addComponent \"" << decal_texture_filepaths[i] << "\" : " << e.what() << std::endl;
+			continue;
+		}
 		decal_textures[i] = GEngineCore::resourceManager().createTexture2D(decal_texture_filepaths[i], image_layout, image_data.data(),true).id;
 	}
 
@@ -168,7 +177,16 @@ void DecalComponentManager::updateComponent(uint eID, const std::string& materia
 		image_layout.int_parameters.push_back({ GL_TEXTURE_WRAP_R,GL_CLAMP_TO_BORDER });
 		image_layout.int_parameters.push_back({ GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR });
 		image_layout.int_parameters.push_back({ GL_TEXTURE_MAG_FILTER,GL_LINEAR });
-		ResourceLoading::loadPngImage(decal_texture_filepaths[i], image_data, image_layout);
+		try
+		{
+			ResourceLoading::loadPngImage(decal_texture_filepaths[i], image_data, image_layout);
+		}
+		catch (std::runtime_error const& e)
+		{
+			// the decal is kept with an invalid texture
+			std::cerr << "Exception DecalComponentManager::updateComponent \"" << decal_texture_filepaths[i] << "\" : " << e.what() << std::endl;
+			continue;
+		}
 		decal_textures[i] = GEngineCore::resourceManager().createTexture2D(decal_texture_filepaths[i], image_layout, image_data.data(),true).id;
 	}
 
@@ -1,5 +1,6 @@
 #include "EntityManager.hpp"
 
+#include <algorithm>
 #include <shared_mutex>
 
 Entity EntityManager::create()
@@ -30,6 +31,32 @@ Entity EntityManager::create()
     return new_entity;
 }
 
+std::vector<Entity> EntityManager::create(size_t entity_cnt)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    std::vector<Entity> new_entities(entity_cnt);
+
+    m_is_alive.reserve(std::min<size_t>(m_is_alive.size() + entity_cnt, MAX_ENTITY_ID));
+
+    for (auto& new_entity : new_entities)
+    {
+        if ((m_is_alive.size()) < MAX_ENTITY_ID)
+        {
+            m_is_alive.push_back(true);
+            new_entity.m_id = static_cast<uint>(m_is_alive.size()) - 1;
+        }
+        else if (!m_free_indices.empty())
+        {
+            new_entity.m_id = m_free_indices.front();
+            m_free_indices.pop_front();
+            m_is_alive[new_entity.m_id] = true;
+        }
+    }
+
+    return new_entities;
+}
+
 void EntityManager::destroy(Entity entity)
 {
     std::unique_lock<std::shared_mutex> lock(m_mutex);
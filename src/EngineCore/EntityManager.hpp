@@ -52,6 +52,11 @@ class EntityManager
 public:
     Entity create();
 
+    /**
+     * Create multiple entities at once, taking the lock only once.
+     */
+    std::vector<Entity> create(size_t entity_cnt);
+
     void destroy(Entity entity);
 
     size_t getEntityCount() const;
@@ -67,7 +67,12 @@ struct GenericTextureLayout
         RGBA16I,
         RGBA16UI,
         RGBA32I,
-        RGBA32UI
+        RGBA32UI,
+        BC1_RGBA,
+        BC3_RGBA,
+        BC4_R,
+        BC5_RG,
+        BC7_RGBA
     };
 
     GenericTextureLayout()
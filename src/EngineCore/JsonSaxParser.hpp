@@ -0,0 +1,370 @@
+#ifndef JsonSaxParser_hpp
+#define JsonSaxParser_hpp
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+        struct JsonParseResult
+        {
+            bool        success;
+            size_t      offset;  ///< Position in the input where parsing stopped
+            std::string message; ///< Error description if parsing failed
+        };
+
+        /**
+        * \brief Streaming (SAX-style) JSON parser. The input is parsed in a single pass without building a document tree,
+        * every token is reported to the given handler.
+        *
+        * The handler has to provide the following methods, each returning false to stop parsing:
+        * onObjectBegin(), onObjectEnd(), onArrayBegin(), onArrayEnd(), onKey(std::string_view), onString(std::string_view),
+        * onNumber(double), onBool(bool) and onNull().
+        * String views passed to the handler are only valid during the call.
+        *
+        * \param data Pointer to the JSON text, doesn't need to be null terminated
+        * \param size Length of the JSON text in bytes
+        * \param handler Receiver of parsing events
+        */
+        template<typename Handler>
+        JsonParseResult parseJson(char const* data, size_t size, Handler& handler);
+
+        namespace detail
+        {
+            inline bool isJsonWhitespace(char c)
+            {
+                return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+            }
+
+            inline void appendUtf8(std::string& str, uint32_t code_point)
+            {
+                if (code_point < 0x80) {
+                    str += static_cast<char>(code_point);
+                }
+                else if (code_point < 0x800) {
+                    str += static_cast<char>(0xC0 | (code_point >> 6));
+                    str += static_cast<char>(0x80 | (code_point & 0x3F));
+                }
+                else if (code_point < 0x10000) {
+                    str += static_cast<char>(0xE0 | (code_point >> 12));
+                    str += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                    str += static_cast<char>(0x80 | (code_point & 0x3F));
+                }
+                else {
+                    str += static_cast<char>(0xF0 | (code_point >> 18));
+                    str += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                    str += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                    str += static_cast<char>(0x80 | (code_point & 0x3F));
+                }
+            }
+
+            inline bool parseHex4(char const* data, uint32_t& value)
+            {
+                value = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    char c = data[i];
+                    value <<= 4;
+                    if (c >= '0' && c <= '9') value |= c - '0';
+                    else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+                    else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+                    else return false;
+                }
+                return true;
+            }
+
+            /**
+            * Parse a string starting at the opening quote. Strings without escape sequences are returned as view
+            * into the input, others are decoded into the scratch buffer.
+            */
+            inline bool parseString(char const* data, size_t size, size_t& pos, std::string& scratch, std::string_view& str)
+            {
+                size_t begin = ++pos;
+
+                // fast path, no escape sequences
+                while (pos < size && data[pos] != '"' && data[pos] != '\\')
+                {
+                    if (static_cast<unsigned char>(data[pos]) < 0x20)
+                        return false;
+                    ++pos;
+                }
+
+                if (pos >= size)
+                    return false;
+
+                if (data[pos] == '"')
+                {
+                    str = std::string_view(data + begin, pos - begin);
+                    ++pos;
+                    return true;
+                }
+
+                scratch.assign(data + begin, pos - begin);
+
+                while (pos < size && data[pos] != '"')
+                {
+                    char c = data[pos];
+
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        return false;
+
+                    if (c != '\\')
+                    {
+                        scratch += c;
+                        ++pos;
+                        continue;
+                    }
+
+                    if (++pos >= size)
+                        return false;
+
+                    switch (data[pos])
+                    {
+                    case '"': scratch += '"'; break;
+                    case '\\': scratch += '\\'; break;
+                    case '/': scratch += '/'; break;
+                    case 'b': scratch += '\b'; break;
+                    case 'f': scratch += '\f'; break;
+                    case 'n': scratch += '\n'; break;
+                    case 'r': scratch += '\r'; break;
+                    case 't': scratch += '\t'; break;
+                    case 'u':
+                    {
+                        uint32_t code_point;
+                        if (pos + 4 >= size || !parseHex4(data + pos + 1, code_point))
+                            return false;
+                        pos += 4;
+
+                        // surrogate pair
+                        if (code_point >= 0xD800 && code_point < 0xDC00)
+                        {
+                            uint32_t low;
+                            if (pos + 6 >= size || data[pos + 1] != '\\' || data[pos + 2] != 'u' || !parseHex4(data + pos + 3, low)
+                                || low < 0xDC00 || low >= 0xE000)
+                                return false;
+                            pos += 6;
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        }
+
+                        appendUtf8(scratch, code_point);
+                        break;
+                    }
+                    default:
+                        return false;
+                    }
+
+                    ++pos;
+                }
+
+                if (pos >= size)
+                    return false;
+
+                str = std::string_view(scratch);
+                ++pos;
+                return true;
+            }
+
+            inline bool parseNumber(char const* data, size_t size, size_t& pos, double& value)
+            {
+                // validate JSON number grammar, from_chars alone would also accept e.g. "inf" or leading zeros
+                size_t begin = pos;
+                if (pos < size && data[pos] == '-') ++pos;
+
+                if (pos >= size)
+                    return false;
+
+                if (data[pos] == '0') {
+                    ++pos;
+                }
+                else if (data[pos] >= '1' && data[pos] <= '9') {
+                    while (pos < size && data[pos] >= '0' && data[pos] <= '9') ++pos;
+                }
+                else {
+                    return false;
+                }
+
+                if (pos < size && data[pos] == '.')
+                {
+                    ++pos;
+                    if (pos >= size || data[pos] < '0' || data[pos] > '9')
+                        return false;
+                    while (pos < size && data[pos] >= '0' && data[pos] <= '9') ++pos;
+                }
+
+                if (pos < size && (data[pos] == 'e' || data[pos] == 'E'))
+                {
+                    ++pos;
+                    if (pos < size && (data[pos] == '+' || data[pos] == '-')) ++pos;
+                    if (pos >= size || data[pos] < '0' || data[pos] > '9')
+                        return false;
+                    while (pos < size && data[pos] >= '0' && data[pos] <= '9') ++pos;
+                }
+
+                auto result = std::from_chars(data + begin, data + pos, value);
+                return result.ec == std::errc() || result.ec == std::errc::result_out_of_range;
+            }
+
+            inline bool matchLiteral(char const* data, size_t size, size_t& pos, std::string_view literal)
+            {
+                if (size - pos < literal.size() || std::string_view(data + pos, literal.size()) != literal)
+                    return false;
+                pos += literal.size();
+                return true;
+            }
+        }
+
+        template<typename Handler>
+        inline JsonParseResult parseJson(char const* data, size_t size, Handler& handler)
+        {
+            enum class Expect { VALUE, VALUE_OR_ARRAY_END, KEY, KEY_OR_OBJECT_END, SEPARATOR_OR_END, DOCUMENT_END };
+
+            std::vector<char> containers; // '{' or '[' for each open container
+            std::string       scratch;
+            std::string_view  str;
+
+            Expect expect = Expect::VALUE;
+            size_t pos = 0;
+
+            auto fail = [&pos](char const* message) {
+                return JsonParseResult{ false, pos, message };
+            };
+
+            auto abort = [&pos]() {
+                return JsonParseResult{ false, pos, "Parsing stopped by handler" };
+            };
+
+            for (;;)
+            {
+                while (pos < size && detail::isJsonWhitespace(data[pos])) ++pos;
+
+                if (pos >= size)
+                {
+                    if (expect == Expect::DOCUMENT_END)
+                        return JsonParseResult{ true, pos, "" };
+                    return fail("Unexpected end of input");
+                }
+
+                char c = data[pos];
+                bool value_completed = false;
+
+                switch (expect)
+                {
+                case Expect::VALUE_OR_ARRAY_END:
+                    if (c == ']')
+                    {
+                        ++pos;
+                        containers.pop_back();
+                        if (!handler.onArrayEnd()) return abort();
+                        value_completed = true;
+                        break;
+                    }
+                    [[fallthrough]];
+                case Expect::VALUE:
+                    switch (c)
+                    {
+                    case '{':
+                        ++pos;
+                        containers.push_back('{');
+                        if (!handler.onObjectBegin()) return abort();
+                        expect = Expect::KEY_OR_OBJECT_END;
+                        break;
+                    case '[':
+                        ++pos;
+                        containers.push_back('[');
+                        if (!handler.onArrayBegin()) return abort();
+                        expect = Expect::VALUE_OR_ARRAY_END;
+                        break;
+                    case '"':
+                        if (!detail::parseString(data, size, pos, scratch, str)) return fail("Invalid string");
+                        if (!handler.onString(str)) return abort();
+                        value_completed = true;
+                        break;
+                    case 't':
+                        if (!detail::matchLiteral(data, size, pos, "true")) return fail("Invalid literal");
+                        if (!handler.onBool(true)) return abort();
+                        value_completed = true;
+                        break;
+                    case 'f':
+                        if (!detail::matchLiteral(data, size, pos, "false")) return fail("Invalid literal");
+                        if (!handler.onBool(false)) return abort();
+                        value_completed = true;
+                        break;
+                    case 'n':
+                        if (!detail::matchLiteral(data, size, pos, "null")) return fail("Invalid literal");
+                        if (!handler.onNull()) return abort();
+                        value_completed = true;
+                        break;
+                    default:
+                    {
+                        double value;
+                        if (!detail::parseNumber(data, size, pos, value)) return fail("Invalid value");
+                        if (!handler.onNumber(value)) return abort();
+                        value_completed = true;
+                        break;
+                    }
+                    }
+                    break;
+                case Expect::KEY_OR_OBJECT_END:
+                    if (c == '}')
+                    {
+                        ++pos;
+                        containers.pop_back();
+                        if (!handler.onObjectEnd()) return abort();
+                        value_completed = true;
+                        break;
+                    }
+                    [[fallthrough]];
+                case Expect::KEY:
+                    if (c != '"') return fail("Expected key");
+                    if (!detail::parseString(data, size, pos, scratch, str)) return fail("Invalid key");
+                    if (!handler.onKey(str)) return abort();
+
+                    while (pos < size && detail::isJsonWhitespace(data[pos])) ++pos;
+                    if (pos >= size || data[pos] != ':') return fail("Expected ':'");
+                    ++pos;
+
+                    expect = Expect::VALUE;
+                    break;
+                case Expect::SEPARATOR_OR_END:
+                    if (c == ',')
+                    {
+                        ++pos;
+                        expect = containers.back() == '{' ? Expect::KEY : Expect::VALUE;
+                    }
+                    else if (c == '}' && containers.back() == '{')
+                    {
+                        ++pos;
+                        containers.pop_back();
+                        if (!handler.onObjectEnd()) return abort();
+                        value_completed = true;
+                    }
+                    else if (c == ']' && containers.back() == '[')
+                    {
+                        ++pos;
+                        containers.pop_back();
+                        if (!handler.onArrayEnd()) return abort();
+                        value_completed = true;
+                    }
+                    else
+                    {
+                        return fail("Expected ',' or end of container");
+                    }
+                    break;
+                case Expect::DOCUMENT_END:
+                    return fail("Unexpected characters after document");
+                }
+
+                if (value_completed) {
+                    expect = containers.empty() ? Expect::DOCUMENT_END : Expect::SEPARATOR_OR_END;
+                }
+            }
+        }
+    }
+}
+
+#endif // !JsonSaxParser_hpp
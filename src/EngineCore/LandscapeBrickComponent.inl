@@ -34,9 +34,20 @@ inline EngineCore::Graphics::Landscape::LandscapeBrickComponentManager<ResourceM
             transformFeedback_terrainOutput_prgm = new GLSLProgram();
             transformFeedback_terrainOutput_prgm->init();
 
-            std::string vertex_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_v.glsl");
-            std::string tessellationControl_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_tc.glsl");
-            std::string tessellationEvaluation_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_te.glsl");
+            std::string vertex_src;
+            std::string tessellationControl_src;
+            std::string tessellationEvaluation_src;
+            try
+            {
+                vertex_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_v.glsl");
+                tessellationControl_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_tc.glsl");
+                tessellationEvaluation_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_te.glsl");
+            }
+            catch (std::runtime_error const& e)
+            {
+                // shader stages that could not be read stay empty and are skipped below
+                std::cerr << "Exception reading transform feedback shaders : " << e.what() << std::endl;
+            }
 
             transformFeedback_terrainOutput_prgm->bindAttribLocation(0, "vPosition");
             transformFeedback_terrainOutput_prgm->bindAttribLocation(1, "vNormal");
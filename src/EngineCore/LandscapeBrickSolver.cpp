@@ -0,0 +1,2011 @@
+#include "LandscapeBrickSolver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+#include "SimdFloat.hpp"
+
+namespace
+{
+    namespace Simd = EngineCore::Utility::Simd;
+
+    using EngineCore::Graphics::Landscape::BrickField;
+    using EngineCore::Graphics::Landscape::LandscapeBrickFields;
+
+    /** Tasks process z-slabs of about this many voxels */
+    constexpr uint voxels_per_task = 8192;
+
+    /** Rows are padded to a multiple of this, covers all SIMD widths */
+    constexpr uint row_alignment = 8;
+
+    constexpr int halo_width = BrickField::halo_width;
+
+    enum FieldId
+    {
+        NORMAL_X,
+        NORMAL_Y,
+        NORMAL_Z,
+        NOISE_AMPLITUDE,
+        NOISE_ROUGHNESS,
+        SURFACE,
+        BOUNDARY_REGION
+    };
+
+    /** Halo values at the border of the landscape, either the border values of the brick or zero */
+    enum class HaloMode { CLAMP, ZERO };
+
+    BrickField& getField(LandscapeBrickFields& brick, FieldId id)
+    {
+        switch (id)
+        {
+        case NORMAL_X: return brick.normals[0];
+        case NORMAL_Y: return brick.normals[1];
+        case NORMAL_Z: return brick.normals[2];
+        case NOISE_AMPLITUDE: return brick.noise[0];
+        case NOISE_ROUGHNESS: return brick.noise[1];
+        case SURFACE: return brick.surface;
+        default: return brick.boundary_region;
+        }
+    }
+
+    /** Returns nullptr at the border of the landscape and for neighbours whose shared face doesn't match */
+    LandscapeBrickFields* getNeighbour(LandscapeBrickFields const& brick, int direction)
+    {
+        LandscapeBrickFields* neighbour = brick.neighbours[direction];
+
+        if (neighbour == nullptr || neighbour == &brick)
+            return nullptr;
+
+        bool matches = false;
+        switch (direction)
+        {
+        case LandscapeBrickFields::EAST:
+        case LandscapeBrickFields::WEST:
+            matches = neighbour->res_y == brick.res_y && neighbour->res_z == brick.res_z && neighbour->res_x > halo_width;
+            break;
+        case LandscapeBrickFields::DOWN:
+        case LandscapeBrickFields::UP:
+            matches = neighbour->res_x == brick.res_x && neighbour->res_z == brick.res_z && neighbour->res_y > halo_width;
+            break;
+        default:
+            matches = neighbour->res_x == brick.res_x && neighbour->res_y == brick.res_y && neighbour->res_z > halo_width;
+            break;
+        }
+
+        return matches ? neighbour : nullptr;
+    }
+
+    /** Halo sources of a field, the mode is used for directions without a neighbouring field */
+    struct HaloLinks
+    {
+        BrickField const* neighbours[LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT] = {};
+        HaloMode          modes[LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT] = {};
+    };
+
+    /** Copy the boundary values of the neighbours into the halo, skipping the shared voxel layer */
+    void fillHalo(BrickField& field, HaloLinks const& links)
+    {
+        int res_x = static_cast<int>(field.getResX());
+        int res_y = static_cast<int>(field.getResY());
+        int res_z = static_cast<int>(field.getResZ());
+
+        for (int direction = 0; direction < LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT; ++direction)
+        {
+            BrickField const* neighbour_field = links.neighbours[direction];
+            HaloMode mode = links.modes[direction];
+
+            // maps a halo voxel to the voxel of the neighbour or to the border voxel of the brick
+            auto fill = [&](int x, int y, int z, int nx, int ny, int nz, int bx, int by, int bz) {
+                if (neighbour_field != nullptr) {
+                    field(x, y, z) = (*neighbour_field)(nx, ny, nz);
+                }
+                else {
+                    field(x, y, z) = mode == HaloMode::CLAMP ? field(bx, by, bz) : 0.0f;
+                }
+            };
+
+            // same for complete rows of voxels
+            auto fillRow = [&](int y, int z, int ny, int nz, int by, int bz) {
+                float* dst = field.data() + field.index(0, y, z);
+                if (neighbour_field != nullptr) {
+                    std::copy_n(neighbour_field->data() + neighbour_field->index(0, ny, nz), res_x, dst);
+                }
+                else if (mode == HaloMode::CLAMP) {
+                    std::copy_n(field.data() + field.index(0, by, bz), res_x, dst);
+                }
+                else {
+                    std::fill_n(dst, res_x, 0.0f);
+                }
+            };
+
+            for (int k = 1; k <= halo_width; ++k)
+            {
+                switch (direction)
+                {
+                case LandscapeBrickFields::EAST:
+                    for (int z = 0; z < res_z; ++z)
+                        for (int y = 0; y < res_y; ++y)
+                            fill(res_x - 1 + k, y, z, k, y, z, res_x - 1, y, z);
+                    break;
+                case LandscapeBrickFields::WEST:
+                    for (int z = 0; z < res_z; ++z)
+                        for (int y = 0; y < res_y; ++y)
+                            fill(-k, y, z, neighbour_field != nullptr ? static_cast<int>(neighbour_field->getResX()) - 1 - k : 0, y, z, 0, y, z);
+                    break;
+                case LandscapeBrickFields::UP:
+                    for (int z = 0; z < res_z; ++z)
+                        fillRow(res_y - 1 + k, z, k, z, res_y - 1, z);
+                    break;
+                case LandscapeBrickFields::DOWN:
+                    for (int z = 0; z < res_z; ++z)
+                        fillRow(-k, z, neighbour_field != nullptr ? static_cast<int>(neighbour_field->getResY()) - 1 - k : 0, z, 0, z);
+                    break;
+                case LandscapeBrickFields::NORTH:
+                    for (int y = 0; y < res_y; ++y)
+                        fillRow(y, res_z - 1 + k, y, k, y, res_z - 1);
+                    break;
+                case LandscapeBrickFields::SOUTH:
+                    for (int y = 0; y < res_y; ++y)
+                        fillRow(y, -k, y, neighbour_field != nullptr ? static_cast<int>(neighbour_field->getResZ()) - 1 - k : 0, y, 0);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+
+    void fillHalo(LandscapeBrickFields& brick, FieldId id, HaloMode mode)
+    {
+        HaloLinks links;
+        for (int direction = 0; direction < LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT; ++direction)
+        {
+            LandscapeBrickFields* neighbour = getNeighbour(brick, direction);
+            links.neighbours[direction] = neighbour != nullptr ? &getField(*neighbour, id) : nullptr;
+            links.modes[direction] = mode;
+        }
+
+        fillHalo(getField(brick, id), links);
+    }
+
+    uint computeSlabSize(BrickField const& field)
+    {
+        return std::max(voxels_per_task / std::max(field.getResX() * field.getResY(), 1u), 1u);
+    }
+
+    uint computeSlabCount(BrickField const& field)
+    {
+        uint slab_size = computeSlabSize(field);
+        return (field.getResZ() + slab_size - 1) / slab_size;
+    }
+
+    /** Run the kernel on z-slabs of all bricks in parallel and wait for completion, getField returns any field of a brick */
+    template<typename GetField, typename Kernel>
+    void forEachSlab(size_t brick_cnt, GetField const& get_field, Kernel const& kernel, EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        for (size_t brick_idx = 0; brick_idx < brick_cnt; ++brick_idx)
+        {
+            BrickField const& field = get_field(brick_idx);
+            uint res_z = field.getResZ();
+            uint slab_size = computeSlabSize(field);
+
+            for (uint first = 0; first < res_z; first += slab_size)
+            {
+                uint last = std::min(first + slab_size, res_z);
+
+                task_scheduler.submitTask([&kernel, brick_idx, first, last]() {
+                    kernel(brick_idx, first, last);
+                });
+            }
+        }
+
+        task_scheduler.waitWhileBusy();
+    }
+
+    /**
+    * One lockstep step over all bricks: fill the halos of the input fields, run the kernel on z-slabs and swap the
+    * written scratch fields with the brick fields. The kernel writes scratch[brick_idx][i] for output field i.
+    */
+    template<typename Kernel>
+    void runStep(
+        std::vector<LandscapeBrickFields*> const& bricks,
+        std::vector<std::pair<FieldId, HaloMode>> const& inputs,
+        std::vector<FieldId> const& outputs,
+        std::vector<std::vector<BrickField>>& scratch,
+        Kernel const& kernel,
+        EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        for (auto brick : bricks)
+        {
+            task_scheduler.submitTask([brick, &inputs]() {
+                for (auto const& input : inputs) {
+                    fillHalo(*brick, input.first, input.second);
+                }
+            });
+        }
+
+        task_scheduler.waitWhileBusy();
+
+        forEachSlab(
+            bricks.size(),
+            [&bricks](size_t brick_idx) -> BrickField const& { return bricks[brick_idx]->surface; },
+            [&kernel, &bricks, &scratch](size_t brick_idx, uint first, uint last) {
+                kernel(*bricks[brick_idx], scratch[brick_idx], first, last);
+            },
+            task_scheduler);
+
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                std::swap(getField(*bricks[brick_idx], outputs[i]), scratch[brick_idx][i]);
+            }
+        }
+    }
+
+    std::vector<std::vector<BrickField>> createScratch(std::vector<LandscapeBrickFields*> const& bricks, size_t field_cnt)
+    {
+        std::vector<std::vector<BrickField>> scratch(bricks.size());
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            auto const* brick = bricks[brick_idx];
+            scratch[brick_idx].assign(field_cnt, BrickField(brick->res_x, brick->res_y, brick->res_z));
+        }
+        return scratch;
+    }
+
+    /**
+    * Jacobi step of the constrained Laplace equation for consecutive fields, constrained voxels keep their value.
+    * Rows are processed in full SIMD vectors, the padding of the rows absorbs the remainder.
+    */
+    void diffuseSlab(
+        LandscapeBrickFields& brick,
+        FieldId first_field,
+        size_t field_cnt,
+        BrickField const& weights,
+        std::vector<BrickField>& tgt,
+        uint first_slice,
+        uint last_slice)
+    {
+        size_t const row_pitch = weights.getRowPitch();
+        size_t const slice_pitch = weights.getSlicePitch();
+
+        Simd::FloatN const zero = Simd::splat(0.0f);
+        Simd::FloatN const sixth = Simd::splat(1.0f / 6.0f);
+
+        float const* w = weights.data();
+
+        for (uint z = first_slice; z < last_slice; ++z)
+        {
+            for (uint y = 0; y < brick.res_y; ++y)
+            {
+                size_t row = weights.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                // all fields of a row while its weights are in cache
+                for (size_t field = 0; field < field_cnt; ++field)
+                {
+                    float const* src = getField(brick, static_cast<FieldId>(first_field + field)).data();
+                    float* dst = tgt[field].data();
+
+                    for (uint x = 0; x < brick.res_x; x += static_cast<uint>(Simd::width))
+                    {
+                        size_t i = row + x;
+
+                        Simd::FloatN sum = Simd::load(src + i + 1) + Simd::load(src + i - 1);
+                        sum = sum + Simd::load(src + i + row_pitch);
+                        sum = sum + Simd::load(src + i - row_pitch);
+                        sum = sum + Simd::load(src + i + slice_pitch);
+                        sum = sum + Simd::load(src + i - slice_pitch);
+
+                        Simd::FloatN constrained = Simd::load(w + i) > zero;
+                        Simd::store(dst + i, Simd::select(constrained, Simd::load(src + i), sum * sixth));
+                    }
+                }
+            }
+        }
+    }
+
+    void diffuse(
+        std::vector<LandscapeBrickFields*> const& bricks,
+        FieldId first_field,
+        size_t field_cnt,
+        BrickField LandscapeBrickFields::* weights,
+        uint iterations,
+        EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        std::vector<std::pair<FieldId, HaloMode>> inputs;
+        std::vector<FieldId> outputs;
+        for (size_t field = 0; field < field_cnt; ++field)
+        {
+            inputs.push_back({ static_cast<FieldId>(first_field + field), HaloMode::CLAMP });
+            outputs.push_back(static_cast<FieldId>(first_field + field));
+        }
+
+        auto scratch = createScratch(bricks, field_cnt);
+
+        auto kernel = [first_field, field_cnt, weights](LandscapeBrickFields& brick, std::vector<BrickField>& tgt, uint first_slice, uint last_slice) {
+            diffuseSlab(brick, first_field, field_cnt, brick.*weights, tgt, first_slice, last_slice);
+        };
+
+        for (uint i = 0; i < iterations; ++i) {
+            runStep(bricks, inputs, outputs, scratch, kernel, task_scheduler);
+        }
+    }
+
+    /**
+    * Distance estimate from each neighbour in the boundary region, offset by the projection of the neighbour
+    * direction on the guidance normal. Voxels with a neighbour in the boundary region join the region. Once the
+    * region covers the brick, the iteration converges to the solution of laplace(surface) = div(normals).
+    */
+    void propagateSlab(LandscapeBrickFields& brick, std::vector<BrickField>& tgt, uint first_slice, uint last_slice)
+    {
+        size_t const row_pitch = brick.surface.getRowPitch();
+        size_t const slice_pitch = brick.surface.getSlicePitch();
+
+        Simd::FloatN const zero = Simd::splat(0.0f);
+        Simd::FloatN const one = Simd::splat(1.0f);
+        Simd::FloatN const half_cell_x = Simd::splat(0.5f * brick.dimensions.x / static_cast<float>(brick.res_x));
+        Simd::FloatN const half_cell_y = Simd::splat(0.5f * brick.dimensions.y / static_cast<float>(brick.res_y));
+        Simd::FloatN const half_cell_z = Simd::splat(0.5f * brick.dimensions.z / static_cast<float>(brick.res_z));
+
+        float const* surface = brick.surface.data();
+        float const* region = brick.boundary_region.data();
+        float const* weights = brick.surface_weights.data();
+        float const* normal_x = brick.normals[0].data();
+        float const* normal_y = brick.normals[1].data();
+        float const* normal_z = brick.normals[2].data();
+
+        float* surface_tgt = tgt[0].data();
+        float* region_tgt = tgt[1].data();
+
+        for (uint z = first_slice; z < last_slice; ++z)
+        {
+            for (uint y = 0; y < brick.res_y; ++y)
+            {
+                size_t row = brick.surface.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                for (uint x = 0; x < brick.res_x; x += static_cast<uint>(Simd::width))
+                {
+                    size_t i = row + x;
+
+                    // offsets use the normal at the midpoint between the voxels
+                    Simd::FloatN n_x = Simd::load(normal_x + i);
+                    Simd::FloatN n_y = Simd::load(normal_y + i);
+                    Simd::FloatN n_z = Simd::load(normal_z + i);
+
+                    Simd::FloatN offset_e = half_cell_x * (n_x + Simd::load(normal_x + i + 1));
+                    Simd::FloatN offset_w = half_cell_x * (n_x + Simd::load(normal_x + i - 1));
+                    Simd::FloatN offset_u = half_cell_y * (n_y + Simd::load(normal_y + i + row_pitch));
+                    Simd::FloatN offset_d = half_cell_y * (n_y + Simd::load(normal_y + i - row_pitch));
+                    Simd::FloatN offset_n = half_cell_z * (n_z + Simd::load(normal_z + i + slice_pitch));
+                    Simd::FloatN offset_s = half_cell_z * (n_z + Simd::load(normal_z + i - slice_pitch));
+
+                    Simd::FloatN region_e = Simd::load(region + i + 1);
+                    Simd::FloatN region_w = Simd::load(region + i - 1);
+                    Simd::FloatN region_u = Simd::load(region + i + row_pitch);
+                    Simd::FloatN region_d = Simd::load(region + i - row_pitch);
+                    Simd::FloatN region_n = Simd::load(region + i + slice_pitch);
+                    Simd::FloatN region_s = Simd::load(region + i - slice_pitch);
+
+                    Simd::FloatN sum = region_e * (Simd::load(surface + i + 1) - offset_e);
+                    sum = sum + region_w * (Simd::load(surface + i - 1) + offset_w);
+                    sum = sum + region_u * (Simd::load(surface + i + row_pitch) - offset_u);
+                    sum = sum + region_d * (Simd::load(surface + i - row_pitch) + offset_d);
+                    sum = sum + region_n * (Simd::load(surface + i + slice_pitch) - offset_n);
+                    sum = sum + region_s * (Simd::load(surface + i - slice_pitch) + offset_s);
+
+                    Simd::FloatN cnt = region_e + region_w + region_u + region_d + region_n + region_s;
+                    Simd::FloatN reached = cnt > zero;
+                    Simd::FloatN estimate = sum / Simd::vmax(cnt, one);
+
+                    Simd::FloatN constrained = Simd::load(weights + i) > zero;
+                    Simd::FloatN value = Simd::load(surface + i);
+
+                    Simd::store(surface_tgt + i, Simd::select(constrained, value, Simd::select(reached, estimate, value)));
+                    Simd::store(region_tgt + i, Simd::select(constrained | reached, one, Simd::load(region + i)));
+                }
+            }
+        }
+    }
+
+    /** One pass of the separable gaussian along the axis with the given stride */
+    void smoothSlab(
+        LandscapeBrickFields& brick,
+        std::vector<BrickField>& tgt,
+        size_t stride,
+        float const (&kernel_weights)[3],
+        uint first_slice,
+        uint last_slice)
+    {
+        Simd::FloatN const k_0 = Simd::splat(kernel_weights[0]);
+        Simd::FloatN const k_1 = Simd::splat(kernel_weights[1]);
+        Simd::FloatN const k_2 = Simd::splat(kernel_weights[2]);
+
+        float const* src = brick.surface.data();
+        float* dst = tgt[0].data();
+
+        for (uint z = first_slice; z < last_slice; ++z)
+        {
+            for (uint y = 0; y < brick.res_y; ++y)
+            {
+                size_t row = brick.surface.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                for (uint x = 0; x < brick.res_x; x += static_cast<uint>(Simd::width))
+                {
+                    size_t i = row + x;
+
+                    Simd::FloatN value = k_0 * Simd::load(src + i);
+                    value = value + k_1 * (Simd::load(src + i - stride) + Simd::load(src + i + stride));
+                    value = value + k_2 * (Simd::load(src + i - 2 * stride) + Simd::load(src + i + 2 * stride));
+
+                    Simd::store(dst + i, value);
+                }
+            }
+        }
+    }
+
+    /** Damping of the Jacobi smoother, optimal smoothing factor of the 7-point laplacian */
+    constexpr float multigrid_damping = 6.0f / 7.0f;
+
+    /** Sum of the 6 neighbours of the voxels at i */
+    inline Simd::FloatN sumNeighbours(float const* src, size_t i, size_t row_pitch, size_t slice_pitch)
+    {
+        Simd::FloatN sum = Simd::load(src + i + 1) + Simd::load(src + i - 1);
+        sum = sum + Simd::load(src + i + row_pitch);
+        sum = sum + Simd::load(src + i - row_pitch);
+        sum = sum + Simd::load(src + i + slice_pitch);
+        sum = sum + Simd::load(src + i - slice_pitch);
+        return sum;
+    }
+
+    /** rhs - (6u - sum(neighbours of u)) for unconstrained voxels, 0 for constrained voxels */
+    void residualSlab(BrickField const& u, BrickField const& rhs, BrickField const& mask, BrickField& tgt, uint first_slice, uint last_slice)
+    {
+        size_t const row_pitch = u.getRowPitch();
+        size_t const slice_pitch = u.getSlicePitch();
+
+        Simd::FloatN const zero = Simd::splat(0.0f);
+        Simd::FloatN const six = Simd::splat(6.0f);
+
+        for (uint z = first_slice; z < last_slice; ++z)
+        {
+            for (uint y = 0; y < u.getResY(); ++y)
+            {
+                size_t row = u.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                for (uint x = 0; x < u.getResX(); x += static_cast<uint>(Simd::width))
+                {
+                    size_t i = row + x;
+
+                    Simd::FloatN residual = Simd::load(rhs.data() + i) - (six * Simd::load(u.data() + i) - sumNeighbours(u.data(), i, row_pitch, slice_pitch));
+                    Simd::FloatN constrained = Simd::load(mask.data() + i) > zero;
+
+                    Simd::store(tgt.data() + i, Simd::select(constrained, zero, residual));
+                }
+            }
+        }
+    }
+
+    /** 6u - sum(neighbours of u) for unconstrained voxels, 0 for constrained voxels */
+    void operatorSlab(BrickField const& u, BrickField const& mask, BrickField& tgt, uint first_slice, uint last_slice)
+    {
+        size_t const row_pitch = u.getRowPitch();
+        size_t const slice_pitch = u.getSlicePitch();
+
+        Simd::FloatN const zero = Simd::splat(0.0f);
+        Simd::FloatN const six = Simd::splat(6.0f);
+
+        for (uint z = first_slice; z < last_slice; ++z)
+        {
+            for (uint y = 0; y < u.getResY(); ++y)
+            {
+                size_t row = u.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                for (uint x = 0; x < u.getResX(); x += static_cast<uint>(Simd::width))
+                {
+                    size_t i = row + x;
+
+                    Simd::FloatN product = six * Simd::load(u.data() + i) - sumNeighbours(u.data(), i, row_pitch, slice_pitch);
+                    Simd::FloatN constrained = Simd::load(mask.data() + i) > zero;
+
+                    Simd::store(tgt.data() + i, Simd::select(constrained, zero, product));
+                }
+            }
+        }
+    }
+
+    /** One brick on one level of the multigrid hierarchy */
+    struct MultigridGrid
+    {
+        BrickField solution;
+        BrickField rhs;
+        BrickField residual;
+        BrickField mask;     ///< 1 for constrained voxels, 0 otherwise
+        BrickField scratch;
+
+        HaloLinks solution_links;
+        HaloLinks residual_links;
+    };
+
+    /** Conjugate gradient state of a brick on the finest level */
+    struct KrylovFields
+    {
+        BrickField solution;
+        BrickField rhs;
+        BrickField residual;
+        BrickField correction;
+        BrickField direction;
+        BrickField product;
+
+        HaloLinks solution_links;
+        HaloLinks direction_links;
+
+        /** Shared boundary layers are stored by both bricks, inner products count them once */
+        float face_weights[LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT];
+    };
+
+    /**
+    * Solves the constrained equation 6u - sum(neighbours of u) = rhs for a field of a group of bricks with conjugate
+    * gradients, preconditioned by a vertex-centered geometric multigrid V-cycle. Plain V-cycles stall on constraints
+    * that fall between coarse voxels, the conjugate gradients recover from that. Coarse voxel i is located at fine
+    * voxel 2i, so the shared boundary layers of neighbouring bricks remain shared on all levels. All bricks of the
+    * group are smoothed in lockstep on each level.
+    */
+    class MultigridSolver
+    {
+    public:
+        MultigridSolver(
+            std::vector<LandscapeBrickFields*> const& bricks,
+            FieldId id,
+            BrickField const LandscapeBrickFields::* weights,
+            EngineCore::Graphics::Landscape::MultigridSettings const& settings,
+            EngineCore::Utility::TaskScheduler& task_scheduler);
+
+        /** Returns false if the solution is not determined, i.e. there are no constraints and no fixed neighbours */
+        bool isAnchored() const { return m_anchored; }
+
+        std::vector<EngineCore::Graphics::Landscape::SolverReport> solve();
+
+    private:
+        template<typename Kernel>
+        void forEachSlab(size_t level, Kernel const& kernel);
+
+        /** Sum of the per slab results of the kernel, reduced in a fixed order */
+        template<typename Kernel>
+        double reduceSlabs(Kernel const& kernel);
+
+        void fillHalos(size_t level, bool residual);
+
+        void smooth(size_t level, uint steps);
+
+        void restrictResidual(size_t fine_level);
+
+        void prolongateCorrection(size_t fine_level);
+
+        /** Approximately solves A z = r with one V-cycle, z is stored in the correction of the Krylov fields */
+        void precondition();
+
+        double computeInnerProduct(BrickField const KrylovFields::* a, BrickField const KrylovFields::* b);
+
+        void computeResidualNorms(std::vector<float>& norms);
+
+        std::vector<LandscapeBrickFields*> const& m_bricks;
+        FieldId m_id;
+
+        EngineCore::Graphics::Landscape::MultigridSettings m_settings;
+        EngineCore::Utility::TaskScheduler& m_task_scheduler;
+
+        /** Grids of all bricks per level, the finest level first */
+        std::vector<std::vector<MultigridGrid>> m_levels;
+
+        std::vector<KrylovFields> m_krylov;
+
+        std::vector<std::atomic<int64_t>> m_brick_nanoseconds;
+
+        bool m_anchored;
+    };
+
+    MultigridSolver::MultigridSolver(
+        std::vector<LandscapeBrickFields*> const& bricks,
+        FieldId id,
+        BrickField const LandscapeBrickFields::* weights,
+        EngineCore::Graphics::Landscape::MultigridSettings const& settings,
+        EngineCore::Utility::TaskScheduler& task_scheduler)
+        : m_bricks(bricks),
+        m_id(id),
+        m_settings(settings),
+        m_task_scheduler(task_scheduler),
+        m_krylov(bricks.size()),
+        m_brick_nanoseconds(bricks.size()),
+        m_anchored(false)
+    {
+        size_t level_cnt = std::max(settings.max_levels, 1u);
+        for (auto brick : bricks)
+        {
+            uint res[3] = { brick->res_x, brick->res_y, brick->res_z };
+
+            size_t brick_level_cnt = 1;
+            while (brick_level_cnt < level_cnt && std::all_of(res, res + 3, [](uint r) { return r % 2 == 1 && r >= 5; }))
+            {
+                for (auto& r : res) {
+                    r = (r + 1) / 2;
+                }
+                ++brick_level_cnt;
+            }
+
+            level_cnt = std::min(level_cnt, brick_level_cnt);
+        }
+
+        m_levels.resize(level_cnt);
+
+        for (size_t level = 0; level < level_cnt; ++level)
+        {
+            m_levels[level].resize(bricks.size());
+
+            for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+            {
+                uint res_x = bricks[brick_idx]->res_x;
+                uint res_y = bricks[brick_idx]->res_y;
+                uint res_z = bricks[brick_idx]->res_z;
+                for (size_t l = 0; l < level; ++l)
+                {
+                    res_x = (res_x + 1) / 2;
+                    res_y = (res_y + 1) / 2;
+                    res_z = (res_z + 1) / 2;
+                }
+
+                MultigridGrid& grid = m_levels[level][brick_idx];
+                grid.solution = BrickField(res_x, res_y, res_z);
+                grid.rhs = BrickField(res_x, res_y, res_z);
+                grid.residual = BrickField(res_x, res_y, res_z);
+                grid.mask = BrickField(res_x, res_y, res_z);
+                grid.scratch = BrickField(res_x, res_y, res_z);
+            }
+        }
+
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            LandscapeBrickFields const& brick = *bricks[brick_idx];
+            KrylovFields& krylov = m_krylov[brick_idx];
+
+            krylov.solution = getField(*bricks[brick_idx], id);
+            krylov.rhs = BrickField(brick.res_x, brick.res_y, brick.res_z);
+            krylov.residual = BrickField(brick.res_x, brick.res_y, brick.res_z);
+            krylov.correction = BrickField(brick.res_x, brick.res_y, brick.res_z);
+            krylov.direction = BrickField(brick.res_x, brick.res_y, brick.res_z);
+            krylov.product = BrickField(brick.res_x, brick.res_y, brick.res_z);
+        }
+
+        // neighbours within the group are solved together, neighbours outside of the group are fixed boundary values
+        std::vector<std::pair<LandscapeBrickFields const*, size_t>> brick_indices;
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx) {
+            brick_indices.push_back({ bricks[brick_idx], brick_idx });
+        }
+        std::sort(brick_indices.begin(), brick_indices.end());
+
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            KrylovFields& krylov = m_krylov[brick_idx];
+
+            for (int direction = 0; direction < LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT; ++direction)
+            {
+                LandscapeBrickFields const* neighbour = getNeighbour(*bricks[brick_idx], direction);
+
+                auto it = std::lower_bound(brick_indices.begin(), brick_indices.end(), std::make_pair(neighbour, size_t(0)));
+                bool in_group = neighbour != nullptr && it != brick_indices.end() && it->first == neighbour;
+
+                m_anchored |= neighbour != nullptr && !in_group;
+
+                // corrections vanish at fixed neighbours, the landscape border has zero flux
+                HaloMode mode = neighbour != nullptr ? HaloMode::ZERO : HaloMode::CLAMP;
+
+                krylov.solution_links.neighbours[direction] = in_group ? &m_krylov[it->second].solution : (neighbour != nullptr ? &getField(*bricks[brick_idx]->neighbours[direction], id) : nullptr);
+                krylov.solution_links.modes[direction] = mode;
+                krylov.direction_links.neighbours[direction] = in_group ? &m_krylov[it->second].direction : nullptr;
+                krylov.direction_links.modes[direction] = mode;
+                krylov.face_weights[direction] = in_group ? 0.5f : 1.0f;
+
+                for (size_t level = 0; level < level_cnt; ++level)
+                {
+                    MultigridGrid& grid = m_levels[level][brick_idx];
+
+                    grid.solution_links.neighbours[direction] = in_group ? &m_levels[level][it->second].solution : nullptr;
+                    grid.solution_links.modes[direction] = mode;
+
+                    // restriction is the transposed prolongation, there are no fine voxels beyond the landscape border
+                    grid.residual_links.neighbours[direction] = in_group ? &m_levels[level][it->second].residual : nullptr;
+                    grid.residual_links.modes[direction] = HaloMode::ZERO;
+                }
+            }
+        }
+
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            LandscapeBrickFields& brick = *bricks[brick_idx];
+            MultigridGrid& grid = m_levels[0][brick_idx];
+
+            for (uint z = 0; z < brick.res_z; ++z)
+            {
+                for (uint y = 0; y < brick.res_y; ++y)
+                {
+                    for (uint x = 0; x < brick.res_x; ++x)
+                    {
+                        bool constrained = (brick.*weights)(x, y, z) > 0.0f;
+                        grid.mask(x, y, z) = constrained ? 1.0f : 0.0f;
+                        m_anchored |= constrained;
+                    }
+                }
+            }
+
+            // discrete divergence of the guidance field with normals at the midpoints, see propagateSlab
+            if (id == SURFACE)
+            {
+                fillHalo(brick, NORMAL_X, HaloMode::CLAMP);
+                fillHalo(brick, NORMAL_Y, HaloMode::CLAMP);
+                fillHalo(brick, NORMAL_Z, HaloMode::CLAMP);
+
+                float half_cell_x = 0.5f * brick.dimensions.x / static_cast<float>(brick.res_x);
+                float half_cell_y = 0.5f * brick.dimensions.y / static_cast<float>(brick.res_y);
+                float half_cell_z = 0.5f * brick.dimensions.z / static_cast<float>(brick.res_z);
+
+                int res_x = static_cast<int>(brick.res_x);
+                int res_y = static_cast<int>(brick.res_y);
+                int res_z = static_cast<int>(brick.res_z);
+
+                // the propagation ignores directions beyond the landscape border
+                bool has_neighbour[LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT];
+                for (int direction = 0; direction < LandscapeBrickFields::NEIGHBOUR_DIRECTION_CNT; ++direction) {
+                    has_neighbour[direction] = getNeighbour(brick, direction) != nullptr;
+                }
+
+                auto offset = [](BrickField const& normal, float half_cell, int x, int y, int z, int nx, int ny, int nz) {
+                    return half_cell * (normal(x, y, z) + normal(nx, ny, nz));
+                };
+
+                for (int z = 0; z < res_z; ++z)
+                {
+                    for (int y = 0; y < res_y; ++y)
+                    {
+                        for (int x = 0; x < res_x; ++x)
+                        {
+                            float rhs = 0.0f;
+
+                            if (x < res_x - 1 || has_neighbour[LandscapeBrickFields::EAST])
+                                rhs -= offset(brick.normals[0], half_cell_x, x, y, z, x + 1, y, z);
+                            if (x > 0 || has_neighbour[LandscapeBrickFields::WEST])
+                                rhs += offset(brick.normals[0], half_cell_x, x, y, z, x - 1, y, z);
+                            if (y < res_y - 1 || has_neighbour[LandscapeBrickFields::UP])
+                                rhs -= offset(brick.normals[1], half_cell_y, x, y, z, x, y + 1, z);
+                            if (y > 0 || has_neighbour[LandscapeBrickFields::DOWN])
+                                rhs += offset(brick.normals[1], half_cell_y, x, y, z, x, y - 1, z);
+                            if (z < res_z - 1 || has_neighbour[LandscapeBrickFields::NORTH])
+                                rhs -= offset(brick.normals[2], half_cell_z, x, y, z, x, y, z + 1);
+                            if (z > 0 || has_neighbour[LandscapeBrickFields::SOUTH])
+                                rhs += offset(brick.normals[2], half_cell_z, x, y, z, x, y, z - 1);
+
+                            m_krylov[brick_idx].rhs(x, y, z) = rhs;
+                        }
+                    }
+                }
+            }
+        }
+
+        // coarse voxels closest to constrained voxels of the finest level are constrained
+        for (size_t level = 1; level < level_cnt; ++level)
+        {
+            int spacing = 1 << level;
+
+            for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+            {
+                BrickField const& fine_mask = m_levels[0][brick_idx].mask;
+                BrickField& mask = m_levels[level][brick_idx].mask;
+
+                int fine_res[3] = { static_cast<int>(fine_mask.getResX()), static_cast<int>(fine_mask.getResY()), static_cast<int>(fine_mask.getResZ()) };
+
+                for (int z = 0; z < static_cast<int>(mask.getResZ()); ++z)
+                {
+                    for (int y = 0; y < static_cast<int>(mask.getResY()); ++y)
+                    {
+                        for (int x = 0; x < static_cast<int>(mask.getResX()); ++x)
+                        {
+                            float constrained = 0.0f;
+                            for (int fz = std::max(spacing * z - spacing / 2, 0); fz <= std::min(spacing * z + spacing / 2, fine_res[2] - 1); ++fz)
+                                for (int fy = std::max(spacing * y - spacing / 2, 0); fy <= std::min(spacing * y + spacing / 2, fine_res[1] - 1); ++fy)
+                                    for (int fx = std::max(spacing * x - spacing / 2, 0); fx <= std::min(spacing * x + spacing / 2, fine_res[0] - 1); ++fx)
+                                        constrained = std::max(constrained, fine_mask(fx, fy, fz));
+
+                            mask(x, y, z) = constrained;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename Kernel>
+    void MultigridSolver::forEachSlab(size_t level, Kernel const& kernel)
+    {
+        auto& grids = m_levels[level];
+
+        ::forEachSlab(
+            grids.size(),
+            [&grids](size_t brick_idx) -> BrickField const& { return grids[brick_idx].solution; },
+            [this, &grids, &kernel](size_t brick_idx, uint first, uint last) {
+                auto start = std::chrono::steady_clock::now();
+
+                kernel(brick_idx, grids[brick_idx], first, last);
+
+                m_brick_nanoseconds[brick_idx] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            },
+            m_task_scheduler);
+    }
+
+    template<typename Kernel>
+    double MultigridSolver::reduceSlabs(Kernel const& kernel)
+    {
+        std::vector<std::vector<double>> slab_results(m_bricks.size());
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx) {
+            slab_results[brick_idx].resize(computeSlabCount(m_levels[0][brick_idx].solution), 0.0);
+        }
+
+        forEachSlab(0, [&slab_results, &kernel](size_t brick_idx, MultigridGrid& grid, uint first_slice, uint last_slice) {
+            slab_results[brick_idx][first_slice / computeSlabSize(grid.solution)] = kernel(brick_idx, grid, first_slice, last_slice);
+        });
+
+        double result = 0.0;
+        for (auto const& brick_results : slab_results)
+        {
+            for (double slab_result : brick_results) {
+                result += slab_result;
+            }
+        }
+
+        return result;
+    }
+
+    void MultigridSolver::fillHalos(size_t level, bool residual)
+    {
+        for (auto& grid : m_levels[level])
+        {
+            m_task_scheduler.submitTask([&grid, residual]() {
+                if (residual) {
+                    fillHalo(grid.residual, grid.residual_links);
+                }
+                else {
+                    fillHalo(grid.solution, grid.solution_links);
+                }
+            });
+        }
+
+        m_task_scheduler.waitWhileBusy();
+    }
+
+    void MultigridSolver::smooth(size_t level, uint steps)
+    {
+        Simd::FloatN const zero = Simd::splat(0.0f);
+        Simd::FloatN const sixth = Simd::splat(1.0f / 6.0f);
+        Simd::FloatN const damping = Simd::splat(multigrid_damping);
+
+        for (uint step = 0; step < steps; ++step)
+        {
+            fillHalos(level, false);
+
+            forEachSlab(level, [&](size_t, MultigridGrid& grid, uint first_slice, uint last_slice) {
+                size_t const row_pitch = grid.solution.getRowPitch();
+                size_t const slice_pitch = grid.solution.getSlicePitch();
+
+                float const* src = grid.solution.data();
+                float const* rhs = grid.rhs.data();
+                float const* mask = grid.mask.data();
+                float* dst = grid.scratch.data();
+
+                for (uint z = first_slice; z < last_slice; ++z)
+                {
+                    for (uint y = 0; y < grid.solution.getResY(); ++y)
+                    {
+                        size_t row = grid.solution.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                        for (uint x = 0; x < grid.solution.getResX(); x += static_cast<uint>(Simd::width))
+                        {
+                            size_t i = row + x;
+
+                            Simd::FloatN value = Simd::load(src + i);
+                            Simd::FloatN jacobi = (sumNeighbours(src, i, row_pitch, slice_pitch) + Simd::load(rhs + i)) * sixth;
+                            Simd::FloatN constrained = Simd::load(mask + i) > zero;
+
+                            Simd::store(dst + i, Simd::select(constrained, value, value + damping * (jacobi - value)));
+                        }
+                    }
+                }
+            });
+
+            for (auto& grid : m_levels[level]) {
+                std::swap(grid.solution, grid.scratch);
+            }
+        }
+    }
+
+    void MultigridSolver::restrictResidual(size_t fine_level)
+    {
+        fillHalos(fine_level, false);
+
+        forEachSlab(fine_level, [](size_t, MultigridGrid& grid, uint first_slice, uint last_slice) {
+            residualSlab(grid.solution, grid.rhs, grid.mask, grid.residual, first_slice, last_slice);
+        });
+
+        fillHalos(fine_level, true);
+
+        auto const& fine_grids = m_levels[fine_level];
+
+        // full weighting, scaled by 4 for the doubled voxel spacing of the coarse operator
+        forEachSlab(fine_level + 1, [&fine_grids](size_t brick_idx, MultigridGrid& grid, uint first_slice, uint last_slice) {
+            constexpr float weights[3] = { 0.25f, 0.5f, 0.25f };
+
+            BrickField const& fine_residual = fine_grids[brick_idx].residual;
+
+            for (int z = static_cast<int>(first_slice); z < static_cast<int>(last_slice); ++z)
+            {
+                for (int y = 0; y < static_cast<int>(grid.solution.getResY()); ++y)
+                {
+                    for (int x = 0; x < static_cast<int>(grid.solution.getResX()); ++x)
+                    {
+                        float sum = 0.0f;
+                        for (int dz = -1; dz <= 1; ++dz)
+                            for (int dy = -1; dy <= 1; ++dy)
+                                for (int dx = -1; dx <= 1; ++dx)
+                                    sum += weights[dx + 1] * weights[dy + 1] * weights[dz + 1] * fine_residual(2 * x + dx, 2 * y + dy, 2 * z + dz);
+
+                        grid.rhs(x, y, z) = grid.mask(x, y, z) > 0.0f ? 0.0f : 4.0f * sum;
+                        grid.solution(x, y, z) = 0.0f;
+                    }
+                }
+            }
+        });
+    }
+
+    void MultigridSolver::prolongateCorrection(size_t fine_level)
+    {
+        auto const& coarse_grids = m_levels[fine_level + 1];
+
+        // trilinear interpolation, fine voxels between coarse voxels average their two, four or eight coarse voxels
+        forEachSlab(fine_level, [&coarse_grids](size_t brick_idx, MultigridGrid& grid, uint first_slice, uint last_slice) {
+            BrickField const& correction = coarse_grids[brick_idx].solution;
+
+            int res_x = static_cast<int>(grid.solution.getResX());
+            std::vector<float> coarse_row(correction.getResX());
+
+            for (int z = static_cast<int>(first_slice); z < static_cast<int>(last_slice); ++z)
+            {
+                for (int y = 0; y < static_cast<int>(grid.solution.getResY()); ++y)
+                {
+                    // sum of the coarse rows around the fine row
+                    std::fill(coarse_row.begin(), coarse_row.end(), 0.0f);
+                    for (int cz : { z / 2, (z + 1) / 2 })
+                    {
+                        for (int cy : { y / 2, (y + 1) / 2 })
+                        {
+                            float const* row = correction.data() + correction.index(0, cy, cz);
+                            for (size_t cx = 0; cx < coarse_row.size(); ++cx) {
+                                coarse_row[cx] += row[cx];
+                            }
+                        }
+                    }
+
+                    float* solution = grid.solution.data() + grid.solution.index(0, y, z);
+                    float const* mask = grid.mask.data() + grid.mask.index(0, y, z);
+
+                    for (int x = 0; x < res_x; ++x)
+                    {
+                        float value = 0.125f * (coarse_row[x / 2] + coarse_row[(x + 1) / 2]);
+                        solution[x] += mask[x] > 0.0f ? 0.0f : value;
+                    }
+                }
+            }
+        });
+    }
+
+    void MultigridSolver::precondition()
+    {
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx)
+        {
+            MultigridGrid& grid = m_levels[0][brick_idx];
+            grid.rhs = m_krylov[brick_idx].residual;
+            grid.solution.fill(0.0f);
+        }
+
+        size_t coarsest_level = m_levels.size() - 1;
+
+        for (size_t level = 0; level < coarsest_level; ++level)
+        {
+            smooth(level, m_settings.pre_smoothing_steps);
+            restrictResidual(level);
+        }
+
+        smooth(coarsest_level, m_settings.coarse_smoothing_steps);
+
+        for (size_t level = coarsest_level; level-- > 0;)
+        {
+            prolongateCorrection(level);
+            smooth(level, m_settings.post_smoothing_steps);
+        }
+
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx) {
+            std::swap(m_krylov[brick_idx].correction, m_levels[0][brick_idx].solution);
+        }
+    }
+
+    double MultigridSolver::computeInnerProduct(BrickField const KrylovFields::* a, BrickField const KrylovFields::* b)
+    {
+        return reduceSlabs([this, a, b](size_t brick_idx, MultigridGrid&, uint first_slice, uint last_slice) {
+            KrylovFields const& krylov = m_krylov[brick_idx];
+            BrickField const& field_a = krylov.*a;
+            BrickField const& field_b = krylov.*b;
+
+            int res_x = static_cast<int>(field_a.getResX());
+            int res_y = static_cast<int>(field_a.getResY());
+            int res_z = static_cast<int>(field_a.getResZ());
+
+            auto weight = [](int i, int res, float lower, float upper) {
+                return (i == 0 ? lower : 1.0f) * (i == res - 1 ? upper : 1.0f);
+            };
+
+            float weight_first = weight(0, res_x, krylov.face_weights[LandscapeBrickFields::WEST], krylov.face_weights[LandscapeBrickFields::EAST]);
+            float weight_last = weight(res_x - 1, res_x, krylov.face_weights[LandscapeBrickFields::WEST], krylov.face_weights[LandscapeBrickFields::EAST]);
+
+            double sum = 0.0;
+            for (int z = static_cast<int>(first_slice); z < static_cast<int>(last_slice); ++z)
+            {
+                float weight_z = weight(z, res_z, krylov.face_weights[LandscapeBrickFields::SOUTH], krylov.face_weights[LandscapeBrickFields::NORTH]);
+
+                for (int y = 0; y < res_y; ++y)
+                {
+                    float weight_yz = weight_z * weight(y, res_y, krylov.face_weights[LandscapeBrickFields::DOWN], krylov.face_weights[LandscapeBrickFields::UP]);
+
+                    float const* row_a = field_a.data() + field_a.index(0, y, z);
+                    float const* row_b = field_b.data() + field_b.index(0, y, z);
+
+                    double row_sum = 0.0;
+                    for (int x = 0; x < res_x; ++x) {
+                        row_sum += static_cast<double>(row_a[x] * row_b[x]);
+                    }
+
+                    // shared boundary voxels of the row
+                    row_sum += static_cast<double>((weight_first - 1.0f) * row_a[0] * row_b[0]);
+                    if (res_x > 1) {
+                        row_sum += static_cast<double>((weight_last - 1.0f) * row_a[res_x - 1] * row_b[res_x - 1]);
+                    }
+
+                    sum += weight_yz * row_sum;
+                }
+            }
+
+            return sum;
+        });
+    }
+
+    void MultigridSolver::computeResidualNorms(std::vector<float>& norms)
+    {
+        std::vector<std::vector<float>> slab_norms(m_bricks.size());
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx) {
+            slab_norms[brick_idx].resize(computeSlabCount(m_levels[0][brick_idx].solution), 0.0f);
+        }
+
+        forEachSlab(0, [this, &slab_norms](size_t brick_idx, MultigridGrid& grid, uint first_slice, uint last_slice) {
+            BrickField const& residual = m_krylov[brick_idx].residual;
+
+            float norm = 0.0f;
+            for (uint z = first_slice; z < last_slice; ++z)
+                for (uint y = 0; y < residual.getResY(); ++y)
+                    for (uint x = 0; x < residual.getResX(); ++x)
+                        norm = std::max(norm, std::abs(residual(x, y, z)));
+
+            slab_norms[brick_idx][first_slice / computeSlabSize(grid.solution)] = norm / 6.0f;
+        });
+
+        norms.resize(m_bricks.size());
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx) {
+            norms[brick_idx] = *std::max_element(slab_norms[brick_idx].begin(), slab_norms[brick_idx].end());
+        }
+    }
+
+    std::vector<EngineCore::Graphics::Landscape::SolverReport> MultigridSolver::solve()
+    {
+        std::vector<EngineCore::Graphics::Landscape::SolverReport> reports(m_bricks.size());
+
+        for (auto& krylov : m_krylov)
+        {
+            m_task_scheduler.submitTask([&krylov]() {
+                fillHalo(krylov.solution, krylov.solution_links);
+            });
+        }
+        m_task_scheduler.waitWhileBusy();
+
+        forEachSlab(0, [this](size_t brick_idx, MultigridGrid& grid, uint first_slice, uint last_slice) {
+            KrylovFields& krylov = m_krylov[brick_idx];
+            residualSlab(krylov.solution, krylov.rhs, grid.mask, krylov.residual, first_slice, last_slice);
+        });
+
+        std::vector<float> norms;
+        computeResidualNorms(norms);
+
+        std::vector<bool> converged(m_bricks.size());
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx)
+        {
+            reports[brick_idx].initial_residual = norms[brick_idx];
+            converged[brick_idx] = norms[brick_idx] <= m_settings.tolerance;
+        }
+
+        double residual_correction = 0.0;
+
+        for (uint cycle = 0; m_anchored && cycle < m_settings.max_cycles; ++cycle)
+        {
+            if (std::all_of(converged.begin(), converged.end(), [](bool c) { return c; }))
+                break;
+
+            precondition();
+
+            double next_residual_correction = computeInnerProduct(&KrylovFields::residual, &KrylovFields::correction);
+            if (next_residual_correction <= 0.0)
+                break;
+
+            float beta = cycle == 0 ? 0.0f : static_cast<float>(next_residual_correction / residual_correction);
+            residual_correction = next_residual_correction;
+
+            forEachSlab(0, [this, beta](size_t brick_idx, MultigridGrid&, uint first_slice, uint last_slice) {
+                KrylovFields& krylov = m_krylov[brick_idx];
+
+                Simd::FloatN const factor = Simd::splat(beta);
+
+                for (uint z = first_slice; z < last_slice; ++z)
+                {
+                    for (uint y = 0; y < krylov.direction.getResY(); ++y)
+                    {
+                        size_t row = krylov.direction.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                        for (uint x = 0; x < krylov.direction.getResX(); x += static_cast<uint>(Simd::width))
+                        {
+                            size_t i = row + x;
+                            Simd::store(krylov.direction.data() + i, Simd::load(krylov.correction.data() + i) + factor * Simd::load(krylov.direction.data() + i));
+                        }
+                    }
+                }
+            });
+
+            for (auto& krylov : m_krylov)
+            {
+                m_task_scheduler.submitTask([&krylov]() {
+                    fillHalo(krylov.direction, krylov.direction_links);
+                });
+            }
+            m_task_scheduler.waitWhileBusy();
+
+            forEachSlab(0, [this](size_t brick_idx, MultigridGrid& grid, uint first_slice, uint last_slice) {
+                KrylovFields& krylov = m_krylov[brick_idx];
+                operatorSlab(krylov.direction, grid.mask, krylov.product, first_slice, last_slice);
+            });
+
+            double direction_product = computeInnerProduct(&KrylovFields::direction, &KrylovFields::product);
+            if (direction_product <= 0.0)
+                break;
+
+            float alpha = static_cast<float>(residual_correction / direction_product);
+
+            forEachSlab(0, [this, alpha](size_t brick_idx, MultigridGrid&, uint first_slice, uint last_slice) {
+                KrylovFields& krylov = m_krylov[brick_idx];
+
+                Simd::FloatN const factor = Simd::splat(alpha);
+
+                for (uint z = first_slice; z < last_slice; ++z)
+                {
+                    for (uint y = 0; y < krylov.solution.getResY(); ++y)
+                    {
+                        size_t row = krylov.solution.index(0, static_cast<int>(y), static_cast<int>(z));
+
+                        for (uint x = 0; x < krylov.solution.getResX(); x += static_cast<uint>(Simd::width))
+                        {
+                            size_t i = row + x;
+                            Simd::store(krylov.solution.data() + i, Simd::load(krylov.solution.data() + i) + factor * Simd::load(krylov.direction.data() + i));
+                            Simd::store(krylov.residual.data() + i, Simd::load(krylov.residual.data() + i) - factor * Simd::load(krylov.product.data() + i));
+                        }
+                    }
+                }
+            });
+
+            computeResidualNorms(norms);
+
+            for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx)
+            {
+                if (!converged[brick_idx])
+                {
+                    reports[brick_idx].cycles = cycle + 1;
+                    converged[brick_idx] = norms[brick_idx] <= m_settings.tolerance;
+                }
+            }
+        }
+
+        for (size_t brick_idx = 0; brick_idx < m_bricks.size(); ++brick_idx)
+        {
+            reports[brick_idx].final_residual = norms[brick_idx];
+            reports[brick_idx].seconds = static_cast<double>(m_brick_nanoseconds[brick_idx].load()) * 1.0e-9;
+
+            if (m_anchored) {
+                std::swap(getField(*m_bricks[brick_idx], m_id), m_krylov[brick_idx].solution);
+            }
+        }
+
+        return reports;
+    }
+
+    /** Sums up the timings and keeps the worst convergence of the solves of each brick */
+    void accumulateReports(
+        std::vector<EngineCore::Graphics::Landscape::SolverReport>& total,
+        std::vector<EngineCore::Graphics::Landscape::SolverReport> const& reports)
+    {
+        total.resize(std::max(total.size(), reports.size()));
+
+        for (size_t i = 0; i < reports.size(); ++i)
+        {
+            total[i].cycles = std::max(total[i].cycles, reports[i].cycles);
+            total[i].initial_residual = std::max(total[i].initial_residual, reports[i].initial_residual);
+            total[i].final_residual = std::max(total[i].final_residual, reports[i].final_residual);
+            total[i].seconds += reports[i].seconds;
+        }
+    }
+
+    std::vector<EngineCore::Graphics::Landscape::SolverReport> diffuseMultigrid(
+        std::vector<LandscapeBrickFields*> const& bricks,
+        FieldId first_field,
+        size_t field_cnt,
+        BrickField LandscapeBrickFields::* weights,
+        EngineCore::Graphics::Landscape::MultigridSettings const& settings,
+        EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        std::vector<EngineCore::Graphics::Landscape::SolverReport> reports;
+
+        for (size_t field = 0; field < field_cnt; ++field)
+        {
+            MultigridSolver solver(bricks, static_cast<FieldId>(first_field + field), weights, settings, task_scheduler);
+            accumulateReports(reports, solver.solve());
+        }
+
+        return reports;
+    }
+
+    bool hasConstraints(LandscapeBrickFields const& brick)
+    {
+        for (uint z = 0; z < brick.res_z; ++z)
+            for (uint y = 0; y < brick.res_y; ++y)
+                for (uint x = 0; x < brick.res_x; ++x)
+                    if (brick.surface_weights(x, y, z) > 0.0f || brick.normal_weights(x, y, z) > 0.0f)
+                        return true;
+
+        return false;
+    }
+
+    /**
+    * Solve bricks with constraints first and then the remaining bricks, using the results of the first group as
+    * boundary values. The solve gets the bricks of a group and their indices in the given bricks.
+    */
+    template<typename Solve>
+    void solveGroups(std::vector<LandscapeBrickFields*> const& bricks, Solve const& solve)
+    {
+        std::vector<LandscapeBrickFields*> constrained_bricks;
+        std::vector<LandscapeBrickFields*> empty_bricks;
+        std::vector<size_t> constrained_indices;
+        std::vector<size_t> empty_indices;
+
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            bool constrained = hasConstraints(*bricks[brick_idx]);
+            (constrained ? constrained_bricks : empty_bricks).push_back(bricks[brick_idx]);
+            (constrained ? constrained_indices : empty_indices).push_back(brick_idx);
+        }
+
+        // empty bricks are not solved yet, so constrained bricks treat them as the border of the landscape
+        std::vector<LandscapeBrickFields*> sorted_empty_bricks = empty_bricks;
+        std::sort(sorted_empty_bricks.begin(), sorted_empty_bricks.end());
+
+        std::vector<std::pair<LandscapeBrickFields**, LandscapeBrickFields*>> detached_neighbours;
+        for (auto brick : constrained_bricks)
+        {
+            for (auto& neighbour : brick->neighbours)
+            {
+                if (std::binary_search(sorted_empty_bricks.begin(), sorted_empty_bricks.end(), neighbour))
+                {
+                    detached_neighbours.push_back({ &neighbour, neighbour });
+                    neighbour = nullptr;
+                }
+            }
+        }
+
+        if (!constrained_bricks.empty()) {
+            solve(constrained_bricks, constrained_indices);
+        }
+
+        for (auto const& detached : detached_neighbours) {
+            *detached.first = detached.second;
+        }
+
+        if (!empty_bricks.empty()) {
+            solve(empty_bricks, empty_indices);
+        }
+    }
+
+    constexpr int positive_directions[3] = { LandscapeBrickFields::EAST, LandscapeBrickFields::UP, LandscapeBrickFields::NORTH };
+    constexpr int negative_directions[3] = { LandscapeBrickFields::WEST, LandscapeBrickFields::DOWN, LandscapeBrickFields::SOUTH };
+
+    int getResolution(LandscapeBrickFields const& brick, int axis)
+    {
+        return static_cast<int>(axis == 0 ? brick.res_x : (axis == 1 ? brick.res_y : brick.res_z));
+    }
+
+    /** Voxel of a brick, coordinates are within the brick */
+    struct VoxelRef
+    {
+        LandscapeBrickFields* brick;
+        int coords[3];
+    };
+
+    /**
+    * Voxel at the given coordinates relative to the brick, coordinates outside of the brick are followed along the
+    * neighbours. Returns false if the voxel is outside of the landscape, the reference is clamped to the last brick.
+    */
+    bool resolveVoxel(LandscapeBrickFields& brick, int x, int y, int z, VoxelRef& ref)
+    {
+        ref = { &brick, { x, y, z } };
+        bool inside = true;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            while (ref.coords[axis] > getResolution(*ref.brick, axis) - 1 || ref.coords[axis] < 0)
+            {
+                bool positive = ref.coords[axis] > 0;
+                LandscapeBrickFields* neighbour = getNeighbour(*ref.brick, positive ? positive_directions[axis] : negative_directions[axis]);
+
+                if (neighbour == nullptr)
+                {
+                    ref.coords[axis] = std::clamp(ref.coords[axis], 0, getResolution(*ref.brick, axis) - 1);
+                    inside = false;
+                    break;
+                }
+
+                ref.coords[axis] += positive ? -(getResolution(*ref.brick, axis) - 1) : getResolution(*neighbour, axis) - 1;
+                ref.brick = neighbour;
+            }
+        }
+
+        return inside;
+    }
+
+    /** The voxel and its copies in the neighbours that share the voxel layer (up to 8 at a corner) */
+    void collectVoxelCopies(VoxelRef const& voxel, std::vector<VoxelRef>& copies)
+    {
+        copies.assign(1, voxel);
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            size_t copy_cnt = copies.size();
+            for (size_t i = 0; i < copy_cnt; ++i)
+            {
+                VoxelRef copy = copies[i];
+
+                if (copy.coords[axis] == getResolution(*copy.brick, axis) - 1)
+                {
+                    if (auto neighbour = getNeighbour(*copy.brick, positive_directions[axis]))
+                    {
+                        copy.coords[axis] = 0;
+                        copy.brick = neighbour;
+                        copies.push_back(copy);
+                    }
+                }
+                else if (copy.coords[axis] == 0)
+                {
+                    if (auto neighbour = getNeighbour(*copy.brick, negative_directions[axis]))
+                    {
+                        copy.coords[axis] = getResolution(*neighbour, axis) - 1;
+                        copy.brick = neighbour;
+                        copies.push_back(copy);
+                    }
+                }
+            }
+        }
+    }
+
+    /** Voxel offsets of all bricks connected to the root brick, relative to the root brick */
+    void computeBrickOffsets(
+        LandscapeBrickFields* root,
+        std::unordered_map<LandscapeBrickFields const*, std::array<int, 3>>& offsets)
+    {
+        std::vector<LandscapeBrickFields*> queue = { root };
+        offsets[root] = { 0, 0, 0 };
+
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            LandscapeBrickFields* brick = queue[i];
+            std::array<int, 3> offset = offsets[brick];
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (bool positive : { true, false })
+                {
+                    LandscapeBrickFields* neighbour = getNeighbour(*brick, positive ? positive_directions[axis] : negative_directions[axis]);
+                    if (neighbour == nullptr || offsets.count(neighbour) > 0)
+                        continue;
+
+                    std::array<int, 3> neighbour_offset = offset;
+                    neighbour_offset[axis] += positive ? getResolution(*brick, axis) - 1 : -(getResolution(*neighbour, axis) - 1);
+
+                    offsets[neighbour] = neighbour_offset;
+                    queue.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    /**
+    * Regions of several bricks that are solved together, in voxel coordinates relative to the root brick.
+    * Regions are grouped if their fixed voxel layers overlap, so no region is solved with outdated values of
+    * another region as boundary.
+    */
+    struct RegionGroup
+    {
+        LandscapeBrickFields* root;
+        EngineCore::Graphics::Landscape::BrickRegion bounds;
+        std::vector<size_t> brick_indices;
+    };
+
+    std::vector<RegionGroup> groupRegions(
+        std::vector<LandscapeBrickFields*> const& bricks,
+        std::vector<EngineCore::Graphics::Landscape::BrickRegion> const& regions)
+    {
+        std::unordered_map<LandscapeBrickFields const*, std::array<int, 3>> offsets;
+        std::unordered_map<LandscapeBrickFields const*, LandscapeBrickFields*> roots;
+
+        std::vector<RegionGroup> groups;
+
+        for (size_t brick_idx = 0; brick_idx < bricks.size(); ++brick_idx)
+        {
+            LandscapeBrickFields* brick = bricks[brick_idx];
+            if (regions[brick_idx].isEmpty())
+                continue;
+
+            if (offsets.count(brick) == 0)
+            {
+                std::unordered_map<LandscapeBrickFields const*, std::array<int, 3>> root_offsets;
+                computeBrickOffsets(brick, root_offsets);
+
+                for (auto const& offset : root_offsets)
+                {
+                    offsets[offset.first] = offset.second;
+                    roots[offset.first] = brick;
+                }
+            }
+
+            RegionGroup group = { roots[brick], regions[brick_idx], { brick_idx } };
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                group.bounds.min[axis] += offsets[brick][axis];
+                group.bounds.max[axis] += offsets[brick][axis];
+            }
+
+            groups.push_back(group);
+        }
+
+        auto overlap = [](RegionGroup const& a, RegionGroup const& b) {
+            if (a.root != b.root)
+                return false;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (a.bounds.max[axis] + 2 * halo_width < b.bounds.min[axis] || b.bounds.max[axis] + 2 * halo_width < a.bounds.min[axis])
+                    return false;
+            }
+
+            return true;
+        };
+
+        // merging grows the bounds, so repeat until no groups overlap
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+
+            for (size_t i = 0; i < groups.size() && !merged; ++i)
+            {
+                for (size_t j = i + 1; j < groups.size() && !merged; ++j)
+                {
+                    if (overlap(groups[i], groups[j]))
+                    {
+                        groups[i].bounds.merge(groups[j].bounds);
+                        groups[i].brick_indices.insert(groups[i].brick_indices.end(), groups[j].brick_indices.begin(), groups[j].brick_indices.end());
+                        groups.erase(groups.begin() + j);
+                        merged = true;
+                    }
+                }
+            }
+        }
+
+        return groups;
+    }
+
+    /**
+    * Voxel box of the standalone brick that a region group is solved in, relative to the root brick: the regions and
+    * halo_width fixed layers around them, except at the border of the landscape. Resolutions are made odd where
+    * possible for the coarsening of the multigrid solver.
+    */
+    struct RegionWindow
+    {
+        int origin[3];
+        int res[3];
+    };
+
+    RegionWindow computeRegionWindow(RegionGroup const& group)
+    {
+        RegionWindow window;
+
+        auto isInside = [&group](int axis, int coord) {
+            int coords[3];
+            for (int i = 0; i < 3; ++i) {
+                coords[i] = i == axis ? coord : (group.bounds.min[i] + group.bounds.max[i]) / 2;
+            }
+
+            VoxelRef ref;
+            return resolveVoxel(*group.root, coords[0], coords[1], coords[2], ref);
+        };
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            int first = group.bounds.min[axis];
+            int last = group.bounds.max[axis];
+
+            for (int i = 0; i < halo_width && isInside(axis, first - 1); ++i) {
+                --first;
+            }
+            for (int i = 0; i < halo_width && isInside(axis, last + 1); ++i) {
+                ++last;
+            }
+
+            if ((last - first + 1) % 2 == 0)
+            {
+                if (isInside(axis, last + 1))
+                    ++last;
+                else if (isInside(axis, first - 1))
+                    --first;
+            }
+
+            window.origin[axis] = first;
+            window.res[axis] = last - first + 1;
+        }
+
+        return window;
+    }
+
+    bool isInRegion(EngineCore::Graphics::Landscape::BrickRegion const& region, int const coords[3])
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (coords[axis] < region.min[axis] || coords[axis] > region.max[axis])
+                return false;
+        }
+
+        return true;
+    }
+
+    /** FNV-1a */
+    void hashField(BrickField const& field, uint64_t& hash)
+    {
+        for (uint z = 0; z < field.getResZ(); ++z)
+        {
+            for (uint y = 0; y < field.getResY(); ++y)
+            {
+                auto bytes = reinterpret_cast<uint8_t const*>(field.data() + field.index(0, static_cast<int>(y), static_cast<int>(z)));
+                for (size_t i = 0; i < field.getResX() * sizeof(float); ++i)
+                {
+                    hash ^= bytes[i];
+                    hash *= 1099511628211ull;
+                }
+            }
+        }
+    }
+}
+
+EngineCore::Graphics::Landscape::BrickField::BrickField(uint res_x, uint res_y, uint res_z, float value)
+    : m_res_x(res_x),
+    m_res_y(res_y),
+    m_res_z(res_z),
+    m_row_pitch(((res_x + row_alignment - 1) / row_alignment) * row_alignment + 2 * halo_width),
+    m_slice_pitch(m_row_pitch * (res_y + 2 * halo_width)),
+    m_data(m_slice_pitch * (res_z + 2 * halo_width), value)
+{
+}
+
+void EngineCore::Graphics::Landscape::BrickField::fill(float value)
+{
+    std::fill(m_data.begin(), m_data.end(), value);
+}
+
+EngineCore::Graphics::Landscape::LandscapeBrickFields::LandscapeBrickFields(Vec3 dimensions, uint res_x, uint res_y, uint res_z)
+    : dimensions(dimensions),
+    res_x(res_x),
+    res_y(res_y),
+    res_z(res_z),
+    normals{ BrickField(res_x, res_y, res_z), BrickField(res_x, res_y, res_z), BrickField(res_x, res_y, res_z) },
+    normal_weights(res_x, res_y, res_z),
+    noise{ BrickField(res_x, res_y, res_z), BrickField(res_x, res_y, res_z) },
+    noise_weights(res_x, res_y, res_z),
+    surface(res_x, res_y, res_z),
+    surface_weights(res_x, res_y, res_z),
+    boundary_region(res_x, res_y, res_z)
+{
+}
+
+void EngineCore::Graphics::Landscape::computeGuidanceField(std::vector<LandscapeBrickFields*> const& bricks, uint iterations, Utility::TaskScheduler& task_scheduler)
+{
+    diffuse(bricks, NORMAL_X, 3, &LandscapeBrickFields::normal_weights, iterations, task_scheduler);
+}
+
+void EngineCore::Graphics::Landscape::computeNoiseField(std::vector<LandscapeBrickFields*> const& bricks, uint iterations, Utility::TaskScheduler& task_scheduler)
+{
+    diffuse(bricks, NOISE_AMPLITUDE, 2, &LandscapeBrickFields::noise_weights, iterations, task_scheduler);
+}
+
+void EngineCore::Graphics::Landscape::initializeSurfacePropagation(std::vector<LandscapeBrickFields*> const& bricks, Utility::TaskScheduler& task_scheduler)
+{
+    for (auto brick : bricks)
+    {
+        task_scheduler.submitTask([brick]() {
+            brick->boundary_region.fill(0.0f);
+
+            for (uint z = 0; z < brick->res_z; ++z)
+                for (uint y = 0; y < brick->res_y; ++y)
+                    for (uint x = 0; x < brick->res_x; ++x)
+                        brick->boundary_region(x, y, z) = brick->surface_weights(x, y, z) > 0.0f ? 1.0f : 0.0f;
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+}
+
+void EngineCore::Graphics::Landscape::computeSurfacePropagation(std::vector<LandscapeBrickFields*> const& bricks, uint iterations, Utility::TaskScheduler& task_scheduler)
+{
+    // the guidance field is constant during the propagation
+    for (auto brick : bricks)
+    {
+        task_scheduler.submitTask([brick]() {
+            fillHalo(*brick, NORMAL_X, HaloMode::CLAMP);
+            fillHalo(*brick, NORMAL_Y, HaloMode::CLAMP);
+            fillHalo(*brick, NORMAL_Z, HaloMode::CLAMP);
+        });
+    }
+    task_scheduler.waitWhileBusy();
+
+    // voxels outside of the landscape never join the boundary region
+    std::vector<std::pair<FieldId, HaloMode>> const inputs = { { SURFACE, HaloMode::CLAMP }, { BOUNDARY_REGION, HaloMode::ZERO } };
+    std::vector<FieldId> const outputs = { SURFACE, BOUNDARY_REGION };
+
+    auto scratch = createScratch(bricks, 2);
+
+    for (uint i = 0; i < iterations; ++i) {
+        runStep(bricks, inputs, outputs, scratch, propagateSlab, task_scheduler);
+    }
+}
+
+void EngineCore::Graphics::Landscape::smoothSurfaceField(std::vector<LandscapeBrickFields*> const& bricks, Utility::TaskScheduler& task_scheduler)
+{
+    constexpr float sigma = 0.8f;
+
+    float kernel_weights[3];
+    float weight_sum = 0.0f;
+    for (int i = 0; i < 3; ++i)
+    {
+        kernel_weights[i] = std::exp(-static_cast<float>(i * i) / (2.0f * sigma * sigma));
+        weight_sum += i == 0 ? kernel_weights[i] : 2.0f * kernel_weights[i];
+    }
+    for (auto& weight : kernel_weights) {
+        weight /= weight_sum;
+    }
+
+    std::vector<std::pair<FieldId, HaloMode>> const inputs = { { SURFACE, HaloMode::CLAMP } };
+    std::vector<FieldId> const outputs = { SURFACE };
+
+    auto scratch = createScratch(bricks, 1);
+
+    // x, y and z pass, the halos of each pass are filled with the results of the previous pass of the neighbours
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        auto kernel = [axis, &kernel_weights](LandscapeBrickFields& brick, std::vector<BrickField>& tgt, uint first_slice, uint last_slice) {
+            size_t stride = axis == 0 ? 1 : (axis == 1 ? brick.surface.getRowPitch() : brick.surface.getSlicePitch());
+            smoothSlab(brick, tgt, stride, kernel_weights, first_slice, last_slice);
+        };
+
+        runStep(bricks, inputs, outputs, scratch, kernel, task_scheduler);
+    }
+}
+
+void EngineCore::Graphics::Landscape::bakeBricks(std::vector<LandscapeBrickFields*> const& bricks, Utility::TaskScheduler& task_scheduler)
+{
+    uint iterations = 0;
+    for (auto brick : bricks)
+    {
+        iterations = std::max(iterations, static_cast<uint>(std::sqrt(static_cast<float>(
+            brick->res_x * brick->res_x + brick->res_y * brick->res_y + brick->res_z * brick->res_z))));
+    }
+
+    // same number of solver steps as the GPU update, which dispatches two steps at a time
+    uint steps = (iterations / 2) * 2;
+
+    solveGroups(bricks, [steps, &task_scheduler](std::vector<LandscapeBrickFields*> const& group, std::vector<size_t> const&) {
+        computeGuidanceField(group, steps, task_scheduler);
+        computeNoiseField(group, steps, task_scheduler);
+        initializeSurfacePropagation(group, task_scheduler);
+        computeSurfacePropagation(group, steps, task_scheduler);
+        smoothSurfaceField(group, task_scheduler);
+    });
+}
+
+std::vector<EngineCore::Graphics::Landscape::SolverReport> EngineCore::Graphics::Landscape::computeGuidanceFieldMultigrid(
+    std::vector<LandscapeBrickFields*> const& bricks,
+    MultigridSettings const& settings,
+    Utility::TaskScheduler& task_scheduler)
+{
+    return diffuseMultigrid(bricks, NORMAL_X, 3, &LandscapeBrickFields::normal_weights, settings, task_scheduler);
+}
+
+std::vector<EngineCore::Graphics::Landscape::SolverReport> EngineCore::Graphics::Landscape::computeNoiseFieldMultigrid(
+    std::vector<LandscapeBrickFields*> const& bricks,
+    MultigridSettings const& settings,
+    Utility::TaskScheduler& task_scheduler)
+{
+    return diffuseMultigrid(bricks, NOISE_AMPLITUDE, 2, &LandscapeBrickFields::noise_weights, settings, task_scheduler);
+}
+
+std::vector<EngineCore::Graphics::Landscape::SolverReport> EngineCore::Graphics::Landscape::computeSurfacePropagationMultigrid(
+    std::vector<LandscapeBrickFields*> const& bricks,
+    MultigridSettings const& settings,
+    Utility::TaskScheduler& task_scheduler)
+{
+    MultigridSolver solver(bricks, SURFACE, &LandscapeBrickFields::surface_weights, settings, task_scheduler);
+
+    auto reports = solver.solve();
+
+    if (solver.isAnchored())
+    {
+        for (auto brick : bricks) {
+            brick->boundary_region.fill(1.0f);
+        }
+    }
+
+    return reports;
+}
+
+std::vector<EngineCore::Graphics::Landscape::SolverReport> EngineCore::Graphics::Landscape::bakeBricksMultigrid(
+    std::vector<LandscapeBrickFields*> const& bricks,
+    MultigridSettings const& settings,
+    Utility::TaskScheduler& task_scheduler)
+{
+    std::vector<SolverReport> reports(bricks.size());
+
+    solveGroups(bricks, [&reports, &settings, &task_scheduler](std::vector<LandscapeBrickFields*> const& group, std::vector<size_t> const& indices) {
+        std::vector<SolverReport> group_reports;
+        accumulateReports(group_reports, computeGuidanceFieldMultigrid(group, settings, task_scheduler));
+        accumulateReports(group_reports, computeNoiseFieldMultigrid(group, settings, task_scheduler));
+        accumulateReports(group_reports, computeSurfacePropagationMultigrid(group, settings, task_scheduler));
+        smoothSurfaceField(group, task_scheduler);
+
+        for (size_t i = 0; i < indices.size(); ++i) {
+            reports[indices[i]] = group_reports[i];
+        }
+    });
+
+    return reports;
+}
+
+EngineCore::Graphics::Landscape::BrickRegion EngineCore::Graphics::Landscape::computeBrickRegion(
+    LandscapeBrickFields const& brick,
+    Vec3 bounds_min,
+    Vec3 bounds_max,
+    float influence_radius)
+{
+    BrickRegion region;
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        int res = getResolution(brick, axis);
+        float cell_size = brick.dimensions[axis] / static_cast<float>(res);
+
+        // voxel centers are at (i + 0.5) * cell_size - dimensions / 2
+        float first = (bounds_min[axis] - influence_radius + 0.5f * brick.dimensions[axis]) / cell_size - 0.5f;
+        float last = (bounds_max[axis] + influence_radius + 0.5f * brick.dimensions[axis]) / cell_size - 0.5f;
+
+        if (last < 0.0f || first > static_cast<float>(res - 1))
+            return BrickRegion();
+
+        region.min[axis] = std::max(static_cast<int>(std::floor(first)), 0);
+        region.max[axis] = std::min(static_cast<int>(std::ceil(last)), res - 1);
+    }
+
+    return region;
+}
+
+void EngineCore::Graphics::Landscape::resetBrickRegion(LandscapeBrickFields& brick, BrickRegion const& region)
+{
+    if (region.isEmpty())
+        return;
+
+    for (int z = std::max(region.min[2], 0); z <= std::min(region.max[2], getResolution(brick, 2) - 1); ++z)
+    {
+        for (int y = std::max(region.min[1], 0); y <= std::min(region.max[1], getResolution(brick, 1) - 1); ++y)
+        {
+            for (int x = std::max(region.min[0], 0); x <= std::min(region.max[0], getResolution(brick, 0) - 1); ++x)
+            {
+                brick.normal_weights(x, y, z) = 0.0f;
+                brick.noise_weights(x, y, z) = 0.0f;
+                brick.surface_weights(x, y, z) = 0.0f;
+                brick.boundary_region(x, y, z) = 0.0f;
+            }
+        }
+    }
+}
+
+std::vector<EngineCore::Graphics::Landscape::SolverReport> EngineCore::Graphics::Landscape::rebakeBrickRegions(
+    std::vector<LandscapeBrickFields*> const& bricks,
+    std::vector<BrickRegion> const& regions,
+    MultigridSettings const& settings,
+    Utility::TaskScheduler& task_scheduler)
+{
+    std::vector<SolverReport> reports(bricks.size());
+
+    std::vector<BrickRegion> clipped_regions(bricks.size());
+    for (size_t brick_idx = 0; brick_idx < bricks.size() && brick_idx < regions.size(); ++brick_idx)
+    {
+        clipped_regions[brick_idx] = regions[brick_idx];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            clipped_regions[brick_idx].min[axis] = std::max(regions[brick_idx].min[axis], 0);
+            clipped_regions[brick_idx].max[axis] = std::min(regions[brick_idx].max[axis], getResolution(*bricks[brick_idx], axis) - 1);
+        }
+    }
+
+    for (auto const& group : groupRegions(bricks, clipped_regions))
+    {
+        RegionWindow window = computeRegionWindow(group);
+
+        LandscapeBrickFields& root = *group.root;
+        Vec3 window_dimensions(
+            root.dimensions.x / static_cast<float>(root.res_x) * static_cast<float>(window.res[0]),
+            root.dimensions.y / static_cast<float>(root.res_y) * static_cast<float>(window.res[1]),
+            root.dimensions.z / static_cast<float>(root.res_z) * static_cast<float>(window.res[2]));
+
+        LandscapeBrickFields window_brick(window_dimensions,
+            static_cast<uint>(window.res[0]), static_cast<uint>(window.res[1]), static_cast<uint>(window.res[2]));
+
+        // 1 for voxels of the window that are solved, i.e. a copy of the voxel is within the region of its brick
+        BrickField free_voxels(window_brick.res_x, window_brick.res_y, window_brick.res_z);
+
+        auto isFree = [&group, &bricks, &clipped_regions](std::vector<VoxelRef> const& copies) {
+            for (auto const& copy : copies)
+            {
+                for (size_t brick_idx : group.brick_indices)
+                {
+                    if (bricks[brick_idx] == copy.brick && isInRegion(clipped_regions[brick_idx], copy.coords))
+                        return true;
+                }
+            }
+            return false;
+        };
+
+        // gather the fields, voxels around the regions become constraints
+        for (int z = 0; z < window.res[2]; ++z)
+        {
+            task_scheduler.submitTask([&root, &window_brick, &free_voxels, &window, &isFree, z]() {
+                std::vector<VoxelRef> copies;
+
+                for (int y = 0; y < window.res[1]; ++y)
+                {
+                    for (int x = 0; x < window.res[0]; ++x)
+                    {
+                        VoxelRef src;
+                        bool inside = resolveVoxel(root, window.origin[0] + x, window.origin[1] + y, window.origin[2] + z, src);
+
+                        collectVoxelCopies(src, copies);
+                        bool fixed = !inside || !isFree(copies);
+                        free_voxels(x, y, z) = fixed ? 0.0f : 1.0f;
+
+                        LandscapeBrickFields const& src_brick = *src.brick;
+                        int sx = src.coords[0];
+                        int sy = src.coords[1];
+                        int sz = src.coords[2];
+
+                        for (int i = 0; i < 3; ++i) {
+                            window_brick.normals[i](x, y, z) = src_brick.normals[i](sx, sy, sz);
+                        }
+                        for (int i = 0; i < 2; ++i) {
+                            window_brick.noise[i](x, y, z) = src_brick.noise[i](sx, sy, sz);
+                        }
+                        window_brick.surface(x, y, z) = src_brick.surface(sx, sy, sz);
+                        window_brick.boundary_region(x, y, z) = src_brick.boundary_region(sx, sy, sz);
+
+                        window_brick.normal_weights(x, y, z) = fixed ? 1.0f : src_brick.normal_weights(sx, sy, sz);
+                        window_brick.noise_weights(x, y, z) = fixed ? 1.0f : src_brick.noise_weights(sx, sy, sz);
+                        window_brick.surface_weights(x, y, z) = fixed ? 1.0f : src_brick.surface_weights(sx, sy, sz);
+                    }
+                }
+            });
+        }
+        task_scheduler.waitWhileBusy();
+
+        std::vector<LandscapeBrickFields*> const window_bricks = { &window_brick };
+
+        std::vector<SolverReport> window_reports;
+        accumulateReports(window_reports, computeGuidanceFieldMultigrid(window_bricks, settings, task_scheduler));
+        accumulateReports(window_reports, computeNoiseFieldMultigrid(window_bricks, settings, task_scheduler));
+        accumulateReports(window_reports, computeSurfacePropagationMultigrid(window_bricks, settings, task_scheduler));
+        smoothSurfaceField(window_bricks, task_scheduler);
+
+        for (size_t brick_idx : group.brick_indices) {
+            reports[brick_idx] = window_reports.front();
+        }
+
+        // scatter the regions to all copies of their voxels, each window voxel maps to distinct brick voxels
+        for (int z = 0; z < window.res[2]; ++z)
+        {
+            task_scheduler.submitTask([&root, &window_brick, &free_voxels, &window, z]() {
+                std::vector<VoxelRef> copies;
+
+                for (int y = 0; y < window.res[1]; ++y)
+                {
+                    for (int x = 0; x < window.res[0]; ++x)
+                    {
+                        if (free_voxels(x, y, z) == 0.0f)
+                            continue;
+
+                        VoxelRef tgt;
+                        resolveVoxel(root, window.origin[0] + x, window.origin[1] + y, window.origin[2] + z, tgt);
+                        collectVoxelCopies(tgt, copies);
+
+                        for (auto const& copy : copies)
+                        {
+                            LandscapeBrickFields& tgt_brick = *copy.brick;
+                            int tx = copy.coords[0];
+                            int ty = copy.coords[1];
+                            int tz = copy.coords[2];
+
+                            for (int i = 0; i < 3; ++i) {
+                                tgt_brick.normals[i](tx, ty, tz) = window_brick.normals[i](x, y, z);
+                            }
+                            for (int i = 0; i < 2; ++i) {
+                                tgt_brick.noise[i](tx, ty, tz) = window_brick.noise[i](x, y, z);
+                            }
+                            tgt_brick.surface(tx, ty, tz) = window_brick.surface(x, y, z);
+                            tgt_brick.boundary_region(tx, ty, tz) = window_brick.boundary_region(x, y, z);
+                        }
+                    }
+                }
+            });
+        }
+        task_scheduler.waitWhileBusy();
+    }
+
+    return reports;
+}
+
+uint64_t EngineCore::Graphics::Landscape::computeFieldHash(LandscapeBrickFields const& brick)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (auto const& field : brick.normals) {
+        hashField(field, hash);
+    }
+    for (auto const& field : brick.noise) {
+        hashField(field, hash);
+    }
+    hashField(brick.surface, hash);
+    hashField(brick.boundary_region, hash);
+
+    return hash;
+}
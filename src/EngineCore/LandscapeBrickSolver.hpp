@@ -0,0 +1,262 @@
+#ifndef LandscapeBrickSolver_hpp
+#define LandscapeBrickSolver_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        namespace Landscape
+        {
+            /**
+            * \class BrickField
+            *
+            * \brief Scalar 3D field of a landscape brick, stored x-fastest with a halo of halo_width voxels on every
+            * side. The halo holds the boundary values of the neighbouring bricks during a solver step. Rows are padded
+            * so that stencils can process full SIMD vectors without a scalar remainder.
+            */
+            class BrickField
+            {
+            public:
+                static constexpr int halo_width = 2;
+
+                BrickField() = default;
+                BrickField(uint res_x, uint res_y, uint res_z, float value = 0.0f);
+
+                float& operator()(int x, int y, int z) { return m_data[index(x, y, z)]; }
+                float operator()(int x, int y, int z) const { return m_data[index(x, y, z)]; }
+
+                size_t index(int x, int y, int z) const
+                {
+                    return static_cast<size_t>(z + halo_width) * m_slice_pitch +
+                        static_cast<size_t>(y + halo_width) * m_row_pitch +
+                        static_cast<size_t>(x + halo_width);
+                }
+
+                float* data() { return m_data.data(); }
+                float const* data() const { return m_data.data(); }
+
+                size_t getRowPitch() const { return m_row_pitch; }
+                size_t getSlicePitch() const { return m_slice_pitch; }
+
+                uint getResX() const { return m_res_x; }
+                uint getResY() const { return m_res_y; }
+                uint getResZ() const { return m_res_z; }
+
+                void fill(float value);
+
+            private:
+                uint m_res_x = 0;
+                uint m_res_y = 0;
+                uint m_res_z = 0;
+
+                size_t m_row_pitch = 0;
+                size_t m_slice_pitch = 0;
+
+                std::vector<float> m_data;
+            };
+
+            /**
+            * \brief CPU-side fields of a landscape brick, the counterpart of the 3D textures of a
+            * LandscapeBrickComponent. Constraint weights are written by the voxelization of the feature curves, voxels
+            * with a weight > 0 keep their values during the solves.
+            *
+            * Neighbouring bricks share their boundary layer of voxels, i.e. the last voxel layer of a brick and the
+            * first voxel layer of its eastern neighbour are at the same position (see the brick creation of the
+            * landscape, which adds one voxel to the resolution).
+            */
+            struct LandscapeBrickFields
+            {
+                /** Same order as LandscapeBrickComponentManager::NeighbourDirection, EAST is +x, UP is +y, NORTH is +z */
+                enum NeighbourDirection { EAST, WEST, DOWN, UP, SOUTH, NORTH, NEIGHBOUR_DIRECTION_CNT };
+
+                LandscapeBrickFields(Vec3 dimensions, uint res_x, uint res_y, uint res_z);
+
+                Vec3 dimensions;
+                uint res_x, res_y, res_z;
+
+                BrickField normals[3];      ///< Guidance field, surface normals
+                BrickField normal_weights;  ///< Constraints of the guidance field
+                BrickField noise[2];        ///< Noise amplitude and roughness
+                BrickField noise_weights;   ///< Constraints of the noise field
+                BrickField surface;         ///< Signed distance to the surface
+                BrickField surface_weights; ///< Constraints of the surface field
+                BrickField boundary_region; ///< 1 for voxels that the surface propagation reached, 0 otherwise
+
+                /** Neighbouring bricks, nullptr (or the brick itself) at the border of the landscape */
+                LandscapeBrickFields* neighbours[NEIGHBOUR_DIRECTION_CNT] = {};
+            };
+
+            /**
+            * \brief Parameters of the multigrid solvers. Bricks are coarsened while all resolutions are odd and at
+            * least 5, i.e. bricks with a resolution of 2^n+1 use the full hierarchy.
+            */
+            struct MultigridSettings
+            {
+                uint  pre_smoothing_steps = 2;     ///< Damped Jacobi steps before restricting the residual
+                uint  post_smoothing_steps = 2;    ///< Damped Jacobi steps after adding the coarse correction
+                uint  coarse_smoothing_steps = 32; ///< Damped Jacobi steps on the coarsest level
+                uint  max_levels = 8;
+                uint  max_cycles = 16;
+                float tolerance = 1.0e-5f;         ///< Residual (max. change of a Jacobi step) at which a brick is converged
+            };
+
+            /**
+            * \brief Convergence and timing of a multigrid solve for one brick
+            */
+            struct SolverReport
+            {
+                uint   cycles = 0;              ///< V-cycles until the brick was converged (or the maximum number of cycles)
+                float  initial_residual = 0.0f;
+                float  final_residual = 0.0f;
+                double seconds = 0.0;           ///< Accumulated kernel time of the brick
+            };
+
+            /**
+            * \brief Diffuse the guidance field (Jacobi iterations of the constrained Laplace equation).
+            * All given bricks are iterated in lockstep, each step reads the boundary values of neighbouring bricks from
+            * the previous step. Parallel over bricks and z-slabs on the task scheduler.
+            */
+            void computeGuidanceField(std::vector<LandscapeBrickFields*> const& bricks, uint iterations, Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Diffuse the noise parameters, see computeGuidanceField
+            */
+            void computeNoiseField(std::vector<LandscapeBrickFields*> const& bricks, uint iterations, Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Mark the constrained voxels of the surface field as the initial boundary region of the propagation
+            */
+            void initializeSurfacePropagation(std::vector<LandscapeBrickFields*> const& bricks, Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Propagate signed distances from the boundary region along the guidance field normals. Each
+            * iteration grows the boundary region by one voxel and updates the distances of all unconstrained voxels
+            * that have a neighbour in the boundary region. Parallel over bricks and z-slabs.
+            */
+            void computeSurfacePropagation(std::vector<LandscapeBrickFields*> const& bricks, uint iterations, Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Separable gaussian smoothing (radius 2, sigma 0.8) of the surface field
+            */
+            void smoothSurfaceField(std::vector<LandscapeBrickFields*> const& bricks, Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Run the full solver schedule of the GPU landscape update: guidance and noise fields, surface
+            * propagation and smoothing, with the iteration count derived from the largest brick diagonal. Bricks
+            * without constraints are solved after all others, using their results as boundary values.
+            */
+            void bakeBricks(std::vector<LandscapeBrickFields*> const& bricks, Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Solve the guidance field diffusion with multigrid V-cycles instead of a fixed number of Jacobi
+            * iterations. Solves the same equations as computeGuidanceField, so the result matches the converged Jacobi
+            * iteration. Reports are in the order of the given bricks.
+            */
+            std::vector<SolverReport> computeGuidanceFieldMultigrid(
+                std::vector<LandscapeBrickFields*> const& bricks,
+                MultigridSettings const& settings,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Solve the noise field diffusion with multigrid V-cycles, see computeGuidanceFieldMultigrid
+            */
+            std::vector<SolverReport> computeNoiseFieldMultigrid(
+                std::vector<LandscapeBrickFields*> const& bricks,
+                MultigridSettings const& settings,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Solve the converged state of the surface propagation with multigrid V-cycles, i.e. the boundary
+            * region covers all bricks. Nothing is solved for groups of bricks without constraints and without
+            * neighbours outside of the group.
+            */
+            std::vector<SolverReport> computeSurfacePropagationMultigrid(
+                std::vector<LandscapeBrickFields*> const& bricks,
+                MultigridSettings const& settings,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Same schedule as bakeBricks, with the multigrid solvers for the guidance, noise and surface fields.
+            * Reports are in the order of the given bricks and accumulated over all solves of a brick.
+            */
+            std::vector<SolverReport> bakeBricksMultigrid(
+                std::vector<LandscapeBrickFields*> const& bricks,
+                MultigridSettings const& settings,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Box of voxels of a brick, the bounds are inclusive. Empty if a max. bound is below the min. bound.
+            */
+            struct BrickRegion
+            {
+                int min[3] = { 0, 0, 0 };
+                int max[3] = { -1, -1, -1 };
+
+                bool isEmpty() const { return max[0] < min[0] || max[1] < min[1] || max[2] < min[2]; }
+
+                /** Grow the region to the bounding box of both regions */
+                void merge(BrickRegion const& other)
+                {
+                    if (other.isEmpty())
+                        return;
+
+                    if (isEmpty())
+                    {
+                        *this = other;
+                        return;
+                    }
+
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        min[axis] = min[axis] < other.min[axis] ? min[axis] : other.min[axis];
+                        max[axis] = max[axis] > other.max[axis] ? max[axis] : other.max[axis];
+                    }
+                }
+            };
+
+            /**
+            * \brief Voxels of the brick that are affected by a change within the given box, e.g. the old and new
+            * bounds of a modified feature curve. Bounds are in brick space, i.e. relative to the brick center like
+            * the voxelization. The box is grown by the influence radius, the distance in which the solved fields
+            * noticeably change after an edit.
+            */
+            BrickRegion computeBrickRegion(LandscapeBrickFields const& brick, Vec3 bounds_min, Vec3 bounds_max, float influence_radius);
+
+            /**
+            * \brief Clear the constraints and the boundary region within the region, the counterpart of a field reset
+            * for a part of the brick. Field values are kept as initial guess of the next solve. All feature curves
+            * intersecting the region have to be voxelized again afterwards.
+            */
+            void resetBrickRegion(LandscapeBrickFields& brick, BrickRegion const& region);
+
+            /**
+            * \brief Solve the guidance, noise and surface fields and smooth the surface only within the given region
+            * of each brick. The halo_width voxel layers around the regions keep their values and act as boundary, so
+            * the results stitch to the unchanged parts of the landscape. Regions of neighbouring bricks that are
+            * closer than their boundary layers are solved together with the multigrid solvers, shared voxel layers
+            * are written to all bricks that contain them. The deviation from a full bake depends on the influence
+            * radius of the regions, about a quarter of the brick size keeps it at a few percent of the change.
+            * Reports are in the order of the given bricks.
+            */
+            std::vector<SolverReport> rebakeBrickRegions(
+                std::vector<LandscapeBrickFields*> const& bricks,
+                std::vector<BrickRegion> const& regions,
+                MultigridSettings const& settings,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Hash of all solver fields of a brick (without halos). Results of the solvers do not depend on the
+            * number of worker threads, so the hash can be compared to stored results of previous bakes.
+            */
+            uint64_t computeFieldHash(LandscapeBrickFields const& brick);
+        }
+    }
+}
+
+#endif // !LandscapeBrickSolver_hpp
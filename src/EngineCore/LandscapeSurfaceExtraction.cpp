@@ -0,0 +1,551 @@
+#include "LandscapeSurfaceExtraction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "MarchingCubesTriangleTable.hpp"
+
+namespace
+{
+    using EngineCore::Graphics::Landscape::LandscapeBrickFields;
+    using EngineCore::Graphics::Landscape::SurfaceMesh;
+
+    /** Tasks process blocks of z-layers of about this many cells */
+    constexpr size_t cells_per_block = 16384;
+
+    constexpr uint32_t invalid_vertex = 0xffffffff;
+
+    /** Corner order and edges of the cubes of the marching cubes triangle table */
+    constexpr int corner_offsets[8][3] = { { 0,0,0 },{ 1,0,0 },{ 1,1,0 },{ 0,1,0 },{ 0,0,1 },{ 1,0,1 },{ 1,1,1 },{ 0,1,1 } };
+    constexpr int edge_corners[12][2] = { { 0,1 },{ 1,2 },{ 2,3 },{ 3,0 },{ 4,5 },{ 5,6 },{ 6,7 },{ 7,4 },{ 0,4 },{ 1,5 },{ 2,6 },{ 3,7 } };
+
+    constexpr int positive_directions[3] = { LandscapeBrickFields::EAST, LandscapeBrickFields::UP, LandscapeBrickFields::NORTH };
+    constexpr int negative_directions[3] = { LandscapeBrickFields::WEST, LandscapeBrickFields::DOWN, LandscapeBrickFields::SOUTH };
+
+    int getResolution(LandscapeBrickFields const& brick, int axis)
+    {
+        return static_cast<int>(axis == 0 ? brick.res_x : (axis == 1 ? brick.res_y : brick.res_z));
+    }
+
+    /** Returns nullptr at the border of the landscape and for neighbours whose shared face doesn't match */
+    LandscapeBrickFields const* getNeighbour(LandscapeBrickFields const& brick, int direction)
+    {
+        LandscapeBrickFields const* neighbour = brick.neighbours[direction];
+
+        if (neighbour == nullptr || neighbour == &brick)
+            return nullptr;
+
+        int axis = direction / 2;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (i != axis && getResolution(*neighbour, i) != getResolution(brick, i))
+                return nullptr;
+        }
+
+        return getResolution(*neighbour, axis) > 1 ? neighbour : nullptr;
+    }
+
+    /**
+    * Surface value at voxel coordinates up to one voxel layer outside of the brick, which are read from the
+    * neighbours. Coordinates are clamped at the border of the landscape.
+    */
+    float sampleSurface(LandscapeBrickFields const& brick, int x, int y, int z)
+    {
+        if (x >= 0 && y >= 0 && z >= 0 && x < static_cast<int>(brick.res_x) && y < static_cast<int>(brick.res_y) && z < static_cast<int>(brick.res_z))
+            return brick.surface(x, y, z);
+
+        LandscapeBrickFields const* src = &brick;
+        int coords[3] = { x, y, z };
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            int res = getResolution(*src, axis);
+
+            if (coords[axis] > res - 1)
+            {
+                if (auto neighbour = getNeighbour(*src, positive_directions[axis]))
+                {
+                    coords[axis] -= res - 1;
+                    src = neighbour;
+                }
+            }
+            else if (coords[axis] < 0)
+            {
+                if (auto neighbour = getNeighbour(*src, negative_directions[axis]))
+                {
+                    coords[axis] += getResolution(*neighbour, axis) - 1;
+                    src = neighbour;
+                }
+            }
+
+            coords[axis] = std::clamp(coords[axis], 0, getResolution(*src, axis) - 1);
+        }
+
+        return src->surface(coords[0], coords[1], coords[2]);
+    }
+
+    /** Brick space position of (fractional) voxel coordinates, the last voxel layer is exactly on the brick face */
+    Vec3 computePosition(LandscapeBrickFields const& brick, float x, float y, float z)
+    {
+        return Vec3(
+            x / static_cast<float>(brick.res_x - 1) * brick.dimensions.x - 0.5f * brick.dimensions.x,
+            y / static_cast<float>(brick.res_y - 1) * brick.dimensions.y - 0.5f * brick.dimensions.y,
+            z / static_cast<float>(brick.res_z - 1) * brick.dimensions.z - 0.5f * brick.dimensions.z);
+    }
+
+    Vec3 computeVoxelSpacing(LandscapeBrickFields const& brick)
+    {
+        return Vec3(
+            brick.dimensions.x / static_cast<float>(brick.res_x - 1),
+            brick.dimensions.y / static_cast<float>(brick.res_y - 1),
+            brick.dimensions.z / static_cast<float>(brick.res_z - 1));
+    }
+
+    Vec3 normalizeOrZero(Vec3 const& v)
+    {
+        float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        return length > 0.0f ? Vec3(v.x / length, v.y / length, v.z / length) : Vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    struct Block
+    {
+        int      first_layer;
+        int      last_layer;
+        uint32_t vertex_cnt;
+        uint32_t index_cnt;
+        uint32_t vertex_offset;
+        uint32_t index_offset;
+    };
+
+    std::vector<Block> createBlocks(int first_layer, int last_layer, size_t cells_per_layer)
+    {
+        int layers_per_block = static_cast<int>(std::max(cells_per_block / std::max(cells_per_layer, size_t(1)), size_t(1)));
+
+        std::vector<Block> blocks;
+        for (int layer = first_layer; layer <= last_layer; layer += layers_per_block) {
+            blocks.push_back({ layer, std::min(layer + layers_per_block - 1, last_layer), 0, 0, 0, 0 });
+        }
+
+        return blocks;
+    }
+
+    template<typename Kernel>
+    void forEachBlock(std::vector<Block>& blocks, Kernel const& kernel, EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        for (auto& block : blocks) {
+            task_scheduler.submitTask([&block, &kernel]() { kernel(block); });
+        }
+
+        task_scheduler.waitWhileBusy();
+    }
+
+    /** Exclusive prefix sum of the vertex and index counts of the blocks, allocates the mesh */
+    void mergeBlocks(std::vector<Block>& blocks, SurfaceMesh& mesh)
+    {
+        uint32_t vertex_cnt = 0;
+        uint32_t index_cnt = 0;
+
+        for (auto& block : blocks)
+        {
+            block.vertex_offset = vertex_cnt;
+            block.index_offset = index_cnt;
+            vertex_cnt += block.vertex_cnt;
+            index_cnt += block.index_cnt;
+        }
+
+        mesh.positions.resize(vertex_cnt);
+        mesh.normals.resize(vertex_cnt);
+        mesh.indices.resize(index_cnt);
+    }
+
+    uint32_t countTriangleIndices(int cube_index)
+    {
+        uint32_t cnt = 0;
+        while (cnt < 15 && ::Landscape::triangle_table[cube_index * 16 + cnt] != -1) {
+            ++cnt;
+        }
+
+        return cnt;
+    }
+}
+
+EngineCore::Graphics::Landscape::SurfaceMesh EngineCore::Graphics::Landscape::computeMarchingCubesMesh(
+    LandscapeBrickFields const& brick,
+    Utility::TaskScheduler& task_scheduler,
+    float iso_value)
+{
+    SurfaceMesh mesh;
+
+    int const res[3] = { static_cast<int>(brick.res_x), static_cast<int>(brick.res_y), static_cast<int>(brick.res_z) };
+    if (res[0] < 2 || res[1] < 2 || res[2] < 2)
+        return mesh;
+
+    // each edge of a cube is stored at its lower voxel, with the axis it points along
+    int edge_voxels[12][3];
+    int edge_axes[12];
+    for (int edge = 0; edge < 12; ++edge)
+    {
+        int const* a = corner_offsets[edge_corners[edge][0]];
+        int const* b = corner_offsets[edge_corners[edge][1]];
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            edge_voxels[edge][axis] = std::min(a[axis], b[axis]);
+            if (a[axis] != b[axis])
+                edge_axes[edge] = axis;
+        }
+    }
+
+    auto edgeIndex = [&res](int x, int y, int z, int axis) {
+        return ((static_cast<size_t>(z) * res[1] + y) * res[0] + x) * 3 + axis;
+    };
+
+    auto cubeIndex = [&brick, iso_value](int x, int y, int z) {
+        int cube_index = 0;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            if (brick.surface(x + corner_offsets[corner][0], y + corner_offsets[corner][1], z + corner_offsets[corner][2]) < iso_value)
+                cube_index |= 1 << corner;
+        }
+        return cube_index;
+    };
+
+    // calls the function for each edge of the voxel layer that crosses the iso surface
+    auto forEachCrossing = [&brick, &res, iso_value](int z, auto const& function) {
+        for (int y = 0; y < res[1]; ++y)
+        {
+            for (int x = 0; x < res[0]; ++x)
+            {
+                float value = brick.surface(x, y, z);
+                int const end[3] = { x + 1, y + 1, z + 1 };
+
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (end[axis] >= res[axis])
+                        continue;
+
+                    float end_value = brick.surface(axis == 0 ? end[0] : x, axis == 1 ? end[1] : y, axis == 2 ? end[2] : z);
+                    if ((value < iso_value) != (end_value < iso_value))
+                        function(x, y, axis, value, end_value);
+                }
+            }
+        }
+    };
+
+    std::vector<Block> blocks = createBlocks(0, res[2] - 1, static_cast<size_t>(res[0]) * res[1]);
+
+    // count vertices of the edges and triangle indices of the cells at the voxel layers of each block
+    forEachBlock(blocks, [&](Block& block) {
+        for (int z = block.first_layer; z <= block.last_layer; ++z)
+        {
+            forEachCrossing(z, [&block](int, int, int, float, float) { ++block.vertex_cnt; });
+
+            if (z == res[2] - 1)
+                continue;
+
+            for (int y = 0; y < res[1] - 1; ++y)
+                for (int x = 0; x < res[0] - 1; ++x)
+                    block.index_cnt += countTriangleIndices(cubeIndex(x, y, z));
+        }
+    }, task_scheduler);
+
+    mergeBlocks(blocks, mesh);
+
+    std::vector<uint32_t> edge_vertices(static_cast<size_t>(res[0]) * res[1] * res[2] * 3, invalid_vertex);
+
+    Vec3 const spacing = computeVoxelSpacing(brick);
+
+    auto computeGradient = [&brick, &spacing](int x, int y, int z) {
+        return Vec3(
+            (sampleSurface(brick, x + 1, y, z) - sampleSurface(brick, x - 1, y, z)) / (2.0f * spacing.x),
+            (sampleSurface(brick, x, y + 1, z) - sampleSurface(brick, x, y - 1, z)) / (2.0f * spacing.y),
+            (sampleSurface(brick, x, y, z + 1) - sampleSurface(brick, x, y, z - 1)) / (2.0f * spacing.z));
+    };
+
+    // vertices at the edge crossings, the normals are interpolated from the gradients at both voxels
+    forEachBlock(blocks, [&](Block& block) {
+        uint32_t vertex_idx = block.vertex_offset;
+
+        for (int z = block.first_layer; z <= block.last_layer; ++z)
+        {
+            forEachCrossing(z, [&](int x, int y, int axis, float value, float end_value) {
+                float t = (iso_value - value) / (end_value - value);
+
+                float coords[3] = { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
+                coords[axis] += t;
+
+                int const end[3] = { axis == 0 ? x + 1 : x, axis == 1 ? y + 1 : y, axis == 2 ? z + 1 : z };
+                Vec3 gradient = computeGradient(x, y, z);
+                Vec3 end_gradient = computeGradient(end[0], end[1], end[2]);
+
+                mesh.positions[vertex_idx] = computePosition(brick, coords[0], coords[1], coords[2]);
+                mesh.normals[vertex_idx] = normalizeOrZero(gradient + t * (end_gradient - gradient));
+
+                edge_vertices[edgeIndex(x, y, z, axis)] = vertex_idx++;
+            });
+        }
+    }, task_scheduler);
+
+    // triangles of the cells, edges of the last layer of a block belong to the next block
+    forEachBlock(blocks, [&](Block& block) {
+        uint32_t index_idx = block.index_offset;
+
+        for (int z = block.first_layer; z <= std::min(block.last_layer, res[2] - 2); ++z)
+        {
+            for (int y = 0; y < res[1] - 1; ++y)
+            {
+                for (int x = 0; x < res[0] - 1; ++x)
+                {
+                    int cube_index = cubeIndex(x, y, z);
+                    uint32_t cnt = countTriangleIndices(cube_index);
+
+                    // the table winds clockwise seen from the outside, i.e. from voxels above the iso value
+                    for (uint32_t i = 0; i < cnt; i += 3)
+                    {
+                        for (uint32_t j = 0; j < 3; ++j)
+                        {
+                            int edge = ::Landscape::triangle_table[cube_index * 16 + i + 2 - j];
+                            mesh.indices[index_idx++] = edge_vertices[edgeIndex(
+                                x + edge_voxels[edge][0], y + edge_voxels[edge][1], z + edge_voxels[edge][2], edge_axes[edge])];
+                        }
+                    }
+                }
+            }
+        }
+    }, task_scheduler);
+
+    return mesh;
+}
+
+EngineCore::Graphics::Landscape::SurfaceMesh EngineCore::Graphics::Landscape::computeSurfaceNetsMesh(
+    LandscapeBrickFields const& brick,
+    Utility::TaskScheduler& task_scheduler,
+    float iso_value)
+{
+    SurfaceMesh mesh;
+
+    int const res[3] = { static_cast<int>(brick.res_x), static_cast<int>(brick.res_y), static_cast<int>(brick.res_z) };
+    if (res[0] < 2 || res[1] < 2 || res[2] < 2)
+        return mesh;
+
+    // cells range from -1 (the adjacent cells of the WEST, DOWN and SOUTH neighbours) to res - 2
+    int first_cell[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        first_cell[axis] = getNeighbour(brick, negative_directions[axis]) != nullptr ? -1 : 0;
+    }
+
+    auto cellIndex = [&res](int x, int y, int z) {
+        return (static_cast<size_t>(z + 1) * res[1] + (y + 1)) * res[0] + (x + 1);
+    };
+
+    auto isCell = [&res, &first_cell](int const cell[3]) {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (cell[axis] < first_cell[axis] || cell[axis] > res[axis] - 2)
+                return false;
+        }
+        return true;
+    };
+
+    auto loadCorners = [&brick](int x, int y, int z, float corners[8]) {
+        for (int corner = 0; corner < 8; ++corner) {
+            corners[corner] = sampleSurface(brick, x + corner_offsets[corner][0], y + corner_offsets[corner][1], z + corner_offsets[corner][2]);
+        }
+    };
+
+    auto isActive = [iso_value](float const corners[8]) {
+        int inside_cnt = 0;
+        for (int corner = 0; corner < 8; ++corner) {
+            inside_cnt += corners[corner] < iso_value ? 1 : 0;
+        }
+        return inside_cnt > 0 && inside_cnt < 8;
+    };
+
+    // calls the function with the four cells around each edge of the voxel layer that crosses the iso surface,
+    // counter-clockwise seen from the outside
+    auto forEachQuad = [&brick, &res, &isCell, iso_value](int z, auto const& function) {
+        for (int y = 0; y < res[1]; ++y)
+        {
+            for (int x = 0; x < res[0]; ++x)
+            {
+                int const voxel[3] = { x, y, z };
+
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (voxel[axis] + 1 >= res[axis])
+                        continue;
+
+                    int u = (axis + 1) % 3;
+                    int v = (axis + 2) % 3;
+
+                    int cells[4][3];
+                    int const uv_offsets[4][2] = { { -1,-1 },{ 0,-1 },{ 0,0 },{ -1,0 } };
+                    bool complete = true;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        cells[i][axis] = voxel[axis];
+                        cells[i][u] = voxel[u] + uv_offsets[i][0];
+                        cells[i][v] = voxel[v] + uv_offsets[i][1];
+                        complete = complete && isCell(cells[i]);
+                    }
+
+                    if (!complete)
+                        continue;
+
+                    float value = brick.surface(x, y, z);
+                    float end_value = brick.surface(axis == 0 ? x + 1 : x, axis == 1 ? y + 1 : y, axis == 2 ? z + 1 : z);
+
+                    if ((value < iso_value) == (end_value < iso_value))
+                        continue;
+
+                    // the quad faces along the edge if its start is inside of the terrain
+                    if (value < iso_value)
+                        function(cells[0], cells[1], cells[2], cells[3]);
+                    else
+                        function(cells[0], cells[3], cells[2], cells[1]);
+                }
+            }
+        }
+    };
+
+    std::vector<Block> blocks = createBlocks(first_cell[2], res[2] - 2, static_cast<size_t>(res[0]) * res[1]);
+
+    // count the active cells and the quads of the edges at the voxel layer of each cell layer
+    forEachBlock(blocks, [&](Block& block) {
+        float corners[8];
+
+        for (int z = block.first_layer; z <= block.last_layer; ++z)
+        {
+            for (int y = first_cell[1]; y <= res[1] - 2; ++y)
+            {
+                for (int x = first_cell[0]; x <= res[0] - 2; ++x)
+                {
+                    loadCorners(x, y, z, corners);
+                    block.vertex_cnt += isActive(corners) ? 1 : 0;
+                }
+            }
+
+            if (z >= 0)
+                forEachQuad(z, [&block](int const*, int const*, int const*, int const*) { block.index_cnt += 6; });
+        }
+    }, task_scheduler);
+
+    mergeBlocks(blocks, mesh);
+
+    std::vector<uint32_t> cell_vertices(static_cast<size_t>(res[0]) * res[1] * res[2], invalid_vertex);
+
+    Vec3 const spacing = computeVoxelSpacing(brick);
+
+    // vertex at the mean of the edge crossings, the normal is the gradient of the trilinear interpolation
+    forEachBlock(blocks, [&](Block& block) {
+        uint32_t vertex_idx = block.vertex_offset;
+        float corners[8];
+
+        for (int z = block.first_layer; z <= block.last_layer; ++z)
+        {
+            for (int y = first_cell[1]; y <= res[1] - 2; ++y)
+            {
+                for (int x = first_cell[0]; x <= res[0] - 2; ++x)
+                {
+                    loadCorners(x, y, z, corners);
+                    if (!isActive(corners))
+                        continue;
+
+                    float mean[3] = { 0.0f, 0.0f, 0.0f };
+                    int crossing_cnt = 0;
+
+                    for (auto const& edge : edge_corners)
+                    {
+                        float a = corners[edge[0]];
+                        float b = corners[edge[1]];
+                        if ((a < iso_value) == (b < iso_value))
+                            continue;
+
+                        float t = (iso_value - a) / (b - a);
+                        for (int axis = 0; axis < 3; ++axis) {
+                            mean[axis] += static_cast<float>(corner_offsets[edge[0]][axis]) +
+                                t * static_cast<float>(corner_offsets[edge[1]][axis] - corner_offsets[edge[0]][axis]);
+                        }
+                        ++crossing_cnt;
+                    }
+
+                    for (auto& coord : mean) {
+                        coord /= static_cast<float>(crossing_cnt);
+                    }
+
+                    float gradient[3] = { 0.0f, 0.0f, 0.0f };
+                    for (int corner = 0; corner < 8; ++corner)
+                    {
+                        float weights[3];
+                        for (int axis = 0; axis < 3; ++axis) {
+                            weights[axis] = corner_offsets[corner][axis] != 0 ? mean[axis] : 1.0f - mean[axis];
+                        }
+
+                        gradient[0] += corners[corner] * (corner_offsets[corner][0] != 0 ? 1.0f : -1.0f) * weights[1] * weights[2];
+                        gradient[1] += corners[corner] * (corner_offsets[corner][1] != 0 ? 1.0f : -1.0f) * weights[0] * weights[2];
+                        gradient[2] += corners[corner] * (corner_offsets[corner][2] != 0 ? 1.0f : -1.0f) * weights[0] * weights[1];
+                    }
+
+                    mesh.positions[vertex_idx] = computePosition(brick,
+                        static_cast<float>(x) + mean[0], static_cast<float>(y) + mean[1], static_cast<float>(z) + mean[2]);
+                    mesh.normals[vertex_idx] = normalizeOrZero(Vec3(gradient[0] / spacing.x, gradient[1] / spacing.y, gradient[2] / spacing.z));
+
+                    cell_vertices[cellIndex(x, y, z)] = vertex_idx++;
+                }
+            }
+        }
+    }, task_scheduler);
+
+    // two triangles per quad, all cells of the quads are active and have a vertex
+    forEachBlock(blocks, [&](Block& block) {
+        uint32_t index_idx = block.index_offset;
+
+        for (int z = std::max(block.first_layer, 0); z <= block.last_layer; ++z)
+        {
+            forEachQuad(z, [&](int const* c0, int const* c1, int const* c2, int const* c3) {
+                uint32_t v0 = cell_vertices[cellIndex(c0[0], c0[1], c0[2])];
+                uint32_t v1 = cell_vertices[cellIndex(c1[0], c1[1], c1[2])];
+                uint32_t v2 = cell_vertices[cellIndex(c2[0], c2[1], c2[2])];
+                uint32_t v3 = cell_vertices[cellIndex(c3[0], c3[1], c3[2])];
+
+                uint32_t const quad_indices[6] = { v0, v1, v2, v0, v2, v3 };
+                for (uint32_t index : quad_indices) {
+                    mesh.indices[index_idx++] = index;
+                }
+            });
+        }
+    }, task_scheduler);
+
+    return mesh;
+}
+
+bool EngineCore::Graphics::Landscape::exportSurfaceMesh(SurfaceMesh const& mesh, Vec3 brick_position, std::string const& export_filepath)
+{
+    std::ofstream file(export_filepath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    file << "# Space-Lion Terrain Export\n";
+    file << "o Terrain\n";
+
+    for (auto const& position : mesh.positions) {
+        file << "v " << position.x + brick_position.x << " " << position.y + brick_position.y << " " << position.z + brick_position.z << "\n";
+    }
+    for (auto const& normal : mesh.normals) {
+        file << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+    }
+
+    file << "usemtl None\n";
+    file << "s off\n";
+
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        uint32_t a = mesh.indices[i] + 1;
+        uint32_t b = mesh.indices[i + 1] + 1;
+        uint32_t c = mesh.indices[i + 2] + 1;
+        file << "f " << a << "//" << a << " " << b << "//" << b << " " << c << "//" << c << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,61 @@
+#ifndef LandscapeSurfaceExtraction_hpp
+#define LandscapeSurfaceExtraction_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LandscapeBrickSolver.hpp"
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        namespace Landscape
+        {
+            /**
+            * \brief Triangle mesh of the surface of a brick. Positions are in brick space, i.e. relative to the
+            * brick center, with the first and last voxel layer of the brick on its faces (like the surface meshes of
+            * the GPU update), so the shared voxel layers of neighbouring bricks are at the same positions.
+            */
+            struct SurfaceMesh
+            {
+                std::vector<Vec3>     positions;
+                std::vector<Vec3>     normals;   ///< Normalized gradient of the surface field, pointing out of the terrain
+                std::vector<uint32_t> indices;   ///< Triangle list, counter-clockwise seen from outside of the terrain
+            };
+
+            /**
+            * \brief Extract the iso surface of the surface field with marching cubes. Vertices are shared by all
+            * cells adjacent to an edge. Parallel over blocks of z-layers on the task scheduler, the blocks are
+            * merged with a prefix sum over their vertex and index counts, so the mesh does not depend on the number
+            * of worker threads.
+            *
+            * Vertices on a shared face are computed from the same voxels (and gradients that read across the face)
+            * in both bricks, so neighbouring meshes meet without cracks.
+            */
+            SurfaceMesh computeMarchingCubesMesh(LandscapeBrickFields const& brick, Utility::TaskScheduler& task_scheduler, float iso_value = 0.0f);
+
+            /**
+            * \brief Extract the iso surface of the surface field with naive surface nets, i.e. one vertex per cell
+            * at the mean of its edge crossings and one quad (two triangles) per edge crossing. Parallel over blocks
+            * of z-layers like computeMarchingCubesMesh.
+            *
+            * Quads across a shared face are generated by the brick on the EAST, UP or NORTH side, which adds the
+            * vertices of the adjacent cells of its WEST, DOWN and SOUTH neighbours. These vertices are computed from
+            * the same voxels as in the neighbour, so the meshes of neighbouring bricks close the seam.
+            */
+            SurfaceMesh computeSurfaceNetsMesh(LandscapeBrickFields const& brick, Utility::TaskScheduler& task_scheduler, float iso_value = 0.0f);
+
+            /**
+            * \brief Write the mesh as Wavefront OBJ file, offset by the given brick position. Returns false if the
+            * file can not be written.
+            */
+            bool exportSurfaceMesh(SurfaceMesh const& mesh, Vec3 brick_position, std::string const& export_filepath);
+        }
+    }
+}
+
+#endif // !LandscapeSurfaceExtraction_hpp
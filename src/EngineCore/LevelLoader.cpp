@@ -0,0 +1,640 @@
+#include "LevelLoader.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+
+#include "AirplanePhysicsComponent.hpp"
+#include "CameraComponent.hpp"
+#include "JsonSaxParser.hpp"
+#include "NameComponentManager.hpp"
+#include "PointlightComponent.hpp"
+#include "ResourceLoading.hpp"
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace EngineCore
+{
+    namespace Common
+    {
+        namespace
+        {
+            /** Number of entity descriptions resolved per task */
+            constexpr size_t entities_per_task = 4096;
+
+            /**
+            * Run all jobs on the scheduler and wait for their completion. The first exception thrown by a job is rethrown.
+            */
+            void runJobs(Utility::TaskScheduler& task_scheduler, std::vector<std::function<void()>> const& jobs)
+            {
+                std::mutex              mutex;
+                std::condition_variable cvar;
+                size_t                  remaining_jobs = jobs.size();
+                std::exception_ptr      exception;
+
+                for (auto const& job : jobs)
+                {
+                    task_scheduler.submitTask([&job, &mutex, &cvar, &remaining_jobs, &exception]() {
+                        std::exception_ptr job_exception;
+                        try {
+                            job();
+                        }
+                        catch (...) {
+                            job_exception = std::current_exception();
+                        }
+
+                        std::unique_lock<std::mutex> lock(mutex);
+                        if (job_exception && !exception) {
+                            exception = job_exception;
+                        }
+                        --remaining_jobs;
+                        cvar.notify_all();
+                    });
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                cvar.wait(lock, [&remaining_jobs]() { return remaining_jobs == 0; });
+
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+            bool parseFloat(std::string_view str, float& value)
+            {
+                auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+                return result.ec == std::errc() && result.ptr == str.data() + str.size();
+            }
+        }
+
+        /**
+        * Turns parsing events into entity records. Entities are the objects at a fixed depth of the document,
+        * i.e. the root object of prefab files and the elements of the "entities" array of level files.
+        */
+        class LevelLoader::JsonHandler
+        {
+        public:
+            JsonHandler(std::vector<EntityRecord>& records, bool is_level)
+                : m_records(records), m_is_level(is_level), m_entity_depth(is_level ? 3 : 1),
+                m_depth(0), m_in_entities(false), m_in_entity(false), m_component(Component::NONE)
+            {
+            }
+
+            bool onObjectBegin()
+            {
+                ++m_depth;
+
+                if (m_depth == m_entity_depth && (!m_is_level || m_in_entities))
+                {
+                    m_records.emplace_back();
+                    m_in_entity = true;
+                }
+                else if (m_in_entity && m_depth == m_entity_depth + 1)
+                {
+                    beginComponent();
+                }
+
+                return true;
+            }
+
+            bool onObjectEnd()
+            {
+                endContainer();
+                return true;
+            }
+
+            bool onArrayBegin()
+            {
+                ++m_depth;
+
+                if (m_is_level && m_depth == 2 && m_root_key == "entities")
+                {
+                    m_in_entities = true;
+                }
+                else if (m_in_entity && m_depth == m_entity_depth + 1)
+                {
+                    // components have to be objects
+                    m_component = Component::NONE;
+                }
+
+                return true;
+            }
+
+            bool onArrayEnd()
+            {
+                if (m_is_level && m_depth == 2) {
+                    m_in_entities = false;
+                }
+
+                endContainer();
+                return true;
+            }
+
+            bool onKey(std::string_view key)
+            {
+                if (m_is_level && m_depth == 1)
+                {
+                    m_root_key = key;
+                }
+                else if (m_in_entity && m_depth == m_entity_depth)
+                {
+                    m_entity_key = key;
+                }
+                else if (m_in_entity && m_depth == m_entity_depth + 1)
+                {
+                    m_value.component = m_component;
+                    m_value.property = lookupProperty(m_component, key);
+                    m_value.value_cnt = 0;
+                    m_value.string_value.clear();
+                }
+
+                return true;
+            }
+
+            bool onString(std::string_view str)
+            {
+                if (m_in_entity && m_depth == m_entity_depth)
+                {
+                    if (m_entity_key == "type") {
+                        m_records.back().type = str;
+                    }
+                    else if (m_entity_key == "name") {
+                        m_records.back().name = str;
+                    }
+                    return true;
+                }
+
+                float value;
+                if (parseFloat(str, value)) {
+                    addValue(value);
+                }
+                else if (m_in_entity && m_depth >= m_entity_depth + 1) {
+                    m_value.string_value = str;
+                }
+
+                completeScalar();
+                return true;
+            }
+
+            bool onNumber(double value)
+            {
+                addValue(static_cast<float>(value));
+                completeScalar();
+                return true;
+            }
+
+            bool onBool(bool value)
+            {
+                completeScalar();
+                return true;
+            }
+
+            bool onNull()
+            {
+                completeScalar();
+                return true;
+            }
+
+        private:
+            static Component lookupComponent(std::string const& name)
+            {
+                if (name == "TransformComponent" || name == "Transform")
+                    return Component::TRANSFORM;
+                if (name == "CameraComponent" || name == "Camera")
+                    return Component::CAMERA;
+                if (name == "PointlightComponent" || name == "Pointlight" || name == "Light")
+                    return Component::POINTLIGHT;
+                if (name == "AirplanePhysicsComponent" || name == "AirplanePhysics")
+                    return Component::AIRPLANE_PHYSICS;
+                if (name == "RenderJob")
+                    return Component::RENDER_JOB;
+                return Component::NONE;
+            }
+
+            static Property lookupProperty(Component component, std::string_view name)
+            {
+                switch (component)
+                {
+                case Component::TRANSFORM:
+                    if (name == "position") return Property::POSITION;
+                    if (name == "orientation") return Property::ORIENTATION;
+                    if (name == "scale") return Property::SCALE;
+                    break;
+                case Component::CAMERA:
+                    if (name == "near") return Property::NEAR_CP;
+                    if (name == "far") return Property::FAR_CP;
+                    if (name == "fovy") return Property::FOVY;
+                    if (name == "aspect ratio") return Property::ASPECT_RATIO;
+                    if (name == "exposure") return Property::EXPOSURE;
+                    break;
+                case Component::POINTLIGHT:
+                    if (name == "light colour") return Property::LIGHT_COLOUR;
+                    if (name == "light intensity") return Property::LIGHT_INTENSITY;
+                    if (name == "light radius") return Property::LIGHT_RADIUS;
+                    break;
+                case Component::AIRPLANE_PHYSICS:
+                    if (name == "velocity") return Property::VELOCITY;
+                    if (name == "acceleration") return Property::ACCELERATION;
+                    if (name == "engine thrust") return Property::ENGINE_THRUST;
+                    if (name == "mass") return Property::MASS;
+                    if (name == "wing surface") return Property::WING_SURFACE;
+                    break;
+                case Component::RENDER_JOB:
+                    if (name == "Material") return Property::MATERIAL;
+                    if (name == "Mesh") return Property::MESH;
+                    break;
+                default:
+                    break;
+                }
+                return Property::UNKNOWN;
+            }
+
+            void beginComponent()
+            {
+                m_component = lookupComponent(m_entity_key);
+
+                if (m_component != Component::NONE) {
+                    m_records.back().properties.push_back({ m_component, Property::COMPONENT, 0, {}, std::string() });
+                }
+            }
+
+            void addValue(float value)
+            {
+                // nested values of a property, e.g. [{"r":"0"},{"g":"0"},{"b":0}], are flattened in document order
+                if (m_in_entity && m_depth >= m_entity_depth + 1)
+                {
+                    if (m_value.value_cnt < m_value.values.size()) {
+                        m_value.values[m_value.value_cnt] = value;
+                    }
+                    ++m_value.value_cnt;
+                }
+            }
+
+            void completeScalar()
+            {
+                if (m_in_entity && m_depth == m_entity_depth + 1) {
+                    emitProperty();
+                }
+            }
+
+            void endContainer()
+            {
+                if (m_in_entity)
+                {
+                    if (m_depth == m_entity_depth + 2) {
+                        emitProperty();
+                    }
+                    else if (m_depth == m_entity_depth) {
+                        m_in_entity = false;
+                    }
+                }
+
+                --m_depth;
+            }
+
+            void emitProperty()
+            {
+                if (m_component != Component::NONE && m_value.property != Property::UNKNOWN)
+                {
+                    m_value.value_cnt = std::min<uint32_t>(m_value.value_cnt, static_cast<uint32_t>(m_value.values.size()));
+                    m_records.back().properties.push_back(m_value);
+                }
+
+                m_value.property = Property::UNKNOWN;
+            }
+
+            std::vector<EntityRecord>& m_records;
+
+            bool m_is_level;
+            int  m_entity_depth;
+            int  m_depth;
+
+            bool        m_in_entities;
+            bool        m_in_entity;
+            std::string m_root_key;
+            std::string m_entity_key;
+
+            Component     m_component;
+            PropertyValue m_value;
+        };
+
+        std::vector<Entity> LevelLoader::loadLevel(
+            std::string const& level_path,
+            std::string const& prefab_directory,
+            WorldState& world_state,
+            Utility::TaskScheduler& task_scheduler)
+        {
+            return instantiate(parseLevel(level_path, prefab_directory, task_scheduler), world_state, task_scheduler);
+        }
+
+        std::vector<LevelLoader::EntityDescription> LevelLoader::parseLevel(
+            std::string const& level_path,
+            std::string const& prefab_directory,
+            Utility::TaskScheduler& task_scheduler)
+        {
+            auto records = parseFile(level_path, true);
+
+            std::vector<std::string> prefab_paths(records.size());
+            std::unordered_set<std::string> unique_prefab_paths;
+
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                if (!records[i].type.empty())
+                {
+                    prefab_paths[i] = (std::filesystem::path(prefab_directory) / records[i].type).lexically_normal().generic_string();
+                    unique_prefab_paths.insert(prefab_paths[i]);
+                }
+            }
+
+            // parse all prefabs that are not cached yet in parallel
+            std::vector<std::function<void()>> prefab_jobs;
+            for (auto const& prefab_path : unique_prefab_paths)
+            {
+                prefab_jobs.push_back([this, &prefab_path]() {
+                    getPrefab(prefab_path);
+                });
+            }
+            runJobs(task_scheduler, prefab_jobs);
+
+            std::unordered_map<std::string, PrefabPtr> prefabs;
+            for (auto const& prefab_path : unique_prefab_paths) {
+                prefabs.insert({ prefab_path, getPrefab(prefab_path) });
+            }
+
+            // apply per-instance overrides
+            std::vector<EntityDescription> retval(records.size());
+
+            std::vector<std::function<void()>> resolve_jobs;
+            for (size_t batch_begin = 0; batch_begin < records.size(); batch_begin += entities_per_task)
+            {
+                size_t batch_end = std::min(batch_begin + entities_per_task, records.size());
+
+                resolve_jobs.push_back([&retval, &records, &prefab_paths, &prefabs, batch_begin, batch_end]() {
+                    for (size_t i = batch_begin; i < batch_end; ++i)
+                    {
+                        if (!prefab_paths[i].empty()) {
+                            retval[i] = *prefabs.at(prefab_paths[i]);
+                        }
+
+                        if (!records[i].name.empty()) {
+                            retval[i].name = records[i].name;
+                        }
+
+                        for (auto const& property_value : records[i].properties) {
+                            applyProperty(retval[i], property_value);
+                        }
+                    }
+                });
+            }
+            runJobs(task_scheduler, resolve_jobs);
+
+            return retval;
+        }
+
+        std::vector<Entity> LevelLoader::instantiate(
+            std::vector<EntityDescription> const& descriptions,
+            WorldState& world_state,
+            Utility::TaskScheduler& task_scheduler)
+        {
+            std::vector<Entity> entities = world_state.accessEntityManager().create(descriptions.size());
+
+            // each job adds all components of one type, so that the managers' locks are not contended
+            std::vector<std::function<void()>> jobs;
+
+            if (world_state.has<TransformComponentManager>())
+            {
+                jobs.push_back([&world_state, &descriptions, &entities]() {
+                    std::vector<Entity> transform_entities;
+                    std::vector<Vec3>   positions;
+                    std::vector<Quat>   orientations;
+                    std::vector<Vec3>   scales;
+
+                    for (size_t i = 0; i < descriptions.size(); ++i)
+                    {
+                        if (descriptions[i].has_transform)
+                        {
+                            transform_entities.push_back(entities[i]);
+                            positions.push_back(descriptions[i].position);
+                            orientations.push_back(descriptions[i].orientation);
+                            scales.push_back(descriptions[i].scale);
+                        }
+                    }
+
+                    world_state.get<TransformComponentManager>().addComponents(transform_entities, positions, orientations, scales);
+                });
+            }
+
+            if (world_state.has<NameComponentManager>())
+            {
+                jobs.push_back([&world_state, &descriptions, &entities]() {
+                    auto& name_mngr = world_state.get<NameComponentManager>();
+                    for (size_t i = 0; i < descriptions.size(); ++i)
+                    {
+                        if (!descriptions[i].name.empty()) {
+                            name_mngr.addComponent(entities[i], descriptions[i].name);
+                        }
+                    }
+                });
+            }
+
+            if (world_state.has<Graphics::CameraComponentManager>())
+            {
+                jobs.push_back([&world_state, &descriptions, &entities]() {
+                    auto& camera_mngr = world_state.get<Graphics::CameraComponentManager>();
+
+                    uint cnt = static_cast<uint>(std::count_if(descriptions.begin(), descriptions.end(),
+                        [](EntityDescription const& description) { return description.has_camera; }));
+                    camera_mngr.reserve(camera_mngr.getComponentCount() + cnt);
+
+                    for (size_t i = 0; i < descriptions.size(); ++i)
+                    {
+                        auto const& d = descriptions[i];
+                        if (d.has_camera) {
+                            camera_mngr.addComponent(entities[i], d.near_cp, d.far_cp, d.fovy, d.aspect_ratio, d.exposure);
+                        }
+                    }
+                });
+            }
+
+            if (world_state.has<Graphics::PointlightComponentManager>())
+            {
+                jobs.push_back([&world_state, &descriptions, &entities]() {
+                    auto& pointlight_mngr = world_state.get<Graphics::PointlightComponentManager>();
+
+                    uint cnt = static_cast<uint>(std::count_if(descriptions.begin(), descriptions.end(),
+                        [](EntityDescription const& description) { return description.has_pointlight; }));
+                    pointlight_mngr.reserve(pointlight_mngr.getComponentCount() + cnt);
+
+                    for (size_t i = 0; i < descriptions.size(); ++i)
+                    {
+                        auto const& d = descriptions[i];
+                        if (d.has_pointlight) {
+                            pointlight_mngr.addComponent(entities[i], d.light_colour, d.lumen, d.radius);
+                        }
+                    }
+                });
+            }
+
+            if (world_state.has<Physics::AirplanePhysicsComponentManager>())
+            {
+                jobs.push_back([&world_state, &descriptions, &entities]() {
+                    auto& airplane_mngr = world_state.get<Physics::AirplanePhysicsComponentManager>();
+
+                    uint cnt = static_cast<uint>(std::count_if(descriptions.begin(), descriptions.end(),
+                        [](EntityDescription const& description) { return description.has_airplane; }));
+                    airplane_mngr.reserve(airplane_mngr.getComponentCount() + cnt);
+
+                    for (size_t i = 0; i < descriptions.size(); ++i)
+                    {
+                        auto const& d = descriptions[i];
+                        if (d.has_airplane) {
+                            airplane_mngr.addComponent(entities[i], d.velocity, d.acceleration, d.engine_thrust, d.mass, d.wing_surface);
+                        }
+                    }
+                });
+            }
+
+            runJobs(task_scheduler, jobs);
+
+            return entities;
+        }
+
+        LevelLoader::PrefabPtr LevelLoader::getPrefab(std::string const& prefab_path)
+        {
+            {
+                std::shared_lock<std::shared_mutex> lock(m_prefabs_mutex);
+                auto query = m_prefabs.find(prefab_path);
+                if (query != m_prefabs.end())
+                    return query->second;
+            }
+
+            auto records = parseFile(prefab_path, false);
+
+            auto prefab = std::make_shared<EntityDescription>();
+            if (!records.empty())
+            {
+                for (auto const& property_value : records.front().properties) {
+                    applyProperty(*prefab, property_value);
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(m_prefabs_mutex);
+            // another thread might have parsed the same prefab in the meantime
+            return m_prefabs.insert({ prefab_path, prefab }).first->second;
+        }
+
+        void LevelLoader::clearPrefabCache()
+        {
+            std::unique_lock<std::shared_mutex> lock(m_prefabs_mutex);
+            m_prefabs.clear();
+        }
+
+        std::vector<LevelLoader::EntityRecord> LevelLoader::parseFile(std::string const& path, bool is_level)
+        {
+            auto data = Utility::ReadFileBytes(path);
+
+            std::vector<EntityRecord> records;
+            JsonHandler handler(records, is_level);
+
+            auto result = Utility::parseJson(reinterpret_cast<char const*>(data.data()), data.size(), handler);
+
+            if (!result.success) {
+                throw std::runtime_error("Failed to parse " + path + ": " + result.message + " at offset " + std::to_string(result.offset));
+            }
+
+            return records;
+        }
+
+        void LevelLoader::applyProperty(EntityDescription& description, PropertyValue const& property_value)
+        {
+            auto const& v = property_value.values;
+            uint32_t cnt = property_value.value_cnt;
+
+            switch (property_value.property)
+            {
+            case Property::COMPONENT:
+                switch (property_value.component)
+                {
+                case Component::TRANSFORM: description.has_transform = true; break;
+                case Component::CAMERA: description.has_camera = true; break;
+                case Component::POINTLIGHT: description.has_pointlight = true; break;
+                case Component::AIRPLANE_PHYSICS: description.has_airplane = true; break;
+                case Component::RENDER_JOB: description.has_render_job = true; break;
+                default: break;
+                }
+                break;
+            case Property::POSITION:
+                if (cnt >= 3) description.position = Vec3(v[0], v[1], v[2]);
+                break;
+            case Property::ORIENTATION:
+                // stored as x,y,z,w, a zero quaternion is read as identity
+                if (cnt >= 4)
+                {
+                    Quat orientation(v[3], v[0], v[1], v[2]);
+                    float length_sq = glm::dot(orientation, orientation);
+                    description.orientation = length_sq > 0.0f ? orientation / std::sqrt(length_sq) : Quat(1.0f, 0.0f, 0.0f, 0.0f);
+                }
+                break;
+            case Property::SCALE:
+                if (cnt >= 3) description.scale = Vec3(v[0], v[1], v[2]);
+                else if (cnt == 1) description.scale = Vec3(v[0]);
+                break;
+            case Property::NEAR_CP:
+                if (cnt >= 1) description.near_cp = v[0];
+                break;
+            case Property::FAR_CP:
+                if (cnt >= 1) description.far_cp = v[0];
+                break;
+            case Property::FOVY:
+                if (cnt >= 1) description.fovy = v[0];
+                break;
+            case Property::ASPECT_RATIO:
+                if (cnt >= 1) description.aspect_ratio = v[0];
+                break;
+            case Property::EXPOSURE:
+                if (cnt >= 1) description.exposure = v[0];
+                break;
+            case Property::LIGHT_COLOUR:
+                if (cnt >= 3) description.light_colour = Vec3(v[0], v[1], v[2]);
+                break;
+            case Property::LIGHT_INTENSITY:
+                if (cnt >= 1) description.lumen = v[0];
+                break;
+            case Property::LIGHT_RADIUS:
+                if (cnt >= 1) description.radius = v[0];
+                break;
+            case Property::VELOCITY:
+                if (cnt >= 3) description.velocity = Vec3(v[0], v[1], v[2]);
+                break;
+            case Property::ACCELERATION:
+                if (cnt >= 3) description.acceleration = Vec3(v[0], v[1], v[2]);
+                break;
+            case Property::ENGINE_THRUST:
+                if (cnt >= 1) description.engine_thrust = v[0];
+                break;
+            case Property::MASS:
+                if (cnt >= 1) description.mass = v[0];
+                break;
+            case Property::WING_SURFACE:
+                if (cnt >= 1) description.wing_surface = v[0];
+                break;
+            case Property::MATERIAL:
+                description.material = property_value.string_value;
+                break;
+            case Property::MESH:
+                description.mesh = property_value.string_value;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef LevelLoader_hpp
+#define LevelLoader_hpp
+
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    class WorldState;
+
+    namespace Common
+    {
+        /**
+        * \class LevelLoader
+        *
+        * \brief Creates entities from level files (e.g. resources/levels/debug_scene.json).
+        *
+        * A level lists entities as references to prefab files (e.g. resources/entities/outflyer.json) via "type",
+        * plus an optional "name" and per-instance overrides of component properties. Prefab files contain one object
+        * per component. Numbers may be given as JSON numbers or as strings.
+        *
+        * Files are parsed with the streaming JSON parser into compact property lists, prefabs are parsed once
+        * (in parallel) and cached across loads. Entities are created with a single call to the entity manager and
+        * each component type is added by its own task, using the bulk insert of the transform component manager.
+        * Component types whose manager was not added to the world are skipped.
+        */
+        class LevelLoader
+        {
+        public:
+            /**
+            * Components of a single entity, i.e. a prefab with all per-instance overrides applied
+            */
+            struct EntityDescription
+            {
+                std::string name;
+
+                bool has_transform = false;
+                Vec3 position = Vec3(0.0f);
+                Quat orientation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+                Vec3 scale = Vec3(1.0f);
+
+                bool  has_camera = false;
+                float near_cp = 0.001f;
+                float far_cp = 1000.0f;
+                float fovy = 0.5236f;
+                float aspect_ratio = 16.0f / 9.0f;
+                float exposure = 0.000036f;
+
+                bool  has_pointlight = false;
+                Vec3  light_colour = Vec3(1.0f);
+                float lumen = 100.0f;
+                float radius = 100.0f;
+
+                bool  has_airplane = false;
+                Vec3  velocity = Vec3(0.0f);
+                Vec3  acceleration = Vec3(0.0f);
+                float engine_thrust = 0.0f;
+                float mass = 1.0f;
+                float wing_surface = 1.0f;
+
+                /** Render job files, not instantiated by the loader since there are no component managers for them */
+                bool        has_render_job = false;
+                std::string material;
+                std::string mesh;
+            };
+
+            typedef std::shared_ptr<EntityDescription const> PrefabPtr;
+
+            LevelLoader() = default;
+            ~LevelLoader() = default;
+
+            LevelLoader(LevelLoader const& cpy) = delete;
+            LevelLoader& operator=(LevelLoader const& rhs) = delete;
+
+            /**
+            * \brief Parse a level file and create all of its entities and components.
+            * Throws std::runtime_error if a file can't be read or parsed.
+            * \param level_path Path of the level file
+            * \param prefab_directory Directory that prefab references ("type") are relative to
+            * \param world_state World to create entities in
+            * \param task_scheduler Scheduler used for parallel parsing and creation. Don't call this from within a task
+            * that is running on the same scheduler.
+            * \return Returns the created entities in level order
+            */
+            std::vector<Entity> loadLevel(
+                std::string const& level_path,
+                std::string const& prefab_directory,
+                WorldState& world_state,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Parse a level file and resolve all prefabs, without creating any entities
+            */
+            std::vector<EntityDescription> parseLevel(
+                std::string const& level_path,
+                std::string const& prefab_directory,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Create entities and components for the given descriptions
+            * \return Returns the created entities in the order of the descriptions
+            */
+            std::vector<Entity> instantiate(
+                std::vector<EntityDescription> const& descriptions,
+                WorldState& world_state,
+                Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Returns the parsed prefab file, parsing it only on first use. Thread-safe.
+            */
+            PrefabPtr getPrefab(std::string const& prefab_path);
+
+            void clearPrefabCache();
+
+        private:
+            enum class Component : uint8_t { NONE, TRANSFORM, CAMERA, POINTLIGHT, AIRPLANE_PHYSICS, RENDER_JOB };
+
+            enum class Property : uint8_t {
+                COMPONENT, ///< Marks the presence of a component, even without any properties
+                POSITION, ORIENTATION, SCALE,
+                NEAR_CP, FAR_CP, FOVY, ASPECT_RATIO, EXPOSURE,
+                LIGHT_COLOUR, LIGHT_INTENSITY, LIGHT_RADIUS,
+                VELOCITY, ACCELERATION, ENGINE_THRUST, MASS, WING_SURFACE,
+                MATERIAL, MESH,
+                UNKNOWN
+            };
+
+            struct PropertyValue
+            {
+                Component            component;
+                Property             property;
+                uint32_t             value_cnt;    ///< Number of numeric values, at most 4 are stored
+                std::array<float, 4> values;
+                std::string          string_value; ///< Value of non-numeric string properties
+            };
+
+            /**
+            * Parsed but unresolved entity, i.e. a prefab reference with overrides or the content of a prefab file
+            */
+            struct EntityRecord
+            {
+                std::string                type;
+                std::string                name;
+                std::vector<PropertyValue> properties;
+            };
+
+            class JsonHandler;
+
+            static std::vector<EntityRecord> parseFile(std::string const& path, bool is_level);
+
+            static void applyProperty(EntityDescription& description, PropertyValue const& property_value);
+
+            std::unordered_map<std::string, PrefabPtr> m_prefabs;
+            std::shared_mutex                          m_prefabs_mutex;
+        };
+    }
+}
+
+#endif // !LevelLoader_hpp
@@ -0,0 +1,59 @@
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+        /**
+        * \class MappedFile
+        *
+        * \brief Read-only memory mapping of a whole file. Pages are loaded by the operating system on first access,
+        * so files larger than the available memory can be read as if they were in memory.
+        */
+        class MappedFile
+        {
+        public:
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(MappedFile const& cpy) = delete;
+            MappedFile& operator=(MappedFile const& rhs) = delete;
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+            /**
+            * \brief Map the given file, a previously mapped file is unmapped first
+            * \return Returns false if the file doesn't exist, is empty or couldn't be mapped
+            */
+            bool open(std::string const& path);
+
+            void close();
+
+            bool isOpen() const { return m_data != nullptr; }
+
+            uint8_t const* data() const { return m_data; }
+
+            size_t size() const { return m_size; }
+
+            /**
+            * \brief Hint the operating system that the mapping is read front to back, e.g. for streamed playback
+            */
+            void adviseSequential() const;
+
+        private:
+            uint8_t const* m_data = nullptr;
+            size_t         m_size = 0;
+
+            void* m_file_handle = nullptr;    ///< Only used on Windows
+            void* m_mapping_handle = nullptr; ///< Only used on Windows
+        };
+    }
+}
+
+#endif // !MappedFile_hpp
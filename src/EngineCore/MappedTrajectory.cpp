@@ -0,0 +1,330 @@
+#include "MappedTrajectory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+    constexpr char     trajectory_file_magic[4] = { 'S','L','T','R' };
+    constexpr uint32_t trajectory_file_version = 1;
+
+    constexpr size_t field_name_length = 24;
+
+    /**
+    * File layout, all sections start at multiples of 8 bytes so that they can be read in place:
+    * FileHeader, FieldEntry per field, timestamps as doubles, then the column of each field.
+    * Raw columns are float arrays. Delta columns are block_cnt + 1 offsets (relative to the end of the offsets)
+    * followed by the encoded blocks.
+    */
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t field_cnt;
+        uint32_t block_size;
+        uint64_t sample_cnt;
+        uint64_t timestamps_offset;
+    };
+
+    struct FieldEntry
+    {
+        char     name[field_name_length];
+        uint32_t encoding;
+        uint32_t padding;
+        uint64_t column_offset;
+    };
+
+    static_assert(sizeof(FileHeader) == 32 && sizeof(FieldEntry) == 40, "Trajectory file layout must not contain padding");
+
+    void padTo8(std::ofstream& file)
+    {
+        char const zeros[8] = {};
+        auto position = static_cast<uint64_t>(file.tellp());
+        file.write(zeros, static_cast<std::streamsize>((8 - position % 8) % 8));
+    }
+
+    size_t computeBlockCount(size_t sample_cnt, size_t block_size)
+    {
+        return (sample_cnt + block_size - 1) / block_size;
+    }
+
+    /** Each value is XOR coded against its predecessor in the block, the byte counts of two values share a header byte */
+    void encodeBlock(float const* values, size_t cnt, std::vector<uint8_t>& data)
+    {
+        size_t header_offset = data.size();
+        data.resize(data.size() + (cnt + 1) / 2, 0);
+
+        uint32_t previous_bits = 0;
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, values + i, sizeof(uint32_t));
+            uint32_t delta = bits ^ previous_bits;
+            previous_bits = bits;
+
+            uint8_t byte_cnt = 0;
+            while (byte_cnt < 4 && (delta >> (8 * byte_cnt)) != 0) {
+                ++byte_cnt;
+            }
+
+            data[header_offset + i / 2] |= static_cast<uint8_t>(byte_cnt << (4 * (i % 2)));
+
+            for (uint8_t b = 0; b < byte_cnt; ++b) {
+                data.push_back(static_cast<uint8_t>(delta >> (8 * b)));
+            }
+        }
+    }
+
+    /** Returns false if a byte count is invalid or the payload exceeds the size of the block */
+    bool decodeBlock(uint8_t const* data, size_t size, size_t cnt, float* values)
+    {
+        size_t offset = (cnt + 1) / 2;
+        if (offset > size)
+            return false;
+
+        uint32_t bits = 0;
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            uint8_t byte_cnt = (data[i / 2] >> (4 * (i % 2))) & 0xf;
+            if (byte_cnt > 4 || offset + byte_cnt > size)
+                return false;
+
+            uint32_t delta = 0;
+            for (uint8_t b = 0; b < byte_cnt; ++b) {
+                delta |= static_cast<uint32_t>(data[offset++]) << (8 * b);
+            }
+            bits ^= delta;
+
+            std::memcpy(values + i, &bits, sizeof(uint32_t));
+        }
+
+        return true;
+    }
+}
+
+bool EngineCore::Utility::writeTrajectory(
+    std::string const& path,
+    std::vector<double> const& timestamps,
+    std::vector<TrajectoryColumn> const& columns,
+    bool delta_encode,
+    uint32_t block_size)
+{
+    size_t sample_cnt = timestamps.size();
+
+    if (block_size == 0 || !std::is_sorted(timestamps.begin(), timestamps.end()))
+        return false;
+
+    for (auto const& column : columns)
+    {
+        if (column.values.size() != sample_cnt || column.name.size() >= field_name_length)
+            return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    FileHeader header = {};
+    std::memcpy(header.magic, trajectory_file_magic, 4);
+    header.version = trajectory_file_version;
+    header.field_cnt = static_cast<uint32_t>(columns.size());
+    header.block_size = block_size;
+    header.sample_cnt = sample_cnt;
+
+    // the field table is rewritten once the column offsets are known
+    std::vector<FieldEntry> fields(columns.size(), FieldEntry{});
+    file.write(reinterpret_cast<char const*>(&header), sizeof(FileHeader));
+    file.write(reinterpret_cast<char const*>(fields.data()), fields.size() * sizeof(FieldEntry));
+
+    header.timestamps_offset = static_cast<uint64_t>(file.tellp());
+    file.write(reinterpret_cast<char const*>(timestamps.data()), sample_cnt * sizeof(double));
+
+    size_t block_cnt = computeBlockCount(sample_cnt, block_size);
+
+    for (size_t field = 0; field < columns.size(); ++field)
+    {
+        auto const& column = columns[field];
+
+        padTo8(file);
+
+        FieldEntry& entry = fields[field];
+        std::memcpy(entry.name, column.name.data(), column.name.size());
+        entry.encoding = static_cast<uint32_t>(delta_encode ? MappedTrajectory::Encoding::DELTA : MappedTrajectory::Encoding::RAW);
+        entry.column_offset = static_cast<uint64_t>(file.tellp());
+
+        if (!delta_encode)
+        {
+            file.write(reinterpret_cast<char const*>(column.values.data()), sample_cnt * sizeof(float));
+            continue;
+        }
+
+        std::vector<uint64_t> block_offsets;
+        std::vector<uint8_t> encoded_data;
+        block_offsets.reserve(block_cnt + 1);
+
+        for (size_t block = 0; block < block_cnt; ++block)
+        {
+            size_t first = block * block_size;
+            size_t cnt = std::min(static_cast<size_t>(block_size), sample_cnt - first);
+
+            block_offsets.push_back(encoded_data.size());
+            encodeBlock(column.values.data() + first, cnt, encoded_data);
+        }
+        block_offsets.push_back(encoded_data.size());
+
+        file.write(reinterpret_cast<char const*>(block_offsets.data()), block_offsets.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<char const*>(encoded_data.data()), encoded_data.size());
+    }
+
+    file.seekp(0);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(FileHeader));
+    file.write(reinterpret_cast<char const*>(fields.data()), fields.size() * sizeof(FieldEntry));
+
+    return static_cast<bool>(file);
+}
+
+bool EngineCore::Utility::MappedTrajectory::open(std::string const& path)
+{
+    m_fields.clear();
+    m_sample_cnt = 0;
+    m_block_size = 0;
+    m_timestamps = nullptr;
+
+    if (!m_file.open(path))
+        return false;
+
+    uint8_t const* data = m_file.data();
+    size_t size = m_file.size();
+
+    FileHeader header;
+    if (size < sizeof(FileHeader))
+        return false;
+    std::memcpy(&header, data, sizeof(FileHeader));
+
+    if (std::memcmp(header.magic, trajectory_file_magic, 4) != 0 || header.version != trajectory_file_version || header.block_size == 0)
+        return false;
+
+    auto fits = [size](uint64_t offset, uint64_t byte_cnt) {
+        return offset % 8 == 0 && offset <= size && byte_cnt <= size - offset;
+    };
+
+    if (!fits(sizeof(FileHeader), static_cast<uint64_t>(header.field_cnt) * sizeof(FieldEntry)) ||
+        header.sample_cnt > size / sizeof(double) ||
+        !fits(header.timestamps_offset, header.sample_cnt * sizeof(double)))
+        return false;
+
+    size_t block_cnt = computeBlockCount(static_cast<size_t>(header.sample_cnt), header.block_size);
+
+    std::vector<Field> fields(header.field_cnt);
+    for (uint32_t i = 0; i < header.field_cnt; ++i)
+    {
+        FieldEntry entry;
+        std::memcpy(&entry, data + sizeof(FileHeader) + i * sizeof(FieldEntry), sizeof(FieldEntry));
+
+        Field& field = fields[i];
+        field.name = std::string(entry.name, strnlen(entry.name, field_name_length));
+        field.encoding = static_cast<Encoding>(entry.encoding);
+        field.raw_values = nullptr;
+        field.block_offsets = nullptr;
+        field.encoded_data = nullptr;
+
+        if (field.encoding == Encoding::RAW)
+        {
+            if (!fits(entry.column_offset, header.sample_cnt * sizeof(float)))
+                return false;
+
+            field.raw_values = reinterpret_cast<float const*>(data + entry.column_offset);
+        }
+        else if (field.encoding == Encoding::DELTA)
+        {
+            uint64_t table_size = (block_cnt + 1) * sizeof(uint64_t);
+            if (!fits(entry.column_offset, table_size))
+                return false;
+
+            field.block_offsets = reinterpret_cast<uint64_t const*>(data + entry.column_offset);
+            field.encoded_data = data + entry.column_offset + table_size;
+
+            // offsets have to be ascending and within the file, each block at least holds its header bytes
+            uint64_t encoded_size = size - (entry.column_offset + table_size);
+            for (size_t block = 0; block < block_cnt; ++block)
+            {
+                size_t cnt = std::min(static_cast<size_t>(header.block_size), static_cast<size_t>(header.sample_cnt) - block * header.block_size);
+                if (field.block_offsets[block + 1] < field.block_offsets[block] + (cnt + 1) / 2 || field.block_offsets[block + 1] > encoded_size)
+                    return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    m_sample_cnt = static_cast<size_t>(header.sample_cnt);
+    m_block_size = header.block_size;
+    m_timestamps = reinterpret_cast<double const*>(data + header.timestamps_offset);
+    m_fields = std::move(fields);
+
+    return true;
+}
+
+size_t EngineCore::Utility::MappedTrajectory::findField(std::string const& name) const
+{
+    for (size_t i = 0; i < m_fields.size(); ++i)
+    {
+        if (m_fields[i].name == name)
+            return i;
+    }
+
+    return m_fields.size();
+}
+
+size_t EngineCore::Utility::MappedTrajectory::findSample(double time, size_t hint) const
+{
+    if (m_sample_cnt == 0)
+        return 0;
+
+    // forward playback stays at the hint or advances by one sample most of the time
+    for (size_t candidate = hint; candidate < std::min(hint + 2, m_sample_cnt); ++candidate)
+    {
+        if (m_timestamps[candidate] <= time && (candidate + 1 == m_sample_cnt || time < m_timestamps[candidate + 1]))
+            return candidate;
+    }
+
+    size_t upper = static_cast<size_t>(std::upper_bound(m_timestamps, m_timestamps + m_sample_cnt, time) - m_timestamps);
+
+    return upper == 0 ? 0 : upper - 1;
+}
+
+EngineCore::Utility::MappedTrajectory::Cursor::Cursor(MappedTrajectory const& trajectory)
+    : m_trajectory(&trajectory), m_blocks(trajectory.getFieldCount())
+{
+}
+
+float EngineCore::Utility::MappedTrajectory::Cursor::getValue(size_t field, size_t sample)
+{
+    Field const& f = m_trajectory->m_fields[field];
+
+    if (f.encoding == Encoding::RAW)
+        return f.raw_values[sample];
+
+    size_t block_size = m_trajectory->m_block_size;
+    size_t block = sample / block_size;
+
+    DecodedBlock& decoded = m_blocks[field];
+    if (decoded.block != block)
+    {
+        size_t cnt = std::min(block_size, m_trajectory->m_sample_cnt - block * block_size);
+        decoded.values.resize(cnt);
+        decoded.block = block;
+
+        // block bounds are validated by open, the encoded contents are not
+        size_t block_byte_size = static_cast<size_t>(f.block_offsets[block + 1] - f.block_offsets[block]);
+        if (!decodeBlock(f.encoded_data + f.block_offsets[block], block_byte_size, cnt, decoded.values.data())) {
+            std::fill(decoded.values.begin(), decoded.values.end(), std::numeric_limits<float>::quiet_NaN());
+        }
+    }
+
+    return decoded.values[sample - block * block_size];
+}
@@ -0,0 +1,133 @@
+#ifndef MappedTrajectory_hpp
+#define MappedTrajectory_hpp
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+        struct TrajectoryColumn
+        {
+            std::string        name;   ///< At most 23 characters
+            std::vector<float> values; ///< One value per sample
+        };
+
+        /**
+        * \brief Write samples to a binary trajectory file. Timestamps need to be ascending.
+        * \param delta_encode Store the columns in blocks of block_size samples, each value XOR coded against its
+        * predecessor with leading zero bytes dropped. Smaller for smooth data, but values have to be decoded.
+        * \return Returns false if the input is inconsistent or the file couldn't be written
+        */
+        bool writeTrajectory(
+            std::string const& path,
+            std::vector<double> const& timestamps,
+            std::vector<TrajectoryColumn> const& columns,
+            bool delta_encode,
+            uint32_t block_size = 256);
+
+        /**
+        * \class MappedTrajectory
+        *
+        * \brief Memory mapped binary trajectory, i.e. a time series of named float fields.
+        *
+        * The file stores the timestamps as a double array followed by one array per field (columnar layout), so that
+        * playback only touches the pages of the fields it reads. Raw columns are read in place. Delta encoded
+        * columns are decoded a block at a time by a Cursor.
+        * The trajectory is immutable after open and can be read by any number of threads, each with its own cursor.
+        */
+        class MappedTrajectory
+        {
+        public:
+            enum class Encoding : uint32_t
+            {
+                RAW = 0,
+                DELTA = 1
+            };
+
+            /**
+            * \brief Reads values of a trajectory and caches the last decoded block of each field
+            */
+            class Cursor
+            {
+            public:
+                Cursor(MappedTrajectory const& trajectory);
+
+                /**
+                * \return Returns the value of a field at a sample, NaN for all samples of a corrupt block
+                */
+                float getValue(size_t field, size_t sample);
+
+            private:
+                struct DecodedBlock
+                {
+                    size_t             block = std::numeric_limits<size_t>::max();
+                    std::vector<float> values;
+                };
+
+                MappedTrajectory const*   m_trajectory;
+                std::vector<DecodedBlock> m_blocks;
+            };
+
+            MappedTrajectory() = default;
+            ~MappedTrajectory() = default;
+
+            MappedTrajectory(MappedTrajectory const& cpy) = delete;
+            MappedTrajectory& operator=(MappedTrajectory const& rhs) = delete;
+
+            /**
+            * \brief Map a trajectory file and validate its layout
+            * \return Returns false if the file is missing, truncated or of an unsupported version
+            */
+            bool open(std::string const& path);
+
+            size_t getSampleCount() const { return m_sample_cnt; }
+
+            size_t getFieldCount() const { return m_fields.size(); }
+
+            std::string const& getFieldName(size_t field) const { return m_fields[field].name; }
+
+            /**
+            * \return Returns the index of the field with the given name or getFieldCount() if there is none
+            */
+            size_t findField(std::string const& name) const;
+
+            double getTimestamp(size_t sample) const { return m_timestamps[sample]; }
+
+            /**
+            * \brief Binary search for the last sample at or before the given time, 0 for times before the first sample.
+            * \param hint Sample found by the last search. Playback that moves forward in time usually stays at the hint
+            * or moves to the next sample, which is checked before searching.
+            */
+            size_t findSample(double time, size_t hint = 0) const;
+
+            /**
+            * \brief Hint the operating system that the trajectory is played back from front to back
+            */
+            void adviseSequential() const { m_file.adviseSequential(); }
+
+        private:
+            struct Field
+            {
+                std::string     name;
+                Encoding        encoding;
+                float const*    raw_values;    ///< Raw columns
+                uint64_t const* block_offsets; ///< Delta columns, block_cnt + 1 offsets relative to encoded_data
+                uint8_t const*  encoded_data;  ///< Delta columns
+            };
+
+            MappedFile         m_file;
+            size_t             m_sample_cnt = 0;
+            size_t             m_block_size = 0;
+            double const*      m_timestamps = nullptr;
+            std::vector<Field> m_fields;
+        };
+    }
+}
+
+#endif // !MappedTrajectory_hpp
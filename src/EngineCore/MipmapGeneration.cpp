@@ -0,0 +1,418 @@
+#include "MipmapGeneration.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPMAP_GENERATION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        namespace
+        {
+            /** Kaiser filter parameters, half width given in target texels */
+            constexpr float kaiser_width = 3.0f;
+            constexpr float kaiser_alpha = 4.0f;
+
+            float besselI0(float x)
+            {
+                // power series, converges quickly for the small arguments used here
+                float sum = 1.0f;
+                float term = 1.0f;
+                float half_x_sq = (x * 0.5f) * (x * 0.5f);
+                for (int k = 1; k < 32; ++k)
+                {
+                    term *= half_x_sq / static_cast<float>(k * k);
+                    sum += term;
+                    if (term < sum * 1.0e-8f) break;
+                }
+                return sum;
+            }
+
+            float sinc(float x)
+            {
+                if (std::abs(x) < 1.0e-5f) return 1.0f;
+                float pi_x = 3.14159265358979f * x;
+                return std::sin(pi_x) / pi_x;
+            }
+
+            float kaiser(float x)
+            {
+                if (std::abs(x) >= 1.0f) return 0.0f;
+                return besselI0(kaiser_alpha * std::sqrt(1.0f - x * x)) / besselI0(kaiser_alpha);
+            }
+
+            /**
+            * Filter taps for one target texel, i.e. first source texel and normalized weights
+            */
+            struct FilterTaps
+            {
+                int                first;
+                std::vector<float> weights;
+            };
+
+            std::vector<FilterTaps> computeKaiserTaps(int src_size, int tgt_size)
+            {
+                std::vector<FilterTaps> retval(tgt_size);
+
+                float scale = static_cast<float>(src_size) / static_cast<float>(tgt_size);
+                float support = kaiser_width * scale;
+
+                for (int i = 0; i < tgt_size; ++i)
+                {
+                    float center = (static_cast<float>(i) + 0.5f) * scale;
+                    int first = static_cast<int>(std::floor(center - support));
+                    int last = static_cast<int>(std::ceil(center + support));
+
+                    retval[i].first = first;
+                    retval[i].weights.resize(last - first + 1);
+
+                    float weight_sum = 0.0f;
+                    for (int j = first; j <= last; ++j)
+                    {
+                        float d = (static_cast<float>(j) + 0.5f - center) / scale;
+                        float w = sinc(d) * kaiser(d / kaiser_width);
+                        retval[i].weights[j - first] = w;
+                        weight_sum += w;
+                    }
+
+                    for (auto& w : retval[i].weights) {
+                        w /= weight_sum;
+                    }
+                }
+
+                return retval;
+            }
+
+            /**
+            * Apply 1D filter taps along one axis of an RGBA float image.
+            * \param src_stride Distance between neighbouring texels along the filtered axis (in texels)
+            * \param line_stride Distance between lines orthogonal to the filtered axis (in texels)
+            */
+            void applyTaps(
+                float const* src,
+                int src_size,
+                int src_stride,
+                int src_line_stride,
+                int line_cnt,
+                std::vector<FilterTaps> const& taps,
+                float* tgt,
+                int tgt_stride,
+                int tgt_line_stride)
+            {
+                for (int line = 0; line < line_cnt; ++line)
+                {
+                    float const* src_line = src + static_cast<size_t>(line) * src_line_stride * 4;
+                    float* tgt_line = tgt + static_cast<size_t>(line) * tgt_line_stride * 4;
+
+                    for (size_t i = 0; i < taps.size(); ++i)
+                    {
+#ifdef MIPMAP_GENERATION_SSE2
+                        __m128 acc = _mm_setzero_ps();
+                        for (size_t j = 0; j < taps[i].weights.size(); ++j)
+                        {
+                            int src_idx = std::clamp(taps[i].first + static_cast<int>(j), 0, src_size - 1);
+                            __m128 texel = _mm_loadu_ps(src_line + static_cast<size_t>(src_idx) * src_stride * 4);
+                            acc = _mm_add_ps(acc, _mm_mul_ps(texel, _mm_set1_ps(taps[i].weights[j])));
+                        }
+                        _mm_storeu_ps(tgt_line + i * tgt_stride * 4, acc);
+#else
+                        float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                        for (size_t j = 0; j < taps[i].weights.size(); ++j)
+                        {
+                            int src_idx = std::clamp(taps[i].first + static_cast<int>(j), 0, src_size - 1);
+                            float const* texel = src_line + static_cast<size_t>(src_idx) * src_stride * 4;
+                            for (int c = 0; c < 4; ++c) {
+                                acc[c] += texel[c] * taps[i].weights[j];
+                            }
+                        }
+                        std::copy_n(acc, 4, tgt_line + i * tgt_stride * 4);
+#endif
+                    }
+                }
+            }
+
+            /**
+            * Box filter taps of one target texel. Odd source sizes use three taps per target texel, weighted so that
+            * every source texel contributes equally to the level, e.g. 5 -> 2 uses (2,2,1)/5 and (1,2,2)/5.
+            */
+            struct BoxTaps
+            {
+                int   first;
+                int   cnt;
+                float weights[3];
+            };
+
+            std::vector<BoxTaps> computeBoxTaps(int src_size)
+            {
+                int tgt_size = std::max(1, src_size / 2);
+                std::vector<BoxTaps> retval(tgt_size);
+
+                for (int i = 0; i < tgt_size; ++i)
+                {
+                    if (src_size == 1)
+                    {
+                        retval[i] = { 0, 1, { 1.0f, 0.0f, 0.0f } };
+                    }
+                    else if (src_size % 2 == 0)
+                    {
+                        retval[i] = { 2 * i, 2, { 0.5f, 0.5f, 0.0f } };
+                    }
+                    else
+                    {
+                        float n = static_cast<float>(tgt_size);
+                        float norm = 1.0f / (2.0f * n + 1.0f);
+                        retval[i] = { 2 * i, 3, { (n - static_cast<float>(i)) * norm, n * norm, (static_cast<float>(i) + 1.0f) * norm } };
+                    }
+                }
+
+                return retval;
+            }
+
+            /** Colour channels of sRGB data, i.e. all channels except for the alpha channel of RGBA data */
+            int computeColourChannelCount(int channel_cnt)
+            {
+                return channel_cnt == 4 ? 3 : channel_cnt;
+            }
+
+            /** Linear values in [0,1] for all 8bit sRGB values */
+            float const* getSrgbToLinearTable()
+            {
+                static float const* table = []() {
+                    static float values[256];
+                    for (int i = 0; i < 256; ++i)
+                    {
+                        float c = static_cast<float>(i) / 255.0f;
+                        values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                    }
+                    return values;
+                }();
+
+                return table;
+            }
+
+            uint8_t linearToSrgb(float value)
+            {
+                value = std::clamp(value, 0.0f, 1.0f);
+                float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                return static_cast<uint8_t>(c * 255.0f + 0.5f);
+            }
+        }
+
+        uint32_t computeMipLevelCount(int width, int height)
+        {
+            uint32_t retval = 1;
+            int size = std::max(width, height);
+            while (size > 1)
+            {
+                size /= 2;
+                ++retval;
+            }
+            return retval;
+        }
+
+        int computeChannelCount(GenericTextureLayout const& layout)
+        {
+            if (layout.type != 0x1401 /*GL_UNSIGNED_BYTE*/)
+                return 0;
+
+            switch (layout.format)
+            {
+            case 0x1903: /*GL_RED*/
+                return 1;
+            case 0x8227: /*GL_RG*/
+                return 2;
+            case 0x1907: /*GL_RGB*/
+                return 3;
+            case 0x1908: /*GL_RGBA*/
+                return 4;
+            default:
+                return 0;
+            }
+        }
+
+        void downsampleBox(uint8_t const* src, int src_width, int src_height, int channel_cnt, uint8_t* tgt, bool srgb)
+        {
+            int tgt_width = std::max(1, src_width / 2);
+            int tgt_height = std::max(1, src_height / 2);
+
+            size_t src_row_size = static_cast<size_t>(src_width) * channel_cnt;
+            size_t tgt_row_size = static_cast<size_t>(tgt_width) * channel_cnt;
+
+#ifdef MIPMAP_GENERATION_SSE2
+            if (channel_cnt == 4 && !srgb && src_width % 2 == 0 && src_height % 2 == 0)
+            {
+                __m128i const zero = _mm_setzero_si128();
+                __m128i const rounding = _mm_set1_epi16(2);
+
+                for (int y = 0; y < tgt_height; ++y)
+                {
+                    uint8_t const* src_row_0 = src + static_cast<size_t>(2 * y) * src_row_size;
+                    uint8_t const* src_row_1 = src + static_cast<size_t>(2 * y + 1) * src_row_size;
+                    uint8_t* tgt_row = tgt + static_cast<size_t>(y) * tgt_row_size;
+
+                    int x = 0;
+
+                    // two target texels per iteration, i.e. four source texels from each row
+                    for (; x + 1 < tgt_width; x += 2)
+                    {
+                        __m128i r0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src_row_0 + static_cast<size_t>(x) * 8));
+                        __m128i r1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src_row_1 + static_cast<size_t>(x) * 8));
+
+                        // vertical sum, 16bit per channel
+                        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+                        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+
+                        // horizontal sum of neighbouring texels
+                        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+                        __m128i sum = _mm_unpacklo_epi64(lo, hi);
+                        sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(tgt_row + static_cast<size_t>(x) * 4), _mm_packus_epi16(sum, sum));
+                    }
+
+                    for (; x < tgt_width; ++x)
+                    {
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            unsigned int sum =
+                                src_row_0[static_cast<size_t>(x) * 8 + c] + src_row_0[static_cast<size_t>(x) * 8 + 4 + c] +
+                                src_row_1[static_cast<size_t>(x) * 8 + c] + src_row_1[static_cast<size_t>(x) * 8 + 4 + c];
+                            tgt_row[static_cast<size_t>(x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                        }
+                    }
+                }
+
+                return;
+            }
+#endif
+
+            auto horizontal_taps = computeBoxTaps(src_width);
+            auto vertical_taps = computeBoxTaps(src_height);
+
+            int colour_channel_cnt = srgb ? computeColourChannelCount(channel_cnt) : 0;
+            float const* srgb_to_linear = getSrgbToLinearTable();
+
+            for (int y = 0; y < tgt_height; ++y)
+            {
+                BoxTaps const& taps_y = vertical_taps[y];
+                uint8_t* tgt_row = tgt + static_cast<size_t>(y) * tgt_row_size;
+
+                for (int x = 0; x < tgt_width; ++x)
+                {
+                    BoxTaps const& taps_x = horizontal_taps[x];
+
+                    for (int c = 0; c < channel_cnt; ++c)
+                    {
+                        bool linearize = c < colour_channel_cnt;
+                        float acc = 0.0f;
+
+                        for (int j = 0; j < taps_y.cnt; ++j)
+                        {
+                            uint8_t const* src_row = src + static_cast<size_t>(taps_y.first + j) * src_row_size;
+
+                            for (int i = 0; i < taps_x.cnt; ++i)
+                            {
+                                uint8_t value = src_row[static_cast<size_t>(taps_x.first + i) * channel_cnt + c];
+                                acc += taps_y.weights[j] * taps_x.weights[i] * (linearize ? srgb_to_linear[value] : static_cast<float>(value));
+                            }
+                        }
+
+                        tgt_row[static_cast<size_t>(x) * channel_cnt + c] = linearize ? linearToSrgb(acc) : static_cast<uint8_t>(acc + 0.5f);
+                    }
+                }
+            }
+        }
+
+        void downsampleKaiser(float const* src, int src_width, int src_height, float* tgt)
+        {
+            int tgt_width = std::max(1, src_width / 2);
+            int tgt_height = std::max(1, src_height / 2);
+
+            auto horizontal_taps = computeKaiserTaps(src_width, tgt_width);
+            auto vertical_taps = computeKaiserTaps(src_height, tgt_height);
+
+            // horizontal pass over all source rows, then vertical pass over all target columns
+            std::vector<float> tmp(static_cast<size_t>(tgt_width) * src_height * 4);
+
+            applyTaps(src, src_width, 1, src_width, src_height, horizontal_taps, tmp.data(), 1, tgt_width);
+            applyTaps(tmp.data(), src_height, tgt_width, 1, tgt_width, vertical_taps, tgt, tgt_width, 1);
+        }
+
+        void generateMipChain(TextureMipChain& mip_chain, MipFilter filter, bool srgb)
+        {
+            int channel_cnt = computeChannelCount(mip_chain.layout);
+
+            if (channel_cnt == 0 || mip_chain.levels.empty())
+                return;
+
+            int width = mip_chain.layout.width;
+            int height = mip_chain.layout.height;
+            uint32_t level_cnt = computeMipLevelCount(width, height);
+
+            mip_chain.levels.resize(level_cnt);
+            mip_chain.layout.levels = level_cnt;
+
+            if (filter == MipFilter::BOX)
+            {
+                for (uint32_t level = 1; level < level_cnt; ++level)
+                {
+                    int tgt_width = std::max(1, width / 2);
+                    int tgt_height = std::max(1, height / 2);
+
+                    mip_chain.levels[level].resize(static_cast<size_t>(tgt_width) * tgt_height * channel_cnt);
+                    downsampleBox(mip_chain.levels[level - 1].data(), width, height, channel_cnt, mip_chain.levels[level].data(), srgb);
+
+                    width = tgt_width;
+                    height = tgt_height;
+                }
+            }
+            else
+            {
+                // filter in float RGBA and keep the float chain around to avoid accumulating quantization errors
+                int colour_channel_cnt = srgb ? computeColourChannelCount(channel_cnt) : 0;
+                float const* srgb_to_linear = getSrgbToLinearTable();
+
+                std::vector<float> src(static_cast<size_t>(width) * height * 4, 1.0f);
+                for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+                {
+                    for (int c = 0; c < channel_cnt; ++c) {
+                        uint8_t value = mip_chain.levels[0][i * channel_cnt + c];
+                        src[i * 4 + c] = c < colour_channel_cnt ? srgb_to_linear[value] : static_cast<float>(value) / 255.0f;
+                    }
+                }
+
+                std::vector<float> tgt;
+
+                for (uint32_t level = 1; level < level_cnt; ++level)
+                {
+                    int tgt_width = std::max(1, width / 2);
+                    int tgt_height = std::max(1, height / 2);
+                    size_t tgt_texel_cnt = static_cast<size_t>(tgt_width) * tgt_height;
+
+                    tgt.resize(tgt_texel_cnt * 4);
+                    downsampleKaiser(src.data(), width, height, tgt.data());
+
+                    mip_chain.levels[level].resize(tgt_texel_cnt * channel_cnt);
+                    for (size_t i = 0; i < tgt_texel_cnt; ++i)
+                    {
+                        for (int c = 0; c < channel_cnt; ++c) {
+                            float v = std::clamp(tgt[i * 4 + c], 0.0f, 1.0f);
+                            mip_chain.levels[level][i * channel_cnt + c] = c < colour_channel_cnt ? linearToSrgb(v) : static_cast<uint8_t>(v * 255.0f + 0.5f);
+                        }
+                    }
+
+                    std::swap(src, tgt);
+                    width = tgt_width;
+                    height = tgt_height;
+                }
+            }
+        }
+    }
+}
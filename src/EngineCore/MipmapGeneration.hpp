@@ -0,0 +1,68 @@
+#ifndef MipmapGeneration_hpp
+#define MipmapGeneration_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "GenericTextureLayout.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \brief CPU-side texture data including all mip levels.
+        * Level 0 is the full resolution image, each following level halves width and height (clamped to 1).
+        */
+        struct TextureMipChain
+        {
+            GenericTextureLayout              layout; ///< Layout of level 0, levels equals the number of stored levels
+            std::vector<std::vector<uint8_t>> levels; ///< Texel data per mip level, tightly packed
+        };
+
+        enum class MipFilter { BOX, KAISER };
+
+        /**
+        * \brief Compute the number of mip levels of a full mip chain for the given base level size
+        */
+        uint32_t computeMipLevelCount(int width, int height);
+
+        /**
+        * \brief Returns the number of 8bit channels of a texel for the given texture layout, or 0 if unsupported
+        */
+        int computeChannelCount(GenericTextureLayout const& layout);
+
+        /**
+        * \brief Build the full mip chain on the CPU, starting from the data in mip_chain.levels[0].
+        * Supports 8bit unsigned normalized data with 1 to 4 channels. Previously stored levels beyond
+        * level 0 are discarded and mip_chain.layout.levels is updated accordingly.
+        * \param mip_chain Texture data with valid layout and level 0
+        * \param filter Downsampling filter, either a box filter or a (wider but sharper) Kaiser-windowed sinc
+        * \param srgb Set for sRGB encoded colour data, colour channels are filtered in linear space. Alpha stays linear.
+        */
+        void generateMipChain(TextureMipChain& mip_chain, MipFilter filter = MipFilter::BOX, bool srgb = false);
+
+        /**
+        * \brief Downsample one level using a 2x2 box filter, widened to 3 texels along odd sized axes so that the last
+        * row and column are not dropped. Uses SSE2 for 4 channel linear data with even sizes if available.
+        */
+        void downsampleBox(
+            uint8_t const* src,
+            int src_width,
+            int src_height,
+            int channel_cnt,
+            uint8_t* tgt,
+            bool srgb = false);
+
+        /**
+        * \brief Downsample one level of RGBA float data using a separable Kaiser-windowed sinc filter.
+        */
+        void downsampleKaiser(
+            float const* src,
+            int src_width,
+            int src_height,
+            float* tgt);
+    }
+}
+
+#endif // !MipmapGeneration_hpp
@@ -0,0 +1,1224 @@
+#include "Narrowphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SimdFloat.hpp"
+
+using EngineCore::Physics::NarrowphaseContact;
+using EngineCore::Physics::NarrowphaseManifold;
+using EngineCore::Physics::OrientedBox;
+using EngineCore::Physics::SoAAxialShapes;
+using EngineCore::Physics::SoABoxes;
+using EngineCore::Physics::SoASpheres;
+using EngineCore::Physics::SoAVec3;
+
+namespace
+{
+    /** Edge axes of nearly parallel edges are skipped, they are covered by the face axes */
+    constexpr float parallel_edge_epsilon = 1.0e-5f;
+
+    /** Ternary search steps along capsule segments, shrinks the search interval to below 1e-4 of the segment */
+    constexpr int capsule_box_iterations = 24;
+
+    inline Vec3 getVec3(SoAVec3 const& v, size_t i)
+    {
+        return Vec3(v.x[i], v.y[i], v.z[i]);
+    }
+
+    inline OrientedBox getBox(SoABoxes const& boxes, size_t i)
+    {
+        return { getVec3(boxes.center, i), { getVec3(boxes.axes[0], i), getVec3(boxes.axes[1], i), getVec3(boxes.axes[2], i) }, getVec3(boxes.extents, i) };
+    }
+
+    /** Unit vector perpendicular to the given unit vector */
+    Vec3 computePerpendicular(Vec3 const& v)
+    {
+        if (std::abs(v.x) >= 0.57735f) {
+            return glm::normalize(Vec3(v.y, -v.x, 0.0f));
+        }
+        return glm::normalize(Vec3(0.0f, v.z, -v.y));
+    }
+
+    void collideSpheres(Vec3 const& center_a, float radius_a, Vec3 const& center_b, float radius_b, float margin, NarrowphaseManifold& result)
+    {
+        result.contact_cnt = 0;
+
+        Vec3 d = center_b - center_a;
+        float distance_sq = glm::dot(d, d);
+        float radius = radius_a + radius_b;
+
+        if (distance_sq > (radius + margin) * (radius + margin))
+            return;
+
+        float distance = std::sqrt(distance_sq);
+
+        result.normal = distance > 0.0f ? d / distance : Vec3(0.0f, 1.0f, 0.0f);
+        result.contact_cnt = 1;
+        result.contacts[0].point = center_a + result.normal * (radius_a - 0.5f * (radius - distance));
+        result.contacts[0].penetration = radius - distance;
+    }
+
+    void collideSphereBox(Vec3 const& center, float radius, OrientedBox const& box, float margin, NarrowphaseManifold& result)
+    {
+        result.contact_cnt = 0;
+
+        Vec3 d = center - box.center;
+        Vec3 local(glm::dot(d, box.axes[0]), glm::dot(d, box.axes[1]), glm::dot(d, box.axes[2]));
+
+        bool inside = std::abs(local.x) <= box.extents.x && std::abs(local.y) <= box.extents.y && std::abs(local.z) <= box.extents.z;
+
+        if (inside)
+        {
+            // push out through the closest face
+            int axis = 0;
+            float face_distance = box.extents[0] - std::abs(local[0]);
+            for (int k = 1; k < 3; ++k)
+            {
+                if (box.extents[k] - std::abs(local[k]) < face_distance)
+                {
+                    axis = k;
+                    face_distance = box.extents[k] - std::abs(local[k]);
+                }
+            }
+
+            Vec3 outwards = local[axis] >= 0.0f ? box.axes[axis] : -box.axes[axis];
+            result.normal = -outwards;
+            result.contact_cnt = 1;
+            result.contacts[0].point = center + outwards * face_distance;
+            result.contacts[0].penetration = radius + face_distance;
+            return;
+        }
+
+        Vec3 closest = box.center;
+        for (int k = 0; k < 3; ++k) {
+            closest += box.axes[k] * std::min(box.extents[k], std::max(-box.extents[k], local[k]));
+        }
+
+        Vec3 offset = center - closest;
+        float distance_sq = glm::dot(offset, offset);
+
+        if (distance_sq > (radius + margin) * (radius + margin))
+            return;
+
+        float distance = std::sqrt(distance_sq);
+
+        result.normal = -(offset / distance);
+        result.contact_cnt = 1;
+        result.contacts[0].point = closest;
+        result.contacts[0].penetration = radius - distance;
+    }
+
+    /** Returns the overlap of the projections of both boxes on the axis, negative if separated */
+    float computeOverlap(OrientedBox const& a, OrientedBox const& b, Vec3 const& d, Vec3 const& axis)
+    {
+        float radius_a = 0.0f;
+        float radius_b = 0.0f;
+        for (int k = 0; k < 3; ++k)
+        {
+            radius_a += a.extents[k] * std::abs(glm::dot(a.axes[k], axis));
+            radius_b += b.extents[k] * std::abs(glm::dot(b.axes[k], axis));
+        }
+
+        return radius_a + radius_b - std::abs(glm::dot(d, axis));
+    }
+
+    /** Smallest overlaps of the separating axis test, per axis group */
+    struct BoxSeparation
+    {
+        float overlap_a = std::numeric_limits<float>::max();
+        float overlap_b = std::numeric_limits<float>::max();
+        float overlap_edge = std::numeric_limits<float>::max();
+        int   axis_a = 0;
+        int   axis_b = 0;
+        int   edge_a = 0;
+        int   edge_b = 0;
+        Vec3  edge_axis;
+    };
+
+    /** Separating axis test, returns false if the boxes are separated by more than the margin */
+    bool findBoxSeparation(OrientedBox const& a, OrientedBox const& b, float margin, BoxSeparation& separation)
+    {
+        Vec3 d = b.center - a.center;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            float overlap = computeOverlap(a, b, d, a.axes[k]);
+            if (overlap < -margin)
+                return false;
+            if (overlap < separation.overlap_a)
+            {
+                separation.overlap_a = overlap;
+                separation.axis_a = k;
+            }
+
+            overlap = computeOverlap(a, b, d, b.axes[k]);
+            if (overlap < -margin)
+                return false;
+            if (overlap < separation.overlap_b)
+            {
+                separation.overlap_b = overlap;
+                separation.axis_b = k;
+            }
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                Vec3 axis = glm::cross(a.axes[i], b.axes[j]);
+                float length = glm::length(axis);
+
+                if (length < parallel_edge_epsilon)
+                    continue;
+
+                axis /= length;
+
+                float overlap = computeOverlap(a, b, d, axis);
+                if (overlap < -margin)
+                    return false;
+                if (overlap < separation.overlap_edge)
+                {
+                    separation.overlap_edge = overlap;
+                    separation.edge_a = i;
+                    separation.edge_b = j;
+                    separation.edge_axis = axis;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /** Sutherland-Hodgman clipping of a polygon against the half space dot(normal, p) <= offset */
+    uint32_t clipPolygon(Vec3 const* polygon, uint32_t vertex_cnt, Vec3 const& normal, float offset, Vec3* result)
+    {
+        uint32_t result_cnt = 0;
+
+        for (uint32_t i = 0; i < vertex_cnt; ++i)
+        {
+            Vec3 const& p = polygon[i];
+            Vec3 const& q = polygon[(i + 1) % vertex_cnt];
+            float distance_p = glm::dot(normal, p) - offset;
+            float distance_q = glm::dot(normal, q) - offset;
+
+            if (distance_p <= 0.0f) {
+                result[result_cnt++] = p;
+            }
+
+            if ((distance_p < 0.0f && distance_q > 0.0f) || (distance_p > 0.0f && distance_q < 0.0f)) {
+                result[result_cnt++] = p + (q - p) * (distance_p / (distance_p - distance_q));
+            }
+        }
+
+        return result_cnt;
+    }
+
+    /** Keep the deepest contact and the three contacts that span the largest area with it */
+    void reduceContacts(NarrowphaseContact const* candidates, uint32_t candidate_cnt, Vec3 const& normal, NarrowphaseManifold& result)
+    {
+        if (candidate_cnt <= 4)
+        {
+            std::copy(candidates, candidates + candidate_cnt, result.contacts);
+            result.contact_cnt = candidate_cnt;
+            return;
+        }
+
+        uint32_t selected[4] = { 0, 0, 0, 0 };
+        float best = -1.0f;
+
+        for (uint32_t i = 0; i < candidate_cnt; ++i)
+        {
+            if (candidates[i].penetration > best)
+            {
+                best = candidates[i].penetration;
+                selected[0] = i;
+            }
+        }
+
+        Vec3 const& p0 = candidates[selected[0]].point;
+
+        best = -1.0f;
+        for (uint32_t i = 0; i < candidate_cnt; ++i)
+        {
+            Vec3 d = candidates[i].point - p0;
+            if (glm::dot(d, d) > best)
+            {
+                best = glm::dot(d, d);
+                selected[1] = i;
+            }
+        }
+
+        Vec3 edge = candidates[selected[1]].point - p0;
+
+        // largest triangle on either side of the first edge
+        float best_positive = 0.0f;
+        float best_negative = 0.0f;
+        selected[2] = selected[0];
+        selected[3] = selected[0];
+        for (uint32_t i = 0; i < candidate_cnt; ++i)
+        {
+            float area = glm::dot(glm::cross(edge, candidates[i].point - p0), normal);
+            if (area > best_positive)
+            {
+                best_positive = area;
+                selected[2] = i;
+            }
+            if (area < best_negative)
+            {
+                best_negative = area;
+                selected[3] = i;
+            }
+        }
+
+        result.contact_cnt = 0;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            bool duplicate = false;
+            for (uint32_t j = 0; j < i; ++j) {
+                duplicate |= selected[j] == selected[i];
+            }
+
+            if (!duplicate) {
+                result.contacts[result.contact_cnt++] = candidates[selected[i]];
+            }
+        }
+    }
+
+    /** Face clipping for face contacts and closest points for edge contacts, after the separating axis test */
+    void clipBoxes(OrientedBox const& a, OrientedBox const& b, BoxSeparation const& separation, float margin, NarrowphaseManifold& result)
+    {
+        result.contact_cnt = 0;
+
+        Vec3 d = b.center - a.center;
+
+        float overlap_face = std::min(separation.overlap_a, separation.overlap_b);
+
+        // face contacts give stable manifolds, so edge contacts need to be clearly better
+        if (separation.overlap_edge < 0.95f * overlap_face - 0.01f)
+        {
+            Vec3 normal = glm::dot(separation.edge_axis, d) < 0.0f ? -separation.edge_axis : separation.edge_axis;
+
+            // supporting edges of both boxes along the normal
+            Vec3 point_a = a.center;
+            Vec3 point_b = b.center;
+            for (int k = 0; k < 3; ++k)
+            {
+                if (k != separation.edge_a) {
+                    point_a += a.axes[k] * (glm::dot(a.axes[k], normal) > 0.0f ? a.extents[k] : -a.extents[k]);
+                }
+                if (k != separation.edge_b) {
+                    point_b += b.axes[k] * (glm::dot(b.axes[k], normal) > 0.0f ? -b.extents[k] : b.extents[k]);
+                }
+            }
+
+            // closest points of both edges
+            Vec3 const& dir_a = a.axes[separation.edge_a];
+            Vec3 const& dir_b = b.axes[separation.edge_b];
+            Vec3 r = point_a - point_b;
+            float cos_angle = glm::dot(dir_a, dir_b);
+            float c = glm::dot(dir_a, r);
+            float f = glm::dot(dir_b, r);
+            float denom = std::max(1.0e-6f, 1.0f - cos_angle * cos_angle);
+            float s = std::min(a.extents[separation.edge_a], std::max(-a.extents[separation.edge_a], (cos_angle * f - c) / denom));
+            float t = std::min(b.extents[separation.edge_b], std::max(-b.extents[separation.edge_b], (f - cos_angle * c) / denom));
+
+            result.normal = normal;
+            result.contact_cnt = 1;
+            result.contacts[0].point = 0.5f * (point_a + dir_a * s + point_b + dir_b * t);
+            result.contacts[0].penetration = separation.overlap_edge;
+            return;
+        }
+
+        // slightly prefer a as reference so that the reference box does not flip between updates
+        bool reference_is_a = !(separation.overlap_b < 0.95f * separation.overlap_a - 0.005f);
+
+        OrientedBox const& reference = reference_is_a ? a : b;
+        OrientedBox const& incident = reference_is_a ? b : a;
+        int reference_axis = reference_is_a ? separation.axis_a : separation.axis_b;
+
+        // reference face normal pointing towards the incident box
+        Vec3 normal = reference.axes[reference_axis];
+        if (glm::dot(normal, incident.center - reference.center) < 0.0f) {
+            normal = -normal;
+        }
+
+        // incident face is the face most anti-parallel to the reference normal
+        int incident_axis = 0;
+        float best_alignment = -1.0f;
+        for (int k = 0; k < 3; ++k)
+        {
+            float alignment = std::abs(glm::dot(incident.axes[k], normal));
+            if (alignment > best_alignment)
+            {
+                best_alignment = alignment;
+                incident_axis = k;
+            }
+        }
+
+        float face_sign = glm::dot(incident.axes[incident_axis], normal) > 0.0f ? -1.0f : 1.0f;
+        Vec3 face_center = incident.center + incident.axes[incident_axis] * (face_sign * incident.extents[incident_axis]);
+        Vec3 u = incident.axes[(incident_axis + 1) % 3] * incident.extents[(incident_axis + 1) % 3];
+        Vec3 v = incident.axes[(incident_axis + 2) % 3] * incident.extents[(incident_axis + 2) % 3];
+
+        Vec3 polygon[16] = { face_center + u + v, face_center - u + v, face_center - u - v, face_center + u - v };
+        Vec3 clipped[16];
+        uint32_t vertex_cnt = 4;
+
+        // clip against the side planes of the reference face
+        for (int side = 1; side < 3; ++side)
+        {
+            int k = (reference_axis + side) % 3;
+            Vec3 const& axis = reference.axes[k];
+            float center_offset = glm::dot(axis, reference.center);
+
+            vertex_cnt = clipPolygon(polygon, vertex_cnt, axis, center_offset + reference.extents[k], clipped);
+            vertex_cnt = clipPolygon(clipped, vertex_cnt, -axis, -center_offset + reference.extents[k], polygon);
+        }
+
+        Vec3 face_point = reference.center + normal * reference.extents[reference_axis];
+
+        NarrowphaseContact candidates[16];
+        uint32_t candidate_cnt = 0;
+        for (uint32_t i = 0; i < vertex_cnt; ++i)
+        {
+            float depth = glm::dot(normal, face_point - polygon[i]);
+            if (depth >= -margin)
+            {
+                candidates[candidate_cnt].point = polygon[i] + normal * (0.5f * depth);
+                candidates[candidate_cnt].penetration = depth;
+                ++candidate_cnt;
+            }
+        }
+
+        reduceContacts(candidates, candidate_cnt, normal, result);
+        result.normal = reference_is_a ? normal : -normal;
+    }
+
+    void collideBoxes(OrientedBox const& a, OrientedBox const& b, float margin, NarrowphaseManifold& result)
+    {
+        result.contact_cnt = 0;
+
+        BoxSeparation separation;
+        if (findBoxSeparation(a, b, margin, separation)) {
+            clipBoxes(a, b, separation, margin, result);
+        }
+    }
+
+    /** Closest points of two axis segments, clamp s, project onto b, clamp t and project back onto a */
+    void computeClosestSegmentPoints(
+        Vec3 const& center_a, Vec3 const& axis_a, float half_height_a,
+        Vec3 const& center_b, Vec3 const& axis_b, float half_height_b,
+        float& s, float& t)
+    {
+        Vec3 r = center_a - center_b;
+        float cos_angle = glm::dot(axis_a, axis_b);
+        float c = glm::dot(axis_a, r);
+        float f = glm::dot(axis_b, r);
+        float denom = 1.0f - cos_angle * cos_angle;
+
+        s = denom > 1.0e-6f ? std::min(half_height_a, std::max(-half_height_a, (cos_angle * f - c) / denom)) : 0.0f;
+        t = std::min(half_height_b, std::max(-half_height_b, cos_angle * s + f));
+        s = std::min(half_height_a, std::max(-half_height_a, cos_angle * t - c));
+    }
+
+    void collideCapsules(
+        Vec3 const& center_a, Vec3 const& axis_a, float half_height_a, float radius_a,
+        Vec3 const& center_b, Vec3 const& axis_b, float half_height_b, float radius_b,
+        float margin,
+        NarrowphaseManifold& result)
+    {
+        float s, t;
+        computeClosestSegmentPoints(center_a, axis_a, half_height_a, center_b, axis_b, half_height_b, s, t);
+
+        collideSpheres(center_a + axis_a * s, radius_a, center_b + axis_b * t, radius_b, margin, result);
+    }
+
+    void collideSphereCylinder(Vec3 const& center, float radius, Vec3 const& cylinder_center, Vec3 const& axis, float half_height, float cylinder_radius, float margin, NarrowphaseManifold& result)
+    {
+        result.contact_cnt = 0;
+
+        Vec3 d = center - cylinder_center;
+        float height = glm::dot(d, axis);
+        Vec3 radial = d - axis * height;
+        float radial_distance = glm::length(radial);
+        Vec3 radial_direction = radial_distance > 1.0e-6f ? radial / radial_distance : computePerpendicular(axis);
+
+        bool inside = std::abs(height) <= half_height && radial_distance <= cylinder_radius;
+
+        if (inside)
+        {
+            // push out through the closer of cap and side
+            float cap_distance = half_height - std::abs(height);
+            float side_distance = cylinder_radius - radial_distance;
+
+            Vec3 outwards = radial_direction;
+            float face_distance = side_distance;
+            if (cap_distance < side_distance)
+            {
+                outwards = height >= 0.0f ? axis : -axis;
+                face_distance = cap_distance;
+            }
+
+            result.normal = -outwards;
+            result.contact_cnt = 1;
+            result.contacts[0].point = center + outwards * face_distance;
+            result.contacts[0].penetration = radius + face_distance;
+            return;
+        }
+
+        Vec3 closest = cylinder_center + axis * std::min(half_height, std::max(-half_height, height)) + radial_direction * std::min(radial_distance, cylinder_radius);
+
+        Vec3 offset = center - closest;
+        float distance_sq = glm::dot(offset, offset);
+
+        if (distance_sq > (radius + margin) * (radius + margin))
+            return;
+
+        float distance = std::sqrt(distance_sq);
+
+        result.normal = -(offset / distance);
+        result.contact_cnt = 1;
+        result.contacts[0].point = closest;
+        result.contacts[0].penetration = radius - distance;
+    }
+
+    /** Signed distance of a point from the box surface, negative inside of the box */
+    float computeBoxDistance(OrientedBox const& box, Vec3 const& point)
+    {
+        Vec3 d = point - box.center;
+
+        float outside_sq = 0.0f;
+        float inside = -std::numeric_limits<float>::max();
+        for (int k = 0; k < 3; ++k)
+        {
+            float q = std::abs(glm::dot(d, box.axes[k])) - box.extents[k];
+            outside_sq += std::max(q, 0.0f) * std::max(q, 0.0f);
+            inside = std::max(inside, q);
+        }
+
+        return std::sqrt(outside_sq) + std::min(inside, 0.0f);
+    }
+
+    void collideCapsuleBox(Vec3 const& center, Vec3 const& axis, float half_height, float radius, OrientedBox const& box, float margin, NarrowphaseManifold& result)
+    {
+        // The signed box distance is convex along the segment, a ternary search finds its deepest point
+        float lo = -half_height;
+        float hi = half_height;
+        for (int iteration = 0; iteration < capsule_box_iterations; ++iteration)
+        {
+            float s0 = lo + (hi - lo) * (1.0f / 3.0f);
+            float s1 = hi - (hi - lo) * (1.0f / 3.0f);
+
+            if (computeBoxDistance(box, center + axis * s0) < computeBoxDistance(box, center + axis * s1)) {
+                hi = s1;
+            }
+            else {
+                lo = s0;
+            }
+        }
+
+        collideSphereBox(center + axis * (0.5f * (lo + hi)), radius, box, margin, result);
+    }
+
+    /** Half length of the projection of a cylinder on a unit direction */
+    float projectCylinder(Vec3 const& axis, float half_height, float radius, Vec3 const& direction)
+    {
+        float cos_angle = glm::dot(axis, direction);
+        return half_height * std::abs(cos_angle) + radius * std::sqrt(std::max(0.0f, 1.0f - cos_angle * cos_angle));
+    }
+
+    void collideCylinders(
+        Vec3 const& center_a, Vec3 const& axis_a, float half_height_a, float radius_a,
+        Vec3 const& center_b, Vec3 const& axis_b, float half_height_b, float radius_b,
+        float margin,
+        NarrowphaseManifold& result)
+    {
+        result.contact_cnt = 0;
+
+        Vec3 d = center_b - center_a;
+
+        float s, t;
+        computeClosestSegmentPoints(center_a, axis_a, half_height_a, center_b, axis_b, half_height_b, s, t);
+        Vec3 point_a = center_a + axis_a * s;
+        Vec3 point_b = center_b + axis_b * t;
+
+        // both cap normals, the normal of both axes and the direction between the closest points of the axes
+        Vec3 candidates[4] = { axis_a, axis_b, glm::cross(axis_a, axis_b), point_b - point_a };
+
+        float overlap = std::numeric_limits<float>::max();
+        Vec3 normal(0.0f, 1.0f, 0.0f);
+        for (Vec3 const& candidate : candidates)
+        {
+            float length = glm::length(candidate);
+
+            if (length < parallel_edge_epsilon)
+                continue;
+
+            Vec3 axis = candidate / length;
+            float distance = glm::dot(d, axis);
+            float axis_overlap = projectCylinder(axis_a, half_height_a, radius_a, axis) + projectCylinder(axis_b, half_height_b, radius_b, axis) - std::abs(distance);
+
+            if (axis_overlap < -margin)
+                return;
+
+            if (axis_overlap < overlap)
+            {
+                overlap = axis_overlap;
+                normal = distance < 0.0f ? -axis : axis;
+            }
+        }
+
+        // halfway between the supporting planes, at the closest points of the axes
+        Vec3 midpoint = 0.5f * (point_a + point_b);
+        float plane_a = glm::dot(normal, center_a) + projectCylinder(axis_a, half_height_a, radius_a, normal);
+
+        result.normal = normal;
+        result.contact_cnt = 1;
+        result.contacts[0].point = midpoint + normal * (plane_a - 0.5f * overlap - glm::dot(normal, midpoint));
+        result.contacts[0].penetration = overlap;
+    }
+}
+
+#ifdef SIMD_FLOAT_VECTORIZED
+namespace
+{
+    using namespace EngineCore::Utility::Simd;
+    using EngineCore::Utility::Simd::load;
+
+    constexpr size_t simd_width = EngineCore::Utility::Simd::width;
+
+    inline Vec3N load(SoAVec3 const& v, size_t i) { return { load(v.x.data() + i), load(v.y.data() + i), load(v.z.data() + i) }; }
+
+    inline void clearManifolds(NarrowphaseManifold* manifolds)
+    {
+        for (size_t lane = 0; lane < simd_width; ++lane) {
+            manifolds[lane].contact_cnt = 0;
+        }
+    }
+
+    /** Write single contact manifolds of a batch, lanes that are not touching get no contacts */
+    void storeManifolds(FloatN touching, Vec3N const& normal, Vec3N const& point, FloatN penetration, NarrowphaseManifold* manifolds)
+    {
+        float nx[simd_width], ny[simd_width], nz[simd_width];
+        float px[simd_width], py[simd_width], pz[simd_width];
+        float depth[simd_width];
+
+        store(nx, normal.x);
+        store(ny, normal.y);
+        store(nz, normal.z);
+        store(px, point.x);
+        store(py, point.y);
+        store(pz, point.z);
+        store(depth, penetration);
+
+        int mask = laneMask(touching);
+
+        for (size_t lane = 0; lane < simd_width; ++lane)
+        {
+            NarrowphaseManifold& manifold = manifolds[lane];
+
+            if ((mask & (1 << lane)) == 0)
+            {
+                manifold.contact_cnt = 0;
+                continue;
+            }
+
+            manifold.normal = Vec3(nx[lane], ny[lane], nz[lane]);
+            manifold.contact_cnt = 1;
+            manifold.contacts[0].point = Vec3(px[lane], py[lane], pz[lane]);
+            manifold.contacts[0].penetration = depth[lane];
+        }
+    }
+
+    /** Sphere sphere contact of a batch, shared by spheres and capsules */
+    void collideSpheres(Vec3N const& center_a, FloatN radius_a, Vec3N const& center_b, FloatN radius_b, float margin, NarrowphaseManifold* manifolds)
+    {
+        Vec3N d = center_b - center_a;
+        FloatN distance_sq = dot(d, d);
+        FloatN radius = radius_a + radius_b;
+        FloatN limit = radius + splat(margin);
+        FloatN touching = distance_sq <= limit * limit;
+
+        if (laneMask(touching) == 0)
+        {
+            clearManifolds(manifolds);
+            return;
+        }
+
+        FloatN distance = vsqrt(distance_sq);
+        Vec3N normal = select(distance > splat(0.0f), d / distance, splat(Vec3(0.0f, 1.0f, 0.0f)));
+        FloatN penetration = radius - distance;
+        Vec3N point = center_a + normal * (radius_a - splat(0.5f) * penetration);
+
+        storeManifolds(touching, normal, point, penetration, manifolds);
+    }
+
+    /** Sphere box contact of a batch, shared by spheres and capsules */
+    void collideSphereBox(Vec3N const& center, FloatN radius, Vec3N const& box_center, Vec3N const* axes, Vec3N const& extents, float margin, NarrowphaseManifold* manifolds)
+    {
+        FloatN zero = splat(0.0f);
+
+        Vec3N d = center - box_center;
+        FloatN local[3] = { dot(d, axes[0]), dot(d, axes[1]), dot(d, axes[2]) };
+        FloatN extent[3] = { extents.x, extents.y, extents.z };
+
+        FloatN inside = (vabs(local[0]) <= extent[0]) & (vabs(local[1]) <= extent[1]) & (vabs(local[2]) <= extent[2]);
+
+        // push out through the closest face
+        FloatN face_distance = extent[0] - vabs(local[0]);
+        Vec3N outwards = select(local[0] >= zero, axes[0], -axes[0]);
+        for (int k = 1; k < 3; ++k)
+        {
+            FloatN distance = extent[k] - vabs(local[k]);
+            FloatN closer = distance < face_distance;
+            face_distance = select(closer, distance, face_distance);
+            outwards = select(closer, select(local[k] >= zero, axes[k], -axes[k]), outwards);
+        }
+
+        // closest point on the surface for spheres outside of the box
+        Vec3N closest = box_center;
+        for (int k = 0; k < 3; ++k) {
+            closest = closest + axes[k] * clamp(local[k], -extent[k], extent[k]);
+        }
+
+        Vec3N offset = center - closest;
+        FloatN distance_sq = dot(offset, offset);
+        FloatN limit = radius + splat(margin);
+        FloatN touching = inside | (distance_sq <= limit * limit);
+
+        if (laneMask(touching) == 0)
+        {
+            clearManifolds(manifolds);
+            return;
+        }
+
+        FloatN distance = vsqrt(distance_sq);
+
+        Vec3N normal = select(inside, -outwards, -(offset / distance));
+        Vec3N point = select(inside, center + outwards * face_distance, closest);
+        FloatN penetration = select(inside, radius + face_distance, radius - distance);
+
+        storeManifolds(touching, normal, point, penetration, manifolds);
+    }
+
+    /** Closest points of a batch of axis segments, same evaluation order as computeClosestSegmentPoints */
+    void computeClosestSegmentPoints(
+        Vec3N const& center_a, Vec3N const& axis_a, FloatN half_height_a,
+        Vec3N const& center_b, Vec3N const& axis_b, FloatN half_height_b,
+        FloatN& s, FloatN& t)
+    {
+        Vec3N r = center_a - center_b;
+        FloatN cos_angle = dot(axis_a, axis_b);
+        FloatN c = dot(axis_a, r);
+        FloatN f = dot(axis_b, r);
+        FloatN denom = splat(1.0f) - cos_angle * cos_angle;
+
+        s = select(denom > splat(1.0e-6f), clamp((cos_angle * f - c) / denom, -half_height_a, half_height_a), splat(0.0f));
+        t = clamp(cos_angle * s + f, -half_height_b, half_height_b);
+        s = clamp(cos_angle * t - c, -half_height_a, half_height_a);
+    }
+
+    /** Same evaluation order as computeBoxDistance */
+    FloatN computeBoxDistance(Vec3N const& box_center, Vec3N const* axes, Vec3N const& extents, Vec3N const& point)
+    {
+        FloatN zero = splat(0.0f);
+
+        Vec3N d = point - box_center;
+        FloatN q0 = vabs(dot(d, axes[0])) - extents.x;
+        FloatN q1 = vabs(dot(d, axes[1])) - extents.y;
+        FloatN q2 = vabs(dot(d, axes[2])) - extents.z;
+
+        FloatN outside_sq = vmax(q0, zero) * vmax(q0, zero) + vmax(q1, zero) * vmax(q1, zero) + vmax(q2, zero) * vmax(q2, zero);
+
+        return vsqrt(outside_sq) + vmin(vmax(vmax(q0, q1), q2), zero);
+    }
+
+    /** Same evaluation order as projectCylinder */
+    FloatN projectCylinder(Vec3N const& axis, FloatN half_height, FloatN radius, Vec3N const& direction)
+    {
+        FloatN cos_angle = dot(axis, direction);
+        return half_height * vabs(cos_angle) + radius * vsqrt(vmax(splat(0.0f), splat(1.0f) - cos_angle * cos_angle));
+    }
+
+    /** Overlap of the projections of both boxes on a batch of axes, same evaluation order as computeOverlap */
+    FloatN computeOverlap(Vec3N const* axes_a, Vec3N const& extents_a, Vec3N const* axes_b, Vec3N const& extents_b, Vec3N const& d, Vec3N const& axis)
+    {
+        FloatN radius_a = extents_a.x * vabs(dot(axes_a[0], axis)) + extents_a.y * vabs(dot(axes_a[1], axis)) + extents_a.z * vabs(dot(axes_a[2], axis));
+        FloatN radius_b = extents_b.x * vabs(dot(axes_b[0], axis)) + extents_b.y * vabs(dot(axes_b[1], axis)) + extents_b.z * vabs(dot(axes_b[2], axis));
+
+        return radius_a + radius_b - vabs(dot(d, axis));
+    }
+}
+#endif
+
+OrientedBox EngineCore::Physics::makeOrientedBox(Mat4x4 const& transform, Vec3 const& half_extents, bool axis_aligned)
+{
+    Vec3 columns[3] = { Vec3(transform[0]), Vec3(transform[1]), Vec3(transform[2]) };
+    Vec3 scale(glm::length(columns[0]), glm::length(columns[1]), glm::length(columns[2]));
+
+    OrientedBox box;
+    box.center = Vec3(transform[3]);
+    box.extents = half_extents * scale;
+
+    for (int k = 0; k < 3; ++k)
+    {
+        Vec3 axis(0.0f);
+        axis[k] = 1.0f;
+        box.axes[k] = axis_aligned || scale[k] == 0.0f ? axis : columns[k] / scale[k];
+    }
+
+    return box;
+}
+
+void EngineCore::Physics::SoAVec3::push_back(Vec3 const& v)
+{
+    x.push_back(v.x);
+    y.push_back(v.y);
+    z.push_back(v.z);
+}
+
+void EngineCore::Physics::SoAVec3::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+void EngineCore::Physics::SoASpheres::push_back(Vec3 const& center, float radius)
+{
+    this->center.push_back(center);
+    this->radius.push_back(radius);
+}
+
+void EngineCore::Physics::SoASpheres::clear()
+{
+    center.clear();
+    radius.clear();
+}
+
+void EngineCore::Physics::SoABoxes::push_back(OrientedBox const& box)
+{
+    center.push_back(box.center);
+    axes[0].push_back(box.axes[0]);
+    axes[1].push_back(box.axes[1]);
+    axes[2].push_back(box.axes[2]);
+    extents.push_back(box.extents);
+}
+
+void EngineCore::Physics::SoABoxes::clear()
+{
+    center.clear();
+    axes[0].clear();
+    axes[1].clear();
+    axes[2].clear();
+    extents.clear();
+}
+
+void EngineCore::Physics::SoAAxialShapes::push_back(Vec3 const& center, Vec3 const& axis, float half_height, float radius)
+{
+    this->center.push_back(center);
+    this->axis.push_back(axis);
+    this->half_height.push_back(half_height);
+    this->radius.push_back(radius);
+}
+
+void EngineCore::Physics::SoAAxialShapes::clear()
+{
+    center.clear();
+    axis.clear();
+    half_height.clear();
+    radius.clear();
+}
+
+void EngineCore::Physics::collideSpheres(SoASpheres const& a, SoASpheres const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        ::collideSpheres(load(a.center, i), load(a.radius.data() + i), load(b.center, i), load(b.radius.data() + i), margin, manifolds + (i - first));
+    }
+#endif
+
+    collideSpheresReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideSphereBoxes(SoASpheres const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        Vec3N axes[3] = { load(b.axes[0], i), load(b.axes[1], i), load(b.axes[2], i) };
+
+        ::collideSphereBox(load(a.center, i), load(a.radius.data() + i), load(b.center, i), axes, load(b.extents, i), margin, manifolds + (i - first));
+    }
+#endif
+
+    collideSphereBoxesReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideBoxes(SoABoxes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    FloatN negative_margin = splat(-margin);
+    FloatN epsilon = splat(parallel_edge_epsilon);
+
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        Vec3N axes_a[3] = { load(a.axes[0], i), load(a.axes[1], i), load(a.axes[2], i) };
+        Vec3N axes_b[3] = { load(b.axes[0], i), load(b.axes[1], i), load(b.axes[2], i) };
+        Vec3N extents_a = load(a.extents, i);
+        Vec3N extents_b = load(b.extents, i);
+        Vec3N d = load(b.center, i) - load(a.center, i);
+
+        FloatN separated = splat(0.0f) < splat(0.0f);
+        FloatN overlap_a = splat(std::numeric_limits<float>::max());
+        FloatN overlap_b = overlap_a;
+        FloatN overlap_edge = overlap_a;
+        FloatN axis_a = splat(0.0f);
+        FloatN axis_b = splat(0.0f);
+        FloatN edge = splat(0.0f);
+        Vec3N edge_axis = splat(Vec3(0.0f));
+
+        // same axis order and tie breaking as findBoxSeparation
+        for (int k = 0; k < 3; ++k)
+        {
+            FloatN overlap = computeOverlap(axes_a, extents_a, axes_b, extents_b, d, axes_a[k]);
+            separated = separated | (overlap < negative_margin);
+            FloatN smaller = overlap < overlap_a;
+            overlap_a = select(smaller, overlap, overlap_a);
+            axis_a = select(smaller, splat(static_cast<float>(k)), axis_a);
+
+            overlap = computeOverlap(axes_a, extents_a, axes_b, extents_b, d, axes_b[k]);
+            separated = separated | (overlap < negative_margin);
+            smaller = overlap < overlap_b;
+            overlap_b = select(smaller, overlap, overlap_b);
+            axis_b = select(smaller, splat(static_cast<float>(k)), axis_b);
+        }
+
+        for (int ea = 0; ea < 3; ++ea)
+        {
+            for (int eb = 0; eb < 3; ++eb)
+            {
+                Vec3N axis = cross(axes_a[ea], axes_b[eb]);
+                FloatN length = vsqrt(dot(axis, axis));
+                FloatN valid = length >= epsilon;
+
+                axis = axis / length;
+
+                FloatN overlap = computeOverlap(axes_a, extents_a, axes_b, extents_b, d, axis);
+                separated = separated | (valid & (overlap < negative_margin));
+                FloatN smaller = valid & (overlap < overlap_edge);
+                overlap_edge = select(smaller, overlap, overlap_edge);
+                edge = select(smaller, splat(static_cast<float>(ea * 3 + eb)), edge);
+                edge_axis = select(smaller, axis, edge_axis);
+            }
+        }
+
+        int separated_mask = laneMask(separated);
+
+        if (separated_mask == (1 << simd_width) - 1)
+        {
+            clearManifolds(manifolds + (i - first));
+            continue;
+        }
+
+        float lane_overlap_a[simd_width], lane_overlap_b[simd_width], lane_overlap_edge[simd_width];
+        float lane_axis_a[simd_width], lane_axis_b[simd_width], lane_edge[simd_width];
+        float lane_edge_axis[3][simd_width];
+
+        store(lane_overlap_a, overlap_a);
+        store(lane_overlap_b, overlap_b);
+        store(lane_overlap_edge, overlap_edge);
+        store(lane_axis_a, axis_a);
+        store(lane_axis_b, axis_b);
+        store(lane_edge, edge);
+        store(lane_edge_axis[0], edge_axis.x);
+        store(lane_edge_axis[1], edge_axis.y);
+        store(lane_edge_axis[2], edge_axis.z);
+
+        // clipping is branchy, touching pairs are clipped one by one
+        for (size_t lane = 0; lane < simd_width; ++lane)
+        {
+            NarrowphaseManifold& manifold = manifolds[i - first + lane];
+
+            if ((separated_mask & (1 << lane)) != 0)
+            {
+                manifold.contact_cnt = 0;
+                continue;
+            }
+
+            BoxSeparation separation;
+            separation.overlap_a = lane_overlap_a[lane];
+            separation.overlap_b = lane_overlap_b[lane];
+            separation.overlap_edge = lane_overlap_edge[lane];
+            separation.axis_a = static_cast<int>(lane_axis_a[lane]);
+            separation.axis_b = static_cast<int>(lane_axis_b[lane]);
+            separation.edge_a = static_cast<int>(lane_edge[lane]) / 3;
+            separation.edge_b = static_cast<int>(lane_edge[lane]) % 3;
+            separation.edge_axis = Vec3(lane_edge_axis[0][lane], lane_edge_axis[1][lane], lane_edge_axis[2][lane]);
+
+            clipBoxes(getBox(a, i + lane), getBox(b, i + lane), separation, margin, manifold);
+        }
+    }
+#endif
+
+    collideBoxesReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideCapsules(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        Vec3N center_a = load(a.center, i);
+        Vec3N axis_a = load(a.axis, i);
+        Vec3N center_b = load(b.center, i);
+        Vec3N axis_b = load(b.axis, i);
+
+        FloatN s, t;
+        ::computeClosestSegmentPoints(center_a, axis_a, load(a.half_height.data() + i), center_b, axis_b, load(b.half_height.data() + i), s, t);
+
+        ::collideSpheres(center_a + axis_a * s, load(a.radius.data() + i), center_b + axis_b * t, load(b.radius.data() + i), margin, manifolds + (i - first));
+    }
+#endif
+
+    collideCapsulesReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideSphereCylinders(SoASpheres const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    FloatN zero = splat(0.0f);
+
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        Vec3N center = load(a.center, i);
+        FloatN radius = load(a.radius.data() + i);
+
+        Vec3N cylinder_center = load(b.center, i);
+        Vec3N axis = load(b.axis, i);
+        FloatN half_height = load(b.half_height.data() + i);
+        FloatN cylinder_radius = load(b.radius.data() + i);
+
+        Vec3N d = center - cylinder_center;
+        FloatN height = dot(d, axis);
+        Vec3N radial = d - axis * height;
+        FloatN radial_distance = vsqrt(dot(radial, radial));
+
+        // same fallback as computePerpendicular for spheres on the axis
+        Vec3N perpendicular_x = { axis.y, -axis.x, zero };
+        Vec3N perpendicular_z = { zero, axis.z, -axis.y };
+        Vec3N perpendicular = select(vabs(axis.x) >= splat(0.57735f), perpendicular_x, perpendicular_z);
+        perpendicular = perpendicular / vsqrt(dot(perpendicular, perpendicular));
+
+        Vec3N radial_direction = select(radial_distance > splat(1.0e-6f), radial / radial_distance, perpendicular);
+
+        FloatN inside = (vabs(height) <= half_height) & (radial_distance <= cylinder_radius);
+
+        // push out through the closer of cap and side
+        FloatN cap_distance = half_height - vabs(height);
+        FloatN side_distance = cylinder_radius - radial_distance;
+        FloatN through_cap = cap_distance < side_distance;
+        Vec3N outwards = select(through_cap, select(height >= zero, axis, -axis), radial_direction);
+        FloatN face_distance = select(through_cap, cap_distance, side_distance);
+
+        // closest point on the surface for spheres outside of the cylinder
+        Vec3N closest = cylinder_center + axis * clamp(height, -half_height, half_height) + radial_direction * vmin(radial_distance, cylinder_radius);
+
+        Vec3N offset = center - closest;
+        FloatN distance_sq = dot(offset, offset);
+        FloatN limit = radius + splat(margin);
+        FloatN touching = inside | (distance_sq <= limit * limit);
+
+        if (laneMask(touching) == 0)
+        {
+            clearManifolds(manifolds + (i - first));
+            continue;
+        }
+
+        FloatN distance = vsqrt(distance_sq);
+
+        Vec3N normal = select(inside, -outwards, -(offset / distance));
+        Vec3N point = select(inside, center + outwards * face_distance, closest);
+        FloatN penetration = select(inside, radius + face_distance, radius - distance);
+
+        storeManifolds(touching, normal, point, penetration, manifolds + (i - first));
+    }
+#endif
+
+    collideSphereCylindersReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideCapsuleBoxes(SoAAxialShapes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    FloatN one_third = splat(1.0f / 3.0f);
+
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        Vec3N center = load(a.center, i);
+        Vec3N axis = load(a.axis, i);
+        FloatN half_height = load(a.half_height.data() + i);
+
+        Vec3N box_center = load(b.center, i);
+        Vec3N axes[3] = { load(b.axes[0], i), load(b.axes[1], i), load(b.axes[2], i) };
+        Vec3N extents = load(b.extents, i);
+
+        // same ternary search as collideCapsuleBox
+        FloatN lo = -half_height;
+        FloatN hi = half_height;
+        for (int iteration = 0; iteration < capsule_box_iterations; ++iteration)
+        {
+            FloatN s0 = lo + (hi - lo) * one_third;
+            FloatN s1 = hi - (hi - lo) * one_third;
+
+            FloatN closer = computeBoxDistance(box_center, axes, extents, center + axis * s0) < computeBoxDistance(box_center, axes, extents, center + axis * s1);
+            hi = select(closer, s1, hi);
+            lo = select(closer, lo, s0);
+        }
+
+        ::collideSphereBox(center + axis * (splat(0.5f) * (lo + hi)), load(a.radius.data() + i), box_center, axes, extents, margin, manifolds + (i - first));
+    }
+#endif
+
+    collideCapsuleBoxesReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideCylinders(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    size_t i = first;
+
+#ifdef SIMD_FLOAT_VECTORIZED
+    FloatN zero = splat(0.0f);
+    FloatN negative_margin = splat(-margin);
+    FloatN epsilon = splat(parallel_edge_epsilon);
+
+    for (; i + simd_width <= last; i += simd_width)
+    {
+        Vec3N center_a = load(a.center, i);
+        Vec3N axis_a = load(a.axis, i);
+        FloatN half_height_a = load(a.half_height.data() + i);
+        FloatN radius_a = load(a.radius.data() + i);
+        Vec3N center_b = load(b.center, i);
+        Vec3N axis_b = load(b.axis, i);
+        FloatN half_height_b = load(b.half_height.data() + i);
+        FloatN radius_b = load(b.radius.data() + i);
+
+        Vec3N d = center_b - center_a;
+
+        FloatN s, t;
+        ::computeClosestSegmentPoints(center_a, axis_a, half_height_a, center_b, axis_b, half_height_b, s, t);
+        Vec3N point_a = center_a + axis_a * s;
+        Vec3N point_b = center_b + axis_b * t;
+
+        // same candidate axes and tie breaking as collideCylinders
+        Vec3N candidates[4] = { axis_a, axis_b, cross(axis_a, axis_b), point_b - point_a };
+
+        FloatN overlap = splat(std::numeric_limits<float>::max());
+        Vec3N normal = splat(Vec3(0.0f, 1.0f, 0.0f));
+        for (Vec3N const& candidate : candidates)
+        {
+            FloatN length = vsqrt(dot(candidate, candidate));
+            FloatN valid = length >= epsilon;
+
+            Vec3N axis = candidate / length;
+            FloatN distance = dot(d, axis);
+            FloatN axis_overlap = projectCylinder(axis_a, half_height_a, radius_a, axis) + projectCylinder(axis_b, half_height_b, radius_b, axis) - vabs(distance);
+
+            FloatN smaller = valid & (axis_overlap < overlap);
+            overlap = select(smaller, axis_overlap, overlap);
+            normal = select(smaller, select(distance < zero, -axis, axis), normal);
+        }
+
+        // separated along any candidate axis if separated along the one with the smallest overlap
+        FloatN touching = overlap >= negative_margin;
+
+        if (laneMask(touching) == 0)
+        {
+            clearManifolds(manifolds + (i - first));
+            continue;
+        }
+
+        Vec3N midpoint = splat(0.5f) * (point_a + point_b);
+        FloatN plane_a = dot(normal, center_a) + projectCylinder(axis_a, half_height_a, radius_a, normal);
+        Vec3N point = midpoint + normal * (plane_a - splat(0.5f) * overlap - dot(normal, midpoint));
+
+        storeManifolds(touching, normal, point, overlap, manifolds + (i - first));
+    }
+#endif
+
+    collideCylindersReference(a, b, i, last, margin, manifolds + (i - first));
+}
+
+void EngineCore::Physics::collideSpheresReference(SoASpheres const& a, SoASpheres const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i) {
+        ::collideSpheres(getVec3(a.center, i), a.radius[i], getVec3(b.center, i), b.radius[i], margin, manifolds[i - first]);
+    }
+}
+
+void EngineCore::Physics::collideSphereBoxesReference(SoASpheres const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i) {
+        collideSphereBox(getVec3(a.center, i), a.radius[i], getBox(b, i), margin, manifolds[i - first]);
+    }
+}
+
+void EngineCore::Physics::collideBoxesReference(SoABoxes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i) {
+        ::collideBoxes(getBox(a, i), getBox(b, i), margin, manifolds[i - first]);
+    }
+}
+
+void EngineCore::Physics::collideCapsulesReference(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        ::collideCapsules(
+            getVec3(a.center, i), getVec3(a.axis, i), a.half_height[i], a.radius[i],
+            getVec3(b.center, i), getVec3(b.axis, i), b.half_height[i], b.radius[i],
+            margin,
+            manifolds[i - first]);
+    }
+}
+
+void EngineCore::Physics::collideSphereCylindersReference(SoASpheres const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i) {
+        collideSphereCylinder(getVec3(a.center, i), a.radius[i], getVec3(b.center, i), getVec3(b.axis, i), b.half_height[i], b.radius[i], margin, manifolds[i - first]);
+    }
+}
+
+void EngineCore::Physics::collideCapsuleBoxesReference(SoAAxialShapes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i) {
+        collideCapsuleBox(getVec3(a.center, i), getVec3(a.axis, i), a.half_height[i], a.radius[i], getBox(b, i), margin, manifolds[i - first]);
+    }
+}
+
+void EngineCore::Physics::collideCylindersReference(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        ::collideCylinders(
+            getVec3(a.center, i), getVec3(a.axis, i), a.half_height[i], a.radius[i],
+            getVec3(b.center, i), getVec3(b.axis, i), b.half_height[i], b.radius[i],
+            margin,
+            manifolds[i - first]);
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef Narrowphase_hpp
+#define Narrowphase_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Physics
+    {
+        struct OrientedBox
+        {
+            Vec3 center;
+            Vec3 axes[3];  ///< Unit axes
+            Vec3 extents;  ///< Half extents along the axes
+        };
+
+        struct NarrowphaseContact
+        {
+            Vec3  point;
+            float penetration; ///< Negative for speculative contacts within the margin
+        };
+
+        /**
+        * \brief Contacts of a shape pair, contact_cnt is 0 if the shapes are separated by more than the margin
+        */
+        struct NarrowphaseManifold
+        {
+            Vec3               normal; ///< Points from the first to the second shape
+            uint32_t           contact_cnt = 0;
+            NarrowphaseContact contacts[4];
+        };
+
+        /**
+        * \brief World space box of a bounding box component. Axis aligned bounding boxes keep the scale but ignore
+        * the rotation of the transformation.
+        * \param half_extents Half of width, height and depth
+        */
+        OrientedBox makeOrientedBox(Mat4x4 const& transform, Vec3 const& half_extents, bool axis_aligned);
+
+        struct SoAVec3
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+
+            void push_back(Vec3 const& v);
+            void clear();
+        };
+
+        struct SoASpheres
+        {
+            SoAVec3            center;
+            std::vector<float> radius;
+
+            void push_back(Vec3 const& center, float radius);
+            void clear();
+            size_t size() const { return radius.size(); }
+        };
+
+        struct SoABoxes
+        {
+            SoAVec3 center;
+            SoAVec3 axes[3];
+            SoAVec3 extents;
+
+            void push_back(OrientedBox const& box);
+            void clear();
+            size_t size() const { return center.x.size(); }
+        };
+
+        /**
+        * \brief Capsules or cylinders given by their center, unit axis, half height along the axis and radius.
+        * Bounding cylinders are aligned with the local y axis.
+        */
+        struct SoAAxialShapes
+        {
+            SoAVec3            center;
+            SoAVec3            axis;
+            std::vector<float> half_height;
+            std::vector<float> radius;
+
+            void push_back(Vec3 const& center, Vec3 const& axis, float half_height, float radius);
+            void clear();
+            size_t size() const { return radius.size(); }
+        };
+
+        /**
+        * Batched narrowphase kernels. Pair i consists of shape i of a and shape i of b. Each kernel writes
+        * manifolds[i - first] for all pairs in [first, last), pairs are processed in SIMD batches of the target
+        * architecture (8 with AVX2, 4 with SSE2, scalar otherwise) with the remainder done by the scalar reference.
+        * The margin keeps contacts of shapes that are up to margin apart.
+        */
+
+        /**
+        * \brief Sphere pairs, one contact halfway between the surfaces
+        */
+        void collideSpheres(SoASpheres const& a, SoASpheres const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * \brief Sphere and oriented box pairs, one contact on the box surface
+        */
+        void collideSphereBoxes(SoASpheres const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * \brief Oriented box pairs. The separating axis test over the 15 candidate axes runs in SIMD, touching pairs
+        * are clipped one by one, face contacts give up to 4 contacts and edge contacts one.
+        */
+        void collideBoxes(SoABoxes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * \brief Capsule pairs, one contact between the closest points of both segments. Spheres are capsules with
+        * zero half height.
+        */
+        void collideCapsules(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * \brief Sphere and cylinder pairs, one contact on the cylinder surface
+        */
+        void collideSphereCylinders(SoASpheres const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * \brief Capsule and oriented box pairs, one contact on the box surface at the deepest point of the capsule
+        * segment, found by a ternary search over the signed box distance
+        */
+        void collideCapsuleBoxes(SoAAxialShapes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * \brief Cylinder pairs, one contact halfway between the surfaces. The separating axis test only checks both
+        * cap normals, the normal of both axes and the direction between the closest points of the axes, so pairs that
+        * are only separated along other directions, e.g. rim to rim, get a conservative shallow contact.
+        */
+        void collideCylinders(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        /**
+        * Straightforward scalar implementations, used as reference for validating the SIMD kernels
+        */
+
+        void collideSpheresReference(SoASpheres const& a, SoASpheres const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        void collideSphereBoxesReference(SoASpheres const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        void collideBoxesReference(SoABoxes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        void collideCapsulesReference(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        void collideSphereCylindersReference(SoASpheres const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        void collideCapsuleBoxesReference(SoAAxialShapes const& a, SoABoxes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+
+        void collideCylindersReference(SoAAxialShapes const& a, SoAAxialShapes const& b, size_t first, size_t last, float margin, NarrowphaseManifold* manifolds);
+    }
+}
+
+#endif // !Narrowphase_hpp
@@ -5,6 +5,7 @@
 #include <backends/imgui_impl_glfw.h>
 
 #include "CameraComponent.hpp"
+#include "gltfAssetComponentManager.hpp"
 #include "MaterialComponentManager.hpp"
 #include "MeshComponentManager.hpp"
 #include "OceanRenderPass.hpp"
@@ -27,7 +28,8 @@ namespace EngineCore
             void setupBasicForwardRenderingPipeline(
                 Common::Frame & frame,
                 WorldState & world_state,
-                ResourceManager & resource_mngr)
+                ResourceManager & resource_mngr,
+                TextureStreamingService<ResourceManager>* texture_streaming)
             {
                 struct GeomPassData
                 {
@@ -51,6 +53,8 @@ namespace EngineCore
                         GLuint64 normal_tx_hndl;
 
                         GLuint64 padding;
+
+                        float min_lod[4] = { 0.0f, 0.0f, 0.0f, 0.0f }; // finest resident level of the albedo, roughness and normal texture storage
                     };
 
                     // static mesh (shader) params per object per batch
@@ -78,7 +82,7 @@ namespace EngineCore
 
                 frame.addRenderPass<GeomPassData, GeomPassResources>("GeometryPass",
                     // data setup phase
-                    [&frame, &world_state, &resource_mngr](GeomPassData& data, GeomPassResources& resources) {
+                    [&frame, &world_state, &resource_mngr, texture_streaming](GeomPassData& data, GeomPassResources& resources) {
 
                     auto& cam_mngr = world_state.get<CameraComponentManager>();
                     auto& mtl_mngr = world_state.get<MaterialComponentManager>();
@@ -97,6 +101,8 @@ namespace EngineCore
                     cam_mngr.updateProjectionMatrix(camera_idx);
                     data.proj_matrix = cam_mngr.getProjectionMatrix(camera_idx);
 
+                    Vec3 camera_position = Vec3(transform_mngr.getWorldTransformation(camera_transform_idx)[3]);
+
                     // set per object data
                     auto objs = renderTask_mngr.getComponentDataCopy();
 
@@ -149,6 +155,29 @@ namespace EngineCore
                             auto roughness_texture = mtl_mngr.getTextures(obj.cached_material_idx, TextureSemantic::METALLIC_ROUGHNESS);
                             auto normal_texture = mtl_mngr.getTextures(obj.cached_material_idx, TextureSemantic::NORMAL);
 
+                            if (texture_streaming != nullptr)
+                            {
+                                // approximate on-screen size from the object's world space scale, assuming unit sized meshes
+                                float radius = std::max({
+                                    glm::length(Vec3(params.transform[0])),
+                                    glm::length(Vec3(params.transform[1])),
+                                    glm::length(Vec3(params.transform[2])) });
+                                float distance = std::max(glm::length(Vec3(params.transform[3]) - camera_position), radius);
+                                float screen_size = static_cast<float>(frame.m_window_height) * data.proj_matrix[1][1] * radius / distance;
+
+                                for (auto texture : { albedo_texture, roughness_texture, normal_texture })
+                                {
+                                    if (texture != resource_mngr.invalidResourceID()) {
+                                        texture_streaming->reportUsage(texture, screen_size);
+                                    }
+                                }
+
+                                // queried together with the texture handles, since streamed textures are reallocated on residency changes
+                                params.min_lod[0] = texture_streaming->getMinLod(albedo_texture);
+                                params.min_lod[1] = texture_streaming->getMinLod(roughness_texture);
+                                params.min_lod[2] = texture_streaming->getMinLod(normal_texture);
+                            }
+
                             //if (!albedo_textures.empty())
                             //{
                             //    auto albedo_tx = resource_mngr.getTexture2DResource(albedo_textures[0]);
@@ -245,7 +274,12 @@ namespace EngineCore
                     }
                 },
                     // resource setup phase
-                    [&frame, &world_state, &resource_mngr](GeomPassData& data, GeomPassResources& resources) {
+                    [&frame, &world_state, &resource_mngr, texture_streaming](GeomPassData& data, GeomPassResources& resources) {
+
+                    // residency changes are uploaded with the render thread tasks of the next frame
+                    if (texture_streaming != nullptr) {
+                        texture_streaming->update(frame.m_render_frameID);
+                    }
 
                     // buffer data to resources
                     uint batch = 0;
@@ -382,7 +416,50 @@ namespace EngineCore
             }
 
 
-            void setupBasicDeferredRenderingPipeline(Common::Frame& frame, WorldState& world_state, ResourceManager& resource_mngr)
+            std::unique_ptr<TextureStreamingService<ResourceManager>> createTextureStreaming(
+                WorldState& world_state,
+                ResourceManager& resource_mngr,
+                size_t budget_bytes)
+            {
+                auto texture_streaming = std::make_unique<TextureStreamingService<ResourceManager>>(&resource_mngr, budget_bytes);
+
+                if (world_state.has<GltfAssetComponentManager>())
+                {
+                    auto service = texture_streaming.get();
+                    world_state.get<GltfAssetComponentManager>().setTextureStreaming(
+                        [service](std::string const& name, GltfAssetComponentManager::MipChainPtr const& mip_chain, GenericTextureLayout const& layout) {
+                            return service->addTexture2D(name, mip_chain, layout.int_parameters, layout.float_parameters);
+                        });
+                }
+
+                return texture_streaming;
+            }
+
+            std::unique_ptr<TextureLoadingService<ResourceManager>> createTextureLoading(
+                WorldState& world_state,
+                ResourceManager& resource_mngr,
+                int worker_thread_cnt)
+            {
+                auto texture_loading = std::make_unique<TextureLoadingService<ResourceManager>>(&resource_mngr, worker_thread_cnt);
+
+                if (world_state.has<GltfAssetComponentManager>())
+                {
+                    auto service = texture_loading.get();
+                    world_state.get<GltfAssetComponentManager>().setTextureLoading(
+                        [service](std::string const& name, GenericTextureLayout const& layout, std::shared_ptr<std::vector<uint8_t>> const& data, bool srgb) {
+                            return service->createTexture2DAsync(name, layout, data, MipFilter::BOX, srgb);
+                        },
+                        &service->accessTaskScheduler());
+                }
+
+                return texture_loading;
+            }
+
+            void setupBasicDeferredRenderingPipeline(
+                Common::Frame& frame,
+                WorldState& world_state,
+                ResourceManager& resource_mngr,
+                TextureStreamingService<ResourceManager>* texture_streaming)
             {
                 // Experimenting with taging framebuffer color attachements
                 enum class ColorAttachmentSemantic : uint32_t
@@ -416,16 +493,19 @@ namespace EngineCore
                         GLuint64 normal_tx_hndl;
 
                         GLuint64 entity_id; // currently not really needed in GPU memory, but also serves as padding
+
+                        float min_lod[4] = { 0.0f, 0.0f, 0.0f, 0.0f }; // finest resident level of the albedo, roughness and normal texture storage
                     };
 
                     // static mesh (shader) params per object per batch
                     std::vector<std::vector<StaticMeshParams>>    static_mesh_params;
                     std::vector<std::vector<DrawElementsCommand>> static_mesh_drawCommands;
 
+                    // store ids only, streamed textures might be recreated before the resource setup phase
                     struct MaterialTextures {
-                        WeakResource<glowl::Texture2D> albedo_tx;
-                        WeakResource<glowl::Texture2D> roughness_tx;
-                        WeakResource<glowl::Texture2D> normal_tx;
+                        ResourceID albedo_tx;
+                        ResourceID roughness_tx;
+                        ResourceID normal_tx;
                     };
                     std::vector<std::vector<MaterialTextures>> mtl_tx_cache;
 
@@ -476,7 +556,7 @@ namespace EngineCore
                 // Geometry pass
                 frame.addRenderPass<GeomPassData, GeomPassResources>("GeometryPass",
                     // data setup phase
-                    [&frame, &world_state, &resource_mngr](GeomPassData& data, GeomPassResources& resources) {
+                    [&frame, &world_state, &resource_mngr, texture_streaming](GeomPassData& data, GeomPassResources& resources) {
 
                         auto & cam_mngr = world_state.get<CameraComponentManager>();
                         auto const& mtl_mngr = world_state.get<MaterialComponentManager>();
@@ -500,6 +580,12 @@ namespace EngineCore
                         // check for existing gBuffer
                         resources.m_render_target = resource_mngr.getFramebufferObject("GBuffer");
 
+                        Vec3 camera_position = Vec3(transform_mngr.getWorldTransformation(camera_transform_idx)[3]);
+
+                        ResourceID dflt_albedo_tx = resource_mngr.getTexture2DResource("noTexture_baseColor").id;
+                        ResourceID dflt_roughness_tx = resource_mngr.getTexture2DResource("noTexture_metallicRoughness").id;
+                        ResourceID dflt_normal_tx = resource_mngr.getTexture2DResource("noTexture_normalMap").id;
+
                         // set per object data
                         auto objs = renderTask_mngr.getComponentDataCopy();
 
@@ -549,32 +635,28 @@ namespace EngineCore
                                 auto roughness_texture = mtl_mngr.getTextures(obj.cached_material_idx, TextureSemantic::METALLIC_ROUGHNESS);
                                 auto normal_texture = mtl_mngr.getTextures(obj.cached_material_idx, TextureSemantic::NORMAL);
 
-                                WeakResource<glowl::Texture2D> albedo_tx;
-                                WeakResource<glowl::Texture2D> roughness_tx;
-                                WeakResource<glowl::Texture2D> normal_tx;
-
-                                if (albedo_texture != resource_mngr.invalidResourceID()) {
-                                    albedo_tx = resource_mngr.getTexture2DResource(albedo_texture);
-                                }
-                                else {
-                                    albedo_tx = resource_mngr.getTexture2DResource("noTexture_baseColor");
-                                }
-
-                                if (roughness_texture != resource_mngr.invalidResourceID()) {
-                                    roughness_tx = resource_mngr.getTexture2DResource(roughness_texture);
-                                }
-                                else {
-                                    roughness_tx = resource_mngr.getTexture2DResource("noTexture_metallicRoughness");
-                                }
-
-                                if (normal_texture != resource_mngr.invalidResourceID()) {
-                                    normal_tx = resource_mngr.getTexture2DResource(normal_texture);
-                                }
-                                else {
-                                    normal_tx = resource_mngr.getTexture2DResource("noTexture_normalMap");
+                                if (texture_streaming != nullptr)
+                                {
+                                    // approximate on-screen size from the object's world space scale, assuming unit sized meshes
+                                    float radius = std::max({
+                                        glm::length(Vec3(params.transform[0])),
+                                        glm::length(Vec3(params.transform[1])),
+                                        glm::length(Vec3(params.transform[2])) });
+                                    float distance = std::max(glm::length(Vec3(params.transform[3]) - camera_position), radius);
+                                    float screen_size = static_cast<float>(frame.m_window_height) * data.proj_matrix[1][1] * radius / distance;
+
+                                    for (auto texture : { albedo_texture, roughness_texture, normal_texture })
+                                    {
+                                        if (texture != resource_mngr.invalidResourceID()) {
+                                            texture_streaming->reportUsage(texture, screen_size);
+                                        }
+                                    }
                                 }
 
-                                data.mtl_tx_cache.back().push_back({ albedo_tx, roughness_tx, normal_tx });
+                                data.mtl_tx_cache.back().push_back({
+                                    albedo_texture != resource_mngr.invalidResourceID() ? albedo_texture : dflt_albedo_tx,
+                                    roughness_texture != resource_mngr.invalidResourceID() ? roughness_texture : dflt_roughness_tx,
+                                    normal_texture != resource_mngr.invalidResourceID() ? normal_texture : dflt_normal_tx });
                             }
 
                             // set draw command values
@@ -591,10 +673,15 @@ namespace EngineCore
                         }
                     },
                     // resource setup phase
-                    [&frame, &resource_mngr](GeomPassData& data, GeomPassResources& resources) {
+                    [&frame, &resource_mngr, texture_streaming](GeomPassData& data, GeomPassResources& resources) {
 
                         glMemoryBarrier(GL_ALL_BARRIER_BITS);
 
+                        // residency changes are uploaded with the render thread tasks of the next frame
+                        if (texture_streaming != nullptr) {
+                            texture_streaming->update(frame.m_render_frameID);
+                        }
+
                         if (resources.m_render_target.state != READY)
                         {
                             resources.m_render_target = resource_mngr.createFramebufferObject("GBuffer", 1280, 720);
@@ -610,9 +697,16 @@ namespace EngineCore
                         {
                             for(int obj_idx = 0; obj_idx < data.static_mesh_params[batch].size(); ++obj_idx)
                             {
-                                WeakResource<glowl::Texture2D> albedo_tx = data.mtl_tx_cache[batch][obj_idx].albedo_tx;
-                                WeakResource<glowl::Texture2D> roughness_tx = data.mtl_tx_cache[batch][obj_idx].roughness_tx;
-                                WeakResource<glowl::Texture2D> normal_tx = data.mtl_tx_cache[batch][obj_idx].normal_tx;
+                                WeakResource<glowl::Texture2D> albedo_tx = resource_mngr.getTexture2DResource(data.mtl_tx_cache[batch][obj_idx].albedo_tx);
+                                WeakResource<glowl::Texture2D> roughness_tx = resource_mngr.getTexture2DResource(data.mtl_tx_cache[batch][obj_idx].roughness_tx);
+                                WeakResource<glowl::Texture2D> normal_tx = resource_mngr.getTexture2DResource(data.mtl_tx_cache[batch][obj_idx].normal_tx);
+
+                                if (texture_streaming != nullptr)
+                                {
+                                    data.static_mesh_params[batch][obj_idx].min_lod[0] = texture_streaming->getMinLod(data.mtl_tx_cache[batch][obj_idx].albedo_tx);
+                                    data.static_mesh_params[batch][obj_idx].min_lod[1] = texture_streaming->getMinLod(data.mtl_tx_cache[batch][obj_idx].roughness_tx);
+                                    data.static_mesh_params[batch][obj_idx].min_lod[2] = texture_streaming->getMinLod(data.mtl_tx_cache[batch][obj_idx].normal_tx);
+                                }
 
                                 if (albedo_tx.state == READY)
                                 {
@@ -2,6 +2,8 @@
 #define BasicRenderingPipeline
 
 #include "../Frame.hpp"
+#include "../TextureLoadingService.hpp"
+#include "../TextureStreamingService.hpp"
 #include "../WorldState.hpp"
 #include "ResourceManager.hpp"
 
@@ -11,15 +13,46 @@ namespace EngineCore
     {
         namespace OpenGL
         {
+            /**
+            * \param texture_streaming Optional texture streaming service (see createTextureStreaming), that receives the
+            * screen space usage of material textures gathered during draw list construction
+            */
             void setupBasicForwardRenderingPipeline(
                 Common::Frame&   frame,
                 WorldState&      world_state,
-                ResourceManager& resource_mngr);
+                ResourceManager& resource_mngr,
+                TextureStreamingService<ResourceManager>* texture_streaming = nullptr);
 
+            /**
+            * \param texture_streaming Optional texture streaming service (see createTextureStreaming), that receives the
+            * screen space usage of material textures gathered during draw list construction
+            */
             void setupBasicDeferredRenderingPipeline(
                 Common::Frame& frame,
                 WorldState& world_state,
-                ResourceManager& resource_mngr);
+                ResourceManager& resource_mngr,
+                TextureStreamingService<ResourceManager>* texture_streaming = nullptr);
+
+            /**
+            * \brief Create a texture streaming service for the basic pipelines and hand the compressed textures of
+            * glTF assets added from now on to it. Requires texture compression of the GltfAssetComponentManager to be
+            * enabled. The service has to outlive these assets.
+            * \param budget_bytes Byte budget for all streamed textures
+            */
+            std::unique_ptr<TextureStreamingService<ResourceManager>> createTextureStreaming(
+                WorldState& world_state,
+                ResourceManager& resource_mngr,
+                size_t budget_bytes);
+
+            /**
+            * \brief Create a texture loading service and let glTF assets added from now on decode their images and build
+            * the mip chains of textures that are not block compressed on its worker threads. The service has to outlive
+            * these assets.
+            */
+            std::unique_ptr<TextureLoadingService<ResourceManager>> createTextureLoading(
+                WorldState& world_state,
+                ResourceManager& resource_mngr,
+                int worker_thread_cnt = 4);
 
             /** Experimenting with new Renderer architecture */
             //void setupBasicRenderingPipeline(
@@ -1,5 +1,8 @@
 #include "ResourceManager.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #include "../ResourceLoading.hpp"
 //#include "GraphicsBackend.hpp"
 
@@ -31,6 +34,8 @@ namespace EngineCore
                 m_id_to_FBO_idx.clear();
                 m_id_to_buffer_idx.clear();
 
+                m_shader_program_fallbacks.clear();
+
                 m_shader_programs.clear();
                 m_meshes.clear();
                 m_textures_2d.clear();
@@ -115,6 +120,27 @@ namespace EngineCore
                 return m_meshes.back().id;
             }
 
+            ResourceManager::~ResourceManager()
+            {
+                if (m_shader_tasks_enabled) {
+                    m_shader_task_scheduler.stop();
+                }
+            }
+
+            void ResourceManager::setShaderProgramCache(int worker_thread_cnt, std::string const& cache_directory)
+            {
+                if (m_shader_tasks_enabled) {
+                    m_shader_task_scheduler.stop();
+                }
+
+                m_shader_tasks_enabled = worker_thread_cnt > 0;
+                m_program_binary_cache.setDirectory(cache_directory);
+
+                if (m_shader_tasks_enabled) {
+                    m_shader_task_scheduler.run(worker_thread_cnt);
+                }
+            }
+
             WeakResource<glowl::GLSLProgram> ResourceManager::createShaderProgram(
                 std::string const& program_name,
                 std::vector<ShaderFilename> const& shader_filenames,
@@ -130,14 +156,92 @@ namespace EngineCore
                             m_shader_programs[search->second].state);
                 }
 
-                size_t idx = m_shader_programs.size();
+                size_t idx;
                 ResourceID rsrc_id = generateResourceID();
 
-                std::unique_lock<std::shared_mutex> lock(m_shader_programs_mutex);
-                m_shader_programs.push_back(Resource<glowl::GLSLProgram>(rsrc_id));
-                m_id_to_shader_program_idx.insert(std::pair<unsigned int, size_t>(rsrc_id.value(), idx));
-                m_name_to_shader_program_idx.insert(std::pair<std::string, size_t>(program_name, idx));
+                {
+                    std::unique_lock<std::shared_mutex> lock(m_shader_programs_mutex);
+                    idx = m_shader_programs.size();
+                    m_shader_programs.push_back(Resource<glowl::GLSLProgram>(rsrc_id));
+                    m_id_to_shader_program_idx.insert(std::pair<unsigned int, size_t>(rsrc_id.value(), idx));
+                    m_name_to_shader_program_idx.insert(std::pair<std::string, size_t>(program_name, idx));
+                }
+
+                try
+                {
+                    ShaderSourceList shader_srcs = loadShaderSources(shader_filenames, additional_cs_defines);
+                    uint64_t program_hash = computeProgramHash(shader_srcs);
+
+                    buildShaderProgram(idx, program_name, shader_srcs, program_hash, loadProgramBinary(program_hash));
+                }
+                catch (std::runtime_error const& exc)
+                {
+                    std::cerr << "Exception ResourceManager::createShaderProgram \"" << program_name << "\" : " << exc.what() << std::endl;
+                }
+
+                std::shared_lock<std::shared_mutex> lock(m_shader_programs_mutex);
+                return WeakResource<glowl::GLSLProgram>(m_shader_programs[idx].id, m_shader_programs[idx].resource.get(), m_shader_programs[idx].state);
+            }
+
+            ResourceID ResourceManager::createShaderProgramAsync(
+                std::string const& program_name,
+                std::shared_ptr<std::vector<ShaderFilename>> const& shader_filenames,
+                std::string const& additional_cs_defines)
+            {
+                // check if program of same name already exits
+                {
+                    std::shared_lock<std::shared_mutex> prgm_lock(m_shader_programs_mutex);
+                    auto search = m_name_to_shader_program_idx.find(program_name);
+                    if (search != m_name_to_shader_program_idx.end())
+                        return m_shader_programs[search->second].id;
+                }
+
+                size_t idx;
+                ResourceID rsrc_id = generateResourceID();
+
+                {
+                    std::unique_lock<std::shared_mutex> lock(m_shader_programs_mutex);
+                    idx = m_shader_programs.size();
+                    m_shader_programs.push_back(Resource<glowl::GLSLProgram>(rsrc_id));
+                    m_name_to_shader_program_idx.insert(std::pair<std::string, size_t>(program_name, idx));
+                    m_id_to_shader_program_idx.insert(std::pair<uint, size_t>(rsrc_id.value(), idx));
+                }
+
+                // file access, preprocessing and binary lookup don't need the GL context
+                auto prepare = [this, idx, program_name, shader_filenames, additional_cs_defines]() {
+                    ShaderSourceList shader_srcs;
+                    try
+                    {
+                        shader_srcs = loadShaderSources(*shader_filenames, additional_cs_defines);
+                    }
+                    catch (std::runtime_error const& exc)
+                    {
+                        std::cerr << "Exception ResourceManager::createShaderProgramAsync \"" << program_name << "\" : " << exc.what() << std::endl;
+                        return;
+                    }
+
+                    uint64_t program_hash = computeProgramHash(shader_srcs);
+                    auto program_binary = loadProgramBinary(program_hash);
+
+                    m_renderThread_tasks.push([this, idx, program_name, shader_srcs, program_hash, program_binary]() {
+                        buildShaderProgram(idx, program_name, shader_srcs, program_hash, program_binary);
+                    });
+                };
 
+                if (m_shader_tasks_enabled) {
+                    m_shader_task_scheduler.submitTask(prepare);
+                }
+                else {
+                    m_renderThread_tasks.push(prepare);
+                }
+
+                return rsrc_id;
+            }
+
+            ResourceManager::ShaderSourceList ResourceManager::loadShaderSources(
+                std::vector<ShaderFilename> const& shader_filenames,
+                std::string const& additional_cs_defines)
+            {
                 std::string vertex_src;
                 std::string tessellationControl_src;
                 std::string tessellationEvaluation_src;
@@ -145,11 +249,10 @@ namespace EngineCore
                 std::string fragment_src;
                 std::string compute_src;
 
-                size_t cs_define_insertion;
-
                 for (auto& shader_filename : shader_filenames)
                 {
-                    auto shader_src = ResourceLoading::readShaderFile(shader_filename.first.c_str());
+                    bool is_compute = shader_filename.second == glowl::GLSLProgram::ShaderType::Compute;
+                    auto shader_src = m_shader_preprocessor.preprocess(shader_filename.first, is_compute ? additional_cs_defines : "")->source;
 
                     switch (shader_filename.second)
                     {
@@ -170,21 +273,13 @@ namespace EngineCore
                         break;
                     case glowl::GLSLProgram::ShaderType::Compute:
                         compute_src = shader_src;
-
-                        if (!compute_src.empty()) {
-                            cs_define_insertion = compute_src.find("#version"); // find beginning of shader, i.e. version statement
-                            cs_define_insertion = compute_src.find("\n", cs_define_insertion); // go to end of that line
-                            cs_define_insertion += 2; // and move to the next line
-                            compute_src.insert(cs_define_insertion, additional_cs_defines);
-                        }
-
                         break;
                     default:
                         break;
                     }
                 }
 
-                std::vector<std::pair<glowl::GLSLProgram::ShaderType, std::string>> shader_srcs;
+                ShaderSourceList shader_srcs;
 
                 if (!vertex_src.empty())
                     shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::Vertex,vertex_src });
@@ -199,16 +294,69 @@ namespace EngineCore
                 if (!compute_src.empty())
                     shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::Compute,compute_src });
 
-                try
+                return shader_srcs;
+            }
+
+            std::shared_ptr<ProgramBinaryCache::ProgramBinary const> ResourceManager::loadProgramBinary(uint64_t program_hash)
+            {
+                if (!m_program_binary_cache.isEnabled())
+                    return nullptr;
+
+                auto program_binary = std::make_shared<ProgramBinaryCache::ProgramBinary>();
+                if (!m_program_binary_cache.load(program_hash, *program_binary))
+                    return nullptr;
+
+                return program_binary;
+            }
+
+            void ResourceManager::buildShaderProgram(
+                size_t idx,
+                std::string const& program_name,
+                ShaderSourceList const& shader_srcs,
+                uint64_t program_hash,
+                std::shared_ptr<ProgramBinaryCache::ProgramBinary const> const& program_binary)
+            {
+                GLuint handle = 0;
+
+                if (program_binary != nullptr && program_binary->driver == getDriverIdentification())
                 {
-                    m_shader_programs[idx].resource = std::make_unique<glowl::GLSLProgram>(shader_srcs);
+                    // the binary replaces compiling and linking, no shader objects are needed
+                    handle = glCreateProgram();
+
+                    glProgramBinary(
+                        handle,
+                        static_cast<GLenum>(program_binary->format),
+                        program_binary->data.data(),
+                        static_cast<GLsizei>(program_binary->data.size()));
+
+                    GLint link_status = GL_FALSE;
+                    glGetProgramiv(handle, GL_LINK_STATUS, &link_status);
+                    if (link_status != GL_TRUE)
+                    {
+                        glDeleteProgram(handle);
+                        handle = 0;
+                        m_program_binary_cache.remove(program_hash);
+                    }
                 }
-                catch (glowl::GLSLProgramException const& exc)
+
+                bool from_binary = handle != 0;
+
+                if (!from_binary)
                 {
-                    std::cerr<< exc.what() <<std::endl;
+                    std::string log;
+                    handle = linkShaderProgram(shader_srcs, m_program_binary_cache.isEnabled(), log);
+
+                    if (handle == 0)
+                    {
+                        std::cerr << "Failed to build shader program \"" << program_name << "\" :\n" << log << std::endl;
+                        return;
+                    }
                 }
 
-                m_shader_programs[idx].resource->setDebugLabel(program_name);
+                // glowl takes ownership of the linked program object
+                auto program = std::make_unique<glowl::GLSLProgram>(handle);
+
+                program->setDebugLabel(program_name);
 
                 for (auto& shaders : shader_srcs)
                 {
@@ -233,7 +381,7 @@ namespace EngineCore
                                 ss >> token; // this should be the variable name
 
                                 token.erase(token.end() - 1);
-                                m_shader_programs[idx].resource->bindAttribLocation(param_idx++, token.c_str());
+                                program->bindAttribLocation(param_idx++, token.c_str());
 
                                 //std::cout<<"Input parameter name: "<<buffer<<std::endl;
                             }
@@ -259,7 +407,7 @@ namespace EngineCore
                                 ss >> token; // this should be the variable name
 
                                 token.erase(token.end() - 1);
-                                m_shader_programs[idx].resource->bindFragDataLocation(param_idx++, token.c_str());
+                                program->bindFragDataLocation(param_idx++, token.c_str());
 
                                 //std::cout<<"Input parameter name: "<<buffer<<std::endl;
                             }
@@ -271,181 +419,142 @@ namespace EngineCore
                     }
                 }
 
-                std::cout << "Shader program creation log of \"" << m_shader_programs[idx].resource->getDebugLabel() << "\"" << std::endl;
-                //std::cout << m_shader_programs[idx].resource->getLog();
+                std::cout << "Shader program creation log of \"" << program->getDebugLabel() << "\"" << (from_binary ? " (program binary)" : "") << std::endl;
+                //std::cout << program->getLog();
 
-                m_shader_programs[idx].state = READY;
+                if (!from_binary && m_program_binary_cache.isEnabled())
+                {
+                    GLint binary_length = 0;
+                    glGetProgramiv(program->getHandle(), GL_PROGRAM_BINARY_LENGTH, &binary_length);
+
+                    if (binary_length > 0)
+                    {
+                        auto new_binary = std::make_shared<ProgramBinaryCache::ProgramBinary>();
+                        new_binary->driver = getDriverIdentification();
+                        new_binary->data.resize(binary_length);
+
+                        GLenum format = 0;
+                        GLsizei written = 0;
+                        glGetProgramBinary(program->getHandle(), binary_length, &written, &format, new_binary->data.data());
+                        new_binary->format = format;
+                        new_binary->data.resize(written);
+
+                        if (written > 0)
+                        {
+                            if (m_shader_tasks_enabled) {
+                                m_shader_task_scheduler.submitTask([this, program_hash, new_binary]() {
+                                    m_program_binary_cache.store(program_hash, *new_binary);
+                                });
+                            }
+                            else {
+                                m_program_binary_cache.store(program_hash, *new_binary);
+                            }
+                        }
+                    }
+                }
 
-                return WeakResource<glowl::GLSLProgram>(m_shader_programs.back().id, m_shader_programs.back().resource.get(), m_shader_programs.back().state);
+                std::unique_lock<std::shared_mutex> lock(m_shader_programs_mutex);
+                m_shader_programs[idx].resource = std::move(program);
+                m_shader_programs[idx].state = READY;
             }
 
-            ResourceID ResourceManager::createShaderProgramAsync(
-                std::string const& program_name,
-                std::shared_ptr<std::vector<ShaderFilename>> const& shader_filenames,
-                std::string const& additional_cs_defines)
+            GLuint ResourceManager::linkShaderProgram(ShaderSourceList const& shader_srcs, bool binary_retrievable, std::string& log)
             {
-                // check if program of same name already exits
-                {
-                    std::shared_lock<std::shared_mutex> prgm_lock(m_shader_programs_mutex);
-                    auto search = m_name_to_shader_program_idx.find(program_name);
-                    if (search != m_name_to_shader_program_idx.end())
-                        return m_shader_programs[search->second].id;
-                }
+                GLuint handle = glCreateProgram();
+                std::vector<GLuint> shaders;
 
-                size_t idx = m_shader_programs.size();
-                ResourceID rsrc_id = generateResourceID();
+                bool success = true;
 
+                for (auto const& shader_src : shader_srcs)
                 {
-                    std::unique_lock<std::shared_mutex> lock(m_shader_programs_mutex);
-                    m_shader_programs.push_back(Resource<glowl::GLSLProgram>(rsrc_id));
-                    m_name_to_shader_program_idx.insert(std::pair<std::string, size_t>(program_name, idx));
-                    m_id_to_shader_program_idx.insert(std::pair<uint, size_t>(m_shader_programs.back().id.value(), idx));
-                }
+                    GLuint shader = glCreateShader(static_cast<GLenum>(shader_src.first));
+                    shaders.push_back(shader);
 
-                m_renderThread_tasks.push([this, idx, program_name, shader_filenames, additional_cs_defines]() {
-                    //m_renderThread_tasks.push([this,idx,name,paths]() {
-                    
-                    std::string vertex_src;
-                    std::string tessellationControl_src;
-                    std::string tessellationEvaluation_src;
-                    std::string geometry_src;
-                    std::string fragment_src;
-                    std::string compute_src;
+                    GLchar const* src = shader_src.second.c_str();
+                    glShaderSource(shader, 1, &src, nullptr);
+                    glCompileShader(shader);
 
-                    size_t cs_define_insertion;
+                    GLint compile_status = GL_FALSE;
+                    glGetShaderiv(shader, GL_COMPILE_STATUS, &compile_status);
 
-                    for (auto& shader_filename : *shader_filenames)
+                    if (compile_status != GL_TRUE)
                     {
-                        auto shader_src = ResourceLoading::readShaderFile(shader_filename.first.c_str());
-
-                        switch (shader_filename.second)
-                        {
-                        case glowl::GLSLProgram::ShaderType::Vertex:
-                            vertex_src = shader_src;
-                            break;
-                        case glowl::GLSLProgram::ShaderType::Fragment:
-                            fragment_src = shader_src;
-                            break;
-                        case glowl::GLSLProgram::ShaderType::Geometry:
-                            geometry_src = shader_src;
-                            break;
-                        case glowl::GLSLProgram::ShaderType::TessControl:
-                            tessellationControl_src = shader_src;
-                            break;
-                        case glowl::GLSLProgram::ShaderType::TessEvaluation:
-                            tessellationEvaluation_src = shader_src;
-                            break;
-                        case glowl::GLSLProgram::ShaderType::Compute:
-                            compute_src = shader_src;
-
-                            cs_define_insertion = compute_src.find("#version"); // find beginning of shader, i.e. version statement
-                            cs_define_insertion = compute_src.find("\n", cs_define_insertion); // go to end of that line
-                            cs_define_insertion += 2; // and move to the next line
-                            compute_src.insert(cs_define_insertion, additional_cs_defines);
-
-                            break;
-                        default:
-                            break;
-                        }
+                        GLint log_length = 0;
+                        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_length);
+                        std::string shader_log(std::max(log_length, 1), '\0');
+                        glGetShaderInfoLog(shader, log_length, nullptr, shader_log.data());
+                        log += shader_log;
+                        success = false;
+                        break;
                     }
 
-                    std::vector<std::pair<glowl::GLSLProgram::ShaderType, std::string>> shader_srcs;
-
-                    if (!vertex_src.empty())
-                        shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::Vertex,vertex_src });
-                    if (!fragment_src.empty())
-                        shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::Fragment,fragment_src });
-                    if (!geometry_src.empty())
-                        shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::Geometry,geometry_src });
-                    if (!tessellationControl_src.empty())
-                        shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::TessControl,tessellationControl_src });
-                    if (!tessellationEvaluation_src.empty())
-                        shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::TessEvaluation, tessellationEvaluation_src });
-                    if (!compute_src.empty())
-                        shader_srcs.push_back({ glowl::GLSLProgram::ShaderType::Compute,compute_src });
+                    glAttachShader(handle, shader);
+                }
 
-                    try
-                    {
-                        m_shader_programs[idx].resource = std::make_unique<glowl::GLSLProgram>(shader_srcs);
-                    }
-                    catch (glowl::GLSLProgramException const& exc)
-                    {
-                        std::cerr << exc.what() << std::endl;
+                if (success)
+                {
+                    // has to be set before linking, drivers might not keep the binary otherwise
+                    if (binary_retrievable) {
+                        glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
                     }
 
-                    //m_shader_programs[idx].resource = std::make_unique<glowl::GLSLProgram>(shader_srcs);
-                    m_shader_programs[idx].state = READY;
-                    m_shader_programs[idx].resource->setDebugLabel(program_name);
+                    glLinkProgram(handle);
 
+                    GLint link_status = GL_FALSE;
+                    glGetProgramiv(handle, GL_LINK_STATUS, &link_status);
 
-                    for (auto& shaders : shader_srcs)
+                    if (link_status != GL_TRUE)
                     {
-                        switch (shaders.first)
-                        {
-                        case glowl::GLSLProgram::ShaderType::Vertex:
-                            {
-                                //TODO Scan vertex shader for input parameters
-                                unsigned int param_idx = 0;
-                                std::string line;
-                                std::istringstream tokenStream(shaders.second);
-                                while (std::getline(tokenStream, line, '\n'))
-                                {
-                                    std::stringstream ss(line);
-                                    std::string token;
-
-                                    ss >> token;
-
-                                    if (std::strcmp("in", token.c_str()) == 0)
-                                    {
-                                        ss >> token; // this should be the data type
-                                        ss >> token; // this should be the variable name
-
-                                        token.erase(token.end() - 1);
-                                        m_shader_programs[idx].resource->bindAttribLocation(param_idx++, token.c_str());
-
-                                        //std::cout<<"Input parameter name: "<<buffer<<std::endl;
-                                    }
-                                }
-                            }
-                            break;
-                        case glowl::GLSLProgram::ShaderType::Fragment:
-                            {
-                                // And scan fragment shader for output parameters
-                                unsigned int param_idx = 0;
-                                std::string line;
-                                std::istringstream tokenStream(shaders.second);
-                                while (std::getline(tokenStream, line, '\n'))
-                                {
-                                    std::stringstream ss(line);
-                                    std::string token;
-
-                                    ss >> token;
-
-                                    if (std::strcmp("in", token.c_str()) == 0)
-                                    {
-                                        ss >> token; // this should be the data type
-                                        ss >> token; // this should be the variable name
-
-                                        token.erase(token.end() - 1);
-                                        m_shader_programs[idx].resource->bindFragDataLocation(param_idx++, token.c_str());
-
-                                        //std::cout<<"Input parameter name: "<<buffer<<std::endl;
-                                    }
-                                }
-                            }
-                            break;
-                        default:
-                            break;
-                        }
+                        GLint log_length = 0;
+                        glGetProgramiv(handle, GL_INFO_LOG_LENGTH, &log_length);
+                        std::string program_log(std::max(log_length, 1), '\0');
+                        glGetProgramInfoLog(handle, log_length, nullptr, program_log.data());
+                        log += program_log;
+                        success = false;
                     }
+                }
 
-                    std::cout << "Shader program creation log of \"" << m_shader_programs[idx].resource->getDebugLabel() << "\"" << std::endl;
-                    //std::cout << m_shader_programs[idx].resource->getLog();
+                // shaders are only needed for linking
+                for (auto shader : shaders)
+                {
+                    glDetachShader(handle, shader);
+                    glDeleteShader(shader);
+                }
 
-                    m_shader_programs[idx].state = READY;
-                });
+                if (!success)
+                {
+                    glDeleteProgram(handle);
+                    return 0;
+                }
 
-                return m_shader_programs.back().id;
+                return handle;
+            }
+
+            std::string const& ResourceManager::getDriverIdentification()
+            {
+                if (m_driver_identification.empty())
+                {
+                    auto getString = [](GLenum name) {
+                        auto str = reinterpret_cast<char const*>(glGetString(name));
+                        return std::string(str != nullptr ? str : "");
+                    };
+
+                    m_driver_identification = getString(GL_VENDOR) + " / " + getString(GL_RENDERER) + " / " + getString(GL_VERSION);
+                }
+
+                return m_driver_identification;
+            }
+
+            uint64_t ResourceManager::computeProgramHash(ShaderSourceList const& shader_srcs)
+            {
+                uint64_t hash = ShaderPreprocessor::computeHash(nullptr, 0);
+                for (auto const& shader_src : shader_srcs)
+                {
+                    uint32_t shader_type = static_cast<uint32_t>(shader_src.first);
+                    hash = ShaderPreprocessor::computeHash(&shader_type, sizeof(shader_type), hash);
+                    hash = ShaderPreprocessor::computeHash(shader_src.second, hash);
+                }
+                return hash;
             }
 
 
@@ -516,6 +625,194 @@ namespace EngineCore
                 return m_textures_2d[idx].id;
             }
 
+            ResourceID ResourceManager::allocateTexture2DAsync(std::string const& name)
+            {
+                {
+                    std::shared_lock<std::shared_mutex> tex_lock(m_textures_2d_mutex);
+                    auto search = m_name_to_textures_2d_idx.find(name);
+                    if (search != m_name_to_textures_2d_idx.end())
+                        return m_textures_2d[search->second].id;
+                }
+
+                std::unique_lock<std::shared_mutex> lock(m_textures_2d_mutex);
+
+                size_t idx = m_textures_2d.size();
+                ResourceID rsrc_id = generateResourceID();
+
+                m_textures_2d.push_back(Resource<glowl::Texture2D>(rsrc_id));
+                m_id_to_textures_2d_idx.insert(std::pair<unsigned int, size_t>(rsrc_id.value(), idx));
+                m_name_to_textures_2d_idx.insert(std::pair<std::string, size_t>(name, idx));
+
+                return m_textures_2d[idx].id;
+            }
+
+            void ResourceManager::updateTexture2DAsync(
+                ResourceID rsrc_id,
+                std::string const& name,
+                glowl::TextureLayout const& layout,
+                std::shared_ptr<std::vector<std::vector<uint8_t>>> const& mip_levels)
+            {
+                m_renderThread_tasks.push([this, rsrc_id, name, layout, mip_levels]() {
+                    std::unique_lock<std::shared_mutex> tex_lock(m_textures_2d_mutex);
+
+                    auto query = m_id_to_textures_2d_idx.find(rsrc_id.value());
+
+                    if (query == m_id_to_textures_2d_idx.end() || mip_levels->empty())
+                    {
+                        std::cerr << "ResourceManager - failed to update texture \"" << name << "\"" << std::endl;
+                        return;
+                    }
+
+                    size_t idx = query->second;
+
+                    glowl::TextureLayout mip_layout = layout;
+                    mip_layout.levels = static_cast<GLsizei>(mip_levels->size());
+
+                    bool compressed = isCompressedInternalFormat(mip_layout.internal_format);
+
+                    // tightly packed rows, e.g. for RGB8 data with odd widths
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+                    try
+                    {
+                        // allocate all levels but don't generate them on the GPU, uncompressed level 0 is uploaded with the texture creation
+                        m_textures_2d[idx].resource = std::make_unique<glowl::Texture2D>(
+                            name, mip_layout, compressed ? nullptr : mip_levels->front().data(), false, true);
+                    }
+                    catch (glowl::TextureException const& e)
+                    {
+                        std::cerr << "Exception ResourceManager::updateTexture2DAsync \"" << name << "\" : " << e.what() << std::endl;
+                        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                        return;
+                    }
+
+                    for (size_t level = compressed ? 0 : 1; level < mip_levels->size(); ++level)
+                    {
+                        uploadTexture2DLevel(m_textures_2d[idx].resource->getName(), mip_layout, static_cast<GLint>(level), (*mip_levels)[level]);
+                    }
+
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+                    m_textures_2d[idx].state = READY;
+                });
+            }
+
+            void ResourceManager::updateTexture2DLevelsAsync(
+                ResourceID rsrc_id,
+                std::string const& name,
+                glowl::TextureLayout const& layout,
+                uint32_t first_level,
+                uint32_t prev_first_level,
+                std::shared_ptr<std::vector<std::vector<uint8_t>>> const& mip_levels,
+                std::function<void()> const& uploaded)
+            {
+                m_renderThread_tasks.push([this, rsrc_id, name, layout, first_level, prev_first_level, mip_levels, uploaded]() {
+                    {
+                        std::unique_lock<std::shared_mutex> tex_lock(m_textures_2d_mutex);
+
+                        auto query = m_id_to_textures_2d_idx.find(rsrc_id.value());
+
+                        uint32_t level_cnt = static_cast<uint32_t>(layout.levels);
+
+                        if (query == m_id_to_textures_2d_idx.end() || first_level >= level_cnt || first_level + mip_levels->size() > level_cnt)
+                        {
+                            std::cerr << "ResourceManager - failed to update texture levels of \"" << name << "\"" << std::endl;
+                            return;
+                        }
+
+                        size_t idx = query->second;
+
+                        // levels that are not uploaded have to be copied from the current storage
+                        uint32_t copy_level = first_level + static_cast<uint32_t>(mip_levels->size());
+                        if (copy_level < level_cnt && (m_textures_2d[idx].resource == nullptr || prev_first_level > copy_level))
+                        {
+                            std::cerr << "ResourceManager - missing texture levels of \"" << name << "\"" << std::endl;
+                            return;
+                        }
+
+                        // the storage only contains the levels from first_level on
+                        glowl::TextureLayout storage_layout = layout;
+                        storage_layout.width = std::max(1, layout.width >> first_level);
+                        storage_layout.height = std::max(1, layout.height >> first_level);
+                        storage_layout.levels = static_cast<GLsizei>(level_cnt - first_level);
+
+                        std::unique_ptr<glowl::Texture2D> storage;
+                        try
+                        {
+                            storage = std::make_unique<glowl::Texture2D>(name, storage_layout, nullptr, false, true);
+                        }
+                        catch (glowl::TextureException const& e)
+                        {
+                            std::cerr << "Exception ResourceManager::updateTexture2DLevelsAsync \"" << name << "\" : " << e.what() << std::endl;
+                            return;
+                        }
+
+                        // tightly packed rows, e.g. for RGB8 data with odd widths
+                        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+                        for (size_t i = 0; i < mip_levels->size(); ++i)
+                        {
+                            uploadTexture2DLevel(storage->getName(), storage_layout, static_cast<GLint>(i), (*mip_levels)[i]);
+                        }
+
+                        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+                        for (uint32_t level = copy_level; level < level_cnt; ++level)
+                        {
+                            glCopyImageSubData(
+                                m_textures_2d[idx].resource->getName(), GL_TEXTURE_2D, static_cast<GLint>(level - prev_first_level), 0, 0, 0,
+                                storage->getName(), GL_TEXTURE_2D, static_cast<GLint>(level - first_level), 0, 0, 0,
+                                std::max(1, layout.width >> level), std::max(1, layout.height >> level), 1);
+                        }
+
+                        // renderers query the bindless handle of the new texture object and make it resident on their next frame
+                        if (m_textures_2d[idx].resource != nullptr && glIsTextureHandleResidentARB(m_textures_2d[idx].resource->getTextureHandle())) {
+                            m_textures_2d[idx].resource->makeNonResident();
+                        }
+
+                        m_textures_2d[idx].resource = std::move(storage);
+                        m_textures_2d[idx].state = READY;
+                    }
+
+                    if (uploaded) {
+                        uploaded();
+                    }
+                });
+            }
+
+            void ResourceManager::uploadTexture2DLevel(
+                GLuint texture,
+                glowl::TextureLayout const& layout,
+                GLint level,
+                std::vector<uint8_t> const& texel_data)
+            {
+                GLsizei level_width = std::max(1, layout.width >> level);
+                GLsizei level_height = std::max(1, layout.height >> level);
+
+                if (isCompressedInternalFormat(layout.internal_format))
+                {
+                    glCompressedTextureSubImage2D(
+                        texture,
+                        level,
+                        0, 0,
+                        level_width, level_height,
+                        layout.internal_format,
+                        static_cast<GLsizei>(texel_data.size()),
+                        texel_data.data());
+                }
+                else
+                {
+                    glTextureSubImage2D(
+                        texture,
+                        level,
+                        0, 0,
+                        level_width, level_height,
+                        layout.format,
+                        layout.type,
+                        texel_data.data());
+                }
+            }
+
             WeakResource<glowl::Texture2DArray> ResourceManager::createTexture2DArray(
                 std::string const& name,
                 glowl::TextureLayout const& layout,
@@ -759,6 +1056,78 @@ namespace EngineCore
                     m_buffers[idx].state);
             }
 
+            WeakResource<glowl::BufferObject> ResourceManager::createPersistentlyMappedBufferObject(
+                std::string const& name,
+                GLenum target,
+                GLsizeiptr byte_size)
+            {
+                std::unique_lock<std::shared_mutex> lock(m_buffers_mutex);
+
+                size_t idx = m_buffers.size();
+
+                void* prev_mapping = nullptr;
+                GLsizeiptr prev_byte_size = 0;
+
+                auto search = m_name_to_buffer_idx.find(name);
+                if (search != m_name_to_buffer_idx.end())
+                {
+                    idx = search->second;
+
+                    auto mapping = m_persistent_buffer_mappings.find(m_buffers[idx].id.value());
+                    if (mapping != m_persistent_buffer_mappings.end()) {
+                        prev_mapping = mapping->second;
+                    }
+                    prev_byte_size = m_buffers[idx].resource->getByteSize();
+
+                    if (prev_mapping != nullptr && prev_byte_size >= byte_size)
+                        return WeakResource<glowl::BufferObject>(m_buffers[idx].id, m_buffers[idx].resource.get(), m_buffers[idx].state);
+                }
+                else
+                {
+                    ResourceID rsrc_id = generateResourceID();
+
+                    m_buffers.push_back(Resource<glowl::BufferObject>(rsrc_id));
+                    m_id_to_buffer_idx.insert(std::pair<unsigned int, size_t>(rsrc_id.value(), idx));
+                    m_name_to_buffer_idx.insert(std::pair<std::string, size_t>(name, idx));
+                }
+
+                GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+                // the mutable storage of the new buffer object is replaced with immutable storage that can be mapped persistently
+                auto buffer = std::make_unique<glowl::BufferObject>(target, nullptr, byte_size, GL_DYNAMIC_DRAW);
+                glNamedBufferStorage(buffer->getName(), byte_size, nullptr, flags);
+                void* mapping = glMapNamedBufferRange(buffer->getName(), 0, byte_size, flags);
+
+                if (mapping == nullptr)
+                {
+                    std::cerr << "ResourceManager - failed to map buffer \"" << name << "\"" << std::endl;
+                    return WeakResource<glowl::BufferObject>(m_buffers[idx].id, nullptr, NOT_READY);
+                }
+
+                // copy on the CPU, a copy on the GPU could overwrite data that is written to the new mapping before it executes
+                if (prev_mapping != nullptr) {
+                    std::memcpy(mapping, prev_mapping, static_cast<size_t>(std::min(prev_byte_size, byte_size)));
+                }
+
+                m_buffers[idx].resource = std::move(buffer);
+                m_buffers[idx].state = READY;
+                m_persistent_buffer_mappings[m_buffers[idx].id.value()] = mapping;
+
+                return WeakResource<glowl::BufferObject>(
+                    m_buffers[idx].id,
+                    m_buffers[idx].resource.get(),
+                    m_buffers[idx].state);
+            }
+
+            void* ResourceManager::getPersistentBufferMapping(ResourceID id) const
+            {
+                std::shared_lock<std::shared_mutex> lock(m_buffers_mutex);
+
+                auto search = m_persistent_buffer_mappings.find(id.value());
+
+                return search != m_persistent_buffer_mappings.end() ? search->second : nullptr;
+            }
+
             WeakResource<glowl::Texture2DArray> ResourceManager::getTexture2DArray(ResourceID id) const
             {
                 std::shared_lock<std::shared_mutex> texArr_lock(m_texArr_mutex);
@@ -17,6 +17,7 @@
 
 /*	std includes */
 #include <list>
+#include <functional>
 #include <fstream>
 #include <sstream>
 #include <memory>
@@ -30,6 +31,9 @@
 #include "../BaseResourceManager.hpp"
 #include "../EntityManager.hpp"
 #include "../GenericTextureLayout.hpp"
+#include "../ProgramBinaryCache.hpp"
+#include "../ShaderPreprocessor.hpp"
+#include "../TaskScheduler.hpp"
 #include "../types.hpp"
 
 #define DEBUG_OUTPUT 0
@@ -54,9 +58,9 @@ namespace EngineCore
                 typedef GLenum               IndexFormatType;
                 typedef GLenum               PrimitiveTopologyType;
 
-                ResourceManager() : BaseResourceManager() {}
+                ResourceManager() : BaseResourceManager(), m_shader_tasks_enabled(false) {}
                 ResourceManager(ResourceManager const & cpy) = delete;
-                ~ResourceManager() = default;
+                ~ResourceManager();
 
                 /** Returns log string */
                 std::string const& getLog() { return m_resourcelog; }
@@ -299,6 +303,21 @@ namespace EngineCore
                     case GenericTextureLayout::InternalFormat::RGBA32UI:
                         retval = GL_RGBA32UI;
                         break;
+                    case GenericTextureLayout::InternalFormat::BC1_RGBA:
+                        retval = 0x83F1; /*GL_COMPRESSED_RGBA_S3TC_DXT1_EXT*/
+                        break;
+                    case GenericTextureLayout::InternalFormat::BC3_RGBA:
+                        retval = 0x83F3; /*GL_COMPRESSED_RGBA_S3TC_DXT5_EXT*/
+                        break;
+                    case GenericTextureLayout::InternalFormat::BC4_R:
+                        retval = GL_COMPRESSED_RED_RGTC1;
+                        break;
+                    case GenericTextureLayout::InternalFormat::BC5_RG:
+                        retval = GL_COMPRESSED_RG_RGTC2;
+                        break;
+                    case GenericTextureLayout::InternalFormat::BC7_RGBA:
+                        retval = GL_COMPRESSED_RGBA_BPTC_UNORM;
+                        break;
                     default:
                         break;
                     }
@@ -307,6 +326,20 @@ namespace EngineCore
                 }
 
 
+                constexpr bool isCompressedInternalFormat(GLenum internal_format) {
+                    switch (internal_format)
+                    {
+                    case 0x83F1: /*GL_COMPRESSED_RGBA_S3TC_DXT1_EXT*/
+                    case 0x83F3: /*GL_COMPRESSED_RGBA_S3TC_DXT5_EXT*/
+                    case GL_COMPRESSED_RED_RGTC1:
+                    case GL_COMPRESSED_RG_RGTC2:
+                    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+                        return true;
+                    default:
+                        return false;
+                    }
+                }
+
                 TextureLayout convertGenericTextureLayout(GenericTextureLayout texture_layout)
                 {
                     TextureLayout retval;
@@ -389,6 +422,16 @@ namespace EngineCore
 #pragma region Create shader program
                 typedef std::pair<std::string, glowl::GLSLProgram::ShaderType> ShaderFilename;
 
+                /**
+                 * \brief Configure how shader programs are prepared.
+                 * Shader files are preprocessed (see ShaderPreprocessor) and linked programs are stored as program binaries,
+                 * keyed by a hash of the final sources. Programs with a matching binary skip compilation entirely.
+                 * \param worker_thread_cnt Number of threads reading and preprocessing the shader files of asynchronously created
+                 * programs and writing program binaries. Pass 0 to do all of this on the render thread.
+                 * \param cache_directory Directory for program binaries, an empty path disables the binary cache
+                 */
+                void setShaderProgramCache(int worker_thread_cnt, std::string const& cache_directory = "");
+
                 /**
                  * Creates a GLSLprogram object
                  * \param paths Gives the paths to all shader files.
@@ -399,6 +442,12 @@ namespace EngineCore
                     std::vector<ShaderFilename> const& shader_filenames,
                     std::string const& additional_cs_defines = "");
 
+                /**
+                 * \brief Creates a GLSLprogram object without blocking the calling thread.
+                 * Shader files are read on the shader worker threads (see setShaderProgramCache), only compilation or loading
+                 * of the program binary happens on the render thread. Use setShaderProgramFallback to render with a different
+                 * program until the program is ready.
+                 */
                 ResourceID createShaderProgramAsync(
                     std::string const& program_name,
                     std::shared_ptr<std::vector<ShaderFilename>> const& shader_filenames,
@@ -435,6 +484,50 @@ namespace EngineCore
                     bool generateMipmap = false
                 );
 
+                /**
+                 * \brief Reserve a 2D texture resource without creating the texture object yet.
+                 * The resource remains NOT_READY until texture data is provided via updateTexture2DAsync.
+                 * \param name Identifier for the texture
+                 * \return Returns the id of the new texture or of the existing texture if the name is already in use
+                 */
+                ResourceID allocateTexture2DAsync(std::string const& name);
+
+                /**
+                 * \brief (Re-)create a previously allocated 2D texture from a complete, CPU-side mip chain
+                 * \param rsrc_id Id of the texture resource
+                 * \param name Identifier for the texture (used as debug label)
+                 * \param layout Texture format and size of level 0, levels is set from the number of given mip levels.
+                 * Block compressed internal formats expect the encoded blocks of each level as texel data.
+                 * \param mip_levels Texel data for each mip level, starting with level 0
+                 */
+                void updateTexture2DAsync(
+                    ResourceID rsrc_id,
+                    std::string const& name,
+                    glowl::TextureLayout const& layout,
+                    std::shared_ptr<std::vector<std::vector<uint8_t>>> const& mip_levels);
+
+                /**
+                 * \brief (Re-)allocate the storage of a previously allocated 2D texture with the levels [first_level, layout.levels)
+                 * of its mip chain, e.g. for texture streaming. Level first_level becomes level 0 of the new storage.
+                 * Levels given in mip_levels are uploaded, all remaining levels are copied from the current storage.
+                 * The new texture object has a new bindless handle, renderers have to query handles after the upload.
+                 * \param rsrc_id Id of the texture resource
+                 * \param name Identifier for the texture (used as debug label)
+                 * \param layout Texture format, size and level count of the complete mip chain
+                 * \param first_level First mip level of the new storage
+                 * \param prev_first_level First mip level of the current storage, ignored if all levels are given in mip_levels
+                 * \param mip_levels Texel data for the levels first_level, first_level+1, ...
+                 * \param uploaded Called on the render thread after the new storage replaced the current one, can be empty
+                 */
+                void updateTexture2DLevelsAsync(
+                    ResourceID rsrc_id,
+                    std::string const& name,
+                    glowl::TextureLayout const& layout,
+                    uint32_t first_level,
+                    uint32_t prev_first_level,
+                    std::shared_ptr<std::vector<std::vector<uint8_t>>> const& mip_levels,
+                    std::function<void()> const& uploaded = nullptr);
+
                 WeakResource<glowl::Texture2DArray> createTexture2DArray(
                     std::string const& name,
                     const glowl::TextureLayout & layout,
@@ -508,6 +601,23 @@ namespace EngineCore
                     GLsizeiptr byte_size
                 );
 
+                /**
+                 * \brief Create a buffer object with immutable storage that stays persistently and coherently mapped, e.g. for data
+                 * that is partially rewritten every frame. If a smaller buffer with the given name exists, it is replaced by a larger
+                 * one that starts with a copy of its content. Has to be called on the render thread.
+                 * \param byte_size Minimum size of the buffer in bytes
+                 */
+                WeakResource<glowl::BufferObject> createPersistentlyMappedBufferObject(
+                    std::string const& name,
+                    GLenum target,
+                    GLsizeiptr byte_size);
+
+                /**
+                 * \brief Returns the mapping of a buffer created with createPersistentlyMappedBufferObject, or nullptr for other buffers.
+                 * The mapping is invalidated when the buffer is replaced by a larger one.
+                 */
+                void* getPersistentBufferMapping(ResourceID id) const;
+
                 WeakResource<glowl::Texture2DArray> getTexture2DArray(ResourceID id) const;
                 WeakResource<glowl::FramebufferObject> getFramebufferObject(std::string const& name) const;
 
@@ -519,6 +629,55 @@ namespace EngineCore
                     GLsizeiptr byte_size
                 );
 
+                typedef std::vector<std::pair<glowl::GLSLProgram::ShaderType, std::string>> ShaderSourceList;
+
+                /**
+                 * Read and preprocess all shader files of a program. Throws std::runtime_error if a file can't be read.
+                 */
+                ShaderSourceList loadShaderSources(
+                    std::vector<ShaderFilename> const& shader_filenames,
+                    std::string const& additional_cs_defines);
+
+                /**
+                 * Look up the cached program binary for the given program hash, returns nullptr if there is none
+                 */
+                std::shared_ptr<ProgramBinaryCache::ProgramBinary const> loadProgramBinary(uint64_t program_hash);
+
+                /**
+                 * Create the program at the given index from its binary or its sources and store a binary for later runs.
+                 * Has to be called on the render thread.
+                 */
+                void buildShaderProgram(
+                    size_t idx,
+                    std::string const& program_name,
+                    ShaderSourceList const& shader_srcs,
+                    uint64_t program_hash,
+                    std::shared_ptr<ProgramBinaryCache::ProgramBinary const> const& program_binary);
+
+                /**
+                 * Vendor, renderer and version of the GL driver. Has to be called on the render thread.
+                 */
+                std::string const& getDriverIdentification();
+
+                static uint64_t computeProgramHash(ShaderSourceList const& shader_srcs);
+
+                /**
+                 * Compile and link a program object from sources. Has to be called on the render thread.
+                 * \param binary_retrievable Set GL_PROGRAM_BINARY_RETRIEVABLE_HINT before linking, e.g. for the program binary cache
+                 * \param log Receives compile and link errors
+                 * \return Returns the linked program object or 0 on failure
+                 */
+                static GLuint linkShaderProgram(ShaderSourceList const& shader_srcs, bool binary_retrievable, std::string& log);
+
+                /**
+                 * Upload the texel data of a single mip level of a texture with immutable storage. Has to be called on the render thread.
+                 */
+                void uploadTexture2DLevel(
+                    GLuint texture,
+                    glowl::TextureLayout const& layout,
+                    GLint level,
+                    std::vector<uint8_t> const& texel_data);
+
             private:
                 /** Log string */
                 std::string m_resourcelog;
@@ -541,6 +700,18 @@ namespace EngineCore
                 mutable std::shared_mutex m_texArr_mutex;
                 mutable std::shared_mutex m_texCubeArr_mutex;
                 mutable std::shared_mutex m_fbo_mutex;
+
+                /** Mappings of persistently mapped buffers by resource id, guarded by the buffer mutex */
+                std::unordered_map<uint, void*> m_persistent_buffer_mappings;
+
+                /*
+                 * Shader program preparation
+                 */
+                ShaderPreprocessor                 m_shader_preprocessor;
+                ProgramBinaryCache                 m_program_binary_cache;
+                EngineCore::Utility::TaskScheduler m_shader_task_scheduler;
+                bool                               m_shader_tasks_enabled;
+                std::string                        m_driver_identification;
             };
 
             template<typename VertexContainer, typename IndexContainer>
@@ -1,5 +1,8 @@
 #include "SkinnedMeshRenderPass.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
@@ -30,18 +33,18 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
         {
             Mat4x4 transform;
 
-            GLint joint_index_offset;
+            GLint   joint_index_offset;          ///< Current evaluation of the skin in the slotted joint palette
+            GLint   previous_joint_index_offset; ///< Previous evaluation of the skin in the slotted joint palette
+            GLfloat joint_blend;                 ///< Interpolation factor from the previous to the current evaluation
 
             GLint padding0;
-            GLint padding1;
-            GLint padding2;
         };
 
         // static mesh (shader) params per object per batch
         std::vector<std::vector<SkinnedMeshParams>>   skinned_mesh_params;
         std::vector<std::vector<DrawElementsCommand>> skinned_mesh_drawCommands;
 
-        std::vector<Mat4x4> joint_matrices;
+        size_t joint_palette_size; ///< Number of joint matrices of the slotted joint palette
 
         Mat4x4 view_matrix;
         Mat4x4 proj_matrix;
@@ -89,8 +92,11 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
             // check for existing gBuffer
             resources.m_render_target = resource_mngr.getFramebufferObject("GBuffer");
 
-            // check for existing joint matrix buffer
-            resources.joint_matrices = resource_mngr.getBufferResource("skinnedMeshPass_joint_matrices_" + std::to_string(frame.m_frameID % 2));
+            // compute joint matrices of all skins at once, skins shared by multiple meshes are only computed once.
+            // distant skins are updated at reduced rates and with reduced bone sets depending on the animation LOD tiers,
+            // only evaluated skins are written to the joint palette in the resource setup phase
+            skin_mngr.updateJointPaletteSlots(transform_mngr, transform_mngr.getWorldPosition(camera_transform_idx), frame.m_frameID);
+            data.joint_palette_size = skin_mngr.getJointPaletteSize() * Animation::SkinComponentManager::JOINT_PALETTE_SLOT_CNT;
 
             // set per object data
             auto objs = renderTask_mngr.getComponentDataCopy();
@@ -124,18 +130,11 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
                 SkinnedMeshPassData::SkinnedMeshParams params;
 
                 params.transform = transform_mngr.getWorldTransformation(obj.cached_transform_idx);
-                params.joint_index_offset = data.joint_matrices.size();
-
-                //compute joint matrices
-                auto const& joints = skin_mngr.getJoints(obj.entity);
-                auto const& inverse_bind_matrices = skin_mngr.getInvsereBindMatrices(obj.entity);
-                for (int i = 0; i < joints.size(); ++i) {
-                    auto const& joint_world_matrix = transform_mngr.getWorldTransformation(transform_mngr.getIndex(joints[i]));
-                    auto const& inverse_bind_matrix = inverse_bind_matrices[i];
 
-                    Mat4x4 joint_matrix = glm::inverse(params.transform) * joint_world_matrix * inverse_bind_matrix;
-                    data.joint_matrices.push_back(joint_matrix);
-                }
+                auto joint_palette_blend = skin_mngr.getJointPaletteBlend(obj.entity);
+                params.joint_index_offset = static_cast<GLint>(joint_palette_blend.current_offset);
+                params.previous_joint_index_offset = static_cast<GLint>(joint_palette_blend.previous_offset);
+                params.joint_blend = joint_palette_blend.t;
 
                 data.skinned_mesh_params.back().push_back(params);
 
@@ -159,23 +158,26 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
                 resources.m_render_target = resource_mngr.getFramebufferObject("GBuffer");
             }
 
-            if (resources.joint_matrices.state != READY)
-            {
-                resources.joint_matrices = resource_mngr.createBufferObject(
-                    "skinnedMeshPass_joint_matrices_" + std::to_string(frame.m_frameID % 2),
-                    GL_SHADER_STORAGE_BUFFER,
-                    data.joint_matrices
-                );
-            }
-            else
+            // a single joint palette is enough, writes never touch the slots sampled by the previous frame
+            resources.joint_matrices = resource_mngr.createPersistentlyMappedBufferObject(
+                "skinnedMeshPass_joint_palette",
+                GL_SHADER_STORAGE_BUFFER,
+                static_cast<GLsizeiptr>(std::max<size_t>(data.joint_palette_size, 1) * sizeof(Mat4x4)));
+
+            // write the skins evaluated since the last rendered frame, including those of frames that were dropped
+            Animation::JointPaletteWrites joint_palette_writes;
+            world_state.get<Animation::SkinComponentManager>().takeJointPaletteWrites(frame.m_frameID, joint_palette_writes);
+
+            auto joint_palette = static_cast<Mat4x4*>(resource_mngr.getPersistentBufferMapping(resources.joint_matrices.id));
+
+            if (joint_palette != nullptr)
             {
-                try
-                {
-                    resources.joint_matrices.resource->rebuffer(data.joint_matrices);
-                }
-                catch (glowl::BufferObjectException const& e)
+                Mat4x4 const* joint_matrices = joint_palette_writes.joint_matrices.data();
+
+                for (auto const& range : joint_palette_writes.ranges)
                 {
-                    std::cerr << "Exception in skinned mesh pass resource setup - joint matrix rebuffer: " << e.what() << std::endl;
+                    std::memcpy(joint_palette + range.first, joint_matrices, range.second * sizeof(Mat4x4));
+                    joint_matrices += range.second;
                 }
             }
 
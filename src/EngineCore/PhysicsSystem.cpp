@@ -0,0 +1,224 @@
+#include "PhysicsSystem.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace EngineCore
+{
+    namespace Physics
+    {
+
+        PhysicsSystem::PhysicsSystem(WorldState& world, float fixed_timestep, uint max_substeps)
+            : m_world(world),
+            m_fixed_timestep(fixed_timestep > 0.0f ? fixed_timestep : 1.0f / 120.0f),
+            m_max_substeps(max_substeps),
+            m_accumulator(0.0),
+            m_interpolation_alpha(0.0f),
+            m_last_substep_cnt(0),
+            m_step_cnt(0)
+        {
+            assert(fixed_timestep > 0.0f);
+
+            // a single worker keeps asynchronous updates in submission order
+            m_task_scheduler.run(1);
+        }
+
+        PhysicsSystem::~PhysicsSystem()
+        {
+            m_task_scheduler.waitWhileBusy();
+            m_task_scheduler.stop();
+        }
+
+        void PhysicsSystem::setFixedTimestep(float fixed_timestep)
+        {
+            assert(fixed_timestep > 0.0f);
+
+            // a non-positive timestep would never advance the accumulator
+            if (!(fixed_timestep > 0.0f))
+                return;
+
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            m_fixed_timestep = fixed_timestep;
+        }
+
+        float PhysicsSystem::getFixedTimestep() const
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            return m_fixed_timestep;
+        }
+
+        void PhysicsSystem::setMaxSubsteps(uint max_substeps)
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            m_max_substeps = max_substeps;
+        }
+
+        void PhysicsSystem::addSimulation(Simulation const& simulation)
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            m_simulations.push_back(simulation);
+        }
+
+        void PhysicsSystem::addInterpolatedEntity(Entity entity)
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            m_interpolated_entities.push_back(InterpolatedEntity(entity));
+        }
+
+        void PhysicsSystem::removeInterpolatedEntity(Entity entity)
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+
+            m_interpolated_entities.erase(
+                std::remove_if(m_interpolated_entities.begin(), m_interpolated_entities.end(),
+                    [entity](InterpolatedEntity const& e) { return e.entity.id() == entity.id(); }),
+                m_interpolated_entities.end());
+        }
+
+        void PhysicsSystem::update(double frame_dt)
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+
+            auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
+
+            size_t entity_cnt = m_interpolated_entities.size();
+
+            std::vector<size_t> transform_indices(entity_cnt);
+            std::vector<Vec3>   positions(entity_cnt);
+            std::vector<Quat>   orientations(entity_cnt);
+            std::vector<Vec3>   scales(entity_cnt);
+
+            // restore the simulated state that was replaced by the interpolated state of the last update
+            for (size_t i = 0; i < entity_cnt; ++i)
+            {
+                auto& e = m_interpolated_entities[i];
+
+                transform_indices[i] = transform_mngr.getIndex(e.entity);
+                scales[i] = transform_mngr.getScale(transform_indices[i]);
+
+                Vec3 position = transform_mngr.getPosition(transform_indices[i]);
+                Quat orientation = transform_mngr.getOrientation(transform_indices[i]);
+
+                // new entities and entities that were moved externally start from their current transformation
+                if (!e.initialized || position != e.rendered_position || orientation != e.rendered_orientation)
+                {
+                    e.previous_position = e.current_position = position;
+                    e.previous_orientation = e.current_orientation = orientation;
+                    e.initialized = true;
+                }
+
+                positions[i] = e.current_position;
+                orientations[i] = e.current_orientation;
+            }
+
+            if (entity_cnt > 0) {
+                transform_mngr.setLocalTransforms(transform_indices, positions, orientations, scales);
+            }
+
+            m_accumulator += frame_dt;
+
+            uint step_cnt = static_cast<uint>(std::min(std::floor(m_accumulator / m_fixed_timestep), static_cast<double>(m_max_substeps)));
+
+            for (uint step = 0; step < step_cnt; ++step)
+            {
+                // only the last two steps are needed for interpolation
+                if (step + 1 == step_cnt) {
+                    storeSimulatedState(transform_indices, true);
+                }
+
+                for (auto& simulation : m_simulations) {
+                    simulation(m_fixed_timestep);
+                }
+            }
+
+            m_accumulator -= step_cnt * m_fixed_timestep;
+
+            // drop time that exceeds the substep budget
+            if (m_accumulator >= m_fixed_timestep) {
+                m_accumulator = std::fmod(m_accumulator, static_cast<double>(m_fixed_timestep));
+            }
+
+            if (step_cnt > 0) {
+                storeSimulatedState(transform_indices, false);
+            }
+
+            m_interpolation_alpha = static_cast<float>(m_accumulator / m_fixed_timestep);
+            m_last_substep_cnt = step_cnt;
+            m_step_cnt += step_cnt;
+
+            for (size_t i = 0; i < entity_cnt; ++i)
+            {
+                auto& e = m_interpolated_entities[i];
+
+                e.rendered_position = glm::mix(e.previous_position, e.current_position, m_interpolation_alpha);
+                e.rendered_orientation = glm::slerp(e.previous_orientation, e.current_orientation, m_interpolation_alpha);
+
+                positions[i] = e.rendered_position;
+                orientations[i] = e.rendered_orientation;
+            }
+
+            if (entity_cnt > 0) {
+                transform_mngr.setLocalTransforms(transform_indices, positions, orientations, scales);
+            }
+        }
+
+        void PhysicsSystem::updateAsync(double frame_dt)
+        {
+            m_task_scheduler.submitTask([this, frame_dt]() {
+                update(frame_dt);
+            });
+        }
+
+        void PhysicsSystem::waitForSimulation()
+        {
+            m_task_scheduler.waitWhileBusy();
+        }
+
+        float PhysicsSystem::getInterpolationAlpha() const
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            return m_interpolation_alpha;
+        }
+
+        uint PhysicsSystem::getLastSubstepCount() const
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            return m_last_substep_cnt;
+        }
+
+        size_t PhysicsSystem::getStepCount() const
+        {
+            std::unique_lock<std::mutex> lock(m_update_mutex);
+            return m_step_cnt;
+        }
+
+        void PhysicsSystem::storeSimulatedState(std::vector<size_t> const& transform_indices, bool previous)
+        {
+            auto& transform_mngr = m_world.get<EngineCore::Common::TransformComponentManager>();
+
+            for (size_t i = 0; i < m_interpolated_entities.size(); ++i)
+            {
+                auto& e = m_interpolated_entities[i];
+
+                Vec3 const& position = transform_mngr.getPosition(transform_indices[i]);
+                Quat const& orientation = transform_mngr.getOrientation(transform_indices[i]);
+
+                if (previous)
+                {
+                    e.previous_position = position;
+                    e.previous_orientation = orientation;
+                }
+                else
+                {
+                    e.current_position = position;
+                    e.current_orientation = orientation;
+                }
+            }
+        }
+
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef PhysicsSystem_hpp
+#define PhysicsSystem_hpp
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    class WorldState;
+
+    namespace Physics
+    {
+        /**
+         * \class PhysicsSystem
+         *
+         * \brief Advances all physics simulations with a fixed timestep, independent of the frame rate.
+         *
+         * Frame time (i.e. BaseFrame::m_simulation_dt) is accumulated and consumed in fixed steps, at most
+         * max_substeps per update. Time that exceeds the substep budget is dropped, so that a slow frame does not
+         * cause ever longer updates.
+         *
+         * Entities whose transformations are written by the simulations are registered as interpolated entities.
+         * While the simulation runs they hold their simulated transformation, after each update they are set to the
+         * interpolation between the last two fixed steps for rendering, i.e. rendering lags up to one fixed step
+         * behind the simulation. Entities that were moved by someone else in the meantime are not reset to their
+         * simulated transformation but adopt the new one.
+         *
+         * The simulation can run on the system's own worker thread (see updateAsync), so that it overlaps with
+         * other engine update work and does not compete with tasks on the engine's task scheduler.
+         */
+        class PhysicsSystem
+        {
+        public:
+            /** A simulation is called once per fixed step with the fixed timestep, e.g. AirplanePhysicsComponentManager::update */
+            typedef std::function<void(float)> Simulation;
+
+            /** A non-positive fixed_timestep is replaced by the default of 1/120 s */
+            PhysicsSystem(WorldState& world, float fixed_timestep = 1.0f / 120.0f, uint max_substeps = 8);
+            ~PhysicsSystem();
+
+            PhysicsSystem(PhysicsSystem const& cpy) = delete;
+            PhysicsSystem& operator=(PhysicsSystem const& rhs) = delete;
+
+            /** Non-positive timesteps are ignored and keep the current timestep */
+            void setFixedTimestep(float fixed_timestep);
+
+            float getFixedTimestep() const;
+
+            void setMaxSubsteps(uint max_substeps);
+
+            void addSimulation(Simulation const& simulation);
+
+            void addInterpolatedEntity(Entity entity);
+
+            void removeInterpolatedEntity(Entity entity);
+
+            /**
+             * \brief Accumulate frame time and run all fixed steps that are due on the calling thread.
+             */
+            void update(double frame_dt);
+
+            /**
+             * \brief Run update on the physics worker thread. Call waitForSimulation before reading the transformations
+             * of interpolated entities, e.g. before extracting render data.
+             */
+            void updateAsync(double frame_dt);
+
+            void waitForSimulation();
+
+            /**
+             * \brief Interpolation factor between the last two fixed steps that was used for the last update, in [0,1)
+             */
+            float getInterpolationAlpha() const;
+
+            /**
+             * \brief Number of fixed steps run by the last update
+             */
+            uint getLastSubstepCount() const;
+
+            /**
+             * \brief Number of fixed steps run since creation
+             */
+            size_t getStepCount() const;
+
+        private:
+            struct InterpolatedEntity
+            {
+                InterpolatedEntity(Entity entity) : entity(entity), initialized(false) {}
+
+                Entity entity;
+                bool   initialized;
+
+                Vec3 previous_position;   ///< Simulated state before the last fixed step
+                Quat previous_orientation;
+                Vec3 current_position;    ///< Simulated state after the last fixed step
+                Quat current_orientation;
+                Vec3 rendered_position;   ///< Interpolated state written for rendering
+                Quat rendered_orientation;
+            };
+
+            void storeSimulatedState(std::vector<size_t> const& transform_indices, bool previous);
+
+            WorldState& m_world;
+
+            float  m_fixed_timestep;
+            uint   m_max_substeps;
+            double m_accumulator;
+            float  m_interpolation_alpha;
+            uint   m_last_substep_cnt;
+            size_t m_step_cnt;
+
+            std::vector<Simulation>         m_simulations;
+            std::vector<InterpolatedEntity> m_interpolated_entities;
+
+            /** Protects all simulation state, held for the whole duration of an update */
+            mutable std::mutex m_update_mutex;
+
+            EngineCore::Utility::TaskScheduler m_task_scheduler;
+        };
+    }
+}
+
+#endif // !PhysicsSystem_hpp
@@ -31,6 +31,10 @@ namespace EngineCore
         {
             std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
 
+            // checked again under the unique lock, a concurrent reserve might have grown the storage already
+            if (size <= m_data.allocated)
+                return;
+
             Data new_data;
 
             const uint bytes = size * (sizeof(Entity)
@@ -46,16 +50,27 @@ namespace EngineCore
             new_data.lumen = (float*)(new_data.light_colour + size);
             new_data.radius = (float*)(new_data.lumen + size);
 
-            std::memcpy(m_data.entity, new_data.entity, m_data.used * sizeof(Entity));
-            std::memcpy(m_data.light_colour, new_data.light_colour, m_data.used * sizeof(Vec3));
-            std::memcpy(m_data.lumen, new_data.lumen, m_data.used * sizeof(float));
-            std::memcpy(m_data.radius, new_data.radius, m_data.used * sizeof(float));
+            std::memcpy(new_data.entity, m_data.entity, m_data.used * sizeof(Entity));
+            std::memcpy(new_data.light_colour, m_data.light_colour, m_data.used * sizeof(Vec3));
+            std::memcpy(new_data.lumen, m_data.lumen, m_data.used * sizeof(float));
+            std::memcpy(new_data.radius, m_data.radius, m_data.used * sizeof(float));
 
-            delete m_data.buffer;
+            delete[] m_data.buffer;
 
             m_data = new_data;
         }
 
+        void PointlightComponentManager::reserve(uint size)
+        {
+            {
+                std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+                if (size <= m_data.allocated)
+                    return;
+            }
+
+            reallocate(size);
+        }
+
         void PointlightComponentManager::addComponent(Entity entity, Vec3 light_colour, float lumen, float radius)
         {
             std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
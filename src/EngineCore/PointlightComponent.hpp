@@ -32,8 +32,16 @@ namespace EngineCore
             PointlightComponentManager(uint size);
             ~PointlightComponentManager();
 
+            /**
+             * Grow the component storage to the given size, smaller sizes are ignored
+             */
             void reallocate(uint size);
 
+            /**
+             * Grow the component storage to hold at least the given number of components
+             */
+            void reserve(uint size);
+
             void addComponent(Entity entity, Vec3 light_colour, float lumen, float radius);
 
             void deleteComponent(Entity entity);
@@ -0,0 +1,166 @@
+#include "ProgramBinaryCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        namespace
+        {
+            constexpr char     program_binary_file_magic[4] = { 'S','L','P','B' };
+            constexpr uint32_t program_binary_file_version = 1;
+
+            template<typename T>
+            void writeValue(std::ofstream& file, T value)
+            {
+                file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+            }
+
+            template<typename T>
+            bool readValue(std::ifstream& file, T& value)
+            {
+                return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+            }
+        }
+
+        void ProgramBinaryCache::setDirectory(std::string const& cache_directory)
+        {
+            if (!cache_directory.empty())
+            {
+                std::error_code ec;
+                std::filesystem::create_directories(cache_directory, ec);
+            }
+
+            std::unique_lock<std::mutex> lock(m_directory_mutex);
+            m_directory = cache_directory;
+        }
+
+        std::string ProgramBinaryCache::getDirectory() const
+        {
+            std::unique_lock<std::mutex> lock(m_directory_mutex);
+            return m_directory;
+        }
+
+        bool ProgramBinaryCache::isEnabled() const
+        {
+            std::unique_lock<std::mutex> lock(m_directory_mutex);
+            return !m_directory.empty();
+        }
+
+        bool ProgramBinaryCache::load(uint64_t key, ProgramBinary& binary) const
+        {
+            std::string path = computeFilePath(key);
+            if (path.empty())
+                return false;
+
+            std::ifstream file(path, std::ios::binary);
+
+            if (!file.is_open())
+                return false;
+
+            char magic[4];
+            uint32_t version, format, driver_length;
+            uint64_t key_check, data_size;
+
+            if (!file.read(magic, 4) || std::memcmp(magic, program_binary_file_magic, 4) != 0)
+                return false;
+
+            if (!readValue(file, version) || version != program_binary_file_version)
+                return false;
+
+            if (!readValue(file, key_check) || key_check != key)
+                return false;
+
+            if (!readValue(file, format) || !readValue(file, driver_length))
+                return false;
+
+            ProgramBinary retval;
+            retval.format = format;
+            retval.driver.resize(driver_length);
+            if (!file.read(retval.driver.data(), driver_length))
+                return false;
+
+            if (!readValue(file, data_size))
+                return false;
+
+            retval.data.resize(data_size);
+            if (!file.read(reinterpret_cast<char*>(retval.data.data()), data_size))
+                return false;
+
+            binary = std::move(retval);
+
+            return true;
+        }
+
+        bool ProgramBinaryCache::store(uint64_t key, ProgramBinary const& binary) const
+        {
+            std::string path = computeFilePath(key);
+            if (path.empty())
+                return false;
+
+            // write to a temporary file first, so that concurrent readers never see partially written binaries
+            std::ostringstream tmp_path;
+            tmp_path << path << "." << std::this_thread::get_id() << ".tmp";
+
+            {
+                std::ofstream file(tmp_path.str(), std::ios::binary | std::ios::trunc);
+
+                if (!file.is_open())
+                    return false;
+
+                file.write(program_binary_file_magic, 4);
+                writeValue(file, program_binary_file_version);
+                writeValue(file, key);
+                writeValue(file, binary.format);
+                writeValue(file, static_cast<uint32_t>(binary.driver.size()));
+                file.write(binary.driver.data(), binary.driver.size());
+                writeValue(file, static_cast<uint64_t>(binary.data.size()));
+                file.write(reinterpret_cast<char const*>(binary.data.data()), binary.data.size());
+
+                if (!file)
+                {
+                    file.close();
+                    std::remove(tmp_path.str().c_str());
+                    return false;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tmp_path.str(), path, ec);
+            if (ec)
+            {
+                std::remove(tmp_path.str().c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+        void ProgramBinaryCache::remove(uint64_t key) const
+        {
+            std::string path = computeFilePath(key);
+            if (!path.empty()) {
+                std::remove(path.c_str());
+            }
+        }
+
+        std::string ProgramBinaryCache::computeFilePath(uint64_t key) const
+        {
+            std::unique_lock<std::mutex> lock(m_directory_mutex);
+
+            if (m_directory.empty())
+                return std::string();
+
+            char file_name[32];
+            std::snprintf(file_name, sizeof(file_name), "%016llx.glprog", static_cast<unsigned long long>(key));
+
+            return (std::filesystem::path(m_directory) / file_name).string();
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef ProgramBinaryCache_hpp
+#define ProgramBinaryCache_hpp
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \class ProgramBinaryCache
+        *
+        * \brief Persists linked shader program binaries on disk, keyed by a hash of the program sources.
+        *
+        * Program binaries are only valid for the driver that created them. Each binary is stored together with a
+        * driver identification string (e.g. vendor, renderer and version) and callers should discard binaries whose
+        * driver string doesn't match the current one. The cache contains no graphics API calls. All methods are thread-safe.
+        */
+        class ProgramBinaryCache
+        {
+        public:
+            struct ProgramBinary
+            {
+                uint32_t             format; ///< API specific binary format
+                std::string          driver; ///< Identification of the driver that created the binary
+                std::vector<uint8_t> data;
+            };
+
+            ProgramBinaryCache() = default;
+            ~ProgramBinaryCache() = default;
+
+            ProgramBinaryCache(ProgramBinaryCache const& cpy) = delete;
+            ProgramBinaryCache& operator=(ProgramBinaryCache const& rhs) = delete;
+
+            /**
+            * \brief Set the directory for binary files. An empty path disables the cache.
+            */
+            void setDirectory(std::string const& cache_directory);
+
+            std::string getDirectory() const;
+
+            bool isEnabled() const;
+
+            /**
+            * \brief Read the binary stored for the given key
+            * \return Returns false if there is no valid binary for the key
+            */
+            bool load(uint64_t key, ProgramBinary& binary) const;
+
+            /**
+            * \brief Write the binary for the given key, replacing an existing one
+            * \return Returns false if the cache is disabled or the file couldn't be written
+            */
+            bool store(uint64_t key, ProgramBinary const& binary) const;
+
+            /**
+            * \brief Delete the binary stored for the given key, e.g. after it was rejected by the driver
+            */
+            void remove(uint64_t key) const;
+
+        private:
+            std::string computeFilePath(uint64_t key) const;
+
+            std::string        m_directory;
+            mutable std::mutex m_directory_mutex;
+        };
+    }
+}
+
+#endif // !ProgramBinaryCache_hpp
@@ -1,8 +1,37 @@
 #include "RearSteerBicycleComponent.hpp"
 
+#include <algorithm>
+#include <iostream>
+
 #include "utility.hpp"
 #include "ResourceLoading.hpp"
 
+namespace
+{
+	/** Simulation state values stored in binary trajectories, the timestep is stored as the trajectory timestamps */
+	struct TrajectoryField
+	{
+		char const* name;
+		float SimulationState::* value;
+	};
+
+	TrajectoryField const trajectory_fields[] = {
+		{ "x_e", &SimulationState::x_e },
+		{ "y_e", &SimulationState::y_e },
+		{ "phi", &SimulationState::phi },
+		{ "phi_dt", &SimulationState::phi_dt },
+		{ "delta", &SimulationState::delta },
+		{ "delta_dt", &SimulationState::delta_dt },
+		{ "psi", &SimulationState::psi },
+		{ "omega", &SimulationState::omega } };
+
+	bool isBinaryTrajectory(std::string const& path)
+	{
+		std::string const extension = ".sltr";
+		return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+	}
+}
+
 void RearSteerBicycleComponentManager::addComponent(Entity e)
 {
 	std::unique_lock<std::shared_mutex> lock(m_data_mutex);
@@ -58,8 +87,30 @@ void RearSteerBicycleComponentManager::addComponent(Entity e, std::string const&
 	addComponent(e);
 
 	std::unique_lock<std::shared_mutex> lock(m_data_mutex);
-	
-	ResourceLoading::loadBikeSimulationData(sim_data_path, m_data.back().m_simulation_data);
+
+	Data& component = m_data.back();
+
+	if (!isBinaryTrajectory(sim_data_path))
+	{
+		ResourceLoading::loadBikeSimulationData(sim_data_path, component.m_simulation_data);
+		return;
+	}
+
+	auto trajectory = std::make_shared<EngineCore::Utility::MappedTrajectory>();
+	if (!trajectory->open(sim_data_path))
+	{
+		std::cerr << "Failed to map bicycle trajectory " << sim_data_path << std::endl;
+		return;
+	}
+	trajectory->adviseSequential();
+
+	component.m_trajectory_fields.clear();
+	for (auto const& field : trajectory_fields) {
+		component.m_trajectory_fields.push_back(trajectory->findField(field.name));
+	}
+
+	component.m_trajectory_cursor = std::make_shared<EngineCore::Utility::MappedTrajectory::Cursor>(*trajectory);
+	component.m_trajectory = trajectory;
 }
 
 void RearSteerBicycleComponentManager::update(float dt)
@@ -98,32 +149,76 @@ void RearSteerBicycleComponentManager::update(float dt)
 
 SimulationState RearSteerBicycleComponentManager::computeCurrentState(uint idx, float timestep)
 {
-	m_data[idx].m_current_time += timestep;
+	Data& component = m_data[idx];
 
-	for (int i = 1; i < m_data[idx].m_simulation_data.size(); ++i)
-	{
-		if (m_data[idx].m_simulation_data[i].timestep > m_data[idx].m_current_time)
-		{
-			SimulationState interpolated_state;
+	component.m_current_time += timestep;
+
+	auto const& simulation_data = component.m_simulation_data;
+	auto const& trajectory = component.m_trajectory;
+
+	size_t sample_cnt = trajectory ? trajectory->getSampleCount() : simulation_data.size();
 
-			float timestep_length = 0.2;
-			float alpha = (m_data[idx].m_current_time - m_data[idx].m_simulation_data[i - 1].timestep) / timestep_length;
-			float beta = (m_data[idx].m_simulation_data[i].timestep - m_data[idx].m_current_time)/ timestep_length;
+	auto getTimestamp = [&](size_t sample) -> double {
+		return trajectory ? trajectory->getTimestamp(sample) : simulation_data[sample].timestep;
+	};
 
-			interpolated_state.y_e = m_data[idx].m_simulation_data[i].y_e * alpha + m_data[idx].m_simulation_data[i - 1].y_e * beta;
-			interpolated_state.x_e = m_data[idx].m_simulation_data[i].x_e * alpha + m_data[idx].m_simulation_data[i - 1].x_e * beta;
-			interpolated_state.phi = m_data[idx].m_simulation_data[i].phi * alpha + m_data[idx].m_simulation_data[i - 1].phi * beta;
-			interpolated_state.delta = m_data[idx].m_simulation_data[i].delta * alpha + m_data[idx].m_simulation_data[i - 1].delta * beta;
-			interpolated_state.psi = m_data[idx].m_simulation_data[i].psi * alpha + m_data[idx].m_simulation_data[i - 1].psi * beta;
-			interpolated_state.omega = m_data[idx].m_simulation_data[i].omega * alpha + m_data[idx].m_simulation_data[i - 1].omega * beta;
+	auto getState = [&](size_t sample) -> SimulationState {
+		if (!trajectory)
+			return simulation_data[sample];
 
-			return interpolated_state;
+		SimulationState state;
+		state.timestep = static_cast<float>(trajectory->getTimestamp(sample));
+		for (size_t i = 0; i < component.m_trajectory_fields.size(); ++i)
+		{
+			if (component.m_trajectory_fields[i] < trajectory->getFieldCount())
+				state.*trajectory_fields[i].value = component.m_trajectory_cursor->getValue(component.m_trajectory_fields[i], sample);
 		}
+		return state;
+	};
+
+	// restart playback once the end of the recording is reached
+	if (sample_cnt < 2 || component.m_current_time >= getTimestamp(sample_cnt - 1))
+	{
+		component.m_current_time = 0.0;
+		component.m_current_sample = 0;
+
+		return SimulationState();
 	}
 
-	m_data[idx].m_current_time = 0.0;
+	// last sample at or before the current time, playback usually stays at or advances by one sample
+	size_t sample;
+	if (trajectory)
+	{
+		sample = trajectory->findSample(component.m_current_time, component.m_current_sample);
+	}
+	else
+	{
+		auto upper = std::upper_bound(simulation_data.begin(), simulation_data.end(), component.m_current_time,
+			[](double time, SimulationState const& state) { return time < state.timestep; });
+		sample = upper == simulation_data.begin() ? 0 : static_cast<size_t>(upper - simulation_data.begin()) - 1;
+	}
+	component.m_current_sample = sample;
+
+	SimulationState previous = getState(sample);
+	SimulationState next = getState(sample + 1);
+
+	double previous_time = getTimestamp(sample);
+	double next_time = getTimestamp(sample + 1);
+	double timestep_length = std::max(next_time - previous_time, 1.0e-9);
+
+	float alpha = static_cast<float>((component.m_current_time - previous_time) / timestep_length);
+	float beta = 1.0f - alpha;
 
-	return SimulationState();
+	SimulationState interpolated_state;
+	interpolated_state.timestep = static_cast<float>(component.m_current_time);
+	interpolated_state.y_e = next.y_e * alpha + previous.y_e * beta;
+	interpolated_state.x_e = next.x_e * alpha + previous.x_e * beta;
+	interpolated_state.phi = next.phi * alpha + previous.phi * beta;
+	interpolated_state.delta = next.delta * alpha + previous.delta * beta;
+	interpolated_state.psi = next.psi * alpha + previous.psi * beta;
+	interpolated_state.omega = next.omega * alpha + previous.omega * beta;
+
+	return interpolated_state;
 }
 
 void RearSteerBicycleComponentManager::pushSimulationState(uint idx, SimulationState state)
@@ -131,6 +226,28 @@ void RearSteerBicycleComponentManager::pushSimulationState(uint idx, SimulationS
 	m_data[idx].m_simulation_data[0] = state;
 }
 
+bool RearSteerBicycleComponentManager::writeBinarySimulationData(std::string const& path, std::vector<SimulationState> const& simulation_data, bool delta_encode)
+{
+	std::vector<double> timestamps;
+	std::vector<EngineCore::Utility::TrajectoryColumn> columns;
+
+	timestamps.reserve(simulation_data.size());
+	for (auto const& state : simulation_data) {
+		timestamps.push_back(state.timestep);
+	}
+
+	for (auto const& field : trajectory_fields)
+	{
+		columns.push_back({ field.name, {} });
+		columns.back().values.reserve(simulation_data.size());
+		for (auto const& state : simulation_data) {
+			columns.back().values.push_back(state.*field.value);
+		}
+	}
+
+	return EngineCore::Utility::writeTrajectory(path, timestamps, columns, delta_encode);
+}
+
 std::pair<bool, uint> RearSteerBicycleComponentManager::getIndex(Entity e) const
 {
 	return getIndex(e.id());
@@ -1,6 +1,7 @@
 #ifndef RearSteerBicycleComponent_hpp
 #define RearSteerBicycleComponent_hpp
 
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -13,6 +14,8 @@
 #include "GlobalRenderingComponents.hpp"
 #include "StaticMeshComponent.hpp"
 
+#include "MappedTrajectory.hpp"
+
 struct SimulationState
 {
 	SimulationState()
@@ -51,7 +54,9 @@ private:
 			m_pedals(GEngineCore::entityManager().invalidEntity()),
 			m_rear_wheel_frame(GEngineCore::entityManager().invalidEntity()),
 			m_front_wheel(GEngineCore::entityManager().invalidEntity()),
-			m_rear_wheel(GEngineCore::entityManager().invalidEntity()) {}
+			m_rear_wheel(GEngineCore::entityManager().invalidEntity()),
+			m_current_time(0.0),
+			m_current_sample(0) {}
 
 		Entity m_entity;
 		
@@ -64,9 +69,15 @@ private:
 		Entity m_rear_wheel;
 
 		double m_current_time;
+		size_t m_current_sample; ///< Last sample found for m_current_time, starting point for the next search
 		SimulationState m_currentstate;
 
 		std::vector<SimulationState> m_simulation_data;
+
+		// Binary trajectories are mapped and streamed instead of being loaded into m_simulation_data
+		std::shared_ptr<EngineCore::Utility::MappedTrajectory> m_trajectory;
+		std::shared_ptr<EngineCore::Utility::MappedTrajectory::Cursor> m_trajectory_cursor;
+		std::vector<size_t> m_trajectory_fields; ///< Trajectory field index of each simulation state value
 	};
 
 	std::vector<Data> m_data;
@@ -79,6 +90,10 @@ public:
 
 	void addComponent(Entity e);
 
+	/**
+	 * \brief Add a bicycle that plays back recorded simulation data.
+	 * Files with the .sltr extension are memory mapped binary trajectories, anything else is loaded as text.
+	 */
 	void addComponent(Entity e, std::string const& sim_data_path);
 
 	void update(float dt);
@@ -87,6 +102,11 @@ public:
 
 	void pushSimulationState(uint idx, SimulationState state);
 
+	/**
+	 * \brief Convert simulation data, e.g. a loaded text recording, to a binary trajectory (.sltr) for playback.
+	 */
+	static bool writeBinarySimulationData(std::string const& path, std::vector<SimulationState> const& simulation_data, bool delta_encode);
+
 	std::pair<bool, uint> getIndex(Entity e) const;
 
 	std::pair<bool, uint> getIndex(uint eID) const;
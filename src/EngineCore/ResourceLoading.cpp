@@ -1,24 +1,30 @@
 #include "ResourceLoading.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 namespace ResourceLoading
 {
     std::string readShaderFile(const char* const path)
     {
-        std::ifstream inFile(path, std::ios::in);
+        std::ifstream inFile(path, std::ios::in | std::ios::binary | std::ios::ate);
 
-        //TODO throw exception if file not found
-
-        std::ostringstream source;
-        while (inFile.good()) {
-            int c = inFile.get();
-            if (!inFile.eof()) source << (char)c;
+        if (!inFile.is_open()) {
+            throw std::runtime_error(std::string("Failed to open shader file: ") + path);
         }
-        inFile.close();
 
-        return source.str();
+        std::string source(static_cast<size_t>(inFile.tellg()), '\0');
+        inFile.seekg(0, std::ios::beg);
+        inFile.read(source.data(), source.size());
+        source.resize(static_cast<size_t>(inFile.gcount()));
+
+        // drop carriage returns, so that files with windows line endings preprocess like all others
+        source.erase(std::remove(source.begin(), source.end(), '\r'), source.end());
+
+        return source;
     }
 
     //    MaterialInfo parseMaterial(std::string const& material_path)
@@ -138,6 +144,10 @@ namespace ResourceLoading
         unsigned int width, height;
         unsigned int error = lodepng::decode(image_data, width, height, path);
 
+        if (error != 0) {
+            throw std::runtime_error("Failed to decode png file: " + path + " (" + lodepng_error_text(error) + ")");
+        }
+
         image_layout.width = width;
         image_layout.height = height;
         image_layout.depth = 1;
@@ -146,40 +156,138 @@ namespace ResourceLoading
         image_layout.type = 0x1401; /*GL_UNSIGNED_BYTE*/
     }
 
-    void loadPpmImage(std::string const& path, std::vector<uint8_t>& image_data, GenericTextureLayout& image_layout)
+    namespace
     {
-        unsigned long headerEnd;
-        int imgDimX, imgDimY;
+        /**
+        * Parse the header of a binary ppm file (P6) that has already been read to memory.
+        * Handles comment lines and arbitrary whitespace between header tokens.
+        */
+        bool parsePpmHeader(std::vector<uint8_t> const& file_data, size_t& header_end, int& imgDimX, int& imgDimY)
+        {
+            size_t pos = 0;
+            std::array<int, 3> values = { 0,0,0 }; // width, height, maximum value
 
-        readPpmHeader(path.c_str(), headerEnd, imgDimX, imgDimY);
+            auto skipWhitespaceAndComments = [&file_data, &pos]() {
+                while (pos < file_data.size())
+                {
+                    if (file_data[pos] == '#') {
+                        while (pos < file_data.size() && file_data[pos] != '\n') ++pos;
+                    }
+                    else if (std::isspace(file_data[pos])) {
+                        ++pos;
+                    }
+                    else {
+                        break;
+                    }
+                }
+            };
+
+            // magic number, other portable anymap variants (ascii or grayscale data) are not supported
+            if (file_data.size() < 3 || file_data[0] != 'P' || file_data[1] != '6' || !std::isspace(file_data[2]))
+                return false;
+            pos = 2;
+
+            for (auto& value : values)
+            {
+                skipWhitespaceAndComments();
+
+                if (pos >= file_data.size() || !std::isdigit(file_data[pos]))
+                    return false;
+
+                while (pos < file_data.size() && std::isdigit(file_data[pos])) {
+                    value = value * 10 + (file_data[pos] - '0');
+                    ++pos;
+
+                    if (value > (1 << 24))
+                        return false;
+                }
+            }
+
+            // only 8bit data is supported, i.e. a maximum value below 256
+            if (values[0] <= 0 || values[1] <= 0 || values[2] <= 0 || values[2] > 255)
+                return false;
+
+            // exactly one whitespace character separates the header from the data block
+            if (pos >= file_data.size() || !std::isspace(file_data[pos]))
+                return false;
+
+            header_end = pos + 1;
+            imgDimX = values[0];
+            imgDimY = values[1];
+
+            return true;
+        }
+
+        /**
+        * Copy rgb data from a ppm file buffer, flipping the image so that the data begins with the lower left corner.
+        */
+        void copyPpmData(std::vector<uint8_t> const& file_data, size_t data_begin, int imgDimX, int imgDimY, int tgt_channels, uint8_t* image_data)
+        {
+            if (file_data.size() < data_begin + static_cast<size_t>(imgDimX) * imgDimY * 3) {
+                throw std::runtime_error("Unexpected end of ppm data");
+            }
+
+            uint8_t const* src = file_data.data() + data_begin;
+
+            for (int i = 0; i < imgDimY; i++)
+            {
+                uint8_t const* src_row = src + static_cast<size_t>(imgDimY - 1 - i) * imgDimX * 3;
+                uint8_t* tgt_row = image_data + static_cast<size_t>(i) * imgDimX * tgt_channels;
+
+                if (tgt_channels == 3)
+                {
+                    std::copy_n(src_row, static_cast<size_t>(imgDimX) * 3, tgt_row);
+                }
+                else
+                {
+                    for (int j = 0; j < imgDimX; j++)
+                    {
+                        tgt_row[j * 4 + 0] = src_row[j * 3 + 0];
+                        tgt_row[j * 4 + 1] = src_row[j * 3 + 1];
+                        tgt_row[j * 4 + 2] = src_row[j * 3 + 2];
+                        tgt_row[j * 4 + 3] = std::numeric_limits<uint8_t>::max();
+                    }
+                }
+            }
+        }
+
+        void loadPpm(std::string const& path, int tgt_channels, std::vector<uint8_t>& image_data, GenericTextureLayout& image_layout)
+        {
+            // read the file only once and parse header and data from memory
+            auto file_data = EngineCore::Utility::ReadFileBytes(path);
+
+            size_t header_end;
+            int imgDimX, imgDimY;
+
+            if (!parsePpmHeader(file_data, header_end, imgDimX, imgDimY)) {
+                throw std::runtime_error("Failed to parse ppm header: " + path);
+            }
+
+            image_data.resize(static_cast<size_t>(imgDimX) * imgDimY * tgt_channels);
+            image_layout.width = imgDimX;
+            image_layout.height = imgDimY;
+            image_layout.depth = 1;
+
+            copyPpmData(file_data, header_end, imgDimX, imgDimY, tgt_channels, image_data.data());
+        }
+    }
+
+    void loadPpmImage(std::string const& path, std::vector<uint8_t>& image_data, GenericTextureLayout& image_layout)
+    {
+        loadPpm(path, 3, image_data, image_layout);
 
-        image_data.resize(imgDimX*imgDimY * 3);
-        image_layout.width = imgDimX;
-        image_layout.height = imgDimY;
-        image_layout.depth = 1;
         image_layout.internal_format = GenericTextureLayout::InternalFormat::RGB8;//0x8051; /*GL_RGB8*/
         image_layout.format = 0x1907; /*GL_RGB*/
         image_layout.type = 0x1401; /*GL_UNSIGNED_BYTE*/
-
-        readPpmData(path.c_str(), reinterpret_cast<char*>(image_data.data()), headerEnd, imgDimX, imgDimY);
     }
 
     void loadPpmImageRGBA(std::string const& path, std::vector<uint8_t>& image_data, GenericTextureLayout& image_layout)
     {
-        unsigned long headerEnd;
-        int imgDimX, imgDimY;
+        loadPpm(path, 4, image_data, image_layout);
 
-        readPpmHeader(path.c_str(), headerEnd, imgDimX, imgDimY);
-
-        image_data.resize(imgDimX*imgDimY * 4);
-        image_layout.width = imgDimX;
-        image_layout.height = imgDimY;
-        image_layout.depth = 1;
         image_layout.internal_format = GenericTextureLayout::InternalFormat::RGBA8;//0x8058; /*GL_RGBA8*/
         image_layout.format = 0x1908; /*GL_RGBA*/
         image_layout.type = 0x1401; /*GL_UNSIGNED_BYTE*/
-
-        readPpmDataPaddedAlpha(path.c_str(), reinterpret_cast<char*>(image_data.data()), headerEnd, imgDimX, imgDimY);
     }
 
     bool readPpmHeader(const char* filename, unsigned long& headerEndPos, int& imgDimX, int& imgDimY)
@@ -6,6 +6,7 @@
 #include <vector>
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
 #ifdef _UWP
 #include <format>
 #include <windows.h>
@@ -75,12 +76,19 @@ namespace ResourceLoading
     /**
     * \brief Read a shader source file
     * \param path Location of the shader file
-    * \return Returns a string containing the shader source
+    * \return Returns a string containing the shader source, throws std::runtime_error if the file can't be opened
     */
     std::string readShaderFile(const char* const path);
 
     std::array<std::string, 4> parseDecalMaterial(std::string const& material_path);
 
+    /**
+    * \brief Load and decode a png image file into a CPU-side RGBA8 buffer
+    * \param path Location of the png file
+    * \param image_data Vector for storing the decoded image data
+    * \param image_layout Store the layout of the loaded image (i.e. size, channels, bit-depth)
+    * Throws std::runtime_error if the file cannot be read or decoded.
+    */
     void loadPngImage(std::string const& path, std::vector<unsigned char>& image_data, GenericTextureLayout& image_layout);
 
     /**
@@ -88,6 +96,7 @@ namespace ResourceLoading
     * \param path Location of the ppm file
     * \param image_data Vector for storing the loaded image data
     * \param image_layout Store the layout of the loaded image (i.e. size, channels, bit-depth)
+    * The file is read only once. Throws std::runtime_error if the file cannot be read or parsed.
     */
     void loadPpmImage(std::string const& path, std::vector<uint8_t>& image_data, GenericTextureLayout& image_layout);
 
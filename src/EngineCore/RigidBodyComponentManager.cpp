@@ -0,0 +1,680 @@
+#include "RigidBodyComponentManager.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "Narrowphase.hpp"
+#include "TransformComponentManager.hpp"
+
+namespace
+{
+    /** Penetration that is tolerated without position correction, avoids jitter of resting contacts */
+    constexpr float penetration_slop = 0.005f;
+
+    /** Separation up to which contacts are kept, so that resting contacts do not flicker between updates */
+    constexpr float contact_margin = 0.02f;
+
+    /** Fraction of the remaining penetration that is corrected per step */
+    constexpr float baumgarte_factor = 0.2f;
+
+    /** Approach velocity below which contacts do not bounce */
+    constexpr float restitution_threshold = 1.0f;
+
+    /** Contacts of consecutive updates closer than this (in the frame of body a) are considered the same */
+    constexpr float contact_match_distance = 0.05f;
+
+    /** Colors are tracked per body in a 64 bit mask, manifolds that find no free color go to a last batch that is solved serially */
+    constexpr size_t max_color_cnt = 64;
+
+    /** Solver iterations without position correction after the positions were integrated */
+    constexpr uint relax_iterations = 2;
+
+    constexpr size_t pairs_per_task = 256;
+    constexpr size_t manifolds_per_task = 64;
+
+    Vec3 computeTangent(Vec3 const& normal)
+    {
+        if (std::abs(normal.x) >= 0.57735f) {
+            return glm::normalize(Vec3(normal.y, -normal.x, 0.0f));
+        }
+        return glm::normalize(Vec3(0.0f, normal.z, -normal.y));
+    }
+}
+
+EngineCore::Physics::RigidBodyComponentManager::RigidBodyComponentManager()
+    : m_gravity(0.0f, -9.81f, 0.0f), m_solver_iterations(10)
+{
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::addSphereComponent(Entity entity, Vec3 position, float radius, float mass, float friction, float restitution)
+{
+    Vec3 inertia(0.4f * mass * radius * radius);
+
+    addBody(entity, RigidBodyShape::SPHERE, Vec3(radius, 0.0f, 0.0f), position, Quat(1.0f, 0.0f, 0.0f, 0.0f), mass, inertia, friction, restitution);
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::addBoxComponent(Entity entity, Vec3 position, Quat orientation, Vec3 half_extents, float mass, float friction, float restitution)
+{
+    Vec3 e2 = half_extents * half_extents;
+    Vec3 inertia = (mass / 3.0f) * Vec3(e2.y + e2.z, e2.x + e2.z, e2.x + e2.y);
+
+    addBody(entity, RigidBodyShape::BOX, half_extents, position, orientation, mass, inertia, friction, restitution);
+}
+
+size_t EngineCore::Physics::RigidBodyComponentManager::getComponentCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_bodies.entity.size();
+}
+
+Vec3 EngineCore::Physics::RigidBodyComponentManager::getPosition(size_t index) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_bodies.position[index];
+}
+
+Quat EngineCore::Physics::RigidBodyComponentManager::getOrientation(size_t index) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_bodies.orientation[index];
+}
+
+Vec3 EngineCore::Physics::RigidBodyComponentManager::getLinearVelocity(size_t index) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_bodies.linear_velocity[index];
+}
+
+Vec3 EngineCore::Physics::RigidBodyComponentManager::getAngularVelocity(size_t index) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_bodies.angular_velocity[index];
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::setPose(size_t index, Vec3 position, Quat orientation)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_bodies.position[index] = position;
+    m_bodies.orientation[index] = orientation;
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::setLinearVelocity(size_t index, Vec3 velocity)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_bodies.linear_velocity[index] = velocity;
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::setAngularVelocity(size_t index, Vec3 velocity)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_bodies.angular_velocity[index] = velocity;
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::setGravity(Vec3 gravity)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_gravity = gravity;
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::setSolverIterations(uint iterations)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+    m_solver_iterations = iterations;
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::update(float timestep, Common::TransformComponentManager& transform_mngr, Utility::TaskScheduler& task_scheduler)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto t_0 = std::chrono::high_resolution_clock::now();
+
+    size_t body_cnt = m_bodies.entity.size();
+
+    // integrate external forces and update the world space inertia
+    for (size_t i = 0; i < body_cnt; ++i)
+    {
+        if (m_bodies.inverse_mass[i] == 0.0f)
+            continue;
+
+        m_bodies.linear_velocity[i] += m_gravity * timestep;
+
+        glm::mat3 rotation = glm::mat3_cast(m_bodies.orientation[i]);
+        Vec3 const& inverse_inertia = m_bodies.inverse_inertia[i];
+        glm::mat3 inverse_inertia_diagonal(
+            Vec3(inverse_inertia.x, 0.0f, 0.0f),
+            Vec3(0.0f, inverse_inertia.y, 0.0f),
+            Vec3(0.0f, 0.0f, inverse_inertia.z));
+        m_bodies.world_inverse_inertia[i] = rotation * inverse_inertia_diagonal * glm::transpose(rotation);
+    }
+
+    std::vector<ContactManifold> previous_manifolds = std::move(m_manifolds);
+
+    findContacts(task_scheduler);
+
+    auto t_1 = std::chrono::high_resolution_clock::now();
+
+    warmStart(previous_manifolds);
+    prepareContacts(timestep);
+    colorManifolds();
+
+    for (uint iteration = 0; iteration < m_solver_iterations; ++iteration) {
+        solveContacts(task_scheduler, true);
+    }
+
+    // integrate velocities
+    for (size_t i = 0; i < body_cnt; ++i)
+    {
+        if (m_bodies.inverse_mass[i] == 0.0f)
+            continue;
+
+        m_bodies.position[i] += m_bodies.linear_velocity[i] * timestep;
+
+        Vec3 const& w = m_bodies.angular_velocity[i];
+        Quat& q = m_bodies.orientation[i];
+        q = glm::normalize(q + (Quat(0.0f, w.x, w.y, w.z) * q) * (0.5f * timestep));
+    }
+
+    // remove the velocity added by the position correction, otherwise it turns into kinetic energy that lets stacks rock
+    for (uint iteration = 0; iteration < relax_iterations; ++iteration) {
+        solveContacts(task_scheduler, false);
+    }
+
+    auto t_2 = std::chrono::high_resolution_clock::now();
+
+    std::vector<size_t> transform_indices(body_cnt);
+    std::vector<Vec3>   scales(body_cnt);
+    for (size_t i = 0; i < body_cnt; ++i)
+    {
+        transform_indices[i] = transform_mngr.getIndex(m_bodies.entity[i]);
+        scales[i] = transform_mngr.getScale(transform_indices[i]);
+    }
+
+    if (body_cnt > 0) {
+        transform_mngr.setLocalTransforms(transform_indices, m_bodies.position, m_bodies.orientation, scales);
+    }
+
+    m_stats.body_cnt = body_cnt;
+    m_stats.manifold_cnt = m_manifolds.size();
+    m_stats.contact_cnt = 0;
+    for (auto const& manifold : m_manifolds) {
+        m_stats.contact_cnt += manifold.contact_cnt;
+    }
+    m_stats.color_cnt = m_color_batches.size();
+    m_stats.collision_time = std::chrono::duration_cast<std::chrono::duration<double>>(t_1 - t_0).count();
+    m_stats.solver_time = std::chrono::duration_cast<std::chrono::duration<double>>(t_2 - t_1).count();
+}
+
+EngineCore::Physics::RigidBodySolverStats EngineCore::Physics::RigidBodyComponentManager::getSolverStats() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_stats;
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::addBody(
+    Entity entity,
+    RigidBodyShape shape,
+    Vec3 extents,
+    Vec3 position,
+    Quat orientation,
+    float mass,
+    Vec3 inertia,
+    float friction,
+    float restitution)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    size_t idx = m_bodies.entity.size();
+
+    addIndex(entity.id(), idx);
+
+    bool is_dynamic = mass > 0.0f;
+
+    m_bodies.entity.push_back(entity);
+    m_bodies.shape.push_back(shape);
+    m_bodies.extents.push_back(extents);
+    m_bodies.position.push_back(position);
+    m_bodies.orientation.push_back(orientation);
+    m_bodies.linear_velocity.push_back(Vec3(0.0f));
+    m_bodies.angular_velocity.push_back(Vec3(0.0f));
+    m_bodies.inverse_mass.push_back(is_dynamic ? 1.0f / mass : 0.0f);
+    m_bodies.inverse_inertia.push_back(is_dynamic ? Vec3(1.0f / inertia.x, 1.0f / inertia.y, 1.0f / inertia.z) : Vec3(0.0f));
+    m_bodies.world_inverse_inertia.push_back(glm::mat3(0.0f));
+    m_bodies.friction.push_back(friction);
+    m_bodies.restitution.push_back(restitution);
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::findContacts(Utility::TaskScheduler& task_scheduler)
+{
+    uint32_t body_cnt = static_cast<uint32_t>(m_bodies.entity.size());
+
+    std::vector<Vec3> bounds_min(body_cnt);
+    std::vector<Vec3> bounds_max(body_cnt);
+
+    for (uint32_t i = 0; i < body_cnt; ++i)
+    {
+        Vec3 extent;
+        if (m_bodies.shape[i] == RigidBodyShape::SPHERE)
+        {
+            extent = Vec3(m_bodies.extents[i].x);
+        }
+        else
+        {
+            glm::mat3 rotation = glm::mat3_cast(m_bodies.orientation[i]);
+            extent = glm::abs(rotation[0]) * m_bodies.extents[i].x + glm::abs(rotation[1]) * m_bodies.extents[i].y + glm::abs(rotation[2]) * m_bodies.extents[i].z;
+        }
+
+        bounds_min[i] = m_bodies.position[i] - extent - Vec3(contact_margin);
+        bounds_max[i] = m_bodies.position[i] + extent + Vec3(contact_margin);
+    }
+
+    // sweep and prune along the x axis
+    std::vector<uint32_t> order(body_cnt);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&bounds_min](uint32_t lhs, uint32_t rhs) {
+        return bounds_min[lhs].x < bounds_min[rhs].x || (bounds_min[lhs].x == bounds_min[rhs].x && lhs < rhs);
+    });
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+
+    for (uint32_t i = 0; i < body_cnt; ++i)
+    {
+        uint32_t a = order[i];
+
+        for (uint32_t j = i + 1; j < body_cnt && bounds_min[order[j]].x <= bounds_max[a].x; ++j)
+        {
+            uint32_t b = order[j];
+
+            if (m_bodies.inverse_mass[a] == 0.0f && m_bodies.inverse_mass[b] == 0.0f)
+                continue;
+
+            if (bounds_min[a].y > bounds_max[b].y || bounds_min[b].y > bounds_max[a].y ||
+                bounds_min[a].z > bounds_max[b].z || bounds_min[b].z > bounds_max[a].z)
+                continue;
+
+            pairs.push_back({ std::min(a, b), std::max(a, b) });
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+
+    m_stats.pair_cnt = pairs.size();
+
+    // group pairs by shape combination for the batched narrowphase, spheres are the first shape of mixed pairs
+    std::vector<size_t> sphere_pairs;
+    std::vector<size_t> sphere_box_pairs;
+    std::vector<size_t> box_pairs;
+
+    SoASpheres spheres_a, spheres_b, sphere_box_spheres;
+    SoABoxes sphere_box_boxes, boxes_a, boxes_b;
+
+    auto make_box = [this](uint32_t body) {
+        glm::mat3 rotation = glm::mat3_cast(m_bodies.orientation[body]);
+        return OrientedBox{ m_bodies.position[body], { rotation[0], rotation[1], rotation[2] }, m_bodies.extents[body] };
+    };
+
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        uint32_t a = pairs[i].first;
+        uint32_t b = pairs[i].second;
+
+        bool sphere_a = m_bodies.shape[a] == RigidBodyShape::SPHERE;
+        bool sphere_b = m_bodies.shape[b] == RigidBodyShape::SPHERE;
+
+        if (sphere_a && sphere_b)
+        {
+            sphere_pairs.push_back(i);
+            spheres_a.push_back(m_bodies.position[a], m_bodies.extents[a].x);
+            spheres_b.push_back(m_bodies.position[b], m_bodies.extents[b].x);
+        }
+        else if (sphere_a || sphere_b)
+        {
+            uint32_t sphere = sphere_a ? a : b;
+            sphere_box_pairs.push_back(i);
+            sphere_box_spheres.push_back(m_bodies.position[sphere], m_bodies.extents[sphere].x);
+            sphere_box_boxes.push_back(make_box(sphere_a ? b : a));
+        }
+        else
+        {
+            box_pairs.push_back(i);
+            boxes_a.push_back(make_box(a));
+            boxes_b.push_back(make_box(b));
+        }
+    }
+
+    std::vector<NarrowphaseManifold> sphere_manifolds(sphere_pairs.size());
+    std::vector<NarrowphaseManifold> sphere_box_manifolds(sphere_box_pairs.size());
+    std::vector<NarrowphaseManifold> box_manifolds(box_pairs.size());
+
+    for (size_t first = 0; first < sphere_pairs.size(); first += pairs_per_task)
+    {
+        size_t last = std::min(first + pairs_per_task, sphere_pairs.size());
+        task_scheduler.submitTask([&spheres_a, &spheres_b, &sphere_manifolds, first, last]() {
+            collideSpheres(spheres_a, spheres_b, first, last, contact_margin, sphere_manifolds.data() + first);
+        });
+    }
+
+    for (size_t first = 0; first < sphere_box_pairs.size(); first += pairs_per_task)
+    {
+        size_t last = std::min(first + pairs_per_task, sphere_box_pairs.size());
+        task_scheduler.submitTask([&sphere_box_spheres, &sphere_box_boxes, &sphere_box_manifolds, first, last]() {
+            collideSphereBoxes(sphere_box_spheres, sphere_box_boxes, first, last, contact_margin, sphere_box_manifolds.data() + first);
+        });
+    }
+
+    for (size_t first = 0; first < box_pairs.size(); first += pairs_per_task)
+    {
+        size_t last = std::min(first + pairs_per_task, box_pairs.size());
+        task_scheduler.submitTask([&boxes_a, &boxes_b, &box_manifolds, first, last]() {
+            collideBoxes(boxes_a, boxes_b, first, last, contact_margin, box_manifolds.data() + first);
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    std::vector<NarrowphaseManifold> pair_contacts(pairs.size());
+
+    for (size_t k = 0; k < sphere_pairs.size(); ++k) {
+        pair_contacts[sphere_pairs[k]] = sphere_manifolds[k];
+    }
+
+    for (size_t k = 0; k < sphere_box_pairs.size(); ++k)
+    {
+        size_t i = sphere_box_pairs[k];
+        pair_contacts[i] = sphere_box_manifolds[k];
+
+        // the normal points from the sphere to the box
+        if (m_bodies.shape[pairs[i].first] != RigidBodyShape::SPHERE) {
+            pair_contacts[i].normal = -pair_contacts[i].normal;
+        }
+    }
+
+    for (size_t k = 0; k < box_pairs.size(); ++k) {
+        pair_contacts[box_pairs[k]] = box_manifolds[k];
+    }
+
+    // compact touching pairs in pair order, which keeps the manifolds sorted by body indices
+    m_manifolds.clear();
+
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        NarrowphaseManifold const& result = pair_contacts[i];
+
+        if (result.contact_cnt == 0)
+            continue;
+
+        uint32_t a = pairs[i].first;
+        uint32_t b = pairs[i].second;
+
+        ContactManifold manifold;
+        manifold.body_a = a;
+        manifold.body_b = b;
+        manifold.normal = result.normal;
+        manifold.tangents[0] = computeTangent(result.normal);
+        manifold.tangents[1] = glm::cross(result.normal, manifold.tangents[0]);
+        manifold.friction = std::sqrt(m_bodies.friction[a] * m_bodies.friction[b]);
+        manifold.restitution = std::max(m_bodies.restitution[a], m_bodies.restitution[b]);
+        manifold.contact_cnt = result.contact_cnt;
+
+        Quat inverse_orientation_a = glm::conjugate(m_bodies.orientation[a]);
+
+        for (uint32_t c = 0; c < result.contact_cnt; ++c)
+        {
+            ContactPoint& contact = manifold.contacts[c];
+            contact.r_a = result.contacts[c].point - m_bodies.position[a];
+            contact.r_b = result.contacts[c].point - m_bodies.position[b];
+            contact.local_point = inverse_orientation_a * contact.r_a;
+            contact.penetration = result.contacts[c].penetration;
+            contact.normal_impulse = 0.0f;
+            contact.tangent_impulse[0] = 0.0f;
+            contact.tangent_impulse[1] = 0.0f;
+        }
+
+        m_manifolds.push_back(manifold);
+    }
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::warmStart(std::vector<ContactManifold> const& previous_manifolds)
+{
+    auto pair_less = [](ContactManifold const& lhs, ContactManifold const& rhs) {
+        return lhs.body_a < rhs.body_a || (lhs.body_a == rhs.body_a && lhs.body_b < rhs.body_b);
+    };
+
+    for (auto& manifold : m_manifolds)
+    {
+        auto previous = std::lower_bound(previous_manifolds.begin(), previous_manifolds.end(), manifold, pair_less);
+
+        if (previous == previous_manifolds.end() || previous->body_a != manifold.body_a || previous->body_b != manifold.body_b)
+            continue;
+
+        for (uint32_t c = 0; c < manifold.contact_cnt; ++c)
+        {
+            ContactPoint& contact = manifold.contacts[c];
+
+            for (uint32_t p = 0; p < previous->contact_cnt; ++p)
+            {
+                Vec3 d = previous->contacts[p].local_point - contact.local_point;
+
+                if (glm::dot(d, d) < contact_match_distance * contact_match_distance)
+                {
+                    contact.normal_impulse = previous->contacts[p].normal_impulse;
+                    contact.tangent_impulse[0] = previous->contacts[p].tangent_impulse[0];
+                    contact.tangent_impulse[1] = previous->contacts[p].tangent_impulse[1];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::prepareContacts(float timestep)
+{
+    for (auto& manifold : m_manifolds)
+    {
+        uint32_t a = manifold.body_a;
+        uint32_t b = manifold.body_b;
+
+        float inverse_mass_a = m_bodies.inverse_mass[a];
+        float inverse_mass_b = m_bodies.inverse_mass[b];
+        glm::mat3 const& inverse_inertia_a = m_bodies.world_inverse_inertia[a];
+        glm::mat3 const& inverse_inertia_b = m_bodies.world_inverse_inertia[b];
+
+        auto effective_mass = [&](Vec3 const& r_a, Vec3 const& r_b, Vec3 const& direction) {
+            Vec3 rn_a = glm::cross(r_a, direction);
+            Vec3 rn_b = glm::cross(r_b, direction);
+            float k = inverse_mass_a + inverse_mass_b + glm::dot(rn_a, inverse_inertia_a * rn_a) + glm::dot(rn_b, inverse_inertia_b * rn_b);
+            return k > 0.0f ? 1.0f / k : 0.0f;
+        };
+
+        for (uint32_t c = 0; c < manifold.contact_cnt; ++c)
+        {
+            ContactPoint& contact = manifold.contacts[c];
+
+            contact.normal_mass = effective_mass(contact.r_a, contact.r_b, manifold.normal);
+            contact.tangent_mass[0] = effective_mass(contact.r_a, contact.r_b, manifold.tangents[0]);
+            contact.tangent_mass[1] = effective_mass(contact.r_a, contact.r_b, manifold.tangents[1]);
+
+            Vec3 relative_velocity =
+                m_bodies.linear_velocity[b] + glm::cross(m_bodies.angular_velocity[b], contact.r_b) -
+                m_bodies.linear_velocity[a] - glm::cross(m_bodies.angular_velocity[a], contact.r_a);
+            float normal_velocity = glm::dot(relative_velocity, manifold.normal);
+
+            // separated contacts allow the bodies to approach until they touch
+            if (contact.penetration < 0.0f)
+            {
+                contact.relax_bias = contact.penetration / timestep;
+                contact.bias = contact.relax_bias;
+            }
+            else
+            {
+                contact.relax_bias = normal_velocity < -restitution_threshold ? -manifold.restitution * normal_velocity : 0.0f;
+                contact.bias = std::max(contact.relax_bias, (baumgarte_factor / timestep) * std::max(0.0f, contact.penetration - penetration_slop));
+            }
+
+            // apply the warm start impulse
+            Vec3 impulse = manifold.normal * contact.normal_impulse +
+                manifold.tangents[0] * contact.tangent_impulse[0] +
+                manifold.tangents[1] * contact.tangent_impulse[1];
+
+            if (inverse_mass_a > 0.0f)
+            {
+                m_bodies.linear_velocity[a] -= impulse * inverse_mass_a;
+                m_bodies.angular_velocity[a] -= inverse_inertia_a * glm::cross(contact.r_a, impulse);
+            }
+            if (inverse_mass_b > 0.0f)
+            {
+                m_bodies.linear_velocity[b] += impulse * inverse_mass_b;
+                m_bodies.angular_velocity[b] += inverse_inertia_b * glm::cross(contact.r_b, impulse);
+            }
+        }
+    }
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::colorManifolds()
+{
+    std::vector<uint64_t> body_colors(m_bodies.entity.size(), 0);
+
+    for (auto& batch : m_color_batches) {
+        batch.clear();
+    }
+
+    size_t color_cnt = 0;
+
+    // greedy coloring in manifold order, static bodies are never written and do not constrain the colors
+    for (uint32_t i = 0; i < m_manifolds.size(); ++i)
+    {
+        uint32_t a = m_manifolds[i].body_a;
+        uint32_t b = m_manifolds[i].body_b;
+        bool dynamic_a = m_bodies.inverse_mass[a] > 0.0f;
+        bool dynamic_b = m_bodies.inverse_mass[b] > 0.0f;
+
+        uint64_t used_colors = (dynamic_a ? body_colors[a] : 0) | (dynamic_b ? body_colors[b] : 0);
+        size_t color = static_cast<size_t>(std::countr_one(used_colors));
+
+        if (color < max_color_cnt)
+        {
+            if (dynamic_a) {
+                body_colors[a] |= uint64_t(1) << color;
+            }
+            if (dynamic_b) {
+                body_colors[b] |= uint64_t(1) << color;
+            }
+        }
+
+        if (color >= m_color_batches.size()) {
+            m_color_batches.resize(color + 1);
+        }
+
+        m_color_batches[color].push_back(i);
+        color_cnt = std::max(color_cnt, color + 1);
+    }
+
+    m_color_batches.resize(color_cnt);
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::solveContacts(Utility::TaskScheduler& task_scheduler, bool use_bias)
+{
+    for (size_t color = 0; color < m_color_batches.size(); ++color)
+    {
+        auto const& batch = m_color_batches[color];
+
+        // the overflow batch may contain manifolds sharing bodies and small batches are not worth a task
+        if (color == max_color_cnt || batch.size() <= manifolds_per_task)
+        {
+            for (uint32_t manifold_idx : batch) {
+                solveManifold(m_manifolds[manifold_idx], use_bias);
+            }
+            continue;
+        }
+
+        for (size_t first = 0; first < batch.size(); first += manifolds_per_task)
+        {
+            size_t last = std::min(first + manifolds_per_task, batch.size());
+
+            task_scheduler.submitTask(
+                [this, &batch, first, last, use_bias]() {
+                    for (size_t i = first; i < last; ++i) {
+                        solveManifold(m_manifolds[batch[i]], use_bias);
+                    }
+                }
+            );
+        }
+
+        task_scheduler.waitWhileBusy();
+    }
+}
+
+void EngineCore::Physics::RigidBodyComponentManager::solveManifold(ContactManifold& manifold, bool use_bias)
+{
+    uint32_t a = manifold.body_a;
+    uint32_t b = manifold.body_b;
+
+    float inverse_mass_a = m_bodies.inverse_mass[a];
+    float inverse_mass_b = m_bodies.inverse_mass[b];
+    glm::mat3 const& inverse_inertia_a = m_bodies.world_inverse_inertia[a];
+    glm::mat3 const& inverse_inertia_b = m_bodies.world_inverse_inertia[b];
+
+    // work on copies, static bodies are shared between batches and must not be written
+    Vec3 linear_velocity_a = m_bodies.linear_velocity[a];
+    Vec3 angular_velocity_a = m_bodies.angular_velocity[a];
+    Vec3 linear_velocity_b = m_bodies.linear_velocity[b];
+    Vec3 angular_velocity_b = m_bodies.angular_velocity[b];
+
+    auto apply_impulse = [&](ContactPoint const& contact, Vec3 const& impulse) {
+        linear_velocity_a -= impulse * inverse_mass_a;
+        angular_velocity_a -= inverse_inertia_a * glm::cross(contact.r_a, impulse);
+        linear_velocity_b += impulse * inverse_mass_b;
+        angular_velocity_b += inverse_inertia_b * glm::cross(contact.r_b, impulse);
+    };
+
+    auto relative_velocity = [&](ContactPoint const& contact) {
+        return linear_velocity_b + glm::cross(angular_velocity_b, contact.r_b) - linear_velocity_a - glm::cross(angular_velocity_a, contact.r_a);
+    };
+
+    // friction first, the non-penetration constraint is more important and solved last
+    for (uint32_t c = 0; c < manifold.contact_cnt; ++c)
+    {
+        ContactPoint& contact = manifold.contacts[c];
+        float max_friction = manifold.friction * contact.normal_impulse;
+
+        for (int t = 0; t < 2; ++t)
+        {
+            float tangent_velocity = glm::dot(relative_velocity(contact), manifold.tangents[t]);
+            float impulse = -tangent_velocity * contact.tangent_mass[t];
+
+            float accumulated = std::min(max_friction, std::max(-max_friction, contact.tangent_impulse[t] + impulse));
+            impulse = accumulated - contact.tangent_impulse[t];
+            contact.tangent_impulse[t] = accumulated;
+
+            apply_impulse(contact, manifold.tangents[t] * impulse);
+        }
+    }
+
+    for (uint32_t c = 0; c < manifold.contact_cnt; ++c)
+    {
+        ContactPoint& contact = manifold.contacts[c];
+
+        float normal_velocity = glm::dot(relative_velocity(contact), manifold.normal);
+        float impulse = contact.normal_mass * ((use_bias ? contact.bias : contact.relax_bias) - normal_velocity);
+
+        float accumulated = std::max(0.0f, contact.normal_impulse + impulse);
+        impulse = accumulated - contact.normal_impulse;
+        contact.normal_impulse = accumulated;
+
+        apply_impulse(contact, manifold.normal * impulse);
+    }
+
+    if (inverse_mass_a > 0.0f)
+    {
+        m_bodies.linear_velocity[a] = linear_velocity_a;
+        m_bodies.angular_velocity[a] = angular_velocity_a;
+    }
+    if (inverse_mass_b > 0.0f)
+    {
+        m_bodies.linear_velocity[b] = linear_velocity_b;
+        m_bodies.angular_velocity[b] = angular_velocity_b;
+    }
+}
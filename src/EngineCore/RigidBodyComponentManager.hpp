@@ -0,0 +1,169 @@
+#ifndef RigidBodyComponentManager_hpp
+#define RigidBodyComponentManager_hpp
+
+#include <shared_mutex>
+#include <vector>
+
+#include "BaseSingleInstanceComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Common
+    {
+        class TransformComponentManager;
+    }
+
+    namespace Physics
+    {
+        enum class RigidBodyShape
+        {
+            SPHERE, ///< Radius stored in the x component of the extents
+            BOX     ///< Half extents
+        };
+
+        struct RigidBodySolverStats
+        {
+            size_t body_cnt = 0;
+            size_t pair_cnt = 0;          ///< Body pairs with overlapping bounds
+            size_t manifold_cnt = 0;      ///< Touching body pairs
+            size_t contact_cnt = 0;
+            size_t color_cnt = 0;         ///< Constraint colors, i.e. parallel solver batches per iteration
+            double collision_time = 0.0;  ///< Seconds spent finding contacts in the last update
+            double solver_time = 0.0;     ///< Seconds spent solving contacts in the last update
+        };
+
+        /**
+        * \class RigidBodyComponentManager
+        *
+        * \brief Simulates rigid spheres and boxes with semi-implicit Euler integration and a sequential impulse
+        * contact solver.
+        *
+        * Body state is stored as structure of arrays. Contact manifolds are graph coloured, i.e. split into batches
+        * in which no two manifolds share a dynamic body, so that each batch is solved in parallel without locking.
+        * Contact impulses are warm started from the previous update. Results are deterministic and do not depend
+        * on the number of worker threads.
+        *
+        * The manager owns the transformation of its bodies, it writes the local transformations of all bodies after
+        * each update, so bodies should not be parented. Use setPose to move a body.
+        */
+        class RigidBodyComponentManager : public BaseSingleInstanceComponentManager
+        {
+        public:
+            RigidBodyComponentManager();
+            ~RigidBodyComponentManager() = default;
+
+            /**
+            * \param mass Mass of the body, 0 creates a static body
+            */
+            void addSphereComponent(Entity entity, Vec3 position, float radius, float mass, float friction = 0.5f, float restitution = 0.0f);
+
+            /**
+            * \param mass Mass of the body, 0 creates a static body
+            */
+            void addBoxComponent(Entity entity, Vec3 position, Quat orientation, Vec3 half_extents, float mass, float friction = 0.5f, float restitution = 0.0f);
+
+            size_t getComponentCount() const;
+
+            Vec3 getPosition(size_t index) const;
+
+            Quat getOrientation(size_t index) const;
+
+            Vec3 getLinearVelocity(size_t index) const;
+
+            Vec3 getAngularVelocity(size_t index) const;
+
+            void setPose(size_t index, Vec3 position, Quat orientation);
+
+            void setLinearVelocity(size_t index, Vec3 velocity);
+
+            void setAngularVelocity(size_t index, Vec3 velocity);
+
+            void setGravity(Vec3 gravity);
+
+            void setSolverIterations(uint iterations);
+
+            /**
+            * \brief Advance all bodies by the timestep and write their transformations. Collision detection and
+            * contact batches run on the task scheduler. Meant to be run as PhysicsSystem simulation.
+            */
+            void update(float timestep, Common::TransformComponentManager& transform_mngr, Utility::TaskScheduler& task_scheduler);
+
+            RigidBodySolverStats getSolverStats() const;
+
+        private:
+            struct Bodies
+            {
+                std::vector<Entity>         entity;
+                std::vector<RigidBodyShape> shape;
+                std::vector<Vec3>           extents;
+                std::vector<Vec3>           position;
+                std::vector<Quat>           orientation;
+                std::vector<Vec3>           linear_velocity;
+                std::vector<Vec3>           angular_velocity;
+                std::vector<float>          inverse_mass;          ///< 0 for static bodies
+                std::vector<Vec3>           inverse_inertia;       ///< Diagonal of the inverse inertia tensor in body space
+                std::vector<glm::mat3>      world_inverse_inertia; ///< Inverse inertia tensor in world space, updated per step
+                std::vector<float>          friction;
+                std::vector<float>          restitution;
+            };
+
+            struct ContactPoint
+            {
+                Vec3  local_point;     ///< Contact point in the frame of body a, used for matching contacts between updates
+                Vec3  r_a;             ///< Contact point relative to the center of body a
+                Vec3  r_b;
+                float penetration;     ///< Negative for contacts that are separated by less than the contact margin
+                float normal_mass;
+                float tangent_mass[2];
+                float bias;            ///< Target normal velocity, including position correction
+                float relax_bias;      ///< Target normal velocity without position correction
+                float normal_impulse;  ///< Accumulated impulses
+                float tangent_impulse[2];
+            };
+
+            struct ContactManifold
+            {
+                uint32_t     body_a;
+                uint32_t     body_b;
+                Vec3         normal;   ///< Points from body a to body b
+                Vec3         tangents[2];
+                float        friction;
+                float        restitution;
+                uint32_t     contact_cnt;
+                ContactPoint contacts[4];
+            };
+
+            void addBody(Entity entity, RigidBodyShape shape, Vec3 extents, Vec3 position, Quat orientation, float mass, Vec3 inertia, float friction, float restitution);
+
+            void findContacts(Utility::TaskScheduler& task_scheduler);
+
+            void warmStart(std::vector<ContactManifold> const& previous_manifolds);
+
+            void prepareContacts(float timestep);
+
+            void colorManifolds();
+
+            /** One solver iteration over all color batches */
+            void solveContacts(Utility::TaskScheduler& task_scheduler, bool use_bias);
+
+            void solveManifold(ContactManifold& manifold, bool use_bias);
+
+            Bodies m_bodies;
+
+            std::vector<ContactManifold>       m_manifolds;
+            std::vector<std::vector<uint32_t>> m_color_batches; ///< Manifold indices per color
+
+            Vec3 m_gravity;
+            uint m_solver_iterations;
+
+            RigidBodySolverStats m_stats;
+
+            mutable std::shared_mutex m_data_access_mutex;
+        };
+    }
+}
+
+#endif // !RigidBodyComponentManager_hpp
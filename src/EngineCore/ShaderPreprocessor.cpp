@@ -0,0 +1,165 @@
+#include "ShaderPreprocessor.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "ResourceLoading.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        ShaderPreprocessor::PreprocessedShaderPtr ShaderPreprocessor::preprocess(std::string const& path, std::string const& defines)
+        {
+            std::string cache_key = path + '\n' + defines;
+
+            {
+                std::shared_lock<std::shared_mutex> lock(m_cache_mutex);
+                auto query = m_cache.find(cache_key);
+                if (query != m_cache.end() && isUpToDate(query->second))
+                    return query->second.shader;
+            }
+
+            auto shader = std::make_shared<PreprocessedShader>();
+
+            expandFile(std::filesystem::path(path), shader->source, shader->files);
+
+            if (!defines.empty())
+            {
+                size_t version = shader->source.find("#version");
+                size_t insertion = version != std::string::npos ? shader->source.find('\n', version) : std::string::npos;
+
+                if (insertion != std::string::npos)
+                {
+                    ++insertion;
+                    size_t next_line = std::count(shader->source.begin(), shader->source.begin() + insertion, '\n') + 1;
+
+                    std::string define_block = defines;
+                    if (define_block.back() != '\n') {
+                        define_block += '\n';
+                    }
+                    define_block += "#line " + std::to_string(next_line) + " 0\n";
+
+                    shader->source.insert(insertion, define_block);
+                }
+                else
+                {
+                    shader->source.insert(0, defines + '\n');
+                }
+            }
+
+            shader->hash = computeHash(shader->source);
+
+            CacheEntry entry;
+            entry.shader = shader;
+            for (auto const& file : shader->files)
+            {
+                std::error_code ec;
+                entry.write_times.push_back(std::filesystem::last_write_time(file, ec));
+            }
+
+            std::unique_lock<std::shared_mutex> lock(m_cache_mutex);
+            m_cache[cache_key] = entry;
+
+            return shader;
+        }
+
+        void ShaderPreprocessor::clearCache()
+        {
+            std::unique_lock<std::shared_mutex> lock(m_cache_mutex);
+            m_cache.clear();
+        }
+
+        uint64_t ShaderPreprocessor::computeHash(void const* data, size_t byte_size, uint64_t seed)
+        {
+            uint64_t hash = seed;
+            auto bytes = reinterpret_cast<uint8_t const*>(data);
+            for (size_t i = 0; i < byte_size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        uint64_t ShaderPreprocessor::computeHash(std::string const& str, uint64_t seed)
+        {
+            return computeHash(str.data(), str.size(), seed);
+        }
+
+        void ShaderPreprocessor::expandFile(
+            std::filesystem::path const& path,
+            std::string& output,
+            std::vector<std::string>& files)
+        {
+            std::string file_name = path.lexically_normal().generic_string();
+
+            size_t file_idx = files.size();
+            files.push_back(file_name);
+
+            std::string source = ResourceLoading::readShaderFile(file_name.c_str());
+
+            output.reserve(output.size() + source.size());
+
+            size_t line_number = 1;
+            size_t line_begin = 0;
+
+            while (line_begin < source.size())
+            {
+                size_t line_end = source.find('\n', line_begin);
+                line_end = line_end != std::string::npos ? line_end + 1 : source.size();
+
+                size_t directive = source.find_first_not_of(" \t", line_begin);
+                bool is_include = directive < line_end && source.compare(directive, 8, "#include") == 0;
+
+                if (is_include)
+                {
+                    size_t name_begin = source.find_first_of("\"<", directive + 8);
+                    size_t name_end = name_begin < line_end ? source.find_first_of("\">", name_begin + 1) : std::string::npos;
+
+                    if (name_begin >= line_end || name_end >= line_end) {
+                        throw std::runtime_error("Malformed #include in " + file_name + " line " + std::to_string(line_number));
+                    }
+
+                    std::filesystem::path include_path = path.parent_path() / source.substr(name_begin + 1, name_end - name_begin - 1);
+
+                    if (std::find(files.begin(), files.end(), include_path.lexically_normal().generic_string()) != files.end())
+                    {
+                        // keep line numbering intact
+                        output += '\n';
+                    }
+                    else
+                    {
+                        output += "#line 1 " + std::to_string(files.size()) + "\n";
+                        expandFile(include_path, output, files);
+                        if (output.back() != '\n') {
+                            output += '\n';
+                        }
+                        output += "#line " + std::to_string(line_number + 1) + " " + std::to_string(file_idx) + "\n";
+                    }
+                }
+                else
+                {
+                    output.append(source, line_begin, line_end - line_begin);
+                }
+
+                line_begin = line_end;
+                ++line_number;
+            }
+        }
+
+        bool ShaderPreprocessor::isUpToDate(CacheEntry const& entry)
+        {
+            for (size_t i = 0; i < entry.shader->files.size(); ++i)
+            {
+                std::error_code ec;
+                auto write_time = std::filesystem::last_write_time(entry.shader->files[i], ec);
+                if (ec || write_time != entry.write_times[i])
+                    return false;
+            }
+            return true;
+        }
+    }
+}
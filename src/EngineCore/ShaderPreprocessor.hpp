@@ -0,0 +1,86 @@
+#ifndef ShaderPreprocessor_hpp
+#define ShaderPreprocessor_hpp
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \class ShaderPreprocessor
+        *
+        * \brief Loads shader source files, resolves #include directives and caches the results.
+        *
+        * Include paths are resolved relative to the directory of the including file. Each file is included at most once
+        * per shader (i.e. all includes behave like #pragma once), which also breaks include cycles. #line directives are
+        * emitted around included files, so that compiler messages refer to the line in the original file. The source
+        * string number of a #line directive is the index of the file in PreprocessedShader::files.
+        *
+        * Results are cached per path and defines. A cached result is reused as long as none of the files it was built
+        * from has been modified. All methods are thread-safe.
+        */
+        class ShaderPreprocessor
+        {
+        public:
+            struct PreprocessedShader
+            {
+                std::string              source; ///< Final shader source, including defines
+                uint64_t                 hash;   ///< Hash of the final source
+                std::vector<std::string> files;  ///< All files the source was built from, starting with the main file
+            };
+
+            typedef std::shared_ptr<PreprocessedShader const> PreprocessedShaderPtr;
+
+            ShaderPreprocessor() = default;
+            ~ShaderPreprocessor() = default;
+
+            ShaderPreprocessor(ShaderPreprocessor const& cpy) = delete;
+            ShaderPreprocessor& operator=(ShaderPreprocessor const& rhs) = delete;
+
+            /**
+            * \brief Load a shader file and resolve all includes. Throws std::runtime_error if a file can't be read.
+            * \param path Path of the main shader file
+            * \param defines Additional lines inserted after the #version statement
+            */
+            PreprocessedShaderPtr preprocess(std::string const& path, std::string const& defines = "");
+
+            void clearCache();
+
+            /**
+            * \brief 64bit FNV-1a hash, use seed to chain multiple hashes
+            */
+            static uint64_t computeHash(void const* data, size_t byte_size, uint64_t seed = 14695981039346656037ull);
+
+            static uint64_t computeHash(std::string const& str, uint64_t seed = 14695981039346656037ull);
+
+        private:
+            struct CacheEntry
+            {
+                PreprocessedShaderPtr                        shader;
+                std::vector<std::filesystem::file_time_type> write_times; ///< Last write time of each file at preprocessing time
+            };
+
+            /**
+            * Append the content of a file to the output, recursively expanding includes
+            */
+            void expandFile(
+                std::filesystem::path const& path,
+                std::string& output,
+                std::vector<std::string>& files);
+
+            static bool isUpToDate(CacheEntry const& entry);
+
+            std::unordered_map<std::string, CacheEntry> m_cache;
+            std::shared_mutex                           m_cache_mutex;
+        };
+    }
+}
+
+#endif // !ShaderPreprocessor_hpp
@@ -0,0 +1,217 @@
+#ifndef SimdFloat_hpp
+#define SimdFloat_hpp
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "types.hpp"
+
+#if defined(__AVX2__)
+#define SIMD_FLOAT_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_FLOAT_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SIMD_FLOAT_AVX2) || defined(SIMD_FLOAT_SSE2)
+#define SIMD_FLOAT_VECTORIZED
+#endif
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+        /**
+        * Thin wrapper around the float registers of the target architecture (8 lanes with AVX2, 4 with SSE2, a single
+        * float otherwise), so that batched kernels are written once for all register widths. Comparisons return lane
+        * masks that are consumed by select and laneMask.
+        */
+        namespace Simd
+        {
+#if defined(SIMD_FLOAT_AVX2)
+            constexpr size_t width = 8;
+
+            struct FloatN { __m256 v; };
+
+            inline FloatN load(float const* p) { return { _mm256_loadu_ps(p) }; }
+            inline FloatN splat(float s) { return { _mm256_set1_ps(s) }; }
+            inline void store(float* p, FloatN a) { _mm256_storeu_ps(p, a.v); }
+
+            inline FloatN operator+(FloatN a, FloatN b) { return { _mm256_add_ps(a.v, b.v) }; }
+            inline FloatN operator-(FloatN a, FloatN b) { return { _mm256_sub_ps(a.v, b.v) }; }
+            inline FloatN operator*(FloatN a, FloatN b) { return { _mm256_mul_ps(a.v, b.v) }; }
+            inline FloatN operator/(FloatN a, FloatN b) { return { _mm256_div_ps(a.v, b.v) }; }
+            inline FloatN operator-(FloatN a) { return { _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)) }; }
+
+            inline FloatN operator<(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+            inline FloatN operator<=(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+            inline FloatN operator>(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+            inline FloatN operator>=(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+            inline FloatN operator==(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+            inline FloatN operator&(FloatN a, FloatN b) { return { _mm256_and_ps(a.v, b.v) }; }
+            inline FloatN operator|(FloatN a, FloatN b) { return { _mm256_or_ps(a.v, b.v) }; }
+            inline FloatN operator^(FloatN a, FloatN b) { return { _mm256_xor_ps(a.v, b.v) }; }
+
+            inline FloatN vmin(FloatN a, FloatN b) { return { _mm256_min_ps(a.v, b.v) }; }
+            inline FloatN vmax(FloatN a, FloatN b) { return { _mm256_max_ps(a.v, b.v) }; }
+            inline FloatN vabs(FloatN a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+            inline FloatN vsqrt(FloatN a) { return { _mm256_sqrt_ps(a.v) }; }
+            inline FloatN vtrunc(FloatN a) { return { _mm256_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC) }; }
+
+            /** a where the mask is set, b otherwise */
+            inline FloatN select(FloatN mask, FloatN a, FloatN b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+            inline int laneMask(FloatN mask) { return _mm256_movemask_ps(mask.v); }
+#elif defined(SIMD_FLOAT_SSE2)
+            constexpr size_t width = 4;
+
+            struct FloatN { __m128 v; };
+
+            inline FloatN load(float const* p) { return { _mm_loadu_ps(p) }; }
+            inline FloatN splat(float s) { return { _mm_set1_ps(s) }; }
+            inline void store(float* p, FloatN a) { _mm_storeu_ps(p, a.v); }
+
+            inline FloatN operator+(FloatN a, FloatN b) { return { _mm_add_ps(a.v, b.v) }; }
+            inline FloatN operator-(FloatN a, FloatN b) { return { _mm_sub_ps(a.v, b.v) }; }
+            inline FloatN operator*(FloatN a, FloatN b) { return { _mm_mul_ps(a.v, b.v) }; }
+            inline FloatN operator/(FloatN a, FloatN b) { return { _mm_div_ps(a.v, b.v) }; }
+            inline FloatN operator-(FloatN a) { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)) }; }
+
+            inline FloatN operator<(FloatN a, FloatN b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+            inline FloatN operator<=(FloatN a, FloatN b) { return { _mm_cmple_ps(a.v, b.v) }; }
+            inline FloatN operator>(FloatN a, FloatN b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+            inline FloatN operator>=(FloatN a, FloatN b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+            inline FloatN operator==(FloatN a, FloatN b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+            inline FloatN operator&(FloatN a, FloatN b) { return { _mm_and_ps(a.v, b.v) }; }
+            inline FloatN operator|(FloatN a, FloatN b) { return { _mm_or_ps(a.v, b.v) }; }
+            inline FloatN operator^(FloatN a, FloatN b) { return { _mm_xor_ps(a.v, b.v) }; }
+
+            inline FloatN vmin(FloatN a, FloatN b) { return { _mm_min_ps(a.v, b.v) }; }
+            inline FloatN vmax(FloatN a, FloatN b) { return { _mm_max_ps(a.v, b.v) }; }
+            inline FloatN vabs(FloatN a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+            inline FloatN vsqrt(FloatN a) { return { _mm_sqrt_ps(a.v) }; }
+            /** Only valid for |a| < 2^31 */
+            inline FloatN vtrunc(FloatN a) { return { _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v)) }; }
+
+            /** a where the mask is set, b otherwise */
+            inline FloatN select(FloatN mask, FloatN a, FloatN b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+            inline int laneMask(FloatN mask) { return _mm_movemask_ps(mask.v); }
+#else
+            constexpr size_t width = 1;
+
+            struct FloatN { float v; };
+
+            inline FloatN fromBits(uint32_t bits) { return { std::bit_cast<float>(bits) }; }
+            inline uint32_t toBits(FloatN a) { return std::bit_cast<uint32_t>(a.v); }
+            inline FloatN fromBool(bool b) { return fromBits(b ? 0xffffffffu : 0u); }
+
+            inline FloatN load(float const* p) { return { *p }; }
+            inline FloatN splat(float s) { return { s }; }
+            inline void store(float* p, FloatN a) { *p = a.v; }
+
+            inline FloatN operator+(FloatN a, FloatN b) { return { a.v + b.v }; }
+            inline FloatN operator-(FloatN a, FloatN b) { return { a.v - b.v }; }
+            inline FloatN operator*(FloatN a, FloatN b) { return { a.v * b.v }; }
+            inline FloatN operator/(FloatN a, FloatN b) { return { a.v / b.v }; }
+            inline FloatN operator-(FloatN a) { return { -a.v }; }
+
+            inline FloatN operator<(FloatN a, FloatN b) { return fromBool(a.v < b.v); }
+            inline FloatN operator<=(FloatN a, FloatN b) { return fromBool(a.v <= b.v); }
+            inline FloatN operator>(FloatN a, FloatN b) { return fromBool(a.v > b.v); }
+            inline FloatN operator>=(FloatN a, FloatN b) { return fromBool(a.v >= b.v); }
+            inline FloatN operator==(FloatN a, FloatN b) { return fromBool(a.v == b.v); }
+            inline FloatN operator&(FloatN a, FloatN b) { return fromBits(toBits(a) & toBits(b)); }
+            inline FloatN operator|(FloatN a, FloatN b) { return fromBits(toBits(a) | toBits(b)); }
+            inline FloatN operator^(FloatN a, FloatN b) { return fromBits(toBits(a) ^ toBits(b)); }
+
+            inline FloatN vmin(FloatN a, FloatN b) { return { b.v < a.v ? b.v : a.v }; }
+            inline FloatN vmax(FloatN a, FloatN b) { return { a.v < b.v ? b.v : a.v }; }
+            inline FloatN vabs(FloatN a) { return { std::abs(a.v) }; }
+            inline FloatN vsqrt(FloatN a) { return { std::sqrt(a.v) }; }
+            inline FloatN vtrunc(FloatN a) { return { std::trunc(a.v) }; }
+
+            /** a where the mask is set, b otherwise */
+            inline FloatN select(FloatN mask, FloatN a, FloatN b) { return toBits(mask) != 0 ? a : b; }
+            inline int laneMask(FloatN mask) { return toBits(mask) != 0 ? 1 : 0; }
+#endif
+
+            /** Same as clamping with std::min and std::max */
+            inline FloatN clamp(FloatN x, FloatN lo, FloatN hi) { return vmin(hi, vmax(lo, x)); }
+
+            /**
+            * \brief Sine and cosine with Cephes style range reduction and polynomials, accurate to a few ulp for
+            * |x| < 8192
+            */
+            inline void vsincos(FloatN x, FloatN& s, FloatN& c)
+            {
+                FloatN ax = vabs(x);
+
+                // even multiple j of pi/4 closest to ax, octant pair q = j/2 mod 4
+                FloatN j = splat(2.0f) * vtrunc((vtrunc(ax * splat(1.27323954473516f)) + splat(1.0f)) * splat(0.5f));
+                FloatN q = j * splat(0.5f);
+                q = q - splat(4.0f) * vtrunc(q * splat(0.25f));
+
+                FloatN y = ((ax - j * splat(0.78515625f)) - j * splat(2.4187564849853515625e-4f)) - j * splat(3.77489497744594108e-8f);
+                FloatN z = y * y;
+
+                FloatN sin_poly = ((splat(-1.9515295891e-4f) * z + splat(8.3321608736e-3f)) * z - splat(1.6666654611e-1f)) * z * y + y;
+                FloatN cos_poly = ((splat(2.443315711809948e-5f) * z - splat(1.388731625493765e-3f)) * z + splat(4.166664568298827e-2f)) * z * z - splat(0.5f) * z + splat(1.0f);
+
+                FloatN odd = (q - splat(2.0f) * vtrunc(q * splat(0.5f))) == splat(1.0f);
+                FloatN sin_negative = (q >= splat(2.0f)) ^ (x < splat(0.0f));
+                FloatN cos_negative = (q == splat(1.0f)) | (q == splat(2.0f));
+
+                s = select(odd, cos_poly, sin_poly);
+                c = select(odd, sin_poly, cos_poly);
+                s = select(sin_negative, -s, s);
+                c = select(cos_negative, -c, c);
+            }
+
+            /**
+            * \brief Arc cosine with Cephes polynomials, x is clamped to [-1,1]
+            */
+            inline FloatN vacos(FloatN x)
+            {
+                x = clamp(x, splat(-1.0f), splat(1.0f));
+                FloatN a = vabs(x);
+
+                // acos(a) = 2 asin(sqrt((1 - a) / 2)) for a > 0.5, pi/2 - asin(a) otherwise
+                FloatN large = a > splat(0.5f);
+                FloatN z = select(large, splat(0.5f) * (splat(1.0f) - a), a * a);
+                FloatN s = select(large, vsqrt(z), a);
+
+                FloatN p = ((((splat(4.2163199048e-2f) * z + splat(2.4181311049e-2f)) * z + splat(4.5470025998e-2f)) * z + splat(7.4953002686e-2f)) * z + splat(1.6666752422e-1f)) * z * s + s;
+
+                FloatN result = select(large, splat(2.0f) * p, splat(1.5707963267948966f) - p);
+                return select(x < splat(0.0f), splat(3.14159265358979f) - result, result);
+            }
+
+            struct Vec3N
+            {
+                FloatN x;
+                FloatN y;
+                FloatN z;
+            };
+
+            inline Vec3N splat(Vec3 const& v) { return { splat(v.x), splat(v.y), splat(v.z) }; }
+
+            inline Vec3N operator+(Vec3N const& a, Vec3N const& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+            inline Vec3N operator-(Vec3N const& a, Vec3N const& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+            inline Vec3N operator-(Vec3N const& a) { return { -a.x, -a.y, -a.z }; }
+            inline Vec3N operator*(Vec3N const& a, FloatN s) { return { a.x * s, a.y * s, a.z * s }; }
+            inline Vec3N operator*(FloatN s, Vec3N const& a) { return { s * a.x, s * a.y, s * a.z }; }
+            inline Vec3N operator/(Vec3N const& a, FloatN s) { return { a.x / s, a.y / s, a.z / s }; }
+
+            /** Same evaluation order as glm */
+            inline FloatN dot(Vec3N const& a, Vec3N const& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+            inline Vec3N cross(Vec3N const& a, Vec3N const& b) { return { a.y * b.z - b.y * a.z, a.z * b.x - b.z * a.x, a.x * b.y - b.x * a.y }; }
+            inline FloatN length(Vec3N const& a) { return vsqrt(dot(a, a)); }
+
+            inline Vec3N select(FloatN mask, Vec3N const& a, Vec3N const& b) { return { select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z) }; }
+        }
+    }
+}
+
+#endif // !SimdFloat_hpp
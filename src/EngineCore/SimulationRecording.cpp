@@ -0,0 +1,679 @@
+#include "SimulationRecording.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "AirplanePhysicsComponent.hpp"
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace
+{
+    constexpr char     recording_file_magic[4] = { 'S','L','S','R' };
+    constexpr uint32_t recording_file_version = 1;
+
+    enum Stream
+    {
+        TRANSFORM_STREAM, ///< position, orientation (x,y,z,w) and scale
+        AIRPLANE_STREAM,  ///< AirplaneState
+        STREAM_CNT
+    };
+
+    using AirplaneState = EngineCore::Physics::AirplanePhysicsComponentManager::AirplaneState;
+
+    static_assert(sizeof(AirplaneState) % sizeof(float) == 0, "Airplane states are recorded as float arrays");
+
+    constexpr size_t stream_element_sizes[STREAM_CNT] = { 10, sizeof(AirplaneState) / sizeof(float) };
+
+    template<typename T>
+    void writeValue(std::ofstream& file, T value)
+    {
+        file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool readValue(std::ifstream& file, T& value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    void writeVarint(std::vector<uint8_t>& data, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            data.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool readVarint(std::vector<uint8_t> const& data, size_t& offset, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (offset >= data.size())
+                return false;
+
+            uint8_t byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    void writeFloat(std::vector<uint8_t>& data, float value)
+    {
+        uint8_t bytes[sizeof(float)];
+        std::memcpy(bytes, &value, sizeof(float));
+        data.insert(data.end(), bytes, bytes + sizeof(float));
+    }
+
+    bool readFloat(std::vector<uint8_t> const& data, size_t& offset, float& value)
+    {
+        if (offset + sizeof(float) > data.size())
+            return false;
+
+        std::memcpy(&value, data.data() + offset, sizeof(float));
+        offset += sizeof(float);
+        return true;
+    }
+
+    /**
+    * XOR the bits of each value with its reference (zero if there is none) and keep only the bytes below the
+    * leading zero bytes. The byte counts of two values share one header byte.
+    */
+    void encodeElement(std::vector<uint8_t>& data, float const* values, float const* reference, size_t cnt)
+    {
+        size_t header_offset = data.size();
+        data.resize(data.size() + (cnt + 1) / 2, 0);
+
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            uint32_t bits, reference_bits = 0;
+            std::memcpy(&bits, values + i, sizeof(uint32_t));
+            if (reference != nullptr) {
+                std::memcpy(&reference_bits, reference + i, sizeof(uint32_t));
+            }
+            bits ^= reference_bits;
+
+            uint8_t byte_cnt = 0;
+            while (byte_cnt < 4 && (bits >> (8 * byte_cnt)) != 0) {
+                ++byte_cnt;
+            }
+
+            data[header_offset + i / 2] |= static_cast<uint8_t>(byte_cnt << (4 * (i % 2)));
+
+            for (uint8_t b = 0; b < byte_cnt; ++b) {
+                data.push_back(static_cast<uint8_t>(bits >> (8 * b)));
+            }
+        }
+    }
+
+    bool decodeElement(std::vector<uint8_t> const& data, size_t& offset, float* values, float const* reference, size_t cnt)
+    {
+        size_t header_offset = offset;
+        offset += (cnt + 1) / 2;
+        if (offset > data.size())
+            return false;
+
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            uint8_t byte_cnt = (data[header_offset + i / 2] >> (4 * (i % 2))) & 0xf;
+            if (byte_cnt > 4 || offset + byte_cnt > data.size())
+                return false;
+
+            uint32_t bits = 0;
+            for (uint8_t b = 0; b < byte_cnt; ++b) {
+                bits |= static_cast<uint32_t>(data[offset++]) << (8 * b);
+            }
+
+            uint32_t reference_bits = 0;
+            if (reference != nullptr) {
+                std::memcpy(&reference_bits, reference + i, sizeof(uint32_t));
+            }
+            bits ^= reference_bits;
+
+            std::memcpy(values + i, &bits, sizeof(uint32_t));
+        }
+
+        return true;
+    }
+
+    void captureState(EngineCore::WorldState& world, std::vector<std::vector<float>>& state)
+    {
+        state.resize(STREAM_CNT);
+
+        // resolve the managers once, the lookup locks the world state
+        auto const* transform_mngr = world.has<EngineCore::Common::TransformComponentManager>() ? &world.get<EngineCore::Common::TransformComponentManager>() : nullptr;
+        auto const* airplane_mngr = world.has<EngineCore::Physics::AirplanePhysicsComponentManager>() ? &world.get<EngineCore::Physics::AirplanePhysicsComponentManager>() : nullptr;
+
+        size_t transform_cnt = transform_mngr != nullptr ? transform_mngr->getComponentCount() : 0;
+        auto& transforms = state[TRANSFORM_STREAM];
+        transforms.resize(transform_cnt * stream_element_sizes[TRANSFORM_STREAM]);
+
+        for (size_t i = 0; i < transform_cnt; ++i)
+        {
+            Vec3 const& position = transform_mngr->getPosition(i);
+            Quat const& orientation = transform_mngr->getOrientation(i);
+            Vec3 const& scale = transform_mngr->getScale(i);
+
+            float* element = transforms.data() + i * stream_element_sizes[TRANSFORM_STREAM];
+            element[0] = position.x;
+            element[1] = position.y;
+            element[2] = position.z;
+            element[3] = orientation.x;
+            element[4] = orientation.y;
+            element[5] = orientation.z;
+            element[6] = orientation.w;
+            element[7] = scale.x;
+            element[8] = scale.y;
+            element[9] = scale.z;
+        }
+
+        auto& airplanes = state[AIRPLANE_STREAM];
+        if (airplane_mngr != nullptr)
+        {
+            auto airplane_states = airplane_mngr->getStates();
+            airplanes.resize(airplane_states.size() * stream_element_sizes[AIRPLANE_STREAM]);
+            std::memcpy(airplanes.data(), airplane_states.data(), airplane_states.size() * sizeof(AirplaneState));
+        }
+        else
+        {
+            airplanes.clear();
+        }
+    }
+}
+
+EngineCore::Physics::SimulationRecorder::SimulationRecorder(WorldState& world, uint keyframe_interval)
+    : m_world(world),
+    m_keyframe_interval(std::max(keyframe_interval, 1u)),
+    m_chunk_first_tick(0),
+    m_chunk_tick_cnt(0),
+    m_tick_cnt(0),
+    m_byte_size(0)
+{
+}
+
+EngineCore::Physics::SimulationRecorder::~SimulationRecorder()
+{
+    end();
+}
+
+bool EngineCore::Physics::SimulationRecorder::begin(std::string const& path)
+{
+    end();
+
+    std::unique_lock<std::mutex> lock(m_recording_mutex);
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+        return false;
+
+    m_file.write(recording_file_magic, 4);
+    writeValue(m_file, recording_file_version);
+    writeValue(m_file, static_cast<uint32_t>(m_keyframe_interval));
+
+    m_chunks.clear();
+    m_chunk_first_tick = 0;
+    m_chunk_tick_cnt = 0;
+    m_chunk_data.clear();
+    m_previous_state.clear();
+    m_tick_cnt = 0;
+    m_byte_size = static_cast<size_t>(m_file.tellp());
+
+    {
+        std::unique_lock<std::mutex> input_lock(m_input_mutex);
+        m_pending_input_events.clear();
+    }
+
+    return static_cast<bool>(m_file);
+}
+
+bool EngineCore::Physics::SimulationRecorder::end()
+{
+    std::unique_lock<std::mutex> lock(m_recording_mutex);
+
+    if (!m_file.is_open())
+        return false;
+
+    if (m_chunk_tick_cnt > 0) {
+        writeChunk();
+    }
+
+    uint64_t table_offset = static_cast<uint64_t>(m_file.tellp());
+    for (auto const& chunk : m_chunks)
+    {
+        writeValue(m_file, chunk.first_tick);
+        writeValue(m_file, chunk.tick_cnt);
+        writeValue(m_file, chunk.file_offset);
+    }
+    writeValue(m_file, static_cast<uint64_t>(m_chunks.size()));
+    writeValue(m_file, table_offset);
+    m_file.write(recording_file_magic, 4);
+
+    bool success = static_cast<bool>(m_file);
+    m_file.close();
+
+    return success;
+}
+
+bool EngineCore::Physics::SimulationRecorder::isRecording() const
+{
+    std::unique_lock<std::mutex> lock(m_recording_mutex);
+    return m_file.is_open();
+}
+
+void EngineCore::Physics::SimulationRecorder::recordInputEvent(Common::Input::Event const& event, Common::Input::HardwareState state)
+{
+    std::unique_lock<std::mutex> lock(m_input_mutex);
+    m_pending_input_events.push_back({ event, state });
+}
+
+void EngineCore::Physics::SimulationRecorder::recordTick(float timestep)
+{
+    std::unique_lock<std::mutex> lock(m_recording_mutex);
+
+    if (!m_file.is_open())
+        return;
+
+    std::vector<RecordedInputEvent> input_events;
+    {
+        std::unique_lock<std::mutex> input_lock(m_input_mutex);
+        std::swap(input_events, m_pending_input_events);
+    }
+
+    std::vector<std::vector<float>> state;
+    captureState(m_world, state);
+
+    bool keyframe = (m_chunk_tick_cnt == 0);
+    if (keyframe) {
+        m_chunk_first_tick = static_cast<uint32_t>(m_tick_cnt);
+    }
+
+    writeFloat(m_chunk_data, timestep);
+
+    writeVarint(m_chunk_data, input_events.size());
+    for (auto const& input_event : input_events)
+    {
+        int32_t part = std::get<1>(input_event.event);
+        writeVarint(m_chunk_data, static_cast<uint64_t>(std::get<0>(input_event.event)));
+        writeVarint(m_chunk_data, (static_cast<uint32_t>(part) << 1) ^ static_cast<uint32_t>(part >> 31));
+        writeVarint(m_chunk_data, static_cast<uint64_t>(std::get<2>(input_event.event)));
+        writeFloat(m_chunk_data, input_event.state);
+    }
+
+    for (int stream = 0; stream < STREAM_CNT; ++stream)
+    {
+        size_t element_size = stream_element_sizes[stream];
+        auto const& values = state[stream];
+        size_t element_cnt = values.size() / element_size;
+
+        writeVarint(m_chunk_data, element_cnt);
+
+        if (keyframe)
+        {
+            for (size_t i = 0; i < element_cnt; ++i) {
+                encodeElement(m_chunk_data, values.data() + i * element_size, nullptr, element_size);
+            }
+            continue;
+        }
+
+        auto const& previous_values = m_previous_state[stream];
+        size_t previous_cnt = previous_values.size() / element_size;
+
+        std::vector<size_t> changed;
+        for (size_t i = 0; i < element_cnt; ++i)
+        {
+            if (i >= previous_cnt || std::memcmp(values.data() + i * element_size, previous_values.data() + i * element_size, element_size * sizeof(float)) != 0) {
+                changed.push_back(i);
+            }
+        }
+
+        // changed elements are given by the gap to the previous changed element
+        writeVarint(m_chunk_data, changed.size());
+        size_t next_idx = 0;
+        for (size_t idx : changed)
+        {
+            writeVarint(m_chunk_data, idx - next_idx);
+            next_idx = idx + 1;
+
+            float const* reference = idx < previous_cnt ? previous_values.data() + idx * element_size : nullptr;
+            encodeElement(m_chunk_data, values.data() + idx * element_size, reference, element_size);
+        }
+    }
+
+    m_previous_state = std::move(state);
+    ++m_chunk_tick_cnt;
+    ++m_tick_cnt;
+
+    if (m_chunk_tick_cnt >= m_keyframe_interval) {
+        writeChunk();
+    }
+}
+
+size_t EngineCore::Physics::SimulationRecorder::getTickCount() const
+{
+    std::unique_lock<std::mutex> lock(m_recording_mutex);
+    return m_tick_cnt;
+}
+
+size_t EngineCore::Physics::SimulationRecorder::getByteSize() const
+{
+    std::unique_lock<std::mutex> lock(m_recording_mutex);
+    return m_byte_size;
+}
+
+void EngineCore::Physics::SimulationRecorder::writeChunk()
+{
+    uint64_t file_offset = static_cast<uint64_t>(m_file.tellp());
+
+    writeValue(m_file, m_chunk_first_tick);
+    writeValue(m_file, m_chunk_tick_cnt);
+    writeValue(m_file, static_cast<uint64_t>(m_chunk_data.size()));
+    m_file.write(reinterpret_cast<char const*>(m_chunk_data.data()), m_chunk_data.size());
+
+    m_chunks.push_back({ m_chunk_first_tick, m_chunk_tick_cnt, file_offset });
+    m_byte_size = static_cast<size_t>(m_file.tellp());
+
+    m_chunk_tick_cnt = 0;
+    m_chunk_data.clear();
+}
+
+EngineCore::Physics::SimulationReplay::SimulationReplay(WorldState& world)
+    : m_world(world),
+    m_chunk_idx(std::numeric_limits<size_t>::max()),
+    m_chunk_read_offset(0),
+    m_tick_cnt(0),
+    m_current_tick(std::numeric_limits<size_t>::max()),
+    m_timestep(0.0f)
+{
+}
+
+bool EngineCore::Physics::SimulationReplay::open(std::string const& path)
+{
+    m_file.close();
+    m_file.clear();
+    m_chunks.clear();
+    m_chunk_idx = std::numeric_limits<size_t>::max();
+    m_chunk_data.clear();
+    m_tick_cnt = 0;
+    m_current_tick = std::numeric_limits<size_t>::max();
+    m_state.assign(STREAM_CNT, {});
+    m_applied_state.assign(STREAM_CNT, {});
+
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open())
+        return false;
+
+    char magic[4];
+    uint32_t version, keyframe_interval;
+    if (!m_file.read(magic, 4) || std::memcmp(magic, recording_file_magic, 4) != 0)
+        return false;
+    if (!readValue(m_file, version) || version != recording_file_version || !readValue(m_file, keyframe_interval))
+        return false;
+
+    // the chunk table is only written when a recording ends
+    uint64_t chunk_cnt, table_offset;
+    m_file.seekg(-static_cast<std::streamoff>(2 * sizeof(uint64_t) + 4), std::ios::end);
+    if (!readValue(m_file, chunk_cnt) || !readValue(m_file, table_offset))
+        return false;
+    if (!m_file.read(magic, 4) || std::memcmp(magic, recording_file_magic, 4) != 0)
+        return false;
+
+    m_file.seekg(static_cast<std::streamoff>(table_offset));
+    m_chunks.resize(static_cast<size_t>(chunk_cnt));
+    for (auto& chunk : m_chunks)
+    {
+        if (!readValue(m_file, chunk.first_tick) || !readValue(m_file, chunk.tick_cnt) || !readValue(m_file, chunk.file_offset))
+            return false;
+    }
+
+    m_tick_cnt = m_chunks.empty() ? 0 : m_chunks.back().first_tick + m_chunks.back().tick_cnt;
+
+    return true;
+}
+
+size_t EngineCore::Physics::SimulationReplay::getTickCount() const
+{
+    return m_tick_cnt;
+}
+
+size_t EngineCore::Physics::SimulationReplay::getCurrentTick() const
+{
+    return m_current_tick;
+}
+
+bool EngineCore::Physics::SimulationReplay::seek(size_t tick, bool apply_state)
+{
+    if (tick >= m_tick_cnt)
+        return false;
+
+    auto chunk = std::upper_bound(m_chunks.begin(), m_chunks.end(), tick,
+        [](size_t t, ChunkInfo const& c) { return t < c.first_tick; }) - 1;
+    size_t chunk_idx = static_cast<size_t>(chunk - m_chunks.begin());
+
+    // continue decoding if the tick lies ahead in the current chunk, otherwise restart at the keyframe
+    bool continue_chunk = chunk_idx == m_chunk_idx && m_current_tick != std::numeric_limits<size_t>::max() && m_current_tick <= tick;
+    if (!continue_chunk && !loadChunk(chunk_idx))
+        return false;
+
+    while (m_current_tick != tick)
+    {
+        if (!decodeTick())
+            return false;
+    }
+
+    // the world may have been changed since the last applied tick, e.g. by re-simulation
+    if (apply_state) {
+        applyState(true);
+    }
+
+    return true;
+}
+
+bool EngineCore::Physics::SimulationReplay::step(bool apply_state)
+{
+    size_t next_tick = m_current_tick == std::numeric_limits<size_t>::max() ? 0 : m_current_tick + 1;
+    if (next_tick >= m_tick_cnt)
+        return false;
+
+    if (m_chunk_idx >= m_chunks.size() || next_tick >= m_chunks[m_chunk_idx].first_tick + m_chunks[m_chunk_idx].tick_cnt)
+    {
+        size_t chunk_idx = m_chunk_idx >= m_chunks.size() ? 0 : m_chunk_idx + 1;
+        if (!loadChunk(chunk_idx))
+            return false;
+    }
+
+    if (!decodeTick())
+        return false;
+
+    if (apply_state) {
+        applyState(false);
+    }
+
+    return true;
+}
+
+float EngineCore::Physics::SimulationReplay::getTimestep() const
+{
+    return m_timestep;
+}
+
+std::vector<EngineCore::Physics::RecordedInputEvent> const& EngineCore::Physics::SimulationReplay::getInputEvents() const
+{
+    return m_input_events;
+}
+
+float EngineCore::Physics::SimulationReplay::computeMaxPositionError() const
+{
+    if (!m_world.has<Common::TransformComponentManager>() || m_state.empty())
+        return 0.0f;
+
+    auto const& transform_mngr = m_world.get<Common::TransformComponentManager>();
+    auto const& transforms = m_state[TRANSFORM_STREAM];
+
+    size_t cnt = std::min(transforms.size() / stream_element_sizes[TRANSFORM_STREAM], transform_mngr.getComponentCount());
+
+    float max_error = 0.0f;
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        float const* element = transforms.data() + i * stream_element_sizes[TRANSFORM_STREAM];
+        max_error = std::max(max_error, glm::length(transform_mngr.getPosition(i) - Vec3(element[0], element[1], element[2])));
+    }
+
+    return max_error;
+}
+
+bool EngineCore::Physics::SimulationReplay::loadChunk(size_t chunk_idx)
+{
+    if (chunk_idx >= m_chunks.size())
+        return false;
+
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_chunks[chunk_idx].file_offset));
+
+    uint32_t first_tick, tick_cnt;
+    uint64_t byte_cnt;
+    if (!readValue(m_file, first_tick) || !readValue(m_file, tick_cnt) || !readValue(m_file, byte_cnt))
+        return false;
+
+    m_chunk_data.resize(static_cast<size_t>(byte_cnt));
+    if (!m_file.read(reinterpret_cast<char*>(m_chunk_data.data()), byte_cnt))
+        return false;
+
+    m_chunk_idx = chunk_idx;
+    m_chunk_read_offset = 0;
+
+    // the next decoded tick is the keyframe
+    m_current_tick = first_tick == 0 ? std::numeric_limits<size_t>::max() : first_tick - 1;
+
+    return true;
+}
+
+bool EngineCore::Physics::SimulationReplay::decodeTick()
+{
+    bool keyframe = (m_chunk_read_offset == 0);
+    size_t& offset = m_chunk_read_offset;
+
+    if (!readFloat(m_chunk_data, offset, m_timestep))
+        return false;
+
+    uint64_t event_cnt;
+    if (!readVarint(m_chunk_data, offset, event_cnt))
+        return false;
+
+    m_input_events.clear();
+    for (uint64_t i = 0; i < event_cnt; ++i)
+    {
+        uint64_t device, zigzag_part, trigger;
+        float state;
+        if (!readVarint(m_chunk_data, offset, device) || !readVarint(m_chunk_data, offset, zigzag_part) || !readVarint(m_chunk_data, offset, trigger) || !readFloat(m_chunk_data, offset, state))
+            return false;
+
+        int32_t part = static_cast<int32_t>(static_cast<uint32_t>(zigzag_part >> 1) ^ (0u - static_cast<uint32_t>(zigzag_part & 1)));
+        m_input_events.push_back({
+            Common::Input::Event(static_cast<Common::Input::Device>(device), part, static_cast<Common::Input::EventTrigger>(trigger)),
+            state });
+    }
+
+    for (int stream = 0; stream < STREAM_CNT; ++stream)
+    {
+        size_t element_size = stream_element_sizes[stream];
+        auto& values = m_state[stream];
+
+        uint64_t element_cnt;
+        if (!readVarint(m_chunk_data, offset, element_cnt))
+            return false;
+
+        if (keyframe)
+        {
+            values.resize(static_cast<size_t>(element_cnt) * element_size);
+            for (size_t i = 0; i < element_cnt; ++i)
+            {
+                if (!decodeElement(m_chunk_data, offset, values.data() + i * element_size, nullptr, element_size))
+                    return false;
+            }
+            continue;
+        }
+
+        size_t previous_cnt = values.size() / element_size;
+        values.resize(static_cast<size_t>(element_cnt) * element_size);
+
+        uint64_t changed_cnt;
+        if (!readVarint(m_chunk_data, offset, changed_cnt))
+            return false;
+
+        size_t next_idx = 0;
+        for (uint64_t c = 0; c < changed_cnt; ++c)
+        {
+            uint64_t gap;
+            if (!readVarint(m_chunk_data, offset, gap))
+                return false;
+
+            size_t idx = next_idx + static_cast<size_t>(gap);
+            if (idx >= element_cnt)
+                return false;
+            next_idx = idx + 1;
+
+            float* element = values.data() + idx * element_size;
+            if (!decodeElement(m_chunk_data, offset, element, idx < previous_cnt ? element : nullptr, element_size))
+                return false;
+        }
+    }
+
+    m_current_tick = m_current_tick == std::numeric_limits<size_t>::max() ? 0 : m_current_tick + 1;
+
+    return true;
+}
+
+void EngineCore::Physics::SimulationReplay::applyState(bool force_all)
+{
+    if (m_world.has<Common::TransformComponentManager>())
+    {
+        auto& transform_mngr = m_world.get<Common::TransformComponentManager>();
+        auto const& transforms = m_state[TRANSFORM_STREAM];
+        auto const& applied_transforms = m_applied_state[TRANSFORM_STREAM];
+
+        size_t element_size = stream_element_sizes[TRANSFORM_STREAM];
+        size_t cnt = std::min(transforms.size() / element_size, transform_mngr.getComponentCount());
+        size_t applied_cnt = applied_transforms.size() / element_size;
+
+        std::vector<size_t> indices;
+        std::vector<Vec3>   positions;
+        std::vector<Quat>   orientations;
+        std::vector<Vec3>   scales;
+
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            float const* element = transforms.data() + i * element_size;
+
+            if (!force_all && i < applied_cnt && std::memcmp(element, applied_transforms.data() + i * element_size, element_size * sizeof(float)) == 0)
+                continue;
+
+            indices.push_back(i);
+            positions.push_back(Vec3(element[0], element[1], element[2]));
+            orientations.push_back(Quat(element[6], element[3], element[4], element[5]));
+            scales.push_back(Vec3(element[7], element[8], element[9]));
+        }
+
+        if (!indices.empty()) {
+            transform_mngr.setLocalTransforms(indices, positions, orientations, scales);
+        }
+    }
+
+    if (m_world.has<AirplanePhysicsComponentManager>())
+    {
+        auto const& airplanes = m_state[AIRPLANE_STREAM];
+
+        std::vector<AirplaneState> airplane_states(airplanes.size() / stream_element_sizes[AIRPLANE_STREAM]);
+        std::memcpy(static_cast<void*>(airplane_states.data()), airplanes.data(), airplane_states.size() * sizeof(AirplaneState));
+
+        m_world.get<AirplanePhysicsComponentManager>().setStates(airplane_states);
+    }
+
+    m_applied_state = m_state;
+}
@@ -0,0 +1,216 @@
+#ifndef SimulationRecording_hpp
+#define SimulationRecording_hpp
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "InputEvent.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    class WorldState;
+
+    namespace Physics
+    {
+        struct RecordedInputEvent
+        {
+            Common::Input::Event         event;
+            Common::Input::HardwareState state;
+        };
+
+        /**
+        * Recordings are binary files of chunks of consecutive ticks, followed by a table of all chunks for seeking.
+        * The first tick of every chunk is a keyframe that stores the complete state, all other ticks only store the
+        * components that changed since the previous tick. Changed values are XOR coded against their previous value
+        * and leading zero bytes are dropped, which compresses the small per tick changes of simulated values.
+        *
+        * A tick holds the simulation timestep, the input events received since the previous tick and the state of
+        * all components of the TransformComponentManager and AirplanePhysicsComponentManager (if added to the
+        * world) after the step. Components are identified by their index, recordings can only be replayed into a
+        * world that was set up the same way, e.g. by loading the same level.
+        */
+
+        /**
+        * \class SimulationRecorder
+        *
+        * \brief Writes a recording of a running simulation. Add recordTick as the last simulation of the
+        * PhysicsSystem to record each fixed step and forward input events with recordInputEvent.
+        */
+        class SimulationRecorder
+        {
+        public:
+            SimulationRecorder(WorldState& world, uint keyframe_interval = 120);
+            ~SimulationRecorder();
+
+            SimulationRecorder(SimulationRecorder const& cpy) = delete;
+            SimulationRecorder& operator=(SimulationRecorder const& rhs) = delete;
+
+            /**
+            * \brief Start a new recording, a running recording is finished first
+            * \return Returns false if the file couldn't be opened
+            */
+            bool begin(std::string const& path);
+
+            /**
+            * \brief Write the remaining ticks and the chunk table and close the file
+            * \return Returns false if no recording was running or writing failed
+            */
+            bool end();
+
+            bool isRecording() const;
+
+            /**
+            * \brief Remember an input event for the next tick. Thread-safe.
+            */
+            void recordInputEvent(Common::Input::Event const& event, Common::Input::HardwareState state);
+
+            /**
+            * \brief Capture the current state of the world after a simulation step with the given timestep
+            */
+            void recordTick(float timestep);
+
+            /**
+            * \brief Number of ticks recorded since begin
+            */
+            size_t getTickCount() const;
+
+            /**
+            * \brief Bytes written to the file since begin, not counting the current chunk
+            */
+            size_t getByteSize() const;
+
+        private:
+            void writeChunk();
+
+            WorldState& m_world;
+            uint        m_keyframe_interval;
+
+            std::ofstream m_file;
+
+            struct ChunkInfo
+            {
+                uint32_t first_tick;
+                uint32_t tick_cnt;
+                uint64_t file_offset;
+            };
+
+            std::vector<ChunkInfo> m_chunks;
+
+            uint32_t             m_chunk_first_tick;
+            uint32_t             m_chunk_tick_cnt;
+            std::vector<uint8_t> m_chunk_data;
+
+            /** Per stream state of the previous tick */
+            std::vector<std::vector<float>> m_previous_state;
+
+            std::vector<RecordedInputEvent> m_pending_input_events;
+
+            size_t m_tick_cnt;
+            size_t m_byte_size;
+
+            mutable std::mutex m_input_mutex;
+            mutable std::mutex m_recording_mutex;
+        };
+
+        /**
+        * \class SimulationReplay
+        *
+        * \brief Plays back a recording by writing the recorded state into the world.
+        *
+        * For deterministic re-simulation, seek to a tick, set the task scheduler of the simulations to fixed order
+        * mode and step without applying the recorded state. Feed the recorded input events and timestep to the
+        * simulations and compare the result with computeMaxPositionError.
+        */
+        class SimulationReplay
+        {
+        public:
+            SimulationReplay(WorldState& world);
+            ~SimulationReplay() = default;
+
+            SimulationReplay(SimulationReplay const& cpy) = delete;
+            SimulationReplay& operator=(SimulationReplay const& rhs) = delete;
+
+            /**
+            * \brief Read the chunk table of a recording
+            * \return Returns false if the file is missing, incomplete or of an unsupported version
+            */
+            bool open(std::string const& path);
+
+            size_t getTickCount() const;
+
+            /**
+            * \brief Index of the tick that was decoded last
+            */
+            size_t getCurrentTick() const;
+
+            /**
+            * \brief Decode the given tick, starting from the closest keyframe before it
+            * \param apply_state Write the state of the tick into the world
+            * \return Returns false if the tick is out of range or the file couldn't be read
+            */
+            bool seek(size_t tick, bool apply_state = true);
+
+            /**
+            * \brief Decode the next tick, only components that changed since the last applied tick are written
+            */
+            bool step(bool apply_state = true);
+
+            /**
+            * \brief Timestep of the current tick
+            */
+            float getTimestep() const;
+
+            /**
+            * \brief Input events that were received before the current tick
+            */
+            std::vector<RecordedInputEvent> const& getInputEvents() const;
+
+            /**
+            * \brief Largest distance between the recorded and the current position of all transform components
+            */
+            float computeMaxPositionError() const;
+
+        private:
+            bool loadChunk(size_t chunk_idx);
+
+            bool decodeTick();
+
+            void applyState(bool force_all);
+
+            WorldState& m_world;
+
+            std::ifstream m_file;
+
+            struct ChunkInfo
+            {
+                uint32_t first_tick;
+                uint32_t tick_cnt;
+                uint64_t file_offset;
+            };
+
+            std::vector<ChunkInfo> m_chunks;
+
+            size_t               m_chunk_idx;
+            std::vector<uint8_t> m_chunk_data;
+            size_t               m_chunk_read_offset;
+
+            size_t m_tick_cnt;
+            size_t m_current_tick;
+
+            float                           m_timestep;
+            std::vector<RecordedInputEvent> m_input_events;
+
+            /** Per stream state of the current tick */
+            std::vector<std::vector<float>> m_state;
+
+            /** Per stream state that was last written to the world */
+            std::vector<std::vector<float>> m_applied_state;
+        };
+    }
+}
+
+#endif // !SimulationRecording_hpp
@@ -1,5 +1,79 @@
 #include "SkinComponentManager.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKIN_COMPONENT_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "TransformComponentManager.hpp"
+
+namespace
+{
+    /** Column-major 4x4 matrix product a * b */
+    inline void multiply(Mat4x4 const& a, Mat4x4 const& b, Mat4x4& result)
+    {
+#ifdef SKIN_COMPONENT_SSE2
+        float const* a_ptr = &a[0][0];
+        float const* b_ptr = &b[0][0];
+        float* result_ptr = &result[0][0];
+
+        __m128 a0 = _mm_loadu_ps(a_ptr);
+        __m128 a1 = _mm_loadu_ps(a_ptr + 4);
+        __m128 a2 = _mm_loadu_ps(a_ptr + 8);
+        __m128 a3 = _mm_loadu_ps(a_ptr + 12);
+
+        for (int col = 0; col < 4; ++col)
+        {
+            float const* b_col = b_ptr + col * 4;
+            __m128 r = _mm_mul_ps(a0, _mm_set1_ps(b_col[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b_col[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b_col[2])));
+            r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b_col[3])));
+            _mm_storeu_ps(result_ptr + col * 4, r);
+        }
+#else
+        result = a * b;
+#endif
+    }
+
+    /** Component-wise a + (b - a) * t */
+    inline void lerp(Mat4x4 const& a, Mat4x4 const& b, float t, Mat4x4& result)
+    {
+#ifdef SKIN_COMPONENT_SSE2
+        float const* a_ptr = &a[0][0];
+        float const* b_ptr = &b[0][0];
+        float* result_ptr = &result[0][0];
+
+        __m128 t_v = _mm_set1_ps(t);
+
+        for (int col = 0; col < 4; ++col)
+        {
+            __m128 a_col = _mm_loadu_ps(a_ptr + col * 4);
+            __m128 b_col = _mm_loadu_ps(b_ptr + col * 4);
+            _mm_storeu_ps(result_ptr + col * 4, _mm_add_ps(a_col, _mm_mul_ps(_mm_sub_ps(b_col, a_col), t_v)));
+        }
+#else
+        result = a + (b - a) * t;
+#endif
+    }
+}
+
+EngineCore::Animation::SkinComponentManager::SkinComponentManager()
+    : m_joint_palette_size(0), m_palette_tasks_enabled(false), m_lod_tiers({ { 0.0f, 1 } })
+{
+    m_lod_stats.evaluated_joint_cnt = 0;
+}
+
+EngineCore::Animation::SkinComponentManager::~SkinComponentManager()
+{
+    if (m_palette_tasks_enabled) {
+        m_palette_task_scheduler.stop();
+    }
+}
+
 void EngineCore::Animation::SkinComponentManager::addComponent(Entity entity, std::vector<Entity> const& joints, std::vector<Mat4x4> const& inverse_bind_matrices)
 {
     std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
@@ -8,7 +82,9 @@ void EngineCore::Animation::SkinComponentManager::addComponent(Entity entity, st
 
     addIndex(entity.id(), idx);
 
-    m_data.push_back(Data(entity, joints, inverse_bind_matrices));
+    m_data.push_back(Data(entity, joints, inverse_bind_matrices, m_joint_palette_size));
+
+    m_joint_palette_size += joints.size();
 }
 
 std::vector<Entity> const& EngineCore::Animation::SkinComponentManager::getJoints(Entity entity)
@@ -34,3 +110,441 @@ std::vector<Mat4x4> const& EngineCore::Animation::SkinComponentManager::getInvse
     std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
     return m_data[component_idx].inverse_bind_matrices;
 }
+
+void EngineCore::Animation::SkinComponentManager::setJointPaletteWorkerThreads(int worker_thread_cnt)
+{
+    if (m_palette_tasks_enabled) {
+        m_palette_task_scheduler.stop();
+    }
+
+    m_palette_tasks_enabled = worker_thread_cnt > 0;
+
+    if (m_palette_tasks_enabled) {
+        m_palette_task_scheduler.run(worker_thread_cnt);
+    }
+}
+
+size_t EngineCore::Animation::SkinComponentManager::getJointPaletteSize()
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_joint_palette_size;
+}
+
+size_t EngineCore::Animation::SkinComponentManager::getJointPaletteOffset(Entity entity)
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_data[getIndex(entity.id())].palette_offset;
+}
+
+void EngineCore::Animation::SkinComponentManager::setAnimationLodTiers(std::vector<AnimationLodTier> const& tiers)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    m_lod_tiers = tiers.empty() ? std::vector<AnimationLodTier>({ { 0.0f, 1 } }) : tiers;
+
+    // remaps are resolved per tier
+    for (auto& skin : m_data) {
+        skin.joint_remaps.clear();
+    }
+}
+
+void EngineCore::Animation::SkinComponentManager::setJointLodLevels(Entity entity, std::vector<uint32_t> const& joint_lod_levels)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto& skin = m_data[getIndex(entity.id())];
+
+    assert(joint_lod_levels.empty() || joint_lod_levels.size() == skin.joints.size());
+
+    skin.joint_lod_levels = joint_lod_levels;
+    skin.joint_remaps.clear();
+}
+
+EngineCore::Animation::AnimationLodStats EngineCore::Animation::SkinComponentManager::getAnimationLodStats()
+{
+    std::unique_lock<std::mutex> lock(m_lod_stats_mutex);
+    return m_lod_stats;
+}
+
+void EngineCore::Animation::SkinComponentManager::updateJointPalettes(
+    Common::TransformComponentManager const& transform_mngr,
+    Vec3 const& camera_position,
+    std::vector<Mat4x4>& joint_palette)
+{
+    // exclusive, the tasks update the cached indices, remaps and interpolation state of the skins.
+    // Each skin is processed by a single task, so the tasks don't need to lock themselves.
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    joint_palette.resize(m_joint_palette_size);
+
+    {
+        std::unique_lock<std::mutex> stats_lock(m_lod_stats_mutex);
+        m_lod_stats.skin_cnt.assign(m_lod_tiers.size(), 0);
+        m_lod_stats.evaluated_skin_cnt.assign(m_lod_tiers.size(), 0);
+        m_lod_stats.evaluated_joint_cnt = 0;
+    }
+
+    if (!m_palette_tasks_enabled)
+    {
+        computeJointPalettes(0, m_data.size(), transform_mngr, camera_position, joint_palette);
+        return;
+    }
+
+    size_t const skins_per_task = 64;
+
+    for (size_t first = 0; first < m_data.size(); first += skins_per_task)
+    {
+        size_t last = std::min(first + skins_per_task, m_data.size());
+
+        m_palette_task_scheduler.submitTask(
+            [this, first, last, &transform_mngr, &camera_position, &joint_palette]() {
+                computeJointPalettes(first, last, transform_mngr, camera_position, joint_palette);
+            }
+        );
+    }
+
+    m_palette_task_scheduler.waitWhileBusy();
+}
+
+void EngineCore::Animation::SkinComponentManager::computeJointPalettes(
+    size_t first,
+    size_t last,
+    Common::TransformComponentManager const& transform_mngr,
+    Vec3 const& camera_position,
+    std::vector<Mat4x4>& joint_palette)
+{
+    size_t tier_cnt = m_lod_tiers.size();
+
+    std::vector<size_t> skin_cnt(tier_cnt, 0);
+    std::vector<size_t> evaluated_skin_cnt(tier_cnt, 0);
+    size_t              evaluated_joint_cnt = 0;
+
+    for (size_t i = first; i < last; ++i)
+    {
+        auto& skin = m_data[i];
+
+        size_t tier = selectLodTier(skin, transform_mngr, camera_position);
+
+        ++skin_cnt[tier];
+
+        Mat4x4* output = joint_palette.data() + skin.palette_offset;
+        uint32_t update_interval = std::max(1u, m_lod_tiers[tier].update_interval);
+
+        if (update_interval == 1)
+        {
+            evaluated_joint_cnt += computeJointPalette(skin, tier, transform_mngr, output);
+            ++evaluated_skin_cnt[tier];
+
+            // restart interpolation when moving to a reduced rate tier again
+            skin.current_palette.clear();
+            continue;
+        }
+
+        bool has_palette = skin.current_palette.size() == skin.joints.size();
+
+        if (!has_palette || ++skin.frames_since_update >= update_interval)
+        {
+            std::swap(skin.previous_palette, skin.current_palette);
+            skin.current_palette.resize(skin.joints.size());
+
+            evaluated_joint_cnt += computeJointPalette(skin, tier, transform_mngr, skin.current_palette.data());
+            ++evaluated_skin_cnt[tier];
+
+            if (!has_palette)
+            {
+                // stagger the updates of skins that enter the tier at the same time
+                skin.previous_palette = skin.current_palette;
+                skin.frames_since_update = static_cast<uint32_t>(i % update_interval);
+            }
+            else
+            {
+                skin.frames_since_update = 0;
+            }
+        }
+
+        // interpolate between the last two evaluations, i.e. the output lags by one update interval
+        float t = static_cast<float>(skin.frames_since_update) / static_cast<float>(update_interval);
+
+        for (size_t joint = 0; joint < skin.joints.size(); ++joint) {
+            lerp(skin.previous_palette[joint], skin.current_palette[joint], t, output[joint]);
+        }
+    }
+
+    std::unique_lock<std::mutex> stats_lock(m_lod_stats_mutex);
+    for (size_t tier = 0; tier < tier_cnt; ++tier)
+    {
+        m_lod_stats.skin_cnt[tier] += skin_cnt[tier];
+        m_lod_stats.evaluated_skin_cnt[tier] += evaluated_skin_cnt[tier];
+    }
+    m_lod_stats.evaluated_joint_cnt += evaluated_joint_cnt;
+}
+
+void EngineCore::Animation::SkinComponentManager::updateJointPaletteSlots(
+    Common::TransformComponentManager const& transform_mngr,
+    Vec3 const& camera_position,
+    size_t frame_id)
+{
+    // exclusive, the tasks update the cached indices, remaps and slots of the skins
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    {
+        std::unique_lock<std::mutex> stats_lock(m_lod_stats_mutex);
+        m_lod_stats.skin_cnt.assign(m_lod_tiers.size(), 0);
+        m_lod_stats.evaluated_skin_cnt.assign(m_lod_tiers.size(), 0);
+        m_lod_stats.evaluated_joint_cnt = 0;
+
+        m_slot_writes.joint_matrices.clear();
+        m_slot_writes.ranges.clear();
+    }
+
+    if (!m_palette_tasks_enabled)
+    {
+        computeJointPaletteSlots(0, m_data.size(), transform_mngr, camera_position);
+    }
+    else
+    {
+        size_t const skins_per_task = 64;
+
+        for (size_t first = 0; first < m_data.size(); first += skins_per_task)
+        {
+            size_t last = std::min(first + skins_per_task, m_data.size());
+
+            m_palette_task_scheduler.submitTask(
+                [this, first, last, &transform_mngr, &camera_position]() {
+                    computeJointPaletteSlots(first, last, transform_mngr, camera_position);
+                }
+            );
+        }
+
+        m_palette_task_scheduler.waitWhileBusy();
+    }
+
+    std::unique_lock<std::mutex> pending_lock(m_pending_slot_writes_mutex);
+    m_pending_slot_writes.push_back({ frame_id, std::move(m_slot_writes) });
+    m_slot_writes = JointPaletteWrites();
+}
+
+void EngineCore::Animation::SkinComponentManager::takeJointPaletteWrites(size_t frame_id, JointPaletteWrites& writes)
+{
+    writes.joint_matrices.clear();
+    writes.ranges.clear();
+
+    std::unique_lock<std::mutex> lock(m_pending_slot_writes_mutex);
+
+    while (!m_pending_slot_writes.empty() && m_pending_slot_writes.front().first <= frame_id)
+    {
+        auto const& frame_writes = m_pending_slot_writes.front().second;
+
+        writes.joint_matrices.insert(writes.joint_matrices.end(), frame_writes.joint_matrices.begin(), frame_writes.joint_matrices.end());
+        writes.ranges.insert(writes.ranges.end(), frame_writes.ranges.begin(), frame_writes.ranges.end());
+
+        m_pending_slot_writes.pop_front();
+    }
+}
+
+EngineCore::Animation::JointPaletteBlend EngineCore::Animation::SkinComponentManager::getJointPaletteBlend(Entity entity)
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    auto const& skin = m_data[getIndex(entity.id())];
+
+    // not evaluated yet, sample the empty first slot
+    if (skin.current_slot == JOINT_PALETTE_SLOT_CNT)
+        return { computeSlotOffset(skin, 0), computeSlotOffset(skin, 0), 1.0f };
+
+    return { computeSlotOffset(skin, skin.previous_slot), computeSlotOffset(skin, skin.current_slot), skin.slot_blend };
+}
+
+void EngineCore::Animation::SkinComponentManager::computeJointPaletteSlots(
+    size_t first,
+    size_t last,
+    Common::TransformComponentManager const& transform_mngr,
+    Vec3 const& camera_position)
+{
+    size_t tier_cnt = m_lod_tiers.size();
+
+    std::vector<size_t> skin_cnt(tier_cnt, 0);
+    std::vector<size_t> evaluated_skin_cnt(tier_cnt, 0);
+    size_t              evaluated_joint_cnt = 0;
+
+    JointPaletteWrites writes;
+
+    for (size_t i = first; i < last; ++i)
+    {
+        auto& skin = m_data[i];
+
+        size_t tier = selectLodTier(skin, transform_mngr, camera_position);
+
+        ++skin_cnt[tier];
+
+        uint32_t update_interval = std::max(1u, m_lod_tiers[tier].update_interval);
+        bool has_slots = skin.current_slot != JOINT_PALETTE_SLOT_CNT;
+
+        if (!has_slots || update_interval == 1 || ++skin.slot_frames_since_update >= update_interval)
+        {
+            // the new slot is neither of the two slots sampled by the previous frame
+            uint32_t slot = 0;
+            if (has_slots)
+            {
+                slot = skin.current_slot == skin.previous_slot
+                    ? (skin.current_slot + 1) % JOINT_PALETTE_SLOT_CNT
+                    : JOINT_PALETTE_SLOT_CNT - skin.current_slot - skin.previous_slot;
+            }
+
+            size_t matrix_offset = writes.joint_matrices.size();
+            writes.joint_matrices.resize(matrix_offset + skin.joints.size());
+            writes.ranges.push_back({ computeSlotOffset(skin, slot), skin.joints.size() });
+
+            evaluated_joint_cnt += computeJointPalette(skin, tier, transform_mngr, writes.joint_matrices.data() + matrix_offset);
+            ++evaluated_skin_cnt[tier];
+
+            skin.previous_slot = has_slots ? skin.current_slot : slot;
+            skin.current_slot = slot;
+
+            // stagger the updates of skins that enter a reduced rate tier at the same time
+            skin.slot_frames_since_update = (!has_slots && update_interval > 1) ? static_cast<uint32_t>(i % update_interval) : 0;
+        }
+
+        // interpolate between the last two evaluations, i.e. the output lags by one update interval
+        skin.slot_blend = update_interval == 1
+            ? 1.0f
+            : static_cast<float>(skin.slot_frames_since_update) / static_cast<float>(update_interval);
+    }
+
+    std::unique_lock<std::mutex> stats_lock(m_lod_stats_mutex);
+    for (size_t tier = 0; tier < tier_cnt; ++tier)
+    {
+        m_lod_stats.skin_cnt[tier] += skin_cnt[tier];
+        m_lod_stats.evaluated_skin_cnt[tier] += evaluated_skin_cnt[tier];
+    }
+    m_lod_stats.evaluated_joint_cnt += evaluated_joint_cnt;
+
+    m_slot_writes.joint_matrices.insert(m_slot_writes.joint_matrices.end(), writes.joint_matrices.begin(), writes.joint_matrices.end());
+    m_slot_writes.ranges.insert(m_slot_writes.ranges.end(), writes.ranges.begin(), writes.ranges.end());
+}
+
+size_t EngineCore::Animation::SkinComponentManager::computeSlotOffset(Data const& skin, uint32_t slot)
+{
+    return JOINT_PALETTE_SLOT_CNT * skin.palette_offset + slot * skin.joints.size();
+}
+
+size_t EngineCore::Animation::SkinComponentManager::selectLodTier(
+    Data& skin,
+    Common::TransformComponentManager const& transform_mngr,
+    Vec3 const& camera_position)
+{
+    size_t tier_cnt = m_lod_tiers.size();
+
+    if (skin.joint_transform_indices.size() != skin.joints.size())
+    {
+        skin.transform_index = transform_mngr.getIndex(skin.entity);
+
+        skin.joint_transform_indices.resize(skin.joints.size());
+        for (size_t joint = 0; joint < skin.joints.size(); ++joint) {
+            skin.joint_transform_indices[joint] = transform_mngr.getIndex(skin.joints[joint]);
+        }
+    }
+
+    if (!skin.joint_lod_levels.empty() && skin.joint_remaps.size() != tier_cnt) {
+        computeJointRemaps(skin, transform_mngr);
+    }
+
+    // select tier by camera distance
+    Mat4x4 const& skin_transform = transform_mngr.getWorldTransformation(skin.transform_index);
+    Vec3 skin_position(skin_transform[3][0], skin_transform[3][1], skin_transform[3][2]);
+    float distance = glm::length(skin_position - camera_position);
+
+    size_t tier = 0;
+    while (tier + 1 < tier_cnt && distance >= m_lod_tiers[tier + 1].min_distance) {
+        ++tier;
+    }
+
+    return tier;
+}
+
+size_t EngineCore::Animation::SkinComponentManager::computeJointPalette(
+    Data const& skin,
+    size_t tier,
+    Common::TransformComponentManager const& transform_mngr,
+    Mat4x4* joint_palette)
+{
+    std::vector<uint32_t> const* remap = skin.joint_remaps.empty() ? nullptr : &skin.joint_remaps[tier];
+
+    Mat4x4 inverse_transform = glm::inverse(transform_mngr.getWorldTransformation(skin.transform_index));
+
+    size_t evaluated_joint_cnt = 0;
+
+    for (size_t joint = 0; joint < skin.joints.size(); ++joint)
+    {
+        if (remap != nullptr && (*remap)[joint] != joint)
+            continue;
+
+        Mat4x4 joint_transform;
+        multiply(inverse_transform, transform_mngr.getWorldTransformation(skin.joint_transform_indices[joint]), joint_transform);
+        multiply(joint_transform, skin.inverse_bind_matrices[joint], joint_palette[joint]);
+
+        ++evaluated_joint_cnt;
+    }
+
+    if (remap != nullptr)
+    {
+        for (size_t joint = 0; joint < skin.joints.size(); ++joint)
+        {
+            if ((*remap)[joint] != joint) {
+                joint_palette[joint] = joint_palette[(*remap)[joint]];
+            }
+        }
+    }
+
+    return evaluated_joint_cnt;
+}
+
+void EngineCore::Animation::SkinComponentManager::computeJointRemaps(Data& skin, Common::TransformComponentManager const& transform_mngr)
+{
+    size_t tier_cnt = m_lod_tiers.size();
+    size_t joint_cnt = skin.joints.size();
+
+    std::unordered_map<uint, uint32_t> joint_indices;
+    for (size_t joint = 0; joint < joint_cnt; ++joint) {
+        joint_indices[skin.joints[joint].id()] = static_cast<uint32_t>(joint);
+    }
+
+    skin.joint_remaps.assign(tier_cnt, std::vector<uint32_t>(joint_cnt));
+
+    std::vector<uint32_t> ancestors;
+
+    for (size_t joint = 0; joint < joint_cnt; ++joint)
+    {
+        // ancestor joints of the skin, closest first
+        ancestors.clear();
+        Entity parent = transform_mngr.getParent(skin.joint_transform_indices[joint]);
+        while (parent != Entity())
+        {
+            auto query = joint_indices.find(parent.id());
+            if (query != joint_indices.end()) {
+                ancestors.push_back(query->second);
+            }
+            parent = transform_mngr.getParent(transform_mngr.getIndex(parent));
+        }
+
+        for (size_t tier = 0; tier < tier_cnt; ++tier)
+        {
+            uint32_t target = static_cast<uint32_t>(joint);
+
+            if (skin.joint_lod_levels[joint] < tier)
+            {
+                // without an evaluated ancestor the joint stays evaluated
+                for (uint32_t ancestor : ancestors)
+                {
+                    if (skin.joint_lod_levels[ancestor] >= tier)
+                    {
+                        target = ancestor;
+                        break;
+                    }
+                }
+            }
+
+            skin.joint_remaps[tier][joint] = target;
+        }
+    }
+}
@@ -1,14 +1,22 @@
 #ifndef SkinComponentManager_hpp
 #define SkinComponentManager_hpp
 
+#include <deque>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "BaseSingleInstanceComponentManager.hpp"
 #include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
 #include "types.hpp"
 
 namespace EngineCore {
 
+    namespace Common {
+        class TransformComponentManager;
+    }
+
     namespace Graphics {
         namespace RenderTaskTags {
             struct SkinnedMesh {};
@@ -16,26 +24,128 @@ namespace EngineCore {
     }
 
     namespace Animation {
+
+        /**
+         * \brief Animation level of detail tier, selected by the distance of a skinned entity to the camera
+         */
+        struct AnimationLodTier
+        {
+            float    min_distance;    ///< Tier is used from this camera distance on
+            uint32_t update_interval; ///< Joint matrices are recomputed every n-th frame and interpolated in between
+        };
+
+        struct AnimationLodStats
+        {
+            std::vector<size_t> skin_cnt;           ///< Number of skins per tier
+            std::vector<size_t> evaluated_skin_cnt; ///< Number of skins per tier whose joint matrices were recomputed
+            size_t              evaluated_joint_cnt;
+        };
+
+        /**
+         * \brief Joint matrices of the skins evaluated for the slotted joint palette (see SkinComponentManager::updateJointPaletteSlots)
+         */
+        struct JointPaletteWrites
+        {
+            std::vector<Mat4x4>                    joint_matrices; ///< Joint matrices of all written skins, in the order of ranges
+            std::vector<std::pair<size_t, size_t>> ranges;         ///< Offset in the slotted joint palette and joint count of each written skin
+        };
+
+        /**
+         * \brief Location of the last two evaluations of a skin in the slotted joint palette
+         */
+        struct JointPaletteBlend
+        {
+            size_t previous_offset;
+            size_t current_offset;
+            float  t; ///< Interpolation factor from the previous to the current evaluation, 1 samples only the current one
+        };
+
         class SkinComponentManager : public BaseSingleInstanceComponentManager
         {
         private:
             struct Data
             {
-                Data(Entity entity, std::vector<Entity> const& joints, std::vector<Mat4x4> const& inverse_bind_matrices)
-                    : entity(entity), joints(joints), inverse_bind_matrices(inverse_bind_matrices) {}
+                Data(Entity entity, std::vector<Entity> const& joints, std::vector<Mat4x4> const& inverse_bind_matrices, size_t palette_offset)
+                    : entity(entity), joints(joints), inverse_bind_matrices(inverse_bind_matrices), palette_offset(palette_offset), transform_index(0),
+                    frames_since_update(0), current_slot(JOINT_PALETTE_SLOT_CNT), previous_slot(JOINT_PALETTE_SLOT_CNT), slot_frames_since_update(0),
+                    slot_blend(1.0f) {}
 
                 Entity              entity;
                 std::vector<Entity> joints;
                 std::vector<Mat4x4> inverse_bind_matrices;
-                // store and reference bind matrices directly in GPU buffer
+                size_t              palette_offset; ///< Index of the first joint matrix in the joint palette
+
+                std::vector<size_t> joint_transform_indices; ///< Cached transform component indices of the joints, resolved on first use
+                size_t              transform_index;         ///< Cached transform component index of the skinned entity
+
+                std::vector<uint32_t>              joint_lod_levels; ///< Highest tier at which each joint is evaluated, empty for all tiers
+                std::vector<std::vector<uint32_t>> joint_remaps;     ///< Per tier, joint whose matrix is used for each joint, resolved on first use
+
+                std::vector<Mat4x4> previous_palette; ///< Last two evaluated joint matrices for interpolation at reduced update rates
+                std::vector<Mat4x4> current_palette;
+                uint32_t            frames_since_update;
+
+                uint32_t current_slot;             ///< Slot of the last evaluation in the slotted joint palette, JOINT_PALETTE_SLOT_CNT before the first one
+                uint32_t previous_slot;            ///< Slot of the evaluation before the last one
+                uint32_t slot_frames_since_update;
+                float    slot_blend;
             };
 
             std::vector<Data> m_data;
             std::shared_mutex m_data_access_mutex;
 
+            size_t m_joint_palette_size;
+
+            EngineCore::Utility::TaskScheduler m_palette_task_scheduler;
+            bool                               m_palette_tasks_enabled;
+
+            std::vector<AnimationLodTier> m_lod_tiers;
+            AnimationLodStats             m_lod_stats;
+            std::mutex                    m_lod_stats_mutex; ///< Also guards the writes of the current updateJointPaletteSlots call
+
+            JointPaletteWrites                                 m_slot_writes;         ///< Writes of the current updateJointPaletteSlots call
+            std::deque<std::pair<size_t, JointPaletteWrites>>  m_pending_slot_writes; ///< Writes by frame id that were not taken yet
+            std::mutex                                         m_pending_slot_writes_mutex;
+
+            /** Resolves cached indices and remaps of a skin and selects its animation LOD tier by camera distance */
+            size_t selectLodTier(Data& skin, Common::TransformComponentManager const& transform_mngr, Vec3 const& camera_position);
+
+            /** Updates the skins in [first, last), the caller holds the data access mutex exclusively */
+            void computeJointPalettes(
+                size_t first,
+                size_t last,
+                Common::TransformComponentManager const& transform_mngr,
+                Vec3 const& camera_position,
+                std::vector<Mat4x4>& joint_palette);
+
+            /** Updates the slots of the skins in [first, last), the caller holds the data access mutex exclusively */
+            void computeJointPaletteSlots(
+                size_t first,
+                size_t last,
+                Common::TransformComponentManager const& transform_mngr,
+                Vec3 const& camera_position);
+
+            /** Offset of a slot of the skin in the slotted joint palette */
+            static size_t computeSlotOffset(Data const& skin, uint32_t slot);
+
+            /** Evaluates the joints of the skin's reduced bone set at the given tier, returns the number of evaluated joints */
+            size_t computeJointPalette(
+                Data const& skin,
+                size_t tier,
+                Common::TransformComponentManager const& transform_mngr,
+                Mat4x4* joint_palette);
+
+            void computeJointRemaps(Data& skin, Common::TransformComponentManager const& transform_mngr);
+
         public:
-            SkinComponentManager() = default;
-            ~SkinComponentManager() = default;
+            /**
+             * Number of evaluations of each skin kept in the slotted joint palette. Evaluations rotate through the slots and never
+             * overwrite the two slots sampled by the previous frame, so the palette can be written while that frame is in flight.
+             */
+            static constexpr uint32_t JOINT_PALETTE_SLOT_CNT = 3;
+
+            SkinComponentManager();
+            ~SkinComponentManager();
 
             void addComponent(Entity entity, std::vector<Entity> const& joints, std::vector<Mat4x4> const& inverse_bind_matrices);
 
@@ -46,6 +156,75 @@ namespace EngineCore {
             std::vector<Mat4x4> const& getInvsereBindMatrices(Entity entity);
 
             std::vector<Mat4x4> const& getInvsereBindMatrices(size_t component_idx);
+
+            /**
+             * \brief Set the number of worker threads used for computing joint palettes, 0 computes them on the calling thread
+             */
+            void setJointPaletteWorkerThreads(int worker_thread_cnt);
+
+            /**
+             * \brief Total number of joint matrices of all skins, the slotted joint palette has JOINT_PALETTE_SLOT_CNT times as many
+             */
+            size_t getJointPaletteSize();
+
+            /**
+             * \brief Index of the first joint matrix of a skin in the joint palette
+             */
+            size_t getJointPaletteOffset(Entity entity);
+
+            /**
+             * \brief Set the animation LOD tiers, sorted by ascending min_distance. The default is a single tier that
+             * updates every frame.
+             */
+            void setAnimationLodTiers(std::vector<AnimationLodTier> const& tiers);
+
+            /**
+             * \brief Reduce the bone set of a skin at distant tiers. A joint above its level uses the joint matrix of
+             * its closest ancestor joint that is still evaluated, i.e. its vertices move rigidly with that ancestor.
+             * \param joint_lod_levels Highest tier at which each joint is evaluated, one entry per joint
+             */
+            void setJointLodLevels(Entity entity, std::vector<uint32_t> const& joint_lod_levels);
+
+            /**
+             * \brief Returns the tier statistics of the last updateJointPalettes call
+             */
+            AnimationLodStats getAnimationLodStats();
+
+            /**
+             * \brief Compute the joint matrices of all skins, i.e. the joint transformations relative to the skinned entity.
+             * Each skin is computed once, no matter how many meshes use it.
+             * Joint transform indices are cached, so joints must not be removed from the transform component manager.
+             * Blocks all other access to the skin components while running.
+             * \param camera_position World space position used for selecting the animation LOD tier of each skin
+             * \param joint_palette Receives the joint matrices of all skins, resized to getJointPaletteSize()
+             */
+            void updateJointPalettes(
+                Common::TransformComponentManager const& transform_mngr,
+                Vec3 const& camera_position,
+                std::vector<Mat4x4>& joint_palette);
+
+            /**
+             * \brief Compute the joint matrices of all skins that are due for evaluation and queue them for writing to the slotted
+             * joint palette, e.g. a persistent GPU buffer. The palette keeps the last evaluations of each skin in slots, so skins at
+             * reduced update rates are only written when they are evaluated and are interpolated when sampled (see getJointPaletteBlend).
+             * Use either this or updateJointPalettes, the interpolation state of the two is separate.
+             * \param frame_id Id of the frame the writes and blends belong to
+             */
+            void updateJointPaletteSlots(
+                Common::TransformComponentManager const& transform_mngr,
+                Vec3 const& camera_position,
+                size_t frame_id);
+
+            /**
+             * \brief Move the writes of all frames up to frame_id into writes, in order. Writes of frames that were dropped before
+             * rendering are included, so the slotted palette is complete for the given frame. Thread-safe.
+             */
+            void takeJointPaletteWrites(size_t frame_id, JointPaletteWrites& writes);
+
+            /**
+             * \brief Returns where to sample the joint matrices of a skin in the slotted joint palette, as of the last updateJointPaletteSlots call
+             */
+            JointPaletteBlend getJointPaletteBlend(Entity entity);
         };
     }
 }
@@ -0,0 +1,417 @@
+#include "SpatialHashGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace
+{
+    constexpr size_t entries_per_task = 4096;
+    constexpr size_t queries_per_task = 64;
+
+    /** Cell coordinates are stored with 21 bits each in the cell keys */
+    constexpr int32_t max_cell_coord = (1 << 20) - 1;
+    constexpr int32_t min_cell_coord = -(1 << 20);
+
+    using Neighbour = EngineCore::Common::SpatialHashGrid::Neighbour;
+
+    /** Max heap by distance, the root is the farthest of the current k nearest */
+    void pushNeighbour(std::vector<Neighbour>& heap, size_t k, Entity entity, float distance_squared)
+    {
+        auto is_closer = [](Neighbour const& lhs, Neighbour const& rhs) {
+            return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.entity.id() < rhs.entity.id());
+        };
+
+        Neighbour candidate = { entity, distance_squared };
+
+        if (heap.size() < k)
+        {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), is_closer);
+        }
+        else if (is_closer(candidate, heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), is_closer);
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), is_closer);
+        }
+    }
+}
+
+EngineCore::Common::SpatialHashGrid::SpatialHashGrid(WorldState& world, float cell_size)
+    : m_world(world),
+    m_cell_size(cell_size),
+    m_min_coords({ max_cell_coord, max_cell_coord, max_cell_coord }),
+    m_max_coords({ min_cell_coord, min_cell_coord, min_cell_coord }),
+    m_transform_version(0)
+{
+}
+
+void EngineCore::Common::SpatialHashGrid::update(Utility::TaskScheduler& task_scheduler)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    if (!m_world.has<TransformComponentManager>())
+        return;
+
+    // resolve the manager once, the lookup locks the world state
+    auto const& transform_mngr = m_world.get<TransformComponentManager>();
+
+    std::vector<size_t> modified;
+    m_transform_version = transform_mngr.getModifiedComponents(m_transform_version, modified);
+
+    if (modified.empty())
+        return;
+
+    // indices are ascending
+    if (m_entries.size() <= modified.back()) {
+        m_entries.resize(modified.back() + 1, { Entity(), Vec3(0.0f), invalid_cell, 0 });
+    }
+
+    std::vector<Entity> entities(modified.size());
+    std::vector<Vec3> positions(modified.size());
+
+    for (size_t first = 0; first < modified.size(); first += entries_per_task)
+    {
+        size_t last = std::min(first + entries_per_task, modified.size());
+
+        task_scheduler.submitTask([&transform_mngr, &modified, &entities, &positions, first, last]() {
+            for (size_t i = first; i < last; ++i)
+            {
+                entities[i] = transform_mngr.getEntity(modified[i]);
+                positions[i] = transform_mngr.getWorldPosition(modified[i]);
+            }
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    // the cell map is not thread safe for modification
+    for (size_t i = 0; i < modified.size(); ++i)
+    {
+        uint32_t entry_idx = static_cast<uint32_t>(modified[i]);
+        Entry& entry = m_entries[entry_idx];
+
+        entry.entity = entities[i];
+        entry.position = positions[i];
+
+        CellCoords coords = computeCellCoords(positions[i]);
+        uint64_t cell = computeCellKey(coords);
+
+        if (cell == entry.cell)
+            continue;
+
+        if (entry.cell != invalid_cell) {
+            removeEntry(entry_idx);
+        }
+        insertEntry(entry_idx, cell);
+
+        m_min_coords = { std::min(m_min_coords.x, coords.x), std::min(m_min_coords.y, coords.y), std::min(m_min_coords.z, coords.z) };
+        m_max_coords = { std::max(m_max_coords.x, coords.x), std::max(m_max_coords.y, coords.y), std::max(m_max_coords.z, coords.z) };
+    }
+}
+
+std::vector<Entity> EngineCore::Common::SpatialHashGrid::queryRadius(Vec3 center, float radius) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    std::vector<Entity> entities;
+    queryRadius(center, radius, entities);
+
+    return entities;
+}
+
+std::vector<EngineCore::Common::SpatialHashGrid::Neighbour> EngineCore::Common::SpatialHashGrid::queryNearest(Vec3 center, size_t k, float max_distance) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    std::vector<Neighbour> neighbours;
+    queryNearest(center, k, max_distance, neighbours);
+
+    return neighbours;
+}
+
+std::vector<std::vector<Entity>> EngineCore::Common::SpatialHashGrid::queryRadius(
+    std::vector<Vec3> const& centers,
+    float radius,
+    Utility::TaskScheduler& task_scheduler) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    std::vector<std::vector<Entity>> results(centers.size());
+
+    for (size_t first = 0; first < centers.size(); first += queries_per_task)
+    {
+        size_t last = std::min(first + queries_per_task, centers.size());
+
+        task_scheduler.submitTask([this, &centers, &results, radius, first, last]() {
+            for (size_t i = first; i < last; ++i) {
+                queryRadius(centers[i], radius, results[i]);
+            }
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    return results;
+}
+
+std::vector<std::vector<EngineCore::Common::SpatialHashGrid::Neighbour>> EngineCore::Common::SpatialHashGrid::queryNearest(
+    std::vector<Vec3> const& centers,
+    size_t k,
+    Utility::TaskScheduler& task_scheduler,
+    float max_distance) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    std::vector<std::vector<Neighbour>> results(centers.size());
+
+    for (size_t first = 0; first < centers.size(); first += queries_per_task)
+    {
+        size_t last = std::min(first + queries_per_task, centers.size());
+
+        task_scheduler.submitTask([this, &centers, &results, k, max_distance, first, last]() {
+            for (size_t i = first; i < last; ++i) {
+                queryNearest(centers[i], k, max_distance, results[i]);
+            }
+        });
+    }
+
+    task_scheduler.waitWhileBusy();
+
+    return results;
+}
+
+size_t EngineCore::Common::SpatialHashGrid::getEntryCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    size_t entry_cnt = 0;
+    for (auto const& cell : m_cells) {
+        entry_cnt += cell.second.size();
+    }
+
+    return entry_cnt;
+}
+
+size_t EngineCore::Common::SpatialHashGrid::getCellCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
+    return m_cells.size();
+}
+
+EngineCore::Common::SpatialHashGrid::CellCoords EngineCore::Common::SpatialHashGrid::computeCellCoords(Vec3 const& position) const
+{
+    auto to_coord = [this](float value) {
+        float coord = std::floor(value / m_cell_size);
+        coord = std::min(std::max(coord, static_cast<float>(min_cell_coord)), static_cast<float>(max_cell_coord));
+        return static_cast<int32_t>(coord);
+    };
+
+    return { to_coord(position.x), to_coord(position.y), to_coord(position.z) };
+}
+
+uint64_t EngineCore::Common::SpatialHashGrid::computeCellKey(CellCoords const& coords)
+{
+    constexpr uint64_t mask = (1ull << 21) - 1;
+
+    return ((static_cast<uint64_t>(coords.x) & mask) << 42) | ((static_cast<uint64_t>(coords.y) & mask) << 21) | (static_cast<uint64_t>(coords.z) & mask);
+}
+
+void EngineCore::Common::SpatialHashGrid::insertEntry(uint32_t entry_idx, uint64_t cell)
+{
+    auto& cell_entries = m_cells[cell];
+
+    m_entries[entry_idx].cell = cell;
+    m_entries[entry_idx].slot = static_cast<uint32_t>(cell_entries.size());
+
+    cell_entries.push_back(entry_idx);
+}
+
+void EngineCore::Common::SpatialHashGrid::removeEntry(uint32_t entry_idx)
+{
+    Entry& entry = m_entries[entry_idx];
+
+    auto cell_it = m_cells.find(entry.cell);
+    auto& cell_entries = cell_it->second;
+
+    // move the last entry of the cell into the freed slot
+    uint32_t moved_idx = cell_entries.back();
+    cell_entries[entry.slot] = moved_idx;
+    m_entries[moved_idx].slot = entry.slot;
+    cell_entries.pop_back();
+
+    if (cell_entries.empty()) {
+        m_cells.erase(cell_it);
+    }
+
+    entry.cell = invalid_cell;
+}
+
+void EngineCore::Common::SpatialHashGrid::queryRadius(Vec3 const& center, float radius, std::vector<Entity>& entities) const
+{
+    entities.clear();
+
+    if (m_cells.empty() || !(radius >= 0.0f))
+        return;
+
+    float radius_squared = radius * radius;
+
+    auto test_cell = [this, &center, radius_squared, &entities](std::vector<uint32_t> const& cell_entries) {
+        for (uint32_t entry_idx : cell_entries)
+        {
+            Vec3 offset = m_entries[entry_idx].position - center;
+            if (glm::dot(offset, offset) <= radius_squared) {
+                entities.push_back(m_entries[entry_idx].entity);
+            }
+        }
+    };
+
+    CellCoords lower = computeCellCoords(center - Vec3(radius));
+    CellCoords upper = computeCellCoords(center + Vec3(radius));
+
+    lower = { std::max(lower.x, m_min_coords.x), std::max(lower.y, m_min_coords.y), std::max(lower.z, m_min_coords.z) };
+    upper = { std::min(upper.x, m_max_coords.x), std::min(upper.y, m_max_coords.y), std::min(upper.z, m_max_coords.z) };
+
+    if (lower.x > upper.x || lower.y > upper.y || lower.z > upper.z)
+        return;
+
+    uint64_t range_cell_cnt =
+        static_cast<uint64_t>(upper.x - lower.x + 1) *
+        static_cast<uint64_t>(upper.y - lower.y + 1) *
+        static_cast<uint64_t>(upper.z - lower.z + 1);
+
+    // large radii cover more cells than are occupied, visiting the occupied cells is cheaper then
+    if (range_cell_cnt > m_cells.size())
+    {
+        for (auto const& cell : m_cells) {
+            test_cell(cell.second);
+        }
+    }
+    else
+    {
+        for (int32_t x = lower.x; x <= upper.x; ++x)
+        {
+            for (int32_t y = lower.y; y <= upper.y; ++y)
+            {
+                for (int32_t z = lower.z; z <= upper.z; ++z)
+                {
+                    auto cell_it = m_cells.find(computeCellKey({ x, y, z }));
+                    if (cell_it != m_cells.end()) {
+                        test_cell(cell_it->second);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(entities.begin(), entities.end(), [](Entity const& lhs, Entity const& rhs) { return lhs.id() < rhs.id(); });
+}
+
+void EngineCore::Common::SpatialHashGrid::queryNearest(Vec3 const& center, size_t k, float max_distance, std::vector<Neighbour>& neighbours) const
+{
+    neighbours.clear();
+
+    if (m_cells.empty() || k == 0 || !(max_distance >= 0.0f))
+        return;
+
+    // distances are squared until the result is sorted
+    float max_distance_squared = max_distance * max_distance;
+
+    auto test_cell = [this, &center, k, max_distance_squared, &neighbours](std::vector<uint32_t> const& cell_entries) {
+        for (uint32_t entry_idx : cell_entries)
+        {
+            Vec3 offset = m_entries[entry_idx].position - center;
+            float distance_squared = glm::dot(offset, offset);
+            if (distance_squared <= max_distance_squared) {
+                pushNeighbour(neighbours, k, m_entries[entry_idx].entity, distance_squared);
+            }
+        }
+    };
+
+    CellCoords c = computeCellCoords(center);
+
+    // search shells of cells around the center cell until no cell outside can hold a closer entry
+    size_t visited_cell_cnt = 0;
+    for (int64_t d = 0;; ++d)
+    {
+        int64_t ring_cell_cnt = d == 0 ? 1 : (2 * d + 1) * (2 * d + 1) * (2 * d + 1) - (2 * d - 1) * (2 * d - 1) * (2 * d - 1);
+
+        // sparse grids, visiting the occupied cells is cheaper than searching further shells
+        if (visited_cell_cnt + static_cast<size_t>(ring_cell_cnt) > m_cells.size())
+        {
+            neighbours.clear();
+            for (auto const& cell : m_cells) {
+                test_cell(cell.second);
+            }
+            break;
+        }
+        visited_cell_cnt += static_cast<size_t>(ring_cell_cnt);
+
+        int64_t lower_x = std::max<int64_t>(c.x - d, m_min_coords.x), upper_x = std::min<int64_t>(c.x + d, m_max_coords.x);
+        int64_t lower_y = std::max<int64_t>(c.y - d, m_min_coords.y), upper_y = std::min<int64_t>(c.y + d, m_max_coords.y);
+
+        for (int64_t x = lower_x; x <= upper_x; ++x)
+        {
+            for (int64_t y = lower_y; y <= upper_y; ++y)
+            {
+                auto test_coords = [&](int64_t z) {
+                    if (z < m_min_coords.z || z > m_max_coords.z)
+                        return;
+
+                    auto cell_it = m_cells.find(computeCellKey({ static_cast<int32_t>(x), static_cast<int32_t>(y), static_cast<int32_t>(z) }));
+                    if (cell_it != m_cells.end()) {
+                        test_cell(cell_it->second);
+                    }
+                };
+
+                // inside the shell only the two cells at the front and back are new
+                if (std::abs(x - c.x) < d && std::abs(y - c.y) < d)
+                {
+                    test_coords(c.z - d);
+                    test_coords(c.z + d);
+                }
+                else
+                {
+                    for (int64_t z = c.z - d; z <= c.z + d; ++z) {
+                        test_coords(z);
+                    }
+                }
+            }
+        }
+
+        bool covers_grid =
+            c.x - d <= m_min_coords.x && c.x + d >= m_max_coords.x &&
+            c.y - d <= m_min_coords.y && c.y + d >= m_max_coords.y &&
+            c.z - d <= m_min_coords.z && c.z + d >= m_max_coords.z;
+
+        if (covers_grid)
+            break;
+
+        // distance from the center to the closest point outside of the searched cells
+        float boundary_distance = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            int64_t coord = axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+            boundary_distance = std::min(boundary_distance, center[axis] - static_cast<float>(coord - d) * m_cell_size);
+            boundary_distance = std::min(boundary_distance, static_cast<float>(coord + d + 1) * m_cell_size - center[axis]);
+        }
+        boundary_distance = std::max(boundary_distance, 0.0f);
+
+        if (boundary_distance > max_distance)
+            break;
+
+        if (neighbours.size() == k && neighbours.front().distance <= boundary_distance * boundary_distance)
+            break;
+    }
+
+    std::sort(neighbours.begin(), neighbours.end(), [](Neighbour const& lhs, Neighbour const& rhs) {
+        return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.entity.id() < rhs.entity.id());
+    });
+
+    for (auto& neighbour : neighbours) {
+        neighbour.distance = std::sqrt(neighbour.distance);
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef SpatialHashGrid_hpp
+#define SpatialHashGrid_hpp
+
+#include <cstdint>
+#include <limits>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    class WorldState;
+
+    namespace Common
+    {
+        /**
+        * \class SpatialHashGrid
+        *
+        * \brief Answers proximity queries, i.e. all entities within a radius or the k nearest entities of a point,
+        * e.g. for AI perception and audio.
+        *
+        * Entities are stored by the world position of their transform component in uniform cells, only occupied
+        * cells are stored in a hash map. Each update only moves the entries of transform components that were
+        * modified since the last update (see TransformComponentManager::getModifiedComponents).
+        * The cell size should be in the order of the typical query radius.
+        * Transform components are never removed from the grid, as deleted components are only reused by the
+        * TransformComponentManager.
+        */
+        class SpatialHashGrid
+        {
+        public:
+            struct Neighbour
+            {
+                Entity entity;
+                float  distance;
+            };
+
+            SpatialHashGrid(WorldState& world, float cell_size = 4.0f);
+            ~SpatialHashGrid() = default;
+
+            SpatialHashGrid(SpatialHashGrid const& cpy) = delete;
+            SpatialHashGrid& operator=(SpatialHashGrid const& rhs) = delete;
+
+            /**
+            * \brief Move the entries of modified transform components, world positions are gathered on the task
+            * scheduler. Meant to be called once per frame after transformations were updated.
+            */
+            void update(Utility::TaskScheduler& task_scheduler);
+
+            /**
+            * \brief Entities within the radius around the center, sorted by entity id
+            */
+            std::vector<Entity> queryRadius(Vec3 center, float radius) const;
+
+            /**
+            * \brief Up to k entities closest to the center that are within max_distance, sorted by distance
+            */
+            std::vector<Neighbour> queryNearest(Vec3 center, size_t k, float max_distance = std::numeric_limits<float>::max()) const;
+
+            /**
+            * \brief Batched radius queries, the queries are split into tasks of the task scheduler.
+            * Results are in the order of the centers.
+            */
+            std::vector<std::vector<Entity>> queryRadius(std::vector<Vec3> const& centers, float radius, Utility::TaskScheduler& task_scheduler) const;
+
+            /**
+            * \brief Batched k nearest queries, the queries are split into tasks of the task scheduler.
+            * Results are in the order of the centers.
+            */
+            std::vector<std::vector<Neighbour>> queryNearest(
+                std::vector<Vec3> const& centers,
+                size_t k,
+                Utility::TaskScheduler& task_scheduler,
+                float max_distance = std::numeric_limits<float>::max()) const;
+
+            size_t getEntryCount() const;
+
+            size_t getCellCount() const;
+
+        private:
+            struct CellCoords
+            {
+                int32_t x, y, z;
+            };
+
+            struct Entry
+            {
+                Entity   entity;
+                Vec3     position;
+                uint64_t cell;  ///< Key of the cell the entry is stored in, invalid_cell if not stored yet
+                uint32_t slot;  ///< Position in the entry list of the cell
+            };
+
+            static constexpr uint64_t invalid_cell = std::numeric_limits<uint64_t>::max();
+
+            CellCoords computeCellCoords(Vec3 const& position) const;
+
+            static uint64_t computeCellKey(CellCoords const& coords);
+
+            void insertEntry(uint32_t entry_idx, uint64_t cell);
+
+            void removeEntry(uint32_t entry_idx);
+
+            void queryRadius(Vec3 const& center, float radius, std::vector<Entity>& entities) const;
+
+            void queryNearest(Vec3 const& center, size_t k, float max_distance, std::vector<Neighbour>& neighbours) const;
+
+            WorldState& m_world;
+            float       m_cell_size;
+
+            /** Entries in component order of the TransformComponentManager */
+            std::vector<Entry> m_entries;
+
+            /** Entry indices of each occupied cell */
+            std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+
+            /** Cell coordinate range that ever held entries, bounds the search of nearest queries */
+            CellCoords m_min_coords;
+            CellCoords m_max_coords;
+
+            uint64_t m_transform_version;
+
+            mutable std::shared_mutex m_data_access_mutex;
+        };
+    }
+}
+
+#endif // !SpatialHashGrid_hpp
@@ -7,32 +7,31 @@ void EngineCore::Utility::TaskScheduler::run(int worker_thread_cnt)
     worker_thread_pool_.resize(worker_thread_cnt);
     task_schedueler_active_.test_and_set();
     busy_threads_cnt_ = 0;
-    tasks_cnt_ = 0;
 
     for (int i = 0; i < worker_thread_cnt; ++i)
     {
         worker_thread_pool_[i] = std::thread([this]() {
-            while (task_schedueler_active_.test())
+            for (;;)
             {
                 std::function<void()> task;
-                bool success = false;
 
                 {
                     // atomically try to pop task from queue and increment busy if successful
                     std::unique_lock<std::mutex> lock(mutex_);
-                    cvar_.wait(lock, [this] { return (tasks_cnt_.load() > 0); });
+                    cvar_.wait(lock, [this] { return (tasks_cnt_.load() > 0) || !task_schedueler_active_.test(); });
+
+                    // woken up by stop() with nothing left to do, queued tasks are drained before exiting
+                    if (tasks_cnt_.load() == 0)
+                        break;
+
                     task = std::move(queue_.front());
                     queue_.pop();
                     --tasks_cnt_;
                     ++busy_threads_cnt_;
-                    success = true;
                 }
 
-                if (success)
-                {
-                    task();
-                    --busy_threads_cnt_;
-                }
+                task();
+                --busy_threads_cnt_;
 
                 cvar_.notify_all();
             }
@@ -42,14 +41,42 @@ void EngineCore::Utility::TaskScheduler::run(int worker_thread_cnt)
 
 void EngineCore::Utility::TaskScheduler::stop()
 {
-    task_schedueler_active_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_schedueler_active_.clear();
+    }
+    cvar_.notify_all();
 
     for (auto& thread : worker_thread_pool_)
         thread.join();
+
+    worker_thread_pool_.clear();
+
+    // without workers, e.g. if run was never called, left over tasks run on the calling thread
+    for (;;)
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty())
+                break;
+
+            task = std::move(queue_.front());
+            queue_.pop();
+            --tasks_cnt_;
+        }
+        task();
+    }
 }
 
 void EngineCore::Utility::TaskScheduler::submitTask(Task new_task)
 {
+    if (fixed_order_.load())
+    {
+        new_task();
+        return;
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex_);
         queue_.push(new_task);
@@ -69,3 +96,15 @@ void EngineCore::Utility::TaskScheduler::waitWhileBusy()
     std::unique_lock<std::mutex> lock(mutex_);
     while (!cvar_.wait_for(lock, std::chrono::microseconds(10), [this] { return (tasks_cnt_.load() == 0) && (busy_threads_cnt_.load() == 0); }));
 }
+
+void EngineCore::Utility::TaskScheduler::setFixedOrder(bool fixed_order)
+{
+    // tasks that were submitted before keep running on the workers
+    waitWhileBusy();
+    fixed_order_ = fixed_order;
+}
+
+bool EngineCore::Utility::TaskScheduler::isFixedOrder() const
+{
+    return fixed_order_.load();
+}
@@ -28,13 +28,20 @@ namespace EngineCore
             std::condition_variable  cvar_;
 
             /** Atomically keep track of threads currently busy processing a task */
-            std::atomic_int          busy_threads_cnt_;
+            std::atomic_int          busy_threads_cnt_ = 0;
             /** Atomically keep track of tasks currently still in queue */
-            std::atomic_int          tasks_cnt_;
+            std::atomic_int          tasks_cnt_ = 0;
+
+            /** Run tasks on the submitting thread in submission order, see setFixedOrder */
+            std::atomic_bool         fixed_order_ = false;
 
         public:
             void run(int worker_thread_cnt);
 
+            /**
+             * Runs all queued tasks to completion and joins the worker threads. Tasks may still submit new tasks
+             * while the queue is drained. The scheduler can be started again with run afterwards.
+             */
             void stop();
 
             void submitTask(Task new_task);
@@ -42,6 +49,15 @@ namespace EngineCore
             bool empty() const;
 
             void waitWhileBusy();
+
+            /**
+             * In fixed order mode, submitted tasks are run right away on the submitting thread instead of the
+             * worker threads. Results then don't depend on the number of workers or their timing, e.g. for
+             * deterministic replays of recorded simulations. Tasks must not wait for other tasks in this mode.
+             */
+            void setFixedOrder(bool fixed_order);
+
+            bool isFixedOrder() const;
         };
     }
 }
@@ -1775,9 +1775,20 @@ namespace Landscape
 			transformFeedback_terrainOutput_prgm = new GLSLProgram();
 			transformFeedback_terrainOutput_prgm->init();
 
-			std::string vertex_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_v.glsl");
-			std::string tessellationControl_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_tc.glsl");
-			std::string tessellationEvaluation_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_te.glsl");
+			std::string vertex_src;
+			std::string tessellationControl_src;
+			std::string tessellationEvaluation_src;
+			try
+			{
+				vertex_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_v.glsl");
+				tessellationControl_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_tc.glsl");
+				tessellationEvaluation_src = ResourceLoading::readShaderFile("../resources/shaders/dfr_landscapeSurface_te.glsl");
+			}
+			catch (std::runtime_error const& e)
+			{
+				// shader stages that could not be read stay empty and are skipped below
+				std::cerr << "Exception reading transform feedback shaders : " << e.what() << std::endl;
+			}
 		
 			transformFeedback_terrainOutput_prgm->bindAttribLocation(0, "vPosition");
 			transformFeedback_terrainOutput_prgm->bindAttribLocation(1, "vNormal");
@@ -5505,7 +5516,15 @@ namespace Landscape
 		// read ppm image
 		std::vector<uint8_t> image_data;
 		TextureLayout image_layout;
-		ResourceLoading::loadPpmImage(heightmap_path, image_data, image_layout);
+		try
+		{
+			ResourceLoading::loadPpmImage(heightmap_path, image_data, image_layout);
+		}
+		catch (std::runtime_error const& e)
+		{
+			std::cout << "Failed to read heightmap: " << e.what() << std::endl;
+			return GEngineCore::entityManager().create(); //return dummy entity...think of something more clever
+		}
 
 		// generate mesh based on heightmap
 		std::vector<float> vertex_data;
@@ -0,0 +1,963 @@
+#include "TextureCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        namespace
+        {
+            typedef GenericTextureLayout::InternalFormat InternalFormat;
+
+            /** Block rows encoded per task */
+            constexpr int block_rows_per_task = 8;
+
+            /** Interpolation weights of BC7 4bit indices */
+            constexpr std::array<int, 16> bc7_weights4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+            template<int D>
+            using Vector = std::array<float, D>;
+
+            /**
+            * Mean and principal axis of the given texels, the principal axis is found by power iteration on the covariance matrix.
+            * Only the first D channels of the RGBA texels are taken into account.
+            */
+            template<int D>
+            void computePrincipalAxis(uint8_t const* rgba_block, bool const* mask, Vector<D>& mean, Vector<D>& axis)
+            {
+                mean.fill(0.0f);
+                int cnt = 0;
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!mask[i]) continue;
+                    for (int c = 0; c < D; ++c) {
+                        mean[c] += rgba_block[i * 4 + c];
+                    }
+                    ++cnt;
+                }
+                for (int c = 0; c < D; ++c) {
+                    mean[c] /= static_cast<float>(std::max(cnt, 1));
+                }
+
+                std::array<float, D * D> cov;
+                cov.fill(0.0f);
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!mask[i]) continue;
+                    for (int r = 0; r < D; ++r) {
+                        for (int c = 0; c < D; ++c) {
+                            cov[r * D + c] += (rgba_block[i * 4 + r] - mean[r]) * (rgba_block[i * 4 + c] - mean[c]);
+                        }
+                    }
+                }
+
+                axis.fill(1.0f);
+                for (int iteration = 0; iteration < 8; ++iteration)
+                {
+                    Vector<D> tmp;
+                    tmp.fill(0.0f);
+                    for (int r = 0; r < D; ++r) {
+                        for (int c = 0; c < D; ++c) {
+                            tmp[r] += cov[r * D + c] * axis[c];
+                        }
+                    }
+
+                    float length = 0.0f;
+                    for (int c = 0; c < D; ++c) {
+                        length = std::max(length, std::abs(tmp[c]));
+                    }
+
+                    if (length < 1.0e-6f) {
+                        // (almost) uniform block, any axis will do
+                        break;
+                    }
+
+                    for (int c = 0; c < D; ++c) {
+                        axis[c] = tmp[c] / length;
+                    }
+                }
+            }
+
+            /**
+            * Endpoints spanning the projection of all texels onto the principal axis
+            */
+            template<int D>
+            void computeEndpoints(uint8_t const* rgba_block, bool const* mask, Vector<D>& e0, Vector<D>& e1)
+            {
+                Vector<D> mean, axis;
+                computePrincipalAxis<D>(rgba_block, mask, mean, axis);
+
+                float axis_sq = 0.0f;
+                for (int c = 0; c < D; ++c) {
+                    axis_sq += axis[c] * axis[c];
+                }
+
+                float t_min = 0.0f;
+                float t_max = 0.0f;
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!mask[i]) continue;
+                    float t = 0.0f;
+                    for (int c = 0; c < D; ++c) {
+                        t += (rgba_block[i * 4 + c] - mean[c]) * axis[c];
+                    }
+                    t /= axis_sq;
+                    t_min = std::min(t_min, t);
+                    t_max = std::max(t_max, t);
+                }
+
+                for (int c = 0; c < D; ++c)
+                {
+                    e0[c] = std::clamp(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+                    e1[c] = std::clamp(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+                }
+            }
+
+            /**
+            * Least squares fit of both endpoints for fixed interpolation weights (fraction of e1 per texel).
+            * Returns false if the system is singular, e.g. if all texels use the same index.
+            */
+            template<int D>
+            bool refineEndpoints(uint8_t const* rgba_block, bool const* mask, float const* weights, Vector<D>& e0, Vector<D>& e1)
+            {
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+                Vector<D> ax, bx;
+                ax.fill(0.0f);
+                bx.fill(0.0f);
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!mask[i]) continue;
+                    float a = 1.0f - weights[i];
+                    float b = weights[i];
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+                    for (int c = 0; c < D; ++c)
+                    {
+                        ax[c] += a * rgba_block[i * 4 + c];
+                        bx[c] += b * rgba_block[i * 4 + c];
+                    }
+                }
+
+                float det = aa * bb - ab * ab;
+                if (std::abs(det) < 1.0e-6f)
+                    return false;
+
+                for (int c = 0; c < D; ++c)
+                {
+                    e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+                    e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+                }
+
+                return true;
+            }
+
+            template<int D>
+            int squaredDistance(uint8_t const* texel, uint8_t const* palette_entry)
+            {
+                int retval = 0;
+                for (int c = 0; c < D; ++c)
+                {
+                    int d = static_cast<int>(texel[c]) - static_cast<int>(palette_entry[c]);
+                    retval += d * d;
+                }
+                return retval;
+            }
+
+            /**
+            * Assign the nearest palette entry to each masked texel, returns the total squared error
+            */
+            template<int D, int PaletteSize>
+            int assignIndices(uint8_t const* rgba_block, bool const* mask, uint8_t const* palette, uint8_t* indices)
+            {
+                int error = 0;
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!mask[i]) continue;
+
+                    int best_dist = std::numeric_limits<int>::max();
+                    for (int p = 0; p < PaletteSize; ++p)
+                    {
+                        int dist = squaredDistance<D>(rgba_block + i * 4, palette + p * 4);
+                        if (dist < best_dist)
+                        {
+                            best_dist = dist;
+                            indices[i] = static_cast<uint8_t>(p);
+                        }
+                    }
+                    error += best_dist;
+                }
+                return error;
+            }
+
+            //////////////////////////////
+            // BC1 colour block
+            //////////////////////////////
+
+            uint16_t packColor565(Vector<3> const& color)
+            {
+                uint16_t r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+                uint16_t g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+                uint16_t b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+                return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+            }
+
+            void unpackColor565(uint16_t color, uint8_t* rgb)
+            {
+                uint8_t r = (color >> 11) & 0x1F;
+                uint8_t g = (color >> 5) & 0x3F;
+                uint8_t b = color & 0x1F;
+                rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+                rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+                rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+            }
+
+            /**
+            * Palette of a BC1 colour block, c0 > c1 selects four colours, otherwise three colours and transparent black
+            */
+            std::array<uint8_t, 16> computeColorPalette(uint16_t c0, uint16_t c1, bool force_four_colors)
+            {
+                std::array<uint8_t, 16> retval;
+                unpackColor565(c0, retval.data());
+                unpackColor565(c1, retval.data() + 4);
+                retval[3] = 255;
+                retval[7] = 255;
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    if (c0 > c1 || force_four_colors)
+                    {
+                        retval[8 + c] = static_cast<uint8_t>((2 * retval[c] + retval[4 + c]) / 3);
+                        retval[12 + c] = static_cast<uint8_t>((retval[c] + 2 * retval[4 + c]) / 3);
+                    }
+                    else
+                    {
+                        retval[8 + c] = static_cast<uint8_t>((retval[c] + retval[4 + c]) / 2);
+                        retval[12 + c] = 0;
+                    }
+                }
+                retval[11] = 255;
+                retval[15] = (c0 > c1 || force_four_colors) ? 255 : 0;
+
+                return retval;
+            }
+
+            /**
+            * Encode the colour part of a BC1/BC3 block.
+            * \param allow_transparency If true, texels with alpha < 128 are encoded using BC1's transparent palette entry
+            */
+            void encodeColorBlock(uint8_t const* rgba_block, bool allow_transparency, uint8_t* tgt)
+            {
+                bool mask[16];
+                bool has_transparency = false;
+                bool has_opaque = false;
+                for (int i = 0; i < 16; ++i)
+                {
+                    mask[i] = !allow_transparency || rgba_block[i * 4 + 3] >= 128;
+                    has_transparency |= !mask[i];
+                    has_opaque |= mask[i];
+                }
+
+                uint16_t c0 = 0;
+                uint16_t c1 = 0;
+                uint8_t indices[16] = {};
+
+                if (has_opaque)
+                {
+                    Vector<3> e0, e1;
+                    computeEndpoints<3>(rgba_block, mask, e0, e1);
+
+                    int best_error = std::numeric_limits<int>::max();
+
+                    // initial guess from the principal axis, then refine once with a least squares fit
+                    for (int iteration = 0; iteration < 2; ++iteration)
+                    {
+                        uint16_t q0 = packColor565(e0);
+                        uint16_t q1 = packColor565(e1);
+
+                        // the transparent mode requires c0 <= c1, the four colour mode c0 > c1
+                        if ((has_transparency && q0 > q1) || (!has_transparency && q0 < q1)) {
+                            std::swap(q0, q1);
+                        }
+
+                        // opaque texels must never pick the transparent entry of the three colour mode
+                        bool three_color_mode = allow_transparency && q0 <= q1;
+                        auto palette = computeColorPalette(q0, q1, !allow_transparency);
+
+                        uint8_t candidate_indices[16] = {};
+                        int error = three_color_mode
+                            ? assignIndices<3, 3>(rgba_block, mask, palette.data(), candidate_indices)
+                            : assignIndices<3, 4>(rgba_block, mask, palette.data(), candidate_indices);
+
+                        if (error < best_error)
+                        {
+                            best_error = error;
+                            c0 = q0;
+                            c1 = q1;
+                            std::copy_n(candidate_indices, 16, indices);
+                        }
+
+                        if (has_transparency || c0 == c1)
+                            break;
+
+                        float weights[16];
+                        constexpr float four_color_weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+                        for (int i = 0; i < 16; ++i) {
+                            weights[i] = four_color_weights[indices[i]];
+                        }
+
+                        Vector<3> r0, r1;
+                        if (!refineEndpoints<3>(rgba_block, mask, weights, r0, r1))
+                            break;
+
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            e0[c] = r0[c];
+                            e1[c] = r1[c];
+                        }
+                    }
+                }
+
+                uint32_t index_bits = 0;
+                for (int i = 0; i < 16; ++i)
+                {
+                    uint32_t index = mask[i] ? indices[i] : 3;
+                    index_bits |= index << (2 * i);
+                }
+
+                tgt[0] = static_cast<uint8_t>(c0 & 0xFF);
+                tgt[1] = static_cast<uint8_t>(c0 >> 8);
+                tgt[2] = static_cast<uint8_t>(c1 & 0xFF);
+                tgt[3] = static_cast<uint8_t>(c1 >> 8);
+                for (int i = 0; i < 4; ++i) {
+                    tgt[4 + i] = static_cast<uint8_t>((index_bits >> (8 * i)) & 0xFF);
+                }
+            }
+
+            void decodeColorBlock(uint8_t const* src, bool force_four_colors, uint8_t* rgba_block)
+            {
+                uint16_t c0 = static_cast<uint16_t>(src[0] | (src[1] << 8));
+                uint16_t c1 = static_cast<uint16_t>(src[2] | (src[3] << 8));
+                uint32_t index_bits = src[4] | (src[5] << 8) | (src[6] << 16) | (static_cast<uint32_t>(src[7]) << 24);
+
+                auto palette = computeColorPalette(c0, c1, force_four_colors);
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    uint32_t index = (index_bits >> (2 * i)) & 0x3;
+                    std::copy_n(palette.data() + index * 4, 4, rgba_block + i * 4);
+                }
+            }
+
+            //////////////////////////////
+            // BC4 single channel block
+            //////////////////////////////
+
+            std::array<uint8_t, 8> computeChannelPalette(uint8_t a0, uint8_t a1)
+            {
+                std::array<uint8_t, 8> retval;
+                retval[0] = a0;
+                retval[1] = a1;
+                if (a0 > a1)
+                {
+                    for (int i = 1; i < 7; ++i) {
+                        retval[1 + i] = static_cast<uint8_t>(((7 - i) * a0 + i * a1 + 3) / 7);
+                    }
+                }
+                else
+                {
+                    for (int i = 1; i < 5; ++i) {
+                        retval[1 + i] = static_cast<uint8_t>(((5 - i) * a0 + i * a1 + 2) / 5);
+                    }
+                    retval[6] = 0;
+                    retval[7] = 255;
+                }
+                return retval;
+            }
+
+            void encodeChannelBlock(uint8_t const* rgba_block, int channel, uint8_t* tgt)
+            {
+                uint8_t v_min = 255;
+                uint8_t v_max = 0;
+                for (int i = 0; i < 16; ++i)
+                {
+                    v_min = std::min(v_min, rgba_block[i * 4 + channel]);
+                    v_max = std::max(v_max, rgba_block[i * 4 + channel]);
+                }
+
+                // eight value mode, degenerates gracefully to a constant block if v_max == v_min
+                auto palette = computeChannelPalette(v_max, v_min);
+
+                uint64_t index_bits = 0;
+                for (int i = 0; i < 16; ++i)
+                {
+                    int best_dist = std::numeric_limits<int>::max();
+                    uint64_t best_index = 0;
+                    for (int p = 0; p < 8; ++p)
+                    {
+                        int dist = std::abs(static_cast<int>(rgba_block[i * 4 + channel]) - static_cast<int>(palette[p]));
+                        if (dist < best_dist)
+                        {
+                            best_dist = dist;
+                            best_index = static_cast<uint64_t>(p);
+                        }
+                    }
+                    index_bits |= best_index << (3 * i);
+                }
+
+                tgt[0] = v_max;
+                tgt[1] = v_min;
+                for (int i = 0; i < 6; ++i) {
+                    tgt[2 + i] = static_cast<uint8_t>((index_bits >> (8 * i)) & 0xFF);
+                }
+            }
+
+            void decodeChannelBlock(uint8_t const* src, int channel, uint8_t* rgba_block)
+            {
+                auto palette = computeChannelPalette(src[0], src[1]);
+
+                uint64_t index_bits = 0;
+                for (int i = 0; i < 6; ++i) {
+                    index_bits |= static_cast<uint64_t>(src[2 + i]) << (8 * i);
+                }
+
+                for (int i = 0; i < 16; ++i) {
+                    rgba_block[i * 4 + channel] = palette[(index_bits >> (3 * i)) & 0x7];
+                }
+            }
+
+            //////////////////////////////
+            // BC7 mode 6 block
+            //////////////////////////////
+
+            struct BitWriter
+            {
+                uint8_t* data;
+                int      position = 0;
+
+                void write(uint32_t value, int bit_cnt)
+                {
+                    for (int i = 0; i < bit_cnt; ++i, ++position)
+                    {
+                        if ((value >> i) & 0x1) {
+                            data[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+                        }
+                    }
+                }
+            };
+
+            struct BitReader
+            {
+                uint8_t const* data;
+                int            position = 0;
+
+                uint32_t read(int bit_cnt)
+                {
+                    uint32_t retval = 0;
+                    for (int i = 0; i < bit_cnt; ++i, ++position) {
+                        retval |= static_cast<uint32_t>((data[position / 8] >> (position % 8)) & 0x1) << i;
+                    }
+                    return retval;
+                }
+            };
+
+            /**
+            * Quantize an endpoint to 7bit per channel plus shared p-bit, picking the p-bit with the lower error
+            */
+            void quantizeEndpointBC7(Vector<4> const& endpoint, std::array<uint8_t, 4>& quantized, uint8_t& p_bit)
+            {
+                float best_error = std::numeric_limits<float>::max();
+                for (uint8_t p = 0; p < 2; ++p)
+                {
+                    std::array<uint8_t, 4> q;
+                    float error = 0.0f;
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        q[c] = static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround((endpoint[c] - p) * 0.5f)), 0, 127));
+                        float d = static_cast<float>((q[c] << 1) | p) - endpoint[c];
+                        error += d * d;
+                    }
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        quantized = q;
+                        p_bit = p;
+                    }
+                }
+            }
+
+            std::array<uint8_t, 64> computePaletteBC7(std::array<uint8_t, 4> const& q0, uint8_t p0, std::array<uint8_t, 4> const& q1, uint8_t p1)
+            {
+                std::array<uint8_t, 64> retval;
+                for (int i = 0; i < 16; ++i)
+                {
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        int e0 = (q0[c] << 1) | p0;
+                        int e1 = (q1[c] << 1) | p1;
+                        retval[i * 4 + c] = static_cast<uint8_t>(((64 - bc7_weights4[i]) * e0 + bc7_weights4[i] * e1 + 32) >> 6);
+                    }
+                }
+                return retval;
+            }
+
+            void encodeBlockBC7(uint8_t const* rgba_block, uint8_t* tgt)
+            {
+                bool mask[16];
+                std::fill_n(mask, 16, true);
+
+                Vector<4> e0, e1;
+                computeEndpoints<4>(rgba_block, mask, e0, e1);
+
+                std::array<uint8_t, 4> q0, q1;
+                uint8_t p0 = 0, p1 = 0;
+                uint8_t indices[16] = {};
+                int best_error = std::numeric_limits<int>::max();
+
+                for (int iteration = 0; iteration < 2; ++iteration)
+                {
+                    std::array<uint8_t, 4> c_q0, c_q1;
+                    uint8_t c_p0, c_p1;
+                    quantizeEndpointBC7(e0, c_q0, c_p0);
+                    quantizeEndpointBC7(e1, c_q1, c_p1);
+
+                    uint8_t candidate_indices[16] = {};
+                    auto palette = computePaletteBC7(c_q0, c_p0, c_q1, c_p1);
+                    int error = assignIndices<4, 16>(rgba_block, mask, palette.data(), candidate_indices);
+
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        q0 = c_q0; q1 = c_q1;
+                        p0 = c_p0; p1 = c_p1;
+                        std::copy_n(candidate_indices, 16, indices);
+                    }
+
+                    float weights[16];
+                    for (int i = 0; i < 16; ++i) {
+                        weights[i] = static_cast<float>(bc7_weights4[indices[i]]) / 64.0f;
+                    }
+
+                    if (!refineEndpoints<4>(rgba_block, mask, weights, e0, e1))
+                        break;
+                }
+
+                // the most significant bit of the anchor index is implicitly zero
+                if (indices[0] & 0x8)
+                {
+                    std::swap(q0, q1);
+                    std::swap(p0, p1);
+                    for (int i = 0; i < 16; ++i) {
+                        indices[i] = static_cast<uint8_t>(15 - indices[i]);
+                    }
+                }
+
+                std::fill_n(tgt, 16, static_cast<uint8_t>(0));
+                BitWriter writer{ tgt };
+
+                writer.write(1 << 6, 7); // mode 6
+                for (int c = 0; c < 4; ++c)
+                {
+                    writer.write(q0[c], 7);
+                    writer.write(q1[c], 7);
+                }
+                writer.write(p0, 1);
+                writer.write(p1, 1);
+                writer.write(indices[0], 3);
+                for (int i = 1; i < 16; ++i) {
+                    writer.write(indices[i], 4);
+                }
+            }
+
+            void decodeBlockBC7(uint8_t const* src, uint8_t* rgba_block)
+            {
+                BitReader reader{ src };
+
+                if (reader.read(7) != (1 << 6))
+                {
+                    std::fill_n(rgba_block, 64, static_cast<uint8_t>(0));
+                    return;
+                }
+
+                std::array<uint8_t, 4> q0, q1;
+                for (int c = 0; c < 4; ++c)
+                {
+                    q0[c] = static_cast<uint8_t>(reader.read(7));
+                    q1[c] = static_cast<uint8_t>(reader.read(7));
+                }
+                uint8_t p0 = static_cast<uint8_t>(reader.read(1));
+                uint8_t p1 = static_cast<uint8_t>(reader.read(1));
+
+                auto palette = computePaletteBC7(q0, p0, q1, p1);
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    uint32_t index = reader.read(i == 0 ? 3 : 4);
+                    std::copy_n(palette.data() + index * 4, 4, rgba_block + i * 4);
+                }
+            }
+
+            /**
+            * Encode the block rows [block_row_begin,block_row_end) of a single mip level
+            */
+            void compressBlockRows(
+                uint8_t const* src,
+                int width,
+                int height,
+                int channel_cnt,
+                InternalFormat internal_format,
+                int block_row_begin,
+                int block_row_end,
+                uint8_t* tgt)
+            {
+                int block_cnt_x = (width + 3) / 4;
+                size_t block_size = computeBlockSize(internal_format);
+
+                uint8_t rgba_block[64];
+
+                for (int block_y = block_row_begin; block_y < block_row_end; ++block_y)
+                {
+                    for (int block_x = 0; block_x < block_cnt_x; ++block_x)
+                    {
+                        // gather block texels, replicating edge texels for partial blocks
+                        for (int i = 0; i < 16; ++i)
+                        {
+                            int x = std::min(block_x * 4 + (i % 4), width - 1);
+                            int y = std::min(block_y * 4 + (i / 4), height - 1);
+                            uint8_t const* texel = src + (static_cast<size_t>(y) * width + x) * channel_cnt;
+
+                            rgba_block[i * 4 + 0] = texel[0];
+                            rgba_block[i * 4 + 1] = channel_cnt > 1 ? texel[1] : 0;
+                            rgba_block[i * 4 + 2] = channel_cnt > 2 ? texel[2] : 0;
+                            rgba_block[i * 4 + 3] = channel_cnt > 3 ? texel[3] : 255;
+                        }
+
+                        size_t block_idx = static_cast<size_t>(block_y) * block_cnt_x + block_x;
+                        compressBlock(internal_format, rgba_block, tgt + block_idx * block_size);
+                    }
+                }
+            }
+        }
+
+        bool isBlockCompressed(GenericTextureLayout::InternalFormat internal_format)
+        {
+            return computeBlockSize(internal_format) != 0;
+        }
+
+        size_t computeBlockSize(GenericTextureLayout::InternalFormat internal_format)
+        {
+            switch (internal_format)
+            {
+            case InternalFormat::BC1_RGBA:
+            case InternalFormat::BC4_R:
+                return 8;
+            case InternalFormat::BC3_RGBA:
+            case InternalFormat::BC5_RG:
+            case InternalFormat::BC7_RGBA:
+                return 16;
+            default:
+                return 0;
+            }
+        }
+
+        size_t computeCompressedSize(GenericTextureLayout::InternalFormat internal_format, int width, int height)
+        {
+            size_t block_cnt = static_cast<size_t>((width + 3) / 4) * static_cast<size_t>((height + 3) / 4);
+            return block_cnt * computeBlockSize(internal_format);
+        }
+
+        void compressBlock(GenericTextureLayout::InternalFormat internal_format, uint8_t const* rgba_block, uint8_t* tgt)
+        {
+            switch (internal_format)
+            {
+            case InternalFormat::BC1_RGBA:
+                encodeColorBlock(rgba_block, true, tgt);
+                break;
+            case InternalFormat::BC3_RGBA:
+                encodeChannelBlock(rgba_block, 3, tgt);
+                encodeColorBlock(rgba_block, false, tgt + 8);
+                break;
+            case InternalFormat::BC4_R:
+                encodeChannelBlock(rgba_block, 0, tgt);
+                break;
+            case InternalFormat::BC5_RG:
+                encodeChannelBlock(rgba_block, 0, tgt);
+                encodeChannelBlock(rgba_block, 1, tgt + 8);
+                break;
+            case InternalFormat::BC7_RGBA:
+                encodeBlockBC7(rgba_block, tgt);
+                break;
+            default:
+                break;
+            }
+        }
+
+        void decompressBlock(GenericTextureLayout::InternalFormat internal_format, uint8_t const* src, uint8_t* rgba_block)
+        {
+            switch (internal_format)
+            {
+            case InternalFormat::BC1_RGBA:
+                decodeColorBlock(src, false, rgba_block);
+                break;
+            case InternalFormat::BC3_RGBA:
+                decodeColorBlock(src + 8, true, rgba_block);
+                decodeChannelBlock(src, 3, rgba_block);
+                break;
+            case InternalFormat::BC4_R:
+            case InternalFormat::BC5_RG:
+                for (int i = 0; i < 16; ++i)
+                {
+                    rgba_block[i * 4 + 1] = 0;
+                    rgba_block[i * 4 + 2] = 0;
+                    rgba_block[i * 4 + 3] = 255;
+                }
+                decodeChannelBlock(src, 0, rgba_block);
+                if (internal_format == InternalFormat::BC5_RG) {
+                    decodeChannelBlock(src + 8, 1, rgba_block);
+                }
+                break;
+            case InternalFormat::BC7_RGBA:
+                decodeBlockBC7(src, rgba_block);
+                break;
+            default:
+                break;
+            }
+        }
+
+        TextureMipChain compressMipChain(
+            TextureMipChain const& mip_chain,
+            GenericTextureLayout::InternalFormat internal_format,
+            EngineCore::Utility::TaskScheduler* task_scheduler)
+        {
+            TextureMipChain retval;
+
+            int channel_cnt = computeChannelCount(mip_chain.layout);
+
+            if (channel_cnt == 0 || !isBlockCompressed(internal_format) || mip_chain.levels.empty())
+                return retval;
+
+            retval.layout = mip_chain.layout;
+            retval.layout.internal_format = internal_format;
+            retval.layout.levels = static_cast<uint32_t>(mip_chain.levels.size());
+            retval.levels.resize(mip_chain.levels.size());
+
+            // split all levels into jobs of a few block rows each
+            struct Job
+            {
+                size_t level;
+                int    width;
+                int    height;
+                int    block_row_begin;
+                int    block_row_end;
+            };
+            std::vector<Job> jobs;
+
+            for (size_t level = 0; level < mip_chain.levels.size(); ++level)
+            {
+                int width = std::max(1, mip_chain.layout.width >> level);
+                int height = std::max(1, mip_chain.layout.height >> level);
+                int block_cnt_y = (height + 3) / 4;
+
+                retval.levels[level].resize(computeCompressedSize(internal_format, width, height));
+
+                for (int row = 0; row < block_cnt_y; row += block_rows_per_task) {
+                    jobs.push_back({ level, width, height, row, std::min(row + block_rows_per_task, block_cnt_y) });
+                }
+            }
+
+            auto execute = [&mip_chain, &retval, channel_cnt, internal_format](Job const& job) {
+                compressBlockRows(
+                    mip_chain.levels[job.level].data(),
+                    job.width,
+                    job.height,
+                    channel_cnt,
+                    internal_format,
+                    job.block_row_begin,
+                    job.block_row_end,
+                    retval.levels[job.level].data());
+            };
+
+            if (task_scheduler == nullptr)
+            {
+                for (auto const& job : jobs) {
+                    execute(job);
+                }
+            }
+            else
+            {
+                // wait for our own jobs only, other systems might be using the same scheduler
+                std::mutex completion_mutex;
+                std::condition_variable completion_cvar;
+                size_t open_jobs = jobs.size();
+
+                for (auto const& job : jobs)
+                {
+                    task_scheduler->submitTask([&execute, &job, &completion_mutex, &completion_cvar, &open_jobs]() {
+                        execute(job);
+
+                        std::unique_lock<std::mutex> lock(completion_mutex);
+                        if (--open_jobs == 0) {
+                            completion_cvar.notify_one();
+                        }
+                    });
+                }
+
+                std::unique_lock<std::mutex> lock(completion_mutex);
+                completion_cvar.wait(lock, [&open_jobs]() { return open_jobs == 0; });
+            }
+
+            return retval;
+        }
+
+        TextureMipChain decompressMipChain(TextureMipChain const& mip_chain)
+        {
+            TextureMipChain retval;
+
+            size_t block_size = computeBlockSize(mip_chain.layout.internal_format);
+
+            if (block_size == 0)
+                return retval;
+
+            retval.layout = mip_chain.layout;
+            retval.layout.internal_format = InternalFormat::RGBA8;
+            retval.layout.format = 0x1908; /*GL_RGBA*/
+            retval.layout.type = 0x1401; /*GL_UNSIGNED_BYTE*/
+            retval.levels.resize(mip_chain.levels.size());
+
+            uint8_t rgba_block[64];
+
+            for (size_t level = 0; level < mip_chain.levels.size(); ++level)
+            {
+                int width = std::max(1, mip_chain.layout.width >> level);
+                int height = std::max(1, mip_chain.layout.height >> level);
+                int block_cnt_x = (width + 3) / 4;
+                int block_cnt_y = (height + 3) / 4;
+
+                if (mip_chain.levels[level].size() < computeCompressedSize(mip_chain.layout.internal_format, width, height))
+                    return TextureMipChain();
+
+                retval.levels[level].resize(static_cast<size_t>(width) * height * 4);
+
+                for (int block_y = 0; block_y < block_cnt_y; ++block_y)
+                {
+                    for (int block_x = 0; block_x < block_cnt_x; ++block_x)
+                    {
+                        size_t block_idx = static_cast<size_t>(block_y) * block_cnt_x + block_x;
+                        decompressBlock(mip_chain.layout.internal_format, mip_chain.levels[level].data() + block_idx * block_size, rgba_block);
+
+                        for (int i = 0; i < 16; ++i)
+                        {
+                            int x = block_x * 4 + (i % 4);
+                            int y = block_y * 4 + (i / 4);
+                            if (x < width && y < height) {
+                                std::copy_n(rgba_block + i * 4, 4, retval.levels[level].data() + (static_cast<size_t>(y) * width + x) * 4);
+                            }
+                        }
+                    }
+                }
+            }
+
+            return retval;
+        }
+
+        namespace
+        {
+            constexpr char     mip_chain_file_magic[4] = { 'S','L','M','C' };
+            constexpr uint32_t mip_chain_file_version = 1;
+
+            template<typename T>
+            void writeValue(std::ofstream& file, T value)
+            {
+                file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+            }
+
+            template<typename T>
+            bool readValue(std::ifstream& file, T& value)
+            {
+                return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+            }
+        }
+
+        bool saveMipChain(std::string const& path, TextureMipChain const& mip_chain)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+            if (!file.is_open())
+                return false;
+
+            file.write(mip_chain_file_magic, 4);
+            writeValue(file, mip_chain_file_version);
+            writeValue(file, static_cast<uint32_t>(mip_chain.layout.internal_format));
+            writeValue(file, static_cast<int32_t>(mip_chain.layout.width));
+            writeValue(file, static_cast<int32_t>(mip_chain.layout.height));
+            writeValue(file, mip_chain.layout.format);
+            writeValue(file, mip_chain.layout.type);
+            writeValue(file, static_cast<uint32_t>(mip_chain.levels.size()));
+
+            for (auto const& level : mip_chain.levels)
+            {
+                writeValue(file, static_cast<uint64_t>(level.size()));
+                file.write(reinterpret_cast<char const*>(level.data()), level.size());
+            }
+
+            return static_cast<bool>(file);
+        }
+
+        bool loadMipChain(std::string const& path, TextureMipChain& mip_chain)
+        {
+            std::ifstream file(path, std::ios::binary);
+
+            if (!file.is_open())
+                return false;
+
+            char magic[4];
+            uint32_t version, internal_format, level_cnt;
+            int32_t width, height;
+            uint32_t format, type;
+
+            if (!file.read(magic, 4) || std::memcmp(magic, mip_chain_file_magic, 4) != 0)
+                return false;
+
+            if (!readValue(file, version) || version != mip_chain_file_version)
+                return false;
+
+            if (!readValue(file, internal_format) || !readValue(file, width) || !readValue(file, height)
+                || !readValue(file, format) || !readValue(file, type) || !readValue(file, level_cnt))
+                return false;
+
+            TextureMipChain retval;
+            retval.layout.internal_format = static_cast<InternalFormat>(internal_format);
+            retval.layout.width = width;
+            retval.layout.height = height;
+            retval.layout.depth = 1;
+            retval.layout.format = format;
+            retval.layout.type = type;
+            retval.layout.levels = level_cnt;
+            retval.levels.resize(level_cnt);
+
+            for (auto& level : retval.levels)
+            {
+                uint64_t size;
+                if (!readValue(file, size))
+                    return false;
+
+                level.resize(static_cast<size_t>(size));
+                if (!file.read(reinterpret_cast<char*>(level.data()), size))
+                    return false;
+            }
+
+            mip_chain = std::move(retval);
+
+            return true;
+        }
+    }
+}
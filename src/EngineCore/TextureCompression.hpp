@@ -0,0 +1,78 @@
+#ifndef TextureCompression_hpp
+#define TextureCompression_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GenericTextureLayout.hpp"
+#include "MipmapGeneration.hpp"
+#include "TaskScheduler.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \brief Returns true for the block compressed (BCn) internal formats
+        */
+        bool isBlockCompressed(GenericTextureLayout::InternalFormat internal_format);
+
+        /**
+        * \brief Returns the size of a single 4x4 block in bytes, or 0 if the format is not block compressed
+        */
+        size_t computeBlockSize(GenericTextureLayout::InternalFormat internal_format);
+
+        /**
+        * \brief Returns the size of an image of the given size in bytes when stored in the given block compressed format
+        */
+        size_t computeCompressedSize(GenericTextureLayout::InternalFormat internal_format, int width, int height);
+
+        /**
+        * \brief Encode a single 4x4 block.
+        * \param internal_format Target format, one of BC1_RGBA, BC3_RGBA, BC4_R, BC5_RG or BC7_RGBA
+        * \param rgba_block 16 RGBA8 texels in row-major order
+        * \param tgt Output, computeBlockSize(internal_format) bytes
+        */
+        void compressBlock(GenericTextureLayout::InternalFormat internal_format, uint8_t const* rgba_block, uint8_t* tgt);
+
+        /**
+        * \brief Decode a single 4x4 block to 16 RGBA8 texels. Only BC7 mode 6 blocks (the ones written by the encoder) are supported,
+        * blocks using other BC7 modes decode to zero.
+        */
+        void decompressBlock(GenericTextureLayout::InternalFormat internal_format, uint8_t const* src, uint8_t* rgba_block);
+
+        /**
+        * \brief Encode all levels of an uncompressed 8bit mip chain (see computeChannelCount) into a block compressed format.
+        * Missing source channels are read as 0 (green, blue) or 255 (alpha).
+        * \param mip_chain Source data
+        * \param internal_format Target format
+        * \param task_scheduler Optional task scheduler used to encode blocks in parallel. Don't call this from within a task
+        * that is running on the same scheduler.
+        * \return Returns the compressed mip chain, or an empty chain if the source layout is unsupported
+        */
+        TextureMipChain compressMipChain(
+            TextureMipChain const& mip_chain,
+            GenericTextureLayout::InternalFormat internal_format,
+            EngineCore::Utility::TaskScheduler* task_scheduler = nullptr);
+
+        /**
+        * \brief Decode all levels of a block compressed mip chain to RGBA8, e.g. for verifying encoder output without a GPU
+        */
+        TextureMipChain decompressMipChain(TextureMipChain const& mip_chain);
+
+        /**
+        * \brief Write a (compressed) mip chain to a binary cache file
+        * \return Returns false if the file could not be written
+        */
+        bool saveMipChain(std::string const& path, TextureMipChain const& mip_chain);
+
+        /**
+        * \brief Read a mip chain previously written with saveMipChain
+        * \return Returns false if the file doesn't exist or is not a valid cache file
+        */
+        bool loadMipChain(std::string const& path, TextureMipChain& mip_chain);
+    }
+}
+
+#endif // !TextureCompression_hpp
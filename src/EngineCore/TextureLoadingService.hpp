@@ -0,0 +1,246 @@
+#ifndef TextureLoadingService_hpp
+#define TextureLoadingService_hpp
+
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BaseResourceManager.hpp"
+#include "GenericTextureLayout.hpp"
+#include "MipmapGeneration.hpp"
+#include "ResourceLoading.hpp"
+#include "TaskScheduler.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \class TextureLoadingService
+        *
+        * \brief Decodes textures and builds their mip chains on worker threads.
+        *
+        * Complete mip chains are handed to the resource manager, which uploads them on the render thread.
+        * Requests are coalesced by name, i.e. concurrent (and later) requests for the same file or
+        * texture name return the same ResourceID and decode the data only once.
+        * The service uses its own worker threads, so that long running decode tasks never stall
+        * systems that synchronize on the engine's task scheduler.
+        */
+        template<typename ResourceManagerType>
+        class TextureLoadingService
+        {
+        public:
+            TextureLoadingService(ResourceManagerType* resource_manager, int worker_thread_cnt = 4);
+            ~TextureLoadingService();
+
+            TextureLoadingService(TextureLoadingService const& cpy) = delete;
+            TextureLoadingService& operator=(TextureLoadingService const& rhs) = delete;
+
+            /**
+            * \brief Load a png or ppm image file, generate its mip chain and create a 2D texture from it.
+            * \param path Location of the image file, also used as texture name
+            * \param filter Filter used for mip generation
+            * \param srgb Set for sRGB encoded colour textures, mip levels are then filtered in linear space
+            * \return Returns the id of the texture resource, which becomes READY once upload is done
+            */
+            ResourceID loadTexture2DAsync(std::string const& path, MipFilter filter = MipFilter::BOX, bool srgb = false);
+
+            /**
+            * \brief Generate the mip chain for already decoded image data and create a 2D texture from it.
+            * \param name Identifier for the texture
+            * \param layout Layout of the given image data
+            * \param data Texel data of the full resolution image
+            * \param filter Filter used for mip generation
+            * \param srgb Set for sRGB encoded colour textures, mip levels are then filtered in linear space
+            * \return Returns the id of the texture resource, which becomes READY once upload is done
+            */
+            ResourceID createTexture2DAsync(
+                std::string const& name,
+                GenericTextureLayout const& layout,
+                std::shared_ptr<std::vector<uint8_t>> const& data,
+                MipFilter filter = MipFilter::BOX,
+                bool srgb = false);
+
+            /**
+            * \brief Block until all submitted decode and mip generation tasks are done.
+            */
+            void waitWhileBusy();
+
+            /**
+            * \brief Worker threads of the service, e.g. for decoding the images of glTF models
+            * (see GltfAssetComponentManager::setTextureLoading)
+            */
+            EngineCore::Utility::TaskScheduler& accessTaskScheduler();
+
+        private:
+            /**
+            * Returns {true, existing id} if a request with the same name was already issued,
+            * otherwise allocates a new texture resource and returns {false, new id}.
+            */
+            std::pair<bool, ResourceID> coalesceRequest(std::string const& name);
+
+            void submitMipChain(ResourceID rsrc_id, std::string const& name, TextureMipChain& mip_chain);
+
+            /**
+            * Removes the request, so that later requests for the name try again, and makes the resource READY with a
+            * 1x1 magenta fallback texture, so that it doesn't stay NOT_READY.
+            */
+            void failRequest(ResourceID rsrc_id, std::string const& name);
+
+            ResourceManagerType* m_resource_mngr;
+
+            EngineCore::Utility::TaskScheduler m_task_scheduler;
+
+            /** Issued requests by texture name */
+            std::unordered_map<std::string, ResourceID> m_requests;
+            std::mutex m_requests_mutex;
+        };
+
+        template<typename ResourceManagerType>
+        inline TextureLoadingService<ResourceManagerType>::TextureLoadingService(ResourceManagerType* resource_manager, int worker_thread_cnt)
+            : m_resource_mngr(resource_manager)
+        {
+            m_task_scheduler.run(worker_thread_cnt);
+        }
+
+        template<typename ResourceManagerType>
+        inline TextureLoadingService<ResourceManagerType>::~TextureLoadingService()
+        {
+            m_task_scheduler.waitWhileBusy();
+            m_task_scheduler.stop();
+        }
+
+        template<typename ResourceManagerType>
+        inline ResourceID TextureLoadingService<ResourceManagerType>::loadTexture2DAsync(std::string const& path, MipFilter filter, bool srgb)
+        {
+            auto [existing, rsrc_id] = coalesceRequest(path);
+
+            if (existing)
+                return rsrc_id;
+
+            m_task_scheduler.submitTask([this, rsrc_id, path, filter, srgb]() {
+                TextureMipChain mip_chain;
+                mip_chain.levels.resize(1);
+
+                try
+                {
+                    auto extension = std::filesystem::path(path).extension().string();
+
+                    if (extension == ".png")
+                    {
+                        ResourceLoading::loadPngImage(path, mip_chain.levels[0], mip_chain.layout);
+                    }
+                    else if (extension == ".ppm")
+                    {
+                        ResourceLoading::loadPpmImage(path, mip_chain.levels[0], mip_chain.layout);
+                    }
+                    else
+                    {
+                        std::cerr << "TextureLoadingService - unsupported image format: " << path << std::endl;
+                        failRequest(rsrc_id, path);
+                        return;
+                    }
+                }
+                catch (std::runtime_error const& e)
+                {
+                    std::cerr << "TextureLoadingService - " << e.what() << std::endl;
+                    failRequest(rsrc_id, path);
+                    return;
+                }
+
+                generateMipChain(mip_chain, filter, srgb);
+
+                submitMipChain(rsrc_id, path, mip_chain);
+            });
+
+            return rsrc_id;
+        }
+
+        template<typename ResourceManagerType>
+        inline ResourceID TextureLoadingService<ResourceManagerType>::createTexture2DAsync(
+            std::string const& name,
+            GenericTextureLayout const& layout,
+            std::shared_ptr<std::vector<uint8_t>> const& data,
+            MipFilter filter,
+            bool srgb)
+        {
+            auto [existing, rsrc_id] = coalesceRequest(name);
+
+            if (existing)
+                return rsrc_id;
+
+            m_task_scheduler.submitTask([this, rsrc_id, name, layout, data, filter, srgb]() {
+                TextureMipChain mip_chain;
+                mip_chain.layout = layout;
+                mip_chain.levels.push_back(*data);
+
+                generateMipChain(mip_chain, filter, srgb);
+
+                submitMipChain(rsrc_id, name, mip_chain);
+            });
+
+            return rsrc_id;
+        }
+
+        template<typename ResourceManagerType>
+        inline void TextureLoadingService<ResourceManagerType>::waitWhileBusy()
+        {
+            m_task_scheduler.waitWhileBusy();
+        }
+
+        template<typename ResourceManagerType>
+        inline EngineCore::Utility::TaskScheduler& TextureLoadingService<ResourceManagerType>::accessTaskScheduler()
+        {
+            return m_task_scheduler;
+        }
+
+        template<typename ResourceManagerType>
+        inline std::pair<bool, ResourceID> TextureLoadingService<ResourceManagerType>::coalesceRequest(std::string const& name)
+        {
+            std::unique_lock<std::mutex> lock(m_requests_mutex);
+
+            auto query = m_requests.find(name);
+
+            if (query != m_requests.end())
+                return { true, query->second };
+
+            ResourceID rsrc_id = m_resource_mngr->allocateTexture2DAsync(name);
+            m_requests.insert({ name, rsrc_id });
+
+            return { false, rsrc_id };
+        }
+
+        template<typename ResourceManagerType>
+        inline void TextureLoadingService<ResourceManagerType>::submitMipChain(ResourceID rsrc_id, std::string const& name, TextureMipChain& mip_chain)
+        {
+            auto mip_levels = std::make_shared<std::vector<std::vector<uint8_t>>>(std::move(mip_chain.levels));
+
+            m_resource_mngr->updateTexture2DAsync(
+                rsrc_id,
+                name,
+                m_resource_mngr->convertGenericTextureLayout(mip_chain.layout),
+                mip_levels);
+        }
+
+        template<typename ResourceManagerType>
+        inline void TextureLoadingService<ResourceManagerType>::failRequest(ResourceID rsrc_id, std::string const& name)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_requests_mutex);
+                m_requests.erase(name);
+            }
+
+            TextureMipChain mip_chain;
+            mip_chain.layout = GenericTextureLayout(GenericTextureLayout::InternalFormat::RGBA8, 1, 1, 1, 0x1908 /*GL_RGBA*/, 0x1401 /*GL_UNSIGNED_BYTE*/, 1);
+            mip_chain.levels.push_back({ 255, 0, 255, 255 });
+
+            submitMipChain(rsrc_id, name, mip_chain);
+        }
+    }
+}
+
+#endif // !TextureLoadingService_hpp
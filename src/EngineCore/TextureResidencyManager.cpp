@@ -0,0 +1,243 @@
+#include "TextureResidencyManager.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        TextureResidencyManager::TextureResidencyManager(size_t budget_bytes, int tail_size)
+            : m_budget(budget_bytes), m_resident_bytes(0), m_tail_size(tail_size)
+        {
+        }
+
+        void TextureResidencyManager::setBudget(size_t budget_bytes)
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+            m_budget = budget_bytes;
+        }
+
+        size_t TextureResidencyManager::getBudget() const
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+            return m_budget;
+        }
+
+        size_t TextureResidencyManager::getResidentBytes() const
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+            return m_resident_bytes;
+        }
+
+        uint32_t TextureResidencyManager::registerTexture(unsigned int texture, int width, int height, std::vector<size_t> const& level_byte_sizes)
+        {
+            TextureState state;
+            state.width = width;
+            state.height = height;
+            state.level_byte_sizes = level_byte_sizes;
+            state.used = false;
+            state.last_used_frame = 0;
+
+            uint32_t level_cnt = static_cast<uint32_t>(level_byte_sizes.size());
+
+            state.tail_level = 0;
+            while (state.tail_level + 1 < level_cnt
+                && std::max(width >> state.tail_level, height >> state.tail_level) > m_tail_size)
+            {
+                ++state.tail_level;
+            }
+
+            state.first_level = state.tail_level;
+            state.requested_level = state.tail_level;
+
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+
+            auto query = m_textures.find(texture);
+            if (query != m_textures.end())
+            {
+                m_resident_bytes -= computeResidentBytes(query->second, query->second.first_level);
+                m_textures.erase(query);
+            }
+
+            m_resident_bytes += computeResidentBytes(state, state.first_level);
+            m_textures.insert({ texture, state });
+
+            return state.first_level;
+        }
+
+        void TextureResidencyManager::unregisterTexture(unsigned int texture)
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+
+            auto query = m_textures.find(texture);
+            if (query != m_textures.end())
+            {
+                m_resident_bytes -= computeResidentBytes(query->second, query->second.first_level);
+                m_textures.erase(query);
+            }
+        }
+
+        void TextureResidencyManager::reportUsage(unsigned int texture, float screen_size)
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+
+            auto query = m_textures.find(texture);
+            if (query == m_textures.end())
+                return;
+
+            auto& state = query->second;
+            uint32_t level = computeRequiredLevel(state.width, state.height, screen_size, static_cast<uint32_t>(state.level_byte_sizes.size()));
+
+            state.requested_level = state.used ? std::min(state.requested_level, level) : level;
+            state.requested_level = std::min(state.requested_level, state.tail_level);
+            state.used = true;
+        }
+
+        std::vector<TextureResidencyManager::ResidencyChange> TextureResidencyManager::update(uint64_t frame_id)
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+
+            // previous first level of each texture changed during this update, ordered for deterministic output
+            std::map<unsigned int, uint32_t> changed;
+
+            auto setFirstLevel = [this, &changed](unsigned int texture, TextureState& state, uint32_t level) {
+                changed.insert({ texture, state.first_level });
+                m_resident_bytes -= computeResidentBytes(state, state.first_level);
+                m_resident_bytes += computeResidentBytes(state, level);
+                state.first_level = level;
+            };
+
+            // lowest level a texture can be downgraded to in this update without degrading anything visible right now
+            auto evictionLevel = [](TextureState const& state) {
+                return state.used ? state.requested_level : state.tail_level;
+            };
+
+            std::vector<unsigned int> upgrades;
+            std::vector<unsigned int> eviction_candidates;
+
+            for (auto& texture : m_textures)
+            {
+                if (texture.second.used)
+                {
+                    texture.second.last_used_frame = frame_id;
+
+                    if (texture.second.requested_level < texture.second.first_level) {
+                        upgrades.push_back(texture.first);
+                    }
+                }
+
+                if (texture.second.first_level < evictionLevel(texture.second)) {
+                    eviction_candidates.push_back(texture.first);
+                }
+            }
+
+            // least recently used textures are evicted first
+            std::sort(eviction_candidates.begin(), eviction_candidates.end(), [this](unsigned int lhs, unsigned int rhs) {
+                auto const& l = m_textures.at(lhs);
+                auto const& r = m_textures.at(rhs);
+                return l.last_used_frame != r.last_used_frame ? l.last_used_frame < r.last_used_frame : lhs < rhs;
+            });
+
+            // textures with the largest gap between resident and requested level are upgraded first
+            std::sort(upgrades.begin(), upgrades.end(), [this](unsigned int lhs, unsigned int rhs) {
+                auto const& l = m_textures.at(lhs);
+                auto const& r = m_textures.at(rhs);
+                uint32_t l_gap = l.first_level - l.requested_level;
+                uint32_t r_gap = r.first_level - r.requested_level;
+                return l_gap != r_gap ? l_gap > r_gap : lhs < rhs;
+            });
+
+            size_t next_eviction = 0;
+
+            auto evictUntil = [&](size_t required_bytes, unsigned int keep) {
+                while (m_resident_bytes + required_bytes > m_budget && next_eviction < eviction_candidates.size())
+                {
+                    unsigned int texture = eviction_candidates[next_eviction++];
+                    if (texture == keep)
+                        continue;
+
+                    auto& state = m_textures.at(texture);
+                    uint32_t level = evictionLevel(state);
+                    if (state.first_level < level) {
+                        setFirstLevel(texture, state, level);
+                    }
+                }
+            };
+
+            for (auto texture : upgrades)
+            {
+                auto& state = m_textures.at(texture);
+
+                size_t current_bytes = computeResidentBytes(state, state.first_level);
+
+                evictUntil(computeResidentBytes(state, state.requested_level) - current_bytes, texture);
+
+                // take the finest level that fits into the budget, possibly less than requested
+                for (uint32_t level = state.requested_level; level < state.first_level; ++level)
+                {
+                    if (m_resident_bytes + computeResidentBytes(state, level) - current_bytes <= m_budget)
+                    {
+                        setFirstLevel(texture, state, level);
+                        break;
+                    }
+                }
+            }
+
+            // the budget might have been reduced since the last update
+            evictUntil(0, std::numeric_limits<unsigned int>::max());
+
+            for (auto& texture : m_textures)
+            {
+                texture.second.used = false;
+                texture.second.requested_level = texture.second.tail_level;
+            }
+
+            std::vector<ResidencyChange> retval;
+            for (auto const& change : changed)
+            {
+                uint32_t first_level = m_textures.at(change.first).first_level;
+                if (first_level != change.second) {
+                    retval.push_back({ change.first, first_level, change.second });
+                }
+            }
+
+            return retval;
+        }
+
+        uint32_t TextureResidencyManager::getFirstResidentLevel(unsigned int texture) const
+        {
+            std::unique_lock<std::mutex> lock(m_textures_mutex);
+
+            auto query = m_textures.find(texture);
+            return query != m_textures.end() ? query->second.first_level : 0;
+        }
+
+        uint32_t TextureResidencyManager::computeRequiredLevel(int width, int height, float screen_size, uint32_t level_cnt)
+        {
+            if (level_cnt == 0)
+                return 0;
+
+            float texture_size = static_cast<float>(std::max(width, height));
+
+            if (!(screen_size > 0.0f))
+                return level_cnt - 1;
+
+            // one texel per pixel, i.e. level = log2(texture size / screen size), rounded towards the finer level
+            float level = std::floor(std::log2(texture_size / screen_size));
+
+            return static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(level_cnt - 1)));
+        }
+
+        size_t TextureResidencyManager::computeResidentBytes(TextureState const& state, uint32_t first_level)
+        {
+            size_t retval = 0;
+            for (size_t level = first_level; level < state.level_byte_sizes.size(); ++level) {
+                retval += state.level_byte_sizes[level];
+            }
+            return retval;
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef TextureResidencyManager_hpp
+#define TextureResidencyManager_hpp
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \class TextureResidencyManager
+        *
+        * \brief Decides which mip levels of streamed textures should be resident in GPU memory.
+        *
+        * Textures are identified by an integer key (e.g. ResourceID::value()). Each texture keeps a contiguous range of
+        * mip levels resident, from its first resident level down to the smallest level. The mip tail (all levels up to
+        * a configurable size) is always resident, so that every registered texture can be sampled at any time.
+        * Per frame, renderers report the screen space size of texture usages. On update, textures are upgraded to the
+        * level matching their largest on-screen size, as long as the byte budget allows it. If it doesn't, textures that
+        * haven't been used for the longest time are downgraded first (LRU).
+        *
+        * The class contains no graphics API calls, residency changes are returned to the caller which applies them.
+        */
+        class TextureResidencyManager
+        {
+        public:
+            struct ResidencyChange
+            {
+                unsigned int texture;          ///< Texture key
+                uint32_t     first_level;      ///< New first resident mip level
+                uint32_t     prev_first_level; ///< Previous first resident mip level
+            };
+
+            /**
+            * \param budget_bytes Maximum number of bytes of all resident mip levels. Mip tails stay resident even if they exceed the budget.
+            * \param tail_size Mip levels with width and height less or equal to this size belong to the always resident mip tail
+            */
+            TextureResidencyManager(size_t budget_bytes, int tail_size = 64);
+            ~TextureResidencyManager() = default;
+
+            void setBudget(size_t budget_bytes);
+
+            size_t getBudget() const;
+
+            /**
+            * \brief Returns the number of bytes of all currently resident levels, including mip tails
+            */
+            size_t getResidentBytes() const;
+
+            /**
+            * \brief Register a texture, initially only its mip tail is resident
+            * \param texture Texture key
+            * \param width Width of level 0
+            * \param height Height of level 0
+            * \param level_byte_sizes Byte size of each mip level, starting with level 0
+            * \return Returns the initially resident first level
+            */
+            uint32_t registerTexture(unsigned int texture, int width, int height, std::vector<size_t> const& level_byte_sizes);
+
+            void unregisterTexture(unsigned int texture);
+
+            /**
+            * \brief Report a usage of a texture in the current frame. Thread-safe.
+            * \param texture Texture key
+            * \param screen_size Approximate size of the textured surface on screen in pixels
+            */
+            void reportUsage(unsigned int texture, float screen_size);
+
+            /**
+            * \brief Resolve all usages reported since the last update into residency changes
+            * \param frame_id Id of the current frame, used for LRU ordering
+            * \return Returns all textures whose first resident level changed
+            */
+            std::vector<ResidencyChange> update(uint64_t frame_id);
+
+            /**
+            * \brief Returns the first resident level of a texture, or 0 if the texture is unknown
+            */
+            uint32_t getFirstResidentLevel(unsigned int texture) const;
+
+            /**
+            * \brief Returns the mip level required to draw a surface of the given screen size without undersampling
+            */
+            static uint32_t computeRequiredLevel(int width, int height, float screen_size, uint32_t level_cnt);
+
+        private:
+            struct TextureState
+            {
+                int                 width;
+                int                 height;
+                std::vector<size_t> level_byte_sizes;
+                uint32_t            tail_level;      ///< First level of the mip tail
+                uint32_t            first_level;     ///< First currently resident level
+                uint32_t            requested_level; ///< Finest level requested since the last update
+                bool                used;            ///< Texture was used since the last update
+                uint64_t            last_used_frame;
+            };
+
+            /**
+            * Sum of byte sizes of levels [first_level, level_cnt)
+            */
+            static size_t computeResidentBytes(TextureState const& state, uint32_t first_level);
+
+            std::unordered_map<unsigned int, TextureState> m_textures;
+            mutable std::mutex                              m_textures_mutex;
+
+            size_t m_budget;
+            size_t m_resident_bytes;
+            int    m_tail_size;
+        };
+    }
+}
+
+#endif // !TextureResidencyManager_hpp
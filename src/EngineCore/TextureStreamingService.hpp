@@ -0,0 +1,235 @@
+#ifndef TextureStreamingService_hpp
+#define TextureStreamingService_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BaseResourceManager.hpp"
+#include "MipmapGeneration.hpp"
+#include "TextureResidencyManager.hpp"
+
+namespace EngineCore
+{
+    namespace Graphics
+    {
+        /**
+        * \class TextureStreamingService
+        *
+        * \brief Keeps the CPU-side mip chains of streamed 2D textures and (re-)uploads the mip levels chosen by a TextureResidencyManager.
+        *
+        * The texture storage only contains the resident levels, so the budget limits the allocated GPU memory. On each
+        * residency change the texture is reallocated, newly resident levels are uploaded and levels that stay resident are
+        * copied on the GPU. The reallocation replaces the texture object and its bindless handle, renderers have to query
+        * handles each frame. Downgrades are sampled right away by clamping to the levels given by getMinLod.
+        * The resource manager only needs to provide allocateTexture2DAsync, updateTexture2DLevelsAsync and convertGenericTextureLayout,
+        * so residency behaviour can be tested with a fake resource manager that records uploads.
+        */
+        template<typename ResourceManagerType>
+        class TextureStreamingService
+        {
+        public:
+            typedef std::shared_ptr<TextureMipChain const> MipChainPtr;
+
+            /**
+            * \param resource_manager Resource manager used for texture creation and upload
+            * \param budget_bytes Byte budget for all streamed textures
+            */
+            TextureStreamingService(ResourceManagerType* resource_manager, size_t budget_bytes);
+            ~TextureStreamingService() = default;
+
+            TextureStreamingService(TextureStreamingService const& cpy) = delete;
+            TextureStreamingService& operator=(TextureStreamingService const& rhs) = delete;
+
+            /**
+            * \brief Create a streamed 2D texture. Only the mip tail is uploaded right away.
+            * \param name Identifier for the texture
+            * \param mip_chain Complete mip chain of the texture, kept in memory for later uploads
+            * \param int_parameters Integer texture parameters applied when the texture storage is allocated (e.g. filter modes)
+            * \param float_parameters Float texture parameters applied when the texture storage is allocated
+            * \return Returns the id of the texture resource
+            */
+            ResourceID addTexture2D(
+                std::string const& name,
+                MipChainPtr const& mip_chain,
+                std::vector<std::pair<uint32_t, int>> const& int_parameters = {},
+                std::vector<std::pair<uint32_t, float>> const& float_parameters = {});
+
+            /**
+            * \brief Report that a texture is used to draw a surface of the given size on screen in pixels. Thread-safe.
+            */
+            void reportUsage(ResourceID texture, float screen_size);
+
+            /**
+            * \brief Apply residency decisions for all usages reported since the last update.
+            * Typically called once per frame after draw lists are built.
+            */
+            void update(uint64_t frame_id);
+
+            /**
+            * \brief Get the finest mip level of the current texture storage that should be sampled. Levels of the storage
+            * are only excluded between a downgrade and the reallocation of the texture. Returns 0 for textures that are not streamed.
+            */
+            float getMinLod(ResourceID texture);
+
+            TextureResidencyManager& accessResidencyManager();
+
+        private:
+            struct StreamedTexture
+            {
+                ResourceID                              rsrc_id;
+                std::string                             name;
+                MipChainPtr                             mip_chain;
+                std::vector<std::pair<uint32_t, int>>   int_parameters;
+                std::vector<std::pair<uint32_t, float>> float_parameters;
+
+                uint32_t                               first_level;   ///< Latest residency decision
+                uint32_t                               queued_level;  ///< First level of the storage of the latest reallocation issued
+                std::shared_ptr<std::atomic<uint32_t>> storage_level; ///< First level of the current storage, written on the render thread
+            };
+
+            /**
+            * \brief Apply a residency decision, reallocates the texture with the levels from first_level on
+            */
+            void applyFirstLevel(StreamedTexture& texture, uint32_t first_level);
+
+            ResourceManagerType*    m_resource_mngr;
+            TextureResidencyManager m_residency_mngr;
+
+            std::unordered_map<unsigned int, StreamedTexture> m_textures;
+            std::shared_mutex                                 m_textures_mutex;
+        };
+
+        template<typename ResourceManagerType>
+        inline TextureStreamingService<ResourceManagerType>::TextureStreamingService(ResourceManagerType* resource_manager, size_t budget_bytes)
+            : m_resource_mngr(resource_manager), m_residency_mngr(budget_bytes)
+        {
+        }
+
+        template<typename ResourceManagerType>
+        inline ResourceID TextureStreamingService<ResourceManagerType>::addTexture2D(
+            std::string const& name,
+            MipChainPtr const& mip_chain,
+            std::vector<std::pair<uint32_t, int>> const& int_parameters,
+            std::vector<std::pair<uint32_t, float>> const& float_parameters)
+        {
+            ResourceID rsrc_id = m_resource_mngr->allocateTexture2DAsync(name);
+
+            if (mip_chain == nullptr || mip_chain->levels.empty())
+                return rsrc_id;
+
+            uint32_t level_cnt = static_cast<uint32_t>(mip_chain->levels.size());
+
+            StreamedTexture texture{
+                rsrc_id, name, mip_chain, int_parameters, float_parameters,
+                level_cnt, level_cnt, std::make_shared<std::atomic<uint32_t>>(level_cnt) };
+
+            std::unique_lock<std::shared_mutex> lock(m_textures_mutex);
+
+            auto insertion = m_textures.insert({ rsrc_id.value(), texture });
+            if (!insertion.second)
+                return rsrc_id;
+
+            std::vector<size_t> level_byte_sizes;
+            for (auto const& level : mip_chain->levels) {
+                level_byte_sizes.push_back(level.size());
+            }
+
+            uint32_t first_level = m_residency_mngr.registerTexture(
+                rsrc_id.value(), mip_chain->layout.width, mip_chain->layout.height, level_byte_sizes);
+
+            applyFirstLevel(insertion.first->second, first_level);
+
+            return rsrc_id;
+        }
+
+        template<typename ResourceManagerType>
+        inline void TextureStreamingService<ResourceManagerType>::reportUsage(ResourceID texture, float screen_size)
+        {
+            m_residency_mngr.reportUsage(texture.value(), screen_size);
+        }
+
+        template<typename ResourceManagerType>
+        inline void TextureStreamingService<ResourceManagerType>::update(uint64_t frame_id)
+        {
+            auto changes = m_residency_mngr.update(frame_id);
+
+            std::unique_lock<std::shared_mutex> lock(m_textures_mutex);
+
+            for (auto const& change : changes)
+            {
+                auto query = m_textures.find(change.texture);
+                if (query != m_textures.end()) {
+                    applyFirstLevel(query->second, change.first_level);
+                }
+            }
+        }
+
+        template<typename ResourceManagerType>
+        inline float TextureStreamingService<ResourceManagerType>::getMinLod(ResourceID texture)
+        {
+            std::shared_lock<std::shared_mutex> lock(m_textures_mutex);
+
+            auto query = m_textures.find(texture.value());
+            if (query == m_textures.end())
+                return 0.0f;
+
+            uint32_t storage_level = query->second.storage_level->load();
+            uint32_t level_cnt = static_cast<uint32_t>(query->second.mip_chain->levels.size());
+
+            if (storage_level >= level_cnt)
+                return 0.0f;
+
+            // a downgrade applies right away, an upgrade once the texture is reallocated
+            return static_cast<float>(std::max(query->second.first_level, storage_level) - storage_level);
+        }
+
+        template<typename ResourceManagerType>
+        inline TextureResidencyManager& TextureStreamingService<ResourceManagerType>::accessResidencyManager()
+        {
+            return m_residency_mngr;
+        }
+
+        template<typename ResourceManagerType>
+        inline void TextureStreamingService<ResourceManagerType>::applyFirstLevel(StreamedTexture& texture, uint32_t first_level)
+        {
+            texture.first_level = first_level;
+
+            if (first_level == texture.queued_level)
+                return;
+
+            auto const& mip_chain = *texture.mip_chain;
+
+            GenericTextureLayout layout = mip_chain.layout;
+            layout.levels = static_cast<uint32_t>(mip_chain.levels.size());
+            layout.int_parameters = texture.int_parameters;
+            layout.float_parameters = texture.float_parameters;
+
+            // only upload levels that are not in the previous storage, a downgrade copies all its levels
+            uint32_t upload_end = std::max(first_level, texture.queued_level);
+            auto levels = std::make_shared<std::vector<std::vector<uint8_t>>>(
+                mip_chain.levels.begin() + first_level, mip_chain.levels.begin() + upload_end);
+
+            uint32_t prev_first_level = texture.queued_level;
+            texture.queued_level = first_level;
+
+            // reallocations are executed in order, each one starts from the storage of the previous one
+            auto storage_level = texture.storage_level;
+
+            m_resource_mngr->updateTexture2DLevelsAsync(
+                texture.rsrc_id,
+                texture.name,
+                m_resource_mngr->convertGenericTextureLayout(layout),
+                first_level,
+                prev_first_level,
+                levels,
+                [storage_level, first_level]() { storage_level->store(first_level); });
+        }
+    }
+}
+
+#endif // !TextureStreamingService_hpp
@@ -1,5 +1,8 @@
 #include "TransformComponentManager.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace EngineCore
 {
     namespace Common
@@ -22,6 +25,7 @@ namespace EngineCore
                     scale,
                     0,
                     0,
+                    0,
                     0
                 }
             );
@@ -43,6 +47,56 @@ namespace EngineCore
             return index;
         }
 
+        std::vector<size_t> TransformComponentManager::addComponents(
+            std::vector<Entity> const& entities,
+            std::vector<Vec3> const& positions,
+            std::vector<Quat> const& orientations,
+            std::vector<Vec3> const& scales)
+        {
+            assert(entities.size() == positions.size() && entities.size() == orientations.size() && entities.size() == scales.size());
+
+            std::vector<Data> components;
+            components.reserve(entities.size());
+
+            uint64_t version = ++version_;
+
+            for (size_t i = 0; i < entities.size(); ++i)
+            {
+                // components don't have a parent yet, so the world transform is the local transform
+                Mat4x4 xform = glm::toMat4(orientations[i]);
+                xform[3] = Vec4(positions[i], 1.0);
+                xform[0] *= scales[i].x;
+                xform[1] *= scales[i].y;
+                xform[2] *= scales[i].z;
+
+                components.push_back({ entities[i], xform, positions[i], orientations[i], scales[i], 0, 0, 0, version });
+            }
+
+            auto indices = data_.addComponents(std::move(components));
+
+            size_t locked_page_idx = (std::numeric_limits<size_t>::max)();
+            std::unique_lock<std::shared_mutex> lock;
+
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                addIndex(entities[i].id(), indices[i]);
+
+                auto [page_idx, idx_in_page] = data_.getIndices(indices[i]);
+
+                if (page_idx != locked_page_idx)
+                {
+                    lock = data_.accquirePageLock(page_idx);
+                    locked_page_idx = page_idx;
+                }
+
+                data_(page_idx, idx_in_page).parent = indices[i];
+                data_(page_idx, idx_in_page).first_child = indices[i];
+                data_(page_idx, idx_in_page).next_sibling = indices[i];
+            }
+
+            return indices;
+        }
+
         void TransformComponentManager::deleteComonent(Entity entity)
         {
             auto query = getIndex(entity);
@@ -134,6 +188,8 @@ namespace EngineCore
                 data_(page_idx, idx_in_page).world_transform = xform;
             }
 
+            data_(page_idx, idx_in_page).version = ++version_;
+
             // update transforms of all children
             size_t child_idx = data_(page_idx, idx_in_page).first_child;
             if (child_idx != index)
@@ -245,6 +301,73 @@ namespace EngineCore
 
         }
 
+        void TransformComponentManager::setLocalTransforms(
+            std::vector<size_t> const& indices,
+            std::vector<Vec3> const& positions,
+            std::vector<Quat> const& orientations,
+            std::vector<Vec3> const& scales)
+        {
+            assert(indices.size() == positions.size() && indices.size() == orientations.size() && indices.size() == scales.size());
+
+            {
+                size_t locked_page_idx = (std::numeric_limits<size_t>::max)();
+                std::unique_lock<std::shared_mutex> lock;
+
+                for (size_t i = 0; i < indices.size(); ++i)
+                {
+                    auto [page_idx, idx_in_page] = data_.getIndices(indices[i]);
+
+                    if (page_idx != locked_page_idx)
+                    {
+                        lock = data_.accquirePageLock(page_idx);
+                        locked_page_idx = page_idx;
+                    }
+
+                    data_(page_idx, idx_in_page).position = positions[i];
+                    data_(page_idx, idx_in_page).orientation = orientations[i];
+                    data_(page_idx, idx_in_page).scale = scales[i];
+                }
+            }
+
+            // transform() updates the whole subtree, so skip components that have an updated ancestor
+            size_t max_index = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+            std::vector<bool> is_updated(max_index + 1, false);
+            for (size_t index : indices) {
+                is_updated[index] = true;
+            }
+
+            for (size_t index : indices)
+            {
+                bool has_updated_ancestor = false;
+
+                size_t current_idx = index;
+                for (;;)
+                {
+                    size_t parent_idx;
+                    {
+                        auto [page_idx, idx_in_page] = data_.getIndices(current_idx);
+                        auto lock = data_.accquirePageLock(page_idx);
+                        parent_idx = data_(page_idx, idx_in_page).parent;
+                    }
+
+                    if (parent_idx == current_idx)
+                        break;
+
+                    if (parent_idx <= max_index && is_updated[parent_idx])
+                    {
+                        has_updated_ancestor = true;
+                        break;
+                    }
+
+                    current_idx = parent_idx;
+                }
+
+                if (!has_updated_ancestor) {
+                    transform(index);
+                }
+            }
+        }
+
         Vec3 const& TransformComponentManager::getPosition(size_t index) const
         {
             auto [page_idx, idx_in_page] = data_.getIndices(index);
@@ -283,6 +406,15 @@ namespace EngineCore
             return data_(page_idx, idx_in_page).orientation;
         }
 
+        Vec3 const& TransformComponentManager::getScale(size_t index) const
+        {
+            auto [page_idx, idx_in_page] = data_.getIndices(index);
+
+            auto lock = data_.accquirePageLock(page_idx);
+
+            return data_(page_idx, idx_in_page).scale;
+        }
+
         Mat4x4 const& TransformComponentManager::getWorldTransformation(size_t index) const
         {
             auto [page_idx, idx_in_page] = data_.getIndices(index);
@@ -355,5 +487,49 @@ namespace EngineCore
 
             return retval;
         }
+
+        Entity TransformComponentManager::getEntity(size_t index) const
+        {
+            auto [page_idx, idx_in_page] = data_.getIndices(index);
+
+            auto lock = data_.accquirePageLock(page_idx);
+
+            return data_(page_idx, idx_in_page).entity;
+        }
+
+        uint64_t TransformComponentManager::getVersion() const
+        {
+            return version_.load();
+        }
+
+        uint64_t TransformComponentManager::getModifiedComponents(uint64_t since_version, std::vector<size_t>& indices) const
+        {
+            // read the counter first, updates that happen during the scan are reported (again) by the next call
+            uint64_t version = version_.load();
+
+            indices.clear();
+
+            size_t component_cnt = data_.getComponentCount();
+
+            size_t locked_page_idx = (std::numeric_limits<size_t>::max)();
+            std::unique_lock<std::shared_mutex> lock;
+
+            for (size_t index = 0; index < component_cnt; ++index)
+            {
+                auto [page_idx, idx_in_page] = data_.getIndices(index);
+
+                if (page_idx != locked_page_idx)
+                {
+                    lock = data_.accquirePageLock(page_idx);
+                    locked_page_idx = page_idx;
+                }
+
+                if (data_(page_idx, idx_in_page).version > since_version) {
+                    indices.push_back(index);
+                }
+            }
+
+            return version;
+        }
     }
-}
\ No newline at end of file
+}
@@ -8,6 +8,7 @@
 #include "types.hpp"
 
 // std includes
+#include <atomic>
 #include <unordered_map>
 #include <iostream>
 #include <shared_mutex>
@@ -30,11 +31,16 @@ namespace EngineCore
                 size_t parent;          ///< index to parent (equals components own index if comp. has no parent)
                 size_t first_child;     ///< index to child (...)
                 size_t next_sibling;    ///< index to sibling (...)
+
+                uint64_t version;       ///< value of the modification counter when the world transform was last updated
             };
         private:
 
             Utility::ComponentStorage<Data, 100000, 1000> data_;
 
+            /** Incremented for every world transform update, components store the value of their last update */
+            std::atomic_uint64_t version_ = std::atomic_uint64_t{ 0 };
+
             void transform(size_t index);
 
         public:
@@ -43,6 +49,17 @@ namespace EngineCore
 
             size_t addComponent(Entity entity, Vec3 position = Vec3(), Quat orientation = Quat(), Vec3 scale = Vec3(1.0));
 
+            /**
+             * Add components without parents for multiple entities at once, e.g. when loading levels.
+             * All input vectors need to have the same size.
+             * \return Returns the component indices in the order of the input
+             */
+            std::vector<size_t> addComponents(
+                std::vector<Entity> const& entities,
+                std::vector<Vec3> const& positions,
+                std::vector<Quat> const& orientations,
+                std::vector<Vec3> const& scales);
+
             void deleteComonent(Entity entity);
 
             size_t getComponentCount() const;
@@ -67,6 +84,17 @@ namespace EngineCore
 
             void setParent(size_t index, Entity parent);
 
+            /**
+             * Set the local transformations of multiple components at once, e.g. the joints of animated skeletons.
+             * World transformations are only recomputed once per updated subtree.
+             * All input vectors need to have the same size.
+             */
+            void setLocalTransforms(
+                std::vector<size_t> const& indices,
+                std::vector<Vec3> const& positions,
+                std::vector<Quat> const& orientations,
+                std::vector<Vec3> const& scales);
+
             Vec3 const& getPosition(size_t index) const;
 
             Vec3 getWorldPosition(size_t index) const;
@@ -75,6 +103,8 @@ namespace EngineCore
 
             Quat const& getOrientation(size_t index) const;
 
+            Vec3 const& getScale(size_t index) const;
+
             Mat4x4 const& getWorldTransformation(size_t index) const;
 
             std::vector<Entity> getChildren(Entity entity) const;
@@ -82,6 +112,21 @@ namespace EngineCore
             std::vector<Entity> getChildren(size_t index) const;
 
             Entity getParent(size_t index) const;
+
+            Entity getEntity(size_t index) const;
+
+            /**
+             * Current value of the modification counter, see getModifiedComponents.
+             */
+            uint64_t getVersion() const;
+
+            /**
+             * Collect the components whose world transform changed after the given version, i.e. the dirty
+             * components of a system that last synchronized at that version. Each system keeps its own version, so
+             * any number of systems can track changes independently.
+             * \return Returns the version to pass to the next call
+             */
+            uint64_t getModifiedComponents(uint64_t since_version, std::vector<size_t>& indices) const;
         };
     }
 }
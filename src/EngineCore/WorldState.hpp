@@ -30,6 +30,12 @@ namespace EngineCore
         template <typename ComponentManagerType>
         ComponentManagerType & get();
 
+        /**
+         * Returns true if a component manager of the given type was added
+         */
+        template <typename ComponentManagerType>
+        bool has() const;
+
         /**
          *
          */
@@ -55,7 +61,7 @@ namespace EngineCore
          */
         std::unordered_map<int, std::unique_ptr<BaseComponentManager>> m_component_managers;
 
-        std::shared_mutex m_component_access_mutex;
+        mutable std::shared_mutex m_component_access_mutex;
 
         /** 
          *
@@ -105,6 +111,14 @@ namespace EngineCore
         return (*(static_cast<ComponentManagerType*>(it->second.get())));
     }
 
+    template <typename ComponentManagerType>
+    inline bool WorldState::has() const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_component_access_mutex);
+
+        return m_component_managers.find(getTypeId<ComponentManagerType>()) != m_component_managers.end();
+    }
+
     template <class ComponentManagerType>
     inline void WorldState::add(std::unique_ptr<BaseComponentManager> &&component_mngr)
     {
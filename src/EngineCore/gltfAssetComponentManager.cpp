@@ -1,6 +1,11 @@
 #include "gltfAssetComponentManager.hpp"
 
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+
+#include "TextureCompression.hpp"
 
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -8,13 +13,43 @@
 #define STBI_MSC_SECURE_CRT
 #include "tiny_gltf.h"
 
-std::shared_ptr<tinygltf::Model> EngineCore::Graphics::Utility::loadGltfModel(std::string const & gltf_filepath)
+namespace
+{
+    /** Encoded image data by image index, collected while parsing a glTF file */
+    typedef std::unordered_map<int, std::vector<unsigned char>> EncodedImages;
+
+    /** Image loader for tinygltf that only copies the encoded data, which is decoded after parsing */
+    bool deferImageDecoding(
+        tinygltf::Image* image,
+        int const image_idx,
+        std::string* err,
+        std::string* warn,
+        int req_width,
+        int req_height,
+        unsigned char const* bytes,
+        int size,
+        void* user_data)
+    {
+        auto encoded_images = static_cast<EncodedImages*>(user_data);
+        (*encoded_images)[image_idx].assign(bytes, bytes + size);
+        return true;
+    }
+}
+
+std::shared_ptr<tinygltf::Model> EngineCore::Graphics::Utility::loadGltfModel(
+    std::string const& gltf_filepath,
+    EngineCore::Utility::TaskScheduler* image_decode_scheduler)
 {
     std::shared_ptr<tinygltf::Model> model = std::make_shared<tinygltf::Model>();
     tinygltf::TinyGLTF loader;
     std::string err;
     std::string warn;
 
+    EncodedImages encoded_images;
+    if (image_decode_scheduler != nullptr) {
+        loader.SetImageLoader(deferImageDecoding, &encoded_images);
+    }
+
     auto ret = loader.LoadASCIIFromFile(
         model.get(),
         &err,
@@ -35,6 +70,27 @@ std::shared_ptr<tinygltf::Model> EngineCore::Graphics::Utility::loadGltfModel(st
         return nullptr;
     }
 
+    // one image per task, encoded_images and the model are not modified while the tasks run
+    for (auto& encoded_image : encoded_images)
+    {
+        int image_idx = encoded_image.first;
+        auto& image = model->images[image_idx];
+        auto const& data = encoded_image.second;
+
+        image_decode_scheduler->submitTask([&image, &data, image_idx, gltf_filepath]() {
+            std::string decode_err;
+            std::string decode_warn;
+
+            if (!tinygltf::LoadImageData(&image, image_idx, &decode_err, &decode_warn, 0, 0, data.data(), static_cast<int>(data.size()), nullptr)) {
+                std::cerr << "Failed to decode image " << image_idx << " of " << gltf_filepath << ": " << decode_err << std::endl;
+            }
+        });
+    }
+
+    if (!encoded_images.empty()) {
+        image_decode_scheduler->waitWhileBusy();
+    }
+
     return model;
 }
 
@@ -56,7 +112,7 @@ std::shared_ptr<tinygltf::Model> EngineCore::Graphics::GltfAssetComponentManager
 
     // if model not found in cache, load and add now
     if (retval == nullptr) {
-        retval = Utility::loadGltfModel(gltf_filepath);
+        retval = Utility::loadGltfModel(gltf_filepath, m_load_texture ? m_image_decode_scheduler : nullptr);
 
         std::unique_lock<std::shared_mutex> lock(m_gltf_models_mutex);
         m_gltf_models.insert(std::make_pair(gltf_filepath, retval));
@@ -105,4 +161,229 @@ std::vector<EngineCore::Graphics::GltfAssetComponentManager::ComponentData> Engi
         retval = m_data;
     }
     return retval;
-}
\ No newline at end of file
+}
+
+EngineCore::Graphics::GltfAssetComponentManager::~GltfAssetComponentManager()
+{
+    if (m_texture_compression_enabled) {
+        m_texture_compression_scheduler.stop();
+    }
+}
+
+void EngineCore::Graphics::GltfAssetComponentManager::setTextureCompression(int worker_thread_cnt, std::string const& cache_directory)
+{
+    if (m_texture_compression_enabled) {
+        m_texture_compression_scheduler.stop();
+    }
+
+    m_texture_compression_enabled = worker_thread_cnt > 0;
+    m_compressed_texture_cache_dir = cache_directory;
+
+    if (m_texture_compression_enabled) {
+        m_texture_compression_scheduler.run(worker_thread_cnt);
+    }
+}
+
+bool EngineCore::Graphics::GltfAssetComponentManager::isTextureCompressionEnabled() const
+{
+    return m_texture_compression_enabled;
+}
+
+namespace
+{
+    /** Layout of a glTF image as encoder input, returns false if the encoder doesn't support the image */
+    bool createSourceLayout(tinygltf::Image const& image, GenericTextureLayout& layout)
+    {
+        layout.width = image.width;
+        layout.height = image.height;
+        layout.depth = 1;
+        layout.levels = 1;
+        layout.type = image.pixel_type;
+        layout.internal_format = GenericTextureLayout::InternalFormat::RGBA8;
+
+        switch (image.component)
+        {
+        case 1:
+            layout.format = 0x1903; /*GL_RED*/
+            break;
+        case 2:
+            layout.format = 0x8227; /*GL_RG*/
+            break;
+        case 3:
+            layout.format = 0x1907; /*GL_RGB*/
+            break;
+        default:
+            layout.format = 0x1908; /*GL_RGBA*/
+            break;
+        }
+
+        if (EngineCore::Graphics::computeChannelCount(layout) != image.component
+            || image.image.size() < static_cast<size_t>(image.width) * image.height * image.component)
+        {
+            std::cerr << "GltfAssetComponentManager - unsupported image format for texture compression: " << image.name << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+}
+
+EngineCore::Graphics::GltfAssetComponentManager::MipChainPtr EngineCore::Graphics::GltfAssetComponentManager::getCompressedTexture(
+    tinygltf::Image const& image,
+    GenericTextureLayout::InternalFormat internal_format,
+    bool srgb)
+{
+    return compressTexture(image, internal_format, srgb, m_texture_compression_enabled ? &m_texture_compression_scheduler : nullptr);
+}
+
+bool EngineCore::Graphics::GltfAssetComponentManager::isCompressibleImage(tinygltf::Image const& image) const
+{
+    GenericTextureLayout layout;
+    return createSourceLayout(image, layout);
+}
+
+void EngineCore::Graphics::GltfAssetComponentManager::getCompressedTextureAsync(
+    tinygltf::Image const& image,
+    GenericTextureLayout::InternalFormat internal_format,
+    bool srgb,
+    std::function<void(MipChainPtr const&)> const& ready)
+{
+    if (!m_texture_compression_enabled)
+    {
+        ready(compressTexture(image, internal_format, srgb, nullptr));
+        return;
+    }
+
+    // the model might be evicted from the cache while the task is queued
+    auto src_image = std::make_shared<tinygltf::Image const>(image);
+
+    // one texture per task, the workers encode different textures in parallel
+    m_texture_compression_scheduler.submitTask([this, src_image, internal_format, srgb, ready]() {
+        ready(compressTexture(*src_image, internal_format, srgb, nullptr));
+    });
+}
+
+void EngineCore::Graphics::GltfAssetComponentManager::waitForCompressedTextures()
+{
+    if (m_texture_compression_enabled) {
+        m_texture_compression_scheduler.waitWhileBusy();
+    }
+}
+
+EngineCore::Graphics::GltfAssetComponentManager::MipChainPtr EngineCore::Graphics::GltfAssetComponentManager::compressTexture(
+    tinygltf::Image const& image,
+    GenericTextureLayout::InternalFormat internal_format,
+    bool srgb,
+    EngineCore::Utility::TaskScheduler* task_scheduler)
+{
+    TextureMipChain src;
+    if (!createSourceLayout(image, src.layout))
+        return nullptr;
+
+    // FNV-1a over the source texels and everything else that affects the encoder output
+    uint64_t key = 14695981039346656037ull;
+    auto hash = [&key](uint8_t const* data, size_t byte_size) {
+        for (size_t i = 0; i < byte_size; ++i) {
+            key = (key ^ data[i]) * 1099511628211ull;
+        }
+    };
+    int32_t params[5] = { image.width, image.height, image.component, static_cast<int32_t>(internal_format), srgb ? 1 : 0 };
+    hash(reinterpret_cast<uint8_t const*>(params), sizeof(params));
+    hash(image.image.data(), image.image.size());
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_compressed_textures_mutex);
+        auto query = m_compressed_textures.find(key);
+
+        if (query != m_compressed_textures.end())
+            return query->second;
+    }
+
+    std::string cache_filepath;
+    if (!m_compressed_texture_cache_dir.empty())
+    {
+        std::stringstream filename;
+        filename << std::hex << std::setw(16) << std::setfill('0') << key << ".bctex";
+        cache_filepath = (std::filesystem::path(m_compressed_texture_cache_dir) / filename.str()).string();
+    }
+
+    auto retval = std::make_shared<TextureMipChain>();
+
+    bool cached = !cache_filepath.empty()
+        && loadMipChain(cache_filepath, *retval)
+        && retval->layout.internal_format == internal_format
+        && retval->layout.width == image.width
+        && retval->layout.height == image.height;
+
+    if (!cached)
+    {
+        src.levels.push_back(image.image);
+        generateMipChain(src, MipFilter::BOX, srgb);
+
+        *retval = compressMipChain(src, internal_format, task_scheduler);
+
+        if (retval->levels.empty())
+            return nullptr;
+
+        if (!cache_filepath.empty())
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(m_compressed_texture_cache_dir, ec);
+
+            if (!saveMipChain(cache_filepath, *retval)) {
+                std::cerr << "GltfAssetComponentManager - failed to write texture cache file " << cache_filepath << std::endl;
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_compressed_textures_mutex);
+    auto insertion = m_compressed_textures.insert(std::make_pair(key, retval));
+
+    return insertion.first->second;
+}
+
+void EngineCore::Graphics::GltfAssetComponentManager::clearCompressedTextureCache()
+{
+    std::unique_lock<std::shared_mutex> lock(m_compressed_textures_mutex);
+    m_compressed_textures.clear();
+}
+
+void EngineCore::Graphics::GltfAssetComponentManager::setTextureStreaming(StreamedTextureFactory const& add_streamed_texture)
+{
+    m_add_streamed_texture = add_streamed_texture;
+}
+
+bool EngineCore::Graphics::GltfAssetComponentManager::isTextureStreamingEnabled() const
+{
+    return static_cast<bool>(m_add_streamed_texture);
+}
+
+EngineCore::Graphics::ResourceID EngineCore::Graphics::GltfAssetComponentManager::addStreamedTexture(
+    std::string const& name,
+    MipChainPtr const& mip_chain,
+    GenericTextureLayout const& layout)
+{
+    return m_add_streamed_texture(name, mip_chain, layout);
+}
+
+void EngineCore::Graphics::GltfAssetComponentManager::setTextureLoading(
+    TextureLoader const& load_texture,
+    EngineCore::Utility::TaskScheduler* image_decode_scheduler)
+{
+    m_load_texture = load_texture;
+    m_image_decode_scheduler = image_decode_scheduler;
+}
+
+bool EngineCore::Graphics::GltfAssetComponentManager::isTextureLoadingEnabled() const
+{
+    return static_cast<bool>(m_load_texture);
+}
+
+EngineCore::Graphics::ResourceID EngineCore::Graphics::GltfAssetComponentManager::loadTexture(
+    std::string const& name,
+    GenericTextureLayout const& layout,
+    std::shared_ptr<std::vector<uint8_t>> const& data,
+    bool srgb)
+{
+    return m_load_texture(name, layout, data, srgb);
+}
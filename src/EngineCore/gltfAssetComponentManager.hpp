@@ -7,6 +7,7 @@
 #ifndef GLTF_ASSET_COMPONENT_MANAGER
 #define GLTF_ASSET_COMPONENT_MANAGER
 
+#include <functional>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
@@ -24,8 +25,10 @@
 #include "GeometryBakery.hpp"
 #include "MaterialComponentManager.hpp"
 #include "MeshComponentManager.hpp"
+#include "MipmapGeneration.hpp"
 #include "SkinComponentManager.hpp"
 #include "RenderTaskComponentManager.hpp"
+#include "TaskScheduler.hpp"
 #include "TransformComponentManager.hpp"
 
 struct Entity;
@@ -38,7 +41,14 @@ namespace EngineCore
     {
         namespace Utility
         {
-            std::shared_ptr<tinygltf::Model> loadGltfModel(std::string const& gltf_filepath);
+            /**
+            * \brief Load a glTF file including its images.
+            * \param image_decode_scheduler Worker threads that decode the images in parallel once the file is parsed.
+            * Images are decoded on the calling thread while parsing if nullptr.
+            */
+            std::shared_ptr<tinygltf::Model> loadGltfModel(
+                std::string const& gltf_filepath,
+                EngineCore::Utility::TaskScheduler* image_decode_scheduler = nullptr);
 
             std::shared_ptr<tinygltf::Model> loadGLTFModel(std::vector<unsigned char> const& databuffer);
         }
@@ -54,9 +64,12 @@ namespace EngineCore
 
         public:
             typedef std::shared_ptr<tinygltf::Model> ModelPtr;
+            typedef std::shared_ptr<TextureMipChain const> MipChainPtr;
+            typedef std::function<ResourceID(std::string const&, MipChainPtr const&, GenericTextureLayout const&)> StreamedTextureFactory;
+            typedef std::function<ResourceID(std::string const&, GenericTextureLayout const&, std::shared_ptr<std::vector<uint8_t>> const&, bool)> TextureLoader;
 
             GltfAssetComponentManager() = default;
-            ~GltfAssetComponentManager() = default;
+            ~GltfAssetComponentManager();
 
             void addComponent(Entity entity, std::string const& gltf_filepath, size_t gltf_node_idx);
 
@@ -68,9 +81,98 @@ namespace EngineCore
 
             std::vector<ComponentData> getComponents() const;
 
+            /**
+            * \brief Enable block compression of imported textures.
+            * \param worker_thread_cnt Number of threads used for encoding, 0 disables texture compression
+            * \param cache_directory Directory for storing encoded textures, textures are only cached in memory if empty
+            */
+            void setTextureCompression(int worker_thread_cnt, std::string const& cache_directory = "");
+
+            bool isTextureCompressionEnabled() const;
+
+            /**
+            * \brief Get the full mip chain of an image of a glTF asset in the given block compressed format.
+            * Encoded textures are looked up in the memory cache and the cache directory first, keyed by a hash of the source
+            * image data. Newly encoded textures are added to both.
+            * \param image Decoded source image with 8bit channels
+            * \param internal_format Block compressed target format
+            * \param srgb Set for sRGB encoded colour images, mip levels are then filtered in linear space
+            * \return Returns the encoded mip chain or nullptr if the image cannot be encoded
+            */
+            MipChainPtr getCompressedTexture(tinygltf::Image const& image, GenericTextureLayout::InternalFormat internal_format, bool srgb = false);
+
+            /**
+            * \brief Check whether the format of an image is supported by the texture encoder
+            */
+            bool isCompressibleImage(tinygltf::Image const& image) const;
+
+            /**
+            * \brief Same as getCompressedTexture, but looks up or encodes the texture on the texture compression worker threads.
+            * Runs on the calling thread if texture compression is disabled.
+            * \param ready Called on a worker thread with the encoded mip chain or nullptr if encoding failed
+            */
+            void getCompressedTextureAsync(
+                tinygltf::Image const& image,
+                GenericTextureLayout::InternalFormat internal_format,
+                bool srgb,
+                std::function<void(MipChainPtr const&)> const& ready);
+
+            /**
+            * \brief Block until all textures passed to getCompressedTextureAsync are encoded and handed to their callbacks
+            */
+            void waitForCompressedTextures();
+
+            void clearCompressedTextureCache();
+
+            /**
+            * \brief Hand compressed textures to a texture streaming service instead of uploading them in full.
+            * Requires texture compression to be enabled.
+            * \param add_streamed_texture Creates a streamed texture from a name, a mip chain and a layout that provides
+            * the texture parameters, e.g. by calling TextureStreamingService::addTexture2D. Pass an empty function to disable streaming.
+            */
+            void setTextureStreaming(StreamedTextureFactory const& add_streamed_texture);
+
+            bool isTextureStreamingEnabled() const;
+
+            ResourceID addStreamedTexture(std::string const& name, MipChainPtr const& mip_chain, GenericTextureLayout const& layout);
+
+            /**
+            * \brief Decode the images of glTF models loaded from now on and build the mip chains of textures that are not
+            * block compressed on worker threads, e.g. those of a TextureLoadingService.
+            * \param load_texture Creates a texture from a name, the layout and texel data of level 0 and whether the data
+            * is sRGB encoded, e.g. by calling TextureLoadingService::createTexture2DAsync. Pass an empty function to disable.
+            * \param image_decode_scheduler Worker threads for decoding images, nullptr decodes on the loading thread.
+            * Has to stay alive until texture loading is disabled again.
+            */
+            void setTextureLoading(TextureLoader const& load_texture, EngineCore::Utility::TaskScheduler* image_decode_scheduler);
+
+            bool isTextureLoadingEnabled() const;
+
+            ResourceID loadTexture(
+                std::string const& name,
+                GenericTextureLayout const& layout,
+                std::shared_ptr<std::vector<uint8_t>> const& data,
+                bool srgb);
+
         private:
+            MipChainPtr compressTexture(
+                tinygltf::Image const& image,
+                GenericTextureLayout::InternalFormat internal_format,
+                bool srgb,
+                EngineCore::Utility::TaskScheduler* task_scheduler);
+
             std::unordered_map<std::string, ModelPtr> m_gltf_models;
             std::shared_mutex                         m_gltf_models_mutex;
+
+            std::unordered_map<uint64_t, MipChainPtr> m_compressed_textures;
+            std::shared_mutex                         m_compressed_textures_mutex;
+            std::string                               m_compressed_texture_cache_dir;
+            EngineCore::Utility::TaskScheduler        m_texture_compression_scheduler;
+            bool                                      m_texture_compression_enabled = false;
+            StreamedTextureFactory                    m_add_streamed_texture;
+            TextureLoader                             m_load_texture;
+            EngineCore::Utility::TaskScheduler*       m_image_decode_scheduler = nullptr;
+
             std::vector<ComponentData>                m_data;
             mutable std::shared_mutex                 m_data_mutex;
         };
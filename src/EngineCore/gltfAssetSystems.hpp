@@ -1,6 +1,12 @@
 #ifndef gltfAssetSystems_hpp
 #define gltfAssetSystems_hpp
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "AnimationPlayerComponentManager.hpp"
+#include "CpuSkinning.hpp"
 #include "BaseResourceManager.hpp"
 #include "EntityManager.hpp"
 #include "gltfAssetComponentManager.hpp"
@@ -75,6 +81,279 @@ namespace EngineCore
                 }
             }
 
+            /**
+            * Create a texture from a glTF image. If texture compression is enabled in the GltfAssetComponentManager,
+            * the full mip chain is encoded (or fetched from the texture cache) in the given block compressed format on the
+            * texture compression worker threads and either uploaded or handed to texture streaming once it is ready. The
+            * texture stays NOT_READY until then. Otherwise, if texture loading is enabled, the mip chain is built on the texture
+            * loading worker threads, or else the image is uploaded as is and mipmaps are generated on the GPU.
+            * Set srgb for colour textures, so that their mip levels are filtered in linear space.
+            * The resource manager has to outlive the texture compression workers of the GltfAssetComponentManager.
+            */
+            template<typename ResourceManagerType>
+            inline ResourceID createGltfTexture2DAsync(
+                ResourceManagerType& resource_manager,
+                GltfAssetComponentManager& gltf_asset_mngr,
+                std::string const& name,
+                tinygltf::Image& img,
+                GenericTextureLayout const& layout,
+                GenericTextureLayout::InternalFormat compressed_format,
+                bool srgb)
+            {
+                if (gltf_asset_mngr.isTextureCompressionEnabled() && gltf_asset_mngr.isCompressibleImage(img))
+                {
+                    // allocating by name returns the same id when the streaming service adds the texture later on
+                    auto tx_rsrcID = resource_manager.allocateTexture2DAsync(name);
+
+                    GenericTextureLayout compressed_layout = layout;
+                    compressed_layout.internal_format = compressed_format;
+                    auto API_compressed_layout = resource_manager.convertGenericTextureLayout(compressed_layout);
+
+                    bool streaming = gltf_asset_mngr.isTextureStreamingEnabled();
+
+                    gltf_asset_mngr.getCompressedTextureAsync(img, compressed_format, srgb,
+                        [&resource_manager, &gltf_asset_mngr, tx_rsrcID, name, layout, API_compressed_layout, streaming](
+                            GltfAssetComponentManager::MipChainPtr const& mip_chain)
+                        {
+                            if (mip_chain == nullptr)
+                            {
+                                std::cerr << "Failed to encode texture " << name << std::endl;
+                            }
+                            else if (streaming)
+                            {
+                                gltf_asset_mngr.addStreamedTexture(name, mip_chain, layout);
+                            }
+                            else
+                            {
+                                resource_manager.updateTexture2DAsync(
+                                    tx_rsrcID,
+                                    name,
+                                    API_compressed_layout,
+                                    std::make_shared<std::vector<std::vector<uint8_t>>>(mip_chain->levels));
+                            }
+                        });
+
+                    return tx_rsrcID;
+                }
+
+                // CPU mip generation has the same input requirements as the encoder
+                if (gltf_asset_mngr.isTextureLoadingEnabled()
+                    && computeChannelCount(layout) == img.component
+                    && gltf_asset_mngr.isCompressibleImage(img))
+                {
+                    return gltf_asset_mngr.loadTexture(name, layout, std::make_shared<std::vector<uint8_t>>(img.image), srgb);
+                }
+
+                auto APIlayout = resource_manager.convertGenericTextureLayout(layout);
+
+                return resource_manager.createTexture2DAsync(name, APIlayout, img.image.data(), true);
+            }
+
+            /**
+            * Read an accessor as floats, normalized integer components are converted to [0,1] or [-1,1]
+            */
+            inline std::vector<float> readGltfAccessorAsFloats(tinygltf::Model const& model, int accessor_idx)
+            {
+                auto const& accessor = model.accessors[accessor_idx];
+
+                size_t component_cnt = tinygltf::GetNumComponentsInType(accessor.type);
+                std::vector<float> retval(accessor.count * component_cnt, 0.0f);
+
+                if (accessor.bufferView == -1)
+                    return retval;
+
+                auto const& buffer_view = model.bufferViews[accessor.bufferView];
+                auto const& buffer = model.buffers[buffer_view.buffer];
+
+                size_t component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+                size_t stride = accessor.ByteStride(buffer_view);
+                unsigned char const* data = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
+
+                for (size_t i = 0; i < accessor.count; ++i)
+                {
+                    for (size_t c = 0; c < component_cnt; ++c)
+                    {
+                        unsigned char const* src = data + i * stride + c * component_size;
+                        float& tgt = retval[i * component_cnt + c];
+
+                        switch (accessor.componentType)
+                        {
+                        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+                            std::memcpy(&tgt, src, sizeof(float));
+                            break;
+                        case TINYGLTF_COMPONENT_TYPE_BYTE:
+                            tgt = std::max(static_cast<float>(*reinterpret_cast<int8_t const*>(src)) / 127.0f, -1.0f);
+                            break;
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                            tgt = static_cast<float>(*src) / 255.0f;
+                            break;
+                        case TINYGLTF_COMPONENT_TYPE_SHORT:
+                        {
+                            int16_t value;
+                            std::memcpy(&value, src, sizeof(int16_t));
+                            tgt = std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+                            break;
+                        }
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                        {
+                            uint16_t value;
+                            std::memcpy(&value, src, sizeof(uint16_t));
+                            tgt = static_cast<float>(value) / 65535.0f;
+                            break;
+                        }
+                        default:
+                            break;
+                        }
+                    }
+                }
+
+                return retval;
+            }
+
+            /**
+            * Read the skinning streams (POSITION, NORMAL, JOINTS_0, WEIGHTS_0) of a mesh primitive for CPU skinning.
+            * Returns an empty mesh if the primitive has no joints or weights.
+            */
+            inline Animation::SkinnedMeshData loadGltfSkinnedMeshData(tinygltf::Model const& model, size_t mesh_idx, size_t primitive_idx)
+            {
+                Animation::SkinnedMeshData retval;
+
+                auto const& attributes = model.meshes[mesh_idx].primitives[primitive_idx].attributes;
+
+                auto position_query = attributes.find("POSITION");
+                auto normal_query = attributes.find("NORMAL");
+                auto joints_query = attributes.find("JOINTS_0");
+                auto weights_query = attributes.find("WEIGHTS_0");
+
+                if (position_query == attributes.end() || joints_query == attributes.end() || weights_query == attributes.end())
+                    return retval;
+
+                retval.positions = readGltfAccessorAsFloats(model, position_query->second);
+                retval.vertex_cnt = retval.positions.size() / 3;
+
+                if (normal_query != attributes.end()) {
+                    retval.normals = readGltfAccessorAsFloats(model, normal_query->second);
+                }
+
+                retval.weights = readGltfAccessorAsFloats(model, weights_query->second);
+
+                // joint indices are unsigned integers, not normalized
+                auto const& joints_accessor = model.accessors[joints_query->second];
+                retval.joints.resize(joints_accessor.count * 4, 0);
+
+                if (joints_accessor.bufferView != -1)
+                {
+                    auto const& buffer_view = model.bufferViews[joints_accessor.bufferView];
+                    auto const& buffer = model.buffers[buffer_view.buffer];
+
+                    size_t stride = joints_accessor.ByteStride(buffer_view);
+                    unsigned char const* data = buffer.data.data() + buffer_view.byteOffset + joints_accessor.byteOffset;
+
+                    for (size_t i = 0; i < joints_accessor.count; ++i)
+                    {
+                        for (size_t c = 0; c < 4; ++c)
+                        {
+                            if (joints_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+                                retval.joints[i * 4 + c] = data[i * stride + c];
+                            }
+                            else {
+                                std::memcpy(&retval.joints[i * 4 + c], data + i * stride + c * sizeof(uint16_t), sizeof(uint16_t));
+                            }
+                        }
+                    }
+                }
+
+                if (retval.weights.size() != retval.vertex_cnt * 4 || retval.joints.size() != retval.vertex_cnt * 4)
+                {
+                    std::cerr << "Skinning streams of glTF mesh " << mesh_idx << " primitive " << primitive_idx << " don't match in size" << std::endl;
+                    return Animation::SkinnedMeshData();
+                }
+
+                if (retval.normals.size() != retval.positions.size()) {
+                    retval.normals.clear();
+                }
+
+                return retval;
+            }
+
+            /**
+            * Convert all animations of a model to clips, targets are identified by their glTF node index.
+            * Morph target weights are not supported and skipped.
+            */
+            inline std::vector<Animation::AnimationClipPtr> loadGltfAnimationClips(tinygltf::Model const& model)
+            {
+                std::vector<Animation::AnimationClipPtr> retval;
+
+                for (auto const& animation : model.animations)
+                {
+                    auto clip = std::make_shared<Animation::AnimationClip>();
+                    clip->name = animation.name;
+
+                    std::unordered_map<int, uint32_t> node_to_target;
+
+                    for (auto const& channel : animation.channels)
+                    {
+                        if (channel.target_node < 0 || channel.sampler < 0)
+                            continue;
+
+                        Animation::AnimationClip::Path path;
+                        if (channel.target_path == "translation") {
+                            path = Animation::AnimationClip::Path::TRANSLATION;
+                        }
+                        else if (channel.target_path == "rotation") {
+                            path = Animation::AnimationClip::Path::ROTATION;
+                        }
+                        else if (channel.target_path == "scale") {
+                            path = Animation::AnimationClip::Path::SCALE;
+                        }
+                        else {
+                            continue;
+                        }
+
+                        auto const& sampler = animation.samplers[channel.sampler];
+
+                        auto interpolation = Animation::AnimationClip::Interpolation::LINEAR;
+                        if (sampler.interpolation == "STEP") {
+                            interpolation = Animation::AnimationClip::Interpolation::STEP;
+                        }
+                        else if (sampler.interpolation == "CUBICSPLINE") {
+                            interpolation = Animation::AnimationClip::Interpolation::CUBICSPLINE;
+                        }
+
+                        auto key_times = readGltfAccessorAsFloats(model, sampler.input);
+                        auto key_values = readGltfAccessorAsFloats(model, sampler.output);
+
+                        size_t component_cnt = path == Animation::AnimationClip::Path::ROTATION ? 4 : 3;
+                        size_t values_per_key = interpolation == Animation::AnimationClip::Interpolation::CUBICSPLINE ? 3 : 1;
+
+                        if (key_values.size() != key_times.size() * component_cnt * values_per_key)
+                        {
+                            std::cerr << "Skipping malformed channel of animation " << animation.name << std::endl;
+                            continue;
+                        }
+
+                        auto query = node_to_target.find(channel.target_node);
+                        if (query == node_to_target.end())
+                        {
+                            query = node_to_target.insert({ channel.target_node, static_cast<uint32_t>(clip->target_ids.size()) }).first;
+                            clip->target_ids.push_back(static_cast<uint32_t>(channel.target_node));
+                        }
+
+                        clip->addChannel(
+                            query->second,
+                            path,
+                            interpolation,
+                            key_times.data(),
+                            static_cast<uint32_t>(key_times.size()),
+                            key_values.data());
+                    }
+
+                    retval.push_back(clip);
+                }
+
+                return retval;
+            }
+
             template<typename ResourceManagerType>
             inline void addGltfNode(
                 EngineCore::WorldState& world_state,
@@ -465,12 +744,13 @@ namespace EngineCore
                                         }
                                     };
 
-                                    auto APIlayout = resource_manager.convertGenericTextureLayout(layout);
-
-                                    auto tx_rsrcID = resource_manager.createTexture2DAsync(
+                                    auto tx_rsrcID = createGltfTexture2DAsync(
+                                        resource_manager,
+                                        gltf_asset_mngr,
                                         material_name + "_baseColor",
-                                        APIlayout,
-                                        img.image.data(),
+                                        img,
+                                        layout,
+                                        GenericTextureLayout::InternalFormat::BC7_RGBA,
                                         true);
 
                                     textures.emplace_back(std::make_pair(TextureSemantic::ALBEDO, tx_rsrcID));
@@ -508,13 +788,14 @@ namespace EngineCore
                                         }
                                     };
 
-                                    auto APIlayout = resource_manager.convertGenericTextureLayout(layout);
-
-                                    auto tx_rsrcID = resource_manager.createTexture2DAsync(
+                                    auto tx_rsrcID = createGltfTexture2DAsync(
+                                        resource_manager,
+                                        gltf_asset_mngr,
                                         material_name + "_metallicRoughness",
-                                        APIlayout,
-                                        img.image.data(),
-                                        true);
+                                        img,
+                                        layout,
+                                        GenericTextureLayout::InternalFormat::BC7_RGBA,
+                                        false);
 
                                     textures.emplace_back(std::make_pair(TextureSemantic::METALLIC_ROUGHNESS, tx_rsrcID));
                                 }
@@ -551,13 +832,14 @@ namespace EngineCore
                                         }
                                     };
 
-                                    auto APIlayout = resource_manager.convertGenericTextureLayout(layout);
-
-                                    auto tx_rsrcID = resource_manager.createTexture2DAsync(
+                                    auto tx_rsrcID = createGltfTexture2DAsync(
+                                        resource_manager,
+                                        gltf_asset_mngr,
                                         material_name + "_normal",
-                                        APIlayout,
-                                        img.image.data(),
-                                        true);
+                                        img,
+                                        layout,
+                                        GenericTextureLayout::InternalFormat::BC5_RG,
+                                        false);
 
                                     textures.emplace_back(std::make_pair(TextureSemantic::NORMAL, tx_rsrcID));
                                 }
@@ -647,6 +929,45 @@ namespace EngineCore
                 }
             }
 
+            // play the first animation on the scene root, all clips of the file are shared via the player's clip library
+            if (!gltf_model->animations.empty() && world_state.has<Animation::AnimationPlayerComponentManager>())
+            {
+                auto& player_mngr = world_state.get<Animation::AnimationPlayerComponentManager>();
+
+                auto clip_name = [&gltf_filepath](size_t animation_idx) {
+                    return gltf_filepath + "#" + std::to_string(animation_idx);
+                };
+
+                if (player_mngr.getClip(clip_name(0)) == nullptr)
+                {
+                    auto clips = loadGltfAnimationClips(*gltf_model);
+                    for (size_t i = 0; i < clips.size(); ++i) {
+                        player_mngr.addClip(clip_name(i), clips[i]);
+                    }
+                }
+
+                auto clip = player_mngr.getClip(clip_name(0));
+
+                int scene_idx = gltf_model->defaultScene >= 0 ? gltf_model->defaultScene : 0;
+                if (clip != nullptr && !gltf_model->scenes.empty() && !gltf_model->scenes[scene_idx].nodes.empty())
+                {
+                    std::vector<Entity> targets;
+                    targets.reserve(clip->target_ids.size());
+                    for (auto node : clip->target_ids)
+                    {
+                        auto query = node_to_entity.find(static_cast<int>(node));
+                        targets.push_back(query != node_to_entity.end() ? query->second : world_state.accessEntityManager().invalidEntity());
+                    }
+
+                    bool all_targets_found = std::none_of(targets.begin(), targets.end(), [](Entity e) {
+                        return e == EntityManager::invalidEntity(); });
+
+                    if (all_targets_found) {
+                        player_mngr.addComponent(node_to_entity[gltf_model->scenes[scene_idx].nodes.front()], clip, targets);
+                    }
+                }
+            }
+
             std::vector<Entity> retval;
 
             for (auto& v : node_to_entity) {
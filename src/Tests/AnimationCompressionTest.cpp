@@ -0,0 +1,134 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "AnimationCompression.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Animation;
+
+    /**
+    * Two minute clip at 30 Hz of a root with a translation range of 20 units and a spinning child with a small
+    * translation, plus a stepped scale and a cubic spline translation of a second child.
+    */
+    AnimationClip createClip()
+    {
+        constexpr uint32_t key_cnt = 3600;
+
+        std::vector<float> times(key_cnt);
+        std::vector<float> root_translations(key_cnt * 3);
+        std::vector<float> child_translations(key_cnt * 3);
+        std::vector<float> child_rotations(key_cnt * 4);
+
+        for (uint32_t i = 0; i < key_cnt; ++i)
+        {
+            float time = static_cast<float>(i) / 30.0f;
+            times[i] = time;
+
+            root_translations[i * 3 + 0] = 10.0f * std::sin(time * 0.7f);
+            root_translations[i * 3 + 1] = 3.0f * std::cos(time * 1.3f);
+            root_translations[i * 3 + 2] = 0.5f * time / 120.0f;
+
+            child_translations[i * 3 + 0] = 0.1f * std::sin(time);
+            child_translations[i * 3 + 1] = 0.0f;
+            child_translations[i * 3 + 2] = 0.0f;
+
+            float angle = time * 2.0f;
+            child_rotations[i * 4 + 0] = 0.0f;
+            child_rotations[i * 4 + 1] = std::sin(angle * 0.5f);
+            child_rotations[i * 4 + 2] = 0.0f;
+            child_rotations[i * 4 + 3] = std::cos(angle * 0.5f);
+        }
+
+        constexpr uint32_t step_key_cnt = 8;
+        std::vector<float> step_times(step_key_cnt);
+        std::vector<float> step_scales(step_key_cnt * 3);
+        for (uint32_t i = 0; i < step_key_cnt; ++i)
+        {
+            step_times[i] = static_cast<float>(i) * 15.0f;
+            step_scales[i * 3 + 0] = step_scales[i * 3 + 1] = step_scales[i * 3 + 2] = 1.0f + 0.25f * static_cast<float>(i % 3);
+        }
+
+        // in-tangent, value and out-tangent per key
+        constexpr uint32_t cubic_key_cnt = 13;
+        std::vector<float> cubic_times(cubic_key_cnt);
+        std::vector<float> cubic_translations(cubic_key_cnt * 9, 0.0f);
+        for (uint32_t i = 0; i < cubic_key_cnt; ++i)
+        {
+            cubic_times[i] = static_cast<float>(i) * 10.0f;
+            float* key = &cubic_translations[i * 9];
+            key[0] = key[6] = (i % 2 == 0) ? 0.05f : -0.05f;
+            key[3] = 0.5f * static_cast<float>(i % 4);
+            key[4] = 0.2f;
+        }
+
+        AnimationClip clip;
+        clip.name = "test";
+        clip.target_ids = { 0, 1, 2 };
+        clip.duration = times.back();
+        clip.addChannel(0, AnimationClip::Path::TRANSLATION, AnimationClip::Interpolation::LINEAR, times.data(), key_cnt, root_translations.data());
+        clip.addChannel(1, AnimationClip::Path::TRANSLATION, AnimationClip::Interpolation::LINEAR, times.data(), key_cnt, child_translations.data());
+        clip.addChannel(1, AnimationClip::Path::ROTATION, AnimationClip::Interpolation::LINEAR, times.data(), key_cnt, child_rotations.data());
+        clip.addChannel(2, AnimationClip::Path::SCALE, AnimationClip::Interpolation::STEP, step_times.data(), step_key_cnt, step_scales.data());
+        clip.addChannel(2, AnimationClip::Path::TRANSLATION, AnimationClip::Interpolation::CUBICSPLINE, cubic_times.data(), cubic_key_cnt, cubic_translations.data());
+
+        return clip;
+    }
+}
+
+/**
+* Compresses a synthetic clip with small and large time blocks and checks size and accuracy with
+* evaluateAnimationCompression, before and after a round trip through a clip file.
+*/
+int main()
+{
+    AnimationClip clip = createClip();
+
+    AnimationCompressionSettings settings;
+    settings.target_parents = { -1, 0, 0 };
+
+    std::string path = (std::filesystem::temp_directory_path() / "AnimationCompressionTest.bin").string();
+
+    bool success = true;
+
+    for (uint32_t block_size : { 4096u, 1u << 20 })
+    {
+        settings.block_size = block_size;
+        CompressedAnimationClip compressed_clip = compressAnimationClip(clip, settings);
+
+        // sample between the source keys as well
+        AnimationCompressionReport report = evaluateAnimationCompression(clip, compressed_clip, 4 * 3600);
+
+        std::cout << "block size " << block_size << ": " << compressed_clip.blocks.size() << " blocks, "
+            << report.compressed_size << " of " << report.uncompressed_size << " bytes, max. errors: position "
+            << report.max_position_error << ", rotation " << report.max_rotation_error << ", scale " << report.max_scale_error << std::endl;
+
+        success &= check(compressed_clip.channels.size() == clip.channels.size(), "Expected one compressed channel per source channel");
+        success &= check(report.compressed_size < report.uncompressed_size, "Compressed clip should be smaller than the source");
+        success &= check(report.max_position_error <= settings.position_tolerance, "Position error exceeds the tolerance");
+        success &= check(report.max_rotation_error <= settings.position_tolerance / settings.shell_distance, "Rotation error exceeds the tolerance");
+        success &= check(report.max_scale_error <= settings.position_tolerance, "Scale error exceeds the tolerance");
+
+        CompressedAnimationClip loaded_clip;
+        success &= check(saveCompressedAnimationClip(path, compressed_clip) && loadCompressedAnimationClip(path, loaded_clip), "Saving or loading the clip failed");
+        std::remove(path.c_str());
+
+        AnimationCompressionReport loaded_report = evaluateAnimationCompression(clip, loaded_clip, 4 * 3600);
+        success &= check(loaded_clip.data == compressed_clip.data && loaded_clip.blocks.size() == compressed_clip.blocks.size(), "Loaded clip differs from the saved clip");
+        success &= check(loaded_report.max_position_error == report.max_position_error
+            && loaded_report.max_rotation_error == report.max_rotation_error
+            && loaded_report.max_scale_error == report.max_scale_error, "Loaded clip samples differently than the saved clip");
+    }
+
+    CompressedAnimationClip invalid_clip;
+    success &= check(!loadCompressedAnimationClip(path, invalid_clip), "Loading a missing file should fail");
+
+    return exitCode(success);
+}
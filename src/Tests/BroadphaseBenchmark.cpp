@@ -0,0 +1,144 @@
+#include "BroadphaseBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    using EngineCore::Physics::AABB;
+
+    /** xorshift64*, deterministic across platforms */
+    struct Random
+    {
+        uint64_t state;
+
+        float next()
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return static_cast<float>((state * 2685821657736338717ull) >> 40) / static_cast<float>(1 << 24);
+        }
+    };
+
+    AABB randomBox(Random& random, float side)
+    {
+        Vec3 center(random.next() * side, random.next() * side, random.next() * side);
+        Vec3 half_extents(0.1f + 0.4f * random.next(), 0.1f + 0.4f * random.next(), 0.1f + 0.4f * random.next());
+        return { center - half_extents, center + half_extents };
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /** Runs the benchmark for either structure, both share the proxy interface */
+    template<typename Broadphase>
+    EngineCore::Physics::BroadphaseBenchmarkResult benchmark(
+        Broadphase& broadphase,
+        EngineCore::Physics::BroadphaseBenchmarkConfig const& config,
+        size_t proxy_cnt,
+        EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        using namespace EngineCore::Physics;
+
+        BroadphaseBenchmarkResult result;
+        result.proxy_cnt = proxy_cnt;
+
+        // roughly one box per 8 cubic units
+        float side = std::cbrt(static_cast<float>(proxy_cnt)) * 2.0f;
+        Random random = { config.seed };
+
+        std::vector<AABB> bounds(proxy_cnt);
+        for (auto& box : bounds) {
+            box = randomBox(random, side);
+        }
+
+        std::vector<uint32_t> proxies(proxy_cnt);
+        std::vector<BroadphasePair> pairs;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < proxy_cnt; ++i) {
+            proxies[i] = broadphase.createProxy(bounds[i], i);
+        }
+        broadphase.computePairs(task_scheduler, pairs);
+        result.build_time = secondsSince(start);
+
+        size_t moving_cnt = static_cast<size_t>(config.moving_fraction * proxy_cnt);
+        std::vector<BroadphaseRayHit> hits;
+        std::vector<uint32_t> box_hits;
+
+        for (uint step = 0; step < config.step_cnt; ++step)
+        {
+            // coherent movement of a contiguous range of proxies
+            size_t first = (step * moving_cnt) % proxy_cnt;
+            Vec3 velocity(0.05f, -0.02f, 0.03f);
+
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < moving_cnt; ++i)
+            {
+                size_t idx = (first + i) % proxy_cnt;
+                bounds[idx].min += velocity;
+                bounds[idx].max += velocity;
+                broadphase.moveProxy(proxies[idx], bounds[idx]);
+            }
+            result.update_time += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            broadphase.computePairs(task_scheduler, pairs);
+            result.pair_time += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            for (uint query = 0; query < config.query_cnt; ++query)
+            {
+                Vec3 origin(random.next() * side, random.next() * side, -1.0f);
+                Vec3 direction(random.next() - 0.5f, random.next() - 0.5f, 1.0f);
+                broadphase.queryRay(origin, direction, side, hits);
+            }
+            result.ray_query_time += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            for (uint query = 0; query < config.query_cnt; ++query)
+            {
+                AABB box = randomBox(random, side);
+                box.min -= Vec3(1.0f);
+                box.max += Vec3(1.0f);
+                broadphase.queryBox(box, box_hits);
+            }
+            result.box_query_time += secondsSince(start);
+        }
+
+        double step_cnt = std::max(1u, config.step_cnt);
+        double query_cnt = step_cnt * std::max(1u, config.query_cnt);
+        result.update_time /= step_cnt;
+        result.pair_time /= step_cnt;
+        result.ray_query_time /= query_cnt;
+        result.box_query_time /= query_cnt;
+        result.pair_cnt = pairs.size();
+
+        return result;
+    }
+}
+
+std::vector<EngineCore::Physics::BroadphaseBenchmarkResult> EngineCore::Physics::runBroadphaseBenchmark(BroadphaseBenchmarkConfig const& config, Utility::TaskScheduler& task_scheduler)
+{
+    std::vector<BroadphaseBenchmarkResult> results;
+
+    for (size_t proxy_cnt : config.proxy_cnts)
+    {
+        {
+            DynamicAABBTree tree;
+            results.push_back(benchmark(tree, config, proxy_cnt, task_scheduler));
+            results.back().method = BroadphaseBenchmarkResult::Method::DYNAMIC_AABB_TREE;
+        }
+        {
+            IncrementalSweepAndPrune sweep_and_prune;
+            results.push_back(benchmark(sweep_and_prune, config, proxy_cnt, task_scheduler));
+            results.back().method = BroadphaseBenchmarkResult::Method::SWEEP_AND_PRUNE;
+        }
+    }
+
+    return results;
+}
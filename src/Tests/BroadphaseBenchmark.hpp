@@ -0,0 +1,49 @@
+#ifndef BroadphaseBenchmark_hpp
+#define BroadphaseBenchmark_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "Broadphase.hpp"
+#include "TaskScheduler.hpp"
+
+namespace EngineCore
+{
+    namespace Physics
+    {
+        struct BroadphaseBenchmarkConfig
+        {
+            std::vector<size_t> proxy_cnts = { 10000, 100000, 1000000 };
+            float moving_fraction = 0.2f; ///< Fraction of proxies moved per step
+            uint  step_cnt = 10;
+            uint  query_cnt = 1000;       ///< Ray and box queries per step
+            uint64_t seed = 0x2545f4914f6cdd1dull;
+        };
+
+        struct BroadphaseBenchmarkResult
+        {
+            enum class Method
+            {
+                DYNAMIC_AABB_TREE,
+                SWEEP_AND_PRUNE
+            };
+
+            Method method;
+            size_t proxy_cnt = 0;
+            double build_time = 0.0;      ///< Seconds to create all proxies and compute the first pairs
+            double update_time = 0.0;     ///< Average seconds per step to move proxies
+            double pair_time = 0.0;       ///< Average seconds per step to compute pairs
+            double ray_query_time = 0.0;  ///< Average seconds per ray query
+            double box_query_time = 0.0;  ///< Average seconds per box query
+            size_t pair_cnt = 0;          ///< Pairs of the last step, equal for both methods up to the fat margin of the tree
+        };
+
+        /**
+        * \brief Compare the dynamic AABB tree and the incremental sweep and prune on a random box cloud of constant
+        * density, one result per method and proxy count. The box cloud only depends on the seed.
+        */
+        std::vector<BroadphaseBenchmarkResult> runBroadphaseBenchmark(BroadphaseBenchmarkConfig const& config, Utility::TaskScheduler& task_scheduler);
+    }
+}
+
+#endif // !BroadphaseBenchmark_hpp
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Broadphase.hpp"
+#include "BroadphaseBenchmark.hpp"
+#include "TaskScheduler.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Physics;
+
+    std::vector<AABB> createBoxes(size_t box_cnt, float side, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> coord(0.0f, side);
+        std::uniform_real_distribution<float> extent(0.1f, 0.5f);
+
+        std::vector<AABB> boxes(box_cnt);
+        for (auto& box : boxes)
+        {
+            Vec3 center(coord(rng), coord(rng), coord(rng));
+            Vec3 half_extents(extent(rng), extent(rng), extent(rng));
+            box = { center - half_extents, center + half_extents };
+        }
+        return boxes;
+    }
+
+    using BoxPairs = std::vector<std::pair<uint64_t, uint64_t>>;
+
+    BoxPairs bruteForcePairs(std::vector<AABB> const& boxes)
+    {
+        BoxPairs pairs;
+        for (uint64_t a = 0; a < boxes.size(); ++a) {
+            for (uint64_t b = a + 1; b < boxes.size(); ++b) {
+                if (intersects(boxes[a], boxes[b])) {
+                    pairs.push_back({ a, b });
+                }
+            }
+        }
+        return pairs;
+    }
+
+    template<typename Broadphase>
+    BoxPairs toBoxPairs(Broadphase const& broadphase, std::vector<BroadphasePair> const& pairs)
+    {
+        BoxPairs retval;
+        for (auto const& pair : pairs)
+        {
+            uint64_t a = broadphase.getUserData(pair.proxy_a);
+            uint64_t b = broadphase.getUserData(pair.proxy_b);
+            retval.push_back({ std::min(a, b), std::max(a, b) });
+        }
+        std::sort(retval.begin(), retval.end());
+        return retval;
+    }
+
+    template<typename Broadphase>
+    std::vector<uint64_t> toBoxIndices(Broadphase const& broadphase, std::vector<uint32_t> const& proxies)
+    {
+        std::vector<uint64_t> retval;
+        for (uint32_t proxy : proxies) {
+            retval.push_back(broadphase.getUserData(proxy));
+        }
+        std::sort(retval.begin(), retval.end());
+        return retval;
+    }
+}
+
+/**
+* Compares the pairs and box queries of both broadphases against brute force before and after moving proxies, then
+* runs a reduced broadphase benchmark on different numbers of worker threads and checks that the pair counts of both
+* methods agree and do not depend on the number of threads.
+*/
+int main()
+{
+    bool success = true;
+
+    {
+        constexpr size_t box_cnt = 2000;
+        constexpr float side = 25.0f;
+
+        std::mt19937 rng(1234);
+        std::vector<AABB> boxes = createBoxes(box_cnt, side, rng);
+
+        EngineCore::Utility::TaskScheduler task_scheduler;
+        task_scheduler.run(4);
+
+        // pairs and query results are mapped back to box indices through the user data
+        DynamicAABBTree tree;
+        IncrementalSweepAndPrune sweep_and_prune;
+        std::vector<uint32_t> tree_proxies(box_cnt);
+        std::vector<uint32_t> sweep_and_prune_proxies(box_cnt);
+        for (size_t i = 0; i < box_cnt; ++i)
+        {
+            tree_proxies[i] = tree.createProxy(boxes[i], i);
+            sweep_and_prune_proxies[i] = sweep_and_prune.createProxy(boxes[i], i);
+        }
+
+        std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+        std::vector<BroadphasePair> pairs;
+
+        for (int step = 0; step < 3; ++step)
+        {
+            sweep_and_prune.computePairs(task_scheduler, pairs);
+            success &= check(toBoxPairs(sweep_and_prune, pairs) == bruteForcePairs(boxes), "Sweep and prune pairs differ from brute force");
+
+            std::vector<AABB> fat_boxes(box_cnt);
+            for (size_t i = 0; i < box_cnt; ++i) {
+                fat_boxes[i] = tree.getFatAABB(tree_proxies[i]);
+                success &= check(intersects(fat_boxes[i], boxes[i]), "Fat AABB does not contain the proxy bounds");
+            }
+            tree.computePairs(task_scheduler, pairs);
+            success &= check(toBoxPairs(tree, pairs) == bruteForcePairs(fat_boxes), "Tree pairs differ from brute force over fat AABBs");
+
+            AABB query = { Vec3(side * 0.25f), Vec3(side * 0.5f) };
+            std::vector<uint64_t> expected;
+            std::vector<uint64_t> expected_fat;
+            for (uint64_t i = 0; i < box_cnt; ++i)
+            {
+                if (intersects(boxes[i], query)) {
+                    expected.push_back(i);
+                }
+                if (intersects(fat_boxes[i], query)) {
+                    expected_fat.push_back(i);
+                }
+            }
+
+            std::vector<uint32_t> proxies;
+            sweep_and_prune.queryBox(query, proxies);
+            success &= check(toBoxIndices(sweep_and_prune, proxies) == expected, "Sweep and prune box query differs from brute force");
+            tree.queryBox(query, proxies);
+            success &= check(toBoxIndices(tree, proxies) == expected_fat, "Tree box query differs from brute force over fat AABBs");
+
+            // move half of the proxies, some of them out of their fat AABBs
+            for (size_t i = 0; i < box_cnt; i += 2)
+            {
+                Vec3 delta(offset(rng), offset(rng), offset(rng));
+                boxes[i].min += delta;
+                boxes[i].max += delta;
+                tree.moveProxy(tree_proxies[i], boxes[i]);
+                sweep_and_prune.moveProxy(sweep_and_prune_proxies[i], boxes[i]);
+            }
+        }
+
+        task_scheduler.stop();
+    }
+
+    BroadphaseBenchmarkConfig config;
+    config.proxy_cnts = { 2000, 10000 };
+    config.step_cnt = 3;
+    config.query_cnt = 50;
+
+    std::vector<BroadphaseBenchmarkResult> reference;
+
+    for (int worker_thread_cnt : { 1, 2, 4 })
+    {
+        EngineCore::Utility::TaskScheduler task_scheduler;
+        task_scheduler.run(worker_thread_cnt);
+
+        std::vector<BroadphaseBenchmarkResult> results = runBroadphaseBenchmark(config, task_scheduler);
+
+        task_scheduler.stop();
+
+        if (!check(results.size() == config.proxy_cnts.size() * 2, "Expected one result per method and proxy count")) {
+            return EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < config.proxy_cnts.size(); ++i)
+        {
+            auto const& tree = results[2 * i];
+            auto const& sweep_and_prune = results[2 * i + 1];
+
+            if (worker_thread_cnt == 1)
+            {
+                std::cout << tree.proxy_cnt << " proxies: tree " << tree.pair_cnt << " pairs, " << tree.pair_time * 1000.0
+                    << " ms, sweep and prune " << sweep_and_prune.pair_cnt << " pairs, " << sweep_and_prune.pair_time * 1000.0
+                    << " ms" << std::endl;
+            }
+
+            success &= check(tree.method == BroadphaseBenchmarkResult::Method::DYNAMIC_AABB_TREE
+                && sweep_and_prune.method == BroadphaseBenchmarkResult::Method::SWEEP_AND_PRUNE, "Unexpected method order");
+            success &= check(tree.proxy_cnt == config.proxy_cnts[i] && sweep_and_prune.proxy_cnt == config.proxy_cnts[i],
+                "Unexpected proxy count");
+            success &= check(sweep_and_prune.pair_cnt > 0, "Boxes should overlap");
+            // tree pairs are overlaps of fat AABBs and include all exact overlaps
+            success &= check(tree.pair_cnt >= sweep_and_prune.pair_cnt, "Tree found fewer pairs than sweep and prune");
+        }
+
+        if (reference.empty())
+        {
+            reference = results;
+        }
+        else
+        {
+            for (size_t i = 0; i < results.size(); ++i) {
+                success &= check(results[i].pair_cnt == reference[i].pair_cnt, "Pair count differs between runs");
+            }
+        }
+    }
+
+    return exitCode(success);
+}
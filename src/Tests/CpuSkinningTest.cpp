@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "CpuSkinning.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Animation;
+
+    SkinnedMeshData createMesh(size_t vertex_cnt, uint16_t joint_cnt, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> coord(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> weight(0.0f, 1.0f);
+        std::uniform_int_distribution<int> joint(0, joint_cnt - 1);
+
+        SkinnedMeshData mesh;
+        mesh.vertex_cnt = vertex_cnt;
+
+        for (size_t v = 0; v < vertex_cnt; ++v)
+        {
+            Vec3 normal = glm::normalize(Vec3(coord(rng), coord(rng), coord(rng)) + Vec3(0.0f, 0.0f, 0.1f));
+
+            mesh.positions.insert(mesh.positions.end(), { coord(rng), coord(rng), coord(rng) });
+            mesh.normals.insert(mesh.normals.end(), { normal.x, normal.y, normal.z });
+
+            // between one and four influences
+            float weights[4];
+            float weight_sum = 0.0f;
+            for (int k = 0; k < 4; ++k)
+            {
+                weights[k] = (k == 0 || weight(rng) > 0.3f) ? weight(rng) + 0.01f : 0.0f;
+                weight_sum += weights[k];
+            }
+
+            for (int k = 0; k < 4; ++k)
+            {
+                mesh.joints.push_back(static_cast<uint16_t>(joint(rng)));
+                mesh.weights.push_back(weights[k] / weight_sum);
+            }
+        }
+
+        return mesh;
+    }
+
+    /** Rigid joint transformations, rotations of up to a full turn also put real parts in opposite hemispheres */
+    std::vector<Mat4x4> createJointPalette(size_t joint_cnt, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> angle(-6.2f, 6.2f);
+
+        std::vector<Mat4x4> joint_palette;
+        for (size_t joint = 0; joint < joint_cnt; ++joint)
+        {
+            Vec3 axis = glm::normalize(Vec3(coord(rng), coord(rng), coord(rng)) + Vec3(0.0f, 0.1f, 0.0f));
+            Quat rotation = glm::angleAxis(angle(rng), axis);
+            Vec3 translation(coord(rng) * 5.0f, coord(rng) * 5.0f, coord(rng) * 5.0f);
+
+            joint_palette.push_back(glm::translate(Mat4x4(1.0f), translation) * glm::toMat4(rotation));
+        }
+
+        return joint_palette;
+    }
+
+    float maxDifference(std::vector<float> const& a, std::vector<float> const& b)
+    {
+        float retval = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i) {
+            retval = std::max(retval, std::abs(a[i] - b[i]) / std::max(1.0f, std::abs(b[i])));
+        }
+        return retval;
+    }
+}
+
+/**
+* Compares the SIMD skinning kernels and the dispatching skinVertices against skinVerticesReference
+* for linear blend and dual quaternion skinning.
+*/
+int main()
+{
+    constexpr size_t vertex_cnt = 4096;
+    constexpr uint16_t joint_cnt = 32;
+    constexpr float tolerance = 1.0e-4f;
+
+    std::mt19937 rng(1234);
+    SkinnedMeshData mesh = createMesh(vertex_cnt, joint_cnt, rng);
+    std::vector<Mat4x4> joint_palette = createJointPalette(joint_cnt, rng);
+
+    bool avx2 = detail::cpuSupportsAvx2();
+    std::cout << "AVX2 " << (avx2 ? "supported" : "not supported") << std::endl;
+
+    bool success = true;
+
+    for (SkinningMethod method : { SkinningMethod::LINEAR_BLEND, SkinningMethod::DUAL_QUATERNION })
+    {
+        char const* method_name = method == SkinningMethod::LINEAR_BLEND ? "linear blend" : "dual quaternion";
+        SkinningPalette palette = createSkinningPalette(joint_palette, 0, joint_cnt, method);
+
+        std::vector<float> reference_positions(vertex_cnt * 3);
+        std::vector<float> reference_normals(vertex_cnt * 3);
+        skinVerticesReference(mesh, palette, method, 0, vertex_cnt, reference_positions.data(), reference_normals.data());
+
+        detail::SkinningStreams streams;
+        streams.positions = mesh.positions.data();
+        streams.normals = mesh.normals.data();
+        streams.joints = mesh.joints.data();
+        streams.weights = mesh.weights.data();
+        streams.matrices = palette.matrices.empty() ? nullptr : &palette.matrices[0][0][0];
+        streams.dual_quaternions = palette.dual_quaternions.data();
+
+        auto compare = [&](char const* kernel, std::vector<float> const& positions, std::vector<float> const& normals) {
+            float position_error = maxDifference(positions, reference_positions);
+            float normal_error = maxDifference(normals, reference_normals);
+
+            std::cout << kernel << " " << method_name << ": max position error " << position_error
+                << ", max normal error " << normal_error << std::endl;
+
+            success &= check(position_error <= tolerance && normal_error <= tolerance, "SIMD kernel differs from the reference");
+        };
+
+        std::vector<float> positions(vertex_cnt * 3);
+        std::vector<float> normals(vertex_cnt * 3);
+
+        skinVertices(mesh, palette, method, 0, vertex_cnt, positions.data(), normals.data());
+        compare("skinVertices", positions, normals);
+
+        if (detail::skinVerticesSse2(streams, method, 0, vertex_cnt, positions.data(), normals.data())) {
+            compare("SSE2", positions, normals);
+        }
+
+        if (avx2)
+        {
+            std::fill(positions.begin(), positions.end(), 0.0f);
+            std::fill(normals.begin(), normals.end(), 0.0f);
+            if (detail::skinVerticesAvx2(streams, method, 0, vertex_cnt, positions.data(), normals.data())) {
+                compare("AVX2", positions, normals);
+            }
+        }
+
+        // only the given range is written and normals are optional
+        std::vector<float> range_positions(vertex_cnt * 3, -1.0f);
+        skinVertices(mesh, palette, method, 100, 200, range_positions.data(), nullptr);
+        success &= check(range_positions[99 * 3] == -1.0f && range_positions[200 * 3] == -1.0f, "Vertices outside of the range were written");
+        success &= check(std::equal(range_positions.begin() + 300, range_positions.begin() + 600, reference_positions.begin() + 300,
+            [tolerance](float a, float b) { return std::abs(a - b) <= tolerance * std::max(1.0f, std::abs(b)); }),
+            "Skinning a range without normals differs from the reference");
+    }
+
+    return exitCode(success);
+}
@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "LandscapeBrickSolver.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Graphics::Landscape;
+
+    constexpr uint brick_res = 17;
+
+    /**
+    * Two neighbouring bricks along x with a constrained ground plane that steps up every 8 voxels, a constrained
+    * normal on the plane and a noise constraint at a different position in each brick.
+    */
+    std::vector<std::unique_ptr<LandscapeBrickFields>> createBricks()
+    {
+        std::vector<std::unique_ptr<LandscapeBrickFields>> bricks;
+        for (int i = 0; i < 2; ++i) {
+            bricks.push_back(std::make_unique<LandscapeBrickFields>(Vec3(16.0f), brick_res, brick_res, brick_res));
+        }
+
+        bricks[0]->neighbours[LandscapeBrickFields::EAST] = bricks[1].get();
+        bricks[1]->neighbours[LandscapeBrickFields::WEST] = bricks[0].get();
+
+        for (size_t b = 0; b < bricks.size(); ++b)
+        {
+            auto& brick = *bricks[b];
+
+            for (uint z = 0; z < brick_res; ++z)
+            {
+                for (uint x = 0; x < brick_res; ++x)
+                {
+                    int y = 6 + static_cast<int>((x + b * (brick_res - 1)) / 8);
+
+                    brick.surface(x, y, z) = 0.0f;
+                    brick.surface_weights(x, y, z) = 1.0f;
+
+                    brick.normals[0](x, y, z) = -0.124f;
+                    brick.normals[1](x, y, z) = 0.992f;
+                    brick.normals[2](x, y, z) = 0.0f;
+                    brick.normal_weights(x, y, z) = 1.0f;
+                }
+            }
+
+            brick.noise[0](4, 8, 4 + 8 * static_cast<int>(b)) = 0.5f;
+            brick.noise[1](4, 8, 4 + 8 * static_cast<int>(b)) = 0.25f;
+            brick.noise_weights(4, 8, 4 + 8 * static_cast<int>(b)) = 1.0f;
+        }
+
+        return bricks;
+    }
+
+    std::vector<uint64_t> bake(bool multigrid, int worker_thread_cnt, bool& converged)
+    {
+        auto bricks = createBricks();
+        std::vector<LandscapeBrickFields*> brick_ptrs = { bricks[0].get(), bricks[1].get() };
+
+        EngineCore::Utility::TaskScheduler task_scheduler;
+        task_scheduler.run(worker_thread_cnt);
+
+        converged = true;
+        if (multigrid)
+        {
+            MultigridSettings settings;
+            for (auto const& report : bakeBricksMultigrid(brick_ptrs, settings, task_scheduler)) {
+                converged &= report.final_residual <= settings.tolerance;
+            }
+        }
+        else
+        {
+            bakeBricks(brick_ptrs, task_scheduler);
+        }
+
+        task_scheduler.stop();
+
+        std::vector<uint64_t> retval;
+        for (auto const& brick : bricks) {
+            retval.push_back(computeFieldHash(*brick));
+        }
+        return retval;
+    }
+}
+
+/**
+* Bakes the same bricks with the Jacobi and the multigrid solvers on different numbers of worker threads and compares
+* the field hashes with each other and with the hashes of earlier bakes. The stored hashes have to be updated whenever
+* solver results change on purpose.
+*/
+int main()
+{
+    // x86-64, SSE2 or AVX2 without FMA contraction
+    uint64_t const stored_jacobi_hashes[2] = { 0xbe492aa4b3646bbaull, 0x9658dbb0b0ad5eecull };
+    uint64_t const stored_multigrid_hashes[2] = { 0x5e6456fbe682acc9ull, 0x11c690d45db3ffd3ull };
+
+    bool success = true;
+
+    for (bool multigrid : { false, true })
+    {
+        char const* solver = multigrid ? "multigrid" : "jacobi";
+        uint64_t const* stored_hashes = multigrid ? stored_multigrid_hashes : stored_jacobi_hashes;
+
+        bool converged;
+        std::vector<uint64_t> hashes = bake(multigrid, 1, converged);
+
+        std::cout << solver << " hashes: " << std::hex;
+        for (auto hash : hashes) {
+            std::cout << "0x" << hash << "ull ";
+        }
+        std::cout << std::dec << std::endl;
+
+        success &= check(!multigrid || converged, "Multigrid solve did not converge");
+        success &= check(hashes[0] != hashes[1], "Bricks with different constraints should have different fields");
+
+        for (int worker_thread_cnt : { 2, 4 })
+        {
+            bool parallel_converged;
+            success &= check(bake(multigrid, worker_thread_cnt, parallel_converged) == hashes, "Results depend on the number of worker threads");
+        }
+
+        success &= check(hashes[0] == stored_hashes[0] && hashes[1] == stored_hashes[1], "Results differ from the stored hashes");
+    }
+
+    return exitCode(success);
+}
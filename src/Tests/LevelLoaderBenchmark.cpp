@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "AirplanePhysicsComponent.hpp"
+#include "CameraComponent.hpp"
+#include "LevelLoader.hpp"
+#include "NameComponentManager.hpp"
+#include "PointlightComponent.hpp"
+#include "TaskScheduler.hpp"
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+/**
+* Loads a generated level with 100k instances of the prefabs in resources/entities and checks the created
+* components. Usage: LevelLoaderBenchmark <prefab directory> [entity count]
+*/
+int main(int argc, char** argv)
+{
+    using namespace EngineCore;
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: LevelLoaderBenchmark <prefab directory> [entity count]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string prefab_directory = argv[1];
+    size_t entity_cnt = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+    char const* prefabs[] = { "outflyer.json", "pointlight.json", "camera.json" };
+
+    std::filesystem::path level_path = std::filesystem::temp_directory_path() / "space-lion_level_loader_benchmark.json";
+
+    {
+        std::ofstream level(level_path);
+        level << "{ \"entities\" : [\n";
+        for (size_t i = 0; i < entity_cnt; ++i)
+        {
+            level << (i > 0 ? ",\n" : "")
+                << "{ \"type\" : \"" << prefabs[i % 3] << "\", \"name\" : \"e" << i << "\", "
+                << "\"Transform\" : { \"position\" : [ \"" << i << "\", \"1.5\", \"" << -static_cast<float>(i) << "\" ] }";
+            if (i % 3 == 1) {
+                level << ", \"Light\" : { \"light intensity\" : \"" << i << "\" }";
+            }
+            level << " }";
+        }
+        level << "\n] }\n";
+    }
+
+    WorldState world;
+    world.add<Common::TransformComponentManager>(std::make_unique<Common::TransformComponentManager>());
+    world.add<Common::NameComponentManager>(std::make_unique<Common::NameComponentManager>());
+    world.add<Graphics::CameraComponentManager>(std::make_unique<Graphics::CameraComponentManager>(4));
+    world.add<Graphics::PointlightComponentManager>(std::make_unique<Graphics::PointlightComponentManager>(4));
+    world.add<Physics::AirplanePhysicsComponentManager>(std::make_unique<Physics::AirplanePhysicsComponentManager>(4, world));
+
+    Utility::TaskScheduler task_scheduler;
+    task_scheduler.run(std::thread::hardware_concurrency());
+
+    Common::LevelLoader loader;
+
+    auto t_0 = std::chrono::steady_clock::now();
+    auto entities = loader.loadLevel(level_path.string(), prefab_directory, world, task_scheduler);
+    auto t_1 = std::chrono::steady_clock::now();
+
+    task_scheduler.stop();
+    std::filesystem::remove(level_path);
+
+    double seconds = std::chrono::duration<double>(t_1 - t_0).count();
+    std::cout << "Loaded " << entities.size() << " entities in " << seconds * 1000.0 << " ms" << std::endl;
+
+    size_t per_prefab_cnt[3] = { (entity_cnt + 2) / 3, (entity_cnt + 1) / 3, entity_cnt / 3 };
+
+    bool success = entities.size() == entity_cnt
+        && world.get<Common::TransformComponentManager>().getComponentCount() == entity_cnt
+        && world.get<Physics::AirplanePhysicsComponentManager>().getComponentCount() == per_prefab_cnt[0]
+        && world.get<Graphics::PointlightComponentManager>().getComponentCount() == per_prefab_cnt[1]
+        && world.get<Graphics::CameraComponentManager>().getComponentCount() == per_prefab_cnt[2];
+
+    if (success && entity_cnt > 1)
+    {
+        // per-instance overrides on top of the prefab values
+        auto& transforms = world.get<Common::TransformComponentManager>();
+        Vec3 position = transforms.getPosition(transforms.getIndex(entities[entity_cnt - 1]));
+        success = position.x == static_cast<float>(entity_cnt - 1) && position.y == 1.5f;
+
+        auto& pointlights = world.get<Graphics::PointlightComponentManager>();
+        success = success && pointlights.getLumen(pointlights.getIndex(entities[1]).front()) == 1.0f;
+    }
+
+    if (!success)
+    {
+        std::cerr << "Created components don't match the level" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+#ifdef NDEBUG
+    if (entity_cnt >= 100000 && seconds > 1.0)
+    {
+        std::cerr << "Loading took longer than the target of one second" << std::endl;
+        return EXIT_FAILURE;
+    }
+#endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Narrowphase.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Physics;
+
+    Vec3 randomDirection(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+        return glm::normalize(Vec3(coord(rng), coord(rng), coord(rng)) + Vec3(0.0f, 0.01f, 0.0f));
+    }
+
+    OrientedBox randomBox(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> coord(-1.5f, 1.5f);
+        std::uniform_real_distribution<float> extent(0.2f, 1.0f);
+
+        Vec3 x = randomDirection(rng);
+        Vec3 y = glm::normalize(glm::cross(x, randomDirection(rng)));
+
+        return { Vec3(coord(rng), coord(rng), coord(rng)), { x, y, glm::cross(x, y) }, Vec3(extent(rng), extent(rng), extent(rng)) };
+    }
+
+    void pushRandomAxialShape(SoAAxialShapes& shapes, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> coord(-1.5f, 1.5f);
+        std::uniform_real_distribution<float> size(0.1f, 1.0f);
+
+        shapes.push_back(Vec3(coord(rng), coord(rng), coord(rng)), randomDirection(rng), size(rng), size(rng));
+    }
+
+    /** Same number of contacts and contacts within the tolerance, shallow contacts near the margin may differ in rounding */
+    bool equal(NarrowphaseManifold const& a, NarrowphaseManifold const& b, float tolerance)
+    {
+        if (a.contact_cnt != b.contact_cnt)
+            return a.contact_cnt + b.contact_cnt == 1 && std::abs(std::max(a.contacts[0].penetration, b.contacts[0].penetration)) < tolerance;
+
+        if (a.contact_cnt == 0)
+            return true;
+
+        bool retval = glm::length(a.normal - b.normal) <= tolerance;
+        for (uint32_t i = 0; i < a.contact_cnt; ++i)
+        {
+            retval &= glm::length(a.contacts[i].point - b.contacts[i].point) <= tolerance;
+            retval &= std::abs(a.contacts[i].penetration - b.contacts[i].penetration) <= tolerance;
+        }
+        return retval;
+    }
+}
+
+/**
+* Checks the capsule box and cylinder kernels on known configurations and compares the batched kernels against the
+* scalar references for random pairs.
+*/
+int main()
+{
+    constexpr size_t pair_cnt = 4099;
+    constexpr float margin = 0.05f;
+    constexpr float tolerance = 1.0e-3f;
+
+    bool success = true;
+
+    {
+        // capsule lying on a unit box, 0.05 deep
+        OrientedBox box = { Vec3(0.0f), { Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), Vec3(0.0f, 0.0f, 1.0f) }, Vec3(1.0f) };
+
+        SoAAxialShapes capsules;
+        SoABoxes boxes;
+        capsules.push_back(Vec3(0.3f, 1.15f, 0.0f), Vec3(1.0f, 0.0f, 0.0f), 0.5f, 0.2f);
+        boxes.push_back(box);
+
+        // tilted capsule, only its lower end reaches into the box
+        capsules.push_back(Vec3(0.0f, 1.5f, 0.0f), glm::normalize(Vec3(1.0f, 1.0f, 0.0f)), 0.6f, 0.2f);
+        boxes.push_back(box);
+
+        NarrowphaseManifold manifolds[2];
+        collideCapsuleBoxesReference(capsules, boxes, 0, 2, margin, manifolds);
+
+        success &= check(manifolds[0].contact_cnt == 1 && std::abs(manifolds[0].contacts[0].penetration - 0.05f) < 1.0e-4f, "Resting capsule should penetrate by 0.05");
+        success &= check(glm::length(manifolds[0].normal - Vec3(0.0f, -1.0f, 0.0f)) < 1.0e-4f, "Resting capsule normal should point into the box");
+
+        float lowest = 1.5f - 0.6f * std::sqrt(0.5f) - 0.2f;
+        success &= check(manifolds[1].contact_cnt == 1 && std::abs(manifolds[1].contacts[0].penetration - (1.0f - lowest)) < 1.0e-3f, "Tilted capsule should touch with its lower end");
+        success &= check(manifolds[1].contacts[0].point.x < 0.0f, "Tilted capsule contact should be below its lower end");
+    }
+
+    {
+        SoAAxialShapes a;
+        SoAAxialShapes b;
+
+        // stacked cylinders
+        a.push_back(Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f), 0.5f, 0.5f);
+        b.push_back(Vec3(0.2f, 0.95f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), 0.5f, 0.5f);
+
+        // crossed cylinders lying on their sides
+        a.push_back(Vec3(0.0f), Vec3(1.0f, 0.0f, 0.0f), 1.0f, 0.5f);
+        b.push_back(Vec3(0.0f, 0.9f, 0.0f), Vec3(0.0f, 0.0f, 1.0f), 1.0f, 0.5f);
+
+        // separated side by side
+        a.push_back(Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f), 0.5f, 0.5f);
+        b.push_back(Vec3(1.2f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), 0.5f, 0.5f);
+
+        NarrowphaseManifold manifolds[3];
+        collideCylindersReference(a, b, 0, 3, margin, manifolds);
+
+        success &= check(manifolds[0].contact_cnt == 1 && std::abs(manifolds[0].contacts[0].penetration - 0.05f) < 1.0e-4f, "Stacked cylinders should penetrate by 0.05");
+        success &= check(glm::length(manifolds[0].normal - Vec3(0.0f, 1.0f, 0.0f)) < 1.0e-4f, "Stacked cylinders should touch with their caps");
+        success &= check(std::abs(manifolds[0].contacts[0].point.y - 0.475f) < 1.0e-4f, "Stacked cylinder contact should be between the caps");
+
+        success &= check(manifolds[1].contact_cnt == 1 && std::abs(manifolds[1].contacts[0].penetration - 0.1f) < 1.0e-4f, "Crossed cylinders should penetrate by 0.1");
+        success &= check(glm::length(manifolds[1].contacts[0].point - Vec3(0.0f, 0.45f, 0.0f)) < 1.0e-4f, "Crossed cylinder contact should be between the sides");
+
+        success &= check(manifolds[2].contact_cnt == 0, "Separated cylinders should not touch");
+    }
+
+    std::mt19937 rng(4321);
+
+    SoAAxialShapes shapes_a;
+    SoAAxialShapes shapes_b;
+    SoABoxes boxes;
+    for (size_t i = 0; i < pair_cnt; ++i)
+    {
+        pushRandomAxialShape(shapes_a, rng);
+        pushRandomAxialShape(shapes_b, rng);
+        boxes.push_back(randomBox(rng));
+    }
+
+    auto compare = [&](char const* kernel, std::vector<NarrowphaseManifold> const& manifolds, std::vector<NarrowphaseManifold> const& reference_manifolds) {
+        size_t contact_cnt = 0;
+        size_t mismatch_cnt = 0;
+        for (size_t i = 0; i < pair_cnt; ++i)
+        {
+            contact_cnt += reference_manifolds[i].contact_cnt > 0 ? 1 : 0;
+            mismatch_cnt += equal(manifolds[i], reference_manifolds[i], tolerance) ? 0 : 1;
+        }
+
+        std::cout << kernel << ": " << contact_cnt << " of " << pair_cnt << " pairs touching, " << mismatch_cnt << " mismatches" << std::endl;
+
+        success &= check(contact_cnt > pair_cnt / 10 && contact_cnt < pair_cnt, "Random pairs should be partly touching");
+        success &= check(mismatch_cnt == 0, "Batched kernel differs from the reference");
+    };
+
+    std::vector<NarrowphaseManifold> manifolds(pair_cnt);
+    std::vector<NarrowphaseManifold> reference_manifolds(pair_cnt);
+
+    collideCapsuleBoxes(shapes_a, boxes, 0, pair_cnt, margin, manifolds.data());
+    collideCapsuleBoxesReference(shapes_a, boxes, 0, pair_cnt, margin, reference_manifolds.data());
+    compare("collideCapsuleBoxes", manifolds, reference_manifolds);
+
+    collideCylinders(shapes_a, shapes_b, 0, pair_cnt, margin, manifolds.data());
+    collideCylindersReference(shapes_a, shapes_b, 0, pair_cnt, margin, reference_manifolds.data());
+    compare("collideCylinders", manifolds, reference_manifolds);
+
+    return exitCode(success);
+}
@@ -0,0 +1,122 @@
+#include "RigidBodyBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace
+{
+    /** FNV-1a */
+    void hashBytes(void const* data, size_t byte_cnt, uint64_t& hash)
+    {
+        auto bytes = reinterpret_cast<uint8_t const*>(data);
+        for (size_t i = 0; i < byte_cnt; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+}
+
+void EngineCore::Physics::createRigidBodyBenchmarkScene(WorldState& world, RigidBodyBenchmarkConfig const& config)
+{
+    auto& transform_mngr = world.get<Common::TransformComponentManager>();
+    auto& rigid_body_mngr = world.get<RigidBodyComponentManager>();
+
+    auto add_box = [&](Vec3 position, Vec3 half_extents, float mass) {
+        Entity entity = world.accessEntityManager().create();
+        transform_mngr.addComponent(entity, position);
+        rigid_body_mngr.addBoxComponent(entity, position, Quat(1.0f, 0.0f, 0.0f, 0.0f), half_extents, mass);
+    };
+
+    uint grid_size = static_cast<uint>(std::ceil(std::sqrt(static_cast<float>(config.box_stack_cnt))));
+    float stack_spacing = 3.0f;
+    float ground_size = 10.0f + grid_size * stack_spacing;
+
+    // ground, top face at y = 0
+    add_box(Vec3(0.0f, -1.0f, 0.0f), Vec3(ground_size, 1.0f, ground_size), 0.0f);
+
+    // box stacks on a grid around the center, every other layer slightly offset
+    for (uint stack = 0; stack < config.box_stack_cnt; ++stack)
+    {
+        float x = (static_cast<float>(stack % grid_size) - 0.5f * (grid_size - 1)) * stack_spacing;
+        float z = (static_cast<float>(stack / grid_size) - 0.5f * (grid_size - 1)) * stack_spacing + ground_size * 0.5f;
+
+        for (uint layer = 0; layer < config.box_stack_height; ++layer)
+        {
+            float offset = (layer % 2) * 0.02f;
+            add_box(Vec3(x + offset, 0.5f + layer * 1.0f, z), Vec3(0.5f), 1.0f);
+        }
+    }
+
+    // static bin that keeps the sphere pile together
+    float bin_size = 4.0f;
+    float bin_z = -ground_size * 0.5f;
+    add_box(Vec3(bin_size + 0.25f, 1.5f, bin_z), Vec3(0.25f, 1.5f, bin_size + 0.5f), 0.0f);
+    add_box(Vec3(-bin_size - 0.25f, 1.5f, bin_z), Vec3(0.25f, 1.5f, bin_size + 0.5f), 0.0f);
+    add_box(Vec3(0.0f, 1.5f, bin_z + bin_size + 0.25f), Vec3(bin_size, 1.5f, 0.25f), 0.0f);
+    add_box(Vec3(0.0f, 1.5f, bin_z - bin_size - 0.25f), Vec3(bin_size, 1.5f, 0.25f), 0.0f);
+
+    // sphere pile, dropped from a column of layers with small deterministic offsets
+    uint layer_size = 10;
+    for (uint i = 0; i < config.sphere_cnt; ++i)
+    {
+        uint layer = i / (layer_size * layer_size);
+        uint row = (i / layer_size) % layer_size;
+        uint column = i % layer_size;
+
+        float jitter = 0.05f * static_cast<float>((i * 7919u) % 11u) / 11.0f;
+        Vec3 position(
+            (static_cast<float>(column) - 0.5f * (layer_size - 1)) * 0.55f + jitter,
+            1.0f + layer * 0.55f,
+            (static_cast<float>(row) - 0.5f * (layer_size - 1)) * 0.55f + bin_z - jitter);
+
+        Entity entity = world.accessEntityManager().create();
+        transform_mngr.addComponent(entity, position);
+        rigid_body_mngr.addSphereComponent(entity, position, 0.25f, 0.5f);
+    }
+}
+
+EngineCore::Physics::RigidBodyBenchmarkResult EngineCore::Physics::runRigidBodyBenchmark(
+    WorldState& world,
+    RigidBodyBenchmarkConfig const& config,
+    Utility::TaskScheduler& task_scheduler)
+{
+    auto& transform_mngr = world.get<Common::TransformComponentManager>();
+    auto& rigid_body_mngr = world.get<RigidBodyComponentManager>();
+
+    RigidBodyBenchmarkResult result;
+    result.body_cnt = rigid_body_mngr.getComponentCount();
+
+    for (uint step = 0; step < config.step_cnt; ++step)
+    {
+        auto t_0 = std::chrono::high_resolution_clock::now();
+
+        rigid_body_mngr.update(config.timestep, transform_mngr, task_scheduler);
+
+        auto t_1 = std::chrono::high_resolution_clock::now();
+
+        double step_time = std::chrono::duration_cast<std::chrono::duration<double>>(t_1 - t_0).count();
+        result.total_time += step_time;
+        result.max_step_time = std::max(result.max_step_time, step_time);
+
+        auto stats = rigid_body_mngr.getSolverStats();
+        result.max_contact_cnt = std::max(result.max_contact_cnt, stats.contact_cnt);
+        result.max_color_cnt = std::max(result.max_color_cnt, stats.color_cnt);
+    }
+
+    result.state_hash = 14695981039346656037ull;
+    for (size_t i = 0; i < result.body_cnt; ++i)
+    {
+        Vec3 position = rigid_body_mngr.getPosition(i);
+        Quat orientation = rigid_body_mngr.getOrientation(i);
+        hashBytes(&position, sizeof(Vec3), result.state_hash);
+        hashBytes(&orientation, sizeof(Quat), result.state_hash);
+    }
+
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef RigidBodyBenchmark_hpp
+#define RigidBodyBenchmark_hpp
+
+#include <cstdint>
+
+#include "RigidBodyComponentManager.hpp"
+#include "TaskScheduler.hpp"
+
+namespace EngineCore
+{
+    class WorldState;
+
+    namespace Physics
+    {
+        struct RigidBodyBenchmarkConfig
+        {
+            uint box_stack_cnt = 16;     ///< Stacks are placed on a grid
+            uint box_stack_height = 10;
+            uint sphere_cnt = 1000;      ///< Spheres are dropped as a pile into a static bin
+            uint step_cnt = 600;
+            float timestep = 1.0f / 60.0f;
+        };
+
+        struct RigidBodyBenchmarkResult
+        {
+            size_t   body_cnt = 0;
+            double   total_time = 0.0;      ///< Seconds for all steps
+            double   max_step_time = 0.0;
+            size_t   max_contact_cnt = 0;
+            size_t   max_color_cnt = 0;
+            uint64_t state_hash = 0;        ///< Hash of the final body state, equal for all runs of the same configuration
+        };
+
+        /**
+        * \brief Create the headless benchmark scene, a static ground box with box stacks and a bin filled with spheres.
+        * The world needs a TransformComponentManager and a RigidBodyComponentManager, the scene does not depend on
+        * any random state.
+        */
+        void createRigidBodyBenchmarkScene(WorldState& world, RigidBodyBenchmarkConfig const& config);
+
+        /**
+        * \brief Step the rigid bodies of the world config.step_cnt times and measure the time.
+        */
+        RigidBodyBenchmarkResult runRigidBodyBenchmark(WorldState& world, RigidBodyBenchmarkConfig const& config, Utility::TaskScheduler& task_scheduler);
+    }
+}
+
+#endif // !RigidBodyBenchmark_hpp
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include "RigidBodyBenchmark.hpp"
+#include "RigidBodyComponentManager.hpp"
+#include "TaskScheduler.hpp"
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore;
+
+    struct Run
+    {
+        Physics::RigidBodyBenchmarkResult result;
+        bool                              bodies_valid = true;
+    };
+
+    Run runBenchmark(Physics::RigidBodyBenchmarkConfig const& config, int worker_thread_cnt)
+    {
+        WorldState world;
+        world.add<Common::TransformComponentManager>(std::make_unique<Common::TransformComponentManager>());
+        world.add<Physics::RigidBodyComponentManager>(std::make_unique<Physics::RigidBodyComponentManager>());
+
+        Physics::createRigidBodyBenchmarkScene(world, config);
+
+        Utility::TaskScheduler task_scheduler;
+        task_scheduler.run(worker_thread_cnt);
+
+        Run retval;
+        retval.result = Physics::runRigidBodyBenchmark(world, config, task_scheduler);
+
+        task_scheduler.stop();
+
+        // nothing explodes or falls through the ground, whose top face is at y = 0
+        auto const& rigid_body_mngr = world.get<Physics::RigidBodyComponentManager>();
+        for (size_t i = 0; i < rigid_body_mngr.getComponentCount(); ++i)
+        {
+            Vec3 position = rigid_body_mngr.getPosition(i);
+            retval.bodies_valid &= std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z)
+                && position.y > -1.5f && std::abs(position.x) < 100.0f && std::abs(position.z) < 100.0f;
+        }
+
+        return retval;
+    }
+}
+
+/**
+* Runs a reduced rigid body benchmark on different numbers of worker threads and checks that the final state is
+* plausible and identical for all runs.
+*/
+int main()
+{
+    Physics::RigidBodyBenchmarkConfig config;
+    config.box_stack_cnt = 4;
+    config.box_stack_height = 5;
+    config.sphere_cnt = 200;
+    config.step_cnt = 240;
+
+    // ground, 4 bin walls, stacks and spheres
+    size_t expected_body_cnt = 5 + config.box_stack_cnt * config.box_stack_height + config.sphere_cnt;
+
+    Run reference = runBenchmark(config, 1);
+
+    std::cout << "bodies " << reference.result.body_cnt << ", max. contacts " << reference.result.max_contact_cnt
+        << ", max. colors " << reference.result.max_color_cnt << ", " << reference.result.total_time * 1000.0 << " ms, state hash 0x"
+        << std::hex << reference.result.state_hash << std::dec << std::endl;
+
+    bool success = true;
+    success &= check(reference.result.body_cnt == expected_body_cnt, "Unexpected body count");
+    success &= check(reference.result.max_contact_cnt > 0 && reference.result.max_color_cnt > 0, "Bodies should be in contact");
+    success &= check(reference.bodies_valid, "Bodies left the scene");
+
+    for (int worker_thread_cnt : { 1, 2, 4 })
+    {
+        Run run = runBenchmark(config, worker_thread_cnt);
+        success &= check(run.result.state_hash == reference.result.state_hash, "Final state differs between runs");
+        success &= check(run.result.max_contact_cnt == reference.result.max_contact_cnt, "Contact count differs between runs");
+    }
+
+    return exitCode(success);
+}
@@ -0,0 +1,161 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "EntityManager.hpp"
+#include "SkinComponentManager.hpp"
+#include "TransformComponentManager.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Animation;
+    using EngineCore::Common::TransformComponentManager;
+
+    struct Skin
+    {
+        Entity              entity;
+        std::vector<Entity> joints;
+    };
+
+    Skin addSkin(EntityManager& entity_mngr, TransformComponentManager& transform_mngr, std::vector<SkinComponentManager*> const& skin_mngrs, Vec3 position)
+    {
+        Skin skin{ entity_mngr.create(), entity_mngr.create(3) };
+
+        transform_mngr.addComponent(skin.entity, position);
+        for (auto joint : skin.joints) {
+            transform_mngr.addComponent(joint, position);
+        }
+
+        for (auto skin_mngr : skin_mngrs) {
+            skin_mngr->addComponent(skin.entity, skin.joints, std::vector<Mat4x4>(skin.joints.size(), Mat4x4(1.0f)));
+        }
+
+        return skin;
+    }
+
+    /** Joint matrix as sampled by the skinning shader from the slotted joint palette */
+    Mat4x4 sampleJoint(std::vector<Mat4x4> const& slotted_palette, JointPaletteBlend const& blend, size_t joint)
+    {
+        Mat4x4 current = slotted_palette[blend.current_offset + joint];
+
+        if (blend.t >= 1.0f)
+            return current;
+
+        Mat4x4 const& previous = slotted_palette[blend.previous_offset + joint];
+
+        Mat4x4 result;
+        for (int i = 0; i < 16; ++i) {
+            (&result[0][0])[i] = (&previous[0][0])[i] + ((&current[0][0])[i] - (&previous[0][0])[i]) * blend.t;
+        }
+        return result;
+    }
+
+    bool equal(Mat4x4 const& a, Mat4x4 const& b)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            if (std::abs((&a[0][0])[i] - (&b[0][0])[i]) > 1.0e-5f)
+                return false;
+        }
+        return true;
+    }
+}
+
+/**
+* Animates a near skin updated every frame and a far skin updated every 4th frame, and checks that the slotted joint
+* palette only receives the evaluated skins, never overwrites slots sampled by the previous rendered frame and
+* samples the same joint matrices as the interpolating updateJointPalettes, including after a dropped frame.
+*/
+int main()
+{
+    bool success = true;
+
+    EntityManager entity_mngr;
+    TransformComponentManager transform_mngr;
+    SkinComponentManager slot_skin_mngr;
+    SkinComponentManager reference_skin_mngr;
+
+    std::vector<AnimationLodTier> tiers = { { 0.0f, 1 }, { 50.0f, 4 } };
+    slot_skin_mngr.setAnimationLodTiers(tiers);
+    reference_skin_mngr.setAnimationLodTiers(tiers);
+
+    std::vector<Skin> skins = {
+        addSkin(entity_mngr, transform_mngr, { &slot_skin_mngr, &reference_skin_mngr }, Vec3(0.0f, 0.0f, 0.0f)),
+        addSkin(entity_mngr, transform_mngr, { &slot_skin_mngr, &reference_skin_mngr }, Vec3(100.0f, 0.0f, 0.0f)) };
+
+    Vec3 camera_position(0.0f, 0.0f, 0.0f);
+
+    std::vector<Mat4x4> slotted_palette(slot_skin_mngr.getJointPaletteSize() * SkinComponentManager::JOINT_PALETTE_SLOT_CNT, Mat4x4(0.0f));
+    std::vector<Mat4x4> reference_palette;
+
+    // offsets sampled by the last rendered frame
+    std::vector<size_t> sampled_offsets;
+
+    size_t far_skin_write_cnt = 0;
+    size_t const frame_cnt = 16;
+    size_t const dropped_frame = 6;
+
+    for (size_t frame_id = 1; frame_id <= frame_cnt; ++frame_id)
+    {
+        for (size_t skin = 0; skin < skins.size(); ++skin)
+        {
+            for (size_t joint = 0; joint < skins[skin].joints.size(); ++joint) {
+                transform_mngr.translate(skins[skin].joints[joint], Vec3(0.1f * static_cast<float>(joint + 1), 0.05f * static_cast<float>(frame_id), 0.0f));
+            }
+        }
+
+        slot_skin_mngr.updateJointPaletteSlots(transform_mngr, camera_position, frame_id);
+        reference_skin_mngr.updateJointPalettes(transform_mngr, camera_position, reference_palette);
+
+        // a dropped frame is never rendered, its writes are taken with the next frame
+        if (frame_id == dropped_frame)
+            continue;
+
+        JointPaletteWrites writes;
+        slot_skin_mngr.takeJointPaletteWrites(frame_id, writes);
+
+        size_t matrix_offset = 0;
+        for (auto const& range : writes.ranges)
+        {
+            for (size_t offset : sampled_offsets) {
+                success &= check(range.first != offset, "Writes should not overwrite slots sampled by the previous rendered frame");
+            }
+
+            if (range.first >= SkinComponentManager::JOINT_PALETTE_SLOT_CNT * reference_skin_mngr.getJointPaletteOffset(skins[1].entity)) {
+                ++far_skin_write_cnt;
+            }
+
+            for (size_t joint = 0; joint < range.second; ++joint) {
+                slotted_palette[range.first + joint] = writes.joint_matrices[matrix_offset + joint];
+            }
+            matrix_offset += range.second;
+        }
+
+        sampled_offsets.clear();
+
+        for (auto const& skin : skins)
+        {
+            JointPaletteBlend blend = slot_skin_mngr.getJointPaletteBlend(skin.entity);
+            size_t palette_offset = reference_skin_mngr.getJointPaletteOffset(skin.entity);
+
+            for (size_t joint = 0; joint < skin.joints.size(); ++joint)
+            {
+                success &= check(equal(sampleJoint(slotted_palette, blend, joint), reference_palette[palette_offset + joint]),
+                    "Sampled joint matrices should match the interpolated joint palette");
+            }
+
+            sampled_offsets.push_back(blend.current_offset);
+            if (blend.t < 1.0f) {
+                sampled_offsets.push_back(blend.previous_offset);
+            }
+        }
+    }
+
+    success &= check(far_skin_write_cnt <= frame_cnt / 4 + 1, "Skins at reduced update rates should only be written when evaluated");
+
+    return exitCode(success);
+}
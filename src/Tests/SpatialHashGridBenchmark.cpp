@@ -0,0 +1,219 @@
+#include "SpatialHashGridBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "SpatialHashGrid.hpp"
+#include "TransformComponentManager.hpp"
+#include "WorldState.hpp"
+
+namespace
+{
+    constexpr size_t queries_per_task = 64;
+
+    using Neighbour = EngineCore::Common::SpatialHashGrid::Neighbour;
+
+    /** xorshift64*, deterministic across platforms */
+    struct Random
+    {
+        uint64_t state;
+
+        float next()
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return static_cast<float>((state * 2685821657736338717ull) >> 40) / static_cast<float>(1 << 24);
+        }
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool isCloser(Neighbour const& lhs, Neighbour const& rhs)
+    {
+        return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.entity.id() < rhs.entity.id());
+    }
+
+    void bruteForceRadius(
+        std::vector<Entity> const& entities,
+        std::vector<Vec3> const& positions,
+        Vec3 const& center,
+        float radius,
+        std::vector<Entity>& result)
+    {
+        result.clear();
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            Vec3 offset = positions[i] - center;
+            if (glm::dot(offset, offset) <= radius * radius) {
+                result.push_back(entities[i]);
+            }
+        }
+        std::sort(result.begin(), result.end(), [](Entity const& lhs, Entity const& rhs) { return lhs.id() < rhs.id(); });
+    }
+
+    void bruteForceNearest(
+        std::vector<Entity> const& entities,
+        std::vector<Vec3> const& positions,
+        Vec3 const& center,
+        size_t k,
+        std::vector<Neighbour>& result)
+    {
+        result.clear();
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            Vec3 offset = positions[i] - center;
+            Neighbour candidate = { entities[i], glm::dot(offset, offset) };
+
+            if (result.size() < k)
+            {
+                result.push_back(candidate);
+                std::push_heap(result.begin(), result.end(), isCloser);
+            }
+            else if (isCloser(candidate, result.front()))
+            {
+                std::pop_heap(result.begin(), result.end(), isCloser);
+                result.back() = candidate;
+                std::push_heap(result.begin(), result.end(), isCloser);
+            }
+        }
+        std::sort(result.begin(), result.end(), isCloser);
+        for (auto& neighbour : result) {
+            neighbour.distance = std::sqrt(neighbour.distance);
+        }
+    }
+
+    template<typename Query>
+    void runBatch(size_t query_cnt, Query const& query, EngineCore::Utility::TaskScheduler& task_scheduler)
+    {
+        for (size_t first = 0; first < query_cnt; first += queries_per_task)
+        {
+            size_t last = std::min(first + queries_per_task, query_cnt);
+
+            task_scheduler.submitTask([&query, first, last]() {
+                for (size_t i = first; i < last; ++i) {
+                    query(i);
+                }
+            });
+        }
+
+        task_scheduler.waitWhileBusy();
+    }
+}
+
+std::vector<EngineCore::Common::SpatialHashGridBenchmarkResult> EngineCore::Common::runSpatialHashGridBenchmark(
+    SpatialHashGridBenchmarkConfig const& config,
+    Utility::TaskScheduler& task_scheduler)
+{
+    std::vector<SpatialHashGridBenchmarkResult> results;
+
+    for (size_t entity_cnt : config.entity_cnts)
+    {
+        SpatialHashGridBenchmarkResult result;
+        result.entity_cnt = entity_cnt;
+
+        WorldState world;
+        world.add<TransformComponentManager>(std::make_unique<TransformComponentManager>());
+        auto& transform_mngr = world.get<TransformComponentManager>();
+
+        // roughly one entity per 8 cubic units
+        float side = std::cbrt(static_cast<float>(entity_cnt)) * 2.0f;
+        Random random = { config.seed };
+
+        std::vector<Entity> entities = world.accessEntityManager().create(entity_cnt);
+        std::vector<Vec3> positions(entity_cnt);
+        for (auto& position : positions) {
+            position = Vec3(random.next() * side, random.next() * side, random.next() * side);
+        }
+
+        std::vector<size_t> indices = transform_mngr.addComponents(entities, positions, std::vector<Quat>(entity_cnt, Quat()), std::vector<Vec3>(entity_cnt, Vec3(1.0f)));
+
+        SpatialHashGrid grid(world, config.cell_size);
+
+        auto start = std::chrono::steady_clock::now();
+        grid.update(task_scheduler);
+        result.build_time = secondsSince(start);
+
+        size_t moving_cnt = static_cast<size_t>(config.moving_fraction * entity_cnt);
+
+        std::vector<size_t> moving_indices(moving_cnt);
+        std::vector<Vec3> moving_positions(moving_cnt);
+        std::vector<Quat> moving_orientations(moving_cnt, Quat());
+        std::vector<Vec3> moving_scales(moving_cnt, Vec3(1.0f));
+
+        std::vector<Vec3> centers(config.query_cnt);
+        std::vector<std::vector<Entity>> brute_force_entities(config.query_cnt);
+        std::vector<std::vector<Neighbour>> brute_force_neighbours(config.query_cnt);
+
+        for (uint step = 0; step < config.step_cnt; ++step)
+        {
+            // coherent movement of a contiguous range of entities
+            size_t first = (step * moving_cnt) % std::max<size_t>(entity_cnt, 1);
+            Vec3 velocity(0.5f, -0.2f, 0.3f);
+
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < moving_cnt; ++i)
+            {
+                size_t idx = (first + i) % entity_cnt;
+                positions[idx] += velocity;
+                moving_indices[i] = indices[idx];
+                moving_positions[i] = positions[idx];
+            }
+            transform_mngr.setLocalTransforms(moving_indices, moving_positions, moving_orientations, moving_scales);
+            grid.update(task_scheduler);
+            result.update_time += secondsSince(start);
+
+            for (auto& center : centers) {
+                center = Vec3(random.next() * side, random.next() * side, random.next() * side);
+            }
+
+            start = std::chrono::steady_clock::now();
+            auto radius_results = grid.queryRadius(centers, config.query_radius, task_scheduler);
+            result.radius_query_time += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            auto nearest_results = grid.queryNearest(centers, config.k, task_scheduler);
+            result.nearest_query_time += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            runBatch(centers.size(), [&](size_t i) {
+                bruteForceRadius(entities, positions, centers[i], config.query_radius, brute_force_entities[i]);
+            }, task_scheduler);
+            result.brute_force_radius_time += secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            runBatch(centers.size(), [&](size_t i) {
+                bruteForceNearest(entities, positions, centers[i], config.k, brute_force_neighbours[i]);
+            }, task_scheduler);
+            result.brute_force_nearest_time += secondsSince(start);
+
+            for (size_t i = 0; i < centers.size(); ++i)
+            {
+                bool radius_match = radius_results[i].size() == brute_force_entities[i].size() &&
+                    std::equal(radius_results[i].begin(), radius_results[i].end(), brute_force_entities[i].begin(),
+                        [](Entity const& lhs, Entity const& rhs) { return lhs.id() == rhs.id(); });
+
+                bool nearest_match = nearest_results[i].size() == brute_force_neighbours[i].size() &&
+                    std::equal(nearest_results[i].begin(), nearest_results[i].end(), brute_force_neighbours[i].begin(),
+                        [](Neighbour const& lhs, Neighbour const& rhs) { return lhs.entity.id() == rhs.entity.id(); });
+
+                result.mismatch_cnt += (radius_match ? 0 : 1) + (nearest_match ? 0 : 1);
+            }
+        }
+
+        double step_cnt = std::max(1u, config.step_cnt);
+        result.update_time /= step_cnt;
+        result.radius_query_time /= step_cnt;
+        result.nearest_query_time /= step_cnt;
+        result.brute_force_radius_time /= step_cnt;
+        result.brute_force_nearest_time /= step_cnt;
+
+        results.push_back(result);
+    }
+
+    return results;
+}
@@ -0,0 +1,47 @@
+#ifndef SpatialHashGridBenchmark_hpp
+#define SpatialHashGridBenchmark_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "TaskScheduler.hpp"
+#include "types.hpp"
+
+namespace EngineCore
+{
+    namespace Common
+    {
+        struct SpatialHashGridBenchmarkConfig
+        {
+            std::vector<size_t> entity_cnts = { 10000, 100000, 1000000 };
+            float moving_fraction = 0.2f; ///< Fraction of entities moved per step
+            float cell_size = 4.0f;
+            float query_radius = 4.0f;
+            uint  k = 8;                  ///< Neighbours per nearest query
+            uint  step_cnt = 10;
+            uint  query_cnt = 1000;       ///< Radius and nearest queries per step, each batch is run in parallel
+            uint64_t seed = 0x2545f4914f6cdd1dull;
+        };
+
+        struct SpatialHashGridBenchmarkResult
+        {
+            size_t entity_cnt = 0;
+            double build_time = 0.0;                ///< Seconds of the first update that inserts all entities
+            double update_time = 0.0;               ///< Average seconds per step to move entities and update the grid
+            double radius_query_time = 0.0;         ///< Average seconds per batch of radius queries
+            double nearest_query_time = 0.0;        ///< Average seconds per batch of nearest queries
+            double brute_force_radius_time = 0.0;   ///< Average seconds per batch of radius queries testing all entities
+            double brute_force_nearest_time = 0.0;  ///< Average seconds per batch of nearest queries testing all entities
+            size_t mismatch_cnt = 0;                ///< Queries whose result differs from brute force, expected to be 0
+        };
+
+        /**
+        * \brief Compare the spatial hash grid to brute force queries on a random point cloud of constant density,
+        * one result per entity count. The brute force queries run on the same task scheduler with the same batches.
+        * The point cloud only depends on the seed.
+        */
+        std::vector<SpatialHashGridBenchmarkResult> runSpatialHashGridBenchmark(SpatialHashGridBenchmarkConfig const& config, Utility::TaskScheduler& task_scheduler);
+    }
+}
+
+#endif // !SpatialHashGridBenchmark_hpp
@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "SpatialHashGridBenchmark.hpp"
+#include "TaskScheduler.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Common;
+}
+
+/**
+* Runs a reduced spatial hash grid benchmark with query radii and neighbour counts below and above the cell size on
+* different numbers of worker threads and checks that all grid queries match brute force.
+*/
+int main()
+{
+    SpatialHashGridBenchmarkConfig small_queries;
+    small_queries.entity_cnts = { 1000, 20000 };
+    small_queries.cell_size = 4.0f;
+    small_queries.query_radius = 2.0f;
+    small_queries.k = 4;
+    small_queries.step_cnt = 3;
+    small_queries.query_cnt = 200;
+
+    // queries that span several cells and entities that move across cells
+    SpatialHashGridBenchmarkConfig large_queries = small_queries;
+    large_queries.cell_size = 1.5f;
+    large_queries.query_radius = 5.0f;
+    large_queries.k = 32;
+    large_queries.moving_fraction = 0.5f;
+
+    bool success = true;
+
+    for (int worker_thread_cnt : { 1, 4 })
+    {
+        for (auto const& config : { small_queries, large_queries })
+        {
+            EngineCore::Utility::TaskScheduler task_scheduler;
+            task_scheduler.run(worker_thread_cnt);
+
+            std::vector<SpatialHashGridBenchmarkResult> results = runSpatialHashGridBenchmark(config, task_scheduler);
+
+            task_scheduler.stop();
+
+            if (!check(results.size() == config.entity_cnts.size(), "Expected one result per entity count")) {
+                return EXIT_FAILURE;
+            }
+
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                std::cout << worker_thread_cnt << " threads, cell size " << config.cell_size << ", " << results[i].entity_cnt
+                    << " entities: radius query " << results[i].radius_query_time * 1000.0 << " ms, nearest query "
+                    << results[i].nearest_query_time * 1000.0 << " ms, " << results[i].mismatch_cnt << " mismatches" << std::endl;
+
+                success &= check(results[i].entity_cnt == config.entity_cnts[i], "Unexpected entity count");
+                success &= check(results[i].mismatch_cnt == 0, "Grid queries differ from brute force");
+            }
+        }
+    }
+
+    return exitCode(success);
+}
@@ -0,0 +1,75 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "TaskScheduler.hpp"
+
+#include "TestUtility.hpp"
+
+using namespace Tests;
+
+/**
+* Stops and restarts a task scheduler with queued work and checks that every task runs exactly once, including tasks
+* submitted before run and tasks submitted by other tasks while the scheduler is stopping.
+*/
+int main()
+{
+    using EngineCore::Utility::TaskScheduler;
+
+    bool success = true;
+
+    {
+        TaskScheduler task_scheduler;
+        std::vector<std::atomic_int> run_cnts(1000);
+
+        for (int i = 0; i < 10; ++i) {
+            task_scheduler.submitTask([&run_cnts, i]() { ++run_cnts[i]; });
+        }
+        task_scheduler.run(2);
+
+        // each restart has work left in the queue when stop is called
+        for (int restart = 0; restart < 10; ++restart)
+        {
+            for (int i = 10 + restart * 99; i < 10 + (restart + 1) * 99; ++i)
+            {
+                task_scheduler.submitTask([&run_cnts, i]() {
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    ++run_cnts[i];
+                });
+            }
+
+            task_scheduler.stop();
+            success &= check(task_scheduler.empty(), "Queue should be drained by stop");
+
+            task_scheduler.run(1 + restart % 3);
+        }
+
+        task_scheduler.waitWhileBusy();
+        task_scheduler.stop();
+
+        for (auto const& run_cnt : run_cnts)
+        {
+            if (!check(run_cnt.load() == 1, "Every task should run exactly once")) {
+                break;
+            }
+        }
+    }
+
+    {
+        // without workers, stop runs the queue on the calling thread
+        TaskScheduler task_scheduler;
+        std::atomic_int run_cnt = 0;
+        task_scheduler.submitTask([&task_scheduler, &run_cnt]() {
+            ++run_cnt;
+            task_scheduler.submitTask([&run_cnt]() { ++run_cnt; });
+        });
+        task_scheduler.stop();
+
+        success &= check(run_cnt.load() == 2, "Tasks submitted while stopping should run");
+    }
+
+    return exitCode(success);
+}
@@ -0,0 +1,30 @@
+#ifndef TestUtility_hpp
+#define TestUtility_hpp
+
+#include <cstdlib>
+#include <iostream>
+
+namespace Tests
+{
+    /**
+    * \brief Prints the message to stderr if the condition does not hold and returns the condition, so that
+    * results can be accumulated with success &= check(...) and all failures of a run are reported.
+    */
+    inline bool check(bool condition, char const* message)
+    {
+        if (!condition) {
+            std::cerr << message << std::endl;
+        }
+        return condition;
+    }
+
+    /**
+    * \brief Exit code of a test executable, non-zero on failure as expected by ctest
+    */
+    inline int exitCode(bool success)
+    {
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}
+
+#endif // !TestUtility_hpp
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BaseResourceManager.hpp"
+#include "TextureResidencyManager.hpp"
+#include "TextureStreamingService.hpp"
+
+#include "TestUtility.hpp"
+
+namespace
+{
+    using namespace Tests;
+    using namespace EngineCore::Graphics;
+
+    /**
+    * Records level uploads and the bytes of the texture storage instead of creating textures. Uploads are deferred
+    * like render thread tasks and are executed by executeRenderThreadTasks. Expects RGBA8 textures.
+    */
+    class FakeResourceManager : public BaseResourceManager<int, int, int, int, int>
+    {
+    public:
+        struct Upload
+        {
+            unsigned int texture;
+            uint32_t     first_level;
+            uint32_t     prev_first_level;
+            uint32_t     level_cnt;
+        };
+
+        FakeResourceManager() { m_resource_cnt = 0; }
+
+        void clearAllResources() override {}
+
+        ResourceID allocateTexture2DAsync(std::string const& name)
+        {
+            auto query = m_names.find(name);
+            if (query != m_names.end())
+                return query->second;
+
+            ResourceID rsrc_id = generateResourceID();
+            m_names.insert({ name, rsrc_id });
+            return rsrc_id;
+        }
+
+        GenericTextureLayout convertGenericTextureLayout(GenericTextureLayout const& layout)
+        {
+            return layout;
+        }
+
+        void updateTexture2DLevelsAsync(
+            ResourceID rsrc_id,
+            std::string const& name,
+            GenericTextureLayout const& layout,
+            uint32_t first_level,
+            uint32_t prev_first_level,
+            std::shared_ptr<std::vector<std::vector<uint8_t>>> const& mip_levels,
+            std::function<void()> const& uploaded)
+        {
+            Upload upload{ rsrc_id.value(), first_level, prev_first_level, static_cast<uint32_t>(mip_levels->size()) };
+
+            size_t storage_bytes = 0;
+            for (uint32_t level = first_level; level < layout.levels; ++level) {
+                storage_bytes += static_cast<size_t>(std::max(1, layout.width >> level)) * std::max(1, layout.height >> level) * 4;
+            }
+
+            m_renderThread_tasks.push([this, upload, storage_bytes, uploaded]() {
+                uploads.push_back(upload);
+                allocated_bytes[upload.texture] = storage_bytes;
+                uploaded();
+            });
+        }
+
+        size_t getAllocatedBytes() const
+        {
+            size_t bytes = 0;
+            for (auto const& allocation : allocated_bytes) {
+                bytes += allocation.second;
+            }
+            return bytes;
+        }
+
+        std::vector<Upload> uploads;
+        std::unordered_map<unsigned int, size_t> allocated_bytes;
+
+    private:
+        std::unordered_map<std::string, ResourceID> m_names;
+    };
+
+    std::shared_ptr<TextureMipChain const> createMipChain(int size)
+    {
+        auto mip_chain = std::make_shared<TextureMipChain>();
+        mip_chain->layout = GenericTextureLayout(GenericTextureLayout::InternalFormat::RGBA8, size, size, 1, 0x1908 /*GL_RGBA*/, 0x1401 /*GL_UNSIGNED_BYTE*/, 1);
+
+        for (int level_size = size; level_size > 0; level_size /= 2) {
+            mip_chain->levels.push_back(std::vector<uint8_t>(static_cast<size_t>(level_size) * level_size * 4));
+        }
+        mip_chain->layout.levels = static_cast<uint32_t>(mip_chain->levels.size());
+
+        return mip_chain;
+    }
+}
+
+/**
+* Drives a TextureStreamingService with a fake resource manager through upgrades, evictions and re-upgrades
+* and checks residency decisions, uploaded level ranges, the allocated storage and the sampled minimum LOD.
+*/
+int main()
+{
+    bool success = true;
+
+    success &= check(TextureResidencyManager::computeRequiredLevel(1024, 1024, 1024.0f, 11) == 0, "Full screen size should require level 0");
+    success &= check(TextureResidencyManager::computeRequiredLevel(1024, 1024, 256.0f, 11) == 2, "Quarter size should require level 2");
+    success &= check(TextureResidencyManager::computeRequiredLevel(1024, 1024, 0.0f, 11) == 10, "Invisible textures should require the last level");
+
+    FakeResourceManager resource_mngr;
+    TextureStreamingService<FakeResourceManager> texture_streaming(&resource_mngr, 8 << 20);
+
+    // 1024x1024 RGBA8, 11 levels, the default mip tail starts at level 4 (64x64)
+    ResourceID a = texture_streaming.addTexture2D("a", createMipChain(1024));
+    ResourceID b = texture_streaming.addTexture2D("b", createMipChain(1024));
+
+    resource_mngr.executeRenderThreadTasks();
+
+    success &= check(resource_mngr.uploads.size() == 2
+        && resource_mngr.uploads[0].first_level == 4 && resource_mngr.uploads[0].level_cnt == 7,
+        "Only the mip tail should be uploaded initially");
+    success &= check(texture_streaming.getMinLod(a) == 0.0f && texture_streaming.getMinLod(b) == 0.0f, "The complete mip tail storage should be sampled");
+    success &= check(resource_mngr.getAllocatedBytes() == texture_streaming.accessResidencyManager().getResidentBytes(),
+        "Only the mip tail should be allocated initially");
+
+    // upgrade a to level 0 and b to level 2
+    texture_streaming.reportUsage(a, 1024.0f);
+    texture_streaming.reportUsage(b, 256.0f);
+    texture_streaming.update(1);
+    resource_mngr.executeRenderThreadTasks();
+
+    success &= check(resource_mngr.uploads.size() == 4, "Each upgrade should issue one upload");
+    for (size_t i = 2; i < resource_mngr.uploads.size(); ++i)
+    {
+        auto const& upload = resource_mngr.uploads[i];
+        uint32_t expected_first_level = upload.texture == a.value() ? 0 : 2;
+        success &= check(upload.first_level == expected_first_level && upload.prev_first_level == 4 && upload.first_level + upload.level_cnt == 4,
+            "Upgrades should only upload the newly resident levels");
+    }
+    success &= check(texture_streaming.getMinLod(a) == 0.0f && texture_streaming.getMinLod(b) == 0.0f, "Upgraded storage should be sampled completely");
+    success &= check(resource_mngr.getAllocatedBytes() <= (8 << 20), "Allocated storage should stay within the budget");
+
+    // a is not used anymore and evicted to meet a lower budget
+    texture_streaming.accessResidencyManager().setBudget(1 << 20);
+    texture_streaming.reportUsage(b, 256.0f);
+    texture_streaming.update(2);
+
+    success &= check(texture_streaming.accessResidencyManager().getResidentBytes() <= (1 << 20), "Residency should meet the budget");
+    success &= check(texture_streaming.getMinLod(a) == 4.0f && texture_streaming.getMinLod(b) == 0.0f, "Evictions should be sampled right away");
+
+    resource_mngr.executeRenderThreadTasks();
+
+    success &= check(resource_mngr.uploads.size() == 5 && resource_mngr.uploads.back().level_cnt == 0,
+        "Evictions should reallocate without uploads");
+    success &= check(texture_streaming.getMinLod(a) == 0.0f, "Reallocated storage should be sampled completely");
+    success &= check(resource_mngr.getAllocatedBytes() <= (1 << 20), "Evictions should free the storage of evicted levels");
+
+    // evicted levels are uploaded again
+    texture_streaming.accessResidencyManager().setBudget(8 << 20);
+    texture_streaming.reportUsage(a, 1024.0f);
+    texture_streaming.update(3);
+    resource_mngr.executeRenderThreadTasks();
+
+    success &= check(resource_mngr.uploads.size() == 6
+        && resource_mngr.uploads.back().first_level == 0 && resource_mngr.uploads.back().level_cnt == 4,
+        "Re-upgrades should upload the evicted levels");
+    success &= check(resource_mngr.getAllocatedBytes() == texture_streaming.accessResidencyManager().getResidentBytes()
+        && resource_mngr.getAllocatedBytes() <= (8 << 20),
+        "Allocated storage should match the resident levels");
+
+    return exitCode(success);
+}